@@ -83,6 +83,15 @@
 //
 #define CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS 150
 
+// Host tools and controllers may resolve many nodes at once.
+#define CHIP_CONFIG_MINMDNS_MAX_BULK_RESOLVES 64
+
+// Host tools answer the same discovery queries over and over on busy networks.
+#define CHIP_CONFIG_MINMDNS_RESPONSE_CACHE_SIZE 8
+
+// Controllers may talk over TCP to more peers than they keep connections to.
+#define CHIP_CONFIG_TCP_EVICT_LEAST_RECENTLY_USED 1
+
 // Safe to enable this flag since standalone is associated with host and not a device.
 #define CONFIG_BUILD_FOR_HOST_UNIT_TEST 1
 
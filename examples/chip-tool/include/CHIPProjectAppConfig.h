@@ -56,6 +56,9 @@
 
 #define CHIP_DEVICE_CONFIG_ENABLE_COMMISSIONER_DISCOVERY 1
 
+// Resolve the nodes of large fabrics through a single operational browse.
+#define CHIP_CONFIG_MINMDNS_MAX_BULK_RESOLVES 64
+
 // Enable some test-only interaction model APIs.
 #define CONFIG_BUILD_FOR_HOST_UNIT_TEST 1
 
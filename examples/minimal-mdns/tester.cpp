@@ -15,16 +15,21 @@
  *    limitations under the License.
  */
 
+#include <cinttypes>
 #include <cstdint>
 #include <cstdio>
 #include <memory>
+#include <vector>
 
 #include <TracingCommandLineArgument.h>
 #include <inet/InetInterface.h>
 #include <inet/UDPEndPoint.h>
 #include <lib/dnssd/MinimalMdnsServer.h>
+#include <lib/dnssd/Resolver.h>
 #include <lib/dnssd/ServiceNaming.h>
 #include <lib/dnssd/minimal_mdns/AddressPolicy.h>
+#include <lib/dnssd/minimal_mdns/Parser.h>
+#include <lib/dnssd/minimal_mdns/RecordData.h>
 #include <lib/dnssd/minimal_mdns/ResponseBuilder.h>
 #include <lib/dnssd/minimal_mdns/Server.h>
 #include <lib/dnssd/minimal_mdns/core/QName.h>
@@ -46,6 +51,7 @@ namespace {
 enum class TestType
 {
     kSrv,
+    kResolve,
 };
 
 struct Options
@@ -53,6 +59,8 @@ struct Options
     uint32_t runtimeMs  = 500;
     uint16_t listenPort = 5353;
     TestType type       = TestType::kSrv;
+    uint32_t nodeCount  = 32;
+    bool sequential     = false;
 } gOptions;
 
 constexpr size_t kMdnsMaxPacketSize = 1'024;
@@ -65,6 +73,8 @@ constexpr uint16_t kOptionType = 't';
 constexpr uint16_t kOptionListenPort = 0x100;
 constexpr uint16_t kOptionRuntimeMs  = 0x102;
 constexpr uint16_t kOptionTraceTo    = 0x104;
+constexpr uint16_t kOptionNodes      = 0x106;
+constexpr uint16_t kOptionSequential = 0x108;
 
 // Only used for argument parsing. Tracing setup owned by the main loop.
 chip::CommandLineApp::TracingSetup * tracing_setup_for_argparse = nullptr;
@@ -88,6 +98,10 @@ bool HandleOptions(const char * aProgram, OptionSet * aOptions, int aIdentifier,
         {
             gOptions.type = TestType::kSrv;
         }
+        else if (strcasecmp(aValue, "RESOLVE") == 0)
+        {
+            gOptions.type = TestType::kResolve;
+        }
         else
         {
             PrintArgError("%s: invalid value for query type: %s\n", aProgram, aValue);
@@ -102,6 +116,16 @@ bool HandleOptions(const char * aProgram, OptionSet * aOptions, int aIdentifier,
             return false;
         }
         return true;
+    case kOptionNodes:
+        if (!ParseInt(aValue, gOptions.nodeCount) || (gOptions.nodeCount == 0))
+        {
+            PrintArgError("%s: invalid value for node count: %s\n", aProgram, aValue);
+            return false;
+        }
+        return true;
+    case kOptionSequential:
+        gOptions.sequential = true;
+        return true;
     default:
         PrintArgError("%s: INTERNAL ERROR: Unhandled option: %s\n", aProgram, aName);
         return false;
@@ -113,6 +137,8 @@ OptionDef cmdLineOptionsDef[] = {
     { "type", kArgumentRequired, kOptionType },
     { "timeout-ms", kArgumentRequired, kOptionRuntimeMs },
     { "trace-to", kArgumentRequired, kOptionTraceTo },
+    { "nodes", kArgumentRequired, kOptionNodes },
+    { "sequential", kNoArgument, kOptionSequential },
     {},
 };
 
@@ -122,8 +148,14 @@ OptionSet cmdLineOptions = { HandleOptions, cmdLineOptionsDef, "PROGRAM OPTIONS"
                              "  -t\n"
                              "  --type\n"
                              "        The packet to test with: \n"
+                             "          SRV - broadcast a SRV record\n"
+                             "          RESOLVE - answer for made up operational nodes and resolve all of them\n"
                              "  --timeout-ms\n"
                              "        How long to wait for replies\n"
+                             "  --nodes <number>\n"
+                             "        Number of made up nodes for the RESOLVE test\n"
+                             "  --sequential\n"
+                             "        Resolve the nodes of the RESOLVE test one at a time instead of all at once\n"
                              "  --trace-to <dest>\n"
                              "        trace to the given destination (supported: " SUPPORTED_COMMAND_LINE_TRACING_TARGETS ").\n"
                              "\n" };
@@ -228,6 +260,283 @@ void BroadcastPacket(mdns::Minimal::ServerBase * server)
 
 mdns::Minimal::Server<20> gMdnsServer;
 
+constexpr CompressedFabricId kStandInCompressedFabricId = 0x1122334455667788;
+constexpr uint16_t kStandInPort                         = 5540;
+constexpr mdns::Minimal::QNamePart kOperationalServiceQName[] = { Dnssd::kOperationalServiceName, Dnssd::kOperationalProtocol,
+                                                                  Dnssd::kLocalDomain };
+
+PeerId StandInPeerId(uint32_t index)
+{
+    return PeerId(kStandInCompressedFabricId, index + 1);
+}
+
+/// Returns the index of the made up node with the given id, or
+/// gOptions.nodeCount if there is none.
+uint32_t StandInIndex(const PeerId & peerId)
+{
+    if (peerId.GetCompressedFabricId() != kStandInCompressedFabricId || peerId.GetNodeId() == 0 ||
+        peerId.GetNodeId() > gOptions.nodeCount)
+    {
+        return gOptions.nodeCount;
+    }
+    return static_cast<uint32_t>(peerId.GetNodeId() - 1);
+}
+
+/// Collects which made up nodes a query asks for and which of them it lists
+/// as known answers.
+class QueryContents : public mdns::Minimal::ParserDelegate
+{
+public:
+    QueryContents(const mdns::Minimal::BytesRange & packet) :
+        mPacket(packet), requested(gOptions.nodeCount, false), knownAnswer(gOptions.nodeCount, false)
+    {}
+
+    bool browse = false;
+    std::vector<bool> requested;
+    std::vector<bool> knownAnswer;
+
+private:
+    void OnHeader(mdns::Minimal::ConstHeaderRef & header) override {}
+
+    void OnQuery(const mdns::Minimal::QueryData & data) override
+    {
+        mdns::Minimal::SerializedQNameIterator name = data.GetName();
+
+        if (name == mdns::Minimal::FullQName(kOperationalServiceQName))
+        {
+            browse = browse || data.GetType() == mdns::Minimal::QType::PTR || data.GetType() == mdns::Minimal::QType::ANY;
+            return;
+        }
+
+        uint32_t index = InstanceIndex(name);
+        if (index < gOptions.nodeCount)
+        {
+            requested[index] = true;
+        }
+    }
+
+    void OnResource(mdns::Minimal::ResourceType type, const mdns::Minimal::ResourceData & data) override
+    {
+        if (type != mdns::Minimal::ResourceType::kAnswer || data.GetType() != mdns::Minimal::QType::PTR ||
+            data.GetName() != mdns::Minimal::FullQName(kOperationalServiceQName))
+        {
+            return;
+        }
+
+        // Known answers at less than half their TTL do not suppress the answer.
+        mdns::Minimal::SerializedQNameIterator instanceName;
+        if (data.GetTtlSeconds() < mdns::Minimal::ResourceRecord::kDefaultTtl / 2 ||
+            !mdns::Minimal::ParsePtrRecord(data.GetData(), mPacket, &instanceName))
+        {
+            return;
+        }
+
+        uint32_t index = InstanceIndex(instanceName);
+        if (index < gOptions.nodeCount)
+        {
+            knownAnswer[index] = true;
+        }
+    }
+
+    static uint32_t InstanceIndex(mdns::Minimal::SerializedQNameIterator name)
+    {
+        PeerId peerId;
+        if (!name.Next() || !name.IsValid() || Dnssd::ExtractIdFromInstanceName(name.Value(), &peerId) != CHIP_NO_ERROR)
+        {
+            return gOptions.nodeCount;
+        }
+        return StandInIndex(peerId);
+    }
+
+    const mdns::Minimal::BytesRange mPacket;
+};
+
+/// Stands in for gOptions.nodeCount operational nodes: answers browses for
+/// all operational nodes, honoring known answers, as well as queries for
+/// single nodes. Every node answers with a packet of its own, like real nodes
+/// would.
+class StandInResponder : public mdns::Minimal::ServerDelegate
+{
+public:
+    uint32_t queries    = 0;
+    uint32_t responses  = 0;
+    uint32_t suppressed = 0;
+
+    void OnQuery(const mdns::Minimal::BytesRange & data, const chip::Inet::IPPacketInfo * info) override
+    {
+        QueryContents contents(data);
+        if (!mdns::Minimal::ParsePacket(data, &contents))
+        {
+            return;
+        }
+
+        bool relevant = contents.browse;
+        for (uint32_t i = 0; i < gOptions.nodeCount; i++)
+        {
+            if (contents.requested[i])
+            {
+                SendNodeResponse(i, /* includePtr = */ false);
+                relevant = true;
+            }
+            else if (contents.browse && contents.knownAnswer[i])
+            {
+                suppressed++;
+            }
+            else if (contents.browse)
+            {
+                SendNodeResponse(i, /* includePtr = */ true);
+            }
+        }
+
+        if (relevant)
+        {
+            queries++;
+        }
+    }
+
+    void OnResponse(const mdns::Minimal::BytesRange & data, const chip::Inet::IPPacketInfo * info) override {}
+
+private:
+    void SendNodeResponse(uint32_t index, bool includePtr)
+    {
+        const PeerId peerId = StandInPeerId(index);
+
+        char instanceName[Dnssd::Operational::kInstanceNameMaxLength + 1];
+        char hostName[17];
+        char addressString[Inet::IPAddress::kMaxStringLength];
+        Inet::IPAddress address;
+
+        VerifyOrDie(Dnssd::MakeInstanceName(instanceName, sizeof(instanceName), peerId) == CHIP_NO_ERROR);
+        snprintf(hostName, sizeof(hostName), "%016" PRIX64, peerId.GetNodeId());
+        snprintf(addressString, sizeof(addressString), "fd00::%" PRIx32, index + 1);
+        VerifyOrDie(Inet::IPAddress::FromString(addressString, address));
+
+        const mdns::Minimal::QNamePart instanceQName[] = { instanceName, Dnssd::kOperationalServiceName,
+                                                           Dnssd::kOperationalProtocol, Dnssd::kLocalDomain };
+        const mdns::Minimal::QNamePart hostQName[]     = { hostName, Dnssd::kLocalDomain };
+
+        mdns::Minimal::PtrResourceRecord ptrRecord(kOperationalServiceQName, instanceQName);
+        mdns::Minimal::SrvResourceRecord srvRecord(instanceQName, hostQName, kStandInPort);
+        mdns::Minimal::IPResourceRecord ipRecord(hostQName, address);
+        srvRecord.SetCacheFlush(true);
+        ipRecord.SetCacheFlush(true);
+
+        System::PacketBufferHandle packet = System::PacketBufferHandle::New(kMdnsMaxPacketSize);
+        VerifyOrReturn(!packet.IsNull());
+
+        mdns::Minimal::ResponseBuilder builder(std::move(packet));
+        if (includePtr)
+        {
+            builder.AddRecord(mdns::Minimal::ResourceType::kAnswer, ptrRecord);
+            builder.AddRecord(mdns::Minimal::ResourceType::kAdditional, srvRecord);
+        }
+        else
+        {
+            builder.AddRecord(mdns::Minimal::ResourceType::kAnswer, srvRecord);
+        }
+        builder.AddRecord(mdns::Minimal::ResourceType::kAdditional, ipRecord);
+        VerifyOrReturn(builder.Ok());
+
+        if (gMdnsServer.BroadcastSend(builder.ReleasePacket(), 5353) == CHIP_NO_ERROR)
+        {
+            responses++;
+        }
+    }
+};
+
+StandInResponder gStandInResponder;
+
+void StopRunning(System::Layer *, void *)
+{
+    // Close all sockets BEFORE system layer is shut down, otherwise
+    // attempts to free UDP sockets with system layer down will segfault
+    if (gOptions.type == TestType::kResolve)
+    {
+        Dnssd::Resolver::Instance().SetOperationalDelegate(nullptr);
+        Dnssd::Resolver::Instance().Shutdown();
+    }
+    gMdnsServer.Shutdown();
+
+    DeviceLayer::PlatformMgr().StopEventLoopTask();
+}
+
+/// Resolves all made up nodes through the DNSSD resolver, either all at once
+/// (which lets minimal mDNS resolve them in bulk) or one at a time.
+class ResolveBenchmark : public Dnssd::OperationalResolveDelegate
+{
+public:
+    CHIP_ERROR Start()
+    {
+        mResolved.assign(gOptions.nodeCount, false);
+
+        Dnssd::Resolver::Instance().SetOperationalDelegate(this);
+        ReturnErrorOnFailure(Dnssd::Resolver::Instance().Init(DeviceLayer::UDPEndPointManager()));
+
+        mStartTime = System::SystemClock().GetMonotonicTimestamp();
+        if (gOptions.sequential)
+        {
+            return Dnssd::Resolver::Instance().ResolveNodeId(StandInPeerId(0));
+        }
+
+        for (uint32_t i = 0; i < gOptions.nodeCount; i++)
+        {
+            ReturnErrorOnFailure(Dnssd::Resolver::Instance().ResolveNodeId(StandInPeerId(i)));
+        }
+        return CHIP_NO_ERROR;
+    }
+
+    void OnOperationalNodeResolved(const Dnssd::ResolvedNodeData & nodeData) override
+    {
+        const PeerId & peerId = nodeData.operationalData.peerId;
+        const uint32_t index  = StandInIndex(peerId);
+        if (index >= gOptions.nodeCount || mResolved[index])
+        {
+            return;
+        }
+
+        mResolved[index] = true;
+        mResolvedCount++;
+        mElapsed = System::SystemClock().GetMonotonicTimestamp() - mStartTime;
+        Dnssd::Resolver::Instance().NodeIdResolutionNoLongerNeeded(peerId);
+
+        if (mResolvedCount == gOptions.nodeCount)
+        {
+            DeviceLayer::SystemLayer().CancelTimer(StopRunning, nullptr);
+            StopRunning(nullptr, nullptr);
+        }
+        else if (gOptions.sequential)
+        {
+            CHIP_ERROR err = Dnssd::Resolver::Instance().ResolveNodeId(StandInPeerId(mResolvedCount));
+            if (err != CHIP_NO_ERROR)
+            {
+                printf("Failed to resolve node %" PRIu32 ": %" CHIP_ERROR_FORMAT "\n", mResolvedCount, err.Format());
+            }
+        }
+    }
+
+    void OnOperationalNodeResolutionFailed(const PeerId & peerId, CHIP_ERROR error) override
+    {
+        printf("Resolution of node 0x%" PRIX64 " failed: %" CHIP_ERROR_FORMAT "\n", peerId.GetNodeId(), error.Format());
+    }
+
+    void Report() const
+    {
+        printf("Resolved %" PRIu32 "/%" PRIu32 " nodes %s in %" PRIu32 " ms\n", mResolvedCount, gOptions.nodeCount,
+               gOptions.sequential ? "one at a time" : "all at once", static_cast<uint32_t>(mElapsed.count()));
+        printf("  queries answered:        %" PRIu32 "\n", gStandInResponder.queries);
+        printf("  responses sent:          %" PRIu32 "\n", gStandInResponder.responses);
+        printf("  suppressed by known answers: %" PRIu32 "\n", gStandInResponder.suppressed);
+    }
+
+private:
+    std::vector<bool> mResolved;
+    uint32_t mResolvedCount = 0;
+    System::Clock::Timestamp mStartTime;
+    System::Clock::Milliseconds64 mElapsed = System::Clock::kZero;
+};
+
+ResolveBenchmark gResolveBenchmark;
+
 } // namespace
 
 int main(int argc, char ** args)
@@ -262,7 +571,14 @@ int main(int argc, char ** args)
     // built in policies for addresses.
     (void) chip::Dnssd::GlobalMinimalMdnsServer::Instance();
 
-    gMdnsServer.SetDelegate(&reporter);
+    if (gOptions.type == TestType::kResolve)
+    {
+        gMdnsServer.SetDelegate(&gStandInResponder);
+    }
+    else
+    {
+        gMdnsServer.SetDelegate(&reporter);
+    }
 
     {
         auto endpoints = mdns::Minimal::GetAddressPolicy()->GetListenEndpoints();
@@ -275,18 +591,21 @@ int main(int argc, char ** args)
         }
     }
 
-    BroadcastPacket(&gMdnsServer);
-
-    err = DeviceLayer::SystemLayer().StartTimer(
-        chip::System::Clock::Milliseconds32(gOptions.runtimeMs),
-        [](System::Layer *, void *) {
-            // Close all sockets BEFORE system layer is shut down, otherwise
-            // attempts to free UDP sockets with system layer down will segfault
-            gMdnsServer.Shutdown();
+    if (gOptions.type == TestType::kResolve)
+    {
+        err = gResolveBenchmark.Start();
+        if (err != CHIP_NO_ERROR)
+        {
+            printf("Failed to start resolving: %" CHIP_ERROR_FORMAT "\n", err.Format());
+            return 1;
+        }
+    }
+    else
+    {
+        BroadcastPacket(&gMdnsServer);
+    }
 
-            DeviceLayer::PlatformMgr().StopEventLoopTask();
-        },
-        nullptr);
+    err = DeviceLayer::SystemLayer().StartTimer(chip::System::Clock::Milliseconds32(gOptions.runtimeMs), StopRunning, nullptr);
     if (err != CHIP_NO_ERROR)
     {
         printf("Failed to create the shutdown timer. Kill with ^C. %" CHIP_ERROR_FORMAT "\n", err.Format());
@@ -294,6 +613,11 @@ int main(int argc, char ** args)
 
     DeviceLayer::PlatformMgr().RunEventLoop();
 
+    if (gOptions.type == TestType::kResolve)
+    {
+        gResolveBenchmark.Report();
+    }
+
     tracing_setup.StopTracing();
     DeviceLayer::PlatformMgr().Shutdown();
     Platform::MemoryShutdown();
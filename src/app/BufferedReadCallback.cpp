@@ -26,6 +26,8 @@
 #include <app/InteractionModelEngine.h>
 #include <lib/support/ScopedBuffer.h>
 
+#include <algorithm>
+
 namespace chip {
 namespace app {
 
@@ -135,6 +137,128 @@ CHIP_ERROR BufferedReadCallback::BufferListItem(TLV::TLVReader & reader)
     return CHIP_NO_ERROR;
 }
 
+void BufferedReadCallback::StreamedListStore::Init(const std::vector<System::PacketBufferHandle> & buffers)
+{
+    mBuffers = &buffers;
+    mBufferEnds.clear();
+    mBufferEnds.reserve(buffers.size());
+
+    uint32_t end = 0;
+    for (const auto & buffer : buffers)
+    {
+        end += static_cast<uint32_t>(buffer->DataLength());
+        mBufferEnds.push_back(end);
+    }
+}
+
+CHIP_ERROR BufferedReadCallback::StreamedListStore::OnInit(TLV::TLVReader & reader, const uint8_t *& bufStart, uint32_t & bufLen)
+{
+    VerifyOrReturnError(mBuffers != nullptr && !mBuffers->empty(), CHIP_ERROR_INCORRECT_STATE);
+
+    bufStart = (*mBuffers)[0]->Start();
+    bufLen   = mBufferEnds[0];
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR BufferedReadCallback::StreamedListStore::GetNextBuffer(TLV::TLVReader & reader, const uint8_t *& bufStart,
+                                                                  uint32_t & bufLen)
+{
+    VerifyOrReturnError(mBuffers != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    // The reader is at the end of one of our buffers, so the data it has consumed ends there too.
+    auto it = std::upper_bound(mBufferEnds.begin(), mBufferEnds.end(), reader.GetLengthRead());
+    if (it == mBufferEnds.end())
+    {
+        bufStart = nullptr;
+        bufLen   = 0;
+        return CHIP_NO_ERROR;
+    }
+
+    const size_t index = static_cast<size_t>(it - mBufferEnds.begin());
+    VerifyOrReturnError(index > 0 && mBufferEnds[index - 1] == reader.GetLengthRead(), CHIP_ERROR_INCORRECT_STATE);
+
+    bufStart = (*mBuffers)[index]->Start();
+    bufLen   = mBufferEnds[index] - mBufferEnds[index - 1];
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR BufferedReadCallback::AddStreamBuffer()
+{
+    // Every list item was received in a message that fit in this size, so any single item fits in a new buffer.
+    System::PacketBufferHandle handle = System::PacketBufferHandle::New(chip::app::kMaxSecureSduLengthBytes);
+    VerifyOrReturnError(!handle.IsNull(), CHIP_ERROR_NO_MEMORY);
+
+    if (mBufferedList.empty())
+    {
+        handle->Start()[0] = static_cast<uint8_t>(TLV::TLVElementType::Array) | static_cast<uint8_t>(TLV::TLVTagControl::Anonymous);
+        handle->SetDataLength(1);
+    }
+
+    mBufferedList.push_back(std::move(handle));
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR BufferedReadCallback::StreamListItem(const TLV::TLVReader & reader)
+{
+    if (mBufferedList.empty())
+    {
+        ReturnErrorOnFailure(AddStreamBuffer());
+    }
+
+    //
+    // Items are packed back to back.  An item that does not fit in the space left in the last buffer goes into a new
+    // one, so that each item stays contiguous for the readers handed to our callback.
+    //
+    for (bool freshBuffer = false;; freshBuffer = true)
+    {
+        System::PacketBufferHandle & buffer = mBufferedList.back();
+
+        TLV::TLVReader itemReader;
+        itemReader.Init(reader);
+
+        TLV::TLVWriter writer;
+        writer.Init(buffer->Start() + buffer->DataLength(), static_cast<uint32_t>(buffer->AvailableDataLength()));
+
+        CHIP_ERROR err = writer.CopyElement(TLV::AnonymousTag(), itemReader);
+        if (err == CHIP_NO_ERROR)
+        {
+            buffer->SetDataLength(buffer->DataLength() + writer.GetLengthWritten());
+            return CHIP_NO_ERROR;
+        }
+
+        VerifyOrReturnError(!freshBuffer && (err == CHIP_ERROR_BUFFER_TOO_SMALL || err == CHIP_ERROR_NO_MEMORY), err);
+        ReturnErrorOnFailure(AddStreamBuffer());
+    }
+}
+
+CHIP_ERROR BufferedReadCallback::DispatchStreamedList()
+{
+    if (mBufferedList.empty())
+    {
+        // A ReplaceAll of an empty list.
+        ReturnErrorOnFailure(AddStreamBuffer());
+    }
+    if (mBufferedList.back()->AvailableDataLength() == 0)
+    {
+        ReturnErrorOnFailure(AddStreamBuffer());
+    }
+
+    System::PacketBufferHandle & lastBuffer       = mBufferedList.back();
+    lastBuffer->Start()[lastBuffer->DataLength()] = static_cast<uint8_t>(TLV::TLVElementType::EndOfContainer);
+    lastBuffer->SetDataLength(lastBuffer->DataLength() + 1);
+
+    mStreamedListStore.Init(mBufferedList);
+
+    TLV::TLVReader reader;
+    ReturnErrorOnFailure(reader.Init(mStreamedListStore, mStreamedListStore.GetTotalLength()));
+    ReturnErrorOnFailure(reader.Next());
+
+    // Deliver the list as a whole, i.e. as a replace all operation.
+    mBufferedPath.mListOp = ConcreteDataAttributePath::ListOperation::ReplaceAll;
+    mCallback.OnAttributeData(mBufferedPath, &reader, StatusIB());
+    return CHIP_NO_ERROR;
+}
+
 CHIP_ERROR BufferedReadCallback::BufferData(const ConcreteDataAttributePath & aPath, TLV::TLVReader * apData)
 {
 
@@ -151,7 +275,7 @@ CHIP_ERROR BufferedReadCallback::BufferData(const ConcreteDataAttributePath & aP
 
         while ((err = apData->Next()) == CHIP_NO_ERROR)
         {
-            ReturnErrorOnFailure(BufferListItem(*apData));
+            ReturnErrorOnFailure(mStreamLists ? StreamListItem(*apData) : BufferListItem(*apData));
         }
 
         if (err == CHIP_END_OF_TLV)
@@ -164,7 +288,7 @@ CHIP_ERROR BufferedReadCallback::BufferData(const ConcreteDataAttributePath & aP
     }
     else if (aPath.mListOp == ConcreteDataAttributePath::ListOperation::AppendItem)
     {
-        ReturnErrorOnFailure(BufferListItem(*apData));
+        ReturnErrorOnFailure(mStreamLists ? StreamListItem(*apData) : BufferListItem(*apData));
     }
 
     return CHIP_NO_ERROR;
@@ -201,23 +325,30 @@ CHIP_ERROR BufferedReadCallback::DispatchBufferedData(const ConcreteAttributePat
         return CHIP_NO_ERROR;
     }
 
-    StatusIB statusIB;
-    TLV::ScopedBufferTLVReader reader;
+    if (mStreamLists)
+    {
+        ReturnErrorOnFailure(DispatchStreamedList());
+    }
+    else
+    {
+        StatusIB statusIB;
+        TLV::ScopedBufferTLVReader reader;
 
-    ReturnErrorOnFailure(GenerateListTLV(reader));
+        ReturnErrorOnFailure(GenerateListTLV(reader));
 
-    //
-    // Update the list operation to now reflect the delivery of the entire list
-    // i.e a replace all operation.
-    //
-    mBufferedPath.mListOp = ConcreteDataAttributePath::ListOperation::ReplaceAll;
+        //
+        // Update the list operation to now reflect the delivery of the entire list
+        // i.e a replace all operation.
+        //
+        mBufferedPath.mListOp = ConcreteDataAttributePath::ListOperation::ReplaceAll;
 
-    //
-    // Advance the reader forward to the list itself
-    //
-    ReturnErrorOnFailure(reader.Next());
+        //
+        // Advance the reader forward to the list itself
+        //
+        ReturnErrorOnFailure(reader.Next());
 
-    mCallback.OnAttributeData(mBufferedPath, &reader, statusIB);
+        mCallback.OnAttributeData(mBufferedPath, &reader, statusIB);
+    }
 
     //
     // Clear out our buffered contents to free up allocated buffers, and reset the buffered path.
@@ -36,13 +36,51 @@ namespace app {
  * upon completion of delivery of all chunks. This is then delivered to a compliant ReadClient::Callback
  * without any awareness on their part that chunking happened.
  *
+ * In streaming mode, list items are instead packed as they arrive into a few MTU-sized packet buffers, and the
+ * callback is handed a reader that walks those buffers in place. This avoids one copy of the whole list and the
+ * per-item packet buffers, at the cost of the reader not being backed by a contiguous buffer: the callback must
+ * not rely on TLVReader::GetReadPoint() spanning the list or on APIs that require a contiguous reader, such as
+ * TLVWriter::CopyContainer().  Individual list items are always contiguous.
+ *
  */
 class BufferedReadCallback : public ReadClient::Callback
 {
 public:
-    BufferedReadCallback(Callback & callback) : mCallback(callback) {}
+    BufferedReadCallback(Callback & callback, bool streamLists = false) : mCallback(callback), mStreamLists(streamLists) {}
 
 private:
+    /*
+     * Read-only backing store over the buffers of a streamed list.  It keeps no per-reader state, since it finds the
+     * next buffer from the number of bytes a reader has consumed, so any number of readers (and readers created off
+     * of readers) can share it.
+     */
+    class StreamedListStore : public TLV::TLVBackingStore
+    {
+    public:
+        void Init(const std::vector<System::PacketBufferHandle> & buffers);
+        uint32_t GetTotalLength() const { return mBufferEnds.empty() ? 0 : mBufferEnds.back(); }
+
+        CHIP_ERROR OnInit(TLV::TLVReader & reader, const uint8_t *& bufStart, uint32_t & bufLen) override;
+        CHIP_ERROR GetNextBuffer(TLV::TLVReader & reader, const uint8_t *& bufStart, uint32_t & bufLen) override;
+        CHIP_ERROR OnInit(TLV::TLVWriter & writer, uint8_t *& bufStart, uint32_t & bufLen) override
+        {
+            return CHIP_ERROR_INCORRECT_STATE;
+        }
+        CHIP_ERROR GetNewBuffer(TLV::TLVWriter & writer, uint8_t *& bufStart, uint32_t & bufLen) override
+        {
+            return CHIP_ERROR_INCORRECT_STATE;
+        }
+        CHIP_ERROR FinalizeBuffer(TLV::TLVWriter & writer, uint8_t * bufStart, uint32_t bufLen) override
+        {
+            return CHIP_ERROR_INCORRECT_STATE;
+        }
+        bool GetNewBufferWillAlwaysFail() override { return true; }
+
+    private:
+        const std::vector<System::PacketBufferHandle> * mBuffers = nullptr;
+        std::vector<uint32_t> mBufferEnds; // offset of the end of each buffer within the list TLV
+    };
+
     /*
      * Generates the reconsistuted TLV array from the stored individual list elements
      */
@@ -128,9 +166,28 @@ private:
      *
      */
     CHIP_ERROR BufferListItem(TLV::TLVReader & reader);
+
+    /*
+     * Streaming mode counterpart of BufferListItem: append the list item where the reader is positioned to the last
+     * buffer of mBufferedList, starting a new buffer if it does not fit.
+     */
+    CHIP_ERROR StreamListItem(const TLV::TLVReader & reader);
+
+    /*
+     * Allocate a new buffer for a streamed list, starting the TLV array if it is the first one.
+     */
+    CHIP_ERROR AddStreamBuffer();
+
+    /*
+     * Close the TLV array of a streamed list and dispatch it.
+     */
+    CHIP_ERROR DispatchStreamedList();
+
     ConcreteDataAttributePath mBufferedPath;
     std::vector<System::PacketBufferHandle> mBufferedList;
+    StreamedListStore mStreamedListStore;
     Callback & mCallback;
+    const bool mStreamLists;
 };
 
 } // namespace app
@@ -34,6 +34,8 @@ struct CASEClientInitParams
     Messaging::ExchangeManager * exchangeMgr                           = nullptr;
     FabricTable * fabricTable                                          = nullptr;
     Credentials::GroupDataProvider * groupDataProvider                 = nullptr;
+    // cryptoWorkQueue is optional; see CASESession::SetCryptoWorkQueue.
+    CryptoWorkQueue * cryptoWorkQueue                                  = nullptr;
 
     // mrpLocalConfig should not generally be set to anything other than
     // NullOptional.  Doing that can lead to different parts of the system
@@ -0,0 +1,218 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/CASEEstablishmentScheduler.h>
+
+#include <crypto/RandUtils.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <tracing/metric_event.h>
+
+#include <algorithm>
+
+using namespace chip::Tracing;
+
+namespace chip {
+
+CHIP_ERROR CASEEstablishmentScheduler::Init(System::Layer * systemLayer)
+{
+    VerifyOrReturnError(systemLayer != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(mConfig.maxConcurrent > 0 && mConfig.batchSize > 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    mSystemLayer = systemLayer;
+    mStats       = Stats();
+    return CHIP_NO_ERROR;
+}
+
+void CASEEstablishmentScheduler::Shutdown()
+{
+    if (mSystemLayer != nullptr)
+    {
+        mSystemLayer->CancelTimer(HandleDispatchTimer, this);
+        mSystemLayer = nullptr;
+    }
+    mDispatchPending = false;
+
+    // mSystemLayer is already cleared, so a client that asks for a slot again from its failure callback is
+    // refused instead of being queued on a scheduler that is going away.
+    while (Client * client = PopNextQueued())
+    {
+        client->OnEstablishmentSlotFailed(CHIP_ERROR_CANCELLED);
+        // Do not touch `client` anymore; it may have been destroyed by the call above.
+    }
+    while (mActive.begin() != mActive.end())
+    {
+        Client & client = *mActive.begin();
+        mActive.Remove(&client);
+        client.mHoldsSlot = false;
+    }
+
+    mStats.queueDepth = 0;
+    mStats.active     = 0;
+}
+
+CHIP_ERROR CASEEstablishmentScheduler::RequestSlot(Client & client, Priority priority)
+{
+    VerifyOrReturnError(mSystemLayer != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    if (client.mHoldsSlot)
+    {
+        return CHIP_NO_ERROR;
+    }
+
+    if (client.IsInList())
+    {
+        if (priority < client.mPriority)
+        {
+            mQueues[to_underlying(client.mPriority)].Remove(&client);
+            client.mPriority = priority;
+            mQueues[to_underlying(priority)].PushBack(&client);
+        }
+        return CHIP_NO_ERROR;
+    }
+
+    if (mStats.queueDepth >= mConfig.maxQueued)
+    {
+        mStats.rejected++;
+        ChipLogError(Discovery, "CASE establishment queue full (%u waiting), rejecting request",
+                     static_cast<unsigned>(mStats.queueDepth));
+        return CHIP_ERROR_BUSY;
+    }
+
+    if (!client.mHasRequestTime)
+    {
+        client.mFirstRequestTime = System::SystemClock().GetMonotonicTimestamp();
+        client.mHasRequestTime   = true;
+    }
+    client.mPriority = priority;
+    mQueues[to_underlying(priority)].PushBack(&client);
+    SetQueueDepth(mStats.queueDepth + 1);
+
+    ScheduleDispatch();
+    return CHIP_NO_ERROR;
+}
+
+void CASEEstablishmentScheduler::ReleaseSlot(Client & client)
+{
+    if (client.mHoldsSlot)
+    {
+        mActive.Remove(&client);
+        client.mHoldsSlot = false;
+        mStats.active--;
+        ScheduleDispatch();
+    }
+    else if (client.IsInList())
+    {
+        mQueues[to_underlying(client.mPriority)].Remove(&client);
+        SetQueueDepth(mStats.queueDepth - 1);
+    }
+}
+
+void CASEEstablishmentScheduler::OnSessionEstablished(Client & client)
+{
+    if (client.mHasRequestTime && mSystemLayer != nullptr)
+    {
+        auto elapsed = std::chrono::duration_cast<System::Clock::Milliseconds32>(System::SystemClock().GetMonotonicTimestamp() -
+                                                                                 client.mFirstRequestTime);
+        mStats.established++;
+        mStats.lastTimeToSession = elapsed;
+        mStats.maxTimeToSession  = std::max(mStats.maxTimeToSession, elapsed);
+        MATTER_LOG_METRIC(kMetricCASEEstablishmentTimeToSession, elapsed.count());
+        client.mHasRequestTime = false;
+    }
+
+    ReleaseSlot(client);
+}
+
+void CASEEstablishmentScheduler::ScheduleDispatch()
+{
+    VerifyOrReturn(mSystemLayer != nullptr && !mDispatchPending);
+    VerifyOrReturn(mStats.queueDepth > 0 && mStats.active < mConfig.maxConcurrent);
+
+    uint32_t delayMs = 0;
+    if (mConfig.batchJitter.count() > 0)
+    {
+        delayMs = Crypto::GetRandU32() % (mConfig.batchJitter.count() + 1);
+    }
+
+    CHIP_ERROR err = mSystemLayer->StartTimer(System::Clock::Milliseconds32(delayMs), HandleDispatchTimer, this);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Discovery, "Failed to schedule CASE establishment dispatch: %" CHIP_ERROR_FORMAT, err.Format());
+        return;
+    }
+    mDispatchPending = true;
+}
+
+void CASEEstablishmentScheduler::HandleDispatchTimer(System::Layer * systemLayer, void * context)
+{
+    static_cast<CASEEstablishmentScheduler *>(context)->Dispatch();
+}
+
+void CASEEstablishmentScheduler::Dispatch()
+{
+    // Stays set while we grant slots: a client can fail synchronously and release its slot from within
+    // OnEstablishmentSlotGranted, and that must not arm a second timer while this batch is still running.
+    mDispatchPending = true;
+
+    uint16_t granted = 0;
+    while (granted < mConfig.batchSize && mStats.active < mConfig.maxConcurrent)
+    {
+        Client * client = PopNextQueued();
+        if (client == nullptr)
+        {
+            break;
+        }
+
+        client->mHoldsSlot = true;
+        mActive.PushBack(client);
+        mStats.active++;
+        mStats.started++;
+        granted++;
+
+        client->OnEstablishmentSlotGranted();
+        // Do not touch `client` anymore; it may have been released by the call above.
+    }
+
+    mDispatchPending = false;
+    ScheduleDispatch();
+}
+
+CASEEstablishmentScheduler::Client * CASEEstablishmentScheduler::PopNextQueued()
+{
+    for (auto & queue : mQueues)
+    {
+        if (queue.begin() != queue.end())
+        {
+            Client * client = &(*queue.begin());
+            queue.Remove(client);
+            SetQueueDepth(mStats.queueDepth - 1);
+            return client;
+        }
+    }
+    return nullptr;
+}
+
+void CASEEstablishmentScheduler::SetQueueDepth(uint32_t queueDepth)
+{
+    mStats.queueDepth     = queueDepth;
+    mStats.peakQueueDepth = std::max(mStats.peakQueueDepth, queueDepth);
+    MATTER_LOG_METRIC(kMetricCASEEstablishmentQueueDepth, queueDepth);
+}
+
+} // namespace chip
@@ -0,0 +1,176 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @file
+ *   CASEEstablishmentScheduler paces operational session establishment when a controller has to (re)connect to
+ *   many nodes at once, e.g. after a restart or a network outage.  Without it every FindOrEstablishSession
+ *   starts an address lookup and a CASE handshake immediately, so hundreds of peers compete for the same
+ *   radio, resolver and crypto time and interactive requests wait behind background resubscriptions.
+ *
+ *   Session setups ask the scheduler for a slot before they start resolving their peer.  At most
+ *   Config::maxConcurrent setups hold a slot at a time; the rest wait in one FIFO queue per priority class and
+ *   are started in batches of up to Config::batchSize after a random delay of up to Config::batchJitter, so
+ *   that a burst of requests does not turn into a burst of Sigma1 messages.  Once Config::maxQueued setups are
+ *   waiting, further requests are rejected with CHIP_ERROR_BUSY instead of growing the queue without bound.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <lib/support/IntrusiveList.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayer.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+
+class CASEEstablishmentScheduler
+{
+public:
+    /**
+     * Priority classes, from most to least urgent.  A queued setup is always started before any setup of a less
+     * urgent class; within a class setups start in the order they were queued.
+     */
+    enum class Priority : uint8_t
+    {
+        kInteractive = 0, // A user or application is waiting on the session.
+        kNormal      = 1, // Default for FindOrEstablishSession.
+        kBackground  = 2, // Resubscriptions and other reconnection work nobody is waiting on.
+    };
+
+    struct Config
+    {
+        // Maximum number of setups resolving or handshaking at the same time.
+        uint16_t maxConcurrent = 8;
+        // Maximum number of setups waiting for a slot.
+        uint16_t maxQueued = 256;
+        // Maximum number of setups started per dispatch.
+        uint16_t batchSize = 4;
+        // Each dispatch is delayed by a random duration in [0, batchJitter].
+        System::Clock::Milliseconds32 batchJitter = System::Clock::Milliseconds32(200);
+    };
+
+    struct Stats
+    {
+        uint32_t queueDepth     = 0; // Setups currently waiting for a slot.
+        uint32_t peakQueueDepth = 0;
+        uint32_t active         = 0; // Setups currently holding a slot.
+        uint32_t started        = 0; // Slots granted since Init.
+        uint32_t rejected       = 0; // Requests refused with CHIP_ERROR_BUSY because the queue was full.
+        uint32_t established    = 0; // Sessions reported through OnSessionEstablished.
+        System::Clock::Milliseconds32 lastTimeToSession = System::Clock::kZero;
+        System::Clock::Milliseconds32 maxTimeToSession  = System::Clock::kZero;
+    };
+
+    /**
+     * Something that needs a slot before it starts establishing a session.  A client is either idle, queued, or
+     * holding a slot; it must release its slot or queue entry (ReleaseSlot) before it is destroyed.
+     */
+    class Client : public IntrusiveListNodeBase<>
+    {
+    public:
+        virtual ~Client() = default;
+
+        /**
+         * Called from a dispatch once the client has been given a slot.  The client is expected to start its
+         * establishment attempt and keep the slot until it calls ReleaseSlot.
+         */
+        virtual void OnEstablishmentSlotGranted() = 0;
+
+        /**
+         * Called when the client is dropped from the queue without ever getting a slot, e.g. because the scheduler
+         * is shutting down.  The client is no longer queued when this is called.
+         */
+        virtual void OnEstablishmentSlotFailed(CHIP_ERROR error) = 0;
+
+        bool HoldsEstablishmentSlot() const { return mHoldsSlot; }
+
+    private:
+        friend class CASEEstablishmentScheduler;
+
+        // When the client first asked for a slot; the base for time-to-session.
+        System::Clock::Timestamp mFirstRequestTime = System::Clock::kZero;
+        Priority mPriority                         = Priority::kNormal;
+        bool mHoldsSlot                            = false;
+        bool mHasRequestTime                       = false;
+    };
+
+    CASEEstablishmentScheduler() = default;
+    explicit CASEEstablishmentScheduler(const Config & config) : mConfig(config) {}
+    ~CASEEstablishmentScheduler() { Shutdown(); }
+
+    CASEEstablishmentScheduler(const CASEEstablishmentScheduler &)             = delete;
+    CASEEstablishmentScheduler & operator=(const CASEEstablishmentScheduler &) = delete;
+
+    CHIP_ERROR Init(System::Layer * systemLayer);
+
+    /**
+     * Cancels any pending dispatch and forgets all queued and active clients.  Every queued client is failed with
+     * CHIP_ERROR_CANCELLED through OnEstablishmentSlotFailed; clients holding a slot just lose it.
+     */
+    void Shutdown();
+
+    /**
+     * Queue `client` for a slot.  If the client is already queued it is moved to `priority` when that is more
+     * urgent than its current class; if it already holds a slot nothing changes.
+     *
+     * @retval CHIP_ERROR_BUSY if Config::maxQueued clients are already waiting.
+     * @retval CHIP_ERROR_INCORRECT_STATE if the scheduler has not been initialized.
+     */
+    CHIP_ERROR RequestSlot(Client & client, Priority priority);
+
+    /**
+     * Give up the client's slot, or its place in the queue.  Safe to call in any state.
+     */
+    void ReleaseSlot(Client & client);
+
+    /**
+     * Record that `client` ended up with a session, for the time-to-session metric.  Also releases its slot.
+     */
+    void OnSessionEstablished(Client & client);
+
+    const Stats & GetStats() const { return mStats; }
+
+private:
+    static constexpr size_t kPriorityCount = 3;
+
+    using ClientList = IntrusiveList<Client>;
+
+    void ScheduleDispatch();
+    void Dispatch();
+    static void HandleDispatchTimer(System::Layer * systemLayer, void * context);
+
+    Client * PopNextQueued();
+    void SetQueueDepth(uint32_t queueDepth);
+
+    Config mConfig;
+    System::Layer * mSystemLayer = nullptr;
+
+    ClientList mQueues[kPriorityCount];
+    ClientList mActive;
+
+    Stats mStats;
+
+    // True while a dispatch timer is armed or a dispatch is running.
+    bool mDispatchPending = false;
+};
+
+} // namespace chip
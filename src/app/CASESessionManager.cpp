@@ -25,12 +25,20 @@ CHIP_ERROR CASESessionManager::Init(chip::System::Layer * systemLayer, const CAS
 {
     ReturnErrorOnFailure(params.sessionInitParams.Validate());
     mConfig = params;
+    if (params.establishmentScheduler != nullptr)
+    {
+        ReturnErrorOnFailure(params.establishmentScheduler->Init(systemLayer));
+    }
     params.sessionInitParams.exchangeMgr->GetReliableMessageMgr()->RegisterSessionUpdateDelegate(this);
     return AddressResolve::Resolver::Instance().Init(systemLayer);
 }
 
 void CASESessionManager::Shutdown()
 {
+    if (mConfig.establishmentScheduler != nullptr)
+    {
+        mConfig.establishmentScheduler->Shutdown();
+    }
     AddressResolve::Resolver::Instance().Shutdown();
 }
 
@@ -76,6 +84,21 @@ void CASESessionManager::FindOrEstablishSession(const ScopedNodeId & peerId, Cal
                                  transportPayloadCapability);
 }
 
+void CASESessionManager::FindOrEstablishSession(CASEEstablishmentScheduler::Priority priority, const ScopedNodeId & peerId,
+                                                Callback::Callback<OnDeviceConnected> * onConnection,
+                                                Callback::Callback<OperationalSessionSetup::OnSetupFailure> * onSetupFailure,
+#if CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
+                                                uint8_t attemptCount, Callback::Callback<OnDeviceConnectionRetry> * onRetry,
+#endif // CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
+                                                TransportPayloadCapability transportPayloadCapability)
+{
+    FindOrEstablishSessionHelper(peerId, onConnection, nullptr, onSetupFailure,
+#if CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
+                                 attemptCount, onRetry,
+#endif
+                                 transportPayloadCapability, priority);
+}
+
 void CASESessionManager::FindOrEstablishSessionHelper(const ScopedNodeId & peerId,
                                                       Callback::Callback<OnDeviceConnected> * onConnection,
                                                       Callback::Callback<OnDeviceConnectionFailure> * onFailure,
@@ -83,7 +106,8 @@ void CASESessionManager::FindOrEstablishSessionHelper(const ScopedNodeId & peerI
 #if CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
                                                       uint8_t attemptCount, Callback::Callback<OnDeviceConnectionRetry> * onRetry,
 #endif
-                                                      TransportPayloadCapability transportPayloadCapability)
+                                                      TransportPayloadCapability transportPayloadCapability,
+                                                      CASEEstablishmentScheduler::Priority priority)
 {
     ChipLogDetail(CASESessionManager, "FindOrEstablishSession: PeerId = [%d:" ChipLogFormatX64 "]", peerId.GetFabricIndex(),
                   ChipLogValueX64(peerId.GetNodeId()));
@@ -120,6 +144,11 @@ void CASESessionManager::FindOrEstablishSessionHelper(const ScopedNodeId & peerI
     }
 #endif // CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
 
+    if (mConfig.establishmentScheduler != nullptr)
+    {
+        session->SetEstablishmentScheduler(mConfig.establishmentScheduler, priority);
+    }
+
     if (onFailure != nullptr)
     {
         session->Connect(onConnection, onFailure, transportPayloadCapability);
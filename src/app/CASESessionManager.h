@@ -19,6 +19,7 @@
 #pragma once
 
 #include <app/CASEClientPool.h>
+#include <app/CASEEstablishmentScheduler.h>
 #include <app/OperationalSessionSetup.h>
 #include <app/OperationalSessionSetupPool.h>
 #include <lib/core/CHIPConfig.h>
@@ -36,6 +37,9 @@ struct CASESessionManagerConfig
     CASEClientInitParams sessionInitParams;
     CASEClientPoolDelegate * clientPool                    = nullptr;
     OperationalSessionSetupPoolDelegate * sessionSetupPool = nullptr;
+    // Optional.  When set, new session setups wait for a slot from this scheduler before they start, instead of
+    // all starting at once.  The CASESessionManager initializes and shuts it down.
+    CASEEstablishmentScheduler * establishmentScheduler = nullptr;
 };
 
 /**
@@ -142,6 +146,19 @@ public:
 #endif // CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
                                 TransportPayloadCapability transportPayloadCapability = TransportPayloadCapability::kMRPPayload);
 
+    /**
+     * Same as the FindOrEstablishSession overload taking `onSetupFailure`, with the session setup queued in `priority`
+     * if the CASESessionManager is configured with an establishment scheduler.  Without a scheduler the priority
+     * is ignored.
+     */
+    void FindOrEstablishSession(CASEEstablishmentScheduler::Priority priority, const ScopedNodeId & peerId,
+                                Callback::Callback<OnDeviceConnected> * onConnection,
+                                Callback::Callback<OperationalSessionSetup::OnSetupFailure> * onSetupFailure,
+#if CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
+                                uint8_t attemptCount = 1, Callback::Callback<OnDeviceConnectionRetry> * onRetry = nullptr,
+#endif // CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
+                                TransportPayloadCapability transportPayloadCapability = TransportPayloadCapability::kMRPPayload);
+
     void ReleaseSession(const ScopedNodeId & peerId);
     void ReleaseSessionsForFabric(FabricIndex fabricIndex);
 
@@ -177,7 +194,9 @@ private:
 #if CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
                                       uint8_t attemptCount, Callback::Callback<OnDeviceConnectionRetry> * onRetry,
 #endif
-                                      TransportPayloadCapability transportPayloadCapability);
+                                      TransportPayloadCapability transportPayloadCapability,
+                                      CASEEstablishmentScheduler::Priority priority =
+                                          CASEEstablishmentScheduler::Priority::kNormal);
 
     CASESessionManagerConfig mConfig;
 };
@@ -19,6 +19,7 @@
 #include "system/SystemPacketBuffer.h"
 #include <app/ClusterStateCache.h>
 #include <app/InteractionModelEngine.h>
+#include <algorithm>
 #include <tuple>
 
 namespace chip {
@@ -49,33 +50,37 @@ uint32_t SizeOfStatusIB(const StatusIB & aStatus)
 
 } // anonymous namespace
 
-template <bool CanEnableDataCaching>
-CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::GetElementTLVSize(TLV::TLVReader * apData, uint32_t & aSize)
+template <bool CanEnableDataCaching, typename Storage>
+CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching, Storage>::GetElementTLVSize(TLV::TLVReader * apData, uint32_t & aSize)
 {
-    Platform::ScopedMemoryBufferWithSize<uint8_t> backingBuffer;
     TLV::TLVReader reader;
     reader.Init(*apData);
     size_t totalBufSize = reader.GetTotalLength();
-    backingBuffer.Calloc(totalBufSize);
-    VerifyOrReturnError(backingBuffer.Get() != nullptr, CHIP_ERROR_NO_MEMORY);
-    TLV::ScopedBufferTLVWriter writer(std::move(backingBuffer), totalBufSize);
+
+    // The element is copied only to measure it, so the copy goes to a scratch buffer that is kept between attributes.
+    if (mElementSizeScratch.AllocatedSize() < totalBufSize)
+    {
+        mElementSizeScratch.Calloc(totalBufSize);
+        VerifyOrReturnError(mElementSizeScratch.Get() != nullptr, CHIP_ERROR_NO_MEMORY);
+    }
+
+    TLV::TLVWriter writer;
+    writer.Init(mElementSizeScratch.Get(), totalBufSize);
     ReturnErrorOnFailure(writer.CopyElement(TLV::AnonymousTag(), reader));
     aSize = writer.GetLengthWritten();
-    ReturnErrorOnFailure(writer.Finalize(backingBuffer));
     return CHIP_NO_ERROR;
 }
 
-template <bool CanEnableDataCaching>
-CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::UpdateCache(const ConcreteDataAttributePath & aPath, TLV::TLVReader * apData,
-                                                                 const StatusIB & aStatus)
+template <bool CanEnableDataCaching, typename Storage>
+CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching, Storage>::UpdateCache(const ConcreteDataAttributePath & aPath,
+                                                                          TLV::TLVReader * apData, const StatusIB & aStatus)
 {
-    AttributeState state;
     bool endpointIsNew = false;
 
-    if (mCache.find(aPath.mEndpointId) == mCache.end())
+    if (!mStorage.HasEndpoint(aPath.mEndpointId))
     {
         //
-        // Since we might potentially be creating a new entry at mCache[aPath.mEndpointId][aPath.mClusterId] that
+        // Since we might potentially be creating a new entry for aPath.mEndpointId and aPath.mClusterId that
         // wasn't there before, we need to check if an entry didn't exist there previously and remember that so that
         // we can appropriately notify our clients of the addition of a new endpoint.
         //
@@ -91,30 +96,25 @@ CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::UpdateCache(const ConcreteD
         {
             if (mCacheData)
             {
-                Platform::ScopedMemoryBufferWithSize<uint8_t> backingBuffer;
-                backingBuffer.Calloc(elementSize);
-                VerifyOrReturnError(backingBuffer.Get() != nullptr, CHIP_ERROR_NO_MEMORY);
-                TLV::ScopedBufferTLVWriter writer(std::move(backingBuffer), elementSize);
-                ReturnErrorOnFailure(writer.CopyElement(TLV::AnonymousTag(), *apData));
-                ReturnErrorOnFailure(writer.Finalize(backingBuffer));
-
-                state.template Set<AttributeData>(std::move(backingBuffer));
+                ReturnErrorOnFailure(mStorage.SetAttributeData(aPath, *apData, elementSize));
             }
             else
             {
-                state.template Set<uint32_t>(elementSize);
+                ReturnErrorOnFailure(mStorage.SetAttributeSize(aPath, elementSize));
             }
         }
         else
         {
-            state = elementSize;
+            ReturnErrorOnFailure(mStorage.SetAttributeSize(aPath, elementSize));
         }
 
         //
         // Clear out the committed data version and only set it again once we have received all data for this cluster.
         // Otherwise, we may have incomplete data that looks like it's complete since it has a valid data version.
         //
-        mCache[aPath.mEndpointId][aPath.mClusterId].mCommittedDataVersion.ClearValue();
+        auto & dataVersions = mStorage.GetOrAddCluster(aPath.mEndpointId, aPath.mClusterId);
+        dataVersions.mCommittedDataVersion.ClearValue();
+        RemoveFromFilterIndex(aPath.mEndpointId, aPath.mClusterId, dataVersions);
 
         // This commits a pending data version if the last report path is valid and it is different from the current path.
         if (mLastReportDataPath.IsValidConcreteClusterPath() && mLastReportDataPath != aPath)
@@ -135,7 +135,7 @@ CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::UpdateCache(const ConcreteD
         // if this data item is encompassed by a wildcard path, let's go ahead and update its pending data version.
         if (foundEncompassingWildcardPath)
         {
-            mCache[aPath.mEndpointId][aPath.mClusterId].mPendingDataVersion = aPath.mDataVersion;
+            mStorage.GetOrAddCluster(aPath.mEndpointId, aPath.mClusterId).mPendingDataVersion = aPath.mDataVersion;
         }
 
         mLastReportDataPath = aPath;
@@ -146,17 +146,20 @@ CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::UpdateCache(const ConcreteD
         {
             if (mCacheData)
             {
-                state.template Set<StatusIB>(aStatus);
+                ReturnErrorOnFailure(mStorage.SetAttributeStatus(aPath, aStatus));
             }
             else
             {
-                state.template Set<uint32_t>(SizeOfStatusIB(aStatus));
+                ReturnErrorOnFailure(mStorage.SetAttributeSize(aPath, SizeOfStatusIB(aStatus)));
             }
         }
         else
         {
-            state = SizeOfStatusIB(aStatus);
+            ReturnErrorOnFailure(mStorage.SetAttributeSize(aPath, SizeOfStatusIB(aStatus)));
         }
+
+        // The status changes the size of the cluster, which orders its data version filter.
+        UpdateFilterIndex(aPath.mEndpointId, aPath.mClusterId, mStorage.GetOrAddCluster(aPath.mEndpointId, aPath.mClusterId));
     }
 
     //
@@ -168,8 +171,6 @@ CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::UpdateCache(const ConcreteD
         mAddedEndpoints.push_back(aPath.mEndpointId);
     }
 
-    mCache[aPath.mEndpointId][aPath.mClusterId].mAttributes[aPath.mAttributeId] = std::move(state);
-
     if (mCacheData)
     {
         mChangedAttributeSet.insert(aPath);
@@ -178,9 +179,9 @@ CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::UpdateCache(const ConcreteD
     return CHIP_NO_ERROR;
 }
 
-template <bool CanEnableDataCaching>
-CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::UpdateEventCache(const EventHeader & aEventHeader, TLV::TLVReader * apData,
-                                                                      const StatusIB * apStatus)
+template <bool CanEnableDataCaching, typename Storage>
+CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching, Storage>::UpdateEventCache(const EventHeader & aEventHeader,
+                                                                               TLV::TLVReader * apData, const StatusIB * apStatus)
 {
     if (apData)
     {
@@ -227,8 +228,8 @@ CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::UpdateEventCache(const Even
     return CHIP_NO_ERROR;
 }
 
-template <bool CanEnableDataCaching>
-void ClusterStateCacheT<CanEnableDataCaching>::OnReportBegin()
+template <bool CanEnableDataCaching, typename Storage>
+void ClusterStateCacheT<CanEnableDataCaching, Storage>::OnReportBegin()
 {
     mLastReportDataPath = ConcreteClusterPath(kInvalidEndpointId, kInvalidClusterId);
     mChangedAttributeSet.clear();
@@ -236,24 +237,25 @@ void ClusterStateCacheT<CanEnableDataCaching>::OnReportBegin()
     mCallback.OnReportBegin();
 }
 
-template <bool CanEnableDataCaching>
-void ClusterStateCacheT<CanEnableDataCaching>::CommitPendingDataVersion()
+template <bool CanEnableDataCaching, typename Storage>
+void ClusterStateCacheT<CanEnableDataCaching, Storage>::CommitPendingDataVersion()
 {
     if (!mLastReportDataPath.IsValidConcreteClusterPath())
     {
         return;
     }
 
-    auto & lastClusterInfo = mCache[mLastReportDataPath.mEndpointId][mLastReportDataPath.mClusterId];
+    auto & lastClusterInfo = mStorage.GetOrAddCluster(mLastReportDataPath.mEndpointId, mLastReportDataPath.mClusterId);
     if (lastClusterInfo.mPendingDataVersion.HasValue())
     {
         lastClusterInfo.mCommittedDataVersion = lastClusterInfo.mPendingDataVersion;
         lastClusterInfo.mPendingDataVersion.ClearValue();
+        UpdateFilterIndex(mLastReportDataPath.mEndpointId, mLastReportDataPath.mClusterId, lastClusterInfo);
     }
 }
 
-template <bool CanEnableDataCaching>
-void ClusterStateCacheT<CanEnableDataCaching>::OnReportEnd()
+template <bool CanEnableDataCaching, typename Storage>
+void ClusterStateCacheT<CanEnableDataCaching, Storage>::OnReportEnd()
 {
     CommitPendingDataVersion();
     mLastReportDataPath = ConcreteClusterPath(kInvalidEndpointId, kInvalidClusterId);
@@ -282,35 +284,35 @@ void ClusterStateCacheT<CanEnableDataCaching>::OnReportEnd()
     mCallback.OnReportEnd();
 }
 
-template <>
-CHIP_ERROR ClusterStateCacheT<true>::Get(const ConcreteAttributePath & path, TLV::TLVReader & reader) const
+template <bool CanEnableDataCaching, typename Storage>
+CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching, Storage>::Get(const ConcreteAttributePath & path, TLV::TLVReader & reader) const
 {
-    CHIP_ERROR err;
-    auto attributeState = GetAttributeState(path.mEndpointId, path.mClusterId, path.mAttributeId, err);
-    ReturnErrorOnFailure(err);
-
-    if (attributeState->template Is<StatusIB>())
+    if constexpr (CanEnableDataCaching)
     {
-        return CHIP_ERROR_IM_STATUS_CODE_RECEIVED;
-    }
+        auto attributeState = mStorage.FindAttribute(path);
+        VerifyOrReturnError(attributeState != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
 
-    if (!attributeState->template Is<AttributeData>())
+        if (attributeState->IsStatus())
+        {
+            return CHIP_ERROR_IM_STATUS_CODE_RECEIVED;
+        }
+
+        if (!attributeState->HasData())
+        {
+            return CHIP_ERROR_KEY_NOT_FOUND;
+        }
+
+        reader.Init(attributeState->GetData());
+        return reader.Next();
+    }
+    else
     {
         return CHIP_ERROR_KEY_NOT_FOUND;
     }
-
-    reader.Init(attributeState->template Get<AttributeData>().Get(), attributeState->template Get<AttributeData>().AllocatedSize());
-    return reader.Next();
 }
 
-template <>
-CHIP_ERROR ClusterStateCacheT<false>::Get(const ConcreteAttributePath & path, TLV::TLVReader & reader) const
-{
-    return CHIP_ERROR_KEY_NOT_FOUND;
-}
-
-template <bool CanEnableDataCaching>
-CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::Get(EventNumber eventNumber, TLV::TLVReader & reader) const
+template <bool CanEnableDataCaching, typename Storage>
+CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching, Storage>::Get(EventNumber eventNumber, TLV::TLVReader & reader) const
 {
     CHIP_ERROR err;
 
@@ -326,67 +328,9 @@ CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::Get(EventNumber eventNumber
     return CHIP_NO_ERROR;
 }
 
-template <bool CanEnableDataCaching>
-const typename ClusterStateCacheT<CanEnableDataCaching>::EndpointState *
-ClusterStateCacheT<CanEnableDataCaching>::GetEndpointState(EndpointId endpointId, CHIP_ERROR & err) const
-{
-    auto endpointIter = mCache.find(endpointId);
-    if (endpointIter == mCache.end())
-    {
-        err = CHIP_ERROR_KEY_NOT_FOUND;
-        return nullptr;
-    }
-
-    err = CHIP_NO_ERROR;
-    return &endpointIter->second;
-}
-
-template <bool CanEnableDataCaching>
-const typename ClusterStateCacheT<CanEnableDataCaching>::ClusterState *
-ClusterStateCacheT<CanEnableDataCaching>::GetClusterState(EndpointId endpointId, ClusterId clusterId, CHIP_ERROR & err) const
-{
-    auto endpointState = GetEndpointState(endpointId, err);
-    if (err != CHIP_NO_ERROR)
-    {
-        return nullptr;
-    }
-
-    auto clusterState = endpointState->find(clusterId);
-    if (clusterState == endpointState->end())
-    {
-        err = CHIP_ERROR_KEY_NOT_FOUND;
-        return nullptr;
-    }
-
-    err = CHIP_NO_ERROR;
-    return &clusterState->second;
-}
-
-template <bool CanEnableDataCaching>
-const typename ClusterStateCacheT<CanEnableDataCaching>::AttributeState *
-ClusterStateCacheT<CanEnableDataCaching>::GetAttributeState(EndpointId endpointId, ClusterId clusterId, AttributeId attributeId,
-                                                            CHIP_ERROR & err) const
-{
-    auto clusterState = GetClusterState(endpointId, clusterId, err);
-    if (err != CHIP_NO_ERROR)
-    {
-        return nullptr;
-    }
-
-    auto attributeState = clusterState->mAttributes.find(attributeId);
-    if (attributeState == clusterState->mAttributes.end())
-    {
-        err = CHIP_ERROR_KEY_NOT_FOUND;
-        return nullptr;
-    }
-
-    err = CHIP_NO_ERROR;
-    return &attributeState->second;
-}
-
-template <bool CanEnableDataCaching>
-const typename ClusterStateCacheT<CanEnableDataCaching>::EventData *
-ClusterStateCacheT<CanEnableDataCaching>::GetEventData(EventNumber eventNumber, CHIP_ERROR & err) const
+template <bool CanEnableDataCaching, typename Storage>
+const typename ClusterStateCacheT<CanEnableDataCaching, Storage>::EventData *
+ClusterStateCacheT<CanEnableDataCaching, Storage>::GetEventData(EventNumber eventNumber, CHIP_ERROR & err) const
 {
     EventData compareKey;
 
@@ -402,9 +346,9 @@ ClusterStateCacheT<CanEnableDataCaching>::GetEventData(EventNumber eventNumber,
     return &(*eventData);
 }
 
-template <bool CanEnableDataCaching>
-void ClusterStateCacheT<CanEnableDataCaching>::OnAttributeData(const ConcreteDataAttributePath & aPath, TLV::TLVReader * apData,
-                                                               const StatusIB & aStatus)
+template <bool CanEnableDataCaching, typename Storage>
+void ClusterStateCacheT<CanEnableDataCaching, Storage>::OnAttributeData(const ConcreteDataAttributePath & aPath,
+                                                                        TLV::TLVReader * apData, const StatusIB & aStatus)
 {
     //
     // Since the cache itself is a ReadClient::Callback, it may be incorrectly passed in directly when registering with the
@@ -434,20 +378,19 @@ void ClusterStateCacheT<CanEnableDataCaching>::OnAttributeData(const ConcreteDat
     mCallback.OnAttributeData(aPath, apData ? &dataSnapshot : nullptr, aStatus);
 }
 
-template <bool CanEnableDataCaching>
-CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::GetVersion(const ConcreteClusterPath & aPath,
+template <bool CanEnableDataCaching, typename Storage>
+CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching, Storage>::GetVersion(const ConcreteClusterPath & aPath,
                                                                 Optional<DataVersion> & aVersion) const
 {
     VerifyOrReturnError(aPath.IsValidConcreteClusterPath(), CHIP_ERROR_INVALID_ARGUMENT);
-    CHIP_ERROR err;
-    auto clusterState = GetClusterState(aPath.mEndpointId, aPath.mClusterId, err);
-    ReturnErrorOnFailure(err);
-    aVersion = clusterState->mCommittedDataVersion;
+    auto dataVersions = mStorage.FindCluster(aPath.mEndpointId, aPath.mClusterId);
+    VerifyOrReturnError(dataVersions != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
+    aVersion = dataVersions->mCommittedDataVersion;
     return CHIP_NO_ERROR;
 }
 
-template <bool CanEnableDataCaching>
-void ClusterStateCacheT<CanEnableDataCaching>::OnEventData(const EventHeader & aEventHeader, TLV::TLVReader * apData,
+template <bool CanEnableDataCaching, typename Storage>
+void ClusterStateCacheT<CanEnableDataCaching, Storage>::OnEventData(const EventHeader & aEventHeader, TLV::TLVReader * apData,
                                                            const StatusIB * apStatus)
 {
     VerifyOrDie(apData != nullptr || apStatus != nullptr);
@@ -462,31 +405,30 @@ void ClusterStateCacheT<CanEnableDataCaching>::OnEventData(const EventHeader & a
     mCallback.OnEventData(aEventHeader, apData ? &dataSnapshot : nullptr, apStatus);
 }
 
-template <>
-CHIP_ERROR ClusterStateCacheT<true>::GetStatus(const ConcreteAttributePath & path, StatusIB & status) const
+template <bool CanEnableDataCaching, typename Storage>
+CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching, Storage>::GetStatus(const ConcreteAttributePath & path, StatusIB & status) const
 {
-    CHIP_ERROR err;
+    if constexpr (CanEnableDataCaching)
+    {
+        auto attributeState = mStorage.FindAttribute(path);
+        VerifyOrReturnError(attributeState != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
 
-    auto attributeState = GetAttributeState(path.mEndpointId, path.mClusterId, path.mAttributeId, err);
-    ReturnErrorOnFailure(err);
+        if (!attributeState->IsStatus())
+        {
+            return CHIP_ERROR_INVALID_ARGUMENT;
+        }
 
-    if (!attributeState->template Is<StatusIB>())
+        status = attributeState->GetStatus();
+        return CHIP_NO_ERROR;
+    }
+    else
     {
         return CHIP_ERROR_INVALID_ARGUMENT;
     }
-
-    status = attributeState->template Get<StatusIB>();
-    return CHIP_NO_ERROR;
 }
 
-template <>
-CHIP_ERROR ClusterStateCacheT<false>::GetStatus(const ConcreteAttributePath & path, StatusIB & status) const
-{
-    return CHIP_ERROR_INVALID_ARGUMENT;
-}
-
-template <bool CanEnableDataCaching>
-CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::GetStatus(const ConcreteEventPath & path, StatusIB & status) const
+template <bool CanEnableDataCaching, typename Storage>
+CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching, Storage>::GetStatus(const ConcreteEventPath & path, StatusIB & status) const
 {
     auto statusIter = mEventStatusCache.find(path);
     if (statusIter == mEventStatusCache.end())
@@ -498,75 +440,60 @@ CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::GetStatus(const ConcreteEve
     return CHIP_NO_ERROR;
 }
 
-template <bool CanEnableDataCaching>
-void ClusterStateCacheT<CanEnableDataCaching>::GetSortedFilters(std::vector<std::pair<DataVersionFilter, size_t>> & aVector) const
+template <bool CanEnableDataCaching, typename Storage>
+uint32_t ClusterStateCacheT<CanEnableDataCaching, Storage>::GetClusterSize(EndpointId endpointId, ClusterId clusterId) const
 {
-    for (auto const & endpointIter : mCache)
-    {
-        EndpointId endpointId = endpointIter.first;
-        for (auto const & clusterIter : endpointIter.second)
+    uint64_t clusterSize = 0;
+
+    mStorage.ForEachAttribute(endpointId, clusterId, [&clusterSize](AttributeId, const AttributeState & attributeState) {
+        if constexpr (CanEnableDataCaching)
         {
-            if (!clusterIter.second.mCommittedDataVersion.HasValue())
+            if (attributeState.IsStatus())
             {
-                continue;
+                clusterSize += SizeOfStatusIB(attributeState.GetStatus());
+                return CHIP_NO_ERROR;
             }
-            DataVersion dataVersion = clusterIter.second.mCommittedDataVersion.Value();
-            size_t clusterSize      = 0;
-            ClusterId clusterId     = clusterIter.first;
+        }
 
-            for (auto const & attributeIter : clusterIter.second.mAttributes)
-            {
-                if constexpr (CanEnableDataCaching)
-                {
-                    if (attributeIter.second.template Is<StatusIB>())
-                    {
-                        clusterSize += SizeOfStatusIB(attributeIter.second.template Get<StatusIB>());
-                    }
-                    else if (attributeIter.second.template Is<uint32_t>())
-                    {
-                        clusterSize += attributeIter.second.template Get<uint32_t>();
-                    }
-                    else
-                    {
-                        VerifyOrDie(attributeIter.second.template Is<AttributeData>());
-                        TLV::TLVReader bufReader;
-                        bufReader.Init(attributeIter.second.template Get<AttributeData>().Get(),
-                                       attributeIter.second.template Get<AttributeData>().AllocatedSize());
-                        ReturnOnFailure(bufReader.Next());
-                        // Skip to the end of the element.
-                        ReturnOnFailure(bufReader.Skip());
-
-                        // Compute the amount of value data
-                        clusterSize += bufReader.GetLengthRead();
-                    }
-                }
-                else
-                {
-                    clusterSize += attributeIter.second;
-                }
-            }
+        // Stored data is exactly one TLV element, so its size is the amount of value data.
+        clusterSize += attributeState.GetSize();
+        return CHIP_NO_ERROR;
+    });
 
-            if (clusterSize == 0)
-            {
-                // No data in this cluster, so no point in sending a dataVersion
-                // along at all.
-                continue;
-            }
+    return static_cast<uint32_t>(std::min<uint64_t>(clusterSize, UINT32_MAX));
+}
 
-            DataVersionFilter filter(endpointId, clusterId, dataVersion);
+template <bool CanEnableDataCaching, typename Storage>
+void ClusterStateCacheT<CanEnableDataCaching, Storage>::UpdateFilterIndex(EndpointId endpointId, ClusterId clusterId,
+                                                                          ClusterStateCacheDataVersions & dataVersions)
+{
+    RemoveFromFilterIndex(endpointId, clusterId, dataVersions);
+    VerifyOrReturn(dataVersions.mCommittedDataVersion.HasValue());
 
-            aVector.push_back(std::make_pair(filter, clusterSize));
-        }
+    const uint32_t clusterSize = GetClusterSize(endpointId, clusterId);
+    if (clusterSize == 0)
+    {
+        // No data in this cluster, so no point in sending a dataVersion
+        // along at all.
+        return;
     }
 
-    std::sort(aVector.begin(), aVector.end(),
-              [](const std::pair<DataVersionFilter, size_t> & x, const std::pair<DataVersionFilter, size_t> & y) {
-                  return x.second > y.second;
-              });
+    mFilterIndex.insert({ clusterSize, endpointId, clusterId, dataVersions.mCommittedDataVersion.Value() });
+    dataVersions.mFilterSize = clusterSize;
+}
+
+template <bool CanEnableDataCaching, typename Storage>
+void ClusterStateCacheT<CanEnableDataCaching, Storage>::RemoveFromFilterIndex(EndpointId endpointId, ClusterId clusterId,
+                                                                              ClusterStateCacheDataVersions & dataVersions)
+{
+    VerifyOrReturn(dataVersions.mFilterSize != 0);
+
+    mFilterIndex.erase({ dataVersions.mFilterSize, endpointId, clusterId, 0 });
+    dataVersions.mFilterSize = 0;
 }
 
-template <bool CanEnableDataCaching>
-CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::OnUpdateDataVersionFilterList(
+template <bool CanEnableDataCaching, typename Storage>
+CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching, Storage>::OnUpdateDataVersionFilterList(
     DataVersionFilterIBs::Builder & aDataVersionFilterIBsBuilder, const Span<AttributePathParams> & aAttributePaths,
     bool & aEncodedDataVersionList)
 {
@@ -603,19 +530,21 @@ CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::OnUpdateDataVersionFilterLi
         }
     }
 
-    std::vector<std::pair<DataVersionFilter, size_t>> filterVector;
-    GetSortedFilters(filterVector);
-
+    //
+    // The filter index is kept sorted as data versions commit, so this is a single pass that stops at the first
+    // filter that does not fit.
+    //
     aEncodedDataVersionList = false;
-    for (auto & filter : filterVector)
+    for (const auto & entry : mFilterIndex)
     {
         bool intersected = false;
+        const DataVersionFilter filter(entry.mEndpointId, entry.mClusterId, entry.mDataVersion);
         aDataVersionFilterIBsBuilder.Checkpoint(backup);
 
         // if the particular cached cluster does not intersect with user provided attribute paths, skip the cached one
         for (const auto & attributePath : aAttributePaths)
         {
-            if (attributePath.IncludesAttributesInCluster(filter.first))
+            if (attributePath.IncludesAttributesInCluster(filter))
             {
                 intersected = true;
                 break;
@@ -626,7 +555,7 @@ CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::OnUpdateDataVersionFilterLi
             continue;
         }
 
-        SuccessOrExit(err = aDataVersionFilterIBsBuilder.EncodeDataVersionFilterIB(filter.first));
+        SuccessOrExit(err = aDataVersionFilterIBsBuilder.EncodeDataVersionFilterIB(filter));
         aEncodedDataVersionList = true;
     }
 
@@ -640,49 +569,43 @@ exit:
     return err;
 }
 
-template <bool CanEnableDataCaching>
-void ClusterStateCacheT<CanEnableDataCaching>::ClearAttributes(EndpointId endpointId)
+template <bool CanEnableDataCaching, typename Storage>
+void ClusterStateCacheT<CanEnableDataCaching, Storage>::ClearAttributes(EndpointId endpointId)
 {
-    mCache.erase(endpointId);
+    mStorage.ClearEndpoint(endpointId);
+
+    for (auto entry = mFilterIndex.begin(); entry != mFilterIndex.end();)
+    {
+        entry = (entry->mEndpointId == endpointId) ? mFilterIndex.erase(entry) : std::next(entry);
+    }
 }
 
-template <bool CanEnableDataCaching>
-void ClusterStateCacheT<CanEnableDataCaching>::ClearAttributes(const ConcreteClusterPath & cluster)
+template <bool CanEnableDataCaching, typename Storage>
+void ClusterStateCacheT<CanEnableDataCaching, Storage>::ClearAttributes(const ConcreteClusterPath & cluster)
 {
-    // Can't use GetEndpointState here, since that only handles const things.
-    auto endpointIter = mCache.find(cluster.mEndpointId);
-    if (endpointIter == mCache.end())
+    if (mStorage.FindCluster(cluster.mEndpointId, cluster.mClusterId) != nullptr)
     {
-        return;
+        RemoveFromFilterIndex(cluster.mEndpointId, cluster.mClusterId,
+                              mStorage.GetOrAddCluster(cluster.mEndpointId, cluster.mClusterId));
     }
 
-    auto & endpointState = endpointIter->second;
-    endpointState.erase(cluster.mClusterId);
+    mStorage.ClearCluster(cluster);
 }
 
-template <bool CanEnableDataCaching>
-void ClusterStateCacheT<CanEnableDataCaching>::ClearAttribute(const ConcreteAttributePath & attribute)
+template <bool CanEnableDataCaching, typename Storage>
+void ClusterStateCacheT<CanEnableDataCaching, Storage>::ClearAttribute(const ConcreteAttributePath & attribute)
 {
-    // Can't use GetClusterState here, since that only handles const things.
-    auto endpointIter = mCache.find(attribute.mEndpointId);
-    if (endpointIter == mCache.end())
-    {
-        return;
-    }
+    mStorage.ClearAttribute(attribute);
 
-    auto & endpointState = endpointIter->second;
-    auto clusterIter     = endpointState.find(attribute.mClusterId);
-    if (clusterIter == endpointState.end())
+    if (mStorage.FindCluster(attribute.mEndpointId, attribute.mClusterId) != nullptr)
     {
-        return;
+        UpdateFilterIndex(attribute.mEndpointId, attribute.mClusterId,
+                          mStorage.GetOrAddCluster(attribute.mEndpointId, attribute.mClusterId));
     }
-
-    auto & clusterState = clusterIter->second;
-    clusterState.mAttributes.erase(attribute.mAttributeId);
 }
 
-template <bool CanEnableDataCaching>
-CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::GetLastReportDataPath(ConcreteClusterPath & aPath)
+template <bool CanEnableDataCaching, typename Storage>
+CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching, Storage>::GetLastReportDataPath(ConcreteClusterPath & aPath)
 {
     if (mLastReportDataPath.IsValidConcreteClusterPath())
     {
@@ -695,6 +618,8 @@ CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::GetLastReportDataPath(Concr
 // Ensure that our out-of-line template methods actually get compiled.
 template class ClusterStateCacheT<true>;
 template class ClusterStateCacheT<false>;
+template class ClusterStateCacheT<true, ClusterStateCacheFlatStorage>;
+template class ClusterStateCacheT<false, ClusterStateCacheFlatStorage>;
 
 } // namespace app
 } // namespace chip
@@ -24,9 +24,11 @@
 #include <app/AppConfig.h>
 #include <app/AttributePathParams.h>
 #include <app/BufferedReadCallback.h>
+#include <app/ClusterStateCacheStorage.h>
 #include <app/ReadClient.h>
 #include <app/data-model/DecodableList.h>
 #include <app/data-model/Decode.h>
+#include <lib/support/ScopedBuffer.h>
 #include <lib/support/Variant.h>
 #include <list>
 #include <map>
@@ -57,6 +59,10 @@ namespace app {
  * The data is stored internally in the cache as TLV. This permits re-use of the existing cluster objects
  * to de-serialize the state on-demand.
  *
+ * Attribute state is kept by a storage engine (see ClusterStateCacheStorage.h).  The default engine uses nested
+ * maps and one allocation per attribute value; ClusterStateCacheFlat uses sorted flat tables and an arena instead,
+ * which is cheaper for controllers that mirror many large nodes.
+ *
  * The cache serves as a callback adapter as well in that it 'forwards' the ReadClient::Callback calls transparently
  * through to a registered callback. In addition, it provides its own enhancements to the base ReadClient::Callback
  * to make it easier to know what has changed in the cache.
@@ -66,7 +72,7 @@ namespace app {
  * 2. The same cache cannot be used by multiple subscribe/read interactions at the same time.
  *
  */
-template <bool CanEnableDataCaching>
+template <bool CanEnableDataCaching, typename Storage = ClusterStateCacheMapStorage<CanEnableDataCaching>>
 class ClusterStateCacheT : protected ReadClient::Callback
 {
 public:
@@ -372,18 +378,10 @@ public:
     template <typename IteratorFunc>
     CHIP_ERROR ForEachAttribute(EndpointId endpointId, ClusterId clusterId, IteratorFunc func) const
     {
-        CHIP_ERROR err;
-
-        auto clusterState = GetClusterState(endpointId, clusterId, err);
-        ReturnErrorOnFailure(err);
-
-        for (auto & attributeIter : clusterState->mAttributes)
-        {
-            const ConcreteAttributePath path(endpointId, clusterId, attributeIter.first);
-            ReturnErrorOnFailure(func(path));
-        }
-
-        return CHIP_NO_ERROR;
+        return mStorage.ForEachAttribute(endpointId, clusterId, [&](AttributeId attributeId, const AttributeState &) {
+            const ConcreteAttributePath path(endpointId, clusterId, attributeId);
+            return func(path);
+        });
     }
 
     /*
@@ -402,21 +400,10 @@ public:
     template <typename IteratorFunc>
     CHIP_ERROR ForEachAttribute(ClusterId clusterId, IteratorFunc func) const
     {
-        for (auto & endpointIter : mCache)
-        {
-            for (auto & clusterIter : endpointIter.second)
-            {
-                if (clusterIter.first == clusterId)
-                {
-                    for (auto & attributeIter : clusterIter.second.mAttributes)
-                    {
-                        const ConcreteAttributePath path(endpointIter.first, clusterId, attributeIter.first);
-                        ReturnErrorOnFailure(func(path));
-                    }
-                }
-            }
-        }
-        return CHIP_NO_ERROR;
+        return mStorage.ForEachCluster([&](const ConcreteClusterPath & clusterPath, const ClusterStateCacheDataVersions &) {
+            VerifyOrReturnError(clusterPath.mClusterId == clusterId, CHIP_NO_ERROR);
+            return ForEachAttribute(clusterPath.mEndpointId, clusterId, func);
+        });
     }
 
     /*
@@ -435,15 +422,7 @@ public:
     template <typename IteratorFunc>
     CHIP_ERROR ForEachCluster(EndpointId endpointId, IteratorFunc func) const
     {
-        auto endpointIter = mCache.find(endpointId);
-        if (endpointIter->first == endpointId)
-        {
-            for (auto & clusterIter : endpointIter->second)
-            {
-                ReturnErrorOnFailure(func(clusterIter.first));
-            }
-        }
-        return CHIP_NO_ERROR;
+        return mStorage.ForEachClusterOnEndpoint(endpointId, func);
     }
 
     /*
@@ -548,33 +527,7 @@ public:
     CHIP_ERROR GetLastReportDataPath(ConcreteClusterPath & aPath);
 
 private:
-    // An attribute state can be one of three things:
-    // * If we got a path-specific error for the attribute, the corresponding
-    //   status.
-    // * If we got data for the attribute and we are storing data ourselves, the
-    //   data.
-    // * If we got data for the attribute and we are not storing data
-    //   oureselves, the size of the data, so we can still prioritize sending
-    //   DataVersions correctly.
-    //
-    // The data for a single attribute is not going to be gigabytes in size, so
-    // using uint32_t for the size is fine; on 64-bit systems this can save
-    // quite a bit of space.
-    using AttributeData  = Platform::ScopedMemoryBufferWithSize<uint8_t>;
-    using AttributeState = std::conditional_t<CanEnableDataCaching, Variant<StatusIB, AttributeData, uint32_t>, uint32_t>;
-    // mPendingDataVersion represents a tentative data version for a cluster that we have gotten some reports for.
-    //
-    // mCurrentDataVersion represents a known data version for a cluster.  In order for this to have a
-    // value the cluster must be included in a path in mRequestPathSet that has a wildcard attribute
-    // and we must not be in the middle of receiving reports for that cluster.
-    struct ClusterState
-    {
-        std::map<AttributeId, AttributeState> mAttributes;
-        Optional<DataVersion> mPendingDataVersion;
-        Optional<DataVersion> mCommittedDataVersion;
-    };
-    using EndpointState = std::map<ClusterId, ClusterState>;
-    using NodeState     = std::map<EndpointId, EndpointState>;
+    using AttributeState = typename Storage::AttributeState;
 
     struct Comparator
     {
@@ -598,23 +551,6 @@ private:
         }
     };
 
-    /*
-     * These functions provide a way to index into the cached state with different sub-sets of a path, returning
-     * appropriate slices of the data as requested.
-     *
-     * In all variants, the respective slice is returned if a valid path is provided. 'err' is updated to reflect
-     * the status of the operation.
-     *
-     * Notable status values:
-     *      - If a cluster instance corresponding to endpointId and clusterId doesn't exist in the cache,
-     *        CHIP_ERROR_KEY_NOT_FOUND shall be returned.
-     *
-     */
-    const EndpointState * GetEndpointState(EndpointId endpointId, CHIP_ERROR & err) const;
-    const ClusterState * GetClusterState(EndpointId endpointId, ClusterId clusterId, CHIP_ERROR & err) const;
-    const AttributeState * GetAttributeState(EndpointId endpointId, ClusterId clusterId, AttributeId attributeId,
-                                             CHIP_ERROR & err) const;
-
     const EventData * GetEventData(EventNumber number, CHIP_ERROR & err) const;
 
     /*
@@ -680,17 +616,42 @@ private:
     // Commit the pending cluster data version, if there is one.
     void CommitPendingDataVersion();
 
-    // Get our list of data version filters, sorted from larges to smallest by the total size of the TLV
-    // payload for the filter's cluster.  Applying filters in this order should maximize space savings
-    // on the wire if not all filters can be applied.
-    void GetSortedFilters(std::vector<std::pair<DataVersionFilter, size_t>> & aVector) const;
+    // A committed cluster data version, keyed for the data version filter index.  The index is sorted from
+    // largest to smallest by the total size of the TLV payload for the filter's cluster.  Applying filters in
+    // this order should maximize space savings on the wire if not all filters can be applied.
+    struct FilterIndexEntry
+    {
+        uint32_t mClusterSize;
+        EndpointId mEndpointId;
+        ClusterId mClusterId;
+        DataVersion mDataVersion;
+
+        bool operator<(const FilterIndexEntry & other) const
+        {
+            if (mClusterSize != other.mClusterSize)
+            {
+                return mClusterSize > other.mClusterSize;
+            }
+            return (mEndpointId < other.mEndpointId) || (mEndpointId == other.mEndpointId && mClusterId < other.mClusterId);
+        }
+    };
+
+    // Total TLV payload size of the attributes cached for a cluster.
+    uint32_t GetClusterSize(EndpointId endpointId, ClusterId clusterId) const;
+
+    // Bring the filter index entry of a cluster up to date with its committed data version and size.
+    void UpdateFilterIndex(EndpointId endpointId, ClusterId clusterId, ClusterStateCacheDataVersions & dataVersions);
+
+    // Drop the filter index entry of a cluster, if it has one.
+    void RemoveFromFilterIndex(EndpointId endpointId, ClusterId clusterId, ClusterStateCacheDataVersions & dataVersions);
 
     CHIP_ERROR GetElementTLVSize(TLV::TLVReader * apData, uint32_t & aSize);
 
     Callback & mCallback;
-    NodeState mCache;
+    Storage mStorage;
     std::set<ConcreteAttributePath> mChangedAttributeSet;
     std::set<AttributePathParams, Comparator> mRequestPathSet; // wildcard attribute request path only
+    std::set<FilterIndexEntry> mFilterIndex; // clusters with a committed data version and cached data
     std::vector<EndpointId> mAddedEndpoints;
 
     std::set<EventData, EventDataCompare> mEventDataCache;
@@ -699,11 +660,15 @@ private:
     BufferedReadCallback mBufferedReader;
     ConcreteClusterPath mLastReportDataPath = ConcreteClusterPath(kInvalidEndpointId, kInvalidClusterId);
     const bool mCacheData                   = CanEnableDataCaching;
+    Platform::ScopedMemoryBufferWithSize<uint8_t> mElementSizeScratch; // see GetElementTLVSize
 };
 
 using ClusterStateCache       = ClusterStateCacheT<true>;
 using ClusterStateCacheNoData = ClusterStateCacheT<false>;
 
+using ClusterStateCacheFlat       = ClusterStateCacheT<true, ClusterStateCacheFlatStorage>;
+using ClusterStateCacheNoDataFlat = ClusterStateCacheT<false, ClusterStateCacheFlatStorage>;
+
 };     // namespace app
 };     // namespace chip
 #endif // CHIP_CONFIG_ENABLE_READ_CLIENT
@@ -0,0 +1,324 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/ClusterStateCacheStorage.h>
+
+#include <lib/support/CHIPMem.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace chip {
+namespace app {
+
+ClusterStateCacheFlatStorage::~ClusterStateCacheFlatStorage()
+{
+    for (auto & record : mAttributes)
+    {
+        if (record.mState.mKind == AttributeState::Kind::kData && record.mState.mCapacity > kMaxPackedSize)
+        {
+            Platform::MemoryFree(record.mState.mData);
+        }
+    }
+    ReleasePackedBlocks();
+}
+
+std::vector<ClusterStateCacheFlatStorage::ClusterRecord>::const_iterator
+ClusterStateCacheFlatStorage::FindClusterRecord(uint64_t clusterKey) const
+{
+    return std::lower_bound(mClusters.begin(), mClusters.end(), clusterKey,
+                            [](const ClusterRecord & record, uint64_t key) { return record.mClusterKey < key; });
+}
+
+std::vector<ClusterStateCacheFlatStorage::AttributeRecord>::const_iterator
+ClusterStateCacheFlatStorage::LowerBound(uint64_t clusterKey, AttributeId attributeId) const
+{
+    // Reports are usually delivered in path order, so check for an append before searching.
+    if (mAttributes.empty() || mAttributes.back().mClusterKey < clusterKey ||
+        (mAttributes.back().mClusterKey == clusterKey && mAttributes.back().mAttributeId < attributeId))
+    {
+        return mAttributes.end();
+    }
+
+    return std::lower_bound(mAttributes.begin(), mAttributes.end(), std::make_pair(clusterKey, attributeId),
+                            [](const AttributeRecord & record, const std::pair<uint64_t, AttributeId> & key) {
+                                return record.mClusterKey < key.first ||
+                                    (record.mClusterKey == key.first && record.mAttributeId < key.second);
+                            });
+}
+
+bool ClusterStateCacheFlatStorage::HasEndpoint(EndpointId endpointId) const
+{
+    auto iter = FindClusterRecord(PackClusterKey(endpointId, 0));
+    return iter != mClusters.end() && UnpackClusterKey(iter->mClusterKey).mEndpointId == endpointId;
+}
+
+ClusterStateCacheDataVersions & ClusterStateCacheFlatStorage::GetOrAddCluster(EndpointId endpointId, ClusterId clusterId)
+{
+    const uint64_t clusterKey = PackClusterKey(endpointId, clusterId);
+
+    if (!mClusters.empty() && mClusters.back().mClusterKey == clusterKey)
+    {
+        return mClusters.back().mDataVersions;
+    }
+
+    auto iter = mClusters.begin() + (FindClusterRecord(clusterKey) - mClusters.cbegin());
+    if (iter == mClusters.end() || iter->mClusterKey != clusterKey)
+    {
+        iter = mClusters.insert(iter, ClusterRecord{ clusterKey, {} });
+    }
+    return iter->mDataVersions;
+}
+
+const ClusterStateCacheDataVersions * ClusterStateCacheFlatStorage::FindCluster(EndpointId endpointId, ClusterId clusterId) const
+{
+    const uint64_t clusterKey = PackClusterKey(endpointId, clusterId);
+
+    auto iter = FindClusterRecord(clusterKey);
+    VerifyOrReturnValue(iter != mClusters.end() && iter->mClusterKey == clusterKey, nullptr);
+    return &iter->mDataVersions;
+}
+
+const ClusterStateCacheFlatStorage::AttributeState *
+ClusterStateCacheFlatStorage::FindAttribute(const ConcreteAttributePath & path) const
+{
+    const uint64_t clusterKey = PackClusterKey(path.mEndpointId, path.mClusterId);
+
+    auto iter = LowerBound(clusterKey, path.mAttributeId);
+    VerifyOrReturnValue(iter != mAttributes.end() && iter->mClusterKey == clusterKey && iter->mAttributeId == path.mAttributeId,
+                        nullptr);
+    return &iter->mState;
+}
+
+ClusterStateCacheFlatStorage::AttributeState & ClusterStateCacheFlatStorage::GetOrAddAttribute(const ConcreteAttributePath & path)
+{
+    const uint64_t clusterKey = PackClusterKey(path.mEndpointId, path.mClusterId);
+
+    // Same as the map storage: storing an attribute creates its cluster.
+    GetOrAddCluster(path.mEndpointId, path.mClusterId);
+
+    auto iter = mAttributes.begin() + (LowerBound(clusterKey, path.mAttributeId) - mAttributes.cbegin());
+    if (iter == mAttributes.end() || iter->mClusterKey != clusterKey || iter->mAttributeId != path.mAttributeId)
+    {
+        iter = mAttributes.insert(iter, AttributeRecord{ clusterKey, path.mAttributeId, AttributeState() });
+    }
+    return iter->mState;
+}
+
+CHIP_ERROR ClusterStateCacheFlatStorage::SetAttributeStatus(const ConcreteAttributePath & path, const StatusIB & status)
+{
+    AttributeState & state = GetOrAddAttribute(path);
+    ReleaseData(state);
+    state.mKind   = AttributeState::Kind::kStatus;
+    state.mStatus = status;
+    state.mSize   = 0;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ClusterStateCacheFlatStorage::SetAttributeData(const ConcreteAttributePath & path, TLV::TLVReader & data, uint32_t size)
+{
+    // Like the map storage, build the new value before touching the attribute so that a failure leaves the old one
+    // in place.  Released slots are reused, so an attribute that keeps being updated alternates between two slots.
+    const uint32_t capacity = SlotCapacity(size);
+    uint8_t * slot          = ArenaAllocate(capacity);
+    VerifyOrReturnError(slot != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    TLV::TLVWriter writer;
+    writer.Init(slot, size);
+    CHIP_ERROR err = writer.CopyElement(TLV::AnonymousTag(), data);
+    if (err == CHIP_NO_ERROR)
+    {
+        err = writer.Finalize();
+    }
+    if (err != CHIP_NO_ERROR)
+    {
+        ArenaRelease(slot, capacity);
+        return err;
+    }
+
+    AttributeState & state = GetOrAddAttribute(path);
+    ReleaseData(state);
+    state.mKind     = AttributeState::Kind::kData;
+    state.mSize     = writer.GetLengthWritten();
+    state.mCapacity = capacity;
+    state.mData     = slot;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ClusterStateCacheFlatStorage::SetAttributeSize(const ConcreteAttributePath & path, uint32_t size)
+{
+    AttributeState & state = GetOrAddAttribute(path);
+    ReleaseData(state);
+    state.mKind = AttributeState::Kind::kSize;
+    state.mSize = size;
+    return CHIP_NO_ERROR;
+}
+
+void ClusterStateCacheFlatStorage::ReleaseData(AttributeState & state)
+{
+    VerifyOrReturn(state.mKind == AttributeState::Kind::kData);
+
+    ArenaRelease(state.mData, state.mCapacity);
+    state.mKind     = AttributeState::Kind::kSize;
+    state.mCapacity = 0;
+    state.mData     = nullptr;
+}
+
+void ClusterStateCacheFlatStorage::ReleaseAttributes(std::vector<AttributeRecord>::iterator first,
+                                                     std::vector<AttributeRecord>::iterator last)
+{
+    for (auto iter = first; iter != last; ++iter)
+    {
+        ReleaseData(iter->mState);
+    }
+    mAttributes.erase(first, last);
+}
+
+void ClusterStateCacheFlatStorage::ClearEndpoint(EndpointId endpointId)
+{
+    const uint64_t firstKey = PackClusterKey(endpointId, 0);
+
+    auto firstCluster = mClusters.begin() + (FindClusterRecord(firstKey) - mClusters.cbegin());
+    auto lastCluster  = firstCluster;
+    while (lastCluster != mClusters.end() && UnpackClusterKey(lastCluster->mClusterKey).mEndpointId == endpointId)
+    {
+        ++lastCluster;
+    }
+    mClusters.erase(firstCluster, lastCluster);
+
+    auto firstAttribute = mAttributes.begin() + (LowerBound(firstKey, 0) - mAttributes.cbegin());
+    auto lastAttribute  = firstAttribute;
+    while (lastAttribute != mAttributes.end() && UnpackClusterKey(lastAttribute->mClusterKey).mEndpointId == endpointId)
+    {
+        ++lastAttribute;
+    }
+    ReleaseAttributes(firstAttribute, lastAttribute);
+}
+
+void ClusterStateCacheFlatStorage::ClearCluster(const ConcreteClusterPath & cluster)
+{
+    const uint64_t clusterKey = PackClusterKey(cluster.mEndpointId, cluster.mClusterId);
+
+    auto clusterIter = mClusters.begin() + (FindClusterRecord(clusterKey) - mClusters.cbegin());
+    VerifyOrReturn(clusterIter != mClusters.end() && clusterIter->mClusterKey == clusterKey);
+    mClusters.erase(clusterIter);
+
+    auto firstAttribute = mAttributes.begin() + (LowerBound(clusterKey, 0) - mAttributes.cbegin());
+    auto lastAttribute  = firstAttribute;
+    while (lastAttribute != mAttributes.end() && lastAttribute->mClusterKey == clusterKey)
+    {
+        ++lastAttribute;
+    }
+    ReleaseAttributes(firstAttribute, lastAttribute);
+}
+
+void ClusterStateCacheFlatStorage::ClearAttribute(const ConcreteAttributePath & attribute)
+{
+    const uint64_t clusterKey = PackClusterKey(attribute.mEndpointId, attribute.mClusterId);
+
+    auto iter = mAttributes.begin() + (LowerBound(clusterKey, attribute.mAttributeId) - mAttributes.cbegin());
+    VerifyOrReturn(iter != mAttributes.end() && iter->mClusterKey == clusterKey && iter->mAttributeId == attribute.mAttributeId);
+    ReleaseAttributes(iter, iter + 1);
+}
+
+uint32_t ClusterStateCacheFlatStorage::SlotCapacity(uint32_t size)
+{
+    // Zero-length values still need a distinct, non-null slot.
+    size = std::max<uint32_t>(size, 1);
+    VerifyOrReturnValue(size <= kMaxPackedSize, size);
+    return (size + kSlotGranularity - 1) / kSlotGranularity * kSlotGranularity;
+}
+
+uint8_t * ClusterStateCacheFlatStorage::ArenaAllocate(uint32_t capacity)
+{
+    if (capacity > kMaxPackedSize)
+    {
+        auto slot = static_cast<uint8_t *>(Platform::MemoryAlloc(capacity));
+        VerifyOrReturnValue(slot != nullptr, nullptr);
+        mDedicatedBytes += capacity;
+        return slot;
+    }
+
+    const size_t freeList = capacity / kSlotGranularity - 1;
+    if (freeList < mFreeSlots.size() && mFreeSlots[freeList] != nullptr)
+    {
+        uint8_t * slot = mFreeSlots[freeList];
+        memcpy(&mFreeSlots[freeList], slot, sizeof(uint8_t *));
+        mPackedLiveBytes += capacity;
+        return slot;
+    }
+
+    if (mPackedBlocks.empty() || kArenaBlockSize - mPackedBlockUsed < capacity)
+    {
+        // Whatever is left at the end of the last block is too small for this value and stays unused.
+        auto block = static_cast<uint8_t *>(Platform::MemoryAlloc(kArenaBlockSize));
+        VerifyOrReturnValue(block != nullptr, nullptr);
+        mPackedBlocks.push_back(block);
+        mPackedBlockUsed = 0;
+    }
+
+    uint8_t * slot = mPackedBlocks.back() + mPackedBlockUsed;
+    mPackedBlockUsed += capacity;
+    mPackedLiveBytes += capacity;
+    return slot;
+}
+
+void ClusterStateCacheFlatStorage::ArenaRelease(uint8_t * slot, uint32_t capacity)
+{
+    if (capacity > kMaxPackedSize)
+    {
+        Platform::MemoryFree(slot);
+        mDedicatedBytes -= capacity;
+        return;
+    }
+
+    mPackedLiveBytes -= capacity;
+    if (mPackedLiveBytes == 0)
+    {
+        // Nothing references the shared blocks any more, so give them back instead of keeping free lists over them.
+        ReleasePackedBlocks();
+        return;
+    }
+
+    const size_t freeList = capacity / kSlotGranularity - 1;
+    if (freeList >= mFreeSlots.size())
+    {
+        mFreeSlots.resize(freeList + 1, nullptr);
+    }
+    memcpy(slot, &mFreeSlots[freeList], sizeof(uint8_t *));
+    mFreeSlots[freeList] = slot;
+}
+
+void ClusterStateCacheFlatStorage::ReleasePackedBlocks()
+{
+    for (auto block : mPackedBlocks)
+    {
+        Platform::MemoryFree(block);
+    }
+    mPackedBlocks.clear();
+    mPackedBlockUsed = 0;
+    mFreeSlots.clear();
+}
+
+size_t ClusterStateCacheFlatStorage::GetArenaBytes() const
+{
+    return mPackedBlocks.size() * kArenaBlockSize + mDedicatedBytes;
+}
+
+} // namespace app
+} // namespace chip
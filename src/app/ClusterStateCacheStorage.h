@@ -0,0 +1,465 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @file
+ *   Storage engines for the attribute state kept by ClusterStateCacheT.
+ *
+ *   Both engines expose the same interface, so the cache is written once against either of them:
+ *
+ *     - ClusterStateCacheMapStorage keeps nested std::maps keyed by endpoint, cluster and attribute, and
+ *       gives every cached attribute value its own heap allocation.  This is the default.
+ *
+ *     - ClusterStateCacheFlatStorage keeps sorted flat vectors of cluster and attribute records, keyed by
+ *       the packed (endpoint, cluster) pair plus the attribute id, and stores attribute values in a
+ *       per-cache arena of large blocks.  It is meant for controllers that mirror many nodes, where
+ *       priming a node otherwise costs one allocation per attribute and pointer-chasing lookups.
+ */
+
+#pragma once
+
+#include <app/ConcreteAttributePath.h>
+#include <app/ConcreteClusterPath.h>
+#include <app/MessageDef/StatusIB.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+#include <lib/core/Optional.h>
+#include <lib/core/TLVReader.h>
+#include <lib/core/TLVWriter.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/ScopedBuffer.h>
+#include <lib/support/Span.h>
+#include <lib/support/Variant.h>
+
+#include <map>
+#include <stdint.h>
+#include <type_traits>
+#include <vector>
+
+namespace chip {
+namespace app {
+
+/*
+ * Data versions tracked for every cluster in the cache.
+ *
+ * mPendingDataVersion represents a tentative data version for a cluster that we have gotten some reports for.
+ *
+ * mCommittedDataVersion represents a known data version for a cluster.  In order for this to have a
+ * value the cluster must be included in a wildcard attribute path of the cache's request path set
+ * and we must not be in the middle of receiving reports for that cluster.
+ *
+ * mFilterSize is the cluster payload size under which the cache has indexed the committed data version
+ * as a data version filter, or 0 if the cluster is not in that index.
+ */
+struct ClusterStateCacheDataVersions
+{
+    Optional<DataVersion> mPendingDataVersion;
+    Optional<DataVersion> mCommittedDataVersion;
+    uint32_t mFilterSize = 0;
+};
+
+template <bool CanEnableDataCaching>
+class ClusterStateCacheMapStorage
+{
+public:
+    // An attribute state can be one of three things:
+    // * If we got a path-specific error for the attribute, the corresponding
+    //   status.
+    // * If we got data for the attribute and we are storing data ourselves, the
+    //   data.
+    // * If we got data for the attribute and we are not storing data
+    //   oureselves, the size of the data, so we can still prioritize sending
+    //   DataVersions correctly.
+    //
+    // The data for a single attribute is not going to be gigabytes in size, so
+    // using uint32_t for the size is fine; on 64-bit systems this can save
+    // quite a bit of space.
+    class AttributeState
+    {
+    public:
+        bool IsStatus() const
+        {
+            if constexpr (CanEnableDataCaching)
+            {
+                return mState.template Is<StatusIB>();
+            }
+            return false;
+        }
+
+        const StatusIB & GetStatus() const { return mState.template Get<StatusIB>(); }
+
+        bool HasData() const
+        {
+            if constexpr (CanEnableDataCaching)
+            {
+                return mState.template Is<AttributeData>();
+            }
+            return false;
+        }
+
+        ByteSpan GetData() const
+        {
+            const auto & data = mState.template Get<AttributeData>();
+            return ByteSpan(data.Get(), data.AllocatedSize());
+        }
+
+        // The TLV size of the data, whether the data itself is stored or not.  Not valid for a status.
+        uint32_t GetSize() const
+        {
+            if constexpr (CanEnableDataCaching)
+            {
+                if (mState.template Is<AttributeData>())
+                {
+                    return static_cast<uint32_t>(mState.template Get<AttributeData>().AllocatedSize());
+                }
+                return mState.template Get<uint32_t>();
+            }
+            else
+            {
+                return mState;
+            }
+        }
+
+    private:
+        friend class ClusterStateCacheMapStorage;
+
+        using AttributeData = Platform::ScopedMemoryBufferWithSize<uint8_t>;
+        std::conditional_t<CanEnableDataCaching, Variant<StatusIB, AttributeData, uint32_t>, uint32_t> mState;
+    };
+
+    bool HasEndpoint(EndpointId endpointId) const { return mCache.find(endpointId) != mCache.end(); }
+
+    /*
+     * Returns the data versions for the given cluster, adding an empty cluster to the cache if there is none yet.
+     */
+    ClusterStateCacheDataVersions & GetOrAddCluster(EndpointId endpointId, ClusterId clusterId)
+    {
+        return mCache[endpointId][clusterId].mDataVersions;
+    }
+
+    const ClusterStateCacheDataVersions * FindCluster(EndpointId endpointId, ClusterId clusterId) const
+    {
+        auto clusterState = FindClusterState(endpointId, clusterId);
+        return clusterState == nullptr ? nullptr : &clusterState->mDataVersions;
+    }
+
+    const AttributeState * FindAttribute(const ConcreteAttributePath & path) const
+    {
+        auto clusterState = FindClusterState(path.mEndpointId, path.mClusterId);
+        VerifyOrReturnValue(clusterState != nullptr, nullptr);
+
+        auto attributeIter = clusterState->mAttributes.find(path.mAttributeId);
+        VerifyOrReturnValue(attributeIter != clusterState->mAttributes.end(), nullptr);
+        return &attributeIter->second;
+    }
+
+    CHIP_ERROR SetAttributeStatus(const ConcreteAttributePath & path, const StatusIB & status)
+    {
+        AttributeState state;
+        state.mState.template Set<StatusIB>(status);
+        mCache[path.mEndpointId][path.mClusterId].mAttributes[path.mAttributeId] = std::move(state);
+        return CHIP_NO_ERROR;
+    }
+
+    /*
+     * Stores a copy of the element the reader is positioned on, re-tagged as anonymous.  `size` is the
+     * size of the re-tagged element.
+     */
+    CHIP_ERROR SetAttributeData(const ConcreteAttributePath & path, TLV::TLVReader & data, uint32_t size)
+    {
+        typename AttributeState::AttributeData backingBuffer;
+        backingBuffer.Calloc(size);
+        VerifyOrReturnError(backingBuffer.Get() != nullptr, CHIP_ERROR_NO_MEMORY);
+        TLV::ScopedBufferTLVWriter writer(std::move(backingBuffer), size);
+        ReturnErrorOnFailure(writer.CopyElement(TLV::AnonymousTag(), data));
+        ReturnErrorOnFailure(writer.Finalize(backingBuffer));
+
+        AttributeState state;
+        state.mState.template Set<typename AttributeState::AttributeData>(std::move(backingBuffer));
+        mCache[path.mEndpointId][path.mClusterId].mAttributes[path.mAttributeId] = std::move(state);
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR SetAttributeSize(const ConcreteAttributePath & path, uint32_t size)
+    {
+        AttributeState state;
+        if constexpr (CanEnableDataCaching)
+        {
+            state.mState.template Set<uint32_t>(size);
+        }
+        else
+        {
+            state.mState = size;
+        }
+        mCache[path.mEndpointId][path.mClusterId].mAttributes[path.mAttributeId] = std::move(state);
+        return CHIP_NO_ERROR;
+    }
+
+    /*
+     * Calls func(AttributeId, const AttributeState &) for every attribute of a cluster, in attribute id order.
+     * Returns CHIP_ERROR_KEY_NOT_FOUND if the cluster is not in the cache, or the first error returned by func.
+     */
+    template <typename IteratorFunc>
+    CHIP_ERROR ForEachAttribute(EndpointId endpointId, ClusterId clusterId, IteratorFunc && func) const
+    {
+        auto clusterState = FindClusterState(endpointId, clusterId);
+        VerifyOrReturnError(clusterState != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
+
+        for (auto & attributeIter : clusterState->mAttributes)
+        {
+            ReturnErrorOnFailure(func(attributeIter.first, attributeIter.second));
+        }
+        return CHIP_NO_ERROR;
+    }
+
+    /*
+     * Calls func(const ConcreteClusterPath &, const ClusterStateCacheDataVersions &) for every cluster in the
+     * cache, ordered by endpoint and then cluster id.  Stops at the first error returned by func.
+     */
+    template <typename IteratorFunc>
+    CHIP_ERROR ForEachCluster(IteratorFunc && func) const
+    {
+        for (auto & endpointIter : mCache)
+        {
+            for (auto & clusterIter : endpointIter.second)
+            {
+                ReturnErrorOnFailure(
+                    func(ConcreteClusterPath(endpointIter.first, clusterIter.first), clusterIter.second.mDataVersions));
+            }
+        }
+        return CHIP_NO_ERROR;
+    }
+
+    /*
+     * Calls func(ClusterId) for every cluster on an endpoint, in cluster id order.  Stops at the first error
+     * returned by func.
+     */
+    template <typename IteratorFunc>
+    CHIP_ERROR ForEachClusterOnEndpoint(EndpointId endpointId, IteratorFunc && func) const
+    {
+        auto endpointIter = mCache.find(endpointId);
+        VerifyOrReturnError(endpointIter != mCache.end(), CHIP_NO_ERROR);
+
+        for (auto & clusterIter : endpointIter->second)
+        {
+            ReturnErrorOnFailure(func(clusterIter.first));
+        }
+        return CHIP_NO_ERROR;
+    }
+
+    void ClearEndpoint(EndpointId endpointId) { mCache.erase(endpointId); }
+
+    void ClearCluster(const ConcreteClusterPath & cluster)
+    {
+        auto endpointIter = mCache.find(cluster.mEndpointId);
+        VerifyOrReturn(endpointIter != mCache.end());
+        endpointIter->second.erase(cluster.mClusterId);
+    }
+
+    void ClearAttribute(const ConcreteAttributePath & attribute)
+    {
+        auto endpointIter = mCache.find(attribute.mEndpointId);
+        VerifyOrReturn(endpointIter != mCache.end());
+
+        auto clusterIter = endpointIter->second.find(attribute.mClusterId);
+        VerifyOrReturn(clusterIter != endpointIter->second.end());
+        clusterIter->second.mAttributes.erase(attribute.mAttributeId);
+    }
+
+private:
+    struct ClusterState
+    {
+        std::map<AttributeId, AttributeState> mAttributes;
+        ClusterStateCacheDataVersions mDataVersions;
+    };
+    using EndpointState = std::map<ClusterId, ClusterState>;
+    using NodeState     = std::map<EndpointId, EndpointState>;
+
+    const ClusterState * FindClusterState(EndpointId endpointId, ClusterId clusterId) const
+    {
+        auto endpointIter = mCache.find(endpointId);
+        VerifyOrReturnValue(endpointIter != mCache.end(), nullptr);
+
+        auto clusterIter = endpointIter->second.find(clusterId);
+        VerifyOrReturnValue(clusterIter != endpointIter->second.end(), nullptr);
+        return &clusterIter->second;
+    }
+
+    NodeState mCache;
+};
+
+class ClusterStateCacheFlatStorage
+{
+public:
+    class AttributeState
+    {
+    public:
+        bool IsStatus() const { return mKind == Kind::kStatus; }
+        const StatusIB & GetStatus() const { return mStatus; }
+        bool HasData() const { return mKind == Kind::kData; }
+        ByteSpan GetData() const { return ByteSpan(mData, mSize); }
+        uint32_t GetSize() const { return mSize; }
+
+    private:
+        friend class ClusterStateCacheFlatStorage;
+
+        enum class Kind : uint8_t
+        {
+            kStatus,
+            kData,
+            kSize,
+        };
+
+        Kind mKind = Kind::kSize;
+        StatusIB mStatus;
+        // Size of the TLV data, whether it is stored or not.
+        uint32_t mSize = 0;
+        // Size of the arena slot holding the data.
+        uint32_t mCapacity = 0;
+        uint8_t * mData    = nullptr;
+    };
+
+    ClusterStateCacheFlatStorage() = default;
+    ~ClusterStateCacheFlatStorage();
+
+    ClusterStateCacheFlatStorage(const ClusterStateCacheFlatStorage &)             = delete;
+    ClusterStateCacheFlatStorage & operator=(const ClusterStateCacheFlatStorage &) = delete;
+
+    bool HasEndpoint(EndpointId endpointId) const;
+    ClusterStateCacheDataVersions & GetOrAddCluster(EndpointId endpointId, ClusterId clusterId);
+    const ClusterStateCacheDataVersions * FindCluster(EndpointId endpointId, ClusterId clusterId) const;
+    const AttributeState * FindAttribute(const ConcreteAttributePath & path) const;
+
+    CHIP_ERROR SetAttributeStatus(const ConcreteAttributePath & path, const StatusIB & status);
+
+    /*
+     * Stores a copy of the element the reader is positioned on, re-tagged as anonymous, in the arena.  The copy is
+     * written to a new slot and only replaces the previous value of the attribute once it is complete, so on
+     * failure the attribute is left as it was.
+     */
+    CHIP_ERROR SetAttributeData(const ConcreteAttributePath & path, TLV::TLVReader & data, uint32_t size);
+
+    CHIP_ERROR SetAttributeSize(const ConcreteAttributePath & path, uint32_t size);
+
+    template <typename IteratorFunc>
+    CHIP_ERROR ForEachAttribute(EndpointId endpointId, ClusterId clusterId, IteratorFunc && func) const
+    {
+        VerifyOrReturnError(FindCluster(endpointId, clusterId) != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
+
+        const uint64_t clusterKey = PackClusterKey(endpointId, clusterId);
+        for (auto iter = LowerBound(clusterKey, 0); iter != mAttributes.end() && iter->mClusterKey == clusterKey; ++iter)
+        {
+            ReturnErrorOnFailure(func(iter->mAttributeId, iter->mState));
+        }
+        return CHIP_NO_ERROR;
+    }
+
+    template <typename IteratorFunc>
+    CHIP_ERROR ForEachCluster(IteratorFunc && func) const
+    {
+        for (auto & cluster : mClusters)
+        {
+            ReturnErrorOnFailure(func(UnpackClusterKey(cluster.mClusterKey), cluster.mDataVersions));
+        }
+        return CHIP_NO_ERROR;
+    }
+
+    template <typename IteratorFunc>
+    CHIP_ERROR ForEachClusterOnEndpoint(EndpointId endpointId, IteratorFunc && func) const
+    {
+        for (auto iter = FindClusterRecord(PackClusterKey(endpointId, 0));
+             iter != mClusters.end() && UnpackClusterKey(iter->mClusterKey).mEndpointId == endpointId; ++iter)
+        {
+            ReturnErrorOnFailure(func(UnpackClusterKey(iter->mClusterKey).mClusterId));
+        }
+        return CHIP_NO_ERROR;
+    }
+
+    void ClearEndpoint(EndpointId endpointId);
+    void ClearCluster(const ConcreteClusterPath & cluster);
+    void ClearAttribute(const ConcreteAttributePath & attribute);
+
+    /*
+     * Bytes of heap held by the arena, including space not yet handed out and released slots waiting to be
+     * reused.  Shared blocks are kept until no value packed into them is left.
+     */
+    size_t GetArenaBytes() const;
+
+    // Size of the shared arena blocks small values are packed into.
+    static constexpr uint32_t kArenaBlockSize = 4096;
+    // Values larger than this get an allocation of their own instead of a slot in a shared block.
+    static constexpr uint32_t kMaxPackedSize = kArenaBlockSize / 4;
+
+private:
+    struct ClusterRecord
+    {
+        uint64_t mClusterKey;
+        ClusterStateCacheDataVersions mDataVersions;
+    };
+
+    struct AttributeRecord
+    {
+        uint64_t mClusterKey;
+        AttributeId mAttributeId;
+        AttributeState mState;
+    };
+
+    static constexpr uint64_t PackClusterKey(EndpointId endpointId, ClusterId clusterId)
+    {
+        return (static_cast<uint64_t>(endpointId) << 32) | clusterId;
+    }
+
+    static ConcreteClusterPath UnpackClusterKey(uint64_t clusterKey)
+    {
+        return ConcreteClusterPath(static_cast<EndpointId>(clusterKey >> 32), static_cast<ClusterId>(clusterKey));
+    }
+
+    // First cluster record whose key is not less than clusterKey.
+    std::vector<ClusterRecord>::const_iterator FindClusterRecord(uint64_t clusterKey) const;
+    // First attribute record whose key is not less than (clusterKey, attributeId).
+    std::vector<AttributeRecord>::const_iterator LowerBound(uint64_t clusterKey, AttributeId attributeId) const;
+
+    AttributeState & GetOrAddAttribute(const ConcreteAttributePath & path);
+    void ReleaseData(AttributeState & state);
+    void ReleaseAttributes(std::vector<AttributeRecord>::iterator first, std::vector<AttributeRecord>::iterator last);
+
+    // Packed slots are rounded up to a multiple of this, which is also large enough to link a released slot
+    // into its free list.
+    static constexpr uint32_t kSlotGranularity = sizeof(uint8_t *);
+
+    static uint32_t SlotCapacity(uint32_t size);
+    uint8_t * ArenaAllocate(uint32_t capacity);
+    void ArenaRelease(uint8_t * slot, uint32_t capacity);
+    void ReleasePackedBlocks();
+
+    std::vector<ClusterRecord> mClusters;
+    std::vector<AttributeRecord> mAttributes;
+
+    // Shared blocks small values are packed into; slots are handed out from the end of the last one.
+    std::vector<uint8_t *> mPackedBlocks;
+    uint32_t mPackedBlockUsed = 0;
+    // Heads of the lists of released packed slots, one list per slot capacity.
+    std::vector<uint8_t *> mFreeSlots;
+    // Bytes of packed slots that hold a value.
+    size_t mPackedLiveBytes = 0;
+    // Bytes of values that got an allocation of their own.
+    size_t mDedicatedBytes = 0;
+};
+
+} // namespace app
+} // namespace chip
@@ -0,0 +1,336 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/ControllerSubscriptionManager.h>
+
+#include <app/InteractionModelEngine.h>
+#include <crypto/RandUtils.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <algorithm>
+
+#if CHIP_CONFIG_ENABLE_READ_CLIENT
+namespace chip {
+namespace app {
+
+namespace {
+
+bool NodeLess(const ScopedNodeId & a, const ScopedNodeId & b)
+{
+    return a.GetFabricIndex() < b.GetFabricIndex() ||
+        (a.GetFabricIndex() == b.GetFabricIndex() && a.GetNodeId() < b.GetNodeId());
+}
+
+template <typename List>
+auto LowerBound(List & nodes, const ScopedNodeId & node)
+{
+    return std::lower_bound(nodes.begin(), nodes.end(), node,
+                            [](const auto & entry, const ScopedNodeId & key) { return NodeLess(entry->GetNodeId(), key); });
+}
+
+} // namespace
+
+//
+// NodeSubscription
+//
+
+ControllerSubscriptionManager::NodeSubscription::NodeSubscription(ControllerSubscriptionManager & manager,
+                                                                  const ScopedNodeId & node) :
+    mManager(manager),
+    mNodeId(node)
+{}
+
+CHIP_ERROR ControllerSubscriptionManager::NodeSubscription::Start(InteractionModelEngine * engine)
+{
+    Stop();
+
+    mFeed       = std::make_unique<SharedClusterStateCache::NodeFeed>(mManager.mCache, mNodeId, *this);
+    mReadClient =
+        std::make_unique<ReadClient>(engine, nullptr, mFeed->GetBufferedCallback(), ReadClient::InteractionType::Subscribe);
+
+    ReadPrepareParams params;
+    params.mpAttributePathParamsList    = mAttributePaths.data();
+    params.mAttributePathParamsListSize = mAttributePaths.size();
+    params.mpEventPathParamsList        = mEventPaths.data();
+    params.mEventPathParamsListSize     = mEventPaths.size();
+    params.mMinIntervalFloorSeconds     = mMinIntervalFloorSeconds;
+    params.mMaxIntervalCeilingSeconds   = mMaxIntervalCeilingSeconds;
+    // Several auto-resubscribing subscriptions coexist, so none of them may cancel the others.
+    params.mKeepSubscriptions = true;
+
+    mStatus.retries = 0;
+    SetState(SubscriptionState::kSubscribing);
+
+    CHIP_ERROR err = mReadClient->SendAutoResubscribeRequest(mNodeId, std::move(params));
+    if (err != CHIP_NO_ERROR)
+    {
+        Stop();
+        SetState(SubscriptionState::kFailed);
+    }
+    return err;
+}
+
+void ControllerSubscriptionManager::NodeSubscription::Stop()
+{
+    mReadClient.reset();
+    mFeed.reset();
+}
+
+void ControllerSubscriptionManager::NodeSubscription::SetState(SubscriptionState state)
+{
+    VerifyOrReturn(mStatus.state != state);
+    mStatus.state = state;
+    if (mManager.mDelegate != nullptr)
+    {
+        mManager.mDelegate->OnSubscriptionStateChanged(mNodeId, state);
+    }
+}
+
+void ControllerSubscriptionManager::NodeSubscription::OnReportEnd()
+{
+    mStatus.lastReportTime = System::SystemClock().GetMonotonicTimestamp();
+}
+
+void ControllerSubscriptionManager::NodeSubscription::OnDone(ReadClient * apReadClient)
+{
+    // The ReadClient is kept until the node is resubscribed or unsubscribed, since this runs from within it.
+    SetState(SubscriptionState::kFailed);
+}
+
+void ControllerSubscriptionManager::NodeSubscription::OnSubscriptionEstablished(SubscriptionId aSubscriptionId)
+{
+    mStatus.retries = 0;
+    SetState(SubscriptionState::kActive);
+}
+
+CHIP_ERROR ControllerSubscriptionManager::NodeSubscription::OnResubscriptionNeeded(ReadClient * apReadClient,
+                                                                                   CHIP_ERROR aTerminationCause)
+{
+    if (aTerminationCause == CHIP_ERROR_LIT_SUBSCRIBE_INACTIVE_TIMEOUT)
+    {
+        // Same as ReadClient::DefaultResubscribePolicy: wait for the ICD to check in.
+        SetState(SubscriptionState::kInactiveICD);
+        return CHIP_ERROR_LIT_SUBSCRIBE_INACTIVE_TIMEOUT;
+    }
+
+    const System::Clock::Milliseconds32 backoff(apReadClient->ComputeTimeTillNextSubscription());
+    const System::Clock::Milliseconds32 delay = mManager.ReserveResubscribeSlot(backoff);
+
+    ChipLogProgress(DataManagement,
+                    "Will try to resubscribe to %02x:" ChipLogFormatX64 " after %" PRIu32 "ms (backoff %" PRIu32
+                    "ms) due to error %" CHIP_ERROR_FORMAT,
+                    mNodeId.GetFabricIndex(), ChipLogValueX64(mNodeId.GetNodeId()), delay.count(), backoff.count(),
+                    aTerminationCause.Format());
+
+    mStatus.retries++;
+    SetState(SubscriptionState::kResubscribing);
+    return apReadClient->ScheduleResubscription(delay.count(), NullOptional, aTerminationCause == CHIP_ERROR_TIMEOUT);
+}
+
+//
+// ControllerSubscriptionManager
+//
+
+CHIP_ERROR ControllerSubscriptionManager::Init(InteractionModelEngine * engine)
+{
+    VerifyOrReturnError(engine != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(mEngine == nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(mConfig.resubscribeWindow.count() > 0 && mConfig.maxResubscribesPerWindow > 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    ReturnErrorOnFailure(mCache.Init());
+    mEngine = engine;
+    return CHIP_NO_ERROR;
+}
+
+void ControllerSubscriptionManager::Shutdown()
+{
+    mNodes.clear();
+    mWindows.clear();
+    mEngine = nullptr;
+}
+
+ControllerSubscriptionManager::NodeList::iterator ControllerSubscriptionManager::FindNode(const ScopedNodeId & node)
+{
+    auto it = LowerBound(mNodes, node);
+    return (it != mNodes.end() && (*it)->GetNodeId() == node) ? it : mNodes.end();
+}
+
+ControllerSubscriptionManager::NodeList::const_iterator ControllerSubscriptionManager::FindNode(const ScopedNodeId & node) const
+{
+    auto it = LowerBound(mNodes, node);
+    return (it != mNodes.end() && (*it)->GetNodeId() == node) ? it : mNodes.end();
+}
+
+CHIP_ERROR ControllerSubscriptionManager::Subscribe(const ScopedNodeId & node,
+                                                    const Span<const AttributePathParams> & attributePaths,
+                                                    const Span<const EventPathParams> & eventPaths,
+                                                    uint16_t minIntervalFloorSeconds, uint16_t maxIntervalCeilingSeconds)
+{
+    VerifyOrReturnError(mEngine != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(node.GetFabricIndex() != kUndefinedFabricIndex, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(!attributePaths.empty() || !eventPaths.empty(), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(FindNode(node) == mNodes.end(), CHIP_ERROR_INCORRECT_STATE);
+
+    auto subscription = std::make_unique<NodeSubscription>(*this, node);
+    subscription->mAttributePaths.assign(attributePaths.begin(), attributePaths.end());
+    subscription->mEventPaths.assign(eventPaths.begin(), eventPaths.end());
+    subscription->mMinIntervalFloorSeconds   = minIntervalFloorSeconds;
+    subscription->mMaxIntervalCeilingSeconds = maxIntervalCeilingSeconds;
+
+    ReturnErrorOnFailure(subscription->Start(mEngine));
+
+    mNodes.insert(LowerBound(mNodes, node), std::move(subscription));
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ControllerSubscriptionManager::Resubscribe(const ScopedNodeId & node)
+{
+    VerifyOrReturnError(mEngine != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    auto it = FindNode(node);
+    VerifyOrReturnError(it != mNodes.end(), CHIP_ERROR_KEY_NOT_FOUND);
+    return (*it)->Start(mEngine);
+}
+
+void ControllerSubscriptionManager::Unsubscribe(const ScopedNodeId & node)
+{
+    auto it = FindNode(node);
+    VerifyOrReturn(it != mNodes.end());
+
+    mNodes.erase(it);
+    mCache.RemoveNode(node);
+}
+
+CHIP_ERROR ControllerSubscriptionManager::GetNodeStatus(const ScopedNodeId & node, NodeStatus & status) const
+{
+    auto it = FindNode(node);
+    VerifyOrReturnError(it != mNodes.end(), CHIP_ERROR_KEY_NOT_FOUND);
+
+    status = (*it)->mStatus;
+    return CHIP_NO_ERROR;
+}
+
+ControllerSubscriptionManager::Liveness ControllerSubscriptionManager::GetLiveness() const
+{
+    const System::Clock::Timestamp now = System::SystemClock().GetMonotonicTimestamp();
+    Liveness liveness;
+
+    for (const auto & subscription : mNodes)
+    {
+        const NodeStatus & status = subscription->mStatus;
+        switch (status.state)
+        {
+        case SubscriptionState::kSubscribing:
+            liveness.subscribing++;
+            break;
+        case SubscriptionState::kActive:
+            liveness.active++;
+            if (status.lastReportTime != System::Clock::kZero && now > status.lastReportTime)
+            {
+                liveness.maxReportAge = std::max<System::Clock::Milliseconds64>(liveness.maxReportAge, now - status.lastReportTime);
+            }
+            break;
+        case SubscriptionState::kResubscribing:
+            liveness.resubscribing++;
+            break;
+        case SubscriptionState::kInactiveICD:
+            liveness.inactiveICD++;
+            break;
+        case SubscriptionState::kFailed:
+            liveness.failed++;
+            break;
+        }
+
+        if (!status.hasData)
+        {
+            liveness.evicted++;
+        }
+    }
+
+    return liveness;
+}
+
+System::Clock::Milliseconds32 ControllerSubscriptionManager::ReserveResubscribeSlot(System::Clock::Milliseconds32 requestedDelay)
+{
+    const uint64_t windowMs = mConfig.resubscribeWindow.count();
+    const uint64_t nowMs    = System::SystemClock().GetMonotonicMilliseconds64().count();
+    const uint64_t wantedMs = nowMs + requestedDelay.count();
+
+    // Windows that have ended can no longer take an attempt.
+    mWindows.erase(mWindows.begin(), mWindows.lower_bound(nowMs / windowMs));
+
+    // Take the first window, from the wanted one on, that still has room.  The map is ordered, so the full
+    // windows that follow the wanted one are consecutive entries.
+    uint64_t window = wantedMs / windowMs;
+    for (auto it = mWindows.find(window); it != mWindows.end() && it->first == window; ++it)
+    {
+        if (it->second < mConfig.maxResubscribesPerWindow)
+        {
+            break;
+        }
+        window++;
+    }
+    mWindows[window]++;
+
+    mStats.resubscribesScheduled++;
+    if (window == wantedMs / windowMs)
+    {
+        return requestedDelay;
+    }
+
+    // Spread the attempts moved into a later window over that window, so they do not all fire at its start.
+    const uint64_t startMs = window * windowMs + Crypto::GetRandU32() % windowMs;
+    const System::Clock::Milliseconds32 delay(static_cast<uint32_t>(std::min<uint64_t>(startMs - nowMs, UINT32_MAX)));
+
+    mStats.resubscribesDeferred++;
+    mStats.maxDeferral = std::max(mStats.maxDeferral, System::Clock::Milliseconds32(delay - requestedDelay));
+    return delay;
+}
+
+void ControllerSubscriptionManager::OnNodeUpdated(const ScopedNodeId & node)
+{
+    auto it = FindNode(node);
+    if (it != mNodes.end())
+    {
+        (*it)->mStatus.hasData = true;
+    }
+
+    if (mDelegate != nullptr)
+    {
+        mDelegate->OnNodeUpdated(node);
+    }
+}
+
+void ControllerSubscriptionManager::OnNodeEvicted(const ScopedNodeId & node)
+{
+    auto it = FindNode(node);
+    if (it != mNodes.end())
+    {
+        (*it)->mStatus.hasData = false;
+    }
+
+    if (mDelegate != nullptr)
+    {
+        mDelegate->OnNodeEvicted(node);
+    }
+}
+
+} // namespace app
+} // namespace chip
+#endif // CHIP_CONFIG_ENABLE_READ_CLIENT
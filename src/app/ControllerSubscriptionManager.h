@@ -0,0 +1,270 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @file
+ *   ControllerSubscriptionManager keeps one auto-resubscribing subscription per node for a controller that
+ *   follows many nodes at once.  It owns the ReadClients, feeds every report into a SharedClusterStateCache, so
+ *   that all nodes share one memory budget, and tracks the liveness of each subscription.
+ *
+ *   When many subscriptions drop at the same time, e.g. because a border router rebooted, each ReadClient would
+ *   compute its own Fibonacci backoff and most of them would resubscribe within the same second.  Instead, the
+ *   manager hands out resubscription times from one shared schedule: time is split into windows of
+ *   Config::resubscribeWindow, at most Config::maxResubscribesPerWindow attempts are placed in each window, and an
+ *   attempt whose window is full moves to the next window with room.  Each node still backs off on its own
+ *   schedule; the shared schedule only ever delays an attempt, so a storm is spread out over time.
+ */
+
+#pragma once
+
+#include <app/AppConfig.h>
+#include <app/AttributePathParams.h>
+#include <app/EventPathParams.h>
+#include <app/ReadClient.h>
+#include <app/SharedClusterStateCache.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/ScopedNodeId.h>
+#include <lib/support/Span.h>
+#include <system/SystemClock.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#if CHIP_CONFIG_ENABLE_READ_CLIENT
+namespace chip {
+namespace app {
+
+class InteractionModelEngine;
+
+class ControllerSubscriptionManager : private SharedClusterStateCache::Delegate
+{
+public:
+    enum class SubscriptionState : uint8_t
+    {
+        kSubscribing,   // The first subscribe request has not succeeded yet.
+        kActive,        // The subscription is established and the node is reporting.
+        kResubscribing, // The subscription dropped and a resubscription is scheduled or in progress.
+        kInactiveICD,   // The node is a LIT ICD that is idle; it resubscribes once it checks in.
+        kFailed,        // The subscription ended for good; see Resubscribe().
+    };
+
+    struct Config
+    {
+        // Length of a window of the shared resubscription schedule.
+        System::Clock::Milliseconds32 resubscribeWindow = System::Clock::Milliseconds32(1000);
+        // Maximum number of resubscription attempts placed in one window.
+        uint16_t maxResubscribesPerWindow = 8;
+    };
+
+    struct NodeStatus
+    {
+        SubscriptionState state = SubscriptionState::kSubscribing;
+        // False once the node was evicted from the cache to stay within the memory budget.
+        bool hasData = true;
+        // Number of resubscriptions since the subscription was last established.
+        uint32_t retries = 0;
+        // When the last report from the node ended, or kZero if none has been received yet.
+        System::Clock::Timestamp lastReportTime = System::Clock::kZero;
+    };
+
+    /**
+     * Aggregated liveness of all managed subscriptions.
+     */
+    struct Liveness
+    {
+        uint32_t subscribing   = 0;
+        uint32_t active        = 0;
+        uint32_t resubscribing = 0;
+        uint32_t inactiveICD   = 0;
+        uint32_t failed        = 0;
+        uint32_t evicted       = 0; // Nodes whose data was evicted from the cache.
+        // Time since the last report of the active node that has been quiet the longest.
+        System::Clock::Milliseconds64 maxReportAge = System::Clock::kZero;
+    };
+
+    struct Stats
+    {
+        uint32_t resubscribesScheduled = 0;
+        uint32_t resubscribesDeferred  = 0; // Attempts pushed later because their window was full.
+        System::Clock::Milliseconds32 maxDeferral = System::Clock::kZero;
+    };
+
+    class Delegate
+    {
+    public:
+        virtual ~Delegate() = default;
+
+        /*
+         * Called when the subscription to `node` moves to another SubscriptionState.
+         */
+        virtual void OnSubscriptionStateChanged(const ScopedNodeId & node, SubscriptionState state) {}
+
+        /*
+         * Same as SharedClusterStateCache::Delegate::OnNodeUpdated.
+         */
+        virtual void OnNodeUpdated(const ScopedNodeId & node) {}
+
+        /*
+         * Called after the data of `node` was evicted from the cache.  The subscription stays up, but only reports
+         * changes, so call Resubscribe() to get the state of the node back.
+         */
+        virtual void OnNodeEvicted(const ScopedNodeId & node) {}
+    };
+
+    /*
+     * @param [in] memoryBudget the number of bytes the cached state of all nodes may take.
+     * @param [in] delegate optional delegate notified of state changes, node updates and evictions.
+     */
+    ControllerSubscriptionManager(size_t memoryBudget, Delegate * delegate = nullptr) :
+        mCache(memoryBudget, this), mDelegate(delegate)
+    {}
+    ControllerSubscriptionManager(size_t memoryBudget, const Config & config, Delegate * delegate = nullptr) :
+        mConfig(config), mCache(memoryBudget, this), mDelegate(delegate)
+    {}
+    ~ControllerSubscriptionManager() override { Shutdown(); }
+
+    ControllerSubscriptionManager(const ControllerSubscriptionManager &)             = delete;
+    ControllerSubscriptionManager & operator=(const ControllerSubscriptionManager &) = delete;
+
+    CHIP_ERROR Init(InteractionModelEngine * engine);
+
+    /*
+     * Tear down all subscriptions.  The cached data stays available until the manager is destroyed.
+     */
+    void Shutdown();
+
+    /*
+     * Subscribe to `node` and keep the subscription up.  The paths are copied.  The ReadClient establishes the
+     * CASE session to the node itself, so callers do not need a session up front.
+     *
+     * @retval CHIP_ERROR_INCORRECT_STATE if the manager is not initialized or already subscribes to `node`.
+     */
+    CHIP_ERROR Subscribe(const ScopedNodeId & node, const Span<const AttributePathParams> & attributePaths,
+                         const Span<const EventPathParams> & eventPaths, uint16_t minIntervalFloorSeconds,
+                         uint16_t maxIntervalCeilingSeconds);
+
+    /*
+     * Tear down the subscription to `node` and start a new one with the same paths, e.g. after its data was
+     * evicted or after it failed.  Must not be called from within a callback for the node.
+     */
+    CHIP_ERROR Resubscribe(const ScopedNodeId & node);
+
+    /*
+     * Tear down the subscription to `node` and drop its data from the cache.  Must not be called from within a
+     * callback for the node.
+     */
+    void Unsubscribe(const ScopedNodeId & node);
+
+    /*
+     * Retrieve the status of the subscription to `node`.
+     *
+     * @retval CHIP_ERROR_KEY_NOT_FOUND if the manager does not subscribe to `node`.
+     */
+    CHIP_ERROR GetNodeStatus(const ScopedNodeId & node, NodeStatus & status) const;
+
+    Liveness GetLiveness() const;
+    const Stats & GetStats() const { return mStats; }
+
+    size_t GetNodeCount() const { return mNodes.size(); }
+
+    /*
+     * The cache every subscription feeds; take snapshots from it to read node state.
+     */
+    SharedClusterStateCache & GetCache() { return mCache; }
+
+    /*
+     * Place a resubscription attempt that would like to start `requestedDelay` from now on the shared schedule,
+     * and return the delay after which it should actually start.  The returned delay is never shorter than the
+     * requested one.  This is what the managed subscriptions use; it is public for applications that run their
+     * own resubscribe policy on other ReadClients and want them paced along.
+     */
+    System::Clock::Milliseconds32 ReserveResubscribeSlot(System::Clock::Milliseconds32 requestedDelay);
+
+private:
+    friend class TestControllerSubscriptionManager;
+
+    class NodeSubscription : public ReadClient::Callback
+    {
+    public:
+        NodeSubscription(ControllerSubscriptionManager & manager, const ScopedNodeId & node);
+
+        CHIP_ERROR Start(InteractionModelEngine * engine);
+        void Stop();
+
+        const ScopedNodeId & GetNodeId() const { return mNodeId; }
+
+        std::vector<AttributePathParams> mAttributePaths;
+        std::vector<EventPathParams> mEventPaths;
+        uint16_t mMinIntervalFloorSeconds   = 0;
+        uint16_t mMaxIntervalCeilingSeconds = 0;
+        NodeStatus mStatus;
+
+    private:
+        friend class TestControllerSubscriptionManager;
+
+        void SetState(SubscriptionState state);
+
+        //
+        // ReadClient::Callback, behind the NodeFeed
+        //
+        void OnReportEnd() override;
+        void OnAttributeData(const ConcreteDataAttributePath & aPath, TLV::TLVReader * apData, const StatusIB & aStatus) override
+        {}
+        void OnDone(ReadClient * apReadClient) override;
+        void OnSubscriptionEstablished(SubscriptionId aSubscriptionId) override;
+        CHIP_ERROR OnResubscriptionNeeded(ReadClient * apReadClient, CHIP_ERROR aTerminationCause) override;
+        void OnDeallocatePaths(ReadPrepareParams && aReadPrepareParams) override {}
+
+        ControllerSubscriptionManager & mManager;
+        const ScopedNodeId mNodeId;
+        std::unique_ptr<SharedClusterStateCache::NodeFeed> mFeed;
+        std::unique_ptr<ReadClient> mReadClient;
+    };
+
+    using NodeList = std::vector<std::unique_ptr<NodeSubscription>>; // sorted by node
+
+    NodeList::iterator FindNode(const ScopedNodeId & node);
+    NodeList::const_iterator FindNode(const ScopedNodeId & node) const;
+
+    //
+    // SharedClusterStateCache::Delegate
+    //
+    void OnNodeUpdated(const ScopedNodeId & node) override;
+    void OnNodeEvicted(const ScopedNodeId & node) override;
+
+    Config mConfig;
+    SharedClusterStateCache mCache;
+    Delegate * mDelegate;
+    InteractionModelEngine * mEngine = nullptr;
+
+    NodeList mNodes;
+
+    // Number of attempts placed in each window of the shared schedule, keyed by window index since the epoch of
+    // the monotonic clock.  Windows that have passed are dropped as new attempts are placed.
+    std::map<uint64_t, uint16_t> mWindows;
+
+    Stats mStats;
+};
+
+} // namespace app
+} // namespace chip
+#endif // CHIP_CONFIG_ENABLE_READ_CLIENT
@@ -0,0 +1,234 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/EventLogQueue.h>
+
+#include <app/EventLoggingDelegate.h>
+#include <app/MessageDef/EventDataIB.h>
+#include <lib/core/TLVReader.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <platform/PlatformManager.h>
+
+#include <string.h>
+
+namespace chip {
+namespace app {
+
+namespace {
+
+/**
+ * Writes a pre-encoded event payload into the event log, retagged as the EventDataIB data field.
+ */
+class EncodedEventLogger : public EventLoggingDelegate
+{
+public:
+    EncodedEventLogger(ByteSpan aPayload) : mPayload(aPayload) {}
+
+    CHIP_ERROR WriteEvent(TLV::TLVWriter & aWriter) override
+    {
+        TLV::TLVReader reader;
+        reader.Init(mPayload);
+        ReturnErrorOnFailure(reader.Next());
+        return aWriter.CopyElement(TLV::ContextTag(EventDataIB::Tag::kData), reader);
+    }
+
+private:
+    ByteSpan mPayload;
+};
+
+} // namespace
+
+EventLogQueue * EventLogQueue::sInitializedQueues = nullptr;
+
+CHIP_ERROR EventLogQueue::Init(EventManagement * apEventManagement, Span<EventLogQueueSlot> aSlots)
+{
+    VerifyOrReturnError(apEventManagement != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(!aSlots.empty() && ((aSlots.size() & (aSlots.size() - 1)) == 0), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(!mAcceptingEvents.load(), CHIP_ERROR_INCORRECT_STATE);
+
+    mpEventManagement = apEventManagement;
+    mpSlots           = aSlots.data();
+    mMask             = aSlots.size() - 1;
+    mDequeuePosition  = 0;
+    mEnqueuePosition.store(0, std::memory_order_relaxed);
+
+    for (size_t i = 0; i < aSlots.size(); i++)
+    {
+        mpSlots[i].mSequence.store(i, std::memory_order_relaxed);
+    }
+
+    mDroppedFull.store(0, std::memory_order_relaxed);
+    mDroppedOversize.store(0, std::memory_order_relaxed);
+    mLogFailures.store(0, std::memory_order_relaxed);
+
+    // A drain left over from before a previous Shutdown may or may not still run; either way a new one must be
+    // scheduled for the first event.
+    mDrainScheduled.store(false, std::memory_order_relaxed);
+
+    mpNextInitialized  = sInitializedQueues;
+    sInitializedQueues = this;
+
+    mAcceptingEvents.store(true, std::memory_order_release);
+    return CHIP_NO_ERROR;
+}
+
+void EventLogQueue::Shutdown()
+{
+    VerifyOrReturn(mAcceptingEvents.exchange(false));
+
+    // Producers that already claimed a slot may still be copying their payload; Drain stops at the first slot that
+    // is not yet published, so those events are dropped together with the queue.
+    while (Drain(mMask + 1) != 0)
+    {
+    }
+    mpEventManagement = nullptr;
+
+    for (EventLogQueue ** link = &sInitializedQueues; *link != nullptr; link = &(*link)->mpNextInitialized)
+    {
+        if (*link == this)
+        {
+            *link = mpNextInitialized;
+            break;
+        }
+    }
+    mpNextInitialized = nullptr;
+}
+
+CHIP_ERROR EventLogQueue::Enqueue(const EventOptions & aOptions, ByteSpan aEncodedPayload)
+{
+    VerifyOrReturnError(mAcceptingEvents.load(std::memory_order_acquire), CHIP_ERROR_INCORRECT_STATE);
+
+    if (aEncodedPayload.size() > sizeof(EventLogQueueSlot::mPayload))
+    {
+        mDroppedOversize.fetch_add(1, std::memory_order_relaxed);
+        return CHIP_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    // Bounded multi-producer claim protocol: a slot is free for position `pos` when its sequence equals `pos`, and holds a
+    // published event for the consumer when its sequence equals `pos + 1`.
+    EventLogQueueSlot * slot = nullptr;
+    size_t pos               = mEnqueuePosition.load(std::memory_order_relaxed);
+    while (true)
+    {
+        slot              = &mpSlots[pos & mMask];
+        const size_t seq  = slot->mSequence.load(std::memory_order_acquire);
+        const auto offset = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (offset == 0)
+        {
+            if (mEnqueuePosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (offset < 0)
+        {
+            mDroppedFull.fetch_add(1, std::memory_order_relaxed);
+            return CHIP_ERROR_NO_MEMORY;
+        }
+        else
+        {
+            pos = mEnqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->mOptions       = aOptions;
+    slot->mPayloadLength = static_cast<uint16_t>(aEncodedPayload.size());
+    memcpy(slot->mPayload, aEncodedPayload.data(), aEncodedPayload.size());
+    slot->mSequence.store(pos + 1, std::memory_order_release);
+
+    ScheduleDrain();
+    return CHIP_NO_ERROR;
+}
+
+size_t EventLogQueue::Drain(size_t aMaxEvents)
+{
+    VerifyOrReturnValue(mpEventManagement != nullptr, 0);
+    assertChipStackLockedByCurrentThread();
+
+    size_t drained = 0;
+    while (drained < aMaxEvents)
+    {
+        EventLogQueueSlot & slot = mpSlots[mDequeuePosition & mMask];
+        if (slot.mSequence.load(std::memory_order_acquire) != mDequeuePosition + 1)
+        {
+            break;
+        }
+
+        EncodedEventLogger logger(ByteSpan(slot.mPayload, slot.mPayloadLength));
+        EventNumber eventNumber;
+        CHIP_ERROR err = mpEventManagement->LogEvent(&logger, slot.mOptions, eventNumber);
+        if (err != CHIP_NO_ERROR)
+        {
+            mLogFailures.fetch_add(1, std::memory_order_relaxed);
+            ChipLogError(EventLogging, "Failed to log queued event: %" CHIP_ERROR_FORMAT, err.Format());
+        }
+
+        // Hand the slot back to producers for the next lap around the ring.
+        slot.mSequence.store(mDequeuePosition + mMask + 1, std::memory_order_release);
+        mDequeuePosition++;
+        drained++;
+    }
+
+    return drained;
+}
+
+void EventLogQueue::ScheduleDrain()
+{
+    if (mDrainScheduled.exchange(true, std::memory_order_acq_rel))
+    {
+        return;
+    }
+
+    if (DeviceLayer::PlatformMgr().ScheduleWork(DrainWork, reinterpret_cast<intptr_t>(this)) != CHIP_NO_ERROR)
+    {
+        // Leave the events queued; the next successful enqueue will try to schedule the drain again.
+        mDrainScheduled.store(false, std::memory_order_release);
+    }
+}
+
+bool EventLogQueue::IsInitialized(const EventLogQueue * apQueue)
+{
+    for (const EventLogQueue * queue = sInitializedQueues; queue != nullptr; queue = queue->mpNextInitialized)
+    {
+        if (queue == apQueue)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void EventLogQueue::DrainWork(intptr_t aContext)
+{
+    auto * queue = reinterpret_cast<EventLogQueue *>(aContext);
+
+    // The queue may have been shut down, and even destroyed, since this drain was scheduled.
+    VerifyOrReturn(IsInitialized(queue));
+
+    // Clear the flag before draining so that an event published while we drain schedules another pass.
+    queue->mDrainScheduled.store(false, std::memory_order_release);
+    if (queue->Drain(CHIP_CONFIG_EVENT_LOG_QUEUE_DRAIN_BATCH_SIZE) == CHIP_CONFIG_EVENT_LOG_QUEUE_DRAIN_BATCH_SIZE)
+    {
+        // Give the rest of the event loop a chance to run before logging the next batch.
+        queue->ScheduleDrain();
+    }
+}
+
+} // namespace app
+} // namespace chip
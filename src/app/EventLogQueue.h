@@ -0,0 +1,179 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @file
+ *
+ * @brief
+ *   A bounded, lock-free, multi-producer / single-consumer queue that lets any thread hand pre-encoded
+ *   events to EventManagement without taking the Matter stack lock.
+ *
+ * Producers copy the TLV-encoded event payload into a queue slot and return immediately.  The queue
+ * schedules a drain on the Matter thread, which logs the queued events into the circular priority
+ * buffers in batches through EventManagement::LogEvent.  When the queue is full, or an event does not
+ * fit in a slot, the event is dropped and counted instead of blocking the producer.
+ *
+ * Event timestamps and event numbers are assigned when the event is drained, not when it is enqueued.
+ */
+
+#pragma once
+
+#include <app/ConcreteEventPath.h>
+#include <app/EventLoggingTypes.h>
+#include <app/EventManagement.h>
+#include <app/data-model/Encode.h>
+#include <app/data-model/FabricScoped.h>
+#include <lib/core/CHIPConfig.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/TLVWriter.h>
+#include <lib/support/Span.h>
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+namespace app {
+
+/**
+ * @brief
+ *   Storage for one queued event.  The array of slots is provided by the caller of EventLogQueue::Init.
+ */
+struct EventLogQueueSlot
+{
+    std::atomic<size_t> mSequence{ 0 };
+    EventOptions mOptions;
+    uint16_t mPayloadLength = 0;
+    uint8_t mPayload[CHIP_CONFIG_EVENT_LOG_QUEUE_MAX_PAYLOAD_SIZE];
+};
+
+class EventLogQueue
+{
+public:
+    ~EventLogQueue() { Shutdown(); }
+
+    /**
+     * @brief
+     *   Initialize the queue.  Must be called on the Matter thread.
+     *
+     * @param[in] apEventManagement  Event log the queued events are drained into.
+     * @param[in] aSlots             Slot storage; the number of slots must be a non-zero power of two.
+     */
+    CHIP_ERROR Init(EventManagement * apEventManagement, Span<EventLogQueueSlot> aSlots);
+
+    /**
+     * @brief
+     *   Drain any queued events and stop accepting new ones.  Must be called on the Matter thread.
+     *
+     *   A drain that is still scheduled on the event loop when Shutdown returns does nothing, so the queue
+     *   may be destroyed right away.  Producers must have stopped calling Enqueue before it is.
+     */
+    void Shutdown();
+
+    /**
+     * @brief
+     *   Queue a pre-encoded event.  Safe to call from any thread without holding the stack lock.
+     *
+     * @param[in] aOptions         Path, priority and fabric index of the event.  The timestamp is ignored.
+     * @param[in] aEncodedPayload  A single TLV element holding the event data.  Its tag is replaced by the
+     *                             EventDataIB data tag when the event is logged.
+     *
+     * @retval #CHIP_ERROR_INCORRECT_STATE  The queue is not initialized.
+     * @retval #CHIP_ERROR_BUFFER_TOO_SMALL The payload does not fit in a slot; the event was dropped.
+     * @retval #CHIP_ERROR_NO_MEMORY        The queue is full; the event was dropped.
+     */
+    CHIP_ERROR Enqueue(const EventOptions & aOptions, ByteSpan aEncodedPayload);
+
+    /**
+     * @brief
+     *   Encode a cluster event on the calling thread and queue it.  Safe to call from any thread without
+     *   holding the stack lock.
+     */
+    template <typename T>
+    CHIP_ERROR Enqueue(const T & aEventData, EndpointId aEndpoint)
+    {
+        uint8_t buffer[CHIP_CONFIG_EVENT_LOG_QUEUE_MAX_PAYLOAD_SIZE];
+        TLV::TLVWriter writer;
+        writer.Init(buffer);
+
+        CHIP_ERROR err = DataModel::Encode(writer, TLV::AnonymousTag(), aEventData);
+        if (err == CHIP_ERROR_BUFFER_TOO_SMALL || err == CHIP_ERROR_NO_MEMORY)
+        {
+            mDroppedOversize.fetch_add(1, std::memory_order_relaxed);
+            return CHIP_ERROR_BUFFER_TOO_SMALL;
+        }
+        ReturnErrorOnFailure(err);
+        ReturnErrorOnFailure(writer.Finalize());
+
+        EventOptions options;
+        options.mPath     = ConcreteEventPath(aEndpoint, aEventData.GetClusterId(), aEventData.GetEventId());
+        options.mPriority = aEventData.GetPriorityLevel();
+        if constexpr (DataModel::IsFabricScoped<T>::value)
+        {
+            options.mFabricIndex = aEventData.GetFabricIndex();
+            // Same rule as LogEvent: fabric-scoped events without a fabric association are not logged.
+            VerifyOrReturnError(options.mFabricIndex != kUndefinedFabricIndex, CHIP_ERROR_INVALID_FABRIC_INDEX);
+        }
+
+        return Enqueue(options, ByteSpan(buffer, writer.GetLengthWritten()));
+    }
+
+    /**
+     * @brief
+     *   Log up to aMaxEvents queued events into the event log.  Must be called on the Matter thread with
+     *   the stack lock held.
+     *
+     * @return The number of events taken off the queue.
+     */
+    size_t Drain(size_t aMaxEvents);
+
+    /// Events dropped because the queue was full.
+    uint32_t GetDroppedFullCount() const { return mDroppedFull.load(std::memory_order_relaxed); }
+    /// Events dropped because their payload did not fit in a slot.
+    uint32_t GetDroppedOversizeCount() const { return mDroppedOversize.load(std::memory_order_relaxed); }
+    /// Events taken off the queue that EventManagement failed to log.
+    uint32_t GetLogFailureCount() const { return mLogFailures.load(std::memory_order_relaxed); }
+
+private:
+    static void DrainWork(intptr_t aContext);
+    static bool IsInitialized(const EventLogQueue * apQueue);
+    void ScheduleDrain();
+
+    // Queues between Init and Shutdown.  A scheduled drain only carries the queue address, which is looked up
+    // here before it is dereferenced.  Only used on the Matter thread.
+    static EventLogQueue * sInitializedQueues;
+    EventLogQueue * mpNextInitialized = nullptr;
+
+    EventManagement * mpEventManagement = nullptr;
+    EventLogQueueSlot * mpSlots         = nullptr;
+    size_t mMask                        = 0;
+
+    // Producers claim slots by advancing mEnqueuePosition; only the Matter thread touches mDequeuePosition.
+    std::atomic<size_t> mEnqueuePosition{ 0 };
+    size_t mDequeuePosition = 0;
+
+    std::atomic<bool> mAcceptingEvents{ false };
+    std::atomic<bool> mDrainScheduled{ false };
+
+    std::atomic<uint32_t> mDroppedFull{ 0 };
+    std::atomic<uint32_t> mDroppedOversize{ 0 };
+    std::atomic<uint32_t> mLogFailures{ 0 };
+};
+
+} // namespace app
+} // namespace chip
@@ -22,6 +22,7 @@
 #include <app/EventManagement.h>
 #include <app/InteractionModelEngine.h>
 #include <app/RequiredPrivilege.h>
+#include <algorithm>
 #include <assert.h>
 #include <inttypes.h>
 #include <lib/core/TLVUtilities.h>
@@ -102,7 +103,7 @@ CHIP_ERROR EventManagement::Init(Messaging::ExchangeManager * apExchangeManager,
 
         current = &apCircularEventBuffer[bufferIndex];
         current->Init(apLogStorageResources[bufferIndex].mpBuffer, apLogStorageResources[bufferIndex].mBufferSize, prev, next,
-                      apLogStorageResources[bufferIndex].mPriority);
+                      apLogStorageResources[bufferIndex].mPriority, apLogStorageResources[bufferIndex].mpStore);
 
         prev = current;
 
@@ -121,6 +122,8 @@ CHIP_ERROR EventManagement::Init(Messaging::ExchangeManager * apExchangeManager,
 
     mpEventReporter = apEventReporter;
 
+    mEvictionGeneration++;
+
     return CHIP_NO_ERROR;
 }
 
@@ -188,6 +191,9 @@ CHIP_ERROR EventManagement::EnsureSpaceInCircularBuffer(size_t aRequiredSpace, P
     // check whether we actually need to do anything, exit if we don't
     VerifyOrExit(requiredSpace > eventBuffer->AvailableDataLength(), err = CHIP_NO_ERROR);
 
+    // Events are about to be evicted or moved, so any outstanding read cursor is stale.
+    mEvictionGeneration++;
+
     while (true)
     {
         if (requiredSpace > eventBuffer->AvailableDataLength())
@@ -198,6 +204,10 @@ CHIP_ERROR EventManagement::EnsureSpaceInCircularBuffer(size_t aRequiredSpace, P
             eventBuffer->mProcessEvictedElement = EvictEvent;
             eventBuffer->mAppData               = &ctx;
             err                                 = eventBuffer->EvictHead();
+            if (err == CHIP_NO_ERROR)
+            {
+                eventBuffer->CommitLayout();
+            }
 
             // one of two things happened: either the element was evicted immediately if the head's priority is same as current
             // buffer(final one), or we figured out how much space we need to evict it into the next buffer, the check happens in
@@ -226,6 +236,7 @@ CHIP_ERROR EventManagement::EnsureSpaceInCircularBuffer(size_t aRequiredSpace, P
                     // caller know that we could not honor the
                     // request
                     SuccessOrExit(err);
+                    eventBuffer->CommitLayout();
                     continue;
                 }
                 // we cannot copy event outright. We remember the
@@ -378,14 +389,18 @@ CHIP_ERROR EventManagement::CopyAndAdjustDeltaTime(const TLVReader & aReader, si
         // Does not go on the wire.
         return CHIP_NO_ERROR;
     }
+    // Events restored from persistent storage carry system timestamps from an earlier boot, so only use a delta
+    // when time did not go backwards.
     if ((aReader.GetTag() == TLV::ContextTag(EventDataIB::Tag::kSystemTimestamp)) && !(ctx->mpContext->mFirst) &&
-        (ctx->mpContext->mCurrentTime.mType == ctx->mpContext->mPreviousTime.mType))
+        (ctx->mpContext->mCurrentTime.mType == ctx->mpContext->mPreviousTime.mType) &&
+        (ctx->mpContext->mCurrentTime.mValue >= ctx->mpContext->mPreviousTime.mValue))
     {
         return ctx->mpWriter->Put(TLV::ContextTag(EventDataIB::Tag::kDeltaSystemTimestamp),
                                   ctx->mpContext->mCurrentTime.mValue - ctx->mpContext->mPreviousTime.mValue);
     }
     if ((aReader.GetTag() == TLV::ContextTag(EventDataIB::Tag::kEpochTimestamp)) && !(ctx->mpContext->mFirst) &&
-        (ctx->mpContext->mCurrentTime.mType == ctx->mpContext->mPreviousTime.mType))
+        (ctx->mpContext->mCurrentTime.mType == ctx->mpContext->mPreviousTime.mType) &&
+        (ctx->mpContext->mCurrentTime.mValue >= ctx->mpContext->mPreviousTime.mValue))
     {
         return ctx->mpWriter->Put(TLV::ContextTag(EventDataIB::Tag::kDeltaEpochTimestamp),
                                   ctx->mpContext->mCurrentTime.mValue - ctx->mpContext->mPreviousTime.mValue);
@@ -644,24 +659,53 @@ CHIP_ERROR EventManagement::CopyEventsSince(const TLVReader & aReader, size_t aD
 
 CHIP_ERROR EventManagement::FetchEventsSince(TLVWriter & aWriter, const SingleLinkedListNode<EventPathParams> * apEventPathList,
                                              EventNumber & aEventMin, size_t & aEventCount,
-                                             const Access::SubjectDescriptor & aSubjectDescriptor)
+                                             const Access::SubjectDescriptor & aSubjectDescriptor, EventReadCursor * apCursor)
 {
     // TODO: Add particular set of event Paths in FetchEventsSince so that we can filter the interested paths
-    CHIP_ERROR err     = CHIP_NO_ERROR;
-    const bool recurse = false;
+    CHIP_ERROR err = CHIP_NO_ERROR;
     TLVReader reader;
     CircularEventBufferWrapper bufWrapper;
     EventLoadOutContext context(aWriter, PriorityLevel::Invalid, aEventMin);
+    CircularEventBuffer * startBuffer = GetPriorityBuffer(PriorityLevel::Critical);
+    uint32_t startOffset              = 0;
+    uint32_t eventStart               = 0;
+    bool stoppedOnEventBoundary       = false;
 
     context.mSubjectDescriptor     = aSubjectDescriptor;
     context.mpInterestedEventPaths = apEventPathList;
-    err                            = GetEventReader(reader, PriorityLevel::Critical, &bufWrapper);
-    SuccessOrExit(err);
 
-    err = TLV::Utilities::Iterate(reader, CopyEventsSince, &context, recurse);
-    if (err == CHIP_END_OF_TLV)
+    if (apCursor != nullptr && IsCursorValid(*apCursor, aEventMin))
     {
-        err = CHIP_NO_ERROR;
+        // Everything before the cursor has event number below aEventMin, so there is no need to walk it again.
+        startBuffer = apCursor->mpBuffer;
+        startOffset = apCursor->mOffset;
+        // If nothing past the cursor gets visited, aEventMin must come out unchanged.
+        context.mCurrentEventNumber = aEventMin - 1;
+    }
+
+    VerifyOrExit(startBuffer != nullptr, err = CHIP_ERROR_INVALID_ARGUMENT);
+    bufWrapper.mpCurrent    = startBuffer;
+    bufWrapper.mStartOffset = startOffset;
+    {
+        CircularEventReader circularReader;
+        circularReader.Init(&bufWrapper);
+        reader.Init(circularReader);
+    }
+
+    // Equivalent to TLV::Utilities::Iterate without recursion, but keeps track of where each event starts so the cursor
+    // can be placed on an event boundary.
+    while (true)
+    {
+        eventStart = reader.GetLengthRead();
+        err        = reader.Next();
+        VerifyOrExit(err != CHIP_END_OF_TLV, stoppedOnEventBoundary = true);
+        SuccessOrExit(err);
+
+        err = CopyEventsSince(reader, 0, &context);
+        VerifyOrExit(err != CHIP_ERROR_BUFFER_TOO_SMALL && err != CHIP_ERROR_NO_MEMORY, stoppedOnEventBoundary = true);
+        SuccessOrExit(err);
+
+        SuccessOrExit(err = reader.Skip());
     }
 
 exit:
@@ -675,10 +719,74 @@ exit:
         // For all other cases, continue from the next event.
         aEventMin = context.mCurrentEventNumber + 1;
     }
+
+    if (err == CHIP_END_OF_TLV)
+    {
+        err = CHIP_NO_ERROR;
+    }
+
+    if (apCursor != nullptr)
+    {
+        if (stoppedOnEventBoundary)
+        {
+            UpdateCursor(*apCursor, startBuffer, startOffset, eventStart, aEventMin);
+        }
+        else
+        {
+            apCursor->Invalidate();
+        }
+    }
+
     aEventCount += context.mEventCount;
     return err;
 }
 
+void EventManagement::SkipToEndOfLog(EventNumber & aEventMin, EventReadCursor & aCursor) const
+{
+    if (aEventMin < mLastEventNumber)
+    {
+        aEventMin = mLastEventNumber;
+    }
+
+    if (mpEventBuffer == nullptr || aEventMin != mLastEventNumber)
+    {
+        aCursor.Invalidate();
+        return;
+    }
+
+    // New events are always appended to the lowest priority buffer, which is the last one a reader visits.
+    aCursor.mpBuffer     = mpEventBuffer;
+    aCursor.mOffset      = mpEventBuffer->DataLength();
+    aCursor.mEventNumber = aEventMin;
+    aCursor.mGeneration  = mEvictionGeneration;
+}
+
+bool EventManagement::IsCursorValid(const EventReadCursor & aCursor, EventNumber aEventMin) const
+{
+    return (aCursor.mpBuffer != nullptr) && (aCursor.mGeneration == mEvictionGeneration) && (aCursor.mEventNumber == aEventMin) &&
+        (aCursor.mOffset <= aCursor.mpBuffer->DataLength());
+}
+
+void EventManagement::UpdateCursor(EventReadCursor & aCursor, CircularEventBuffer * apBuffer, uint32_t aOffset,
+                                   uint32_t aBytesRead, EventNumber aEventNumber) const
+{
+    uint32_t offset = aOffset + aBytesRead;
+
+    // The reader walks from apBuffer towards less important buffers; follow the same path.  A position right at the end of
+    // a buffer that has a successor is the start of that successor, since only the least important buffer gets appended to
+    // without an eviction.
+    while (offset >= apBuffer->DataLength() && apBuffer->GetPreviousCircularEventBuffer() != nullptr)
+    {
+        offset -= apBuffer->DataLength();
+        apBuffer = apBuffer->GetPreviousCircularEventBuffer();
+    }
+
+    aCursor.mpBuffer     = apBuffer;
+    aCursor.mOffset      = offset;
+    aCursor.mEventNumber = aEventNumber;
+    aCursor.mGeneration  = mEvictionGeneration;
+}
+
 CHIP_ERROR EventManagement::FabricRemovedCB(const TLV::TLVReader & aReader, size_t aDepth, void * apContext)
 {
     // the function does not actually remove the event, instead, it sets the fabric index to an invalid value.
@@ -860,12 +968,94 @@ CHIP_ERROR EventManagement::GenerateEvent(EventLoggingDelegate * eventPayloadWri
 }
 
 void CircularEventBuffer::Init(uint8_t * apBuffer, uint32_t aBufferLength, CircularEventBuffer * apPrev,
-                               CircularEventBuffer * apNext, PriorityLevel aPriorityLevel)
+                               CircularEventBuffer * apNext, PriorityLevel aPriorityLevel, CircularEventBufferStore * apStore)
 {
     TLVCircularBuffer::Init(apBuffer, aBufferLength);
     mpPrev    = apPrev;
     mpNext    = apNext;
     mPriority = aPriorityLevel;
+    mpStore   = apStore;
+
+    if (mpStore != nullptr)
+    {
+        CHIP_ERROR err = RestoreFromStore();
+        if (err != CHIP_NO_ERROR)
+        {
+            if (err != CHIP_ERROR_NOT_FOUND)
+            {
+                ChipLogError(EventLogging, "Dropping persisted events with priority %u: %" CHIP_ERROR_FORMAT,
+                             static_cast<unsigned>(mPriority), err.Format());
+            }
+            TLVCircularBuffer::Init(apBuffer, aBufferLength);
+            CommitLayout();
+        }
+    }
+}
+
+CHIP_ERROR CircularEventBuffer::RestoreFromStore()
+{
+    uint32_t headOffset = 0;
+    uint32_t dataLength = 0;
+
+    ReturnErrorOnFailure(mpStore->LoadLayout(headOffset, dataLength));
+    ReturnErrorOnFailure(Restore(headOffset, dataLength));
+
+    // A layout can be committed while an event is only partially written (the writer finalizes each chunk it
+    // fills), so keep the longest prefix that parses as a sequence of complete events and drop the rest.
+    CircularTLVReader reader;
+    reader.Init(*this);
+    reader.ImplicitProfileId = mImplicitProfileId;
+
+    uint32_t validLength = 0;
+    while (reader.Next() == CHIP_NO_ERROR && reader.GetType() == kTLVType_Structure && reader.Skip() == CHIP_NO_ERROR)
+    {
+        validLength = reader.GetLengthRead();
+    }
+
+    if (validLength != dataLength)
+    {
+        ChipLogError(EventLogging, "Dropping %" PRIu32 " bytes of incomplete persisted events with priority %u",
+                     dataLength - validLength, static_cast<unsigned>(mPriority));
+        ReturnErrorOnFailure(Restore(headOffset, validLength));
+        CommitLayout();
+    }
+
+    ChipLogProgress(EventLogging, "Restored %" PRIu32 " bytes of events with priority %u", validLength,
+                    static_cast<unsigned>(mPriority));
+    return CHIP_NO_ERROR;
+}
+
+void CircularEventBuffer::CommitLayout()
+{
+    VerifyOrReturn(mpStore != nullptr);
+
+    // Evicting the element that ends the backing store leaves the head right past its end, which is the same
+    // position as its start.  Only offsets inside the store are restorable.
+    uint32_t headOffset = static_cast<uint32_t>(QueueHead() - GetQueue());
+    if (headOffset == GetTotalDataLength())
+    {
+        headOffset = 0;
+    }
+    mpStore->CommitLayout(headOffset, DataLength());
+}
+
+CHIP_ERROR CircularEventBuffer::FinalizeBuffer(TLV::TLVWriter & ioWriter, uint8_t * inBufStart, uint32_t inBufLen)
+{
+    ReturnErrorOnFailure(TLVCircularBuffer::FinalizeBuffer(ioWriter, inBufStart, inBufLen));
+    // The new event data is in place, so the longer queue can be made durable.
+    CommitLayout();
+    return CHIP_NO_ERROR;
+}
+
+void CircularEventBuffer::GetBufferAtOffset(uint32_t aOffset, const uint8_t *& aBufStart, uint32_t & aBufLen) const
+{
+    const uint32_t headOffset = static_cast<uint32_t>(QueueHead() - GetQueue());
+    const uint32_t start      = (headOffset + aOffset) % GetTotalDataLength();
+    const uint32_t remaining  = DataLength() - aOffset;
+
+    aBufStart = GetQueue() + start;
+    // Stop at the end of the underlying storage; TLVCircularBuffer::GetNextBuffer handles the wraparound from there.
+    aBufLen = std::min(remaining, GetTotalDataLength() - start);
 }
 
 bool CircularEventBuffer::IsFinalDestinationForPriority(PriorityLevel aPriority) const
@@ -891,21 +1081,28 @@ void CircularEventReader::Init(CircularEventBufferWrapper * apBufWrapper)
     if (apBufWrapper->mpCurrent == nullptr)
         return;
 
-    TLVReader::Init(*apBufWrapper, apBufWrapper->mpCurrent->DataLength());
-    mMaxLen = apBufWrapper->mpCurrent->DataLength();
+    uint32_t maxLen = apBufWrapper->mpCurrent->DataLength() - apBufWrapper->mStartOffset;
     for (prev = apBufWrapper->mpCurrent->GetPreviousCircularEventBuffer(); prev != nullptr;
          prev = prev->GetPreviousCircularEventBuffer())
     {
-        CircularEventBufferWrapper bufWrapper;
-        bufWrapper.mpCurrent = prev;
-        mMaxLen += prev->DataLength();
+        maxLen += prev->DataLength();
     }
+    TLVReader::Init(*apBufWrapper, maxLen);
 }
 
 CHIP_ERROR CircularEventBufferWrapper::GetNextBuffer(TLVReader & aReader, const uint8_t *& aBufStart, uint32_t & aBufLen)
 {
     CHIP_ERROR err = CHIP_NO_ERROR;
-    mpCurrent->GetNextBuffer(aReader, aBufStart, aBufLen);
+    if ((aBufStart == nullptr) && (mStartOffset != 0))
+    {
+        // Resuming from a cursor: the first chunk starts part way into the current buffer.
+        mpCurrent->GetBufferAtOffset(mStartOffset, aBufStart, aBufLen);
+        mStartOffset = 0;
+    }
+    else
+    {
+        mpCurrent->GetNextBuffer(aReader, aBufStart, aBufLen);
+    }
     SuccessOrExit(err);
 
     if ((aBufLen == 0) && (mpCurrent->GetPreviousCircularEventBuffer() != nullptr))
@@ -78,6 +78,31 @@ inline constexpr size_t kMaxEventSizeReserve            = 512;
 constexpr uint16_t kRequiredEventField =
     (1 << to_underlying(EventDataIB::Tag::kPriority)) | (1 << to_underlying(EventDataIB::Tag::kPath));
 
+/**
+ * @brief
+ *   Interface for storage that keeps the contents of a CircularEventBuffer across restarts.
+ *
+ * The event data itself lives in the buffer memory handed to EventManagement (for example a memory mapped
+ * file); the store only persists where the queue starts and how long it is.  The buffer commits a new layout
+ * after event data has been written and after the head has moved, so a committed layout never covers bytes
+ * that were not written yet.
+ */
+class CircularEventBufferStore
+{
+public:
+    virtual ~CircularEventBufferStore() = default;
+
+    /**
+     * Load the last committed layout.  Return CHIP_ERROR_NOT_FOUND if nothing was committed yet.
+     */
+    virtual CHIP_ERROR LoadLayout(uint32_t & aHeadOffset, uint32_t & aDataLength) = 0;
+
+    /**
+     * Commit the current layout of the buffer.
+     */
+    virtual void CommitLayout(uint32_t aHeadOffset, uint32_t aDataLength) = 0;
+};
+
 /**
  * @brief
  *   Internal event buffer, built around the TLV::TLVCircularBuffer
@@ -107,9 +132,13 @@ public:
      *                           events of greater priority.
      *
      * @param[in] aPriorityLevel CircularEventBuffer priority level
+     *
+     * @param[in] apStore        Optional store persisting the buffer layout.  When provided, events left in
+     *                           \c apBuffer by a previous run are kept if the committed layout is consistent
+     *                           with the buffer contents, and dropped otherwise.
      */
     void Init(uint8_t * apBuffer, uint32_t aBufferLength, CircularEventBuffer * apPrev, CircularEventBuffer * apNext,
-              PriorityLevel aPriorityLevel);
+              PriorityLevel aPriorityLevel, CircularEventBufferStore * apStore = nullptr);
 
     /**
      * @brief
@@ -130,6 +159,24 @@ public:
     void SetRequiredSpaceforEvicted(size_t aRequiredSpace) { mRequiredSpaceForEvicted = aRequiredSpace; }
     size_t GetRequiredSpaceforEvicted() const { return mRequiredSpaceForEvicted; }
 
+    /**
+     * @brief
+     *   Get the contiguous run of stored data that starts aOffset bytes past the head of the buffer.
+     *
+     * @param[in]  aOffset   Offset, in bytes, from the queue head.  Must not exceed DataLength().
+     * @param[out] aBufStart Start of the contiguous run.
+     * @param[out] aBufLen   Length of the contiguous run; 0 if there is no data past aOffset.
+     */
+    void GetBufferAtOffset(uint32_t aOffset, const uint8_t *& aBufStart, uint32_t & aBufLen) const;
+
+    /**
+     * @brief
+     *   Commit the current head and length to the store, if the buffer has one.  Called after the head moved.
+     */
+    void CommitLayout();
+
+    CHIP_ERROR FinalizeBuffer(TLV::TLVWriter & ioWriter, uint8_t * inBufStart, uint32_t inBufLen) override;
+
     ~CircularEventBuffer() override = default;
 
 private:
@@ -141,6 +188,9 @@ private:
 
     size_t mRequiredSpaceForEvicted = 0; ///< Required space for previous buffer to evict event to new buffer
 
+    CircularEventBufferStore * mpStore = nullptr; ///< Optional store persisting the buffer layout
+
+    CHIP_ERROR RestoreFromStore();
     CHIP_ERROR OnInit(TLV::TLVWriter & writer, uint8_t *& bufStart, uint32_t & bufLen) override;
 };
 
@@ -157,6 +207,8 @@ class CircularEventBufferWrapper : public TLV::TLVCircularBuffer
 public:
     CircularEventBufferWrapper() : TLVCircularBuffer(nullptr, 0), mpCurrent(nullptr){};
     CircularEventBuffer * mpCurrent;
+    // Offset from the head of mpCurrent at which reading starts, used to resume from an EventReadCursor.
+    uint32_t mStartOffset = 0;
 
 private:
     CHIP_ERROR GetNextBuffer(chip::TLV::TLVReader & aReader, const uint8_t *& aBufStart, uint32_t & aBufLen) override;
@@ -189,6 +241,26 @@ struct LogStorageResources
     uint32_t mBufferSize = 0; ///< The size, in bytes, of the `mBuffer`.
     PriorityLevel mPriority =
         PriorityLevel::Invalid; // Log priority level associated with the resources provided in this structure.
+    CircularEventBufferStore * mpStore = nullptr; ///< Optional store that keeps the buffer contents across restarts.
+};
+
+/**
+ * @brief
+ *   Remembers where a reader stopped in the event log, so that the next fetch can resume from that
+ *   position instead of re-scanning every buffer from the oldest event.
+ *
+ * A cursor stays valid as long as no event has been evicted or moved between buffers since it was
+ * taken: appending new events never moves existing ones.  EventManagement tracks this with an
+ * eviction generation and silently falls back to a full scan when the cursor is stale.
+ */
+struct EventReadCursor
+{
+    CircularEventBuffer * mpBuffer = nullptr; ///< Buffer holding the event at the cursor.
+    uint32_t mOffset               = 0;       ///< Offset of that event from the buffer's queue head.
+    EventNumber mEventNumber       = 0;       ///< Event number the cursor was taken for (the reader's EventMin).
+    uint32_t mGeneration           = 0;       ///< Eviction generation the cursor was taken in.
+
+    void Invalidate() { mpBuffer = nullptr; }
 };
 
 /**
@@ -352,6 +424,8 @@ public:
      *
      * @param[out] aEventCount The number of fetched event
      * @param[in] aSubjectDescriptor Subject descriptor for current read handler
+     * @param[in,out] apCursor Optional cursor.  If it is still valid for aEventMin, reading resumes from
+     *                         it; on return it is updated to point at aEventMin, or invalidated.
      * @retval #CHIP_END_OF_TLV             The function has reached the end of the
      *                                       available log entries at the specified
      *                                       priority level
@@ -367,7 +441,14 @@ public:
      */
     CHIP_ERROR FetchEventsSince(chip::TLV::TLVWriter & aWriter, const SingleLinkedListNode<EventPathParams> * apEventPathList,
                                 EventNumber & aEventMin, size_t & aEventCount,
-                                const Access::SubjectDescriptor & aSubjectDescriptor);
+                                const Access::SubjectDescriptor & aSubjectDescriptor, EventReadCursor * apCursor = nullptr);
+
+    /**
+     * @brief
+     *   Move aEventMin and aCursor past every event logged so far.  Used by readers that know none of the
+     *   events logged since their last fetch are of interest to them.
+     */
+    void SkipToEndOfLog(EventNumber & aEventMin, EventReadCursor & aCursor) const;
     /**
      * @brief brief Iterate all events and invalidate the fabric-sensitive events whose associated fabric has the given fabric
      * index.
@@ -555,6 +636,18 @@ private:
      */
     CircularEventBuffer * GetPriorityBuffer(PriorityLevel aPriority) const;
 
+    /**
+     * @brief Whether aCursor can be used to resume reading at aEventMin.
+     */
+    bool IsCursorValid(const EventReadCursor & aCursor, EventNumber aEventMin) const;
+
+    /**
+     * @brief Point aCursor at the position aBytesRead bytes into the stream that started aOffset bytes
+     * past the head of apBuffer.
+     */
+    void UpdateCursor(EventReadCursor & aCursor, CircularEventBuffer * apBuffer, uint32_t aOffset, uint32_t aBytesRead,
+                      EventNumber aEventNumber) const;
+
     // EventBuffer for debug level,
     CircularEventBuffer * mpEventBuffer        = nullptr;
     Messaging::ExchangeManager * mpExchangeMgr = nullptr;
@@ -570,6 +663,9 @@ private:
     System::Clock::Milliseconds64 mMonotonicStartupTime;
 
     EventReporter * mpEventReporter = nullptr;
+
+    // Bumped every time events are evicted or moved between buffers, which invalidates outstanding EventReadCursors.
+    uint32_t mEvictionGeneration = 0;
 };
 
 } // namespace app
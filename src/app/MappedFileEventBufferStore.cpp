@@ -0,0 +1,168 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/MappedFileEventBufferStore.h>
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <system/SystemError.h>
+
+#include <atomic>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace chip {
+namespace app {
+
+CHIP_ERROR MappedFileEventBufferStore::Open(const char * aPath, uint32_t aBufferSize)
+{
+    VerifyOrReturnError(aPath != nullptr && aBufferSize != 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(mFd < 0, CHIP_ERROR_INCORRECT_STATE);
+
+    const size_t mappingSize = kDataOffset + aBufferSize;
+
+    int fd = open(aPath, O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    VerifyOrReturnError(fd >= 0, CHIP_ERROR_POSIX(errno));
+
+    struct stat st;
+    bool reset = (fstat(fd, &st) != 0) || (static_cast<size_t>(st.st_size) != mappingSize);
+    if (reset && ftruncate(fd, static_cast<off_t>(mappingSize)) != 0)
+    {
+        CHIP_ERROR err = CHIP_ERROR_POSIX(errno);
+        close(fd);
+        return err;
+    }
+
+    void * mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        CHIP_ERROR err = CHIP_ERROR_POSIX(errno);
+        close(fd);
+        return err;
+    }
+
+    mFd          = fd;
+    mpMapping    = static_cast<uint8_t *>(mapping);
+    mMappingSize = mappingSize;
+    mpHeader     = reinterpret_cast<Header *>(mpMapping);
+    mpData       = mpMapping + kDataOffset;
+    mBufferSize  = aBufferSize;
+
+    if (reset || mpHeader->mMagic != kMagic || mpHeader->mVersion != kVersion || mpHeader->mBufferSize != aBufferSize)
+    {
+        ChipLogProgress(EventLogging, "Initializing event buffer file %s", aPath);
+        memset(mpHeader, 0, kDataOffset);
+        mpHeader->mMagic      = kMagic;
+        mpHeader->mVersion    = kVersion;
+        mpHeader->mBufferSize = aBufferSize;
+    }
+
+    mSequence = 0;
+    for (const auto & layout : mpHeader->mLayouts)
+    {
+        if (IsValid(layout) && layout.mSequence > mSequence)
+        {
+            mSequence = layout.mSequence;
+        }
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+void MappedFileEventBufferStore::Close()
+{
+    VerifyOrReturn(mFd >= 0);
+
+    if (mSyncOnCommit)
+    {
+        msync(mpMapping, mMappingSize, MS_SYNC);
+    }
+    munmap(mpMapping, mMappingSize);
+    close(mFd);
+
+    mFd          = -1;
+    mpMapping    = nullptr;
+    mMappingSize = 0;
+    mpHeader     = nullptr;
+    mpData       = nullptr;
+    mBufferSize  = 0;
+}
+
+CHIP_ERROR MappedFileEventBufferStore::LoadLayout(uint32_t & aHeadOffset, uint32_t & aDataLength)
+{
+    VerifyOrReturnError(mpHeader != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(mSequence != 0, CHIP_ERROR_NOT_FOUND);
+
+    const Layout & layout = mpHeader->mLayouts[mSequence & 1];
+    VerifyOrReturnError(IsValid(layout) && layout.mSequence == mSequence, CHIP_ERROR_INTERNAL);
+
+    aHeadOffset = layout.mHeadOffset;
+    aDataLength = layout.mDataLength;
+    return CHIP_NO_ERROR;
+}
+
+void MappedFileEventBufferStore::CommitLayout(uint32_t aHeadOffset, uint32_t aDataLength)
+{
+    VerifyOrReturn(mpHeader != nullptr);
+
+    // Never overwrite the current record: if we crash part way through, the previous commit still stands.
+    const uint32_t sequence = mSequence + 1;
+    Layout & layout         = mpHeader->mLayouts[sequence & 1];
+
+    layout.mSequence   = 0;
+    layout.mHeadOffset = aHeadOffset;
+    layout.mDataLength = aDataLength;
+    layout.mCheck      = ComputeCheck(Layout{ sequence, aHeadOffset, aDataLength, 0 });
+    // The event data and the record fields must land before the sequence number that makes the record current.
+    std::atomic_thread_fence(std::memory_order_release);
+    layout.mSequence = sequence;
+    mSequence        = sequence;
+
+    if (mSyncOnCommit)
+    {
+        msync(mpMapping, mMappingSize, MS_SYNC);
+    }
+}
+
+uint32_t MappedFileEventBufferStore::ComputeCheck(const Layout & aLayout)
+{
+    // FNV-1a over the record fields; enough to tell a torn record from a committed one.
+    uint32_t hash = 2166136261u;
+    for (uint32_t value : { aLayout.mSequence, aLayout.mHeadOffset, aLayout.mDataLength, kMagic })
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            hash ^= static_cast<uint8_t>(value >> (8 * i));
+            hash *= 16777619u;
+        }
+    }
+    return hash;
+}
+
+bool MappedFileEventBufferStore::IsValid(const Layout & aLayout) const
+{
+    return (aLayout.mSequence != 0) && (aLayout.mHeadOffset < mBufferSize) && (aLayout.mDataLength <= mBufferSize) &&
+        (aLayout.mCheck == ComputeCheck(Layout{ aLayout.mSequence, aLayout.mHeadOffset, aLayout.mDataLength, 0 }));
+}
+
+} // namespace app
+} // namespace chip
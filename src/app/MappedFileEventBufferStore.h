@@ -0,0 +1,125 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @file
+ *   A file-backed event buffer for Linux.  The event data lives in a memory mapped file, so events
+ *   logged by a previous run are still available after a crash or restart.
+ *
+ * File layout: a small header holding two alternating layout records, followed by the circular
+ * buffer data exactly as TLV::TLVCircularBuffer lays it out.  Each commit writes the record that is
+ * not current, with a higher sequence number and a check value; the record with the highest valid
+ * sequence wins on load.  A record torn by a crash fails its check and the previous one is used.
+ *
+ * Usage:
+ *
+ *     MappedFileEventBufferStore critStore;
+ *     ReturnErrorOnFailure(critStore.Open("/var/lib/matter/events-critical", 4096));
+ *     LogStorageResources resources[] = {
+ *         ...
+ *         { critStore.GetBuffer(), critStore.GetBufferSize(), PriorityLevel::Critical, &critStore },
+ *     };
+ *
+ * Event numbers must come from a persisted counter so that they keep increasing across restarts.
+ */
+
+#pragma once
+
+#include <app/EventManagement.h>
+#include <lib/core/CHIPError.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+namespace app {
+
+class MappedFileEventBufferStore : public CircularEventBufferStore
+{
+public:
+    MappedFileEventBufferStore() = default;
+    ~MappedFileEventBufferStore() override { Close(); }
+
+    MappedFileEventBufferStore(const MappedFileEventBufferStore &)             = delete;
+    MappedFileEventBufferStore & operator=(const MappedFileEventBufferStore &) = delete;
+
+    /**
+     * @brief
+     *   Map the file at aPath, creating it if needed.  A file that was created for a different buffer
+     *   size, or that is not an event buffer file, is reset.
+     */
+    CHIP_ERROR Open(const char * aPath, uint32_t aBufferSize);
+
+    /**
+     * @brief
+     *   Unmap the file.  The buffer must no longer be used by EventManagement.
+     */
+    void Close();
+
+    uint8_t * GetBuffer() const { return mpData; }
+    uint32_t GetBufferSize() const { return mBufferSize; }
+
+    /**
+     * @brief
+     *   When enabled, every commit is followed by msync() so that the log also survives power loss, at
+     *   the cost of a synchronous write per logged event.  Process crashes are covered either way.
+     */
+    void SetSyncOnCommit(bool aSyncOnCommit) { mSyncOnCommit = aSyncOnCommit; }
+
+    // CircularEventBufferStore implementation
+    CHIP_ERROR LoadLayout(uint32_t & aHeadOffset, uint32_t & aDataLength) override;
+    void CommitLayout(uint32_t aHeadOffset, uint32_t aDataLength) override;
+
+private:
+    struct Layout
+    {
+        uint32_t mSequence;
+        uint32_t mHeadOffset;
+        uint32_t mDataLength;
+        uint32_t mCheck;
+    };
+
+    struct Header
+    {
+        uint32_t mMagic;
+        uint32_t mVersion;
+        uint32_t mBufferSize;
+        uint32_t mReserved;
+        Layout mLayouts[2];
+    };
+
+    static constexpr uint32_t kMagic    = 0x5456454d; // "MEVT"
+    static constexpr uint32_t kVersion  = 1;
+    static constexpr size_t kDataOffset = 64;
+    static_assert(sizeof(Header) <= kDataOffset, "Header must fit before the event data");
+
+    static uint32_t ComputeCheck(const Layout & aLayout);
+    bool IsValid(const Layout & aLayout) const;
+
+    int mFd              = -1;
+    uint8_t * mpMapping  = nullptr;
+    size_t mMappingSize  = 0;
+    Header * mpHeader    = nullptr;
+    uint8_t * mpData     = nullptr;
+    uint32_t mBufferSize = 0;
+    uint32_t mSequence   = 0;
+    bool mSyncOnCommit   = false;
+};
+
+} // namespace app
+} // namespace chip
@@ -65,6 +65,19 @@ void OperationalSessionSetup::MoveToState(State aTargetState)
 
         mState = aTargetState;
 
+        if (mEstablishmentScheduler != nullptr)
+        {
+            if (aTargetState == State::SecureConnected)
+            {
+                mEstablishmentScheduler->OnSessionEstablished(*this);
+            }
+            else if (aTargetState == State::NeedsAddress || aTargetState == State::WaitingForRetry)
+            {
+                // Retry backoff can be long, so do not keep a slot other setups could be using meanwhile.
+                mEstablishmentScheduler->ReleaseSlot(*this);
+            }
+        }
+
         if (aTargetState != State::Connecting)
         {
             CleanupCASEClient();
@@ -75,7 +88,7 @@ void OperationalSessionSetup::MoveToState(State aTargetState)
 bool OperationalSessionSetup::AttachToExistingSecureSession()
 {
     VerifyOrReturnError(mState == State::NeedsAddress || mState == State::ResolvingAddress || mState == State::HasAddress ||
-                            mState == State::WaitingForRetry,
+                            mState == State::WaitingForRetry || mState == State::WaitingForSlot,
                         false);
 
     auto sessionHandle = mInitParams.sessionManager->FindSecureSessionForNode(
@@ -119,22 +132,14 @@ void OperationalSessionSetup::Connect(Callback::Callback<OnDeviceConnected> * on
         isConnected = AttachToExistingSecureSession();
         if (!isConnected)
         {
-            // LookupPeerAddress could perhaps call back with a result
-            // synchronously, so do our state update first.
-            MoveToState(State::ResolvingAddress);
-            err = LookupPeerAddress();
-            if (err != CHIP_NO_ERROR)
-            {
-                // Roll back the state change, since we are presumably not in
-                // the middle of a lookup.
-                MoveToState(State::NeedsAddress);
-            }
+            err = StartAddressLookupOrWaitForSlot(State::NeedsAddress);
         }
 
         break;
 
     case State::ResolvingAddress:
     case State::WaitingForRetry:
+    case State::WaitingForSlot:
         isConnected = AttachToExistingSecureSession();
         break;
 
@@ -197,6 +202,85 @@ void OperationalSessionSetup::Connect(Callback::Callback<OnDeviceConnected> * on
     Connect(onConnection, nullptr, onSetupFailure, transportPayloadCapability);
 }
 
+CHIP_ERROR OperationalSessionSetup::StartAddressLookupOrWaitForSlot(State rollbackState)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
+    if (mEstablishmentScheduler != nullptr && !HoldsEstablishmentSlot())
+    {
+        // The lookup starts from OnEstablishmentSlotGranted.
+        MoveToState(State::WaitingForSlot);
+        err = mEstablishmentScheduler->RequestSlot(*this, mEstablishmentPriority);
+    }
+    else
+    {
+        // LookupPeerAddress could perhaps call back with a result
+        // synchronously, so do our state update first.
+        MoveToState(State::ResolvingAddress);
+        err = LookupPeerAddress();
+    }
+
+    if (err != CHIP_NO_ERROR)
+    {
+        // Roll back the state change, since we are presumably not in
+        // the middle of a lookup.
+        MoveToState(rollbackState);
+    }
+    return err;
+}
+
+void OperationalSessionSetup::SetEstablishmentScheduler(CASEEstablishmentScheduler * scheduler,
+                                                        CASEEstablishmentScheduler::Priority priority)
+{
+    VerifyOrReturn(scheduler != nullptr && !mPerformingAddressUpdate);
+
+    if (mEstablishmentScheduler == nullptr)
+    {
+        // Setups that are already resolving or connecting just carry on unscheduled.
+        VerifyOrReturn(mState == State::NeedsAddress);
+        mEstablishmentScheduler = scheduler;
+        mEstablishmentPriority  = priority;
+        return;
+    }
+
+    VerifyOrReturn(scheduler == mEstablishmentScheduler && priority < mEstablishmentPriority);
+    mEstablishmentPriority = priority;
+    if (mState == State::WaitingForSlot)
+    {
+        // Moves us to the more urgent queue.
+        LogErrorOnFailure(mEstablishmentScheduler->RequestSlot(*this, priority));
+    }
+}
+
+void OperationalSessionSetup::OnEstablishmentSlotGranted()
+{
+    if (mState != State::WaitingForSlot)
+    {
+        // Something else (e.g. an existing session) got us going in the meantime.
+        mEstablishmentScheduler->ReleaseSlot(*this);
+        return;
+    }
+
+    MoveToState(State::ResolvingAddress);
+    CHIP_ERROR err = LookupPeerAddress();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Discovery, "Failed to look up peer address: %" CHIP_ERROR_FORMAT, err.Format());
+        DequeueConnectionCallbacks(err);
+        // Do not touch `this` instance anymore; it has been destroyed in DequeueConnectionCallbacks.
+        return;
+    }
+}
+
+void OperationalSessionSetup::OnEstablishmentSlotFailed(CHIP_ERROR error)
+{
+    VerifyOrReturn(mState == State::WaitingForSlot);
+
+    ChipLogError(Discovery, "Gave up waiting for a CASE establishment slot: %" CHIP_ERROR_FORMAT, error.Format());
+    DequeueConnectionCallbacks(error);
+    // Do not touch `this` instance anymore; it has been destroyed in DequeueConnectionCallbacks.
+}
+
 void OperationalSessionSetup::UpdateDeviceData(const ResolveResult & result)
 {
     auto & config = result.mrpRemoteConfig;
@@ -539,6 +623,11 @@ void OperationalSessionSetup::CleanupCASEClient()
 
 OperationalSessionSetup::~OperationalSessionSetup()
 {
+    if (mEstablishmentScheduler != nullptr)
+    {
+        mEstablishmentScheduler->ReleaseSlot(*this);
+    }
+
     if (mAddressLookupHandle.IsActive())
     {
         ChipLogDetail(Discovery,
@@ -608,6 +697,9 @@ CHIP_ERROR OperationalSessionSetup::LookupPeerAddress()
     PeerId peerId(fabricInfo->GetCompressedFabricId(), mPeerId.GetNodeId());
 
     NodeLookupRequest request(peerId);
+    // An address update is requested because the peer stopped answering on the address we have, which may well be the
+    // cached one.
+    request.SetBypassCache(mPerformingAddressUpdate);
 
     return Resolver::Instance().LookupNode(request, mAddressLookupHandle);
 }
@@ -705,10 +797,11 @@ void OperationalSessionSetup::UpdateAttemptCount(uint8_t attemptCount)
         return;
     }
 
-    if (mState != State::NeedsAddress)
+    if (mState != State::NeedsAddress && !(mState == State::WaitingForSlot && mAttemptsDone == 0))
     {
         // We're in the middle of an attempt already, so decrement attemptCount
-        // by 1 to account for that.
+        // by 1 to account for that.  Waiting for the first scheduler slot does
+        // not count as an attempt yet.
         --attemptCount;
     }
 
@@ -813,8 +906,7 @@ void OperationalSessionSetup::TrySetupAgain(System::Layer * systemLayer, void *
 {
     auto * self = static_cast<OperationalSessionSetup *>(state);
 
-    self->MoveToState(State::ResolvingAddress);
-    CHIP_ERROR err = self->LookupPeerAddress();
+    CHIP_ERROR err = self->StartAddressLookupOrWaitForSlot(State::NeedsAddress);
     if (err == CHIP_NO_ERROR)
     {
         return;
@@ -29,6 +29,7 @@
 #include <app/AppConfig.h>
 #include <app/CASEClient.h>
 #include <app/CASEClientPool.h>
+#include <app/CASEEstablishmentScheduler.h>
 #include <app/DeviceProxy.h>
 #include <app/util/basic-types.h>
 #include <credentials/GroupDataProvider.h>
@@ -154,7 +155,9 @@ typedef void (*OnDeviceConnectionRetry)(void * context, const ScopedNodeId & pee
  * It is possible to determine which of the two purposes the OperationalSessionSetup is for by calling
  * IsForAddressUpdate().
  */
-class DLL_EXPORT OperationalSessionSetup : public SessionEstablishmentDelegate, public AddressResolve::NodeListener
+class DLL_EXPORT OperationalSessionSetup : public SessionEstablishmentDelegate,
+                                          public AddressResolve::NodeListener,
+                                          public CASEEstablishmentScheduler::Client
 {
 public:
     struct ConnectionFailureInfo
@@ -241,6 +244,17 @@ public:
 
     bool IsForAddressUpdate() const { return mPerformingAddressUpdate; }
 
+    /**
+     * Make this setup wait for a slot from `scheduler` before it starts resolving its peer, queued in
+     * `priority`.  Must be called before Connect; calling it again only raises the priority.  Setups without a
+     * scheduler start immediately, as do setups that are only performing an address update.
+     */
+    void SetEstablishmentScheduler(CASEEstablishmentScheduler * scheduler, CASEEstablishmentScheduler::Priority priority);
+
+    //////////// CASEEstablishmentScheduler::Client Implementation ///////////////
+    void OnEstablishmentSlotGranted() override;
+    void OnEstablishmentSlotFailed(CHIP_ERROR error) override;
+
     //////////// SessionEstablishmentDelegate Implementation ///////////////
     void OnSessionEstablished(const SessionHandle & session) override;
     void OnSessionEstablishmentError(CHIP_ERROR error, SessionEstablishmentStage stage) override;
@@ -295,6 +309,8 @@ private:
         SecureConnected,  // CASE session established.
         WaitingForRetry,  // No address known, but a retry is pending.  Added at
                           // end to make logs easier to understand.
+        WaitingForSlot,   // No address known, waiting for a CASEEstablishmentScheduler slot
+                          // before starting the lookup.
     };
 
     CASEClientInitParams mInitParams;
@@ -322,6 +338,9 @@ private:
 
     bool mPerformingAddressUpdate = false;
 
+    CASEEstablishmentScheduler * mEstablishmentScheduler        = nullptr;
+    CASEEstablishmentScheduler::Priority mEstablishmentPriority = CASEEstablishmentScheduler::Priority::kNormal;
+
 #if CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES || CHIP_CONFIG_ENABLE_BUSY_HANDLING_FOR_OPERATIONAL_SESSION_SETUP
     System::Clock::Milliseconds16 mRequestedBusyDelay = System::Clock::kZero;
 #endif // CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES || CHIP_CONFIG_ENABLE_BUSY_HANDLING_FOR_OPERATIONAL_SESSION_SETUP
@@ -347,6 +366,12 @@ private:
 
     void MoveToState(State aTargetState);
 
+    /**
+     * Start looking up the peer address, or queue for a scheduler slot first if we have a scheduler and do not
+     * hold a slot yet.  On error the state is rolled back to `rollbackState`.
+     */
+    CHIP_ERROR StartAddressLookupOrWaitForSlot(State rollbackState);
+
     CHIP_ERROR EstablishConnection(const AddressResolve::ResolveResult & result);
 
     /*
@@ -1441,7 +1441,10 @@ CHIP_ERROR ReadClient::EstablishSessionToPeer()
     ChipLogProgress(DataManagement, "Trying to establish a CASE session for subscription");
     auto * caseSessionManager = InteractionModelEngine::GetInstance()->GetCASESessionManager();
     VerifyOrReturnError(caseSessionManager != nullptr, CHIP_ERROR_INCORRECT_STATE);
-    caseSessionManager->FindOrEstablishSession(mPeer, &mOnConnectedCallback, &mOnConnectionFailureCallback);
+    // Nobody is waiting on a resubscription, so let other session setups go first.
+    auto priority =
+        (mNumRetries > 0) ? CASEEstablishmentScheduler::Priority::kBackground : CASEEstablishmentScheduler::Priority::kNormal;
+    caseSessionManager->FindOrEstablishSession(priority, mPeer, &mOnConnectedCallback, &mOnConnectionFailureCallback);
     return CHIP_NO_ERROR;
 }
 
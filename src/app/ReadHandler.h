@@ -292,6 +292,15 @@ public:
 private:
     PriorityLevel GetCurrentPriority() const { return mCurrentPriority; }
     EventNumber & GetEventMin() { return mEventMin; }
+    EventReadCursor & GetEventCursor() { return mEventCursor; }
+
+    /**
+     * Whether events matching this handler's event paths may have been logged since the last time all available events
+     * were fetched.  When this returns false the engine does not need to scan the event log at all.
+     */
+    bool MayHaveNewMatchingEvents() const { return !mFlags.Has(ReadHandlerFlags::EventsFetched); }
+    void SetAllEventsFetched() { mFlags.Set(ReadHandlerFlags::EventsFetched); }
+    void OnMatchingEventGenerated() { mFlags.Clear(ReadHandlerFlags::EventsFetched); }
 
     /**
      * Returns SUBSCRIPTION_MAX_INTERVAL_PUBLISHER_LIMIT
@@ -325,6 +334,10 @@ private:
 
         // Don't need the response for report data if true
         SuppressResponse = (1 << 5),
+
+        // Set once every event in the log has been fetched for this subscription, and cleared whenever a newly
+        // logged event matches one of its event paths.  While set, reports skip scanning the event log.
+        EventsFetched = (1 << 6),
     };
 
     /**
@@ -563,6 +576,9 @@ private:
 
     EventNumber mEventMin = 0;
 
+    // Position in the event log corresponding to mEventMin, so the next fetch does not rescan older events.
+    EventReadCursor mEventCursor;
+
     // The last schedule event number snapshoted in the beginning when preparing to fill new events to reports
     EventNumber mLastScheduledEventNumber = 0;
 
@@ -0,0 +1,608 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/SharedClusterStateCache.h>
+
+#include <lib/core/TLVWriter.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string.h>
+
+#if CHIP_CONFIG_ENABLE_READ_CLIENT
+namespace chip {
+namespace app {
+
+namespace {
+
+bool NodeLess(const ScopedNodeId & a, const ScopedNodeId & b)
+{
+    return a.GetFabricIndex() < b.GetFabricIndex() || (a.GetFabricIndex() == b.GetFabricIndex() && a.GetNodeId() < b.GetNodeId());
+}
+
+uint64_t ClusterKey(EndpointId endpointId, ClusterId clusterId)
+{
+    return (static_cast<uint64_t>(endpointId) << 32) | clusterId;
+}
+
+template <typename T>
+auto FindNodeEntry(T & entries, const ScopedNodeId & node)
+{
+    return std::lower_bound(entries.begin(), entries.end(), node,
+                            [](const auto & entry, const ScopedNodeId & key) { return NodeLess(entry.first, key); });
+}
+
+template <typename T>
+auto FindClusterEntry(T & clusters, EndpointId endpointId, ClusterId clusterId)
+{
+    return std::lower_bound(clusters.begin(), clusters.end(), ClusterKey(endpointId, clusterId),
+                            [](const auto & cluster, uint64_t key) {
+                                return ClusterKey(cluster->mEndpointId, cluster->mClusterId) < key;
+                            });
+}
+
+/*
+ * Whether the object behind a shared_ptr owned by the Matter thread is referenced by that pointer only.
+ *
+ * Other threads can drop references (by releasing snapshots) but never add one to a NodeData or ClusterData, and
+ * only add references to the published index under mPublishedLock.  Once the count is 1 it therefore stays 1; the
+ * fence orders the reads made through the released references before the writes the caller is about to make.
+ */
+template <typename T>
+bool IsExclusive(const std::shared_ptr<T> & ptr)
+{
+    if (ptr.use_count() != 1)
+    {
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return true;
+}
+
+} // namespace
+
+//
+// Snapshot
+//
+
+const SharedClusterStateCache::NodeData * SharedClusterStateCache::Snapshot::FindNode(const ScopedNodeId & node) const
+{
+    VerifyOrReturnValue(mIndex != nullptr, nullptr);
+
+    auto it = FindNodeEntry(*mIndex, node);
+    VerifyOrReturnValue(it != mIndex->end() && it->first == node, nullptr);
+    return it->second.get();
+}
+
+const SharedClusterStateCache::ClusterData * SharedClusterStateCache::Snapshot::FindCluster(const ScopedNodeId & node,
+                                                                                              EndpointId endpointId,
+                                                                                              ClusterId clusterId) const
+{
+    const NodeData * nodeData = FindNode(node);
+    VerifyOrReturnValue(nodeData != nullptr, nullptr);
+
+    auto it = FindClusterEntry(nodeData->mClusters, endpointId, clusterId);
+    VerifyOrReturnValue(it != nodeData->mClusters.end() && (*it)->mEndpointId == endpointId && (*it)->mClusterId == clusterId,
+                        nullptr);
+    return it->get();
+}
+
+const SharedClusterStateCache::AttributeEntry *
+SharedClusterStateCache::Snapshot::FindAttribute(const ScopedNodeId & node, const ConcreteAttributePath & path) const
+{
+    const ClusterData * cluster = FindCluster(node, path.mEndpointId, path.mClusterId);
+    VerifyOrReturnValue(cluster != nullptr, nullptr);
+
+    auto it = std::lower_bound(cluster->mAttributes.begin(), cluster->mAttributes.end(), path.mAttributeId,
+                               [](const AttributeEntry & entry, AttributeId id) { return entry.mAttributeId < id; });
+    VerifyOrReturnValue(it != cluster->mAttributes.end() && it->mAttributeId == path.mAttributeId, nullptr);
+    return &*it;
+}
+
+CHIP_ERROR SharedClusterStateCache::Snapshot::Get(const ScopedNodeId & node, const ConcreteAttributePath & path,
+                                                  TLV::TLVReader & reader) const
+{
+    const ClusterData * cluster = FindCluster(node, path.mEndpointId, path.mClusterId);
+    VerifyOrReturnError(cluster != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
+
+    const AttributeEntry * entry = FindAttribute(node, path);
+    VerifyOrReturnError(entry != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
+    VerifyOrReturnError(!entry->mIsStatus, CHIP_ERROR_IM_STATUS_CODE_RECEIVED);
+
+    reader.Init(cluster->mValues.data() + entry->mOffset, entry->mLength);
+    return reader.Next();
+}
+
+CHIP_ERROR SharedClusterStateCache::Snapshot::GetStatus(const ScopedNodeId & node, const ConcreteAttributePath & path,
+                                                        StatusIB & status) const
+{
+    const AttributeEntry * entry = FindAttribute(node, path);
+    VerifyOrReturnError(entry != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
+    VerifyOrReturnError(entry->mIsStatus, CHIP_ERROR_INVALID_ARGUMENT);
+
+    status = entry->mStatus;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR SharedClusterStateCache::Snapshot::GetVersion(const ScopedNodeId & node, const ConcreteClusterPath & path,
+                                                         Optional<DataVersion> & aVersion) const
+{
+    VerifyOrReturnError(path.IsValidConcreteClusterPath(), CHIP_ERROR_INVALID_ARGUMENT);
+
+    const ClusterData * cluster = FindCluster(node, path.mEndpointId, path.mClusterId);
+    VerifyOrReturnError(cluster != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
+
+    aVersion = cluster->mDataVersion;
+    return CHIP_NO_ERROR;
+}
+
+//
+// NodeFeed
+//
+
+SharedClusterStateCache::NodeFeed::NodeFeed(SharedClusterStateCache & cache, const ScopedNodeId & node,
+                                            ReadClient::Callback & callback) :
+    mCache(cache),
+    mNodeId(node), mCallback(callback), mVersionCache(*this)
+{
+    mCache.mFeeds.push_back(this);
+}
+
+SharedClusterStateCache::NodeFeed::~NodeFeed()
+{
+    EndReport();
+    mCache.mFeeds.erase(std::remove(mCache.mFeeds.begin(), mCache.mFeeds.end(), this), mCache.mFeeds.end());
+}
+
+void SharedClusterStateCache::NodeFeed::EndReport()
+{
+    VerifyOrReturn(mInReport);
+    mInReport = false;
+    mCache.EndReport(mNodeId);
+}
+
+void SharedClusterStateCache::NodeFeed::ClearDataVersions(const std::vector<EndpointId> & endpoints)
+{
+    for (auto endpoint : endpoints)
+    {
+        mVersionCache.ClearAttributes(endpoint);
+    }
+}
+
+void SharedClusterStateCache::NodeFeed::OnReportBegin()
+{
+    // A report interrupted by an error is not ended; the next one simply continues it.
+    if (!mInReport)
+    {
+        mInReport = true;
+        mCache.BeginReport(mNodeId);
+    }
+    mCallback.OnReportBegin();
+}
+
+void SharedClusterStateCache::NodeFeed::OnReportEnd()
+{
+    EndReport();
+    mCallback.OnReportEnd();
+}
+
+void SharedClusterStateCache::NodeFeed::OnAttributeData(const ConcreteDataAttributePath & aPath, TLV::TLVReader * apData,
+                                                        const StatusIB & aStatus)
+{
+    // Copy the reader for forwarding
+    TLV::TLVReader dataSnapshot;
+    if (apData)
+    {
+        dataSnapshot.Init(*apData);
+    }
+
+    CHIP_ERROR err = mCache.UpdateAttribute(mNodeId, aPath, apData, aStatus);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(DataManagement,
+                     "Failed to cache attribute " ChipLogFormatMEI "/" ChipLogFormatMEI " of node " ChipLogFormatScopedNodeId
+                     ": %" CHIP_ERROR_FORMAT,
+                     ChipLogValueMEI(aPath.mClusterId), ChipLogValueMEI(aPath.mAttributeId), ChipLogValueScopedNodeId(mNodeId),
+                     err.Format());
+    }
+
+    mCallback.OnAttributeData(aPath, apData ? &dataSnapshot : nullptr, aStatus);
+}
+
+void SharedClusterStateCache::NodeFeed::OnDone(ReadClient * apReadClient)
+{
+    // Publish whatever was received before the interaction ended.
+    EndReport();
+    mCallback.OnDone(apReadClient);
+}
+
+//
+// SharedClusterStateCache
+//
+
+SharedClusterStateCache::~SharedClusterStateCache()
+{
+    VerifyOrDie(mFeeds.empty());
+}
+
+CHIP_ERROR SharedClusterStateCache::Init()
+{
+    ReturnErrorOnFailure(System::Mutex::Init(mPublishedLock));
+    mPublished = std::make_shared<NodeIndex>();
+    return CHIP_NO_ERROR;
+}
+
+SharedClusterStateCache::Snapshot SharedClusterStateCache::GetSnapshot() const
+{
+    std::lock_guard<System::Mutex> lock(mPublishedLock);
+    return Snapshot(mPublished);
+}
+
+void SharedClusterStateCache::Touch(const ScopedNodeId & node)
+{
+    NodeRecord * record = FindRecord(node);
+    VerifyOrReturn(record != nullptr);
+    record->mLastUsed = ++mUseCounter;
+}
+
+void SharedClusterStateCache::RemoveNode(const ScopedNodeId & node)
+{
+    auto it = std::lower_bound(mNodes.begin(), mNodes.end(), node,
+                               [](const NodeRecord & record, const ScopedNodeId & key) { return NodeLess(record.mNodeId, key); });
+    VerifyOrReturn(it != mNodes.end() && it->mNodeId == node);
+    RemoveRecord(static_cast<size_t>(it - mNodes.begin()));
+}
+
+void SharedClusterStateCache::SetMemoryBudget(size_t memoryBudget)
+{
+    mMemoryBudget = memoryBudget;
+    EvictIfNeeded();
+}
+
+SharedClusterStateCache::NodeRecord * SharedClusterStateCache::FindRecord(const ScopedNodeId & node)
+{
+    auto it = std::lower_bound(mNodes.begin(), mNodes.end(), node,
+                               [](const NodeRecord & record, const ScopedNodeId & key) { return NodeLess(record.mNodeId, key); });
+    VerifyOrReturnValue(it != mNodes.end() && it->mNodeId == node, nullptr);
+    return &*it;
+}
+
+SharedClusterStateCache::NodeRecord & SharedClusterStateCache::GetOrAddRecord(const ScopedNodeId & node)
+{
+    auto it = std::lower_bound(mNodes.begin(), mNodes.end(), node,
+                               [](const NodeRecord & record, const ScopedNodeId & key) { return NodeLess(record.mNodeId, key); });
+    if (it == mNodes.end() || it->mNodeId != node)
+    {
+        NodeRecord record;
+        record.mNodeId = node;
+        record.mData   = std::make_shared<NodeData>();
+        record.mBytes  = sizeof(NodeRecord) + sizeof(NodeData);
+        mBytesUsed += record.mBytes;
+        it = mNodes.insert(it, std::move(record));
+    }
+    return *it;
+}
+
+void SharedClusterStateCache::BeginReport(const ScopedNodeId & node)
+{
+    GetOrAddRecord(node).mReportsInProgress++;
+}
+
+void SharedClusterStateCache::EndReport(const ScopedNodeId & node)
+{
+    NodeRecord * record = FindRecord(node);
+
+    // The node may have been removed while the report was in progress.
+    VerifyOrReturn(record != nullptr);
+
+    if (record->mReportsInProgress > 0)
+    {
+        record->mReportsInProgress--;
+    }
+    record->mLastUsed = ++mUseCounter;
+    Publish(*record);
+
+    EvictIfNeeded();
+
+    if (mDelegate != nullptr && FindRecord(node) != nullptr)
+    {
+        mDelegate->OnNodeUpdated(node);
+    }
+}
+
+CHIP_ERROR SharedClusterStateCache::UpdateAttribute(const ScopedNodeId & node, const ConcreteDataAttributePath & path,
+                                                    TLV::TLVReader * apData, const StatusIB & status)
+{
+    NodeRecord & record  = GetOrAddRecord(node);
+    ClusterData * cluster = GetMutableCluster(record, path.mEndpointId, path.mClusterId);
+    VerifyOrReturnError(cluster != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    const size_t bytesBefore = cluster->GetBytes();
+
+    auto it = std::lower_bound(cluster->mAttributes.begin(), cluster->mAttributes.end(), path.mAttributeId,
+                               [](const AttributeEntry & entry, AttributeId id) { return entry.mAttributeId < id; });
+    const bool isNewEntry = (it == cluster->mAttributes.end() || it->mAttributeId != path.mAttributeId);
+    if (isNewEntry)
+    {
+        AttributeEntry entry;
+        entry.mAttributeId = path.mAttributeId;
+        entry.mOffset      = 0;
+        entry.mLength      = 0;
+        entry.mIsStatus    = true;
+        it                 = cluster->mAttributes.insert(it, entry);
+    }
+
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    if (apData)
+    {
+        err = StoreValue(*cluster, *it, isNewEntry, *apData);
+    }
+    else
+    {
+        if (!it->mIsStatus)
+        {
+            cluster->mGarbageBytes += it->mLength;
+        }
+        it->mIsStatus = true;
+        it->mStatus   = status;
+        it->mLength   = 0;
+    }
+
+    if (err != CHIP_NO_ERROR && isNewEntry)
+    {
+        // Failing to store a value keeps the previous state of the attribute, so a new one must not linger.
+        cluster->mAttributes.erase(it);
+    }
+    else if (path.mDataVersion.HasValue())
+    {
+        cluster->mDataVersion = path.mDataVersion;
+    }
+
+    if (cluster->mGarbageBytes > cluster->mValues.size() / 2)
+    {
+        CompactValues(*cluster);
+    }
+
+    const size_t bytesAfter = cluster->GetBytes();
+    record.mBytes           = record.mBytes - bytesBefore + bytesAfter;
+    mBytesUsed              = mBytesUsed - bytesBefore + bytesAfter;
+
+    // Enforce the budget as the report grows instead of only once it ends, so that a large report makes room
+    // by evicting idle nodes rather than overshooting.  The node being reported is in progress and stays.
+    EvictIfNeeded();
+    return err;
+}
+
+SharedClusterStateCache::ClusterData * SharedClusterStateCache::GetMutableCluster(NodeRecord & record, EndpointId endpointId,
+                                                                                  ClusterId clusterId)
+{
+    // The node itself is shared with the published index after every report; copying it only copies the cluster
+    // pointers.
+    if (!IsExclusive(record.mData))
+    {
+        record.mData = std::make_shared<NodeData>(*record.mData);
+    }
+
+    auto & clusters = record.mData->mClusters;
+    auto it         = FindClusterEntry(clusters, endpointId, clusterId);
+
+    if (it == clusters.end() || (*it)->mEndpointId != endpointId || (*it)->mClusterId != clusterId)
+    {
+        auto cluster         = std::make_shared<ClusterData>();
+        cluster->mEndpointId = endpointId;
+        cluster->mClusterId  = clusterId;
+
+        const size_t bytes = cluster->GetBytes() + sizeof(std::shared_ptr<ClusterData>);
+        record.mBytes += bytes;
+        mBytesUsed += bytes;
+        return clusters.insert(it, std::move(cluster))->get();
+    }
+
+    if (!IsExclusive(*it))
+    {
+        // The published state, and maybe some snapshots, still refer to this cluster: give the node its own,
+        // compacted, copy.
+        auto copy          = std::make_shared<ClusterData>();
+        copy->mEndpointId  = (*it)->mEndpointId;
+        copy->mClusterId   = (*it)->mClusterId;
+        copy->mDataVersion = (*it)->mDataVersion;
+        copy->mAttributes  = (*it)->mAttributes;
+        copy->mValues.reserve((*it)->mValues.size() - (*it)->mGarbageBytes);
+        for (auto & attribute : copy->mAttributes)
+        {
+            if (!attribute.mIsStatus)
+            {
+                const uint8_t * value = (*it)->mValues.data() + attribute.mOffset;
+                attribute.mOffset     = static_cast<uint32_t>(copy->mValues.size());
+                copy->mValues.insert(copy->mValues.end(), value, value + attribute.mLength);
+            }
+        }
+
+        record.mBytes = record.mBytes - (*it)->GetBytes() + copy->GetBytes();
+        mBytesUsed    = mBytesUsed - (*it)->GetBytes() + copy->GetBytes();
+        *it           = std::move(copy);
+    }
+
+    return it->get();
+}
+
+CHIP_ERROR SharedClusterStateCache::StoreValue(ClusterData & cluster, AttributeEntry & entry, bool isNewEntry,
+                                               TLV::TLVReader & data)
+{
+    // The value is re-encoded with an anonymous tag, which never makes it larger than the buffer it was read from.
+    if (mScratch.size() < data.GetTotalLength())
+    {
+        mScratch.resize(data.GetTotalLength());
+    }
+
+    TLV::TLVReader reader;
+    reader.Init(data);
+
+    TLV::TLVWriter writer;
+    writer.Init(mScratch.data(), mScratch.size());
+    ReturnErrorOnFailure(writer.CopyElement(TLV::AnonymousTag(), reader));
+    ReturnErrorOnFailure(writer.Finalize());
+    const uint32_t length = writer.GetLengthWritten();
+
+    if (!isNewEntry && !entry.mIsStatus && length <= entry.mLength)
+    {
+        // Overwrite the previous value in place; the cluster is not shared with any snapshot at this point.
+        memcpy(cluster.mValues.data() + entry.mOffset, mScratch.data(), length);
+        cluster.mGarbageBytes += entry.mLength - length;
+        entry.mLength = length;
+        return CHIP_NO_ERROR;
+    }
+
+    if (!isNewEntry && !entry.mIsStatus)
+    {
+        cluster.mGarbageBytes += entry.mLength;
+    }
+
+    entry.mIsStatus = false;
+    entry.mStatus   = StatusIB();
+    entry.mOffset   = static_cast<uint32_t>(cluster.mValues.size());
+    entry.mLength   = length;
+    cluster.mValues.insert(cluster.mValues.end(), mScratch.data(), mScratch.data() + length);
+    return CHIP_NO_ERROR;
+}
+
+void SharedClusterStateCache::CompactValues(ClusterData & cluster)
+{
+    std::vector<uint8_t> values;
+    values.reserve(cluster.mValues.size() - cluster.mGarbageBytes);
+
+    for (auto & attribute : cluster.mAttributes)
+    {
+        if (!attribute.mIsStatus)
+        {
+            const uint8_t * value = cluster.mValues.data() + attribute.mOffset;
+            attribute.mOffset     = static_cast<uint32_t>(values.size());
+            values.insert(values.end(), value, value + attribute.mLength);
+        }
+    }
+
+    cluster.mValues       = std::move(values);
+    cluster.mGarbageBytes = 0;
+}
+
+void SharedClusterStateCache::Publish(const NodeRecord & record)
+{
+    std::lock_guard<System::Mutex> lock(mPublishedLock);
+
+    // Snapshots keep the index they were taken from; only an index nobody else holds may be changed in place.
+    if (!IsExclusive(mPublished))
+    {
+        mPublished = std::make_shared<NodeIndex>(*mPublished);
+    }
+
+    auto it = FindNodeEntry(*mPublished, record.mNodeId);
+    if (it != mPublished->end() && it->first == record.mNodeId)
+    {
+        it->second = record.mData;
+    }
+    else
+    {
+        mPublished->emplace(it, record.mNodeId, record.mData);
+    }
+}
+
+void SharedClusterStateCache::Unpublish(const ScopedNodeId & node)
+{
+    std::lock_guard<System::Mutex> lock(mPublishedLock);
+
+    auto it = FindNodeEntry(*mPublished, node);
+    VerifyOrReturn(it != mPublished->end() && it->first == node);
+
+    if (!IsExclusive(mPublished))
+    {
+        const size_t index = static_cast<size_t>(it - mPublished->begin());
+        mPublished         = std::make_shared<NodeIndex>(*mPublished);
+        it                 = mPublished->begin() + static_cast<ptrdiff_t>(index);
+    }
+    mPublished->erase(it);
+}
+
+void SharedClusterStateCache::EvictIfNeeded()
+{
+    while (mBytesUsed > mMemoryBudget)
+    {
+        // Linear scan for the least recently used node: evictions are rare next to updates, and keeping an LRU list
+        // in order would cost on every report.
+        size_t victim = mNodes.size();
+        for (size_t i = 0; i < mNodes.size(); i++)
+        {
+            if (mNodes[i].mReportsInProgress == 0 && (victim == mNodes.size() || mNodes[i].mLastUsed < mNodes[victim].mLastUsed))
+            {
+                victim = i;
+            }
+        }
+        VerifyOrReturn(victim != mNodes.size());
+
+        const ScopedNodeId node = mNodes[victim].mNodeId;
+        ChipLogProgress(DataManagement, "Evicting node " ChipLogFormatScopedNodeId " from the shared cluster state cache",
+                        ChipLogValueScopedNodeId(node));
+        RemoveRecord(victim);
+
+        if (mDelegate != nullptr)
+        {
+            mDelegate->OnNodeEvicted(node);
+        }
+    }
+}
+
+void SharedClusterStateCache::RemoveRecord(size_t recordIndex)
+{
+    NodeRecord & record = mNodes[recordIndex];
+
+    std::vector<EndpointId> endpoints;
+    for (const auto & cluster : record.mData->mClusters)
+    {
+        if (endpoints.empty() || endpoints.back() != cluster->mEndpointId)
+        {
+            endpoints.push_back(cluster->mEndpointId);
+        }
+    }
+    for (auto * feed : mFeeds)
+    {
+        if (feed->GetNodeId() == record.mNodeId)
+        {
+            feed->ClearDataVersions(endpoints);
+        }
+    }
+
+    Unpublish(record.mNodeId);
+    mBytesUsed -= record.mBytes;
+
+    if (record.mReportsInProgress > 0)
+    {
+        // Keep the record, empty, so that the reports in progress for this node still count for it: it must not be
+        // evicted while they deliver data, and their end must not be mistaken for the end of a later report.
+        record.mData  = std::make_shared<NodeData>();
+        record.mBytes = sizeof(NodeRecord) + sizeof(NodeData);
+        mBytesUsed += record.mBytes;
+        return;
+    }
+    mNodes.erase(mNodes.begin() + static_cast<ptrdiff_t>(recordIndex));
+}
+
+} // namespace app
+} // namespace chip
+#endif // CHIP_CONFIG_ENABLE_READ_CLIENT
@@ -0,0 +1,387 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <app/AppConfig.h>
+#include <app/ClusterStateCache.h>
+#include <app/ConcreteAttributePath.h>
+#include <app/MessageDef/StatusIB.h>
+#include <app/ReadClient.h>
+#include <app/data-model/Decode.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/Optional.h>
+#include <lib/core/ScopedNodeId.h>
+#include <lib/core/TLVReader.h>
+#include <system/SystemMutex.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#if CHIP_CONFIG_ENABLE_READ_CLIENT
+namespace chip {
+namespace app {
+
+/*
+ * SharedClusterStateCache holds the attribute state of many nodes under a single memory budget and hands out
+ * immutable snapshots of it, so that an application can get a consistent view across devices without copying.
+ *
+ * Each node is fed by a NodeFeed, which takes the place of a ClusterStateCache in the ReadClient callback chain
+ * of a read or subscription to that node.  A NodeFeed keeps a data-less ClusterStateCache underneath for data
+ * version bookkeeping, so resubscriptions still send DataVersionFilters.  The attributes received in a report
+ * become visible together once the report ends.
+ *
+ * GetSnapshot() is O(1): a snapshot shares the cached state, which is copy-on-write at cluster granularity.  A
+ * report copies each cluster it updates once, since snapshots may still refer to the previous version of it; the
+ * clusters it does not touch stay shared.  Snapshots may be taken, copied, queried and released on any thread
+ * without holding the Matter stack lock.  All other methods, and the NodeFeeds, must only be used with the stack
+ * lock held.
+ *
+ * When the state of all nodes exceeds the memory budget, whole nodes are evicted, least recently used first.  The
+ * budget is checked after every attribute that is stored, so Delegate::OnNodeEvicted may be called in the middle of
+ * a report for another node.  A node counts as used when a report for it ends or when Touch() is called for it, and
+ * a node with a report in progress is never evicted.  The budget only covers the current state: clusters that have
+ * since been replaced but are still referenced by a snapshot are freed when the last such snapshot is released.
+ */
+class SharedClusterStateCache
+{
+    struct AttributeEntry
+    {
+        AttributeId mAttributeId;
+        uint32_t mOffset; // into ClusterData::mValues, when !mIsStatus
+        uint32_t mLength;
+        StatusIB mStatus;
+        bool mIsStatus;
+    };
+
+    struct ClusterData
+    {
+        EndpointId mEndpointId;
+        ClusterId mClusterId;
+        Optional<DataVersion> mDataVersion;
+        std::vector<AttributeEntry> mAttributes; // sorted by attribute id
+        std::vector<uint8_t> mValues;            // TLV of the attribute values, anonymous tags
+        uint32_t mGarbageBytes = 0;              // bytes of mValues no longer referenced by an attribute
+
+        size_t GetBytes() const
+        {
+            return sizeof(ClusterData) + mAttributes.capacity() * sizeof(AttributeEntry) + mValues.capacity();
+        }
+    };
+
+    struct NodeData
+    {
+        std::vector<std::shared_ptr<ClusterData>> mClusters; // sorted by endpoint, then cluster id
+    };
+
+    using NodeIndex = std::vector<std::pair<ScopedNodeId, std::shared_ptr<const NodeData>>>; // sorted by node
+
+public:
+    class Delegate
+    {
+    public:
+        virtual ~Delegate() = default;
+
+        /*
+         * Called once a report for the node has ended and its data is visible in new snapshots.
+         */
+        virtual void OnNodeUpdated(const ScopedNodeId & node) {}
+
+        /*
+         * Called after the node was evicted to stay within the memory budget.  The data version filters of any
+         * NodeFeed for the node have been dropped, but an established subscription only reports changes: the
+         * application has to re-read or resubscribe to get the state of the node back into the cache.
+         */
+        virtual void OnNodeEvicted(const ScopedNodeId & node) {}
+    };
+
+    /*
+     * An immutable view of the cache as of the time it was taken.  Unlike with ClusterStateCache, TLV data read
+     * from a snapshot stays valid for as long as the snapshot, or a copy of it, is alive.
+     */
+    class Snapshot
+    {
+    public:
+        Snapshot() = default;
+
+        bool HasNode(const ScopedNodeId & node) const { return FindNode(node) != nullptr; }
+
+        /*
+         * Same as ClusterStateCache::Get(path, reader), for the given node.
+         */
+        CHIP_ERROR Get(const ScopedNodeId & node, const ConcreteAttributePath & path, TLV::TLVReader & reader) const;
+
+        /*
+         * Same as ClusterStateCache::Get<AttributeObjectTypeT>(path, value), for the given node.
+         */
+        template <typename AttributeObjectTypeT>
+        CHIP_ERROR Get(const ScopedNodeId & node, const ConcreteAttributePath & path,
+                       typename AttributeObjectTypeT::DecodableType & value) const
+        {
+            TLV::TLVReader reader;
+
+            if (path.mClusterId != AttributeObjectTypeT::GetClusterId() ||
+                path.mAttributeId != AttributeObjectTypeT::GetAttributeId())
+            {
+                return CHIP_ERROR_SCHEMA_MISMATCH;
+            }
+
+            ReturnErrorOnFailure(Get(node, path, reader));
+            return DataModel::Decode(reader, value);
+        }
+
+        /*
+         * Same as ClusterStateCache::GetStatus(path, status), for the given node.
+         */
+        CHIP_ERROR GetStatus(const ScopedNodeId & node, const ConcreteAttributePath & path, StatusIB & status) const;
+
+        /*
+         * Retrieve the data version last reported for the given cluster of the node, if any.  If the cluster is not
+         * in the snapshot, CHIP_ERROR_KEY_NOT_FOUND shall be returned.
+         */
+        CHIP_ERROR GetVersion(const ScopedNodeId & node, const ConcreteClusterPath & path, Optional<DataVersion> & aVersion) const;
+
+        /*
+         * Execute an iterator function that is called for every attribute of the node in a given endpoint and
+         * cluster, in order of attribute id.
+         *
+         * The iterator is expected to have this signature:
+         *      CHIP_ERROR IteratorFunc(const ConcreteAttributePath &path);
+         *
+         * If the cluster is not in the snapshot, CHIP_ERROR_KEY_NOT_FOUND shall be returned.  An error returned by
+         * func stops the iteration and is returned.
+         */
+        template <typename IteratorFunc>
+        CHIP_ERROR ForEachAttribute(const ScopedNodeId & node, EndpointId endpointId, ClusterId clusterId, IteratorFunc func) const
+        {
+            const ClusterData * cluster = FindCluster(node, endpointId, clusterId);
+            VerifyOrReturnError(cluster != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
+
+            for (const auto & attribute : cluster->mAttributes)
+            {
+                ReturnErrorOnFailure(func(ConcreteAttributePath(endpointId, clusterId, attribute.mAttributeId)));
+            }
+            return CHIP_NO_ERROR;
+        }
+
+        /*
+         * Execute an iterator function that is called for every cluster of the node, ordered by endpoint and then
+         * cluster id.
+         *
+         * The iterator is expected to have this signature:
+         *      CHIP_ERROR IteratorFunc(const ConcreteClusterPath &path);
+         *
+         * If the node is not in the snapshot, CHIP_ERROR_KEY_NOT_FOUND shall be returned.
+         */
+        template <typename IteratorFunc>
+        CHIP_ERROR ForEachCluster(const ScopedNodeId & node, IteratorFunc func) const
+        {
+            const NodeData * nodeData = FindNode(node);
+            VerifyOrReturnError(nodeData != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
+
+            for (const auto & cluster : nodeData->mClusters)
+            {
+                ReturnErrorOnFailure(func(ConcreteClusterPath(cluster->mEndpointId, cluster->mClusterId)));
+            }
+            return CHIP_NO_ERROR;
+        }
+
+        /*
+         * Execute an iterator function that is called for every node in the snapshot.
+         *
+         * The iterator is expected to have this signature:
+         *      CHIP_ERROR IteratorFunc(const ScopedNodeId &node);
+         */
+        template <typename IteratorFunc>
+        CHIP_ERROR ForEachNode(IteratorFunc func) const
+        {
+            VerifyOrReturnError(mIndex != nullptr, CHIP_NO_ERROR);
+
+            for (const auto & entry : *mIndex)
+            {
+                ReturnErrorOnFailure(func(entry.first));
+            }
+            return CHIP_NO_ERROR;
+        }
+
+    private:
+        friend class SharedClusterStateCache;
+
+        explicit Snapshot(std::shared_ptr<const NodeIndex> index) : mIndex(std::move(index)) {}
+
+        const NodeData * FindNode(const ScopedNodeId & node) const;
+        const ClusterData * FindCluster(const ScopedNodeId & node, EndpointId endpointId, ClusterId clusterId) const;
+        const AttributeEntry * FindAttribute(const ScopedNodeId & node, const ConcreteAttributePath & path) const;
+
+        std::shared_ptr<const NodeIndex> mIndex;
+    };
+
+    /*
+     * Feeds the reports of one read or subscription interaction with a node into the cache, and forwards all
+     * ReadClient::Callback calls to the application's callback.  Register GetBufferedCallback() with the
+     * ReadClient; like ClusterStateCache, a NodeFeed already includes the BufferedReadCallback.
+     *
+     * The feed must be destroyed before the cache.
+     */
+    class NodeFeed : private ClusterStateCacheNoDataFlat::Callback
+    {
+    public:
+        NodeFeed(SharedClusterStateCache & cache, const ScopedNodeId & node, ReadClient::Callback & callback);
+        ~NodeFeed() override;
+
+        ReadClient::Callback & GetBufferedCallback() { return mVersionCache.GetBufferedCallback(); }
+
+        const ScopedNodeId & GetNodeId() const { return mNodeId; }
+
+    private:
+        friend class SharedClusterStateCache;
+
+        void EndReport();
+
+        // Forget the data versions of the node once the cache no longer holds its data.
+        void ClearDataVersions(const std::vector<EndpointId> & endpoints);
+
+        //
+        // ReadClient::Callback
+        //
+        void OnReportBegin() override;
+        void OnReportEnd() override;
+        void OnAttributeData(const ConcreteDataAttributePath & aPath, TLV::TLVReader * apData, const StatusIB & aStatus) override;
+        void OnEventData(const EventHeader & aEventHeader, TLV::TLVReader * apData, const StatusIB * apStatus) override
+        {
+            mCallback.OnEventData(aEventHeader, apData, apStatus);
+        }
+        void OnError(CHIP_ERROR aError) override { mCallback.OnError(aError); }
+        void OnDone(ReadClient * apReadClient) override;
+        void OnSubscriptionEstablished(SubscriptionId aSubscriptionId) override
+        {
+            mCallback.OnSubscriptionEstablished(aSubscriptionId);
+        }
+        CHIP_ERROR OnResubscriptionNeeded(ReadClient * apReadClient, CHIP_ERROR aTerminationCause) override
+        {
+            return mCallback.OnResubscriptionNeeded(apReadClient, aTerminationCause);
+        }
+        void OnDeallocatePaths(ReadPrepareParams && aReadPrepareParams) override
+        {
+            mCallback.OnDeallocatePaths(std::move(aReadPrepareParams));
+        }
+        void OnUnsolicitedMessageFromPublisher(ReadClient * apReadClient) override
+        {
+            mCallback.OnUnsolicitedMessageFromPublisher(apReadClient);
+        }
+        void OnCASESessionEstablished(const SessionHandle & aSession, ReadPrepareParams & aSubscriptionParams) override
+        {
+            mCallback.OnCASESessionEstablished(aSession, aSubscriptionParams);
+        }
+
+        SharedClusterStateCache & mCache;
+        const ScopedNodeId mNodeId;
+        ReadClient::Callback & mCallback;
+        ClusterStateCacheNoDataFlat mVersionCache;
+        bool mInReport = false;
+    };
+
+    /*
+     * @param [in] memoryBudget the number of bytes the state of all nodes may take before nodes get evicted.
+     * @param [in] delegate optional delegate notified of node updates and evictions.
+     */
+    SharedClusterStateCache(size_t memoryBudget, Delegate * delegate = nullptr) : mMemoryBudget(memoryBudget), mDelegate(delegate)
+    {}
+    ~SharedClusterStateCache();
+
+    SharedClusterStateCache(const SharedClusterStateCache &)             = delete;
+    SharedClusterStateCache & operator=(const SharedClusterStateCache &) = delete;
+
+    /*
+     * Must be called, and succeed, before the cache is used.
+     */
+    CHIP_ERROR Init();
+
+    /*
+     * Take an immutable snapshot of the data of all nodes.  May be called from any thread.
+     */
+    Snapshot GetSnapshot() const;
+
+    /*
+     * Mark the node as recently used, so it is evicted after the nodes that have been used less recently.
+     */
+    void Touch(const ScopedNodeId & node);
+
+    /*
+     * Drop all data held for the node.  Snapshots that have already been taken are not affected.  If a report for
+     * the node is in progress, the attributes it delivers from now on are published when it ends.
+     */
+    void RemoveNode(const ScopedNodeId & node);
+
+    /*
+     * Change the memory budget, evicting nodes right away if the current state no longer fits.
+     */
+    void SetMemoryBudget(size_t memoryBudget);
+    size_t GetMemoryBudget() const { return mMemoryBudget; }
+
+    /*
+     * Approximate number of bytes taken by the current state of all nodes.
+     */
+    size_t GetBytesUsed() const { return mBytesUsed; }
+
+    size_t GetNodeCount() const { return mNodes.size(); }
+
+private:
+    struct NodeRecord
+    {
+        ScopedNodeId mNodeId;
+        std::shared_ptr<NodeData> mData; // shared with the published index once the node has been published
+        size_t mBytes               = 0;
+        uint64_t mLastUsed          = 0;
+        uint16_t mReportsInProgress = 0;
+    };
+
+    NodeRecord * FindRecord(const ScopedNodeId & node);
+    NodeRecord & GetOrAddRecord(const ScopedNodeId & node);
+
+    void BeginReport(const ScopedNodeId & node);
+    void EndReport(const ScopedNodeId & node);
+    CHIP_ERROR UpdateAttribute(const ScopedNodeId & node, const ConcreteDataAttributePath & path, TLV::TLVReader * apData,
+                               const StatusIB & status);
+
+    // Returns a cluster of the record that is not shared with any published state, copying or adding it as needed.
+    ClusterData * GetMutableCluster(NodeRecord & record, EndpointId endpointId, ClusterId clusterId);
+    CHIP_ERROR StoreValue(ClusterData & cluster, AttributeEntry & entry, bool isNewEntry, TLV::TLVReader & data);
+    static void CompactValues(ClusterData & cluster);
+
+    void Publish(const NodeRecord & record);
+    void Unpublish(const ScopedNodeId & node);
+    void EvictIfNeeded();
+    void RemoveRecord(size_t recordIndex);
+
+    mutable System::Mutex mPublishedLock;
+    std::shared_ptr<NodeIndex> mPublished; // guarded by mPublishedLock
+
+    std::vector<NodeRecord> mNodes; // sorted by node
+    std::vector<NodeFeed *> mFeeds;
+    std::vector<uint8_t> mScratch;
+    size_t mMemoryBudget;
+    size_t mBytesUsed    = 0;
+    uint64_t mUseCounter = 0;
+    Delegate * mDelegate;
+};
+
+} // namespace app
+} // namespace chip
+#endif // CHIP_CONFIG_ENABLE_READ_CLIENT
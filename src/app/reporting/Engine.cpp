@@ -593,6 +593,13 @@ CHIP_ERROR Engine::BuildSingleReportDataEventReports(ReportDataMessage::Builder
         ExitNow(); // Read clean, move along
     }
 
+    // Nothing logged since the last complete fetch matches this subscription, skip over it without scanning the log.
+    if (!apReadHandler->MayHaveNewMatchingEvents())
+    {
+        mpEventManagement->SkipToEndOfLog(eventMin, apReadHandler->GetEventCursor());
+        ExitNow();
+    }
+
     {
         // Just like what we do in BuildSingleReportDataAttributeReportIBs(), we need to reserve one byte for end of container tag
         // when encoding events to ensure we can close the container successfully.
@@ -606,12 +613,17 @@ CHIP_ERROR Engine::BuildSingleReportDataEventReports(ReportDataMessage::Builder
         SuccessOrExit(err);
 
         err = mpEventManagement->FetchEventsSince(*(eventReportIBs.GetWriter()), apReadHandler->GetEventPathList(), eventMin,
-                                                  eventCount, apReadHandler->GetSubjectDescriptor());
+                                                  eventCount, apReadHandler->GetSubjectDescriptor(),
+                                                  &apReadHandler->GetEventCursor());
 
         if ((err == CHIP_END_OF_TLV) || (err == CHIP_ERROR_TLV_UNDERRUN) || (err == CHIP_NO_ERROR))
         {
             err           = CHIP_NO_ERROR;
             hasMoreChunks = false;
+            if (apReadHandler->IsType(ReadHandler::InteractionType::Subscribe))
+            {
+                apReadHandler->SetAllEventsFetched();
+            }
         }
         else if (IsOutOfWriterSpaceError(err))
         {
@@ -1162,7 +1174,13 @@ CHIP_ERROR Engine::NewEventGenerated(ConcreteEventPath & aPath, uint32_t aBytesC
         for (auto * interestedPath = handler->GetEventPathList(); interestedPath != nullptr;
              interestedPath        = interestedPath->mpNext)
         {
-            if (interestedPath->mValue.IsEventPathSupersetOf(aPath) && interestedPath->mValue.mIsUrgentEvent)
+            if (!interestedPath->mValue.IsEventPathSupersetOf(aPath))
+            {
+                continue;
+            }
+
+            handler->OnMatchingEventGenerated();
+            if (interestedPath->mValue.mIsUrgentEvent)
             {
                 isUrgentEvent = true;
                 handler->ForceDirtyState();
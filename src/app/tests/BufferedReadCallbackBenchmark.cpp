@@ -0,0 +1,189 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @file
+ *   Compares the buffered and streaming list modes of BufferedReadCallback on a large list attribute received
+ *   in chunks: the time to reassemble and walk the list, and the peak heap held while the consumer sees it.
+ *
+ *   Usage: buffered-read-callback-benchmark [items]
+ */
+
+#include <app/BufferedReadCallback.h>
+#include <lib/core/TLV.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/tests/BenchmarkHelpers.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace chip;
+using namespace chip::app;
+
+namespace {
+
+// Roughly what fits in one chunk alongside the report framing.
+constexpr uint32_t kItemsPerChunk = 20;
+constexpr uint8_t kLabel[32]      = {};
+
+size_t HeapInUse()
+{
+#if defined(__GLIBC__)
+    // Large list buffers are served by mmap, so count those blocks too.
+    const struct mallinfo info = mallinfo();
+    return static_cast<size_t>(info.uordblks) + static_cast<size_t>(info.hblkhd);
+#else
+    return 0;
+#endif
+}
+
+// Walks the reassembled list and checks that every item came through in order.
+class Consumer : public ReadClient::Callback
+{
+public:
+    void OnAttributeData(const ConcreteDataAttributePath & aPath, TLV::TLVReader * apData, const StatusIB & aStatus) override
+    {
+        mPeakHeap = std::max(mPeakHeap, HeapInUse());
+
+        VerifyOrDie(apData != nullptr && aPath.mListOp == ConcreteDataAttributePath::ListOperation::ReplaceAll);
+
+        TLV::TLVType listType;
+        VerifyOrDie(apData->EnterContainer(listType) == CHIP_NO_ERROR);
+
+        uint32_t count = 0;
+        CHIP_ERROR err;
+        while ((err = apData->Next()) == CHIP_NO_ERROR)
+        {
+            TLV::TLVType itemType;
+            uint32_t index;
+            ByteSpan label;
+
+            VerifyOrDie(apData->EnterContainer(itemType) == CHIP_NO_ERROR);
+            VerifyOrDie(apData->Next(TLV::ContextTag(0)) == CHIP_NO_ERROR && apData->Get(index) == CHIP_NO_ERROR);
+            VerifyOrDie(apData->Next(TLV::ContextTag(1)) == CHIP_NO_ERROR && apData->Get(label) == CHIP_NO_ERROR);
+            VerifyOrDie(apData->ExitContainer(itemType) == CHIP_NO_ERROR);
+
+            VerifyOrDie(index == count && label.size() == sizeof(kLabel));
+            count++;
+        }
+        VerifyOrDie(err == CHIP_END_OF_TLV && apData->ExitContainer(listType) == CHIP_NO_ERROR);
+
+        mItemsSeen = count;
+    }
+
+    void OnDone(ReadClient *) override {}
+
+    size_t mPeakHeap    = 0;
+    uint32_t mItemsSeen = 0;
+};
+
+CHIP_ERROR EncodeItem(TLV::TLVWriter & writer, TLV::Tag tag, uint32_t index)
+{
+    TLV::TLVType outer;
+    ReturnErrorOnFailure(writer.StartContainer(tag, TLV::kTLVType_Structure, outer));
+    ReturnErrorOnFailure(writer.Put(TLV::ContextTag(0), index));
+    ReturnErrorOnFailure(writer.Put(TLV::ContextTag(1), ByteSpan(kLabel)));
+    return writer.EndContainer(outer);
+}
+
+// Feeds a list of itemCount items the way a chunked report delivers it: a ReplaceAll with the items that fit
+// in the first chunk, followed by one AppendItem per remaining item.
+void FeedList(ReadClient::Callback & callback, uint32_t itemCount)
+{
+    ConcreteDataAttributePath path(1, 0xFFF1FC05, 0x0000, MakeOptional(DataVersion(1)));
+    uint8_t buf[1024];
+    TLV::TLVWriter writer;
+    TLV::TLVReader reader;
+
+    callback.OnReportBegin();
+
+    writer.Init(buf);
+    TLV::TLVType listType;
+    VerifyOrDie(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Array, listType) == CHIP_NO_ERROR);
+    const uint32_t firstChunk = std::min(itemCount, kItemsPerChunk);
+    for (uint32_t i = 0; i < firstChunk; i++)
+    {
+        VerifyOrDie(EncodeItem(writer, TLV::AnonymousTag(), i) == CHIP_NO_ERROR);
+    }
+    VerifyOrDie(writer.EndContainer(listType) == CHIP_NO_ERROR);
+
+    reader.Init(buf, writer.GetLengthWritten());
+    VerifyOrDie(reader.Next() == CHIP_NO_ERROR);
+    path.mListOp = ConcreteDataAttributePath::ListOperation::ReplaceAll;
+    callback.OnAttributeData(path, &reader, StatusIB());
+
+    path.mListOp = ConcreteDataAttributePath::ListOperation::AppendItem;
+    for (uint32_t i = firstChunk; i < itemCount; i++)
+    {
+        writer.Init(buf);
+        VerifyOrDie(EncodeItem(writer, TLV::AnonymousTag(), i) == CHIP_NO_ERROR);
+
+        reader.Init(buf, writer.GetLengthWritten());
+        VerifyOrDie(reader.Next() == CHIP_NO_ERROR);
+        callback.OnAttributeData(path, &reader, StatusIB());
+    }
+
+    callback.OnReportEnd();
+}
+
+void RunMode(const char * modeName, bool streamLists, uint32_t itemCount)
+{
+    char name[96];
+    Consumer consumer;
+    BufferedReadCallback bufferedCallback(consumer, streamLists);
+    ReadClient::Callback & callback = bufferedCallback;
+
+    const size_t heapBefore = HeapInUse();
+    FeedList(callback, itemCount);
+    VerifyOrDie(consumer.mItemsSeen == itemCount);
+    printf("%s: peak heap while consuming %" PRIu32 " items: %zu bytes\n", modeName, itemCount, consumer.mPeakHeap - heapBefore);
+
+    snprintf(name, sizeof(name), "%s: reassemble and walk %" PRIu32 " items", modeName, itemCount);
+    auto result = Test::RunBenchmark(name, 50, [&](uint64_t) {
+        consumer.mItemsSeen = 0;
+        FeedList(callback, itemCount);
+        return consumer.mItemsSeen == itemCount;
+    });
+    Test::PrintBenchmarkResult(result);
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+    uint32_t itemCount = 2000;
+    if (argc > 1)
+    {
+        itemCount = static_cast<uint32_t>(strtoul(argv[1], nullptr, 0));
+    }
+
+    VerifyOrDie(Platform::MemoryInit() == CHIP_NO_ERROR);
+
+    Test::PrintBenchmarkHeader();
+    RunMode("buffered", false, itemCount);
+    RunMode("streamed", true, itemCount);
+
+    Platform::MemoryShutdown();
+    return 0;
+}
@@ -0,0 +1,255 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @file
+ *   Measures encode and decode of struct-heavy cluster objects: a Scenes Management AddScene command,
+ *   a Thermostat schedule and a Device Energy Management power forecast.  Decoding walks every nested
+ *   list, the way a command handler or a report consumer would.
+ *
+ *   Usage: cluster-objects-benchmark [iterations]
+ */
+
+#include <app-common/zap-generated/cluster-objects.h>
+#include <lib/core/TLV.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/tests/BenchmarkHelpers.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace chip;
+using namespace chip::app;
+using namespace chip::app::Clusters;
+
+namespace {
+
+constexpr uint64_t kDefaultIterations = 100000;
+
+uint8_t gEncoded[4096];
+uint32_t gEncodedLength;
+
+template <typename T>
+bool EncodeObject(const T & object)
+{
+    TLV::TLVWriter writer;
+    writer.Init(gEncoded);
+    VerifyOrReturnValue(DataModel::Encode(writer, TLV::AnonymousTag(), object) == CHIP_NO_ERROR, false);
+    VerifyOrReturnValue(writer.Finalize() == CHIP_NO_ERROR, false);
+    gEncodedLength = writer.GetLengthWritten();
+    return true;
+}
+
+template <typename T>
+bool DecodeObject(T & object)
+{
+    TLV::TLVReader reader;
+    reader.Init(gEncoded, gEncodedLength);
+    VerifyOrReturnValue(reader.Next() == CHIP_NO_ERROR, false);
+    return DataModel::Decode(reader, object) == CHIP_NO_ERROR;
+}
+
+template <typename DecodableListType, typename Visitor>
+bool ForEach(const DecodableListType & list, Visitor && visitor)
+{
+    auto iter = list.begin();
+    while (iter.Next())
+    {
+        VerifyOrReturnValue(visitor(iter.GetValue()), false);
+    }
+    return iter.GetStatus() == CHIP_NO_ERROR;
+}
+
+// Scenes Management AddScene: 3 extension field sets of 4 attribute values each.
+ScenesManagement::Structs::AttributeValuePairStruct::Type gAttributeValues[3][4];
+ScenesManagement::Structs::ExtensionFieldSet::Type gExtensionFieldSets[3];
+ScenesManagement::Commands::AddScene::Type gAddScene;
+
+void BuildAddScene()
+{
+    for (uint8_t set = 0; set < 3; set++)
+    {
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            auto & value       = gAttributeValues[set][i];
+            value.attributeID  = i;
+            if (i % 2 == 0)
+            {
+                value.valueUnsigned8.SetValue(static_cast<uint8_t>(i + set));
+            }
+            else
+            {
+                value.valueUnsigned16.SetValue(static_cast<uint16_t>(1000 + i));
+            }
+        }
+        gExtensionFieldSets[set].clusterID          = static_cast<ClusterId>(6 + set);
+        gExtensionFieldSets[set].attributeValueList = DataModel::List<const ScenesManagement::Structs::AttributeValuePairStruct::Type>(
+            gAttributeValues[set]);
+    }
+
+    gAddScene.groupID            = 1;
+    gAddScene.sceneID            = 2;
+    gAddScene.transitionTime     = 1000;
+    gAddScene.sceneName          = "Evening lights"_span;
+    gAddScene.extensionFieldSets = DataModel::List<const ScenesManagement::Structs::ExtensionFieldSet::Type>(gExtensionFieldSets);
+}
+
+bool DecodeAddScene()
+{
+    ScenesManagement::Commands::AddScene::DecodableType command;
+    VerifyOrReturnValue(DecodeObject(command), false);
+    uint32_t values = 0;
+    VerifyOrReturnValue(ForEach(command.extensionFieldSets,
+                                [&](const ScenesManagement::Structs::ExtensionFieldSet::DecodableType & set) {
+                                    return ForEach(set.attributeValueList,
+                                                   [&](const ScenesManagement::Structs::AttributeValuePairStruct::Type & value) {
+                                                       values++;
+                                                       return true;
+                                                   });
+                                }),
+                        false);
+    return values == 12;
+}
+
+// Thermostat schedule with a transition per day part for a whole week.
+Thermostat::Structs::ScheduleTransitionStruct::Type gTransitions[28];
+Thermostat::Structs::ScheduleStruct::Type gSchedule;
+const uint8_t kScheduleHandle[] = { 0x01, 0x02, 0x03, 0x04 };
+
+void BuildSchedule()
+{
+    for (uint8_t i = 0; i < ArraySize(gTransitions); i++)
+    {
+        auto & transition = gTransitions[i];
+        transition.dayOfWeek.Set(static_cast<Thermostat::ScheduleDayOfWeekBitmap>(1 << (i / 4)));
+        transition.transitionTime = static_cast<uint16_t>((i % 4) * 360);
+        transition.systemMode.SetValue(Thermostat::SystemModeEnum::kHeat);
+        transition.heatingSetpoint.SetValue(static_cast<int16_t>(1900 + (i % 4) * 100));
+    }
+
+    gSchedule.scheduleHandle.SetNonNull(ByteSpan(kScheduleHandle));
+    gSchedule.systemMode = Thermostat::SystemModeEnum::kHeat;
+    gSchedule.name.SetValue("Weekdays"_span);
+    gSchedule.transitions = DataModel::List<const Thermostat::Structs::ScheduleTransitionStruct::Type>(gTransitions);
+    gSchedule.builtIn.SetNonNull(false);
+}
+
+bool DecodeSchedule()
+{
+    Thermostat::Structs::ScheduleStruct::DecodableType schedule;
+    VerifyOrReturnValue(DecodeObject(schedule), false);
+    uint32_t transitions = 0;
+    VerifyOrReturnValue(ForEach(schedule.transitions,
+                                [&](const Thermostat::Structs::ScheduleTransitionStruct::Type & transition) {
+                                    transitions++;
+                                    return true;
+                                }),
+                        false);
+    return transitions == ArraySize(gTransitions);
+}
+
+// Device Energy Management forecast of 12 fully populated slots with 2 costs each.
+DeviceEnergyManagement::Structs::CostStruct::Type gCosts[2];
+DeviceEnergyManagement::Structs::SlotStruct::Type gSlots[12];
+DeviceEnergyManagement::Structs::ForecastStruct::Type gForecast;
+
+void BuildForecast()
+{
+    gCosts[0].costType = DeviceEnergyManagement::CostTypeEnum::kFinancial;
+    gCosts[0].value    = 1234;
+    gCosts[1].costType = DeviceEnergyManagement::CostTypeEnum::kGHGEmissions;
+    gCosts[1].value    = 56;
+
+    for (uint32_t i = 0; i < ArraySize(gSlots); i++)
+    {
+        auto & slot            = gSlots[i];
+        slot.minDuration       = 600;
+        slot.maxDuration       = 3600;
+        slot.defaultDuration   = 1800;
+        slot.elapsedSlotTime   = 0;
+        slot.remainingSlotTime = 1800;
+        slot.slotIsPausable.SetValue(true);
+        slot.minPauseDuration.SetValue(60);
+        slot.maxPauseDuration.SetValue(600);
+        slot.manufacturerESAState.SetValue(static_cast<uint16_t>(i));
+        slot.nominalPower.SetValue(2000000);
+        slot.minPower.SetValue(1000000);
+        slot.maxPower.SetValue(3000000);
+        slot.nominalEnergy.SetValue(1000000);
+        slot.costs.SetValue(DataModel::List<const DeviceEnergyManagement::Structs::CostStruct::Type>(gCosts));
+        slot.minPowerAdjustment.SetValue(-500000);
+        slot.maxPowerAdjustment.SetValue(500000);
+        slot.minDurationAdjustment.SetValue(300);
+        slot.maxDurationAdjustment.SetValue(900);
+    }
+
+    gForecast.forecastID = 7;
+    gForecast.activeSlotNumber.SetNonNull(static_cast<uint16_t>(0));
+    gForecast.startTime = 1000;
+    gForecast.endTime   = 1000 + 1800 * ArraySize(gSlots);
+    gForecast.isPausable = true;
+    gForecast.slots      = DataModel::List<const DeviceEnergyManagement::Structs::SlotStruct::Type>(gSlots);
+    gForecast.forecastUpdateReason = DeviceEnergyManagement::ForecastUpdateReasonEnum::kInternalOptimization;
+}
+
+bool DecodeForecast()
+{
+    DeviceEnergyManagement::Structs::ForecastStruct::DecodableType forecast;
+    VerifyOrReturnValue(DecodeObject(forecast), false);
+    uint32_t costs = 0;
+    VerifyOrReturnValue(ForEach(forecast.slots,
+                                [&](const DeviceEnergyManagement::Structs::SlotStruct::DecodableType & slot) {
+                                    VerifyOrReturnValue(slot.costs.HasValue(), false);
+                                    return ForEach(slot.costs.Value(),
+                                                   [&](const DeviceEnergyManagement::Structs::CostStruct::Type & cost) {
+                                                       costs++;
+                                                       return true;
+                                                   });
+                                }),
+                        false);
+    return costs == 2 * ArraySize(gSlots);
+}
+
+template <typename T>
+void RunCase(const char * name, const T & object, bool (*decode)(), uint64_t iterations)
+{
+    char caseName[64];
+
+    snprintf(caseName, sizeof(caseName), "Encode(%s)", name);
+    Test::PrintBenchmarkResult(Test::RunBenchmark(caseName, iterations, [&](uint64_t) { return EncodeObject(object); }));
+
+    snprintf(caseName, sizeof(caseName), "Decode(%s) [%u bytes]", name, static_cast<unsigned>(gEncodedLength));
+    Test::PrintBenchmarkResult(Test::RunBenchmark(caseName, iterations, [&](uint64_t) { return decode(); }));
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+    const uint64_t iterations = (argc > 1) ? strtoull(argv[1], nullptr, 0) : kDefaultIterations;
+
+    BuildAddScene();
+    BuildSchedule();
+    BuildForecast();
+
+    Test::PrintBenchmarkHeader();
+    RunCase("ScenesManagement::AddScene", gAddScene, DecodeAddScene, iterations);
+    RunCase("Thermostat::ScheduleStruct", gSchedule, DecodeSchedule, iterations);
+    RunCase("DeviceEnergyManagement::ForecastStruct", gForecast, DecodeForecast, iterations);
+    return EXIT_SUCCESS;
+}
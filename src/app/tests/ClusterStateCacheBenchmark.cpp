@@ -0,0 +1,231 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @file
+ *   Compares the map and flat storage engines of ClusterStateCacheT: the time to prime the cache with a
+ *   wildcard report of a large bridge, the heap it holds afterwards, and the cost of attribute lookups,
+ *   per-cluster iteration and generating the data version filters of a resubscription.
+ *
+ *   Usage: cluster-state-cache-benchmark [endpoints]
+ */
+
+#include <app/ClusterStateCache.h>
+#include <app/MessageDef/DataVersionFilterIBs.h>
+#include <lib/core/TLV.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/tests/BenchmarkHelpers.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace chip;
+using namespace chip::app;
+
+namespace {
+
+constexpr ClusterId kClustersPerEndpoint   = 10;
+constexpr AttributeId kAttributesPerCluster = 15;
+
+size_t HeapInUse()
+{
+#if defined(__GLIBC__)
+    return static_cast<size_t>(mallinfo().uordblks);
+#else
+    return 0;
+#endif
+}
+
+template <typename CacheType>
+class Callback : public CacheType::Callback
+{
+    void OnDone(ReadClient *) override {}
+};
+
+// Encodes the value reported for an attribute: a mix of integers, strings and small structs.
+uint32_t EncodeValue(AttributeId attributeId, uint32_t seed, uint8_t * buf, size_t bufSize)
+{
+    TLV::TLVWriter writer;
+    writer.Init(buf, bufSize);
+
+    switch (attributeId % 3)
+    {
+    case 0:
+        VerifyOrDie(writer.Put(TLV::AnonymousTag(), static_cast<uint16_t>(seed)) == CHIP_NO_ERROR);
+        break;
+    case 1:
+        VerifyOrDie(writer.PutString(TLV::AnonymousTag(), "bridged-device-name") == CHIP_NO_ERROR);
+        break;
+    default: {
+        TLV::TLVType outer;
+        VerifyOrDie(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outer) == CHIP_NO_ERROR);
+        VerifyOrDie(writer.Put(TLV::ContextTag(0), seed) == CHIP_NO_ERROR);
+        VerifyOrDie(writer.PutBoolean(TLV::ContextTag(1), true) == CHIP_NO_ERROR);
+        VerifyOrDie(writer.EndContainer(outer) == CHIP_NO_ERROR);
+        break;
+    }
+    }
+
+    return writer.GetLengthWritten();
+}
+
+template <typename CacheType>
+void Prime(CacheType & cache, EndpointId endpoints, uint32_t seed)
+{
+    ReadClient::Callback & callback = cache.GetBufferedCallback();
+    uint8_t buf[64];
+
+    callback.OnReportBegin();
+    for (EndpointId endpoint = 1; endpoint <= endpoints; endpoint++)
+    {
+        for (ClusterId cluster = 0; cluster < kClustersPerEndpoint; cluster++)
+        {
+            for (AttributeId attribute = 0; attribute < kAttributesPerCluster; attribute++)
+            {
+                TLV::TLVReader reader;
+                reader.Init(buf, EncodeValue(attribute, seed + attribute, buf, sizeof(buf)));
+                VerifyOrDie(reader.Next() == CHIP_NO_ERROR);
+
+                ConcreteDataAttributePath path(endpoint, cluster, attribute, MakeOptional(seed));
+                callback.OnAttributeData(path, &reader, StatusIB());
+            }
+        }
+    }
+    callback.OnReportEnd();
+}
+
+// Encodes the data version filters of a wildcard resubscription into a request-sized buffer.
+bool EncodeFilters(ReadClient::Callback & callback)
+{
+    AttributePathParams wildcardPath;
+    uint8_t buf[1024];
+    TLV::TLVWriter writer;
+    writer.Init(buf);
+
+    DataVersionFilterIBs::Builder builder;
+    bool encodedDataVersionList = false;
+    return builder.Init(&writer) == CHIP_NO_ERROR &&
+        callback.OnUpdateDataVersionFilterList(builder, Span<AttributePathParams>(&wildcardPath, 1), encodedDataVersionList) ==
+        CHIP_NO_ERROR;
+}
+
+template <typename CacheType>
+void RunEngine(const char * engineName, EndpointId endpoints)
+{
+    char name[96];
+    const uint64_t attributeCount = uint64_t(endpoints) * kClustersPerEndpoint * kAttributesPerCluster;
+
+    Callback<CacheType> callback;
+    const size_t heapBefore = HeapInUse();
+    {
+        CacheType cache(callback);
+
+        // Subscribe to a wildcard path first, so the cache tracks data versions.
+        VerifyOrDie(EncodeFilters(cache.GetBufferedCallback()));
+
+        snprintf(name, sizeof(name), "%s: prime %" PRIu64 " attributes", engineName, attributeCount);
+        auto result = Test::RunBenchmark(name, 1, [&](uint64_t) {
+            Prime(cache, endpoints, 1);
+            return true;
+        });
+        // Report per attribute.
+        result.mIterations = attributeCount;
+        Test::PrintBenchmarkResult(result);
+
+        const size_t heapAfter = HeapInUse();
+        printf("%s: heap held after priming: %zu bytes (%.1f per attribute)\n", engineName, heapAfter - heapBefore,
+               static_cast<double>(heapAfter - heapBefore) / static_cast<double>(attributeCount));
+
+        snprintf(name, sizeof(name), "%s: update report", engineName);
+        result = Test::RunBenchmark(name, 1, [&](uint64_t) {
+            Prime(cache, endpoints, 2);
+            return true;
+        });
+        result.mIterations = attributeCount;
+        Test::PrintBenchmarkResult(result);
+
+        snprintf(name, sizeof(name), "%s: Get(path, reader)", engineName);
+        uint32_t state = 1;
+        Test::PrintBenchmarkResult(Test::RunBenchmark(name, attributeCount * 4, [&](uint64_t) {
+            // xorshift, so lookups do not walk the tables in order.
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            const ConcreteAttributePath path(static_cast<EndpointId>(1 + state % endpoints),
+                                             static_cast<ClusterId>((state >> 8) % kClustersPerEndpoint),
+                                             static_cast<AttributeId>((state >> 16) % kAttributesPerCluster));
+            TLV::TLVReader reader;
+            CHIP_ERROR err = cache.Get(path, reader);
+            Test::DoNotOptimize(reader);
+            return err == CHIP_NO_ERROR;
+        }));
+
+        snprintf(name, sizeof(name), "%s: ForEachAttribute(endpoint, cluster)", engineName);
+        Test::PrintBenchmarkResult(Test::RunBenchmark(name, uint64_t(endpoints) * kClustersPerEndpoint * 4, [&](uint64_t i) {
+            const EndpointId endpoint = static_cast<EndpointId>(1 + (i / kClustersPerEndpoint) % endpoints);
+            const ClusterId cluster   = static_cast<ClusterId>(i % kClustersPerEndpoint);
+            uint32_t visited          = 0;
+            CHIP_ERROR err            = cache.ForEachAttribute(endpoint, cluster, [&visited](const ConcreteAttributePath &) {
+                visited++;
+                return CHIP_NO_ERROR;
+            });
+            return err == CHIP_NO_ERROR && visited == kAttributesPerCluster;
+        }));
+
+        snprintf(name, sizeof(name), "%s: OnUpdateDataVersionFilterList", engineName);
+        Test::PrintBenchmarkResult(
+            Test::RunBenchmark(name, 1000, [&](uint64_t) { return EncodeFilters(cache.GetBufferedCallback()); }));
+
+        snprintf(name, sizeof(name), "%s: destroy", engineName);
+        result = Test::RunBenchmark(name, 1, [&](uint64_t) {
+            for (EndpointId endpoint = 1; endpoint <= endpoints; endpoint++)
+            {
+                cache.ClearAttributes(endpoint);
+            }
+            return true;
+        });
+        result.mIterations = attributeCount;
+        Test::PrintBenchmarkResult(result);
+    }
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+    EndpointId endpoints = 100;
+    if (argc > 1)
+    {
+        endpoints = static_cast<EndpointId>(strtoul(argv[1], nullptr, 0));
+    }
+    VerifyOrDie(endpoints > 0);
+
+    VerifyOrDie(Platform::MemoryInit() == CHIP_NO_ERROR);
+
+    Test::PrintBenchmarkHeader();
+    RunEngine<ClusterStateCache>("map", endpoints);
+    RunEngine<ClusterStateCacheFlat>("flat", endpoints);
+
+    Platform::MemoryShutdown();
+    return 0;
+}
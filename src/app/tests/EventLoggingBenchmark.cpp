@@ -0,0 +1,164 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @file
+ *   Measures EventManagement::LogEvent throughput with RAM-backed priority buffers and with
+ *   memory-mapped, file-backed buffers (with and without msync on every layout commit).
+ *
+ *   Usage: event-logging-benchmark [iterations] [directory]
+ */
+
+#include <app/EventLoggingDelegate.h>
+#include <app/EventManagement.h>
+#include <app/EventReporter.h>
+#include <app/MappedFileEventBufferStore.h>
+#include <app/MessageDef/EventDataIB.h>
+#include <lib/support/CHIPCounter.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/tests/BenchmarkHelpers.h>
+#include <platform/CHIPDeviceLayer.h>
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace chip;
+using namespace chip::app;
+
+namespace {
+
+constexpr uint32_t kBufferSize        = 4096;
+constexpr uint64_t kDefaultIterations = 20000;
+
+class NullEventReporter : public EventReporter
+{
+public:
+    CHIP_ERROR NewEventGenerated(ConcreteEventPath & aPath, uint32_t aBytesConsumed) override { return CHIP_NO_ERROR; }
+};
+
+class BenchmarkEventGenerator : public EventLoggingDelegate
+{
+public:
+    CHIP_ERROR WriteEvent(TLV::TLVWriter & aWriter) override
+    {
+        TLV::TLVType dataContainerType;
+        ReturnErrorOnFailure(aWriter.StartContainer(TLV::ContextTag(EventDataIB::Tag::kData), TLV::kTLVType_Structure,
+                                                    dataContainerType));
+        ReturnErrorOnFailure(aWriter.Put(TLV::ContextTag(0), mValue));
+        ReturnErrorOnFailure(aWriter.PutString(TLV::ContextTag(1), "benchmark event payload"));
+        return aWriter.EndContainer(dataContainerType);
+    }
+
+    uint32_t mValue = 0;
+};
+
+enum class Backend
+{
+    kRam,
+    kMappedFile,
+    kMappedFileSync,
+};
+
+uint8_t gRamBuffers[3][kBufferSize];
+CircularEventBuffer gCircularEventBuffer[3];
+MappedFileEventBufferStore gStores[3];
+NullEventReporter gEventReporter;
+
+Test::BenchmarkResult RunLoggingBenchmark(const char * name, Backend backend, const char * directory, uint64_t iterations)
+{
+    const char * fileNames[]     = { "debug", "info", "crit" };
+    const PriorityLevel levels[] = { PriorityLevel::Debug, PriorityLevel::Info, PriorityLevel::Critical };
+    LogStorageResources resources[3];
+    char paths[3][256];
+
+    for (size_t i = 0; i < ArraySize(resources); i++)
+    {
+        if (backend == Backend::kRam)
+        {
+            resources[i] = { gRamBuffers[i], kBufferSize, levels[i] };
+            continue;
+        }
+
+        snprintf(paths[i], sizeof(paths[i]), "%s/%s", directory, fileNames[i]);
+        unlink(paths[i]);
+        if (gStores[i].Open(paths[i], kBufferSize) != CHIP_NO_ERROR)
+        {
+            printf("Failed to open %s\n", paths[i]);
+            return Test::BenchmarkResult();
+        }
+        gStores[i].SetSyncOnCommit(backend == Backend::kMappedFileSync);
+        resources[i] = { gStores[i].GetBuffer(), gStores[i].GetBufferSize(), levels[i], &gStores[i] };
+    }
+
+    MonotonicallyIncreasingCounter<EventNumber> eventCounter;
+    eventCounter.Init(0);
+    EventManagement::GetInstance().Init(nullptr, ArraySize(resources), gCircularEventBuffer, resources, &eventCounter,
+                                        System::SystemClock().GetMonotonicMilliseconds64(), &gEventReporter);
+
+    BenchmarkEventGenerator generator;
+    EventOptions options;
+    options.mPath = ConcreteEventPath(1, 0x0006, 1);
+
+    auto result = Test::RunBenchmark(name, iterations, [&](uint64_t i) {
+        EventNumber eventNumber;
+        generator.mValue  = static_cast<uint32_t>(i);
+        options.mPriority = levels[i % ArraySize(levels)];
+        return EventManagement::GetInstance().LogEvent(&generator, options, eventNumber) == CHIP_NO_ERROR;
+    });
+
+    EventManagement::DestroyEventManagement();
+    if (backend != Backend::kRam)
+    {
+        for (size_t i = 0; i < ArraySize(gStores); i++)
+        {
+            gStores[i].Close();
+            unlink(paths[i]);
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+    const uint64_t iterations = (argc > 1) ? strtoull(argv[1], nullptr, 0) : kDefaultIterations;
+    const char * directory    = (argc > 2) ? argv[2] : "/tmp";
+
+    if (Platform::MemoryInit() != CHIP_NO_ERROR || DeviceLayer::PlatformMgr().InitChipStack() != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "Failed to initialize the CHIP stack\n");
+        return EXIT_FAILURE;
+    }
+
+    DeviceLayer::PlatformMgr().LockChipStack();
+    Test::PrintBenchmarkHeader();
+    Test::PrintBenchmarkResult(RunLoggingBenchmark("LogEvent/ram", Backend::kRam, directory, iterations));
+    Test::PrintBenchmarkResult(RunLoggingBenchmark("LogEvent/mapped-file", Backend::kMappedFile, directory, iterations));
+    // msync per commit is orders of magnitude slower, keep the run short.
+    const uint64_t syncIterations = std::max<uint64_t>(iterations / 100, 1);
+    Test::PrintBenchmarkResult(RunLoggingBenchmark("LogEvent/mapped-file+msync", Backend::kMappedFileSync, directory, syncIterations));
+    DeviceLayer::PlatformMgr().UnlockChipStack();
+
+    DeviceLayer::PlatformMgr().Shutdown();
+    Platform::MemoryShutdown();
+    return EXIT_SUCCESS;
+}
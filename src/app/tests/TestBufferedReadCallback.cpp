@@ -517,12 +517,16 @@ void DataSeriesGenerator::Generate()
 
 void RunAndValidateSequence(std::vector<ValidationInstruction> instructionList)
 {
-    DataSeriesValidator validator(instructionList);
-    BufferedReadCallback bufferedCallback(validator);
-    DataSeriesGenerator generator(bufferedCallback, instructionList);
-    generator.Generate();
+    // Reassembling lists into a contiguous buffer and streaming them must deliver the same data.
+    for (bool streamLists : { false, true })
+    {
+        DataSeriesValidator validator(instructionList);
+        BufferedReadCallback bufferedCallback(validator, streamLists);
+        DataSeriesGenerator generator(bufferedCallback, instructionList);
+        generator.Generate();
 
-    EXPECT_EQ(validator.mCurrentInstruction, instructionList.size());
+        EXPECT_EQ(validator.mCurrentInstruction, instructionList.size());
+    }
 }
 
 TEST_F(TestBufferedReadCallback, TestBufferedSequences)
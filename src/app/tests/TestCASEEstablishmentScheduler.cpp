@@ -0,0 +1,232 @@
+/*
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <vector>
+
+#include <app/CASEEstablishmentScheduler.h>
+#include <lib/core/StringBuilderAdapters.h>
+#include <system/SystemLayerImpl.h>
+#include <pw_unit_test/framework.h>
+
+namespace {
+
+using namespace chip;
+using Priority = CASEEstablishmentScheduler::Priority;
+
+// Holds on to the single dispatch timer the scheduler arms, so tests decide when a dispatch runs.
+class ManualTimerLayer : public System::LayerImpl
+{
+public:
+    CHIP_ERROR StartTimer(System::Clock::Timeout aDelay, System::TimerCompleteCallback aComplete, void * aAppState) override
+    {
+        mCallback = aComplete;
+        mAppState = aAppState;
+        return CHIP_NO_ERROR;
+    }
+
+    void CancelTimer(System::TimerCompleteCallback aOnComplete, void * aAppState) override
+    {
+        if (mCallback == aOnComplete && mAppState == aAppState)
+        {
+            mCallback = nullptr;
+        }
+    }
+
+    bool IsArmed() const { return mCallback != nullptr; }
+
+    void Fire()
+    {
+        ASSERT_TRUE(IsArmed());
+        auto callback = mCallback;
+        mCallback     = nullptr;
+        callback(this, mAppState);
+    }
+
+private:
+    System::TimerCompleteCallback mCallback = nullptr;
+    void * mAppState                        = nullptr;
+};
+
+class TestClient : public CASEEstablishmentScheduler::Client
+{
+public:
+    TestClient(std::vector<int> & grantLog, int id) : mGrantLog(grantLog), mId(id) {}
+
+    void OnEstablishmentSlotGranted() override { mGrantLog.push_back(mId); }
+    void OnEstablishmentSlotFailed(CHIP_ERROR error) override { mFailure = error; }
+
+    CHIP_ERROR mFailure = CHIP_NO_ERROR;
+
+private:
+    std::vector<int> & mGrantLog;
+    int mId;
+};
+
+CASEEstablishmentScheduler::Config MakeConfig(uint16_t maxConcurrent, uint16_t maxQueued, uint16_t batchSize)
+{
+    CASEEstablishmentScheduler::Config config;
+    config.maxConcurrent = maxConcurrent;
+    config.maxQueued     = maxQueued;
+    config.batchSize     = batchSize;
+    config.batchJitter   = System::Clock::kZero;
+    return config;
+}
+
+TEST(TestCASEEstablishmentScheduler, TestConcurrencyLimitAndBatching)
+{
+    ManualTimerLayer layer;
+    CASEEstablishmentScheduler scheduler(MakeConfig(/* maxConcurrent = */ 3, /* maxQueued = */ 16, /* batchSize = */ 2));
+    ASSERT_EQ(scheduler.Init(&layer), CHIP_NO_ERROR);
+
+    std::vector<int> grants;
+    TestClient a(grants, 0), b(grants, 1), c(grants, 2), d(grants, 3);
+    for (auto * client : { &a, &b, &c, &d })
+    {
+        EXPECT_EQ(scheduler.RequestSlot(*client, Priority::kNormal), CHIP_NO_ERROR);
+    }
+    EXPECT_TRUE(grants.empty());
+    EXPECT_EQ(scheduler.GetStats().queueDepth, 4u);
+
+    // First batch is capped by batchSize, second by maxConcurrent.
+    layer.Fire();
+    EXPECT_EQ(grants, (std::vector<int>{ 0, 1 }));
+    layer.Fire();
+    EXPECT_EQ(grants, (std::vector<int>{ 0, 1, 2 }));
+    EXPECT_FALSE(layer.IsArmed());
+    EXPECT_EQ(scheduler.GetStats().active, 3u);
+    EXPECT_EQ(scheduler.GetStats().queueDepth, 1u);
+
+    // Freeing a slot lets the last client through.
+    scheduler.OnSessionEstablished(b);
+    EXPECT_FALSE(b.HoldsEstablishmentSlot());
+    layer.Fire();
+    EXPECT_EQ(grants, (std::vector<int>{ 0, 1, 2, 3 }));
+    EXPECT_EQ(scheduler.GetStats().established, 1u);
+    EXPECT_EQ(scheduler.GetStats().started, 4u);
+
+    for (auto * client : { &a, &c, &d })
+    {
+        scheduler.ReleaseSlot(*client);
+    }
+    EXPECT_EQ(scheduler.GetStats().active, 0u);
+    EXPECT_FALSE(layer.IsArmed());
+}
+
+TEST(TestCASEEstablishmentScheduler, TestPriorityOrder)
+{
+    ManualTimerLayer layer;
+    CASEEstablishmentScheduler scheduler(MakeConfig(/* maxConcurrent = */ 8, /* maxQueued = */ 16, /* batchSize = */ 8));
+    ASSERT_EQ(scheduler.Init(&layer), CHIP_NO_ERROR);
+
+    std::vector<int> grants;
+    TestClient background(grants, 0), normal(grants, 1), interactive(grants, 2), promoted(grants, 3);
+    EXPECT_EQ(scheduler.RequestSlot(background, Priority::kBackground), CHIP_NO_ERROR);
+    EXPECT_EQ(scheduler.RequestSlot(promoted, Priority::kBackground), CHIP_NO_ERROR);
+    EXPECT_EQ(scheduler.RequestSlot(normal, Priority::kNormal), CHIP_NO_ERROR);
+    EXPECT_EQ(scheduler.RequestSlot(interactive, Priority::kInteractive), CHIP_NO_ERROR);
+
+    // Asking again with a more urgent class moves a queued client; a less urgent one is ignored.
+    EXPECT_EQ(scheduler.RequestSlot(promoted, Priority::kInteractive), CHIP_NO_ERROR);
+    EXPECT_EQ(scheduler.RequestSlot(interactive, Priority::kBackground), CHIP_NO_ERROR);
+    EXPECT_EQ(scheduler.GetStats().queueDepth, 4u);
+
+    layer.Fire();
+    EXPECT_EQ(grants, (std::vector<int>{ 2, 3, 1, 0 }));
+
+    for (auto * client : { &background, &normal, &interactive, &promoted })
+    {
+        scheduler.ReleaseSlot(*client);
+    }
+}
+
+TEST(TestCASEEstablishmentScheduler, TestBackPressureAndCancel)
+{
+    ManualTimerLayer layer;
+    CASEEstablishmentScheduler scheduler(MakeConfig(/* maxConcurrent = */ 1, /* maxQueued = */ 2, /* batchSize = */ 1));
+    ASSERT_EQ(scheduler.Init(&layer), CHIP_NO_ERROR);
+
+    std::vector<int> grants;
+    TestClient a(grants, 0), b(grants, 1), c(grants, 2);
+    EXPECT_EQ(scheduler.RequestSlot(a, Priority::kNormal), CHIP_NO_ERROR);
+    EXPECT_EQ(scheduler.RequestSlot(b, Priority::kNormal), CHIP_NO_ERROR);
+    EXPECT_EQ(scheduler.RequestSlot(c, Priority::kNormal), CHIP_ERROR_BUSY);
+    EXPECT_EQ(scheduler.GetStats().rejected, 1u);
+    EXPECT_EQ(scheduler.GetStats().peakQueueDepth, 2u);
+
+    // A cancelled client leaves the queue without ever being granted a slot.
+    scheduler.ReleaseSlot(a);
+    EXPECT_EQ(scheduler.GetStats().queueDepth, 1u);
+
+    layer.Fire();
+    EXPECT_EQ(grants, (std::vector<int>{ 1 }));
+    EXPECT_TRUE(b.HoldsEstablishmentSlot());
+
+    // Releasing twice is harmless.
+    scheduler.ReleaseSlot(b);
+    scheduler.ReleaseSlot(b);
+    EXPECT_EQ(scheduler.GetStats().active, 0u);
+    EXPECT_FALSE(layer.IsArmed());
+}
+
+TEST(TestCASEEstablishmentScheduler, TestShutdownForgetsClients)
+{
+    ManualTimerLayer layer;
+    CASEEstablishmentScheduler scheduler(MakeConfig(/* maxConcurrent = */ 1, /* maxQueued = */ 4, /* batchSize = */ 1));
+    ASSERT_EQ(scheduler.Init(&layer), CHIP_NO_ERROR);
+
+    std::vector<int> grants;
+    TestClient a(grants, 0), b(grants, 1);
+    EXPECT_EQ(scheduler.RequestSlot(a, Priority::kNormal), CHIP_NO_ERROR);
+    EXPECT_EQ(scheduler.RequestSlot(b, Priority::kNormal), CHIP_NO_ERROR);
+    layer.Fire();
+    EXPECT_TRUE(a.HoldsEstablishmentSlot());
+
+    scheduler.Shutdown();
+    EXPECT_FALSE(layer.IsArmed());
+    EXPECT_FALSE(a.HoldsEstablishmentSlot());
+    EXPECT_FALSE(b.IsInList());
+    EXPECT_EQ(scheduler.RequestSlot(a, Priority::kNormal), CHIP_ERROR_INCORRECT_STATE);
+
+    // Only the client that was still waiting is told it will not get a slot.
+    EXPECT_EQ(a.mFailure, CHIP_NO_ERROR);
+    EXPECT_EQ(b.mFailure, CHIP_ERROR_CANCELLED);
+    EXPECT_EQ(scheduler.GetStats().queueDepth, 0u);
+}
+
+TEST(TestCASEEstablishmentScheduler, TestShutdownFailsEveryQueuedClient)
+{
+    ManualTimerLayer layer;
+    CASEEstablishmentScheduler scheduler(MakeConfig(/* maxConcurrent = */ 1, /* maxQueued = */ 4, /* batchSize = */ 1));
+    ASSERT_EQ(scheduler.Init(&layer), CHIP_NO_ERROR);
+
+    std::vector<int> grants;
+    TestClient a(grants, 0), b(grants, 1), c(grants, 2);
+    EXPECT_EQ(scheduler.RequestSlot(a, Priority::kBackground), CHIP_NO_ERROR);
+    EXPECT_EQ(scheduler.RequestSlot(b, Priority::kNormal), CHIP_NO_ERROR);
+    EXPECT_EQ(scheduler.RequestSlot(c, Priority::kInteractive), CHIP_NO_ERROR);
+
+    scheduler.Shutdown();
+    EXPECT_TRUE(grants.empty());
+    for (TestClient * client : { &a, &b, &c })
+    {
+        EXPECT_EQ(client->mFailure, CHIP_ERROR_CANCELLED);
+        EXPECT_FALSE(client->IsInList());
+    }
+    EXPECT_EQ(scheduler.GetStats().queueDepth, 0u);
+}
+
+} // namespace
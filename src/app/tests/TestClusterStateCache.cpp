@@ -278,7 +278,8 @@ void DataSeriesGenerator::Generate(ForwardedDataCallbackValidator & dataCallback
     callback->OnReportEnd();
 }
 
-class CacheValidator : public ClusterStateCache::Callback
+template <typename CacheType>
+class CacheValidator : public CacheType::Callback
 {
 public:
     CacheValidator(AttributeInstructionListType & instructionList, ForwardedDataCallbackValidator & dataCallbackValidator);
@@ -309,7 +310,7 @@ private:
         }
     }
 
-    void DecodeAttribute(const AttributeInstruction & instruction, const ConcreteAttributePath & path, ClusterStateCache * cache)
+    void DecodeAttribute(const AttributeInstruction & instruction, const ConcreteAttributePath & path, CacheType * cache)
     {
         CHIP_ERROR err;
         bool gotStatus = false;
@@ -322,7 +323,7 @@ private:
             ChipLogProgress(DataManagement, "\t\t -- Validating A");
 
             Clusters::UnitTesting::Attributes::Int16u::TypeInfo::DecodableType v = 0;
-            err = cache->Get<Clusters::UnitTesting::Attributes::Int16u::TypeInfo>(path, v);
+            err = cache->template Get<Clusters::UnitTesting::Attributes::Int16u::TypeInfo>(path, v);
             if (err == CHIP_ERROR_IM_STATUS_CODE_RECEIVED)
             {
                 gotStatus = true;
@@ -341,7 +342,7 @@ private:
             ChipLogProgress(DataManagement, "\t\t -- Validating B");
 
             Clusters::UnitTesting::Attributes::OctetString::TypeInfo::DecodableType v;
-            err = cache->Get<Clusters::UnitTesting::Attributes::OctetString::TypeInfo>(path, v);
+            err = cache->template Get<Clusters::UnitTesting::Attributes::OctetString::TypeInfo>(path, v);
             if (err == CHIP_ERROR_IM_STATUS_CODE_RECEIVED)
             {
                 gotStatus = true;
@@ -360,7 +361,7 @@ private:
             ChipLogProgress(DataManagement, "\t\t -- Validating C");
 
             Clusters::UnitTesting::Attributes::StructAttr::TypeInfo::DecodableType v;
-            err = cache->Get<Clusters::UnitTesting::Attributes::StructAttr::TypeInfo>(path, v);
+            err = cache->template Get<Clusters::UnitTesting::Attributes::StructAttr::TypeInfo>(path, v);
             if (err == CHIP_ERROR_IM_STATUS_CODE_RECEIVED)
             {
                 gotStatus = true;
@@ -379,7 +380,7 @@ private:
             ChipLogProgress(DataManagement, "\t\t -- Validating D");
 
             Clusters::UnitTesting::Attributes::ListStructOctetString::TypeInfo::DecodableType v;
-            err = cache->Get<Clusters::UnitTesting::Attributes::ListStructOctetString::TypeInfo>(path, v);
+            err = cache->template Get<Clusters::UnitTesting::Attributes::ListStructOctetString::TypeInfo>(path, v);
             if (err == CHIP_ERROR_IM_STATUS_CODE_RECEIVED)
             {
                 gotStatus = true;
@@ -410,9 +411,9 @@ private:
     }
 
     void DecodeClusterObject(const AttributeInstruction & instruction, const ConcreteAttributePath & path,
-                             ClusterStateCache * cache)
+                             CacheType * cache)
     {
-        std::list<ClusterStateCache::AttributeStatus> statusList;
+        std::list<typename CacheType::AttributeStatus> statusList;
         EXPECT_EQ(cache->Get(path.mEndpointId, path.mClusterId, clusterValue, statusList), CHIP_NO_ERROR);
 
         if (instruction.mValueType == AttributeInstruction::kData)
@@ -462,7 +463,7 @@ private:
         }
     }
 
-    void OnAttributeChanged(ClusterStateCache * cache, const ConcreteAttributePath & path) override
+    void OnAttributeChanged(CacheType * cache, const ConcreteAttributePath & path) override
     {
         StatusIB status;
 
@@ -490,14 +491,14 @@ private:
         }
     }
 
-    void OnClusterChanged(ClusterStateCache * cache, EndpointId endpointId, ClusterId clusterId) override
+    void OnClusterChanged(CacheType * cache, EndpointId endpointId, ClusterId clusterId) override
     {
         auto iter = mExpectedClusters.find(std::make_tuple(endpointId, clusterId));
         ASSERT_NE(iter, mExpectedClusters.end());
         mExpectedClusters.erase(iter);
     }
 
-    void OnEndpointAdded(ClusterStateCache * cache, EndpointId endpointId) override
+    void OnEndpointAdded(CacheType * cache, EndpointId endpointId) override
     {
         auto iter = mExpectedEndpoints.find(endpointId);
         ASSERT_NE(iter, mExpectedEndpoints.end());
@@ -523,8 +524,9 @@ private:
     ForwardedDataCallbackValidator & mDataCallbackValidator;
 };
 
-CacheValidator::CacheValidator(AttributeInstructionListType & instructionList,
-                               ForwardedDataCallbackValidator & dataCallbackValidator) :
+template <typename CacheType>
+CacheValidator<CacheType>::CacheValidator(AttributeInstructionListType & instructionList,
+                                          ForwardedDataCallbackValidator & dataCallbackValidator) :
     mDataCallbackValidator(dataCallbackValidator)
 {
     for (auto & instruction : instructionList)
@@ -542,11 +544,12 @@ CacheValidator::CacheValidator(AttributeInstructionListType & instructionList,
     }
 }
 
+template <typename CacheType>
 void RunAndValidateSequence(AttributeInstructionListType list)
 {
     ForwardedDataCallbackValidator dataCallbackValidator;
-    CacheValidator client(list, dataCallbackValidator);
-    ClusterStateCache cache(client);
+    CacheValidator<CacheType> client(list, dataCallbackValidator);
+    CacheType cache(client);
 
     // In order for the cache to track our data versions, we need to claim to it
     // that we are dealing with a wildcard path.  And we need to do that before
@@ -712,7 +715,8 @@ void RunAndValidateSequence(AttributeInstructionListType list)
  * E1:A1 --- Endpoint 1, Attribute A, Version 1
  *
  */
-TEST_F(TestClusterStateCache, TestCache)
+template <typename CacheType>
+void RunAndValidateSequences()
 {
     ChipLogProgress(DataManagement, "Validating various sequences of attribute data IBs...");
 
@@ -720,55 +724,346 @@ TEST_F(TestClusterStateCache, TestCache)
     // Validate a range of types and ensure that they can be successfully decoded.
     //
     ChipLogProgress(DataManagement, "E1:A1 --> E1:A1");
-    RunAndValidateSequence({ AttributeInstruction(
+    RunAndValidateSequence<CacheType>({ AttributeInstruction(
 
         AttributeInstruction::kAttributeA, 1, AttributeInstruction::kData) });
 
     ChipLogProgress(DataManagement, "E1:B1 --> E1:B1");
-    RunAndValidateSequence({ AttributeInstruction(
+    RunAndValidateSequence<CacheType>({ AttributeInstruction(
 
         AttributeInstruction::kAttributeB, 1, AttributeInstruction::kData) });
 
     ChipLogProgress(DataManagement, "E1:C1 --> E1:C1");
-    RunAndValidateSequence({ AttributeInstruction(AttributeInstruction::kAttributeC, 1, AttributeInstruction::kData) });
+    RunAndValidateSequence<CacheType>({ AttributeInstruction(AttributeInstruction::kAttributeC, 1, AttributeInstruction::kData) });
 
     ChipLogProgress(DataManagement, "E1:D1 --> E1:D1");
-    RunAndValidateSequence({ AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData) });
+    RunAndValidateSequence<CacheType>({ AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData) });
 
     //
     // Validate that a newer version of a data item over-rides the
     // previous copy.
     //
     ChipLogProgress(DataManagement, "E1:D1 E1:D2 --> E1:D2");
-    RunAndValidateSequence({ AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData),
+    RunAndValidateSequence<CacheType>({ AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData),
                              AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData) });
 
     //
     // Validate that a newer StatusIB over-rides a previous data value.
     //
     ChipLogProgress(DataManagement, "E1:D1 E1:D2s --> E1:D2s");
-    RunAndValidateSequence({ AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData),
+    RunAndValidateSequence<CacheType>({ AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData),
                              AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kStatus) });
 
     //
     // Validate that a newer data value over-rides a previous status value.
     //
     ChipLogProgress(DataManagement, "E1:D1s E1:D2 --> E1:D2");
-    RunAndValidateSequence({ AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kStatus),
+    RunAndValidateSequence<CacheType>({ AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kStatus),
                              AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData) });
 
     //
     // Validate data across different endpoints.
     //
     ChipLogProgress(DataManagement, "E0:D1 E1:D2 --> E0:D1 E1:D2");
-    RunAndValidateSequence({ AttributeInstruction(AttributeInstruction::kAttributeD, 0, AttributeInstruction::kData),
+    RunAndValidateSequence<CacheType>({ AttributeInstruction(AttributeInstruction::kAttributeD, 0, AttributeInstruction::kData),
                              AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData) });
 
     ChipLogProgress(DataManagement, "E0:A1 E0:B2 E0:A3 E0:B4 --> E0:A3 E0:B4");
-    RunAndValidateSequence({ AttributeInstruction(AttributeInstruction::kAttributeA, 0, AttributeInstruction::kData),
+    RunAndValidateSequence<CacheType>({ AttributeInstruction(AttributeInstruction::kAttributeA, 0, AttributeInstruction::kData),
                              AttributeInstruction(AttributeInstruction::kAttributeB, 0, AttributeInstruction::kData),
                              AttributeInstruction(AttributeInstruction::kAttributeA, 0, AttributeInstruction::kData),
                              AttributeInstruction(AttributeInstruction::kAttributeB, 0, AttributeInstruction::kData) });
 }
 
+TEST_F(TestClusterStateCache, TestCache)
+{
+    RunAndValidateSequences<ClusterStateCache>();
+}
+
+TEST_F(TestClusterStateCache, TestFlatStorageCache)
+{
+    RunAndValidateSequences<ClusterStateCacheFlat>();
+}
+
+CHIP_ERROR StoreUint32(ClusterStateCacheFlatStorage & storage, const ConcreteAttributePath & path, uint32_t value)
+{
+    uint8_t buf[16];
+    TLV::TLVWriter writer;
+    writer.Init(buf);
+    ReturnErrorOnFailure(writer.Put(TLV::AnonymousTag(), value));
+
+    TLV::TLVReader reader;
+    reader.Init(buf, writer.GetLengthWritten());
+    ReturnErrorOnFailure(reader.Next());
+    return storage.SetAttributeData(path, reader, writer.GetLengthWritten());
+}
+
+TEST_F(TestClusterStateCache, TestFlatStorage)
+{
+    ClusterStateCacheFlatStorage storage;
+
+    // Insert out of path order; iteration must still be ordered.
+    EXPECT_EQ(StoreUint32(storage, ConcreteAttributePath(2, 6, 0), 20), CHIP_NO_ERROR);
+    EXPECT_EQ(StoreUint32(storage, ConcreteAttributePath(1, 6, 5), 15), CHIP_NO_ERROR);
+    EXPECT_EQ(StoreUint32(storage, ConcreteAttributePath(1, 6, 1), 11), CHIP_NO_ERROR);
+    EXPECT_EQ(storage.SetAttributeStatus(ConcreteAttributePath(1, 8, 0), StatusIB(Protocols::InteractionModel::Status::Failure)),
+              CHIP_NO_ERROR);
+
+    std::vector<AttributeId> attributes;
+    EXPECT_EQ(storage.ForEachAttribute(1, 6,
+                                       [&attributes](AttributeId attributeId, const auto &) {
+                                           attributes.push_back(attributeId);
+                                           return CHIP_NO_ERROR;
+                                       }),
+              CHIP_NO_ERROR);
+    EXPECT_EQ(attributes, (std::vector<AttributeId>{ 1, 5 }));
+    EXPECT_EQ(storage.ForEachAttribute(1, 7, [](AttributeId, const auto &) { return CHIP_NO_ERROR; }), CHIP_ERROR_KEY_NOT_FOUND);
+
+    std::vector<ClusterId> clusters;
+    EXPECT_EQ(storage.ForEachClusterOnEndpoint(1,
+                                               [&clusters](ClusterId clusterId) {
+                                                   clusters.push_back(clusterId);
+                                                   return CHIP_NO_ERROR;
+                                               }),
+              CHIP_NO_ERROR);
+    EXPECT_EQ(clusters, (std::vector<ClusterId>{ 6, 8 }));
+
+    auto state = storage.FindAttribute(ConcreteAttributePath(1, 6, 5));
+    ASSERT_NE(state, nullptr);
+    ASSERT_TRUE(state->HasData());
+    TLV::TLVReader reader;
+    reader.Init(state->GetData());
+    EXPECT_EQ(reader.Next(), CHIP_NO_ERROR);
+    uint32_t value = 0;
+    EXPECT_EQ(reader.Get(value), CHIP_NO_ERROR);
+    EXPECT_EQ(value, 15u);
+
+    state = storage.FindAttribute(ConcreteAttributePath(1, 8, 0));
+    ASSERT_NE(state, nullptr);
+    EXPECT_TRUE(state->IsStatus());
+
+    // An update goes to a new slot and releases the old one, which the next update then reuses.
+    const uint8_t * slot = storage.FindAttribute(ConcreteAttributePath(1, 6, 1))->GetData().data();
+    EXPECT_EQ(StoreUint32(storage, ConcreteAttributePath(1, 6, 1), 12), CHIP_NO_ERROR);
+    EXPECT_NE(storage.FindAttribute(ConcreteAttributePath(1, 6, 1))->GetData().data(), slot);
+    EXPECT_EQ(StoreUint32(storage, ConcreteAttributePath(1, 6, 1), 13), CHIP_NO_ERROR);
+    EXPECT_EQ(storage.FindAttribute(ConcreteAttributePath(1, 6, 1))->GetData().data(), slot);
+
+    storage.ClearCluster(ConcreteClusterPath(1, 6));
+    EXPECT_EQ(storage.FindAttribute(ConcreteAttributePath(1, 6, 5)), nullptr);
+    EXPECT_EQ(storage.FindCluster(1, 6), nullptr);
+    EXPECT_NE(storage.FindCluster(1, 8), nullptr);
+
+    storage.ClearEndpoint(1);
+    EXPECT_FALSE(storage.HasEndpoint(1));
+    EXPECT_TRUE(storage.HasEndpoint(2));
+
+    storage.ClearAttribute(ConcreteAttributePath(2, 6, 0));
+    EXPECT_EQ(storage.FindAttribute(ConcreteAttributePath(2, 6, 0)), nullptr);
+    EXPECT_NE(storage.FindCluster(2, 6), nullptr);
+}
+
+CHIP_ERROR StoreBytes(ClusterStateCacheFlatStorage & storage, const ConcreteAttributePath & path, size_t length,
+                      uint32_t sizeLimit = UINT32_MAX)
+{
+    uint8_t value[64] = {};
+    uint8_t buf[80];
+    TLV::TLVWriter writer;
+    writer.Init(buf);
+    ReturnErrorOnFailure(writer.PutBytes(TLV::AnonymousTag(), value, static_cast<uint32_t>(length)));
+
+    TLV::TLVReader reader;
+    reader.Init(buf, writer.GetLengthWritten());
+    ReturnErrorOnFailure(reader.Next());
+    return storage.SetAttributeData(path, reader, std::min(writer.GetLengthWritten(), sizeLimit));
+}
+
+TEST_F(TestClusterStateCache, TestFlatStorageFailedUpdate)
+{
+    ClusterStateCacheFlatStorage storage;
+    const ConcreteAttributePath path(1, 6, 0);
+
+    EXPECT_EQ(StoreUint32(storage, path, 42), CHIP_NO_ERROR);
+
+    // The new value does not fit the size it claims, so the copy fails and the old value must survive.
+    EXPECT_NE(StoreBytes(storage, path, 32, 8), CHIP_NO_ERROR);
+
+    auto state = storage.FindAttribute(path);
+    ASSERT_NE(state, nullptr);
+    ASSERT_TRUE(state->HasData());
+    TLV::TLVReader reader;
+    reader.Init(state->GetData());
+    EXPECT_EQ(reader.Next(), CHIP_NO_ERROR);
+    uint32_t value = 0;
+    EXPECT_EQ(reader.Get(value), CHIP_NO_ERROR);
+    EXPECT_EQ(value, 42u);
+
+    // A failed first store does not create the attribute, or its cluster.
+    EXPECT_NE(StoreBytes(storage, ConcreteAttributePath(1, 7, 0), 32, 8), CHIP_NO_ERROR);
+    EXPECT_EQ(storage.FindAttribute(ConcreteAttributePath(1, 7, 0)), nullptr);
+    EXPECT_EQ(storage.FindCluster(1, 7), nullptr);
+}
+
+TEST_F(TestClusterStateCache, TestFlatStorageChurn)
+{
+    ClusterStateCacheFlatStorage storage;
+
+    // Keep resizing a handful of attributes; released slots must be reused rather than the arena growing with every update.
+    for (size_t round = 0; round < 200; round++)
+    {
+        for (AttributeId attributeId = 0; attributeId < 16; attributeId++)
+        {
+            ASSERT_EQ(StoreBytes(storage, ConcreteAttributePath(1, 6, attributeId), (round * 7 + attributeId) % 64), CHIP_NO_ERROR);
+        }
+    }
+    EXPECT_LE(storage.GetArenaBytes(), 4 * ClusterStateCacheFlatStorage::kArenaBlockSize);
+
+    // Values too large to pack are allocated on their own and given back as soon as they are replaced.
+    std::vector<uint8_t> large(ClusterStateCacheFlatStorage::kMaxPackedSize + 100);
+    uint8_t buf[ClusterStateCacheFlatStorage::kMaxPackedSize + 200];
+    TLV::TLVWriter writer;
+    writer.Init(buf);
+    ASSERT_EQ(writer.PutBytes(TLV::AnonymousTag(), large.data(), static_cast<uint32_t>(large.size())), CHIP_NO_ERROR);
+    TLV::TLVReader reader;
+    reader.Init(buf, writer.GetLengthWritten());
+    ASSERT_EQ(reader.Next(), CHIP_NO_ERROR);
+
+    const size_t packedBytes = storage.GetArenaBytes();
+    ASSERT_EQ(storage.SetAttributeData(ConcreteAttributePath(2, 6, 0), reader, writer.GetLengthWritten()), CHIP_NO_ERROR);
+    EXPECT_EQ(storage.GetArenaBytes(), packedBytes + writer.GetLengthWritten());
+    EXPECT_EQ(StoreUint32(storage, ConcreteAttributePath(2, 6, 0), 1), CHIP_NO_ERROR);
+    EXPECT_EQ(storage.GetArenaBytes(), packedBytes);
+
+    // Once nothing is stored any more, the shared blocks are released too.
+    storage.ClearEndpoint(1);
+    storage.ClearEndpoint(2);
+    EXPECT_EQ(storage.GetArenaBytes(), 0u);
+}
+
+template <typename CacheType>
+class NullCacheCallback : public CacheType::Callback
+{
+    void OnDone(ReadClient *) override {}
+};
+
+// Reports one attribute holding a byte string of valueSize bytes, which is what sizes the cluster.
+void ReportCluster(ReadClient::Callback & callback, const ConcreteClusterPath & cluster, size_t valueSize, DataVersion version)
+{
+    uint8_t value[64] = {};
+    uint8_t buf[80];
+    TLV::TLVWriter writer;
+    writer.Init(buf);
+    ASSERT_EQ(writer.PutBytes(TLV::AnonymousTag(), value, static_cast<uint32_t>(valueSize)), CHIP_NO_ERROR);
+
+    TLV::TLVReader reader;
+    reader.Init(buf, writer.GetLengthWritten());
+    ASSERT_EQ(reader.Next(), CHIP_NO_ERROR);
+
+    callback.OnReportBegin();
+    callback.OnAttributeData(ConcreteDataAttributePath(cluster.mEndpointId, cluster.mClusterId, 0, MakeOptional(version)), &reader,
+                             StatusIB());
+    callback.OnReportEnd();
+}
+
+// Encodes the cache's data version filters for a wildcard subscription into bufferSize bytes and decodes them.
+std::vector<DataVersionFilter> EncodeFilters(ReadClient::Callback & callback, size_t bufferSize)
+{
+    std::vector<DataVersionFilter> filters;
+    AttributePathParams wildcardPath;
+    const Span<AttributePathParams> pathSpan(&wildcardPath, 1);
+
+    uint8_t buf[256];
+    TLV::TLVWriter writer;
+    writer.Init(buf, std::min(bufferSize, sizeof(buf)));
+    // Keep room to close the list.
+    writer.ReserveBuffer(1);
+
+    DataVersionFilterIBs::Builder builder;
+    bool encodedDataVersionList = false;
+    EXPECT_EQ(builder.Init(&writer), CHIP_NO_ERROR);
+    EXPECT_EQ(callback.OnUpdateDataVersionFilterList(builder, pathSpan, encodedDataVersionList), CHIP_NO_ERROR);
+    EXPECT_EQ(writer.UnreserveBuffer(1), CHIP_NO_ERROR);
+    EXPECT_EQ(builder.EndOfDataVersionFilterIBs(), CHIP_NO_ERROR);
+
+    TLV::TLVReader reader;
+    TLV::TLVType listType;
+    reader.Init(buf, writer.GetLengthWritten());
+    EXPECT_EQ(reader.Next(), CHIP_NO_ERROR);
+    EXPECT_EQ(reader.EnterContainer(listType), CHIP_NO_ERROR);
+    while (reader.Next() == CHIP_NO_ERROR)
+    {
+        DataVersionFilterIB::Parser filterParser;
+        ClusterPathIB::Parser pathParser;
+        DataVersionFilter filter;
+        DataVersion version = 0;
+
+        EXPECT_EQ(filterParser.Init(reader), CHIP_NO_ERROR);
+        EXPECT_EQ(filterParser.GetPath(&pathParser), CHIP_NO_ERROR);
+        EXPECT_EQ(pathParser.GetEndpoint(&filter.mEndpointId), CHIP_NO_ERROR);
+        EXPECT_EQ(pathParser.GetCluster(&filter.mClusterId), CHIP_NO_ERROR);
+        EXPECT_EQ(filterParser.GetDataVersion(&version), CHIP_NO_ERROR);
+        filter.mDataVersion.SetValue(version);
+        filters.push_back(filter);
+    }
+    EXPECT_EQ(encodedDataVersionList, !filters.empty());
+
+    return filters;
+}
+
+bool IsFilter(const DataVersionFilter & filter, EndpointId endpointId, ClusterId clusterId, DataVersion version)
+{
+    return filter.mEndpointId == endpointId && filter.mClusterId == clusterId && filter.mDataVersion.ValueOr(0) == version;
+}
+
+template <typename CacheType>
+void RunDataVersionFilterOrder()
+{
+    NullCacheCallback<CacheType> callback;
+    CacheType cache(callback);
+    ReadClient::Callback & bufferedCallback = cache.GetBufferedCallback();
+
+    // Tell the cache about the wildcard path before any report, so it tracks data versions.
+    EXPECT_TRUE(EncodeFilters(bufferedCallback, 256).empty());
+
+    ReportCluster(bufferedCallback, ConcreteClusterPath(1, 6), 8, 100);
+    ReportCluster(bufferedCallback, ConcreteClusterPath(1, 8), 40, 200);
+    ReportCluster(bufferedCallback, ConcreteClusterPath(2, 6), 20, 300);
+
+    // Largest cluster first.
+    auto filters = EncodeFilters(bufferedCallback, 256);
+    ASSERT_EQ(filters.size(), 3u);
+    EXPECT_TRUE(IsFilter(filters[0], 1, 8, 200));
+    EXPECT_TRUE(IsFilter(filters[1], 2, 6, 300));
+    EXPECT_TRUE(IsFilter(filters[2], 1, 6, 100));
+
+    // With room for just one filter, the largest cluster gets it.
+    filters = EncodeFilters(bufferedCallback, 30);
+    ASSERT_EQ(filters.size(), 1u);
+    EXPECT_TRUE(IsFilter(filters[0], 1, 8, 200));
+
+    // A new report moves a cluster and bumps its version.
+    ReportCluster(bufferedCallback, ConcreteClusterPath(1, 6), 60, 101);
+    filters = EncodeFilters(bufferedCallback, 256);
+    ASSERT_EQ(filters.size(), 3u);
+    EXPECT_TRUE(IsFilter(filters[0], 1, 6, 101));
+    EXPECT_TRUE(IsFilter(filters[1], 1, 8, 200));
+    EXPECT_TRUE(IsFilter(filters[2], 2, 6, 300));
+
+    // Clusters without data do not get filters.
+    cache.ClearAttribute(ConcreteAttributePath(1, 6, 0));
+    cache.ClearAttributes(ConcreteClusterPath(1, 8));
+    filters = EncodeFilters(bufferedCallback, 256);
+    ASSERT_EQ(filters.size(), 1u);
+    EXPECT_TRUE(IsFilter(filters[0], 2, 6, 300));
+
+    cache.ClearAttributes(EndpointId(2));
+    EXPECT_TRUE(EncodeFilters(bufferedCallback, 256).empty());
+}
+
+TEST_F(TestClusterStateCache, TestDataVersionFilterOrder)
+{
+    RunDataVersionFilterOrder<ClusterStateCache>();
+    RunDataVersionFilterOrder<ClusterStateCacheFlat>();
+}
+
 } // namespace
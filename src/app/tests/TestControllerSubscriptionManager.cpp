@@ -0,0 +1,404 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <vector>
+
+#include <app/CASEClientPool.h>
+#include <app/CASESessionManager.h>
+#include <app/ControllerSubscriptionManager.h>
+#include <app/InteractionModelEngine.h>
+#include <app/OperationalSessionSetupPool.h>
+#include <app/reporting/tests/MockReportScheduler.h>
+#include <app/tests/AppTestContext.h>
+#include <credentials/GroupDataProviderImpl.h>
+#include <lib/core/StringBuilderAdapters.h>
+#include <lib/core/TLV.h>
+#include <lib/dnssd/Resolver.h>
+#include <lib/support/TestPersistentStorageDelegate.h>
+#include <system/SystemClock.h>
+
+#include <pw_unit_test/framework.h>
+
+using namespace chip::System::Clock::Literals;
+
+namespace chip {
+namespace app {
+
+namespace {
+
+using Manager           = ControllerSubscriptionManager;
+using SubscriptionState = Manager::SubscriptionState;
+
+constexpr size_t kMemoryBudget = 4096;
+
+const ScopedNodeId kNode(0x1001, 1);
+
+System::Clock::Internal::MockClock gMockClock;
+System::Clock::ClockBase * gRealClock;
+
+// Takes every operational lookup and never answers it, so CASE to the subscribed nodes stays pending and the tests
+// play the part of the ReadClient.
+class PendingOperationalResolver : public Dnssd::Resolver
+{
+public:
+    CHIP_ERROR Init(Inet::EndPointManager<Inet::UDPEndPoint> * udpEndPointManager) override { return CHIP_NO_ERROR; }
+    bool IsInitialized() override { return true; }
+    void Shutdown() override {}
+    void SetOperationalDelegate(Dnssd::OperationalResolveDelegate * delegate) override {}
+    CHIP_ERROR ResolveNodeId(const PeerId & peerId) override { return CHIP_NO_ERROR; }
+    void NodeIdResolutionNoLongerNeeded(const PeerId & peerId) override {}
+    CHIP_ERROR StartDiscovery(Dnssd::DiscoveryType type, Dnssd::DiscoveryFilter filter, Dnssd::DiscoveryContext &) override
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+    CHIP_ERROR StopDiscovery(Dnssd::DiscoveryContext &) override { return CHIP_ERROR_NOT_IMPLEMENTED; }
+    CHIP_ERROR ReconfirmRecord(const char * hostname, Inet::IPAddress address, Inet::InterfaceId interfaceId) override
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+};
+
+class RecordingDelegate : public Manager::Delegate
+{
+public:
+    void OnSubscriptionStateChanged(const ScopedNodeId & node, SubscriptionState state) override
+    {
+        mStateChanges.push_back(state);
+    }
+    void OnNodeUpdated(const ScopedNodeId & node) override { mUpdated.push_back(node); }
+    void OnNodeEvicted(const ScopedNodeId & node) override { mEvicted.push_back(node); }
+
+    std::vector<SubscriptionState> mStateChanges;
+    std::vector<ScopedNodeId> mUpdated;
+    std::vector<ScopedNodeId> mEvicted;
+};
+
+void ReportValue(ReadClient::Callback & callback, const ConcreteDataAttributePath & path, uint32_t value)
+{
+    uint8_t buf[16];
+    TLV::TLVWriter writer;
+    writer.Init(buf);
+    ASSERT_EQ(writer.Put(TLV::AnonymousTag(), value), CHIP_NO_ERROR);
+    ASSERT_EQ(writer.Finalize(), CHIP_NO_ERROR);
+
+    TLV::TLVReader reader;
+    reader.Init(buf, writer.GetLengthWritten());
+    ASSERT_EQ(reader.Next(), CHIP_NO_ERROR);
+    callback.OnAttributeData(path, &reader, StatusIB());
+}
+
+// Delivers a report of a single attribute, the way a ReadClient does.
+void ReportAttribute(ReadClient::Callback & callback, uint32_t value)
+{
+    callback.OnReportBegin();
+    ReportValue(callback, ConcreteDataAttributePath(1, 6, 0), value);
+    callback.OnReportEnd();
+}
+
+} // namespace
+
+class TestControllerSubscriptionManager : public Test::AppContext
+{
+public:
+    static void SetUpTestSuite()
+    {
+        AppContext::SetUpTestSuite();
+
+        gRealClock = &System::SystemClock();
+        System::Clock::Internal::SetSystemClockForTesting(&gMockClock);
+    }
+
+    static void TearDownTestSuite()
+    {
+        System::Clock::Internal::SetSystemClockForTesting(gRealClock);
+        AppContext::TearDownTestSuite();
+    }
+
+    void SetUp() override
+    {
+        gMockClock.SetMonotonic(100000_ms64);
+
+        AppContext::SetUp();
+        VerifyOrReturn(!HasFailure());
+
+        // Must be in place before the session manager initializes the address resolver, which registers itself with it.
+        Dnssd::Resolver::SetInstance(mResolver);
+
+        mGroupDataProvider.SetStorageDelegate(&mStorage);
+        mGroupDataProvider.SetSessionKeystore(&GetSessionKeystore());
+        ASSERT_EQ(mGroupDataProvider.Init(), CHIP_NO_ERROR);
+
+        CASESessionManagerConfig config;
+        config.sessionInitParams.sessionManager    = &GetSecureSessionManager();
+        config.sessionInitParams.exchangeMgr       = &GetExchangeManager();
+        config.sessionInitParams.fabricTable       = &GetFabricTable();
+        config.sessionInitParams.groupDataProvider = &mGroupDataProvider;
+        config.clientPool                          = &mClientPool;
+        config.sessionSetupPool                    = &mSetupPool;
+        ASSERT_EQ(mCASESessionManager.Init(&GetSystemLayer(), config), CHIP_NO_ERROR);
+
+        // Subscriptions by node establish their own sessions, so the engine needs a CASESessionManager.
+        ASSERT_EQ(InteractionModelEngine::GetInstance()->Init(&GetExchangeManager(), &GetFabricTable(),
+                                                              reporting::GetDefaultReportScheduler(), &mCASESessionManager),
+                  CHIP_NO_ERROR);
+    }
+
+    void TearDown() override
+    {
+        mCASESessionManager.ReleaseAllSessions();
+        mCASESessionManager.Shutdown();
+        GetExchangeManager().GetReliableMessageMgr()->RegisterSessionUpdateDelegate(nullptr);
+        mGroupDataProvider.Finish();
+        Dnssd::Resolver::SetInstance(Dnssd::GetDefaultResolver());
+        AppContext::TearDown();
+    }
+
+protected:
+    static Manager::Config MakeConfig(uint16_t maxPerWindow)
+    {
+        Manager::Config config;
+        config.resubscribeWindow        = 1000_ms32;
+        config.maxResubscribesPerWindow = maxPerWindow;
+        return config;
+    }
+
+    ScopedNodeId ToScopedNodeId(NodeId nodeId) { return ScopedNodeId(nodeId, GetBobFabricIndex()); }
+
+    static CHIP_ERROR Subscribe(Manager & manager, const ScopedNodeId & node)
+    {
+        const AttributePathParams path(1, 6, 0);
+        return manager.Subscribe(node, Span<const AttributePathParams>(&path, 1), Span<const EventPathParams>(), 0, 60);
+    }
+
+    // The callback a node's ReadClient reports to, i.e. the front of its NodeFeed.
+    static ReadClient::Callback & GetReadClientCallback(Manager & manager, const ScopedNodeId & node)
+    {
+        return (*manager.FindNode(node))->mFeed->GetBufferedCallback();
+    }
+
+    static ReadClient * GetReadClient(Manager & manager, const ScopedNodeId & node)
+    {
+        return (*manager.FindNode(node))->mReadClient.get();
+    }
+
+    static Manager::NodeStatus GetStatus(const Manager & manager, const ScopedNodeId & node)
+    {
+        Manager::NodeStatus status;
+        EXPECT_EQ(manager.GetNodeStatus(node, status), CHIP_NO_ERROR);
+        return status;
+    }
+
+    PendingOperationalResolver mResolver;
+    TestPersistentStorageDelegate mStorage;
+    Credentials::GroupDataProviderImpl mGroupDataProvider;
+    CASEClientPool<4> mClientPool;
+    OperationalSessionSetupPool<4> mSetupPool;
+    CASESessionManager mCASESessionManager;
+};
+
+TEST_F(TestControllerSubscriptionManager, TestSpreadsResubscribeStorm)
+{
+    Manager manager(kMemoryBudget, MakeConfig(4));
+
+    // Ten subscriptions drop at once and all want to resubscribe right away.
+    uint32_t perWindow[3] = {};
+    for (int i = 0; i < 10; ++i)
+    {
+        System::Clock::Milliseconds32 delay = manager.ReserveResubscribeSlot(0_ms32);
+        ASSERT_LT(delay.count(), 3000u);
+        perWindow[delay.count() / 1000]++;
+    }
+
+    EXPECT_EQ(perWindow[0], 4u);
+    EXPECT_EQ(perWindow[1], 4u);
+    EXPECT_EQ(perWindow[2], 2u);
+
+    const Manager::Stats & stats = manager.GetStats();
+    EXPECT_EQ(stats.resubscribesScheduled, 10u);
+    EXPECT_EQ(stats.resubscribesDeferred, 6u);
+    EXPECT_GE(stats.maxDeferral.count(), 2000u);
+}
+
+TEST_F(TestControllerSubscriptionManager, TestNeverShortensBackoff)
+{
+    Manager manager(kMemoryBudget, MakeConfig(1));
+
+    // An attempt with a long backoff does not take room from earlier windows.
+    EXPECT_EQ(manager.ReserveResubscribeSlot(5500_ms32), 5500_ms32);
+    EXPECT_EQ(manager.ReserveResubscribeSlot(200_ms32), 200_ms32);
+
+    // The window of the first attempt is full, so this one moves to the next window.
+    System::Clock::Milliseconds32 delay = manager.ReserveResubscribeSlot(5100_ms32);
+    EXPECT_GE(delay.count(), 6000u);
+    EXPECT_LT(delay.count(), 7000u);
+    EXPECT_EQ(manager.GetStats().resubscribesDeferred, 1u);
+}
+
+TEST_F(TestControllerSubscriptionManager, TestWindowsFreeUpOverTime)
+{
+    Manager manager(kMemoryBudget, MakeConfig(1));
+
+    EXPECT_EQ(manager.ReserveResubscribeSlot(0_ms32), 0_ms32);
+    EXPECT_GE(manager.ReserveResubscribeSlot(0_ms32).count(), 1000u);
+
+    // Once time has moved past the windows in use, attempts are placed as requested again.
+    gMockClock.AdvanceMonotonic(10000_ms64);
+    EXPECT_EQ(manager.ReserveResubscribeSlot(0_ms32), 0_ms32);
+}
+
+TEST_F(TestControllerSubscriptionManager, TestRequiresInit)
+{
+    Manager manager(kMemoryBudget);
+    const AttributePathParams path(1, 6, 0);
+
+    EXPECT_EQ(manager.Subscribe(kNode, Span<const AttributePathParams>(&path, 1), Span<const EventPathParams>(), 0, 60),
+              CHIP_ERROR_INCORRECT_STATE);
+    EXPECT_EQ(manager.Init(nullptr), CHIP_ERROR_INVALID_ARGUMENT);
+
+    ASSERT_EQ(manager.Init(InteractionModelEngine::GetInstance()), CHIP_NO_ERROR);
+    EXPECT_EQ(manager.Init(InteractionModelEngine::GetInstance()), CHIP_ERROR_INCORRECT_STATE);
+
+    // Neither an undefined fabric nor an empty set of paths can be subscribed to.
+    EXPECT_EQ(manager.Subscribe(ScopedNodeId(0x1001, kUndefinedFabricIndex), Span<const AttributePathParams>(&path, 1),
+                                Span<const EventPathParams>(), 0, 60),
+              CHIP_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(manager.Subscribe(kNode, Span<const AttributePathParams>(), Span<const EventPathParams>(), 0, 60),
+              CHIP_ERROR_INVALID_ARGUMENT);
+
+    Manager::NodeStatus status;
+    EXPECT_EQ(manager.GetNodeStatus(kNode, status), CHIP_ERROR_KEY_NOT_FOUND);
+    EXPECT_EQ(manager.Resubscribe(kNode), CHIP_ERROR_KEY_NOT_FOUND);
+    EXPECT_EQ(manager.GetNodeCount(), 0u);
+
+    Manager::Liveness liveness = manager.GetLiveness();
+    EXPECT_EQ(liveness.active, 0u);
+    EXPECT_EQ(liveness.failed, 0u);
+    EXPECT_EQ(liveness.maxReportAge, System::Clock::kZero);
+}
+
+TEST_F(TestControllerSubscriptionManager, TestSubscriptionLifecycle)
+{
+    RecordingDelegate delegate;
+    Manager manager(kMemoryBudget, &delegate);
+    const ScopedNodeId node = ToScopedNodeId(0x1001);
+
+    ASSERT_EQ(manager.Init(InteractionModelEngine::GetInstance()), CHIP_NO_ERROR);
+    ASSERT_EQ(Subscribe(manager, node), CHIP_NO_ERROR);
+    EXPECT_EQ(Subscribe(manager, node), CHIP_ERROR_INCORRECT_STATE);
+    EXPECT_EQ(manager.GetNodeCount(), 1u);
+    EXPECT_EQ(GetStatus(manager, node).state, SubscriptionState::kSubscribing);
+    EXPECT_EQ(manager.GetLiveness().subscribing, 1u);
+
+    ReadClient::Callback & callback = GetReadClientCallback(manager, node);
+    ReadClient * readClient         = GetReadClient(manager, node);
+    ASSERT_NE(readClient, nullptr);
+
+    callback.OnSubscriptionEstablished(1);
+    EXPECT_EQ(GetStatus(manager, node).state, SubscriptionState::kActive);
+    ReportAttribute(callback, 1);
+    EXPECT_EQ(GetStatus(manager, node).lastReportTime, gMockClock.GetMonotonicTimestamp());
+
+    gMockClock.AdvanceMonotonic(5000_ms64);
+    Manager::Liveness liveness = manager.GetLiveness();
+    EXPECT_EQ(liveness.subscribing, 0u);
+    EXPECT_EQ(liveness.active, 1u);
+    EXPECT_EQ(liveness.maxReportAge, 5000_ms64);
+
+    // A drop schedules a resubscription on the shared schedule.
+    EXPECT_EQ(callback.OnResubscriptionNeeded(readClient, CHIP_ERROR_TIMEOUT), CHIP_NO_ERROR);
+    EXPECT_EQ(GetStatus(manager, node).state, SubscriptionState::kResubscribing);
+    EXPECT_EQ(GetStatus(manager, node).retries, 1u);
+    EXPECT_EQ(manager.GetStats().resubscribesScheduled, 1u);
+    liveness = manager.GetLiveness();
+    EXPECT_EQ(liveness.active, 0u);
+    EXPECT_EQ(liveness.resubscribing, 1u);
+
+    callback.OnSubscriptionEstablished(2);
+    EXPECT_EQ(GetStatus(manager, node).state, SubscriptionState::kActive);
+    EXPECT_EQ(GetStatus(manager, node).retries, 0u);
+
+    // An idle LIT ICD is left alone until it checks in.
+    EXPECT_EQ(callback.OnResubscriptionNeeded(readClient, CHIP_ERROR_LIT_SUBSCRIBE_INACTIVE_TIMEOUT),
+              CHIP_ERROR_LIT_SUBSCRIBE_INACTIVE_TIMEOUT);
+    EXPECT_EQ(GetStatus(manager, node).state, SubscriptionState::kInactiveICD);
+    EXPECT_EQ(manager.GetLiveness().inactiveICD, 1u);
+    EXPECT_EQ(manager.GetStats().resubscribesScheduled, 1u);
+
+    callback.OnDone(readClient);
+    EXPECT_EQ(GetStatus(manager, node).state, SubscriptionState::kFailed);
+    EXPECT_EQ(manager.GetLiveness().failed, 1u);
+
+    const std::vector<SubscriptionState> expected = { SubscriptionState::kActive, SubscriptionState::kResubscribing,
+                                                      SubscriptionState::kActive, SubscriptionState::kInactiveICD,
+                                                      SubscriptionState::kFailed };
+    EXPECT_EQ(delegate.mStateChanges, expected);
+
+    // Resubscribe starts over with a new ReadClient.
+    EXPECT_EQ(manager.Resubscribe(node), CHIP_NO_ERROR);
+    EXPECT_EQ(GetStatus(manager, node).state, SubscriptionState::kSubscribing);
+    EXPECT_EQ(delegate.mStateChanges.back(), SubscriptionState::kSubscribing);
+    EXPECT_NE(GetReadClient(manager, node), nullptr);
+    liveness = manager.GetLiveness();
+    EXPECT_EQ(liveness.failed, 0u);
+    EXPECT_EQ(liveness.subscribing, 1u);
+
+    // The cached data of the node outlives the resubscription, but not the unsubscription.
+    EXPECT_EQ(manager.GetCache().GetNodeCount(), 1u);
+    manager.Unsubscribe(node);
+    EXPECT_EQ(manager.GetNodeCount(), 0u);
+    EXPECT_EQ(manager.GetCache().GetNodeCount(), 0u);
+    Manager::NodeStatus status;
+    EXPECT_EQ(manager.GetNodeStatus(node, status), CHIP_ERROR_KEY_NOT_FOUND);
+    EXPECT_EQ(manager.Resubscribe(node), CHIP_ERROR_KEY_NOT_FOUND);
+    EXPECT_EQ(manager.GetLiveness().subscribing, 0u);
+}
+
+TEST_F(TestControllerSubscriptionManager, TestEvictionReachesDelegate)
+{
+    RecordingDelegate delegate;
+    Manager manager(kMemoryBudget, &delegate);
+    const ScopedNodeId nodeA = ToScopedNodeId(0x1001);
+    const ScopedNodeId nodeB = ToScopedNodeId(0x1002);
+
+    ASSERT_EQ(manager.Init(InteractionModelEngine::GetInstance()), CHIP_NO_ERROR);
+    ASSERT_EQ(Subscribe(manager, nodeA), CHIP_NO_ERROR);
+    ASSERT_EQ(Subscribe(manager, nodeB), CHIP_NO_ERROR);
+
+    ReportAttribute(GetReadClientCallback(manager, nodeA), 1);
+    ReportAttribute(GetReadClientCallback(manager, nodeB), 2);
+    EXPECT_EQ(delegate.mUpdated.size(), 2u);
+    EXPECT_EQ(manager.GetLiveness().evicted, 0u);
+
+    // Shrinking the budget evicts both nodes; their subscriptions stay up.
+    manager.GetCache().SetMemoryBudget(0);
+    EXPECT_EQ(delegate.mEvicted.size(), 2u);
+    EXPECT_FALSE(GetStatus(manager, nodeA).hasData);
+    EXPECT_FALSE(GetStatus(manager, nodeB).hasData);
+    EXPECT_EQ(manager.GetLiveness().evicted, 2u);
+    EXPECT_EQ(manager.GetNodeCount(), 2u);
+
+    // The next report brings the data of a node back.
+    manager.GetCache().SetMemoryBudget(kMemoryBudget);
+    ReportAttribute(GetReadClientCallback(manager, nodeA), 3);
+    EXPECT_TRUE(GetStatus(manager, nodeA).hasData);
+    EXPECT_FALSE(GetStatus(manager, nodeB).hasData);
+    EXPECT_EQ(manager.GetLiveness().evicted, 1u);
+}
+
+} // namespace app
+} // namespace chip
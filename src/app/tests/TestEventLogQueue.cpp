@@ -0,0 +1,249 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/EventLogQueue.h>
+#include <app/EventLoggingTypes.h>
+#include <app/EventManagement.h>
+#include <app/MessageDef/EventReportIB.h>
+#include <app/tests/AppTestContext.h>
+#include <lib/core/TLV.h>
+#include <lib/core/TLVUtilities.h>
+#include <lib/support/CHIPCounter.h>
+#include <lib/support/CodeUtils.h>
+
+#include <lib/core/StringBuilderAdapters.h>
+#include <pw_unit_test/framework.h>
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+#include <thread>
+#include <vector>
+#endif
+
+namespace {
+
+using namespace chip;
+using namespace chip::app;
+
+constexpr ClusterId kTestClusterId   = 0x00000006;
+constexpr EventId kTestEventId       = 1;
+constexpr EndpointId kTestEndpointId = 1;
+
+uint8_t gDebugEventBuffer[512];
+uint8_t gInfoEventBuffer[512];
+uint8_t gCritEventBuffer[512];
+CircularEventBuffer gCircularEventBuffer[3];
+
+// Static so that a drain scheduled on the event loop never outlives the queue.
+EventLogQueueSlot gSlots[4];
+EventLogQueue gQueue;
+
+class TestEventLogQueue : public Test::AppContext
+{
+public:
+    void SetUp() override
+    {
+        const LogStorageResources logStorageResources[] = {
+            { &gDebugEventBuffer[0], sizeof(gDebugEventBuffer), PriorityLevel::Debug },
+            { &gInfoEventBuffer[0], sizeof(gInfoEventBuffer), PriorityLevel::Info },
+            { &gCritEventBuffer[0], sizeof(gCritEventBuffer), PriorityLevel::Critical },
+        };
+
+        AppContext::SetUp();
+        ASSERT_EQ(mEventCounter.Init(0), CHIP_NO_ERROR);
+        EventManagement::CreateEventManagement(&GetExchangeManager(), ArraySize(logStorageResources), gCircularEventBuffer,
+                                               logStorageResources, &mEventCounter);
+        ASSERT_EQ(gQueue.Init(&EventManagement::GetInstance(), Span<EventLogQueueSlot>(gSlots)), CHIP_NO_ERROR);
+    }
+
+    void TearDown() override
+    {
+        gQueue.Shutdown();
+        EventManagement::DestroyEventManagement();
+        AppContext::TearDown();
+    }
+
+private:
+    MonotonicallyIncreasingCounter<EventNumber> mEventCounter;
+};
+
+size_t CountLoggedEvents()
+{
+    TLV::TLVReader reader;
+    size_t count = 0;
+    CircularEventBufferWrapper bufWrapper;
+    EXPECT_EQ(EventManagement::GetInstance().GetEventReader(reader, PriorityLevel::Critical, &bufWrapper), CHIP_NO_ERROR);
+    EXPECT_EQ(TLV::Utilities::Count(reader, count, false), CHIP_NO_ERROR);
+    return count;
+}
+
+ByteSpan EncodePayload(uint8_t (&buffer)[16], uint32_t aValue)
+{
+    TLV::TLVWriter writer;
+    TLV::TLVType outer;
+    writer.Init(buffer);
+    EXPECT_EQ(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outer), CHIP_NO_ERROR);
+    EXPECT_EQ(writer.Put(TLV::ContextTag(0), aValue), CHIP_NO_ERROR);
+    EXPECT_EQ(writer.EndContainer(outer), CHIP_NO_ERROR);
+    EXPECT_EQ(writer.Finalize(), CHIP_NO_ERROR);
+    return ByteSpan(buffer, writer.GetLengthWritten());
+}
+
+EventOptions TestEventOptions()
+{
+    EventOptions options;
+    options.mPath     = ConcreteEventPath(kTestEndpointId, kTestClusterId, kTestEventId);
+    options.mPriority = PriorityLevel::Info;
+    return options;
+}
+
+TEST_F(TestEventLogQueue, TestEnqueueAndDrain)
+{
+    uint8_t buffer[16];
+
+    EXPECT_EQ(gQueue.Enqueue(TestEventOptions(), EncodePayload(buffer, 1)), CHIP_NO_ERROR);
+    EXPECT_EQ(gQueue.Enqueue(TestEventOptions(), EncodePayload(buffer, 2)), CHIP_NO_ERROR);
+    EXPECT_EQ(CountLoggedEvents(), 0u);
+
+    EXPECT_EQ(gQueue.Drain(1), 1u);
+    EXPECT_EQ(CountLoggedEvents(), 1u);
+    EXPECT_EQ(gQueue.Drain(8), 1u);
+    EXPECT_EQ(CountLoggedEvents(), 2u);
+    EXPECT_EQ(gQueue.Drain(8), 0u);
+
+    EXPECT_EQ(gQueue.GetDroppedFullCount(), 0u);
+    EXPECT_EQ(gQueue.GetLogFailureCount(), 0u);
+}
+
+TEST_F(TestEventLogQueue, TestDropCounters)
+{
+    uint8_t buffer[16];
+
+    for (uint32_t i = 0; i < ArraySize(gSlots); i++)
+    {
+        EXPECT_EQ(gQueue.Enqueue(TestEventOptions(), EncodePayload(buffer, i)), CHIP_NO_ERROR);
+    }
+    EXPECT_EQ(gQueue.Enqueue(TestEventOptions(), EncodePayload(buffer, 42)), CHIP_ERROR_NO_MEMORY);
+    EXPECT_EQ(gQueue.GetDroppedFullCount(), 1u);
+
+    uint8_t oversized[CHIP_CONFIG_EVENT_LOG_QUEUE_MAX_PAYLOAD_SIZE + 1] = {};
+    EXPECT_EQ(gQueue.Enqueue(TestEventOptions(), ByteSpan(oversized)), CHIP_ERROR_BUFFER_TOO_SMALL);
+    EXPECT_EQ(gQueue.GetDroppedOversizeCount(), 1u);
+
+    // Draining frees the slots for the next lap around the ring.
+    EXPECT_EQ(gQueue.Drain(ArraySize(gSlots)), ArraySize(gSlots));
+    EXPECT_EQ(gQueue.Enqueue(TestEventOptions(), EncodePayload(buffer, 5)), CHIP_NO_ERROR);
+    EXPECT_EQ(gQueue.Drain(8), 1u);
+    EXPECT_EQ(CountLoggedEvents(), ArraySize(gSlots) + 1);
+}
+
+TEST_F(TestEventLogQueue, TestDestroyWithDrainScheduled)
+{
+    uint8_t buffer[16];
+
+    {
+        EventLogQueueSlot slots[2];
+        EventLogQueue queue;
+        ASSERT_EQ(queue.Init(&EventManagement::GetInstance(), Span<EventLogQueueSlot>(slots)), CHIP_NO_ERROR);
+
+        // Schedules a drain on the event loop, which is still pending when the queue goes away.
+        EXPECT_EQ(queue.Enqueue(TestEventOptions(), EncodePayload(buffer, 1)), CHIP_NO_ERROR);
+        queue.Shutdown();
+        EXPECT_EQ(CountLoggedEvents(), 1u);
+    }
+
+    // The leftover drain must not touch the destroyed queue.
+    DrainAndServiceIO();
+    EXPECT_EQ(CountLoggedEvents(), 1u);
+
+    EXPECT_EQ(gQueue.Enqueue(TestEventOptions(), EncodePayload(buffer, 2)), CHIP_NO_ERROR);
+    EXPECT_EQ(gQueue.Drain(8), 1u);
+    EXPECT_EQ(CountLoggedEvents(), 2u);
+}
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+uint32_t LoggedEventValue(const TLV::TLVReader & aEvent)
+{
+    EventReportIB::Parser report;
+    EventDataIB::Parser eventData;
+    TLV::TLVReader data;
+    TLV::TLVType outer;
+    uint32_t value = UINT32_MAX;
+
+    EXPECT_EQ(report.Init(aEvent), CHIP_NO_ERROR);
+    EXPECT_EQ(report.GetEventData(&eventData), CHIP_NO_ERROR);
+    EXPECT_EQ(eventData.GetData(&data), CHIP_NO_ERROR);
+    EXPECT_EQ(data.EnterContainer(outer), CHIP_NO_ERROR);
+    EXPECT_EQ(data.Next(TLV::ContextTag(0)), CHIP_NO_ERROR);
+    EXPECT_EQ(data.Get(value), CHIP_NO_ERROR);
+    return value;
+}
+
+TEST_F(TestEventLogQueue, TestConcurrentProducers)
+{
+    constexpr uint32_t kProducerCount     = 4;
+    constexpr uint32_t kEventsPerProducer = 5;
+    constexpr uint32_t kEventCount        = kProducerCount * kEventsPerProducer;
+
+    EventLogQueueSlot slots[32];
+    EventLogQueue queue;
+    ASSERT_EQ(queue.Init(&EventManagement::GetInstance(), Span<EventLogQueueSlot>(slots)), CHIP_NO_ERROR);
+
+    std::vector<std::thread> producers;
+    for (uint32_t producer = 0; producer < kProducerCount; producer++)
+    {
+        producers.emplace_back([&queue, producer] {
+            for (uint32_t i = 0; i < kEventsPerProducer; i++)
+            {
+                uint8_t buffer[16];
+                EXPECT_EQ(queue.Enqueue(TestEventOptions(), EncodePayload(buffer, producer * kEventsPerProducer + i)),
+                          CHIP_NO_ERROR);
+            }
+        });
+    }
+    for (std::thread & producer : producers)
+    {
+        producer.join();
+    }
+
+    EXPECT_EQ(queue.Drain(ArraySize(slots)), kEventCount);
+    EXPECT_EQ(queue.GetDroppedFullCount(), 0u);
+    EXPECT_EQ(queue.GetLogFailureCount(), 0u);
+    queue.Shutdown();
+
+    // Every event was logged exactly once.
+    bool seen[kEventCount] = {};
+    TLV::TLVReader reader;
+    CircularEventBufferWrapper bufWrapper;
+    EXPECT_EQ(EventManagement::GetInstance().GetEventReader(reader, PriorityLevel::Critical, &bufWrapper), CHIP_NO_ERROR);
+    while (reader.Next() == CHIP_NO_ERROR)
+    {
+        const uint32_t value = LoggedEventValue(reader);
+        ASSERT_LT(value, kEventCount);
+        EXPECT_FALSE(seen[value]);
+        seen[value] = true;
+    }
+    for (bool eventSeen : seen)
+    {
+        EXPECT_TRUE(eventSeen);
+    }
+}
+
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+} // namespace
@@ -21,6 +21,7 @@
 #include <app/EventLoggingTypes.h>
 #include <app/EventManagement.h>
 #include <app/InteractionModelEngine.h>
+#include <app/MessageDef/EventReportIB.h>
 #include <app/tests/AppTestContext.h>
 #include <lib/core/CHIPCore.h>
 #include <lib/core/ErrorStr.h>
@@ -283,4 +284,144 @@ TEST_F(TestEventLogging, TestCheckLogEventWithDiscardLowEvent)
     CheckLogState(logMgmt, 3, chip::app::PriorityLevel::Debug);
 }
 
+static chip::EventNumber FirstEventNumber(chip::TLV::TLVReader & aReader)
+{
+    chip::app::EventReportIB::Parser report;
+    chip::app::EventDataIB::Parser eventData;
+    chip::EventNumber eventNumber = 0;
+
+    EXPECT_EQ(aReader.Next(), CHIP_NO_ERROR);
+    EXPECT_EQ(report.Init(aReader), CHIP_NO_ERROR);
+    EXPECT_EQ(report.GetEventData(&eventData), CHIP_NO_ERROR);
+    EXPECT_EQ(eventData.GetEventNumber(&eventNumber), CHIP_NO_ERROR);
+    return eventNumber;
+}
+
+static size_t FetchWithCursor(chip::app::EventManagement & aLogMgmt, chip::EventNumber & aEventMin,
+                              chip::app::EventReadCursor & aCursor,
+                              chip::SingleLinkedListNode<chip::app::EventPathParams> * apPaths)
+{
+    uint8_t backingStore[1024];
+    chip::TLV::TLVWriter writer;
+    size_t eventCount = 0;
+
+    writer.Init(backingStore, sizeof(backingStore));
+    EXPECT_EQ(aLogMgmt.FetchEventsSince(writer, apPaths, aEventMin, eventCount, chip::Access::SubjectDescriptor{}, &aCursor),
+              CHIP_NO_ERROR);
+    return eventCount;
+}
+
+TEST_F(TestEventLogging, TestFetchEventsWithCursor)
+{
+    chip::EventNumber eid;
+    chip::app::EventOptions options1;
+    chip::app::EventOptions options2;
+    TestEventGenerator testEventGenerator;
+
+    options1.mPath     = { kTestEndpointId1, kLivenessClusterId, kLivenessChangeEvent };
+    options1.mPriority = chip::app::PriorityLevel::Info;
+    options2.mPath     = { kTestEndpointId2, kLivenessClusterId, kLivenessChangeEvent };
+    options2.mPriority = chip::app::PriorityLevel::Info;
+
+    chip::SingleLinkedListNode<chip::app::EventPathParams> path;
+    path.mValue.mEndpointId = kTestEndpointId1;
+    path.mValue.mClusterId  = kLivenessClusterId;
+
+    chip::app::EventManagement & logMgmt = chip::app::EventManagement::GetInstance();
+    chip::app::EventReadCursor cursor;
+    chip::EventNumber eventMin = 0;
+
+    testEventGenerator.SetStatus(0);
+    EXPECT_EQ(logMgmt.LogEvent(&testEventGenerator, options1, eid), CHIP_NO_ERROR);
+    EXPECT_EQ(logMgmt.LogEvent(&testEventGenerator, options2, eid), CHIP_NO_ERROR);
+
+    // First fetch walks the whole log and leaves the cursor at its end.
+    EXPECT_EQ(FetchWithCursor(logMgmt, eventMin, cursor, &path), 1u);
+    EXPECT_EQ(eventMin, 2u);
+    EXPECT_NE(cursor.mpBuffer, nullptr);
+
+    // Nothing new: resuming from the cursor neither fetches events nor moves eventMin.
+    EXPECT_EQ(FetchWithCursor(logMgmt, eventMin, cursor, &path), 0u);
+    EXPECT_EQ(eventMin, 2u);
+
+    // Only the event appended after the cursor is visited.
+    testEventGenerator.SetStatus(1);
+    EXPECT_EQ(logMgmt.LogEvent(&testEventGenerator, options1, eid), CHIP_NO_ERROR);
+    EXPECT_EQ(FetchWithCursor(logMgmt, eventMin, cursor, &path), 1u);
+    EXPECT_EQ(eventMin, 3u);
+
+    // Events moved into the next buffer invalidate the cursor; the fetch falls back to a full scan and is still exact.
+    EXPECT_EQ(logMgmt.LogEvent(&testEventGenerator, options2, eid), CHIP_NO_ERROR);
+    EXPECT_EQ(logMgmt.LogEvent(&testEventGenerator, options1, eid), CHIP_NO_ERROR);
+    EXPECT_EQ(FetchWithCursor(logMgmt, eventMin, cursor, &path), 1u);
+    EXPECT_EQ(eventMin, 5u);
+
+    // Skipping to the end of the log lines the cursor up with the next event to be logged.
+    EXPECT_EQ(logMgmt.LogEvent(&testEventGenerator, options2, eid), CHIP_NO_ERROR);
+    logMgmt.SkipToEndOfLog(eventMin, cursor);
+    EXPECT_EQ(eventMin, 6u);
+    EXPECT_EQ(logMgmt.LogEvent(&testEventGenerator, options1, eid), CHIP_NO_ERROR);
+    EXPECT_EQ(FetchWithCursor(logMgmt, eventMin, cursor, &path), 1u);
+    EXPECT_EQ(eventMin, 7u);
+}
+
+TEST_F(TestEventLogging, TestFetchEventsWithCursorAfterEviction)
+{
+    chip::EventNumber eid;
+    chip::app::EventOptions options;
+    TestEventGenerator testEventGenerator;
+
+    options.mPath     = { kTestEndpointId1, kLivenessClusterId, kLivenessChangeEvent };
+    options.mPriority = chip::app::PriorityLevel::Info;
+
+    chip::SingleLinkedListNode<chip::app::EventPathParams> path;
+    path.mValue.mEndpointId = kTestEndpointId1;
+    path.mValue.mClusterId  = kLivenessClusterId;
+
+    chip::app::EventManagement & logMgmt = chip::app::EventManagement::GetInstance();
+    chip::app::EventReadCursor cursor;
+    chip::EventNumber eventMin = 0;
+
+    testEventGenerator.SetStatus(0);
+    EXPECT_EQ(logMgmt.LogEvent(&testEventGenerator, options, eid), CHIP_NO_ERROR);
+    EXPECT_EQ(FetchWithCursor(logMgmt, eventMin, cursor, &path), 1u);
+    EXPECT_EQ(eventMin, 1u);
+
+    // The debug and info buffers hold about three events each, so this evicts the events right after the cursor.
+    constexpr chip::EventNumber kLastEvent = 10;
+    for (chip::EventNumber i = 1; i <= kLastEvent; i++)
+    {
+        testEventGenerator.SetStatus(static_cast<int32_t>(i));
+        EXPECT_EQ(logMgmt.LogEvent(&testEventGenerator, options, eid), CHIP_NO_ERROR);
+    }
+
+    chip::TLV::TLVReader logReader;
+    chip::app::CircularEventBufferWrapper bufWrapper;
+    EXPECT_EQ(logMgmt.GetEventReader(logReader, chip::app::PriorityLevel::Info, &bufWrapper), CHIP_NO_ERROR);
+    const chip::EventNumber oldestSurviving = FirstEventNumber(logReader);
+    EXPECT_GT(oldestSurviving, eventMin);
+
+    // The cursor is stale: the fetch starts at the oldest event still in the log and returns everything after it.
+    uint8_t backingStore[1024];
+    chip::TLV::TLVWriter writer;
+    size_t eventCount = 0;
+    writer.Init(backingStore, sizeof(backingStore));
+    EXPECT_EQ(logMgmt.FetchEventsSince(writer, &path, eventMin, eventCount, chip::Access::SubjectDescriptor{}, &cursor),
+              CHIP_NO_ERROR);
+    EXPECT_EQ(eventCount, static_cast<size_t>(kLastEvent - oldestSurviving + 1));
+    EXPECT_EQ(eventMin, kLastEvent + 1);
+
+    chip::TLV::TLVReader fetchedReader;
+    fetchedReader.Init(backingStore, writer.GetLengthWritten());
+    EXPECT_EQ(FirstEventNumber(fetchedReader), oldestSurviving);
+
+    // The cursor was refreshed by that fetch and resumes at the end of the log again.
+    EXPECT_EQ(FetchWithCursor(logMgmt, eventMin, cursor, &path), 0u);
+    EXPECT_EQ(eventMin, kLastEvent + 1);
+    testEventGenerator.SetStatus(0);
+    EXPECT_EQ(logMgmt.LogEvent(&testEventGenerator, options, eid), CHIP_NO_ERROR);
+    EXPECT_EQ(FetchWithCursor(logMgmt, eventMin, cursor, &path), 1u);
+    EXPECT_EQ(eventMin, kLastEvent + 2);
+}
+
 } // namespace
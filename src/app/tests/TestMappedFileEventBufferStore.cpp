@@ -0,0 +1,185 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/EventLoggingDelegate.h>
+#include <app/EventLoggingTypes.h>
+#include <app/EventManagement.h>
+#include <app/MappedFileEventBufferStore.h>
+#include <app/tests/AppTestContext.h>
+#include <lib/core/TLV.h>
+#include <lib/core/TLVUtilities.h>
+#include <lib/support/CHIPCounter.h>
+#include <lib/support/CodeUtils.h>
+
+#include <lib/core/StringBuilderAdapters.h>
+#include <pw_unit_test/framework.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace {
+
+using namespace chip;
+using namespace chip::app;
+
+constexpr ClusterId kTestClusterId   = 0x00000006;
+constexpr EventId kTestEventId       = 1;
+constexpr EndpointId kTestEndpointId = 1;
+constexpr uint32_t kBufferSize       = 256;
+
+CircularEventBuffer gCircularEventBuffer[3];
+
+class TestEventGenerator : public EventLoggingDelegate
+{
+public:
+    CHIP_ERROR WriteEvent(TLV::TLVWriter & aWriter) override
+    {
+        TLV::TLVType dataContainerType;
+        ReturnErrorOnFailure(aWriter.StartContainer(TLV::ContextTag(EventDataIB::Tag::kData), TLV::kTLVType_Structure,
+                                                    dataContainerType));
+        ReturnErrorOnFailure(aWriter.Put(TLV::ContextTag(1), mStatus));
+        return aWriter.EndContainer(dataContainerType);
+    }
+
+    int32_t mStatus = 0;
+};
+
+class TestMappedFileEventBufferStore : public Test::AppContext
+{
+public:
+    void SetUp() override
+    {
+        AppContext::SetUp();
+        snprintf(mDirectory, sizeof(mDirectory), "/tmp/chip-event-store-XXXXXX");
+        ASSERT_NE(mkdtemp(mDirectory), nullptr);
+        ASSERT_EQ(mEventCounter.Init(0), CHIP_NO_ERROR);
+    }
+
+    void TearDown() override
+    {
+        for (auto & store : mStores)
+        {
+            store.Close();
+        }
+        for (const char * name : { "debug", "info", "crit" })
+        {
+            char path[128];
+            snprintf(path, sizeof(path), "%s/%s", mDirectory, name);
+            unlink(path);
+        }
+        rmdir(mDirectory);
+        AppContext::TearDown();
+    }
+
+    void StartEventManagement()
+    {
+        const char * names[]         = { "debug", "info", "crit" };
+        const PriorityLevel levels[] = { PriorityLevel::Debug, PriorityLevel::Info, PriorityLevel::Critical };
+        LogStorageResources resources[3];
+
+        for (size_t i = 0; i < ArraySize(resources); i++)
+        {
+            char path[128];
+            snprintf(path, sizeof(path), "%s/%s", mDirectory, names[i]);
+            ASSERT_EQ(mStores[i].Open(path, kBufferSize), CHIP_NO_ERROR);
+            resources[i] = { mStores[i].GetBuffer(), mStores[i].GetBufferSize(), levels[i], &mStores[i] };
+        }
+
+        EventManagement::CreateEventManagement(&GetExchangeManager(), ArraySize(resources), gCircularEventBuffer, resources,
+                                               &mEventCounter);
+    }
+
+    void StopEventManagement()
+    {
+        EventManagement::DestroyEventManagement();
+        for (auto & store : mStores)
+        {
+            store.Close();
+        }
+    }
+
+    char mDirectory[64];
+    MappedFileEventBufferStore mStores[3];
+    MonotonicallyIncreasingCounter<EventNumber> mEventCounter;
+};
+
+size_t CountLoggedEvents()
+{
+    TLV::TLVReader reader;
+    size_t count = 0;
+    CircularEventBufferWrapper bufWrapper;
+    EXPECT_EQ(EventManagement::GetInstance().GetEventReader(reader, PriorityLevel::Critical, &bufWrapper), CHIP_NO_ERROR);
+    EXPECT_EQ(TLV::Utilities::Count(reader, count, false), CHIP_NO_ERROR);
+    return count;
+}
+
+TEST_F(TestMappedFileEventBufferStore, TestEventsSurviveRestart)
+{
+    TestEventGenerator generator;
+    EventOptions options;
+    EventNumber eventNumber;
+    options.mPath     = ConcreteEventPath(kTestEndpointId, kTestClusterId, kTestEventId);
+    options.mPriority = PriorityLevel::Critical;
+
+    StartEventManagement();
+    EXPECT_EQ(CountLoggedEvents(), 0u);
+    for (int32_t i = 0; i < 20; i++)
+    {
+        generator.mStatus = i;
+        EXPECT_EQ(EventManagement::GetInstance().LogEvent(&generator, options, eventNumber), CHIP_NO_ERROR);
+    }
+    const size_t loggedBeforeRestart = CountLoggedEvents();
+    EXPECT_GT(loggedBeforeRestart, 0u);
+    StopEventManagement();
+
+    // Events logged by the previous "run", including the ones that were evicted into higher priority buffers, are back.
+    StartEventManagement();
+    EXPECT_EQ(CountLoggedEvents(), loggedBeforeRestart);
+
+    EXPECT_EQ(EventManagement::GetInstance().LogEvent(&generator, options, eventNumber), CHIP_NO_ERROR);
+    EXPECT_GE(CountLoggedEvents(), loggedBeforeRestart);
+    StopEventManagement();
+}
+
+TEST_F(TestMappedFileEventBufferStore, TestTornEventIsDropped)
+{
+    TestEventGenerator generator;
+    EventOptions options;
+    EventNumber eventNumber;
+    options.mPath     = ConcreteEventPath(kTestEndpointId, kTestClusterId, kTestEventId);
+    options.mPriority = PriorityLevel::Debug;
+
+    StartEventManagement();
+    EXPECT_EQ(EventManagement::GetInstance().LogEvent(&generator, options, eventNumber), CHIP_NO_ERROR);
+    EXPECT_EQ(EventManagement::GetInstance().LogEvent(&generator, options, eventNumber), CHIP_NO_ERROR);
+
+    // Simulate a crash in the middle of writing a third event: the layout covers bytes that are not a complete event.
+    uint32_t headOffset = 0;
+    uint32_t dataLength = 0;
+    ASSERT_EQ(mStores[0].LoadLayout(headOffset, dataLength), CHIP_NO_ERROR);
+    mStores[0].GetBuffer()[headOffset + dataLength] = TLV::kTLVType_Structure;
+    mStores[0].CommitLayout(headOffset, dataLength + 1);
+    StopEventManagement();
+
+    StartEventManagement();
+    EXPECT_EQ(CountLoggedEvents(), 2u);
+    StopEventManagement();
+}
+
+} // namespace
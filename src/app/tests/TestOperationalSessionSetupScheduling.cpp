@@ -0,0 +1,439 @@
+/*
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * Drives real OperationalSessionSetup objects through a CASESessionManager configured with a
+ * CASEEstablishmentScheduler that has a single slot, and checks that every way a setup leaves the
+ * "resolving or handshaking" phase gives the slot (or its queue entry) back.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include <app/CASEClientPool.h>
+#include <app/CASEEstablishmentScheduler.h>
+#include <app/CASESessionManager.h>
+#include <app/OperationalSessionSetupPool.h>
+#include <app/tests/AppTestContext.h>
+#include <credentials/GroupDataProvider.h>
+#include <credentials/GroupDataProviderImpl.h>
+#include <lib/core/StringBuilderAdapters.h>
+#include <lib/dnssd/Resolver.h>
+#include <lib/support/TestPersistentStorageDelegate.h>
+#include <pw_unit_test/framework.h>
+
+namespace {
+
+using namespace chip;
+using namespace chip::System::Clock::Literals;
+using Priority = CASEEstablishmentScheduler::Priority;
+
+constexpr NodeId kNodeA = 0x1001;
+constexpr NodeId kNodeB = 0x1002;
+constexpr NodeId kNodeC = 0x1003;
+
+constexpr uint8_t kTestIpk[Crypto::CHIP_CRYPTO_SYMMETRIC_KEY_LENGTH_BYTES] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+
+// Records operational lookups and only answers them when a test says so.
+class FakeOperationalResolver : public Dnssd::Resolver
+{
+public:
+    CHIP_ERROR Init(Inet::EndPointManager<Inet::UDPEndPoint> * udpEndPointManager) override { return CHIP_NO_ERROR; }
+    bool IsInitialized() override { return true; }
+    void Shutdown() override {}
+    void SetOperationalDelegate(Dnssd::OperationalResolveDelegate * delegate) override { mDelegate = delegate; }
+    CHIP_ERROR ResolveNodeId(const PeerId & peerId) override
+    {
+        mLookups.push_back(peerId);
+        return CHIP_NO_ERROR;
+    }
+    void NodeIdResolutionNoLongerNeeded(const PeerId & peerId) override { mFinishedLookups.push_back(peerId); }
+    CHIP_ERROR StartDiscovery(Dnssd::DiscoveryType type, Dnssd::DiscoveryFilter filter, Dnssd::DiscoveryContext &) override
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+    CHIP_ERROR StopDiscovery(Dnssd::DiscoveryContext &) override { return CHIP_ERROR_NOT_IMPLEMENTED; }
+    CHIP_ERROR ReconfirmRecord(const char * hostname, Inet::IPAddress address, Inet::InterfaceId interfaceId) override
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+
+    bool WasLookedUp(const PeerId & peerId) const { return Contains(mLookups, peerId); }
+    bool IsLookupFinished(const PeerId & peerId) const { return Contains(mFinishedLookups, peerId); }
+
+    void Fail(const PeerId & peerId, CHIP_ERROR error) { mDelegate->OnOperationalNodeResolutionFailed(peerId, error); }
+
+    void Resolve(const PeerId & peerId, const Inet::IPAddress & address, uint16_t port)
+    {
+        Dnssd::ResolvedNodeData nodeData;
+        nodeData.operationalData.peerId     = peerId;
+        nodeData.operationalData.hasZeroTTL = false;
+        nodeData.resolutionData.interfaceId = Inet::InterfaceId::Null();
+        nodeData.resolutionData.ipAddress[0] = address;
+        nodeData.resolutionData.numIPs       = 1;
+        nodeData.resolutionData.port         = port;
+        mDelegate->OnOperationalNodeResolved(nodeData);
+    }
+
+private:
+    static bool Contains(const std::vector<PeerId> & peers, const PeerId & peerId)
+    {
+        return std::find(peers.begin(), peers.end(), peerId) != peers.end();
+    }
+
+    Dnssd::OperationalResolveDelegate * mDelegate = nullptr;
+    std::vector<PeerId> mLookups;
+    std::vector<PeerId> mFinishedLookups;
+};
+
+// Owns the callbacks for one FindOrEstablishSession request.
+struct ConnectionRecorder
+{
+    ConnectionRecorder() :
+        mOnConnected(OnConnected, this), mOnFailure(OnFailure, this)
+#if CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
+        ,
+        mOnRetry(OnRetry, this)
+#endif // CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
+    {}
+
+    static void OnConnected(void * context, Messaging::ExchangeManager & exchangeMgr, const SessionHandle & sessionHandle)
+    {
+        static_cast<ConnectionRecorder *>(context)->mConnectedCount++;
+    }
+
+    static void OnFailure(void * context, const OperationalSessionSetup::ConnectionFailureInfo & failureInfo)
+    {
+        auto * self = static_cast<ConnectionRecorder *>(context);
+        self->mFailureCount++;
+        self->mLastError = failureInfo.error;
+    }
+
+#if CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
+    static void OnRetry(void * context, const ScopedNodeId & peerId, CHIP_ERROR error, System::Clock::Seconds16 retryTimeout)
+    {
+        static_cast<ConnectionRecorder *>(context)->mRetryCount++;
+    }
+#endif // CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
+
+    Callback::Callback<OnDeviceConnected> mOnConnected;
+    Callback::Callback<OperationalSessionSetup::OnSetupFailure> mOnFailure;
+#if CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
+    Callback::Callback<OnDeviceConnectionRetry> mOnRetry;
+#endif // CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
+
+    int mConnectedCount   = 0;
+    int mFailureCount     = 0;
+    int mRetryCount       = 0;
+    CHIP_ERROR mLastError = CHIP_NO_ERROR;
+};
+
+CASEEstablishmentScheduler::Config MakeSingleSlotConfig()
+{
+    CASEEstablishmentScheduler::Config config;
+    config.maxConcurrent = 1;
+    config.batchJitter   = System::Clock::kZero;
+    return config;
+}
+
+class TestOperationalSessionSetupScheduling : public Test::AppContext
+{
+public:
+    void SetUp() override
+    {
+        AppContext::SetUp();
+        VerifyOrReturn(!HasFailure());
+
+        // Must be in place before the manager initializes the address resolver, which registers itself with it.
+        Dnssd::Resolver::SetInstance(mResolver);
+
+        mGroupDataProvider.SetStorageDelegate(&mStorage);
+        mGroupDataProvider.SetSessionKeystore(&GetSessionKeystore());
+        ASSERT_EQ(mGroupDataProvider.Init(), CHIP_NO_ERROR);
+
+        uint8_t compressedFabricId[sizeof(uint64_t)];
+        MutableByteSpan compressedFabricIdSpan(compressedFabricId);
+        ASSERT_EQ(GetBobFabric()->GetCompressedFabricIdBytes(compressedFabricIdSpan), CHIP_NO_ERROR);
+        ASSERT_EQ(Credentials::SetSingleIpkEpochKey(&mGroupDataProvider, GetBobFabricIndex(), ByteSpan(kTestIpk),
+                                                    compressedFabricIdSpan),
+                  CHIP_NO_ERROR);
+
+        CASESessionManagerConfig config;
+        config.sessionInitParams.sessionManager    = &GetSecureSessionManager();
+        config.sessionInitParams.exchangeMgr       = &GetExchangeManager();
+        config.sessionInitParams.fabricTable       = &GetFabricTable();
+        config.sessionInitParams.groupDataProvider = &mGroupDataProvider;
+        config.clientPool                          = &mClientPool;
+        config.sessionSetupPool                    = &mSetupPool;
+        config.establishmentScheduler              = &mScheduler;
+        ASSERT_EQ(mManager.Init(&GetSystemLayer(), config), CHIP_NO_ERROR);
+    }
+
+    void TearDown() override
+    {
+        mManager.ReleaseAllSessions();
+        mManager.Shutdown();
+        GetExchangeManager().GetReliableMessageMgr()->RegisterSessionUpdateDelegate(nullptr);
+        mGroupDataProvider.Finish();
+        Dnssd::Resolver::SetInstance(Dnssd::GetDefaultResolver());
+        AppContext::TearDown();
+    }
+
+protected:
+    ScopedNodeId ToScopedNodeId(NodeId nodeId) { return ScopedNodeId(nodeId, GetBobFabricIndex()); }
+    PeerId ToPeerId(NodeId nodeId) { return PeerId(GetBobFabric()->GetCompressedFabricId(), nodeId); }
+
+    void Connect(NodeId nodeId, ConnectionRecorder & recorder, Priority priority = Priority::kNormal, uint8_t attemptCount = 1)
+    {
+        mManager.FindOrEstablishSession(priority, ToScopedNodeId(nodeId), &recorder.mOnConnected, &recorder.mOnFailure
+#if CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
+                                        ,
+                                        attemptCount, &recorder.mOnRetry
+#endif // CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
+        );
+    }
+
+    // Runs the scheduler's dispatch timer until `count` slots have been granted in total.
+    void WaitForStarted(uint32_t count)
+    {
+        GetIOContext().DriveIOUntil(1000_ms32, [&] { return mScheduler.GetStats().started >= count; });
+        EXPECT_EQ(mScheduler.GetStats().started, count);
+    }
+
+    // Answers the lookup for `nodeId` and waits out the minimum lookup time, after which the setup starts its handshake.
+    OperationalSessionSetup * ResolveAndStartHandshake(NodeId nodeId)
+    {
+        mResolver.Resolve(ToPeerId(nodeId), GetAddress(), CHIP_PORT);
+        GetIOContext().DriveIOUntil(2000_ms32, [&] { return mResolver.IsLookupFinished(ToPeerId(nodeId)); });
+        EXPECT_TRUE(mResolver.IsLookupFinished(ToPeerId(nodeId)));
+        return mSetupPool.FindSessionSetup(ToScopedNodeId(nodeId), /* forAddressUpdate = */ false);
+    }
+
+    FakeOperationalResolver mResolver;
+    TestPersistentStorageDelegate mStorage;
+    Credentials::GroupDataProviderImpl mGroupDataProvider;
+    CASEClientPool<4> mClientPool;
+    OperationalSessionSetupPool<4> mSetupPool;
+    CASEEstablishmentScheduler mScheduler{ MakeSingleSlotConfig() };
+    CASESessionManager mManager;
+};
+
+TEST_F(TestOperationalSessionSetupScheduling, LookupFailureReleasesSlot)
+{
+    ConnectionRecorder first;
+    ConnectionRecorder second;
+
+    Connect(kNodeA, first);
+    Connect(kNodeB, second);
+    EXPECT_EQ(mScheduler.GetStats().queueDepth, 2u);
+
+    WaitForStarted(1);
+    EXPECT_EQ(mScheduler.GetStats().active, 1u);
+    EXPECT_EQ(mScheduler.GetStats().queueDepth, 1u);
+    EXPECT_TRUE(mResolver.WasLookedUp(ToPeerId(kNodeA)));
+    EXPECT_FALSE(mResolver.WasLookedUp(ToPeerId(kNodeB)));
+
+    mResolver.Fail(ToPeerId(kNodeA), CHIP_ERROR_TIMEOUT);
+    EXPECT_EQ(first.mFailureCount, 1);
+    EXPECT_EQ(first.mLastError, CHIP_ERROR_TIMEOUT);
+    EXPECT_EQ(mScheduler.GetStats().active, 0u);
+
+    WaitForStarted(2);
+    EXPECT_EQ(mScheduler.GetStats().active, 1u);
+    EXPECT_EQ(mScheduler.GetStats().queueDepth, 0u);
+    EXPECT_TRUE(mResolver.WasLookedUp(ToPeerId(kNodeB)));
+    EXPECT_EQ(second.mFailureCount, 0);
+}
+
+TEST_F(TestOperationalSessionSetupScheduling, DestructionReleasesSlotAndQueueEntry)
+{
+    ConnectionRecorder first;
+    ConnectionRecorder second;
+    ConnectionRecorder third;
+
+    Connect(kNodeA, first);
+    Connect(kNodeB, second);
+    Connect(kNodeC, third);
+    WaitForStarted(1);
+    EXPECT_EQ(mScheduler.GetStats().queueDepth, 2u);
+
+    // A setup that is still queued leaves the queue when it goes away.
+    mManager.ReleaseSession(ToScopedNodeId(kNodeC));
+    EXPECT_EQ(third.mFailureCount, 1);
+    EXPECT_EQ(third.mLastError, CHIP_ERROR_CANCELLED);
+    EXPECT_EQ(mScheduler.GetStats().queueDepth, 1u);
+    EXPECT_EQ(mScheduler.GetStats().active, 1u);
+
+    // A setup holding the slot gives it to the next one in line.
+    mManager.ReleaseSession(ToScopedNodeId(kNodeA));
+    EXPECT_EQ(first.mFailureCount, 1);
+    EXPECT_EQ(first.mLastError, CHIP_ERROR_CANCELLED);
+    EXPECT_TRUE(mResolver.IsLookupFinished(ToPeerId(kNodeA)));
+    EXPECT_EQ(mScheduler.GetStats().active, 0u);
+
+    WaitForStarted(2);
+    EXPECT_EQ(mScheduler.GetStats().active, 1u);
+    EXPECT_EQ(mScheduler.GetStats().queueDepth, 0u);
+    EXPECT_TRUE(mResolver.WasLookedUp(ToPeerId(kNodeB)));
+    EXPECT_FALSE(mResolver.WasLookedUp(ToPeerId(kNodeC)));
+}
+
+TEST_F(TestOperationalSessionSetupScheduling, SchedulerShutdownFailsQueuedSetups)
+{
+    ConnectionRecorder first;
+    ConnectionRecorder second;
+
+    Connect(kNodeA, first);
+    Connect(kNodeB, second);
+    WaitForStarted(1);
+
+    // The setup still waiting for a slot is failed and released; the one holding the slot carries on.
+    mScheduler.Shutdown();
+    EXPECT_EQ(second.mFailureCount, 1);
+    EXPECT_EQ(second.mLastError, CHIP_ERROR_CANCELLED);
+    EXPECT_EQ(mSetupPool.FindSessionSetup(ToScopedNodeId(kNodeB), /* forAddressUpdate = */ false), nullptr);
+    EXPECT_EQ(first.mFailureCount, 0);
+    EXPECT_NE(mSetupPool.FindSessionSetup(ToScopedNodeId(kNodeA), /* forAddressUpdate = */ false), nullptr);
+    EXPECT_EQ(mScheduler.GetStats().queueDepth, 0u);
+}
+
+TEST_F(TestOperationalSessionSetupScheduling, HandshakeFailureReleasesSlot)
+{
+    ConnectionRecorder first;
+    ConnectionRecorder second;
+
+    Connect(kNodeA, first);
+    Connect(kNodeB, second);
+    WaitForStarted(1);
+
+    OperationalSessionSetup * setup = ResolveAndStartHandshake(kNodeA);
+    ASSERT_NE(setup, nullptr);
+    // The slot is held through the handshake, not just the lookup.
+    EXPECT_EQ(mScheduler.GetStats().active, 1u);
+    EXPECT_EQ(mScheduler.GetStats().queueDepth, 1u);
+
+    // With no attempts left the setup goes through NeedsAddress and is destroyed.
+    setup->OnSessionEstablishmentError(CHIP_ERROR_TIMEOUT, SessionEstablishmentStage::kSentSigma1);
+    EXPECT_EQ(first.mFailureCount, 1);
+    EXPECT_EQ(mScheduler.GetStats().active, 0u);
+
+    WaitForStarted(2);
+    EXPECT_TRUE(mResolver.WasLookedUp(ToPeerId(kNodeB)));
+}
+
+TEST_F(TestOperationalSessionSetupScheduling, HandshakeSuccessReleasesSlot)
+{
+    ExpireSessionBobToAlice();
+    ASSERT_EQ(CreateCASESessionBobToAlice(), CHIP_NO_ERROR);
+
+    ConnectionRecorder first;
+    ConnectionRecorder second;
+
+    Connect(kNodeA, first);
+    Connect(kNodeB, second);
+    WaitForStarted(1);
+
+    OperationalSessionSetup * setup = ResolveAndStartHandshake(kNodeA);
+    ASSERT_NE(setup, nullptr);
+
+    setup->OnSessionEstablished(GetSessionBobToAlice());
+    EXPECT_EQ(first.mConnectedCount, 1);
+    EXPECT_EQ(mScheduler.GetStats().established, 1u);
+    EXPECT_EQ(mScheduler.GetStats().active, 0u);
+
+    WaitForStarted(2);
+    EXPECT_TRUE(mResolver.WasLookedUp(ToPeerId(kNodeB)));
+}
+
+TEST_F(TestOperationalSessionSetupScheduling, ExistingSessionReleasesQueueEntry)
+{
+    ConnectionRecorder first;
+    ConnectionRecorder waiting;
+    ConnectionRecorder attaching;
+    const NodeId aliceNodeId = GetAliceFabric()->GetNodeId();
+
+    Connect(kNodeA, first);
+    WaitForStarted(1);
+    Connect(aliceNodeId, waiting);
+    EXPECT_EQ(mScheduler.GetStats().queueDepth, 1u);
+
+    // A session to the peer shows up while the setup is still waiting for a slot; the next request for that peer
+    // attaches to it and completes the queued setup without it ever resolving.
+    ExpireSessionBobToAlice();
+    ASSERT_EQ(CreateCASESessionBobToAlice(), CHIP_NO_ERROR);
+    Connect(aliceNodeId, attaching);
+
+    EXPECT_EQ(waiting.mConnectedCount, 1);
+    EXPECT_EQ(attaching.mConnectedCount, 1);
+    EXPECT_EQ(mScheduler.GetStats().queueDepth, 0u);
+    EXPECT_EQ(mScheduler.GetStats().active, 1u);
+    EXPECT_EQ(mScheduler.GetStats().established, 1u);
+    EXPECT_FALSE(mResolver.WasLookedUp(ToPeerId(aliceNodeId)));
+}
+
+#if CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
+TEST_F(TestOperationalSessionSetupScheduling, WaitingForRetryReleasesSlot)
+{
+    ConnectionRecorder first;
+    ConnectionRecorder second;
+
+    Connect(kNodeA, first, Priority::kNormal, /* attemptCount = */ 2);
+    Connect(kNodeB, second);
+    WaitForStarted(1);
+
+    OperationalSessionSetup * setup = ResolveAndStartHandshake(kNodeA);
+    ASSERT_NE(setup, nullptr);
+
+    // The first attempt times out; the setup backs off in WaitingForRetry and must not sit on the slot meanwhile.
+    setup->OnSessionEstablishmentError(CHIP_ERROR_TIMEOUT, SessionEstablishmentStage::kSentSigma1);
+    EXPECT_EQ(first.mRetryCount, 1);
+    EXPECT_EQ(first.mFailureCount, 0);
+    EXPECT_EQ(mScheduler.GetStats().active, 0u);
+    EXPECT_EQ(mSetupPool.FindSessionSetup(ToScopedNodeId(kNodeA), false), setup);
+
+    WaitForStarted(2);
+    EXPECT_TRUE(mResolver.WasLookedUp(ToPeerId(kNodeB)));
+}
+#endif // CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
+
+TEST_F(TestOperationalSessionSetupScheduling, BackgroundSetupWaitsBehindNormal)
+{
+    ConnectionRecorder first;
+    ConnectionRecorder resubscribe;
+    ConnectionRecorder foreground;
+
+    Connect(kNodeA, first);
+    WaitForStarted(1);
+
+    // ReadClient asks for resubscription sessions with background priority.
+    Connect(kNodeB, resubscribe, Priority::kBackground);
+    Connect(kNodeC, foreground, Priority::kNormal);
+    EXPECT_EQ(mScheduler.GetStats().queueDepth, 2u);
+
+    mResolver.Fail(ToPeerId(kNodeA), CHIP_ERROR_TIMEOUT);
+    WaitForStarted(2);
+    EXPECT_TRUE(mResolver.WasLookedUp(ToPeerId(kNodeC)));
+    EXPECT_FALSE(mResolver.WasLookedUp(ToPeerId(kNodeB)));
+
+    mResolver.Fail(ToPeerId(kNodeC), CHIP_ERROR_TIMEOUT);
+    WaitForStarted(3);
+    EXPECT_TRUE(mResolver.WasLookedUp(ToPeerId(kNodeB)));
+}
+
+} // namespace
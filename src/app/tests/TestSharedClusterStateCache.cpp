@@ -0,0 +1,422 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <vector>
+
+#include <app/SharedClusterStateCache.h>
+#include <lib/core/TLV.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/Span.h>
+
+#include <lib/core/StringBuilderAdapters.h>
+#include <pw_unit_test/framework.h>
+
+using namespace chip;
+using namespace chip::app;
+
+namespace {
+
+const ScopedNodeId kNodeA(0x1001, 1);
+const ScopedNodeId kNodeB(0x1002, 1);
+const ScopedNodeId kNodeC(0x1001, 2);
+const ScopedNodeId kNodeD(0x1003, 1);
+
+class ApplicationCallback : public ReadClient::Callback
+{
+public:
+    void OnReportBegin() override { mReportBegins++; }
+    void OnReportEnd() override { mReportEnds++; }
+    void OnAttributeData(const ConcreteDataAttributePath & aPath, TLV::TLVReader * apData, const StatusIB & aStatus) override
+    {
+        mAttributes++;
+        if (apData != nullptr)
+        {
+            // The forwarded reader must still be positioned on the value.
+            uint32_t value;
+            if (apData->GetType() == TLV::kTLVType_UnsignedInteger && apData->Get(value) == CHIP_NO_ERROR)
+            {
+                mLastValue = value;
+            }
+        }
+    }
+    void OnDone(ReadClient *) override {}
+
+    uint32_t mReportBegins = 0;
+    uint32_t mReportEnds   = 0;
+    uint32_t mAttributes   = 0;
+    uint32_t mLastValue    = 0;
+};
+
+class RecordingDelegate : public SharedClusterStateCache::Delegate
+{
+public:
+    void OnNodeUpdated(const ScopedNodeId & node) override { mUpdated.push_back(node); }
+    void OnNodeEvicted(const ScopedNodeId & node) override { mEvicted.push_back(node); }
+
+    std::vector<ScopedNodeId> mUpdated;
+    std::vector<ScopedNodeId> mEvicted;
+};
+
+void ReportValue(ReadClient::Callback & callback, const ConcreteDataAttributePath & path, uint32_t value)
+{
+    uint8_t buf[16];
+    TLV::TLVWriter writer;
+    writer.Init(buf);
+    ASSERT_EQ(writer.Put(TLV::AnonymousTag(), value), CHIP_NO_ERROR);
+    ASSERT_EQ(writer.Finalize(), CHIP_NO_ERROR);
+
+    TLV::TLVReader reader;
+    reader.Init(buf, writer.GetLengthWritten());
+    ASSERT_EQ(reader.Next(), CHIP_NO_ERROR);
+    callback.OnAttributeData(path, &reader, StatusIB());
+}
+
+void ReportString(ReadClient::Callback & callback, const ConcreteDataAttributePath & path, const char * value)
+{
+    uint8_t buf[64];
+    TLV::TLVWriter writer;
+    writer.Init(buf);
+    ASSERT_EQ(writer.PutString(TLV::AnonymousTag(), value), CHIP_NO_ERROR);
+    ASSERT_EQ(writer.Finalize(), CHIP_NO_ERROR);
+
+    TLV::TLVReader reader;
+    reader.Init(buf, writer.GetLengthWritten());
+    ASSERT_EQ(reader.Next(), CHIP_NO_ERROR);
+    callback.OnAttributeData(path, &reader, StatusIB());
+}
+
+// Reports `clusters` clusters of five attributes each on endpoint 1, all set to `value`.
+void ReportNode(SharedClusterStateCache::NodeFeed & feed, ClusterId clusters, uint32_t value)
+{
+    ReadClient::Callback & callback = feed.GetBufferedCallback();
+    callback.OnReportBegin();
+    for (ClusterId cluster = 0; cluster < clusters; cluster++)
+    {
+        for (AttributeId attribute = 0; attribute < 5; attribute++)
+        {
+            ReportValue(callback, ConcreteDataAttributePath(1, cluster, attribute), value);
+        }
+    }
+    callback.OnReportEnd();
+}
+
+uint32_t ReadValue(const SharedClusterStateCache::Snapshot & snapshot, const ScopedNodeId & node,
+                   const ConcreteAttributePath & path)
+{
+    TLV::TLVReader reader;
+    uint32_t value = 0;
+    if (snapshot.Get(node, path, reader) != CHIP_NO_ERROR || reader.Get(value) != CHIP_NO_ERROR)
+    {
+        return UINT32_MAX;
+    }
+    return value;
+}
+
+class TestSharedClusterStateCache : public ::testing::Test
+{
+public:
+    static void SetUpTestSuite() { ASSERT_EQ(Platform::MemoryInit(), CHIP_NO_ERROR); }
+    static void TearDownTestSuite() { Platform::MemoryShutdown(); }
+};
+
+TEST_F(TestSharedClusterStateCache, TestNodesAndAttributes)
+{
+    SharedClusterStateCache cache(1024 * 1024);
+    ASSERT_EQ(cache.Init(), CHIP_NO_ERROR);
+
+    ApplicationCallback appCallbackA, appCallbackC;
+    SharedClusterStateCache::NodeFeed feedA(cache, kNodeA, appCallbackA);
+    SharedClusterStateCache::NodeFeed feedC(cache, kNodeC, appCallbackC);
+
+    ReadClient::Callback & callbackA = feedA.GetBufferedCallback();
+    callbackA.OnReportBegin();
+    ReportValue(callbackA, ConcreteDataAttributePath(2, 6, 0, MakeOptional(DataVersion(7))), 1);
+    ReportString(callbackA, ConcreteDataAttributePath(1, 0x28, 5), "living room");
+    callbackA.OnAttributeData(ConcreteDataAttributePath(1, 6, 3), nullptr,
+                              StatusIB(Protocols::InteractionModel::Status::UnsupportedAttribute));
+    callbackA.OnReportEnd();
+
+    ReportNode(feedC, 1, 42);
+
+    // Everything is forwarded to the application.
+    EXPECT_EQ(appCallbackA.mReportBegins, 1u);
+    EXPECT_EQ(appCallbackA.mReportEnds, 1u);
+    EXPECT_EQ(appCallbackA.mAttributes, 3u);
+    EXPECT_EQ(appCallbackC.mAttributes, 5u);
+    EXPECT_EQ(appCallbackC.mLastValue, 42u);
+
+    auto snapshot = cache.GetSnapshot();
+    EXPECT_TRUE(snapshot.HasNode(kNodeA));
+    EXPECT_TRUE(snapshot.HasNode(kNodeC));
+    EXPECT_FALSE(snapshot.HasNode(kNodeB));
+    EXPECT_EQ(cache.GetNodeCount(), 2u);
+
+    // Nodes that only differ by fabric are kept apart.
+    EXPECT_EQ(ReadValue(snapshot, kNodeA, ConcreteAttributePath(2, 6, 0)), 1u);
+    EXPECT_EQ(ReadValue(snapshot, kNodeC, ConcreteAttributePath(1, 0, 4)), 42u);
+    EXPECT_EQ(ReadValue(snapshot, kNodeC, ConcreteAttributePath(2, 6, 0)), UINT32_MAX);
+
+    TLV::TLVReader reader;
+    CharSpan name;
+    ASSERT_EQ(snapshot.Get(kNodeA, ConcreteAttributePath(1, 0x28, 5), reader), CHIP_NO_ERROR);
+    ASSERT_EQ(reader.Get(name), CHIP_NO_ERROR);
+    EXPECT_TRUE(name.data_equal("living room"_span));
+
+    StatusIB status;
+    EXPECT_EQ(snapshot.Get(kNodeA, ConcreteAttributePath(1, 6, 3), reader), CHIP_ERROR_IM_STATUS_CODE_RECEIVED);
+    ASSERT_EQ(snapshot.GetStatus(kNodeA, ConcreteAttributePath(1, 6, 3), status), CHIP_NO_ERROR);
+    EXPECT_EQ(status.mStatus, Protocols::InteractionModel::Status::UnsupportedAttribute);
+    EXPECT_EQ(snapshot.GetStatus(kNodeA, ConcreteAttributePath(2, 6, 0), status), CHIP_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(snapshot.Get(kNodeA, ConcreteAttributePath(2, 6, 1), reader), CHIP_ERROR_KEY_NOT_FOUND);
+
+    Optional<DataVersion> version;
+    ASSERT_EQ(snapshot.GetVersion(kNodeA, ConcreteClusterPath(2, 6), version), CHIP_NO_ERROR);
+    EXPECT_EQ(version, MakeOptional(DataVersion(7)));
+    ASSERT_EQ(snapshot.GetVersion(kNodeA, ConcreteClusterPath(1, 6), version), CHIP_NO_ERROR);
+    EXPECT_FALSE(version.HasValue());
+    EXPECT_EQ(snapshot.GetVersion(kNodeA, ConcreteClusterPath(3, 6), version), CHIP_ERROR_KEY_NOT_FOUND);
+
+    // Clusters come back ordered by endpoint, then cluster id.
+    std::vector<ConcreteClusterPath> clusters;
+    EXPECT_EQ(snapshot.ForEachCluster(kNodeA,
+                                      [&](const ConcreteClusterPath & path) {
+                                          clusters.push_back(path);
+                                          return CHIP_NO_ERROR;
+                                      }),
+              CHIP_NO_ERROR);
+    ASSERT_EQ(clusters.size(), 3u);
+    EXPECT_EQ(clusters[0], ConcreteClusterPath(1, 6));
+    EXPECT_EQ(clusters[1], ConcreteClusterPath(1, 0x28));
+    EXPECT_EQ(clusters[2], ConcreteClusterPath(2, 6));
+
+    uint32_t attributes = 0;
+    EXPECT_EQ(snapshot.ForEachAttribute(kNodeC, 1, 0,
+                                        [&](const ConcreteAttributePath & path) {
+                                            EXPECT_EQ(path.mAttributeId, attributes);
+                                            attributes++;
+                                            return CHIP_NO_ERROR;
+                                        }),
+              CHIP_NO_ERROR);
+    EXPECT_EQ(attributes, 5u);
+    EXPECT_EQ(snapshot.ForEachAttribute(kNodeB, 1, 0, [](const ConcreteAttributePath &) { return CHIP_NO_ERROR; }),
+              CHIP_ERROR_KEY_NOT_FOUND);
+
+    uint32_t nodes = 0;
+    EXPECT_EQ(snapshot.ForEachNode([&](const ScopedNodeId &) {
+        nodes++;
+        return CHIP_NO_ERROR;
+    }),
+              CHIP_NO_ERROR);
+    EXPECT_EQ(nodes, 2u);
+}
+
+TEST_F(TestSharedClusterStateCache, TestSnapshotIsolation)
+{
+    SharedClusterStateCache cache(1024 * 1024);
+    ASSERT_EQ(cache.Init(), CHIP_NO_ERROR);
+
+    // An empty cache yields an empty snapshot.
+    EXPECT_FALSE(cache.GetSnapshot().HasNode(kNodeA));
+
+    ApplicationCallback appCallback;
+    SharedClusterStateCache::NodeFeed feedA(cache, kNodeA, appCallback);
+    SharedClusterStateCache::NodeFeed feedB(cache, kNodeB, appCallback);
+    ReportNode(feedA, 2, 1);
+    ReportNode(feedB, 2, 1);
+
+    auto before = cache.GetSnapshot();
+
+    TLV::TLVReader heldReader;
+    ASSERT_EQ(before.Get(kNodeA, ConcreteAttributePath(1, 0, 0), heldReader), CHIP_NO_ERROR);
+
+    // Update one attribute with a value that fits its old slot, and one with a larger value.
+    ReadClient::Callback & callback = feedA.GetBufferedCallback();
+    callback.OnReportBegin();
+    ReportValue(callback, ConcreteDataAttributePath(1, 0, 0), 2);
+    ReportValue(callback, ConcreteDataAttributePath(1, 0, 1), 0x12345678);
+
+    // Nothing of a report is visible before it ends.
+    auto during = cache.GetSnapshot();
+    EXPECT_EQ(ReadValue(during, kNodeA, ConcreteAttributePath(1, 0, 0)), 1u);
+
+    callback.OnReportEnd();
+    auto after = cache.GetSnapshot();
+
+    EXPECT_EQ(ReadValue(before, kNodeA, ConcreteAttributePath(1, 0, 0)), 1u);
+    EXPECT_EQ(ReadValue(before, kNodeA, ConcreteAttributePath(1, 0, 1)), 1u);
+    EXPECT_EQ(ReadValue(during, kNodeA, ConcreteAttributePath(1, 0, 1)), 1u);
+    EXPECT_EQ(ReadValue(after, kNodeA, ConcreteAttributePath(1, 0, 0)), 2u);
+    EXPECT_EQ(ReadValue(after, kNodeA, ConcreteAttributePath(1, 0, 1)), 0x12345678u);
+    EXPECT_EQ(ReadValue(after, kNodeA, ConcreteAttributePath(1, 1, 0)), 1u);
+    EXPECT_EQ(ReadValue(after, kNodeB, ConcreteAttributePath(1, 1, 4)), 1u);
+
+    // Data read from a snapshot stays valid while the snapshot lives.
+    uint32_t value = 0;
+    ASSERT_EQ(heldReader.Get(value), CHIP_NO_ERROR);
+    EXPECT_EQ(value, 1u);
+
+    // Repeated reports of values of the same size do not grow the cache.
+    before = during = after = SharedClusterStateCache::Snapshot();
+    ReportNode(feedA, 2, 3);
+    const size_t bytesUsed = cache.GetBytesUsed();
+    ReportNode(feedA, 2, 4);
+    EXPECT_LE(cache.GetBytesUsed(), bytesUsed);
+    EXPECT_EQ(ReadValue(cache.GetSnapshot(), kNodeA, ConcreteAttributePath(1, 1, 4)), 4u);
+
+    // Status replaces data and back.
+    callback.OnReportBegin();
+    callback.OnAttributeData(ConcreteDataAttributePath(1, 0, 2), nullptr, StatusIB(Protocols::InteractionModel::Status::Failure));
+    callback.OnReportEnd();
+    EXPECT_EQ(ReadValue(cache.GetSnapshot(), kNodeA, ConcreteAttributePath(1, 0, 2)), UINT32_MAX);
+    ReportNode(feedA, 1, 5);
+    EXPECT_EQ(ReadValue(cache.GetSnapshot(), kNodeA, ConcreteAttributePath(1, 0, 2)), 5u);
+}
+
+TEST_F(TestSharedClusterStateCache, TestEviction)
+{
+    RecordingDelegate delegate;
+    SharedClusterStateCache cache(SIZE_MAX, &delegate);
+    ASSERT_EQ(cache.Init(), CHIP_NO_ERROR);
+
+    ApplicationCallback appCallback;
+    SharedClusterStateCache::NodeFeed feedA(cache, kNodeA, appCallback);
+    SharedClusterStateCache::NodeFeed feedB(cache, kNodeB, appCallback);
+    SharedClusterStateCache::NodeFeed feedC(cache, kNodeC, appCallback);
+    SharedClusterStateCache::NodeFeed feedD(cache, kNodeD, appCallback);
+
+    ReportNode(feedA, 4, 1);
+    const size_t nodeBytes = cache.GetBytesUsed();
+    ReportNode(feedB, 4, 1);
+    ReportNode(feedC, 4, 1);
+    EXPECT_EQ(delegate.mUpdated.size(), 3u);
+
+    // Room for three nodes and a half.
+    cache.SetMemoryBudget(nodeBytes * 7 / 2);
+    EXPECT_TRUE(delegate.mEvicted.empty());
+
+    // A is the oldest, but was used more recently than B.
+    cache.Touch(kNodeA);
+    auto snapshot = cache.GetSnapshot();
+    ReportNode(feedD, 4, 1);
+
+    ASSERT_EQ(delegate.mEvicted.size(), 1u);
+    EXPECT_EQ(delegate.mEvicted[0], kNodeB);
+    EXPECT_EQ(cache.GetNodeCount(), 3u);
+    EXPECT_LE(cache.GetBytesUsed(), cache.GetMemoryBudget());
+    EXPECT_FALSE(cache.GetSnapshot().HasNode(kNodeB));
+    EXPECT_TRUE(cache.GetSnapshot().HasNode(kNodeD));
+
+    // Snapshots taken before the eviction still have the node.
+    EXPECT_EQ(ReadValue(snapshot, kNodeB, ConcreteAttributePath(1, 3, 4)), 1u);
+
+    // A node with a report in progress is not evicted, even when it is the least recently used one.
+    ReadClient::Callback & callbackC = feedC.GetBufferedCallback();
+    callbackC.OnReportBegin();
+    ReportValue(callbackC, ConcreteDataAttributePath(1, 0, 0), 2);
+    cache.SetMemoryBudget(nodeBytes * 5 / 2);
+    ASSERT_EQ(delegate.mEvicted.size(), 2u);
+    EXPECT_EQ(delegate.mEvicted[1], kNodeA);
+    callbackC.OnReportEnd();
+    EXPECT_EQ(ReadValue(cache.GetSnapshot(), kNodeC, ConcreteAttributePath(1, 0, 0)), 2u);
+
+    cache.RemoveNode(kNodeC);
+    EXPECT_FALSE(cache.GetSnapshot().HasNode(kNodeC));
+    EXPECT_EQ(cache.GetNodeCount(), 1u);
+    EXPECT_EQ(delegate.mEvicted.size(), 2u);
+
+    // An evicted node comes back with its next report.
+    ReportNode(feedB, 1, 9);
+    EXPECT_EQ(ReadValue(cache.GetSnapshot(), kNodeB, ConcreteAttributePath(1, 0, 0)), 9u);
+}
+
+TEST_F(TestSharedClusterStateCache, TestBudgetEnforcedDuringReport)
+{
+    RecordingDelegate delegate;
+    SharedClusterStateCache cache(SIZE_MAX, &delegate);
+    ASSERT_EQ(cache.Init(), CHIP_NO_ERROR);
+
+    ApplicationCallback appCallback;
+    SharedClusterStateCache::NodeFeed feedA(cache, kNodeA, appCallback);
+    SharedClusterStateCache::NodeFeed feedB(cache, kNodeB, appCallback);
+    SharedClusterStateCache::NodeFeed feedC(cache, kNodeC, appCallback);
+
+    ReportNode(feedA, 4, 1);
+    const size_t nodeBytes = cache.GetBytesUsed();
+    ReportNode(feedB, 4, 1);
+    cache.SetMemoryBudget(nodeBytes * 5 / 2);
+    EXPECT_TRUE(delegate.mEvicted.empty());
+
+    // Room is made as soon as the report outgrows the budget, not only once it ends.
+    ReadClient::Callback & callbackC = feedC.GetBufferedCallback();
+    callbackC.OnReportBegin();
+    for (ClusterId cluster = 0; cluster < 4; cluster++)
+    {
+        for (AttributeId attribute = 0; attribute < 5; attribute++)
+        {
+            ReportValue(callbackC, ConcreteDataAttributePath(1, cluster, attribute), 3);
+            EXPECT_LE(cache.GetBytesUsed(), cache.GetMemoryBudget());
+        }
+    }
+    ASSERT_EQ(delegate.mEvicted.size(), 1u);
+    EXPECT_EQ(delegate.mEvicted[0], kNodeA);
+    EXPECT_FALSE(cache.GetSnapshot().HasNode(kNodeC));
+
+    callbackC.OnReportEnd();
+    EXPECT_EQ(delegate.mEvicted.size(), 1u);
+    EXPECT_EQ(ReadValue(cache.GetSnapshot(), kNodeC, ConcreteAttributePath(1, 3, 4)), 3u);
+}
+
+TEST_F(TestSharedClusterStateCache, TestRemoveNodeDuringReport)
+{
+    RecordingDelegate delegate;
+    SharedClusterStateCache cache(SIZE_MAX, &delegate);
+    ASSERT_EQ(cache.Init(), CHIP_NO_ERROR);
+
+    ApplicationCallback appCallback;
+    SharedClusterStateCache::NodeFeed feedA(cache, kNodeA, appCallback);
+    SharedClusterStateCache::NodeFeed feedB(cache, kNodeB, appCallback);
+    SharedClusterStateCache::NodeFeed feedC(cache, kNodeC, appCallback);
+    ReportNode(feedC, 1, 1);
+
+    ReadClient::Callback & callbackA = feedA.GetBufferedCallback();
+    ReadClient::Callback & callbackB = feedB.GetBufferedCallback();
+    callbackA.OnReportBegin();
+    callbackB.OnReportBegin();
+    ReportValue(callbackA, ConcreteDataAttributePath(1, 0, 0), 1);
+    ReportValue(callbackB, ConcreteDataAttributePath(1, 0, 0), 2);
+
+    // Removing A drops what it had so far, but both reports are still in progress: only idle C may be evicted.
+    cache.RemoveNode(kNodeA);
+    ReportValue(callbackA, ConcreteDataAttributePath(1, 0, 1), 3);
+    cache.SetMemoryBudget(0);
+    ASSERT_EQ(delegate.mEvicted.size(), 1u);
+    EXPECT_EQ(delegate.mEvicted[0], kNodeC);
+    EXPECT_EQ(cache.GetNodeCount(), 2u);
+
+    callbackA.OnReportEnd();
+    callbackB.OnReportEnd();
+
+    // Each report ended once, so both nodes are idle again and get evicted.
+    ASSERT_EQ(delegate.mUpdated.size(), 1u);
+    ASSERT_EQ(delegate.mEvicted.size(), 3u);
+    EXPECT_EQ(delegate.mEvicted[1], kNodeA);
+    EXPECT_EQ(delegate.mEvicted[2], kNodeB);
+    EXPECT_EQ(cache.GetNodeCount(), 0u);
+}
+
+} // namespace
@@ -61,13 +61,15 @@ CHIP_ERROR DeviceControllerFactory::Init(FactoryInitParams params)
 
     // Save our initialization state that we can't recover later from a
     // created-but-shut-down system state.
-    mListenPort                = params.listenPort;
-    mFabricIndependentStorage  = params.fabricIndependentStorage;
-    mOperationalKeystore       = params.operationalKeystore;
-    mOpCertStore               = params.opCertStore;
-    mCertificateValidityPolicy = params.certificateValidityPolicy;
-    mSessionResumptionStorage  = params.sessionResumptionStorage;
-    mEnableServerInteractions  = params.enableServerInteractions;
+    mListenPort                 = params.listenPort;
+    mFabricIndependentStorage   = params.fabricIndependentStorage;
+    mOperationalKeystore        = params.operationalKeystore;
+    mOpCertStore                = params.opCertStore;
+    mCertificateValidityPolicy  = params.certificateValidityPolicy;
+    mSessionResumptionStorage   = params.sessionResumptionStorage;
+    mCASEEstablishmentScheduler = params.caseEstablishmentScheduler;
+    mCryptoWorkQueue            = params.cryptoWorkQueue;
+    mEnableServerInteractions   = params.enableServerInteractions;
 
     // Initialize the system state. Note that it is left in a somewhat
     // special state where it is initialized, but has a ref count of 0.
@@ -90,16 +92,18 @@ CHIP_ERROR DeviceControllerFactory::ReinitSystemStateIfNecessary()
 #if CONFIG_NETWORK_LAYER_BLE
     params.bleLayer = mSystemState->BleLayer();
 #endif
-    params.listenPort                = mListenPort;
-    params.fabricIndependentStorage  = mFabricIndependentStorage;
-    params.enableServerInteractions  = mEnableServerInteractions;
-    params.groupDataProvider         = mSystemState->GetGroupDataProvider();
-    params.sessionKeystore           = mSystemState->GetSessionKeystore();
-    params.fabricTable               = mSystemState->Fabrics();
-    params.operationalKeystore       = mOperationalKeystore;
-    params.opCertStore               = mOpCertStore;
-    params.certificateValidityPolicy = mCertificateValidityPolicy;
-    params.sessionResumptionStorage  = mSessionResumptionStorage;
+    params.listenPort                 = mListenPort;
+    params.fabricIndependentStorage   = mFabricIndependentStorage;
+    params.enableServerInteractions   = mEnableServerInteractions;
+    params.groupDataProvider          = mSystemState->GetGroupDataProvider();
+    params.sessionKeystore            = mSystemState->GetSessionKeystore();
+    params.fabricTable                = mSystemState->Fabrics();
+    params.operationalKeystore        = mOperationalKeystore;
+    params.opCertStore                = mOpCertStore;
+    params.certificateValidityPolicy  = mCertificateValidityPolicy;
+    params.sessionResumptionStorage   = mSessionResumptionStorage;
+    params.caseEstablishmentScheduler = mCASEEstablishmentScheduler;
+    params.cryptoWorkQueue            = mCryptoWorkQueue;
 
     // re-initialization keeps any previously initialized values. The only place where
     // a provider exists is in the InteractionModelEngine, so just say "keep it as is".
@@ -271,6 +275,7 @@ CHIP_ERROR DeviceControllerFactory::InitSystemState(FactoryInitParams params)
         ReturnErrorOnFailure(stateParams.caseServer->ListenForSessionEstablishment(
             stateParams.exchangeMgr, stateParams.sessionMgr, stateParams.fabricTable, sessionResumptionStorage,
             stateParams.certificateValidityPolicy, stateParams.groupDataProvider));
+        stateParams.caseServer->GetSession().SetCryptoWorkQueue(params.cryptoWorkQueue);
 
         //
         // We need to advertise the port that we're listening to for unsolicited messages over UDP. However, we have both a IPv4
@@ -306,15 +311,17 @@ CHIP_ERROR DeviceControllerFactory::InitSystemState(FactoryInitParams params)
         .exchangeMgr               = stateParams.exchangeMgr,
         .fabricTable               = stateParams.fabricTable,
         .groupDataProvider         = stateParams.groupDataProvider,
+        .cryptoWorkQueue           = params.cryptoWorkQueue,
         // Don't provide an MRP local config, so each CASE initiation will use
         // the then-current value.
         .mrpLocalConfig = NullOptional,
     };
 
     CASESessionManagerConfig sessionManagerConfig = {
-        .sessionInitParams = sessionInitParams,
-        .clientPool        = stateParams.caseClientPool,
-        .sessionSetupPool  = stateParams.sessionSetupPool,
+        .sessionInitParams      = sessionInitParams,
+        .clientPool             = stateParams.caseClientPool,
+        .sessionSetupPool       = stateParams.sessionSetupPool,
+        .establishmentScheduler = params.caseEstablishmentScheduler,
     };
 
     // TODO: Need to be able to create a CASESessionManagerConfig here!
@@ -450,11 +457,13 @@ void DeviceControllerFactory::Shutdown()
         Platform::Delete(mSystemState);
         mSystemState = nullptr;
     }
-    mFabricIndependentStorage  = nullptr;
-    mOperationalKeystore       = nullptr;
-    mOpCertStore               = nullptr;
-    mCertificateValidityPolicy = nullptr;
-    mSessionResumptionStorage  = nullptr;
+    mFabricIndependentStorage   = nullptr;
+    mOperationalKeystore        = nullptr;
+    mOpCertStore                = nullptr;
+    mCertificateValidityPolicy  = nullptr;
+    mSessionResumptionStorage   = nullptr;
+    mCASEEstablishmentScheduler = nullptr;
+    mCryptoWorkQueue            = nullptr;
 }
 
 void DeviceControllerSystemState::Shutdown()
@@ -142,6 +142,10 @@ struct FactoryInitParams
     Crypto::OperationalKeystore * operationalKeystore                  = nullptr;
     Credentials::OperationalCertificateStore * opCertStore             = nullptr;
     SessionResumptionStorage * sessionResumptionStorage                = nullptr;
+    // Optional; when set, operational session establishment is paced through this scheduler.
+    CASEEstablishmentScheduler * caseEstablishmentScheduler            = nullptr;
+    // Optional; when set, CASE certificate and signature checks run on this queue (e.g. a CryptoWorkerPool).
+    CryptoWorkQueue * cryptoWorkQueue                                  = nullptr;
 #if CONFIG_NETWORK_LAYER_BLE
     Ble::BleLayer * bleLayer = nullptr;
 #endif
@@ -297,6 +301,8 @@ private:
     Credentials::OperationalCertificateStore * mOpCertStore             = nullptr;
     Credentials::CertificateValidityPolicy * mCertificateValidityPolicy = nullptr;
     SessionResumptionStorage * mSessionResumptionStorage                = nullptr;
+    CASEEstablishmentScheduler * mCASEEstablishmentScheduler            = nullptr;
+    CryptoWorkQueue * mCryptoWorkQueue                                  = nullptr;
     bool mEnableServerInteractions                                      = false;
 };
 
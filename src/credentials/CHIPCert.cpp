@@ -409,6 +409,13 @@ CHIP_ERROR ChipCertificateSet::ValidateCert(const ChipCertificateData * cert, Va
         ExitNow(err = CHIP_ERROR_CA_CERT_NOT_FOUND);
     }
 
+    // A certificate whose signature the caller already verified against the trust anchor (see
+    // CertificateValidationCache) is valid when that trust anchor is its issuer.
+    if (cert->mCertFlags.Has(CertFlags::kSignatureVerified) && caCert->mCertFlags.Has(CertFlags::kIsTrustAnchor))
+    {
+        ExitNow(err = CHIP_NO_ERROR);
+    }
+
     // Verify signature of the current certificate against public key of the CA certificate. If signature verification
     // succeeds, the current certificate is valid.
     err = VerifyCertSignature(*cert, *caCert);
@@ -499,9 +506,10 @@ bool ChipCertificateData::IsEqual(const ChipCertificateData & other) const
 
 void ValidationContext::Reset()
 {
-    mEffectiveTime  = EffectiveTime{};
-    mTrustAnchor    = nullptr;
-    mValidityPolicy = nullptr;
+    mEffectiveTime   = EffectiveTime{};
+    mTrustAnchor     = nullptr;
+    mValidityPolicy  = nullptr;
+    mValidationCache = nullptr;
     mRequiredKeyUsages.ClearAll();
     mRequiredKeyPurposes.ClearAll();
     mRequiredCertType = CertType::kNotSpecified;
@@ -164,6 +164,7 @@ enum class CertFlags : uint16_t
     kIsCA                        = 0x0080, /**< Indicates that certificate is a CA certificate. */
     kIsTrustAnchor               = 0x0100, /**< Indicates that certificate is a trust anchor. */
     kTBSHashPresent              = 0x0200, /**< Indicates that TBS hash of the certificate was generated and stored. */
+    kSignatureVerified           = 0x0400, /**< Indicates that the signature was already verified against the trust anchor. */
 };
 
 /** CHIP Certificate Decode Flags
@@ -175,7 +176,10 @@ enum class CertDecodeFlags : uint8_t
     kGenerateTBSHash = 0x01, /**< Indicates that to-be-signed (TBS) hash of the certificate should be calculated when certificate is
                                 loaded. The TBS hash is then used to validate certificate signature. Normally, all certificates
                                 (except trust anchor) in the certificate validation chain require TBS hash. */
-    kIsTrustAnchor = 0x02,   /**< Indicates that the corresponding certificate is trust anchor. */
+    kIsTrustAnchor     = 0x02, /**< Indicates that the corresponding certificate is trust anchor. */
+    kSignatureVerified = 0x04, /**< Indicates that the caller already verified the certificate signature against the trust
+                                  anchor it is validated with, so no TBS hash is needed. Only meaningful in a certificate
+                                  set with a single trust anchor. */
 };
 
 enum
@@ -697,6 +697,11 @@ CHIP_ERROR DecodeChipCert(TLVReader & reader, ChipCertificateData & certData, Bi
         certData.mCertFlags.Set(CertFlags::kIsTrustAnchor);
     }
 
+    if (decodeFlags.Has(CertDecodeFlags::kSignatureVerified))
+    {
+        certData.mCertFlags.Set(CertFlags::kSignatureVerified);
+    }
+
     return CHIP_NO_ERROR;
 }
 
@@ -0,0 +1,139 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <credentials/CertificateValidationCache.h>
+
+#include <lib/support/CodeUtils.h>
+
+#include <mutex>
+#include <string.h>
+
+namespace chip {
+namespace Credentials {
+
+static_assert(CertificateValidationCache::kCapacity > 0, "CHIP_CONFIG_CERTIFICATE_VALIDATION_CACHE_SIZE must be positive");
+
+CHIP_ERROR CertificateValidationCache::Init()
+{
+    ReturnErrorOnFailure(System::Mutex::Init(mLock));
+    Clear();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CertificateValidationCache::ComputeDigest(const ByteSpan & icac, Digest & outDigest)
+{
+    VerifyOrReturnError(!icac.empty(), CHIP_ERROR_INVALID_ARGUMENT);
+    return Crypto::Hash_SHA256(icac.data(), icac.size(), outDigest);
+}
+
+CertificateValidationCache::Entry * CertificateValidationCache::Find(const P256PublicKeySpan & rootPublicKey,
+                                                                     const Digest & icacDigest)
+{
+    for (auto & entry : mEntries)
+    {
+        if (entry.inUse && memcmp(entry.icacDigest, icacDigest, sizeof(Digest)) == 0 &&
+            memcmp(entry.rootPublicKey, rootPublicKey.data(), sizeof(entry.rootPublicKey)) == 0)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool CertificateValidationCache::Contains(const P256PublicKeySpan & rootPublicKey, const Digest & icacDigest)
+{
+    std::lock_guard<System::Mutex> lock(mLock);
+
+    Entry * entry = Find(rootPublicKey, icacDigest);
+    if (entry == nullptr)
+    {
+        mStats.misses++;
+        return false;
+    }
+
+    entry->lastUsed = ++mUseCounter;
+    mStats.hits++;
+    return true;
+}
+
+void CertificateValidationCache::Insert(const P256PublicKeySpan & rootPublicKey, const Digest & icacDigest)
+{
+    std::lock_guard<System::Mutex> lock(mLock);
+
+    Entry * entry = Find(rootPublicKey, icacDigest);
+    if (entry == nullptr)
+    {
+        // Take a free slot, or else the least recently used one.
+        entry = &mEntries[0];
+        for (auto & candidate : mEntries)
+        {
+            if (!candidate.inUse)
+            {
+                entry = &candidate;
+                break;
+            }
+            if (candidate.lastUsed < entry->lastUsed)
+            {
+                entry = &candidate;
+            }
+        }
+
+        if (entry->inUse)
+        {
+            mStats.evictions++;
+        }
+        entry->inUse = true;
+        memcpy(entry->rootPublicKey, rootPublicKey.data(), sizeof(entry->rootPublicKey));
+        memcpy(entry->icacDigest, icacDigest, sizeof(Digest));
+    }
+
+    entry->lastUsed = ++mUseCounter;
+}
+
+void CertificateValidationCache::RemoveRoot(const P256PublicKeySpan & rootPublicKey)
+{
+    std::lock_guard<System::Mutex> lock(mLock);
+
+    for (auto & entry : mEntries)
+    {
+        if (entry.inUse && memcmp(entry.rootPublicKey, rootPublicKey.data(), sizeof(entry.rootPublicKey)) == 0)
+        {
+            entry.inUse = false;
+        }
+    }
+}
+
+void CertificateValidationCache::Clear()
+{
+    std::lock_guard<System::Mutex> lock(mLock);
+
+    for (auto & entry : mEntries)
+    {
+        entry.inUse = false;
+    }
+    mUseCounter = 0;
+    mStats      = Stats();
+}
+
+CertificateValidationCache::Stats CertificateValidationCache::GetStats()
+{
+    std::lock_guard<System::Mutex> lock(mLock);
+    return mStats;
+}
+
+} // namespace Credentials
+} // namespace chip
@@ -0,0 +1,110 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @brief Defines a bounded cache of intermediate certificates whose signature was already verified.
+ */
+
+#pragma once
+
+#include <credentials/CHIPCert.h>
+#include <crypto/CHIPCryptoPAL.h>
+#include <lib/core/CHIPConfig.h>
+#include <lib/core/CHIPError.h>
+#include <lib/support/Span.h>
+#include <system/SystemMutex.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+namespace Credentials {
+
+/**
+ * Remembers which ICACs have a signature that verified against a given root public key.
+ *
+ * Every CASE handshake validates the peer's NOC -> ICAC -> RCAC chain, which costs one ECDSA verification per
+ * signed certificate.  The ICAC is usually the same across handshakes on a fabric, so when a ValidationContext
+ * points at a cache, FabricTable::VerifyCredentials verifies the ICAC signature only the first time it sees that
+ * ICAC under that root.
+ *
+ * Only the signature result is cached: validity periods, key usages and the certificate validity policy are
+ * still evaluated on every validation.  Entries are keyed by the SHA-256 of the ICAC in CHIP TLV form together
+ * with the root public key, so a changed ICAC or a rotated root never matches an old entry.  The least recently
+ * used entry is evicted when the cache is full.
+ *
+ * The cache is safe to use from several threads, e.g. from CASE verification running on a CryptoWorkQueue.
+ */
+class CertificateValidationCache
+{
+public:
+    static constexpr size_t kCapacity = CHIP_CONFIG_CERTIFICATE_VALIDATION_CACHE_SIZE;
+
+    using Digest = uint8_t[Crypto::kSHA256_Hash_Length];
+
+    struct Stats
+    {
+        uint32_t hits      = 0;
+        uint32_t misses    = 0;
+        uint32_t evictions = 0;
+    };
+
+    CHIP_ERROR Init();
+
+    /**
+     * Compute the digest under which `icac` (CHIP TLV encoded) is cached.
+     */
+    static CHIP_ERROR ComputeDigest(const ByteSpan & icac, Digest & outDigest);
+
+    /**
+     * @return true if an ICAC with `icacDigest` was recorded as signed by `rootPublicKey`.
+     */
+    bool Contains(const P256PublicKeySpan & rootPublicKey, const Digest & icacDigest);
+
+    /**
+     * Record that the ICAC with `icacDigest` carries a valid signature by `rootPublicKey`.
+     */
+    void Insert(const P256PublicKeySpan & rootPublicKey, const Digest & icacDigest);
+
+    /**
+     * Drop every entry under `rootPublicKey`, e.g. when the fabric using that root is removed.
+     */
+    void RemoveRoot(const P256PublicKeySpan & rootPublicKey);
+
+    void Clear();
+
+    Stats GetStats();
+
+private:
+    struct Entry
+    {
+        bool inUse = false;
+        uint32_t lastUsed;
+        uint8_t rootPublicKey[Crypto::kP256_PublicKey_Length];
+        Digest icacDigest;
+    };
+
+    Entry * Find(const P256PublicKeySpan & rootPublicKey, const Digest & icacDigest);
+
+    System::Mutex mLock;
+    Entry mEntries[kCapacity];
+    uint32_t mUseCounter = 0;
+    Stats mStats;
+};
+
+} // namespace Credentials
+} // namespace chip
@@ -396,6 +396,30 @@ CHIP_ERROR FabricTable::VerifyCredentials(FabricIndex fabricIndex, const ByteSpa
                              outRootPublicKey);
 }
 
+CHIP_ERROR FabricTable::CheckICACSignatureWithCache(CertificateValidationCache & cache, const ByteSpan & icac,
+                                                    const ChipCertificateData & rcacData,
+                                                    BitFlags<CertDecodeFlags> & outIcacDecodeFlags)
+{
+    CertificateValidationCache::Digest icacDigest;
+    ReturnErrorOnFailure(CertificateValidationCache::ComputeDigest(icac, icacDigest));
+
+    if (!cache.Contains(rcacData.mPublicKey, icacDigest))
+    {
+        // Verify the ICAC signature against the root on its own so that the result can be remembered. If it does
+        // not verify, the full chain validation below fails with its usual error.
+        ChipCertificateData icacData;
+        ReturnErrorOnFailure(DecodeChipCert(icac, icacData, BitFlags<CertDecodeFlags>(CertDecodeFlags::kGenerateTBSHash)));
+        if (VerifyCertSignature(icacData, rcacData) != CHIP_NO_ERROR)
+        {
+            return CHIP_NO_ERROR;
+        }
+        cache.Insert(rcacData.mPublicKey, icacDigest);
+    }
+
+    outIcacDecodeFlags = BitFlags<CertDecodeFlags>(CertDecodeFlags::kSignatureVerified);
+    return CHIP_NO_ERROR;
+}
+
 CHIP_ERROR FabricTable::VerifyCredentials(const ByteSpan & noc, const ByteSpan & icac, const ByteSpan & rcac,
                                           ValidationContext & context, CompressedFabricId & outCompressedFabricId,
                                           FabricId & outFabricId, NodeId & outNodeId, Crypto::P256PublicKey & outNocPubkey,
@@ -414,7 +438,13 @@ CHIP_ERROR FabricTable::VerifyCredentials(const ByteSpan & noc, const ByteSpan &
 
     if (!icac.empty())
     {
-        ReturnErrorOnFailure(certificates.LoadCert(icac, BitFlags<CertDecodeFlags>(CertDecodeFlags::kGenerateTBSHash)));
+        BitFlags<CertDecodeFlags> icacDecodeFlags(CertDecodeFlags::kGenerateTBSHash);
+        if (context.mValidationCache != nullptr)
+        {
+            ReturnErrorOnFailure(CheckICACSignatureWithCache(*context.mValidationCache, icac, certificates.GetCertSet()[0],
+                                                             icacDecodeFlags));
+        }
+        ReturnErrorOnFailure(certificates.LoadCert(icac, icacDecodeFlags));
     }
 
     ReturnErrorOnFailure(certificates.LoadCert(noc, BitFlags<CertDecodeFlags>(CertDecodeFlags::kGenerateTBSHash)));
@@ -1009,6 +1039,15 @@ CHIP_ERROR FabricTable::Delete(FabricIndex fabricIndex)
         return CHIP_ERROR_NOT_FOUND;
     }
 
+    if (mCertificateValidationCache != nullptr)
+    {
+        Crypto::P256PublicKey rootPubkey;
+        if (fabricInfo->FetchRootPubkey(rootPubkey) == CHIP_NO_ERROR)
+        {
+            mCertificateValidationCache->RemoveRoot(P256PublicKeySpan(rootPubkey.ConstBytes()));
+        }
+    }
+
     // Since fabricIsInitialized was true, fabric is not null.
     fabricInfo->Reset();
 
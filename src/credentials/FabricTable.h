@@ -26,6 +26,7 @@
 #include <app/util/basic-types.h>
 #include <credentials/CHIPCert.h>
 #include <credentials/CHIPCertificateSet.h>
+#include <credentials/CertificateValidationCache.h>
 #include <credentials/CertificateValidityPolicy.h>
 #include <credentials/LastKnownGoodTime.h>
 #include <credentials/OperationalCertificateStore.h>
@@ -969,6 +970,15 @@ public:
                                         Credentials::ValidationContext & context, CompressedFabricId & outCompressedFabricId,
                                         FabricId & outFabricId, NodeId & outNodeId, Crypto::P256PublicKey & outNocPubkey,
                                         Crypto::P256PublicKey * outRootPublicKey = nullptr);
+
+    /**
+     * @brief Set the cache of verified ICAC signatures that session establishment should pass to VerifyCredentials
+     *        through its ValidationContext, or nullptr to always verify the full chain.  Entries for a fabric's
+     *        root are dropped when that fabric is deleted.
+     */
+    void SetCertificateValidationCache(Credentials::CertificateValidationCache * cache) { mCertificateValidationCache = cache; }
+    Credentials::CertificateValidationCache * GetCertificateValidationCache() const { return mCertificateValidationCache; }
+
     /**
      * @brief Enables FabricInfo instances to collide and reference the same logical fabric (i.e Root Public Key + FabricId).
      *
@@ -1186,6 +1196,12 @@ private:
                                                NodeId & outNodeId, Crypto::P256PublicKey & outNocPubkey,
                                                Crypto::P256PublicKey & outRootPubkey);
 
+    // Look the ICAC up in `cache`, verifying and recording its signature by the root on a miss. Sets
+    // `outIcacDecodeFlags` to kSignatureVerified when the signature is known good, and leaves it alone otherwise.
+    static CHIP_ERROR CheckICACSignatureWithCache(Credentials::CertificateValidationCache & cache, const ByteSpan & icac,
+                                                  const Credentials::ChipCertificateData & rcacData,
+                                                  BitFlags<Credentials::CertDecodeFlags> & outIcacDecodeFlags);
+
     /**
      * Read our fabric index info from the given TLV reader and set up the
      * fabric table accordingly.
@@ -1219,6 +1235,8 @@ private:
 
     LastKnownGoodTime mLastKnownGoodTime;
 
+    Credentials::CertificateValidationCache * mCertificateValidationCache = nullptr;
+
     // We may not have an mNextAvailableFabricIndex if our table is as large as
     // it can go and is full.
     Optional<FabricIndex> mNextAvailableFabricIndex;
@@ -0,0 +1,113 @@
+/*
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @file
+ *   Measures how many peer credential validations per second CASE can do with and without a
+ *   CertificateValidationCache.  Each validation is what FabricTable::VerifyCredentials does for the
+ *   NOC -> ICAC -> RCAC chain a peer sends in Sigma2 or Sigma3; the ECDSA verification of the Sigma
+ *   signature itself is timed separately, so the two lines add up to the certificate work of a handshake.
+ *
+ *   Usage: certificate-validation-cache-benchmark [iterations]
+ */
+
+#include <credentials/CertificateValidationCache.h>
+#include <credentials/FabricTable.h>
+#include <credentials/tests/CHIPCert_test_vectors.h>
+#include <crypto/CHIPCryptoPAL.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/tests/BenchmarkHelpers.h>
+
+#include <stdlib.h>
+
+using namespace chip;
+using namespace chip::Credentials;
+using namespace chip::TestCerts;
+
+namespace {
+
+constexpr uint64_t kDefaultIterations = 2000;
+
+// 2021-01-01, inside the validity period of the test certificates.
+constexpr System::Clock::Seconds32 kValidUnixTime(1609459200);
+
+ByteSpan gRcac;
+ByteSpan gIcac;
+ByteSpan gNoc;
+
+bool ValidatePeerChain(CertificateValidationCache * cache)
+{
+    ValidationContext context;
+    context.Reset();
+    VerifyOrReturnValue(context.SetEffectiveTimeFromUnixTime<CurrentChipEpochTime>(kValidUnixTime) == CHIP_NO_ERROR, false);
+    context.mRequiredKeyUsages.Set(KeyUsageFlags::kDigitalSignature);
+    context.mRequiredKeyPurposes.Set(KeyPurposeFlags::kServerAuth);
+    context.mValidationCache = cache;
+
+    CompressedFabricId compressedFabricId;
+    FabricId fabricId;
+    NodeId nodeId;
+    Crypto::P256PublicKey nocPubkey;
+    return FabricTable::VerifyCredentials(gNoc, gIcac, gRcac, context, compressedFabricId, fabricId, nodeId, nocPubkey) ==
+        CHIP_NO_ERROR;
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+    const uint64_t iterations = (argc > 1) ? strtoull(argv[1], nullptr, 0) : kDefaultIterations;
+    VerifyOrReturnValue(Platform::MemoryInit() == CHIP_NO_ERROR, EXIT_FAILURE);
+
+    constexpr BitFlags<TestCertLoadFlags> loadFlags;
+    VerifyOrReturnValue(GetTestCert(kRoot01, loadFlags, gRcac) == CHIP_NO_ERROR, EXIT_FAILURE);
+    VerifyOrReturnValue(GetTestCert(kICA01, loadFlags, gIcac) == CHIP_NO_ERROR, EXIT_FAILURE);
+    VerifyOrReturnValue(GetTestCert(kNode01_01, loadFlags, gNoc) == CHIP_NO_ERROR, EXIT_FAILURE);
+
+    Test::PrintBenchmarkHeader();
+
+    Test::PrintBenchmarkResult(
+        Test::RunBenchmark("VerifyCredentials, no cache", iterations, [](uint64_t) { return ValidatePeerChain(nullptr); }));
+
+    CertificateValidationCache cache;
+    VerifyOrReturnValue(cache.Init() == CHIP_NO_ERROR, EXIT_FAILURE);
+
+    // Every validation after the first one finds the ICAC in the cache, as on a fabric that reuses its ICAC.
+    Test::PrintBenchmarkResult(
+        Test::RunBenchmark("VerifyCredentials, cache", iterations, [&](uint64_t) { return ValidatePeerChain(&cache); }));
+    VerifyOrReturnValue(iterations == 0 || cache.GetStats().misses == 1, EXIT_FAILURE);
+
+    // The worst case: the ICAC is never seen twice, so every validation misses.
+    Test::PrintBenchmarkResult(Test::RunBenchmark("VerifyCredentials, cache (always missing)", iterations, [&](uint64_t) {
+        cache.Clear();
+        return ValidatePeerChain(&cache);
+    }));
+
+    // The Sigma2/Sigma3 signature a handshake verifies on top of the chain.
+    Crypto::P256Keypair keypair;
+    Crypto::P256ECDSASignature signature;
+    const uint8_t message[] = "sigma tbs data";
+    VerifyOrReturnValue(keypair.Initialize(Crypto::ECPKeyTarget::ECDSA) == CHIP_NO_ERROR, EXIT_FAILURE);
+    VerifyOrReturnValue(keypair.ECDSA_sign_msg(message, sizeof(message), signature) == CHIP_NO_ERROR, EXIT_FAILURE);
+    Test::PrintBenchmarkResult(Test::RunBenchmark("P256 ECDSA verify (Sigma signature)", iterations, [&](uint64_t) {
+        return keypair.Pubkey().ECDSA_validate_msg_signature(message, sizeof(message), signature) == CHIP_NO_ERROR;
+    }));
+
+    Platform::MemoryShutdown();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,210 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <pw_unit_test/framework.h>
+
+#include <credentials/CertificateValidationCache.h>
+#include <credentials/FabricTable.h>
+#include <lib/core/StringBuilderAdapters.h>
+#include <lib/support/CHIPMem.h>
+
+#include "CHIPCert_test_vectors.h"
+
+#include <string.h>
+
+using namespace chip;
+using namespace chip::Credentials;
+using namespace chip::TestCerts;
+
+namespace {
+
+constexpr BitFlags<TestCertLoadFlags> sNullLoadFlag;
+
+// 2021-01-01, inside the validity period of all the test certificates used here.
+constexpr System::Clock::Seconds32 kValidUnixTime(1609459200);
+
+class TestCertificateValidationCache : public ::testing::Test
+{
+public:
+    static void SetUpTestSuite() { ASSERT_EQ(Platform::MemoryInit(), CHIP_NO_ERROR); }
+    static void TearDownTestSuite() { Platform::MemoryShutdown(); }
+
+    void SetUp() override { ASSERT_EQ(mCache.Init(), CHIP_NO_ERROR); }
+
+protected:
+    CertificateValidationCache mCache;
+};
+
+struct VerifyResult
+{
+    CHIP_ERROR err;
+    CompressedFabricId compressedFabricId;
+    FabricId fabricId;
+    NodeId nodeId;
+    Crypto::P256PublicKey nocPubkey;
+};
+
+VerifyResult Verify(TestCert rcacType, TestCert icacType, TestCert nocType, CertificateValidationCache * cache)
+{
+    ByteSpan rcac;
+    ByteSpan icac;
+    ByteSpan noc;
+    EXPECT_EQ(GetTestCert(rcacType, sNullLoadFlag, rcac), CHIP_NO_ERROR);
+    EXPECT_EQ(GetTestCert(icacType, sNullLoadFlag, icac), CHIP_NO_ERROR);
+    EXPECT_EQ(GetTestCert(nocType, sNullLoadFlag, noc), CHIP_NO_ERROR);
+
+    ValidationContext context;
+    context.Reset();
+    EXPECT_EQ(context.SetEffectiveTimeFromUnixTime<CurrentChipEpochTime>(kValidUnixTime), CHIP_NO_ERROR);
+    context.mRequiredKeyUsages.Set(KeyUsageFlags::kDigitalSignature);
+    context.mRequiredKeyPurposes.Set(KeyPurposeFlags::kServerAuth);
+    context.mValidationCache = cache;
+
+    VerifyResult result;
+    result.err = FabricTable::VerifyCredentials(noc, icac, rcac, context, result.compressedFabricId, result.fabricId,
+                                                result.nodeId, result.nocPubkey);
+    return result;
+}
+
+void MakeKey(uint8_t (&key)[Crypto::kP256_PublicKey_Length], uint8_t seed)
+{
+    memset(key, seed, sizeof(key));
+    key[0] = 0x04;
+}
+
+void MakeDigest(CertificateValidationCache::Digest & digest, uint8_t seed)
+{
+    memset(digest, seed, sizeof(digest));
+}
+
+TEST_F(TestCertificateValidationCache, TestInsertAndContains)
+{
+    uint8_t root1[Crypto::kP256_PublicKey_Length];
+    uint8_t root2[Crypto::kP256_PublicKey_Length];
+    MakeKey(root1, 1);
+    MakeKey(root2, 2);
+
+    CertificateValidationCache::Digest icac;
+    CertificateValidationCache::Digest otherIcac;
+    MakeDigest(icac, 0x11);
+    MakeDigest(otherIcac, 0x22);
+
+    EXPECT_FALSE(mCache.Contains(P256PublicKeySpan(root1), icac));
+    mCache.Insert(P256PublicKeySpan(root1), icac);
+    EXPECT_TRUE(mCache.Contains(P256PublicKeySpan(root1), icac));
+
+    // The same ICAC under another root, or another ICAC under the same root, is a different entry.
+    EXPECT_FALSE(mCache.Contains(P256PublicKeySpan(root2), icac));
+    EXPECT_FALSE(mCache.Contains(P256PublicKeySpan(root1), otherIcac));
+
+    CertificateValidationCache::Stats stats = mCache.GetStats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 3u);
+    EXPECT_EQ(stats.evictions, 0u);
+
+    mCache.Clear();
+    EXPECT_FALSE(mCache.Contains(P256PublicKeySpan(root1), icac));
+}
+
+TEST_F(TestCertificateValidationCache, TestEvictsLeastRecentlyUsed)
+{
+    uint8_t root[Crypto::kP256_PublicKey_Length];
+    MakeKey(root, 1);
+
+    CertificateValidationCache::Digest digests[CertificateValidationCache::kCapacity + 1];
+    for (size_t i = 0; i < CertificateValidationCache::kCapacity; ++i)
+    {
+        MakeDigest(digests[i], static_cast<uint8_t>(i + 1));
+        mCache.Insert(P256PublicKeySpan(root), digests[i]);
+    }
+
+    // Use the oldest entry so that the second oldest is the one to go.
+    EXPECT_TRUE(mCache.Contains(P256PublicKeySpan(root), digests[0]));
+
+    MakeDigest(digests[CertificateValidationCache::kCapacity], 0xFF);
+    mCache.Insert(P256PublicKeySpan(root), digests[CertificateValidationCache::kCapacity]);
+
+    EXPECT_EQ(mCache.GetStats().evictions, 1u);
+    EXPECT_TRUE(mCache.Contains(P256PublicKeySpan(root), digests[0]));
+    EXPECT_TRUE(mCache.Contains(P256PublicKeySpan(root), digests[CertificateValidationCache::kCapacity]));
+    if (CertificateValidationCache::kCapacity > 1)
+    {
+        EXPECT_FALSE(mCache.Contains(P256PublicKeySpan(root), digests[1]));
+    }
+}
+
+TEST_F(TestCertificateValidationCache, TestRemoveRoot)
+{
+    uint8_t root1[Crypto::kP256_PublicKey_Length];
+    uint8_t root2[Crypto::kP256_PublicKey_Length];
+    MakeKey(root1, 1);
+    MakeKey(root2, 2);
+
+    CertificateValidationCache::Digest icac;
+    MakeDigest(icac, 0x33);
+    mCache.Insert(P256PublicKeySpan(root1), icac);
+    mCache.Insert(P256PublicKeySpan(root2), icac);
+
+    mCache.RemoveRoot(P256PublicKeySpan(root1));
+    EXPECT_FALSE(mCache.Contains(P256PublicKeySpan(root1), icac));
+    EXPECT_TRUE(mCache.Contains(P256PublicKeySpan(root2), icac));
+}
+
+TEST_F(TestCertificateValidationCache, TestVerifyCredentialsWithCache)
+{
+    VerifyResult expected = Verify(kRoot01, kICA01, kNode01_01, nullptr);
+    ASSERT_EQ(expected.err, CHIP_NO_ERROR);
+
+    // The first validation verifies and records the ICAC, the second one finds it.
+    for (int i = 0; i < 2; ++i)
+    {
+        VerifyResult result = Verify(kRoot01, kICA01, kNode01_01, &mCache);
+        EXPECT_EQ(result.err, CHIP_NO_ERROR);
+        EXPECT_EQ(result.compressedFabricId, expected.compressedFabricId);
+        EXPECT_EQ(result.fabricId, expected.fabricId);
+        EXPECT_EQ(result.nodeId, expected.nodeId);
+        EXPECT_TRUE(result.nocPubkey.Matches(expected.nocPubkey));
+    }
+
+    CertificateValidationCache::Stats stats = mCache.GetStats();
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.hits, 1u);
+
+    ByteSpan icac;
+    ByteSpan rcacPubkey;
+    CertificateValidationCache::Digest icacDigest;
+    ASSERT_EQ(GetTestCert(kICA01, sNullLoadFlag, icac), CHIP_NO_ERROR);
+    ASSERT_EQ(GetTestCertPubkey(kRoot01, rcacPubkey), CHIP_NO_ERROR);
+    ASSERT_EQ(CertificateValidationCache::ComputeDigest(icac, icacDigest), CHIP_NO_ERROR);
+    EXPECT_TRUE(mCache.Contains(P256PublicKeySpan(rcacPubkey.data()), icacDigest));
+}
+
+TEST_F(TestCertificateValidationCache, TestVerifyCredentialsFailuresAreNotCached)
+{
+    // ICA01 is not signed by Root02.
+    EXPECT_NE(Verify(kRoot02, kICA01, kNode01_01, &mCache).err, CHIP_NO_ERROR);
+    EXPECT_NE(Verify(kRoot02, kICA01, kNode01_01, &mCache).err, CHIP_NO_ERROR);
+    EXPECT_EQ(mCache.GetStats().hits, 0u);
+    EXPECT_EQ(mCache.GetStats().misses, 2u);
+
+    // A cached ICAC does not vouch for a NOC it did not sign.
+    EXPECT_EQ(Verify(kRoot01, kICA01, kNode01_01, &mCache).err, CHIP_NO_ERROR);
+    EXPECT_NE(Verify(kRoot01, kICA01, kNode02_01, &mCache).err, CHIP_NO_ERROR);
+}
+
+} // namespace
@@ -21,6 +21,7 @@
  */
 
 #include "CHIPCryptoPAL.h"
+#include "CHIPCryptoPALInternal.h"
 
 #include "SessionKeystore.h"
 
@@ -31,10 +32,15 @@
 #include <lib/support/BufferWriter.h>
 #include <lib/support/BytesToHex.h>
 #include <lib/support/CodeUtils.h>
+#include <lib/support/ScopedBuffer.h>
 #include <lib/support/Span.h>
 #include <stdint.h>
 #include <string.h>
 
+#if CHIP_CRYPTO_MBEDTLS
+#include <mbedtls/version.h>
+#endif // CHIP_CRYPTO_MBEDTLS
+
 using chip::ByteSpan;
 using chip::MutableByteSpan;
 using chip::Encoding::BufferWriter;
@@ -775,6 +781,27 @@ CHIP_ERROR EcdsaAsn1SignatureToRaw(size_t fe_length_bytes, const ByteSpan & asn1
     return CHIP_NO_ERROR;
 }
 
+namespace Internal {
+
+bool BuildCCMCounterBlock(const uint8_t * nonce, size_t nonce_length, size_t message_length,
+                          uint8_t (&counter)[kAES_CCM128_Block_Length])
+{
+    VerifyOrReturnValue(nonce != nullptr && nonce_length >= 7 && nonce_length <= 13, false);
+
+    const size_t lengthSize = kAES_CCM128_Block_Length - 1 - nonce_length;
+    VerifyOrReturnValue(lengthSize >= sizeof(message_length) || (message_length >> (8 * lengthSize)) == 0, false);
+
+    counter[0] = static_cast<uint8_t>(lengthSize - 1);
+    memcpy(&counter[1], nonce, nonce_length);
+    memset(&counter[1 + nonce_length], 0, lengthSize);
+    counter[kAES_CCM128_Block_Length - 1] = 1;
+    return true;
+}
+
+} // namespace Internal
+
+#if !(CHIP_CRYPTO_OPENSSL || CHIP_CRYPTO_BORINGSSL || CHIP_CRYPTO_MBEDTLS)
+// OpenSSL and mbedTLS run AES-CTR directly; the other backends only expose AES-CCM.
 CHIP_ERROR AES_CTR_crypt(const uint8_t * input, size_t input_length, const Aes128KeyHandle & key, const uint8_t * nonce,
                          size_t nonce_length, uint8_t * output)
 {
@@ -784,6 +811,105 @@ CHIP_ERROR AES_CTR_crypt(const uint8_t * input, size_t input_length, const Aes12
 
     return AES_CCM_encrypt(input, input_length, nullptr, 0, key, nonce, nonce_length, output, tag, kTagLen);
 }
+#endif // !(CHIP_CRYPTO_OPENSSL || CHIP_CRYPTO_BORINGSSL || CHIP_CRYPTO_MBEDTLS)
+
+#if CHIP_CRYPTO_OPENSSL || CHIP_CRYPTO_BORINGSSL || CHIP_CRYPTO_PLATFORM ||                                                        \
+    (CHIP_CRYPTO_MBEDTLS && MBEDTLS_VERSION_NUMBER < 0x03000000)
+
+// These backends have no incremental AES-CCM, so the buffers are gathered into a contiguous copy
+// that is secured in one go and then scattered back. OpenSSL could build CCM from its incremental
+// CBC and CTR modes, but that runs the data twice and loses to its one-shot CCM plus the copy.
+
+namespace {
+
+size_t GatherBuffers(const MutableByteSpan * buffers, size_t buffer_count, uint8_t * out)
+{
+    size_t length = 0;
+    for (size_t i = 0; i < buffer_count; i++)
+    {
+        if (out != nullptr && !buffers[i].empty())
+        {
+            memcpy(out + length, buffers[i].data(), buffers[i].size());
+        }
+        length += buffers[i].size();
+    }
+    return length;
+}
+
+void ScatterBuffers(const uint8_t * in, const MutableByteSpan * buffers, size_t buffer_count)
+{
+    for (size_t i = 0; i < buffer_count; i++)
+    {
+        if (!buffers[i].empty())
+        {
+            memcpy(buffers[i].data(), in, buffers[i].size());
+            in += buffers[i].size();
+        }
+    }
+}
+
+} // namespace
+
+CHIP_ERROR AES_CCM_encrypt_buffers(const MutableByteSpan * buffers, size_t buffer_count, const uint8_t * aad, size_t aad_length,
+                                   const Aes128KeyHandle & key, const uint8_t * nonce, size_t nonce_length, uint8_t * tag,
+                                   size_t tag_length)
+{
+    VerifyOrReturnError(buffers != nullptr || buffer_count == 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    const size_t length = GatherBuffers(buffers, buffer_count, nullptr);
+    if (length == 0)
+    {
+        return AES_CCM_encrypt(nullptr, 0, aad, aad_length, key, nonce, nonce_length, nullptr, tag, tag_length);
+    }
+
+    Platform::ScopedMemoryBuffer<uint8_t> message;
+    VerifyOrReturnError(message.Alloc(length), CHIP_ERROR_NO_MEMORY);
+    GatherBuffers(buffers, buffer_count, message.Get());
+
+    CHIP_ERROR err =
+        AES_CCM_encrypt(message.Get(), length, aad, aad_length, key, nonce, nonce_length, message.Get(), tag, tag_length);
+    if (err == CHIP_NO_ERROR)
+    {
+        ScatterBuffers(message.Get(), buffers, buffer_count);
+    }
+    ClearSecretData(message.Get(), length);
+    return err;
+}
+
+CHIP_ERROR AES_CCM_decrypt_buffers(const MutableByteSpan * buffers, size_t buffer_count, const uint8_t * aad, size_t aad_length,
+                                   const uint8_t * tag, size_t tag_length, const Aes128KeyHandle & key, const uint8_t * nonce,
+                                   size_t nonce_length)
+{
+    VerifyOrReturnError(buffers != nullptr || buffer_count == 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    const size_t length = GatherBuffers(buffers, buffer_count, nullptr);
+    if (length == 0)
+    {
+        return AES_CCM_decrypt(nullptr, 0, aad, aad_length, tag, tag_length, key, nonce, nonce_length, nullptr);
+    }
+
+    Platform::ScopedMemoryBuffer<uint8_t> message;
+    VerifyOrReturnError(message.Alloc(length), CHIP_ERROR_NO_MEMORY);
+    GatherBuffers(buffers, buffer_count, message.Get());
+
+    CHIP_ERROR err =
+        AES_CCM_decrypt(message.Get(), length, aad, aad_length, tag, tag_length, key, nonce, nonce_length, message.Get());
+    if (err == CHIP_NO_ERROR)
+    {
+        ScatterBuffers(message.Get(), buffers, buffer_count);
+    }
+    else
+    {
+        for (size_t i = 0; i < buffer_count; i++)
+        {
+            ClearSecretData(buffers[i].data(), buffers[i].size());
+        }
+    }
+    ClearSecretData(message.Get(), length);
+    return err;
+}
+
+#endif // CHIP_CRYPTO_OPENSSL || CHIP_CRYPTO_BORINGSSL || CHIP_CRYPTO_PLATFORM || CHIP_CRYPTO_MBEDTLS
 
 CHIP_ERROR GenerateCompressedFabricId(const Crypto::P256PublicKey & root_public_key, uint64_t fabric_id,
                                       MutableByteSpan & out_compressed_fabric_id)
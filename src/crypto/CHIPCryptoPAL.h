@@ -786,6 +786,50 @@ CHIP_ERROR AES_CCM_decrypt(const uint8_t * ciphertext, size_t ciphertext_length,
                            const uint8_t * tag, size_t tag_length, const Aes128KeyHandle & key, const uint8_t * nonce,
                            size_t nonce_length, uint8_t * plaintext);
 
+/**
+ * @brief A function that implements AES-CCM encryption of a message held in several buffers
+ *
+ * Same as AES_CCM_encrypt(), with the plaintext being the concatenation of the given buffers.
+ * Each buffer is encrypted in place, so a message spread over a buffer chain can be secured
+ * without copying it into a contiguous buffer first.
+ *
+ * @param buffers Buffers holding the plaintext, in order. Replaced with the ciphertext.
+ * @param buffer_count Number of buffers
+ * @param aad Additional authentication data
+ * @param aad_length Length of additional authentication data
+ * @param key Encryption key
+ * @param nonce Encryption nonce
+ * @param nonce_length Length of encryption nonce
+ * @param tag Buffer to write tag into. Caller must ensure this is large enough to hold the tag
+ * @param tag_length Expected length of tag
+ * @return Returns a CHIP_ERROR on error, CHIP_NO_ERROR otherwise
+ * */
+CHIP_ERROR AES_CCM_encrypt_buffers(const MutableByteSpan * buffers, size_t buffer_count, const uint8_t * aad, size_t aad_length,
+                                   const Aes128KeyHandle & key, const uint8_t * nonce, size_t nonce_length, uint8_t * tag,
+                                   size_t tag_length);
+
+/**
+ * @brief A function that implements AES-CCM decryption of a message held in several buffers
+ *
+ * Same as AES_CCM_decrypt(), with the ciphertext being the concatenation of the given buffers,
+ * each of which is decrypted in place. If the tag does not match, the buffers are cleared so
+ * that no unauthenticated plaintext is left behind.
+ *
+ * @param buffers Buffers holding the ciphertext, in order. Replaced with the plaintext.
+ * @param buffer_count Number of buffers
+ * @param aad Additional authentical data.
+ * @param aad_length Length of additional authentication data
+ * @param tag Tag to use to decrypt
+ * @param tag_length Length of tag
+ * @param key Decryption key
+ * @param nonce Encryption nonce
+ * @param nonce_length Length of encryption nonce
+ * @return Returns a CHIP_ERROR on error, CHIP_NO_ERROR otherwise
+ **/
+CHIP_ERROR AES_CCM_decrypt_buffers(const MutableByteSpan * buffers, size_t buffer_count, const uint8_t * aad, size_t aad_length,
+                                   const uint8_t * tag, size_t tag_length, const Aes128KeyHandle & key, const uint8_t * nonce,
+                                   size_t nonce_length);
+
 /**
  * @brief A function that implements AES-CTR encryption/decryption
  *
@@ -0,0 +1,47 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Helpers shared by the crypto PAL backends. These are not part of the
+ *      public CHIPCryptoPAL interface.
+ */
+
+#pragma once
+
+#include "CHIPCryptoPAL.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+namespace Crypto {
+namespace Internal {
+
+/**
+ * Build the counter block of the first message block of AES-CCM (A_1 in RFC 3610), so that plain
+ * AES-CTR produces the key stream AES-CCM would apply to the message.
+ *
+ * @return false if the nonce length is not valid for AES-CCM, or if message_length does not fit the
+ *         length field that the nonce leaves room for.
+ */
+bool BuildCCMCounterBlock(const uint8_t * nonce, size_t nonce_length, size_t message_length,
+                          uint8_t (&counter)[kAES_CCM128_Block_Length]);
+
+} // namespace Internal
+} // namespace Crypto
+} // namespace chip
@@ -21,6 +21,7 @@
  */
 
 #include "CHIPCryptoPAL.h"
+#include "CHIPCryptoPALInternal.h"
 
 #include <type_traits>
 
@@ -65,7 +66,6 @@ namespace Crypto {
 #if CHIP_CRYPTO_BORINGSSL
 #define RAND_priv_bytes RAND_bytes
 #define BN_CTX_secure_new BN_CTX_new
-#define EC_GROUP_clear_free EC_GROUP_free
 using boringssl_size_t_openssl_int = size_t;
 using boringssl_uint_openssl_int   = unsigned int;
 using libssl_err_type              = uint32_t;
@@ -104,6 +104,149 @@ static int _nidForCurve(ECName name)
     }
 }
 
+// Returns the group for the curve, which is built once and shared: a group is never modified after it
+// has been created, so it can be used by several threads at once.  Must not be freed.
+static const EC_GROUP * _groupForCurve(ECName name)
+{
+    switch (name)
+    {
+    case ECName::P256v1: {
+        static const EC_GROUP * const sP256Group = EC_GROUP_new_by_curve_name(_nidForCurve(name));
+        return sP256Group;
+    }
+
+    default:
+        return nullptr;
+    }
+}
+
+// Unlike EC_KEY_new_by_curve_name(), which builds the curve parameters from scratch for every key,
+// copies them from the shared group.
+static EC_KEY * _newECKey(const EC_GROUP * group)
+{
+    EC_KEY * ec_key = EC_KEY_new();
+    if (ec_key != nullptr && EC_KEY_set_group(ec_key, group) != 1)
+    {
+        EC_KEY_free(ec_key);
+        ec_key = nullptr;
+    }
+    return ec_key;
+}
+
+namespace {
+
+// Scratch state that the P-256 operations reuse instead of allocating on every call.  It is kept per
+// thread, as neither a BN_CTX nor an EC_KEY may be used by two threads at once.
+class P256ThreadContext
+{
+public:
+    ~P256ThreadContext()
+    {
+        for (CachedKey & cached : mKeys)
+        {
+            EC_KEY_free(cached.mKey);
+        }
+        BN_CTX_free(mBnCtx);
+    }
+
+    BN_CTX * BnCtx()
+    {
+        if (mBnCtx == nullptr)
+        {
+            mBnCtx = BN_CTX_new();
+        }
+        return mBnCtx;
+    }
+
+    // Returns an EC_KEY for the public key on the group that has passed EC_KEY_check_key(), or nullptr.
+    // The caller owns a reference and must free it.
+    //
+    // Checking a key costs a scalar multiplication, more than verifying the signature itself, and
+    // CASE verifies signatures against the same ICA, root and operational keys over and over, so the
+    // most recently used keys are kept checked.
+    EC_KEY * GetValidatedKey(const EC_GROUP * ec_group, const P256PublicKey & key)
+    {
+        size_t index = 0;
+        while (index < kCachedKeyCount && mKeys[index].mKey != nullptr &&
+               memcmp(mKeys[index].mPoint, key.ConstBytes(), sizeof(mKeys[index].mPoint)) != 0)
+        {
+            index++;
+        }
+
+        CachedKey found;
+        if (index < kCachedKeyCount && mKeys[index].mKey != nullptr)
+        {
+            found = mKeys[index];
+        }
+        else
+        {
+            VerifyOrReturnValue(NewValidatedKey(ec_group, key, found.mKey) == CHIP_NO_ERROR, nullptr);
+            memcpy(found.mPoint, key.ConstBytes(), sizeof(found.mPoint));
+
+            index = kCachedKeyCount - 1;
+            EC_KEY_free(mKeys[index].mKey);
+        }
+
+        // Keep the entries in most recently used order.
+        for (; index > 0; index--)
+        {
+            mKeys[index] = mKeys[index - 1];
+        }
+        mKeys[0] = found;
+
+        EC_KEY_up_ref(found.mKey);
+        return found.mKey;
+    }
+
+private:
+    struct CachedKey
+    {
+        uint8_t mPoint[kP256_PublicKey_Length];
+        EC_KEY * mKey = nullptr;
+    };
+
+    static constexpr size_t kCachedKeyCount = 4;
+
+    CHIP_ERROR NewValidatedKey(const EC_GROUP * ec_group, const P256PublicKey & key, EC_KEY *& out_key)
+    {
+        CHIP_ERROR error     = CHIP_ERROR_INTERNAL;
+        EC_KEY * ec_key      = nullptr;
+        EC_POINT * key_point = nullptr;
+        int result           = 0;
+
+        key_point = EC_POINT_new(ec_group);
+        VerifyOrExit(key_point != nullptr, error = CHIP_ERROR_NO_MEMORY);
+
+        result = EC_POINT_oct2point(ec_group, key_point, Uint8::to_const_uchar(key), key.Length(), BnCtx());
+        VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+        ec_key = _newECKey(ec_group);
+        VerifyOrExit(ec_key != nullptr, error = CHIP_ERROR_NO_MEMORY);
+
+        result = EC_KEY_set_public_key(ec_key, key_point);
+        VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+        result = EC_KEY_check_key(ec_key);
+        VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+        out_key = ec_key;
+        ec_key  = nullptr;
+        error   = CHIP_NO_ERROR;
+
+    exit:
+        EC_KEY_free(ec_key);
+        EC_POINT_clear_free(key_point);
+        return error;
+    }
+
+    BN_CTX * mBnCtx = nullptr;
+    CachedKey mKeys[kCachedKeyCount];
+};
+
+thread_local P256ThreadContext sP256ThreadContext;
+
+} // namespace
+
 static void _logSSLError()
 {
     unsigned long ssl_err_code = ERR_get_error();
@@ -411,6 +554,46 @@ exit:
     return error;
 }
 
+CHIP_ERROR AES_CTR_crypt(const uint8_t * input, size_t input_length, const Aes128KeyHandle & key, const uint8_t * nonce,
+                         size_t nonce_length, uint8_t * output)
+{
+    CHIP_ERROR error         = CHIP_NO_ERROR;
+    EVP_CIPHER_CTX * context = nullptr;
+    int bytesWritten         = 0;
+    int result               = 1;
+    uint8_t counter[kAES_CCM128_Block_Length];
+
+    VerifyOrExit(input != nullptr || input_length == 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(output != nullptr || input_length == 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(CanCastTo<int>(input_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(Internal::BuildCCMCounterBlock(nonce, nonce_length, input_length, counter), error = CHIP_ERROR_INVALID_ARGUMENT);
+
+    if (input_length > 0)
+    {
+        context = EVP_CIPHER_CTX_new();
+        VerifyOrExit(context != nullptr, error = CHIP_ERROR_NO_MEMORY);
+
+        // A single CTR pass, which OpenSSL runs with AES-NI or the ARMv8 AES instructions where the CPU has them.
+        static_assert(kAES_CCM128_Key_Length == sizeof(Symmetric128BitsKeyByteArray), "Unexpected key length");
+        result = EVP_EncryptInit_ex(context, EVP_aes_128_ctr(), nullptr, key.As<Symmetric128BitsKeyByteArray>(), counter);
+        VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+        result = EVP_EncryptUpdate(context, Uint8::to_uchar(output), &bytesWritten, Uint8::to_const_uchar(input),
+                                   static_cast<int>(input_length));
+        VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+        VerifyOrExit(bytesWritten == static_cast<int>(input_length), error = CHIP_ERROR_INTERNAL);
+    }
+
+exit:
+    if (context != nullptr)
+    {
+        EVP_CIPHER_CTX_free(context);
+        context = nullptr;
+    }
+
+    return error;
+}
+
 CHIP_ERROR Hash_SHA256(const uint8_t * data, const size_t data_length, uint8_t * out_buffer)
 {
     // zero data length hash is supported.
@@ -817,39 +1000,22 @@ CHIP_ERROR P256PublicKey::ECDSA_validate_hash_signature(const uint8_t * hash, co
 {
     ERR_clear_error();
     CHIP_ERROR error     = CHIP_ERROR_INTERNAL;
-    int nid              = NID_undef;
-    EC_KEY * ec_key      = nullptr;
-    EC_POINT * key_point = nullptr;
-    EC_GROUP * ec_group  = nullptr;
-    ECDSA_SIG * ec_sig   = nullptr;
-    BIGNUM * r           = nullptr;
-    BIGNUM * s           = nullptr;
-    int result           = 0;
+    const EC_GROUP * ec_group = nullptr;
+    EC_KEY * ec_key           = nullptr;
+    ECDSA_SIG * ec_sig        = nullptr;
+    BIGNUM * r                = nullptr;
+    BIGNUM * s                = nullptr;
+    int result                = 0;
 
     VerifyOrExit(hash != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
     VerifyOrExit(hash_length == kSHA256_Hash_Length, error = CHIP_ERROR_INVALID_ARGUMENT);
     VerifyOrExit(signature.Length() == kP256_ECDSA_Signature_Length_Raw, error = CHIP_ERROR_INVALID_ARGUMENT);
 
-    nid = _nidForCurve(MapECName(Type()));
-    VerifyOrExit(nid != NID_undef, error = CHIP_ERROR_INVALID_ARGUMENT);
-
-    ec_group = EC_GROUP_new_by_curve_name(nid);
-    VerifyOrExit(ec_group != nullptr, error = CHIP_ERROR_NO_MEMORY);
-
-    key_point = EC_POINT_new(ec_group);
-    VerifyOrExit(key_point != nullptr, error = CHIP_ERROR_NO_MEMORY);
-
-    result = EC_POINT_oct2point(ec_group, key_point, Uint8::to_const_uchar(*this), Length(), nullptr);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
-
-    ec_key = EC_KEY_new_by_curve_name(nid);
-    VerifyOrExit(ec_key != nullptr, error = CHIP_ERROR_NO_MEMORY);
-
-    result = EC_KEY_set_public_key(ec_key, key_point);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    ec_group = _groupForCurve(MapECName(Type()));
+    VerifyOrExit(ec_group != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
 
-    result = EC_KEY_check_key(ec_key);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    ec_key = sP256ThreadContext.GetValidatedKey(ec_group, *this);
+    VerifyOrExit(ec_key != nullptr, error = CHIP_ERROR_INTERNAL);
 
     // Build-up the signature object from raw <r,s> tuple
     r = BN_bin2bn(Uint8::to_const_uchar(signature.ConstBytes()) + 0u, kP256_FE_Length, nullptr);
@@ -891,14 +1057,6 @@ exit:
     {
         EC_KEY_free(ec_key);
     }
-    if (key_point != nullptr)
-    {
-        EC_POINT_clear_free(key_point);
-    }
-    if (ec_group != nullptr)
-    {
-        EC_GROUP_free(ec_group);
-    }
     return error;
 }
 
@@ -906,28 +1064,24 @@ exit:
 static CHIP_ERROR _create_evp_key_from_binary_p256_key(const P256PublicKey & key, EVP_PKEY ** out_evp_pkey)
 {
 
-    CHIP_ERROR error = CHIP_NO_ERROR;
-    EC_KEY * ec_key  = nullptr;
-    int result       = -1;
-    EC_POINT * point = nullptr;
-    EC_GROUP * group = nullptr;
-    int nid          = NID_undef;
+    CHIP_ERROR error       = CHIP_NO_ERROR;
+    EC_KEY * ec_key        = nullptr;
+    int result             = -1;
+    EC_POINT * point       = nullptr;
+    const EC_GROUP * group = nullptr;
 
     VerifyOrExit(*out_evp_pkey == nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
 
-    nid = _nidForCurve(MapECName(key.Type()));
-    VerifyOrExit(nid != NID_undef, error = CHIP_ERROR_INTERNAL);
+    group = _groupForCurve(MapECName(key.Type()));
+    VerifyOrExit(group != nullptr, error = CHIP_ERROR_INTERNAL);
 
-    ec_key = EC_KEY_new_by_curve_name(nid);
+    ec_key = _newECKey(group);
     VerifyOrExit(ec_key != nullptr, error = CHIP_ERROR_INTERNAL);
 
-    group = EC_GROUP_new_by_curve_name(nid);
-    VerifyOrExit(group != nullptr, error = CHIP_ERROR_INTERNAL);
-
     point = EC_POINT_new(group);
     VerifyOrExit(point != nullptr, error = CHIP_ERROR_INTERNAL);
 
-    result = EC_POINT_oct2point(group, point, Uint8::to_const_uchar(key), key.Length(), nullptr);
+    result = EC_POINT_oct2point(group, point, Uint8::to_const_uchar(key), key.Length(), sP256ThreadContext.BnCtx());
     VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
 
     result = EC_KEY_set_public_key(ec_key, point);
@@ -959,12 +1113,6 @@ exit:
         point = nullptr;
     }
 
-    if (group != nullptr)
-    {
-        EC_GROUP_free(group);
-        group = nullptr;
-    }
-
     return error;
 }
 
@@ -979,15 +1127,13 @@ CHIP_ERROR P256Keypair::ECDH_derive_secret(const P256PublicKey & remote_public_k
     EVP_PKEY_CTX * context = nullptr;
     size_t out_buf_length  = 0;
 
-    EC_KEY * ec_key = EC_KEY_dup(to_const_EC_KEY(&mKeypair));
-    VerifyOrExit(ec_key != nullptr, error = CHIP_ERROR_INTERNAL);
-
     VerifyOrExit(mInitialized, error = CHIP_ERROR_UNINITIALIZED);
 
     local_key = EVP_PKEY_new();
     VerifyOrExit(local_key != nullptr, error = CHIP_ERROR_INTERNAL);
 
-    result = EVP_PKEY_set1_EC_KEY(local_key, ec_key);
+    // Takes a reference to the key rather than a copy of it.
+    result = EVP_PKEY_set1_EC_KEY(local_key, to_EC_KEY(&mKeypair));
     VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
 
     error = _create_evp_key_from_binary_p256_key(remote_public_key, &remote_key);
@@ -1008,12 +1154,6 @@ CHIP_ERROR P256Keypair::ECDH_derive_secret(const P256PublicKey & remote_public_k
     SuccessOrExit(error = out_secret.SetLength(out_buf_length));
 
 exit:
-    if (ec_key != nullptr)
-    {
-        EC_KEY_free(ec_key);
-        ec_key = nullptr;
-    }
-
     if (local_key != nullptr)
     {
         EVP_PKEY_free(local_key);
@@ -1051,33 +1191,21 @@ static CHIP_ERROR P256PublicKeyFromECKey(EC_KEY * ec_key, P256PublicKey & pubkey
     ERR_clear_error();
     CHIP_ERROR error = CHIP_NO_ERROR;
 
-    int nid            = NID_undef;
-    ECName curve       = MapECName(pubkey.Type());
-    EC_GROUP * group   = nullptr;
-    size_t pubkey_size = 0;
+    const EC_GROUP * group = _groupForCurve(MapECName(pubkey.Type()));
+    size_t pubkey_size     = 0;
 
     const EC_POINT * pubkey_ecp = EC_KEY_get0_public_key(ec_key);
     VerifyOrExit(pubkey_ecp != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
 
-    nid = _nidForCurve(curve);
-    VerifyOrExit(nid != NID_undef, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(group != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
 
-    group = EC_GROUP_new_by_curve_name(nid);
-    VerifyOrExit(group != nullptr, error = CHIP_ERROR_INTERNAL);
-
-    pubkey_size =
-        EC_POINT_point2oct(group, pubkey_ecp, POINT_CONVERSION_UNCOMPRESSED, Uint8::to_uchar(pubkey), pubkey.Length(), nullptr);
+    pubkey_size = EC_POINT_point2oct(group, pubkey_ecp, POINT_CONVERSION_UNCOMPRESSED, Uint8::to_uchar(pubkey), pubkey.Length(),
+                                     sP256ThreadContext.BnCtx());
     pubkey_ecp = nullptr;
 
     VerifyOrExit(pubkey_size == pubkey.Length(), error = CHIP_ERROR_INVALID_ARGUMENT);
 
 exit:
-    if (group != nullptr)
-    {
-        EC_GROUP_free(group);
-        group = nullptr;
-    }
-
     _logSSLError();
     return error;
 }
@@ -1093,10 +1221,10 @@ CHIP_ERROR P256Keypair::Initialize(ECPKeyTarget key_target)
     EC_KEY * ec_key  = nullptr;
     ECName curve     = MapECName(mPublicKey.Type());
 
-    int nid = _nidForCurve(curve);
-    VerifyOrExit(nid != NID_undef, error = CHIP_ERROR_INVALID_ARGUMENT);
+    const EC_GROUP * group = _groupForCurve(curve);
+    VerifyOrExit(group != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
 
-    ec_key = EC_KEY_new_by_curve_name(nid);
+    ec_key = _newECKey(group);
     VerifyOrExit(ec_key != nullptr, error = CHIP_ERROR_INTERNAL);
 
     result = EC_KEY_generate_key(ec_key);
@@ -1158,9 +1286,9 @@ CHIP_ERROR P256Keypair::Deserialize(P256SerializedKeypair & input)
 
     Clear();
 
-    BIGNUM * pvt_key     = nullptr;
-    EC_GROUP * group     = nullptr;
-    EC_POINT * key_point = nullptr;
+    BIGNUM * pvt_key       = nullptr;
+    const EC_GROUP * group = nullptr;
+    EC_POINT * key_point   = nullptr;
 
     EC_KEY * ec_key = nullptr;
     ECName curve    = MapECName(mPublicKey.Type());
@@ -1168,7 +1296,6 @@ CHIP_ERROR P256Keypair::Deserialize(P256SerializedKeypair & input)
     ERR_clear_error();
     CHIP_ERROR error = CHIP_NO_ERROR;
     int result       = 0;
-    int nid          = NID_undef;
 
     const uint8_t * privkey = input.ConstBytes() + mPublicKey.Length();
 
@@ -1176,19 +1303,17 @@ CHIP_ERROR P256Keypair::Deserialize(P256SerializedKeypair & input)
     bbuf.Put(input.ConstBytes(), mPublicKey.Length());
     VerifyOrExit(bbuf.Fit(), error = CHIP_ERROR_NO_MEMORY);
 
-    nid = _nidForCurve(curve);
-    VerifyOrExit(nid != NID_undef, error = CHIP_ERROR_INVALID_ARGUMENT);
-
-    group = EC_GROUP_new_by_curve_name(nid);
-    VerifyOrExit(group != nullptr, error = CHIP_ERROR_INTERNAL);
+    group = _groupForCurve(curve);
+    VerifyOrExit(group != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
 
     key_point = EC_POINT_new(group);
     VerifyOrExit(key_point != nullptr, error = CHIP_ERROR_INTERNAL);
 
-    result = EC_POINT_oct2point(group, key_point, Uint8::to_const_uchar(mPublicKey), mPublicKey.Length(), nullptr);
+    result = EC_POINT_oct2point(group, key_point, Uint8::to_const_uchar(mPublicKey), mPublicKey.Length(),
+                                sP256ThreadContext.BnCtx());
     VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
 
-    ec_key = EC_KEY_new_by_curve_name(nid);
+    ec_key = _newECKey(group);
     VerifyOrExit(ec_key != nullptr, error = CHIP_ERROR_INTERNAL);
 
     result = EC_KEY_set_public_key(ec_key, key_point);
@@ -1211,12 +1336,6 @@ exit:
         ec_key = nullptr;
     }
 
-    if (group != nullptr)
-    {
-        EC_GROUP_free(group);
-        group = nullptr;
-    }
-
     if (pvt_key != nullptr)
     {
         BN_free(pvt_key);
@@ -1398,7 +1517,7 @@ exit:
 
 typedef struct Spake2p_Context
 {
-    EC_GROUP * curve;
+    const EC_GROUP * curve;
     BN_CTX * bn_ctx;
     const EVP_MD * md_info;
 } Spake2p_Context;
@@ -1416,7 +1535,7 @@ CHIP_ERROR Spake2p_P256_SHA256_HKDF_HMAC::InitInternal()
     context->bn_ctx  = nullptr;
     context->md_info = nullptr;
 
-    context->curve = EC_GROUP_new_by_curve_name(NID_X9_62_prime256v1);
+    context->curve = _groupForCurve(ECName::P256v1);
     VerifyOrReturnError(context->curve != nullptr, CHIP_ERROR_INTERNAL);
 
     G = EC_GROUP_get0_generator(context->curve);
@@ -1453,11 +1572,7 @@ void Spake2p_P256_SHA256_HKDF_HMAC::Clear()
 
     Spake2p_Context * const context = to_inner_spake2p_context(&mSpake2pContext);
 
-    if (context->curve != nullptr)
-    {
-        EC_GROUP_clear_free(context->curve);
-    }
-
+    // The curve is the shared P-256 group, which is not freed.
     if (context->bn_ctx != nullptr)
     {
         BN_CTX_free(context->bn_ctx);
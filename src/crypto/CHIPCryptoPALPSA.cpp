@@ -58,6 +58,102 @@ bool isValidTag(const uint8_t * tag, size_t tag_length)
     return tag != nullptr && (tag_length == 8 || tag_length == 12 || tag_length == 16);
 }
 
+bool isValidBufferList(const MutableByteSpan * buffers, size_t buffer_count)
+{
+    VerifyOrReturnValue(buffers != nullptr || buffer_count == 0, false);
+    for (size_t i = 0; i < buffer_count; i++)
+    {
+        VerifyOrReturnValue(buffers[i].data() != nullptr || buffers[i].empty(), false);
+    }
+    return true;
+}
+
+/**
+ * Writes the output of an AEAD operation back over the buffers its input was read from.
+ *
+ * The output may lag behind the input, but never gets ahead of it, so the buffers can be
+ * processed in place.
+ */
+class BufferListWriter
+{
+public:
+    BufferListWriter(const MutableByteSpan * buffers, size_t buffer_count) : mBuffers(buffers), mBufferCount(buffer_count) {}
+
+    bool Write(const uint8_t * data, size_t length)
+    {
+        while (length > 0)
+        {
+            VerifyOrReturnValue(mIndex < mBufferCount, false);
+
+            const size_t chunk = std::min(length, mBuffers[mIndex].size() - mOffset);
+            if (chunk > 0)
+            {
+                memcpy(mBuffers[mIndex].data() + mOffset, data, chunk);
+            }
+            data += chunk;
+            length -= chunk;
+            mOffset += chunk;
+
+            if (mOffset == mBuffers[mIndex].size())
+            {
+                mIndex++;
+                mOffset = 0;
+            }
+        }
+        return true;
+    }
+
+private:
+    const MutableByteSpan * mBuffers;
+    size_t mBufferCount;
+    size_t mIndex  = 0;
+    size_t mOffset = 0;
+};
+
+CHIP_ERROR updateBuffers(psa_aead_operation_t & operation, const MutableByteSpan * buffers, size_t buffer_count,
+                         const uint8_t * aad, size_t aad_length, const uint8_t * nonce, size_t nonce_length,
+                         BufferListWriter & writer)
+{
+    // Input is fed in chunks so that the output, which may include data held back from earlier
+    // chunks, fits a small buffer.
+    constexpr size_t kChunkLength = 128;
+    uint8_t output[PSA_AEAD_UPDATE_OUTPUT_MAX_SIZE(kChunkLength)];
+    size_t messageLength = 0;
+    size_t outLength;
+    psa_status_t status;
+
+    for (size_t i = 0; i < buffer_count; i++)
+    {
+        messageLength += buffers[i].size();
+    }
+
+    status = psa_aead_set_lengths(&operation, aad_length, messageLength);
+    VerifyOrReturnError(status == PSA_SUCCESS, CHIP_ERROR_INTERNAL);
+
+    status = psa_aead_set_nonce(&operation, nonce, nonce_length);
+    VerifyOrReturnError(status == PSA_SUCCESS, CHIP_ERROR_INTERNAL);
+
+    if (aad_length != 0)
+    {
+        status = psa_aead_update_ad(&operation, aad, aad_length);
+        VerifyOrReturnError(status == PSA_SUCCESS, CHIP_ERROR_INTERNAL);
+    }
+
+    for (size_t i = 0; i < buffer_count; i++)
+    {
+        for (size_t offset = 0; offset < buffers[i].size(); offset += kChunkLength)
+        {
+            const size_t chunk = std::min(kChunkLength, buffers[i].size() - offset);
+
+            status = psa_aead_update(&operation, buffers[i].data() + offset, chunk, output, sizeof(output), &outLength);
+            VerifyOrReturnError(status == PSA_SUCCESS, CHIP_ERROR_INTERNAL);
+            VerifyOrReturnError(writer.Write(output, outLength), CHIP_ERROR_INTERNAL);
+        }
+    }
+
+    return CHIP_NO_ERROR;
+}
+
 } // namespace
 
 CHIP_ERROR AES_CCM_encrypt(const uint8_t * plaintext, size_t plaintext_length, const uint8_t * aad, size_t aad_length,
@@ -168,6 +264,77 @@ CHIP_ERROR AES_CCM_decrypt(const uint8_t * ciphertext, size_t ciphertext_length,
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR AES_CCM_encrypt_buffers(const MutableByteSpan * buffers, size_t buffer_count, const uint8_t * aad, size_t aad_length,
+                                   const Aes128KeyHandle & key, const uint8_t * nonce, size_t nonce_length, uint8_t * tag,
+                                   size_t tag_length)
+{
+    VerifyOrReturnError(isBufferNonEmpty(nonce, nonce_length), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(isValidTag(tag, tag_length), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(isValidBufferList(buffers, buffer_count), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(aad != nullptr || aad_length == 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    const psa_algorithm_t algorithm = PSA_ALG_AEAD_WITH_SHORTENED_TAG(PSA_ALG_CCM, tag_length);
+    psa_status_t status             = PSA_SUCCESS;
+    psa_aead_operation_t operation  = PSA_AEAD_OPERATION_INIT;
+    BufferListWriter writer(buffers, buffer_count);
+    uint8_t output[PSA_AEAD_FINISH_OUTPUT_MAX_SIZE];
+    size_t outLength    = 0;
+    size_t tagOutLength = 0;
+    CHIP_ERROR error    = CHIP_NO_ERROR;
+
+    status = psa_aead_encrypt_setup(&operation, key.As<psa_key_id_t>(), algorithm);
+    VerifyOrReturnError(status == PSA_SUCCESS, CHIP_ERROR_INTERNAL);
+
+    SuccessOrExit(error = updateBuffers(operation, buffers, buffer_count, aad, aad_length, nonce, nonce_length, writer));
+
+    status = psa_aead_finish(&operation, output, sizeof(output), &outLength, tag, tag_length, &tagOutLength);
+    VerifyOrExit(status == PSA_SUCCESS && tag_length == tagOutLength, error = CHIP_ERROR_INTERNAL);
+    VerifyOrExit(writer.Write(output, outLength), error = CHIP_ERROR_INTERNAL);
+
+exit:
+    psa_aead_abort(&operation);
+    return error;
+}
+
+CHIP_ERROR AES_CCM_decrypt_buffers(const MutableByteSpan * buffers, size_t buffer_count, const uint8_t * aad, size_t aad_length,
+                                   const uint8_t * tag, size_t tag_length, const Aes128KeyHandle & key, const uint8_t * nonce,
+                                   size_t nonce_length)
+{
+    VerifyOrReturnError(isBufferNonEmpty(nonce, nonce_length), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(isValidTag(tag, tag_length), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(isValidBufferList(buffers, buffer_count), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(aad != nullptr || aad_length == 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    const psa_algorithm_t algorithm = PSA_ALG_AEAD_WITH_SHORTENED_TAG(PSA_ALG_CCM, tag_length);
+    psa_status_t status             = PSA_SUCCESS;
+    psa_aead_operation_t operation  = PSA_AEAD_OPERATION_INIT;
+    BufferListWriter writer(buffers, buffer_count);
+    uint8_t output[PSA_AEAD_VERIFY_OUTPUT_MAX_SIZE];
+    size_t outLength = 0;
+    CHIP_ERROR error = CHIP_NO_ERROR;
+
+    status = psa_aead_decrypt_setup(&operation, key.As<psa_key_id_t>(), algorithm);
+    VerifyOrReturnError(status == PSA_SUCCESS, CHIP_ERROR_INTERNAL);
+
+    SuccessOrExit(error = updateBuffers(operation, buffers, buffer_count, aad, aad_length, nonce, nonce_length, writer));
+
+    status = psa_aead_verify(&operation, output, sizeof(output), &outLength, tag, tag_length);
+    VerifyOrExit(status == PSA_SUCCESS, error = CHIP_ERROR_INTERNAL);
+    VerifyOrExit(writer.Write(output, outLength), error = CHIP_ERROR_INTERNAL);
+
+exit:
+    psa_aead_abort(&operation);
+    if (error != CHIP_NO_ERROR)
+    {
+        // Do not leave unauthenticated plaintext behind
+        for (size_t i = 0; i < buffer_count; i++)
+        {
+            ClearSecretData(buffers[i].data(), buffers[i].size());
+        }
+    }
+    return error;
+}
+
 CHIP_ERROR Hash_SHA256(const uint8_t * data, const size_t data_length, uint8_t * out_buffer)
 {
     size_t outLength = 0;
@@ -22,9 +22,11 @@
 
 #include "CHIPCryptoPALmbedTLS.h"
 #include "CHIPCryptoPAL.h"
+#include "CHIPCryptoPALInternal.h"
 
 #include <type_traits>
 
+#include <mbedtls/aes.h>
 #include <mbedtls/bignum.h>
 #include <mbedtls/ccm.h>
 #include <mbedtls/ctr_drbg.h>
@@ -150,6 +152,146 @@ exit:
     return error;
 }
 
+#if (MBEDTLS_VERSION_NUMBER >= 0x03000000)
+// Runs AES-CCM over the buffers with the incremental API, leaving the computed tag in tag.
+static CHIP_ERROR _AES_CCM_crypt_buffers(int mode, const MutableByteSpan * buffers, size_t buffer_count, const uint8_t * aad,
+                                         size_t aad_length, const Aes128KeyHandle & key, const uint8_t * nonce, size_t nonce_length,
+                                         uint8_t * tag, size_t tag_length)
+{
+    CHIP_ERROR error     = CHIP_NO_ERROR;
+    int result           = 1;
+    size_t messageLength = 0;
+    size_t outLength     = 0;
+
+    mbedtls_ccm_context context;
+    mbedtls_ccm_init(&context);
+
+    VerifyOrExit(buffers != nullptr || buffer_count == 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(nonce != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(nonce_length > 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(tag != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(_isValidTagLength(tag_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(aad != nullptr || aad_length == 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+
+    for (size_t i = 0; i < buffer_count; i++)
+    {
+        VerifyOrExit(buffers[i].data() != nullptr || buffers[i].empty(), error = CHIP_ERROR_INVALID_ARGUMENT);
+        messageLength += buffers[i].size();
+    }
+
+    // Size of key is expressed in bits, hence the multiplication by 8.
+    result = mbedtls_ccm_setkey(&context, MBEDTLS_CIPHER_ID_AES, key.As<Symmetric128BitsKeyByteArray>(),
+                                sizeof(Symmetric128BitsKeyByteArray) * 8);
+    VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+
+    result = mbedtls_ccm_starts(&context, mode, Uint8::to_const_uchar(nonce), nonce_length);
+    VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+
+    result = mbedtls_ccm_set_lengths(&context, aad_length, messageLength, tag_length);
+    VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+
+    if (aad_length > 0)
+    {
+        result = mbedtls_ccm_update_ad(&context, Uint8::to_const_uchar(aad), aad_length);
+        VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+    }
+
+    // CCM never holds back output, so each buffer can be processed in place.
+    for (size_t i = 0; i < buffer_count; i++)
+    {
+        if (buffers[i].empty())
+        {
+            continue;
+        }
+        result = mbedtls_ccm_update(&context, Uint8::to_const_uchar(buffers[i].data()), buffers[i].size(),
+                                    Uint8::to_uchar(buffers[i].data()), buffers[i].size(), &outLength);
+        VerifyOrExit(result == 0 && outLength == buffers[i].size(), error = CHIP_ERROR_INTERNAL);
+    }
+
+    result = mbedtls_ccm_finish(&context, Uint8::to_uchar(tag), tag_length);
+    _log_mbedTLS_error(result);
+    VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+
+exit:
+    mbedtls_ccm_free(&context);
+    return error;
+}
+
+CHIP_ERROR AES_CCM_encrypt_buffers(const MutableByteSpan * buffers, size_t buffer_count, const uint8_t * aad, size_t aad_length,
+                                   const Aes128KeyHandle & key, const uint8_t * nonce, size_t nonce_length, uint8_t * tag,
+                                   size_t tag_length)
+{
+    return _AES_CCM_crypt_buffers(MBEDTLS_CCM_ENCRYPT, buffers, buffer_count, aad, aad_length, key, nonce, nonce_length, tag,
+                                  tag_length);
+}
+
+CHIP_ERROR AES_CCM_decrypt_buffers(const MutableByteSpan * buffers, size_t buffer_count, const uint8_t * aad, size_t aad_length,
+                                   const uint8_t * tag, size_t tag_length, const Aes128KeyHandle & key, const uint8_t * nonce,
+                                   size_t nonce_length)
+{
+    uint8_t expectedTag[kAES_CCM128_Tag_Length];
+
+    VerifyOrReturnError(tag != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(tag_length <= sizeof(expectedTag), CHIP_ERROR_INVALID_ARGUMENT);
+    ReturnErrorOnFailure(_AES_CCM_crypt_buffers(MBEDTLS_CCM_DECRYPT, buffers, buffer_count, aad, aad_length, key, nonce,
+                                                nonce_length, expectedTag, tag_length));
+
+    if (!IsBufferContentEqualConstantTime(expectedTag, tag, tag_length))
+    {
+        for (size_t i = 0; i < buffer_count; i++)
+        {
+            ClearSecretData(buffers[i].data(), buffers[i].size());
+        }
+        return CHIP_ERROR_INTERNAL;
+    }
+
+    return CHIP_NO_ERROR;
+}
+#endif // MBEDTLS_VERSION_NUMBER >= 0x03000000
+
+CHIP_ERROR AES_CTR_crypt(const uint8_t * input, size_t input_length, const Aes128KeyHandle & key, const uint8_t * nonce,
+                         size_t nonce_length, uint8_t * output)
+{
+#if defined(MBEDTLS_CIPHER_MODE_CTR)
+    CHIP_ERROR error = CHIP_NO_ERROR;
+    int result       = 1;
+    size_t offset    = 0;
+    uint8_t counter[kAES_CCM128_Block_Length];
+    uint8_t streamBlock[kAES_CCM128_Block_Length];
+
+    mbedtls_aes_context context;
+    mbedtls_aes_init(&context);
+
+    VerifyOrExit(input != nullptr || input_length == 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(output != nullptr || input_length == 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(Internal::BuildCCMCounterBlock(nonce, nonce_length, input_length, counter), error = CHIP_ERROR_INVALID_ARGUMENT);
+
+    if (input_length > 0)
+    {
+        // Size of key is expressed in bits, hence the multiplication by 8.
+        result =
+            mbedtls_aes_setkey_enc(&context, key.As<Symmetric128BitsKeyByteArray>(), sizeof(Symmetric128BitsKeyByteArray) * 8);
+        VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+
+        // A single CTR pass; mbedTLS uses AES-NI when built with MBEDTLS_AESNI_C and the CPU has it.
+        result = mbedtls_aes_crypt_ctr(&context, input_length, &offset, counter, streamBlock, Uint8::to_const_uchar(input),
+                                       Uint8::to_uchar(output));
+        _log_mbedTLS_error(result);
+        VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+    }
+
+exit:
+    mbedtls_aes_free(&context);
+    ClearSecretData(streamBlock, sizeof(streamBlock));
+    return error;
+#else
+    // Without CTR mode in the mbedTLS configuration, run AES-CCM and discard the tag.
+    uint8_t tag[kAES_CCM128_Tag_Length];
+
+    return AES_CCM_encrypt(input, input_length, nullptr, 0, key, nonce, nonce_length, output, tag, sizeof(tag));
+#endif // defined(MBEDTLS_CIPHER_MODE_CTR)
+}
+
 CHIP_ERROR Hash_SHA256(const uint8_t * data, const size_t data_length, uint8_t * out_buffer)
 {
     // zero data length hash is supported.
@@ -0,0 +1,418 @@
+/*
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @file
+ *   Times the primitives of the crypto PAL backend this is built with, so that the OpenSSL, BoringSSL,
+ *   mbedTLS and PSA builds can be compared: the AES-CCM and AES-CTR AEAD paths, SHA-256, SHA-1 and
+ *   HMAC over messages from 16 B to 16 KB, the HKDF and PBKDF2 key derivations, P-256 key generation,
+ *   ECDSA and ECDH, the public key operations of a CASE handshake, and each round of a SPAKE2+
+ *   exchange.  Public key operations run a tenth of the iterations.
+ *
+ *   Usage: crypto-pal-benchmark [iterations [filter]]
+ *   Only the benchmarks whose name contains filter are run, e.g. "ECDSA" or "16384 B".
+ */
+
+#include <crypto/CHIPCryptoPAL.h>
+#include <crypto/DefaultSessionKeystore.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/tests/BenchmarkHelpers.h>
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if CHIP_CRYPTO_PSA
+#include <psa/crypto.h>
+#endif
+
+using namespace chip;
+using namespace chip::Crypto;
+
+namespace {
+
+constexpr uint64_t kDefaultIterations = 5000;
+constexpr size_t kMaxMessageSize      = 16 * 1024;
+constexpr size_t kBufferCount         = 4;
+
+const size_t kMessageSizes[] = { 16, 64, 256, 1024, kMaxMessageSize };
+
+const uint8_t kKey[kAES_CCM128_Key_Length] = { 0xb8, 0x27, 0x9f, 0x89, 0x62, 0x1e, 0xd3, 0x27,
+                                               0xa9, 0xc3, 0x9f, 0x6a, 0x27, 0x22, 0x73, 0x58 };
+const uint8_t kNonce[kAES_CCM128_Nonce_Length] = { 0x00, 0x8b, 0x37, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08 };
+const uint8_t kAad[8]                          = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07 };
+const uint8_t kSpake2pContext[]                = { 'C', 'H', 'I', 'P', ' ', 'P', 'A', 'K', 'E', ' ', 'V', '1', ' ',
+                                                   'C', 'o', 'm', 'm', 'i', 's', 's', 'i', 'o', 'n', 'i', 'n', 'g' };
+constexpr uint32_t kSetupPasscode              = 20202021;
+
+const char * gFilter = nullptr;
+
+uint8_t gInput[kMaxMessageSize];
+uint8_t gCiphertext[kMaxMessageSize];
+uint8_t gOutput[kMaxMessageSize];
+
+const char * BackendName()
+{
+#if CHIP_CRYPTO_OPENSSL
+    return "OpenSSL";
+#elif CHIP_CRYPTO_BORINGSSL
+    return "BoringSSL";
+#elif CHIP_CRYPTO_MBEDTLS
+    return "mbedTLS";
+#elif CHIP_CRYPTO_PSA
+    return "PSA";
+#else
+    return "platform";
+#endif
+}
+
+// Times `body`, which returns a CHIP_ERROR. A case that fails still gets a row, which shows the error.
+template <typename Body>
+void Run(const char * primitive, size_t size, uint64_t iterations, Body && body)
+{
+    char name[64];
+    if (size > 0)
+    {
+        snprintf(name, sizeof(name), "%s %u B", primitive, static_cast<unsigned>(size));
+    }
+    else
+    {
+        snprintf(name, sizeof(name), "%s", primitive);
+    }
+    if (gFilter != nullptr && strstr(name, gFilter) == nullptr)
+    {
+        return;
+    }
+
+    CHIP_ERROR error                   = CHIP_NO_ERROR;
+    const Test::BenchmarkResult result = Test::RunBenchmark(name, iterations, [&](uint64_t i) {
+        error = body(i);
+        return error == CHIP_NO_ERROR;
+    });
+    if (error != CHIP_NO_ERROR)
+    {
+        printf("%-56s %12s %s\n", name, "error", error.AsString());
+        return;
+    }
+    Test::PrintBenchmarkResult(result);
+}
+
+void RunAeadBenchmarks(const Aes128KeyHandle & key, uint64_t iterations)
+{
+    uint8_t tag[kAES_CCM128_Tag_Length];
+
+    for (size_t size : kMessageSizes)
+    {
+        Run("AES_CCM_encrypt", size, iterations, [&](uint64_t) {
+            return AES_CCM_encrypt(gInput, size, kAad, sizeof(kAad), key, kNonce, sizeof(kNonce), gCiphertext, tag, sizeof(tag));
+        });
+
+        Run("AES_CCM_decrypt", size, iterations, [&](uint64_t) {
+            return AES_CCM_decrypt(gCiphertext, size, kAad, sizeof(kAad), tag, sizeof(tag), key, kNonce, sizeof(kNonce), gOutput);
+        });
+
+        // Split into equal buffers; the buffers are encrypted in place, so the contents change every run.
+        MutableByteSpan buffers[kBufferCount];
+        for (size_t i = 0; i < kBufferCount; i++)
+        {
+            const size_t start = i * size / kBufferCount;
+            buffers[i]         = MutableByteSpan(gOutput + start, (i + 1) * size / kBufferCount - start);
+        }
+        Run("AES_CCM_encrypt_buffers x4", size, iterations, [&](uint64_t) {
+            return AES_CCM_encrypt_buffers(buffers, kBufferCount, kAad, sizeof(kAad), key, kNonce, sizeof(kNonce), tag,
+                                           sizeof(tag));
+        });
+
+        Run("AES_CTR_crypt", size, iterations, [&](uint64_t) {
+            return AES_CTR_crypt(gInput, size, key, kNonce, sizeof(kNonce), gOutput);
+        });
+    }
+}
+
+void RunHashBenchmarks(uint64_t iterations)
+{
+    uint8_t digest[kSHA256_Hash_Length];
+
+    for (size_t size : kMessageSizes)
+    {
+        Run("Hash_SHA256", size, iterations, [&](uint64_t) { return Hash_SHA256(gInput, size, digest); });
+
+        Run("Hash_SHA1", size, iterations, [&](uint64_t) { return Hash_SHA1(gInput, size, digest); });
+
+        Run("Hash_SHA256_stream", size, iterations, [&](uint64_t) {
+            Hash_SHA256_stream hash;
+            MutableByteSpan out(digest);
+            ReturnErrorOnFailure(hash.Begin());
+            ReturnErrorOnFailure(hash.AddData(ByteSpan(gInput, size)));
+            return hash.Finish(out);
+        });
+
+        Run("HMAC_SHA256", size, iterations, [&](uint64_t) {
+            HMAC_sha hmac;
+            return hmac.HMAC_SHA256(kKey, sizeof(kKey), gInput, size, digest, sizeof(digest));
+        });
+    }
+}
+
+void RunKdfBenchmarks(SessionKeystore & keystore, uint64_t iterations)
+{
+    static const uint8_t kSalt[] = { 'S', 'a', 'l', 't' };
+    static const uint8_t kInfo[] = { 'S', 'e', 's', 's', 'i', 'o', 'n', 'K', 'e', 'y', 's' };
+    uint8_t out[3 * kAES_CCM128_Key_Length];
+
+    Run("HKDF_SHA256", sizeof(out), iterations, [&](uint64_t) {
+        HKDF_sha hkdf;
+        return hkdf.HKDF_SHA256(gInput, kMax_ECDH_Secret_Length, kSalt, sizeof(kSalt), kInfo, sizeof(kInfo), out, sizeof(out));
+    });
+
+    Run("DeriveSessionKeys", sizeof(out), iterations, [&](uint64_t) {
+        Aes128KeyHandle i2rKey;
+        Aes128KeyHandle r2iKey;
+        AttestationChallenge challenge;
+        ReturnErrorOnFailure(keystore.DeriveSessionKeys(ByteSpan(gInput, kMax_ECDH_Secret_Length), ByteSpan(kSalt),
+                                                        ByteSpan(kInfo), i2rKey, r2iKey, challenge));
+        keystore.DestroyKey(i2rKey);
+        keystore.DestroyKey(r2iKey);
+        return CHIP_NO_ERROR;
+    });
+
+    // The PASE w0s || w1s derivation. Each run is a thousand HMACs, so keep the count down.
+    uint8_t ws[kSpake2p_WS_Length * 2];
+    Run("pbkdf2_sha256 x1000", sizeof(ws), std::max<uint64_t>(iterations / 100, 1), [&](uint64_t) {
+        PBKDF2_sha256 pbkdf2;
+        return pbkdf2.pbkdf2_sha256(kKey, sizeof(kKey), gInput, kSpake2p_Min_PBKDF_Salt_Length, kSpake2p_Min_PBKDF_Iterations,
+                                    sizeof(ws), ws);
+    });
+}
+
+void RunPublicKeyBenchmarks(uint64_t iterations)
+{
+    P256Keypair keypair;
+    P256Keypair peer;
+    P256ECDSASignature signature;
+
+    VerifyOrReturn(keypair.Initialize(ECPKeyTarget::ECDSA) == CHIP_NO_ERROR && peer.Initialize(ECPKeyTarget::ECDH) == CHIP_NO_ERROR,
+                   printf("P256 key generation failed\n"));
+
+    Run("P256Keypair::Initialize", 0, iterations, [&](uint64_t) {
+        P256Keypair generated;
+        return generated.Initialize(ECPKeyTarget::ECDSA);
+    });
+
+    for (size_t size : kMessageSizes)
+    {
+        Run("ECDSA_sign_msg", size, iterations, [&](uint64_t) { return keypair.ECDSA_sign_msg(gInput, size, signature); });
+
+        Run("ECDSA_validate_msg_signature", size, iterations, [&](uint64_t) {
+            return keypair.Pubkey().ECDSA_validate_msg_signature(gInput, size, signature);
+        });
+    }
+
+    Run("ECDH_derive_secret", kMax_ECDH_Secret_Length, iterations, [&](uint64_t) {
+        P256ECDHDerivedSecret secret;
+        return keypair.ECDH_derive_secret(peer.Pubkey(), secret);
+    });
+}
+
+// One side of a CASE exchange: an operational key, its certificate chain signatures and the
+// ephemeral key that is regenerated for every handshake.
+struct CaseNode
+{
+    P256Keypair mOperationalKey;
+    P256ECDSASignature mNocSignature;
+    P256Keypair mEphemeralKey;
+    P256ECDSASignature mTbsSignature;
+
+    CHIP_ERROR Setup(const P256Keypair & icaKey)
+    {
+        ReturnErrorOnFailure(mOperationalKey.Initialize(ECPKeyTarget::ECDSA));
+        return icaKey.ECDSA_sign_msg(mOperationalKey.Pubkey().ConstBytes(), mOperationalKey.Pubkey().Length(), mNocSignature);
+    }
+
+    CHIP_ERROR Start()
+    {
+        ReturnErrorOnFailure(mEphemeralKey.Initialize(ECPKeyTarget::ECDH));
+        return mOperationalKey.ECDSA_sign_msg(mEphemeralKey.Pubkey().ConstBytes(), mEphemeralKey.Pubkey().Length(), mTbsSignature);
+    }
+
+    // Derives the shared secret and checks the peer's NOC and TBS signatures, the way Sigma2 and
+    // Sigma3 are handled.
+    CHIP_ERROR Finish(const CaseNode & peer, const P256Keypair & icaKey)
+    {
+        P256ECDHDerivedSecret secret;
+        const P256PublicKey & peerKey = peer.mOperationalKey.Pubkey();
+
+        ReturnErrorOnFailure(mEphemeralKey.ECDH_derive_secret(peer.mEphemeralKey.Pubkey(), secret));
+        ReturnErrorOnFailure(
+            icaKey.Pubkey().ECDSA_validate_msg_signature(peerKey.ConstBytes(), peerKey.Length(), peer.mNocSignature));
+        return peerKey.ECDSA_validate_msg_signature(peer.mEphemeralKey.Pubkey().ConstBytes(), peer.mEphemeralKey.Pubkey().Length(),
+                                                    peer.mTbsSignature);
+    }
+};
+
+// The public key work of CASE handshakes between two nodes of the same fabric, both sides: each
+// handshake generates two ephemeral keys and checks the same operational and ICA keys again.
+void RunCaseBenchmark(uint64_t iterations)
+{
+    P256Keypair icaKey;
+    CaseNode initiator;
+    CaseNode responder;
+
+    VerifyOrReturn(icaKey.Initialize(ECPKeyTarget::ECDSA) == CHIP_NO_ERROR && initiator.Setup(icaKey) == CHIP_NO_ERROR &&
+                       responder.Setup(icaKey) == CHIP_NO_ERROR,
+                   printf("CASE setup failed\n"));
+
+    Run("CASE handshake public key operations", 0, iterations, [&](uint64_t) {
+        ReturnErrorOnFailure(initiator.Start());
+        ReturnErrorOnFailure(responder.Start());
+        ReturnErrorOnFailure(responder.Finish(initiator, icaKey));
+        return initiator.Finish(responder, icaKey);
+    });
+}
+
+// A PASE-style SPAKE2+ exchange that can be driven up to a given step, so that each step is timed
+// together with the ones before it.
+class Spake2pExchange
+{
+public:
+    enum class Step
+    {
+        kBegin,
+        kRoundOne,
+        kRoundTwo,
+        kKeyConfirm,
+    };
+
+    CHIP_ERROR Setup()
+    {
+        const ByteSpan salt(gInput, kSpake2p_Min_PBKDF_Salt_Length);
+
+        ReturnErrorOnFailure(Spake2pVerifier::ComputeWS(kSpake2p_Min_PBKDF_Iterations, salt, kSetupPasscode, mWS, sizeof(mWS)));
+        return mVerifierInput.Generate(kSpake2p_Min_PBKDF_Iterations, salt, kSetupPasscode);
+    }
+
+    CHIP_ERROR RunTo(Step last)
+    {
+        uint8_t pA[kMAX_Point_Length];
+        uint8_t pB[kMAX_Point_Length];
+        uint8_t cA[kMAX_Hash_Length];
+        uint8_t cB[kMAX_Hash_Length];
+        size_t pALength = sizeof(pA);
+        size_t pBLength = sizeof(pB);
+        size_t cALength = sizeof(cA);
+        size_t cBLength = sizeof(cB);
+
+        ReturnErrorOnFailure(mProver.Init(kSpake2pContext, sizeof(kSpake2pContext)));
+        ReturnErrorOnFailure(mVerifier.Init(kSpake2pContext, sizeof(kSpake2pContext)));
+        ReturnErrorOnFailure(
+            mProver.BeginProver(nullptr, 0, nullptr, 0, &mWS[0], kSpake2p_WS_Length, &mWS[kSpake2p_WS_Length], kSpake2p_WS_Length));
+        ReturnErrorOnFailure(mVerifier.BeginVerifier(nullptr, 0, nullptr, 0, mVerifierInput.mW0, sizeof(mVerifierInput.mW0),
+                                                     mVerifierInput.mL, sizeof(mVerifierInput.mL)));
+        if (last == Step::kBegin)
+        {
+            return CHIP_NO_ERROR;
+        }
+
+        ReturnErrorOnFailure(mProver.ComputeRoundOne(nullptr, 0, pA, &pALength));
+        ReturnErrorOnFailure(mVerifier.ComputeRoundOne(pA, pALength, pB, &pBLength));
+        if (last == Step::kRoundOne)
+        {
+            return CHIP_NO_ERROR;
+        }
+
+        ReturnErrorOnFailure(mVerifier.ComputeRoundTwo(pA, pALength, cB, &cBLength));
+        ReturnErrorOnFailure(mProver.ComputeRoundTwo(pB, pBLength, cA, &cALength));
+        if (last == Step::kRoundTwo)
+        {
+            return CHIP_NO_ERROR;
+        }
+
+        ReturnErrorOnFailure(mProver.KeyConfirm(cB, cBLength));
+        return mVerifier.KeyConfirm(cA, cALength);
+    }
+
+private:
+    Spake2p_P256_SHA256_HKDF_HMAC mProver;
+    Spake2p_P256_SHA256_HKDF_HMAC mVerifier;
+    Spake2pVerifier mVerifierInput;
+    uint8_t mWS[kSpake2p_WS_Length * 2];
+};
+
+void RunSpake2pBenchmarks(uint64_t iterations)
+{
+    static const struct
+    {
+        const char * mName;
+        Spake2pExchange::Step mLastStep;
+    } kSteps[] = {
+        { "Spake2p Begin", Spake2pExchange::Step::kBegin },
+        { "Spake2p Begin..ComputeRoundOne", Spake2pExchange::Step::kRoundOne },
+        { "Spake2p Begin..ComputeRoundTwo", Spake2pExchange::Step::kRoundTwo },
+        { "Spake2p Begin..KeyConfirm", Spake2pExchange::Step::kKeyConfirm },
+    };
+
+    Spake2pExchange exchange;
+    VerifyOrReturn(exchange.Setup() == CHIP_NO_ERROR, printf("SPAKE2+ setup failed\n"));
+
+    for (const auto & step : kSteps)
+    {
+        Run(step.mName, 0, iterations, [&](uint64_t) { return exchange.RunTo(step.mLastStep); });
+    }
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+    const uint64_t iterations = (argc > 1) ? strtoull(argv[1], nullptr, 0) : kDefaultIterations;
+    gFilter                   = (argc > 2) ? argv[2] : nullptr;
+
+    VerifyOrReturnValue(Platform::MemoryInit() == CHIP_NO_ERROR, EXIT_FAILURE);
+#if CHIP_CRYPTO_PSA
+    VerifyOrReturnValue(psa_crypto_init() == PSA_SUCCESS, EXIT_FAILURE);
+#endif
+
+    for (size_t i = 0; i < sizeof(gInput); i++)
+    {
+        gInput[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    {
+        DefaultSessionKeystore keystore;
+        Symmetric128BitsKeyByteArray keyMaterial;
+        Aes128KeyHandle key;
+
+        memcpy(keyMaterial, kKey, sizeof(kKey));
+        VerifyOrReturnValue(keystore.CreateKey(keyMaterial, key) == CHIP_NO_ERROR, EXIT_FAILURE);
+
+        printf("crypto backend: %s\n", BackendName());
+        Test::PrintBenchmarkHeader();
+        RunAeadBenchmarks(key, iterations);
+        RunHashBenchmarks(iterations);
+        RunKdfBenchmarks(keystore, iterations);
+        RunPublicKeyBenchmarks(std::max<uint64_t>(iterations / 10, 1));
+        RunCaseBenchmark(std::max<uint64_t>(iterations / 10, 1));
+        RunSpake2pBenchmarks(std::max<uint64_t>(iterations / 10, 1));
+
+        keystore.DestroyKey(key);
+    }
+
+    Platform::MemoryShutdown();
+    return EXIT_SUCCESS;
+}
@@ -315,6 +315,42 @@ TEST_F(TestChipCryptoPAL, TestAES_CTR_128CryptTestVectors)
     EXPECT_GT(numOfTestsRan, 0);
 }
 
+TEST_F(TestChipCryptoPAL, TestAES_CTR_128MatchesCCM)
+{
+    HeapChecker heapChecker;
+    const uint8_t keyBytes[KEY_LENGTH] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                                           0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f };
+    const uint8_t nonce[13]            = { 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c };
+    TestAesKey key(keyBytes, sizeof(keyBytes));
+
+    uint8_t input[1000];
+    uint8_t ccmOutput[sizeof(input)];
+    uint8_t ctrOutput[sizeof(input)];
+    uint8_t tag[kAES_CCM128_Tag_Length];
+
+    for (size_t i = 0; i < sizeof(input); i++)
+    {
+        input[i] = static_cast<uint8_t>(i * 13);
+    }
+
+    // The CTR key stream must be the one AES-CCM applies to its payload, whatever the length and nonce size.
+    constexpr size_t kLengths[]      = { 1, 15, 16, 17, 100, sizeof(input) };
+    constexpr size_t kNonceLengths[] = { 7, 8, 12, 13 };
+    for (size_t nonceLength : kNonceLengths)
+    {
+        for (size_t length : kLengths)
+        {
+            EXPECT_EQ(AES_CCM_encrypt(input, length, nullptr, 0, key.key, nonce, nonceLength, ccmOutput, tag, sizeof(tag)),
+                      CHIP_NO_ERROR);
+            EXPECT_EQ(AES_CTR_crypt(input, length, key.key, nonce, nonceLength, ctrOutput), CHIP_NO_ERROR);
+            EXPECT_EQ(memcmp(ccmOutput, ctrOutput, length), 0);
+        }
+    }
+
+    EXPECT_NE(AES_CTR_crypt(input, sizeof(input), key.key, nonce, 0, ctrOutput), CHIP_NO_ERROR);
+    EXPECT_NE(AES_CTR_crypt(input, sizeof(input), key.key, nullptr, sizeof(nonce), ctrOutput), CHIP_NO_ERROR);
+}
+
 TEST_F(TestChipCryptoPAL, TestAES_CCM_128EncryptTestVectors)
 {
     HeapChecker heapChecker;
@@ -478,6 +514,67 @@ TEST_F(TestChipCryptoPAL, TestAES_CCM_128DecryptInvalidNonceLen)
     EXPECT_GT(numOfTestsRan, 0);
 }
 
+TEST_F(TestChipCryptoPAL, TestAES_CCM_128BuffersTestVectors)
+{
+    HeapChecker heapChecker;
+    int numOfTestVectors = ArraySize(ccm_128_test_vectors);
+    int numOfTestsRan    = 0;
+    for (int vectorIndex = 0; vectorIndex < numOfTestVectors; vectorIndex++)
+    {
+        const ccm_128_test_vector * vector = ccm_128_test_vectors[vectorIndex];
+        if (vector->pt_len > 0 && vector->result == CHIP_NO_ERROR)
+        {
+            numOfTestsRan++;
+            chip::Platform::ScopedMemoryBuffer<uint8_t> data;
+            data.Alloc(vector->pt_len);
+            EXPECT_TRUE(data);
+            memcpy(data.Get(), vector->pt, vector->pt_len);
+            uint8_t out_tag[kAES_CCM128_Tag_Length];
+
+            // Split the message unevenly, with buffers shorter and longer than a block, and an empty one.
+            constexpr size_t kSplitSizes[] = { 1, 0, 17, 5, 32 };
+            MutableByteSpan buffers[16];
+            size_t bufferCount = 0;
+            for (size_t offset = 0; offset < vector->pt_len && bufferCount < ArraySize(buffers); bufferCount++)
+            {
+                size_t size = std::min(kSplitSizes[bufferCount % ArraySize(kSplitSizes)], vector->pt_len - offset);
+                if (bufferCount == ArraySize(buffers) - 1)
+                {
+                    size = vector->pt_len - offset;
+                }
+                buffers[bufferCount] = MutableByteSpan(data.Get() + offset, size);
+                offset += size;
+            }
+
+            TestAesKey key(vector->key, vector->key_len);
+
+            CHIP_ERROR err = AES_CCM_encrypt_buffers(buffers, bufferCount, vector->aad, vector->aad_len, key.key, vector->nonce,
+                                                     vector->nonce_len, out_tag, vector->tag_len);
+            EXPECT_EQ(err, CHIP_NO_ERROR);
+            EXPECT_EQ(memcmp(data.Get(), vector->ct, vector->ct_len), 0);
+            EXPECT_EQ(memcmp(out_tag, vector->tag, vector->tag_len), 0);
+
+            err = AES_CCM_decrypt_buffers(buffers, bufferCount, vector->aad, vector->aad_len, vector->tag, vector->tag_len, key.key,
+                                          vector->nonce, vector->nonce_len);
+            EXPECT_EQ(err, CHIP_NO_ERROR);
+            EXPECT_EQ(memcmp(data.Get(), vector->pt, vector->pt_len), 0);
+
+            // A bad tag leaves no unauthenticated plaintext behind
+            memcpy(data.Get(), vector->ct, vector->ct_len);
+            out_tag[0] = static_cast<uint8_t>(vector->tag[0] ^ 0x01);
+            memcpy(&out_tag[1], &vector->tag[1], vector->tag_len - 1);
+            err = AES_CCM_decrypt_buffers(buffers, bufferCount, vector->aad, vector->aad_len, out_tag, vector->tag_len, key.key,
+                                          vector->nonce, vector->nonce_len);
+            EXPECT_NE(err, CHIP_NO_ERROR);
+            for (size_t i = 0; i < vector->pt_len; i++)
+            {
+                EXPECT_EQ(data[i], 0);
+            }
+        }
+    }
+    EXPECT_GT(numOfTestsRan, 0);
+}
+
 TEST_F(TestChipCryptoPAL, TestSensitiveDataBuffer)
 {
     HeapChecker heapChecker;
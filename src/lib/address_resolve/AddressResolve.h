@@ -105,6 +105,7 @@ public:
     const PeerId & GetPeerId() const { return mPeerId; }
     System::Clock::Milliseconds32 GetMinLookupTime() const { return mMinLookupTimeMs; }
     System::Clock::Milliseconds32 GetMaxLookupTime() const { return mMaxLookupTimeMs; }
+    bool GetBypassCache() const { return mBypassCache; }
 
     /// The minimum lookup time is how much to wait for additional DNSSD
     /// queries even if a reply has already been received or to allow for
@@ -142,6 +143,16 @@ public:
         return *this;
     }
 
+    /// Resolvers that cache node addresses normally answer from the cache.
+    /// Bypassing the cache drops whatever it holds for the node and always
+    /// runs a fresh DNSSD lookup, for callers that know the cached address
+    /// has stopped working.
+    NodeLookupRequest & SetBypassCache(bool value)
+    {
+        mBypassCache = value;
+        return *this;
+    }
+
 private:
     static_assert((CHIP_CONFIG_ADDRESS_RESOLVE_MIN_LOOKUP_TIME_MS) <= (CHIP_CONFIG_ADDRESS_RESOLVE_MAX_LOOKUP_TIME_MS),
                   "AddressResolveMinLookupTime must be equal or less than AddressResolveMaxLookupTime");
@@ -155,6 +166,7 @@ private:
     PeerId mPeerId;
     System::Clock::Milliseconds32 mMinLookupTimeMs{ kMinLookupTimeMsDefault };
     System::Clock::Milliseconds32 mMaxLookupTimeMs{ kMaxLookupTimeMsDefault };
+    bool mBypassCache = false;
 };
 
 /// These things are expected to be defined by the implementation header.
@@ -21,6 +21,8 @@
 #include <tracing/macros.h>
 #include <transport/raw/PeerAddress.h>
 
+#include <algorithm>
+
 namespace chip {
 namespace AddressResolve {
 namespace Impl {
@@ -28,6 +30,35 @@ namespace {
 
 static constexpr System::Clock::Timeout kInvalidTimeout{ System::Clock::Timeout::max() };
 
+static constexpr System::Clock::Seconds32 kCacheDefaultTtl{ CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_DEFAULT_TTL_SECONDS };
+static constexpr System::Clock::Seconds32 kCacheStaleTime{ CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_STALE_SECONDS };
+static constexpr System::Clock::Seconds32 kCacheNegativeTtl{ CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_NEGATIVE_TTL_SECONDS };
+static constexpr System::Clock::Milliseconds32 kCacheRefreshTimeout{ CHIP_CONFIG_ADDRESS_RESOLVE_MAX_LOOKUP_TIME_MS };
+
+/// The result for a resolved node, without an IP address set.
+ResolveResult MakeResolveResult(const Dnssd::ResolvedNodeData & nodeData)
+{
+    ResolveResult result;
+
+    result.address.SetPort(nodeData.resolutionData.port);
+    result.address.SetInterface(nodeData.resolutionData.interfaceId);
+    result.mrpRemoteConfig   = nodeData.resolutionData.GetRemoteMRPConfig();
+    result.supportsTcpClient = nodeData.resolutionData.supportsTcpClient;
+    result.supportsTcpServer = nodeData.resolutionData.supportsTcpServer;
+
+    if (nodeData.resolutionData.isICDOperatingAsLIT.has_value())
+    {
+        result.isICDOperatingAsLIT = *(nodeData.resolutionData.isICDOperatingAsLIT);
+    }
+
+    return result;
+}
+
+bool IsUsableAddress(const Inet::IPAddress & address)
+{
+    return INET_CONFIG_ENABLE_IPV4 || address.IsIPv6();
+}
+
 } // namespace
 
 void NodeLookupHandle::ResetForLookup(System::Clock::Timestamp now, const NodeLookupRequest & request)
@@ -35,6 +66,16 @@ void NodeLookupHandle::ResetForLookup(System::Clock::Timestamp now, const NodeLo
     mRequestStartTime = now;
     mRequest          = request;
     mResults          = NodeLookupResults();
+    mCachedError      = CHIP_NO_ERROR;
+    mServedFromCache  = false;
+}
+
+void NodeLookupHandle::ServeFromCache(const NodeLookupResults & results, CHIP_ERROR error)
+{
+    mResults          = results;
+    mResults.consumed = 0;
+    mCachedError      = error;
+    mServedFromCache  = true;
 }
 
 void NodeLookupHandle::LookupResult(const ResolveResult & result)
@@ -66,6 +107,12 @@ System::Clock::Timeout NodeLookupHandle::NextEventTimeout(System::Clock::Timesta
 {
     const System::Clock::Timestamp elapsed = now - mRequestStartTime;
 
+    if (mServedFromCache)
+    {
+        // Cached data is complete already: there is nothing to wait for.
+        return System::Clock::Timeout::zero();
+    }
+
     if (elapsed < mRequest.GetMinLookupTime())
     {
         return mRequest.GetMinLookupTime() - elapsed;
@@ -104,6 +151,16 @@ NodeLookupAction NodeLookupHandle::NextAction(System::Clock::Timestamp now)
     ChipLogProgress(Discovery, "Checking node lookup status for " ChipLogFormatPeerId " after %lu ms",
                     ChipLogValuePeerId(mRequest.GetPeerId()), static_cast<unsigned long>(elapsed.count()));
 
+    // Cached data is not subject to the minimal search time.
+    if (mServedFromCache)
+    {
+        if (HasLookupResult())
+        {
+            return NodeLookupAction::Success(TakeLookupResult());
+        }
+        return NodeLookupAction::Error(mCachedError);
+    }
+
     // We are still within the minimal search time. Wait for more results.
     if (elapsed < mRequest.GetMinLookupTime())
     {
@@ -198,14 +255,103 @@ bool NodeLookupResults::UpdateResults(const ResolveResult & result, const Dnssd:
     return true;
 }
 
+NodeAddressCache::Entry * NodeAddressCache::Find(const PeerId & peerId)
+{
+    for (auto & entry : *this)
+    {
+        if (entry.inUse && entry.peerId == peerId)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+NodeAddressCache::Entry & NodeAddressCache::NextFreeEntry()
+{
+    Entry * oldest = begin();
+    for (auto & entry : *this)
+    {
+        if (!entry.inUse)
+        {
+            return entry;
+        }
+        if (entry.lastUsed < oldest->lastUsed)
+        {
+            oldest = &entry;
+        }
+    }
+    return *oldest;
+}
+
+NodeAddressCache::EntryState NodeAddressCache::GetState(const Entry & entry, System::Clock::Timestamp now)
+{
+    if (!entry.inUse)
+    {
+        return EntryState::kExpired;
+    }
+    if (entry.results.count == 0)
+    {
+        return (now < entry.expiryTime) ? EntryState::kNegative : EntryState::kExpired;
+    }
+    if (now < entry.refreshTime)
+    {
+        return EntryState::kFresh;
+    }
+    if (now < entry.expiryTime)
+    {
+        return EntryState::kRefreshDue;
+    }
+    return (now < entry.staleTime) ? EntryState::kStale : EntryState::kExpired;
+}
+
+void NodeAddressCache::SetResults(Entry & entry, const PeerId & peerId, const NodeLookupResults & results,
+                                  System::Clock::Seconds32 ttl, System::Clock::Timestamp now)
+{
+    entry.peerId           = peerId;
+    entry.results          = results;
+    entry.results.consumed = 0;
+    entry.error            = CHIP_NO_ERROR;
+    entry.refreshTime      = now + ttl * 3 / 4;
+    entry.expiryTime       = now + ttl;
+    entry.staleTime        = entry.expiryTime + kCacheStaleTime;
+    entry.lastUsed         = now;
+    entry.inUse            = true;
+}
+
+void NodeAddressCache::SetFailure(Entry & entry, const PeerId & peerId, CHIP_ERROR error, System::Clock::Timestamp now)
+{
+    entry.peerId      = peerId;
+    entry.results     = NodeLookupResults();
+    entry.error       = error;
+    entry.refreshTime = entry.expiryTime = entry.staleTime = now + kCacheNegativeTtl;
+    entry.lastUsed    = now;
+    entry.inUse       = true;
+}
+
 CHIP_ERROR Resolver::LookupNode(const NodeLookupRequest & request, Impl::NodeLookupHandle & handle)
 {
     MATTER_LOG_NODE_LOOKUP(&request);
 
     VerifyOrReturnError(mSystemLayer != nullptr, CHIP_ERROR_INCORRECT_STATE);
 
-    handle.ResetForLookup(mTimeSource.GetMonotonicTimestamp(), request);
+    const System::Clock::Timestamp now = mTimeSource.GetMonotonicTimestamp();
+    handle.ResetForLookup(now, request);
     auto & peerId = request.GetPeerId();
+
+    if (request.GetBypassCache())
+    {
+        // The caller already found the cached address to be unusable, so nobody else should get it either.
+        DropCacheEntry(peerId);
+    }
+    else if (LookupFromCache(handle, now))
+    {
+        mActiveLookups.PushBack(&handle);
+        ReArmTimer();
+        ChipLogProgress(Discovery, "Lookup for " ChipLogFormatPeerId " served from cache", ChipLogValuePeerId(peerId));
+        return CHIP_NO_ERROR;
+    }
+
     ReturnErrorOnFailure(Dnssd::Resolver::Instance().ResolveNodeId(peerId));
     mActiveLookups.PushBack(&handle);
     ReArmTimer();
@@ -216,10 +362,19 @@ CHIP_ERROR Resolver::LookupNode(const NodeLookupRequest & request, Impl::NodeLoo
 CHIP_ERROR Resolver::TryNextResult(Impl::NodeLookupHandle & handle)
 {
     VerifyOrReturnError(!mActiveLookups.Contains(&handle), CHIP_ERROR_INCORRECT_STATE);
+
+    auto peerId = handle.GetRequest().GetPeerId();
+
+    if (handle.IsServedFromCache())
+    {
+        // The caller moves on because the previous cached address did not
+        // work: do not hand that address out again.
+        DropCacheEntry(peerId);
+    }
+
     VerifyOrReturnError(handle.HasLookupResult(), CHIP_ERROR_NOT_FOUND);
 
     auto listener = handle.GetListener();
-    auto peerId   = handle.GetRequest().GetPeerId();
     auto result   = handle.TakeLookupResult();
 
     MATTER_LOG_NODE_DISCOVERED(Tracing::DiscoveryInfoType::kRetryDifferent, &peerId, &result);
@@ -232,7 +387,10 @@ CHIP_ERROR Resolver::CancelLookup(Impl::NodeLookupHandle & handle, FailureCallba
 {
     VerifyOrReturnError(handle.IsActive(), CHIP_ERROR_INVALID_ARGUMENT);
     mActiveLookups.Remove(&handle);
-    Dnssd::Resolver::Instance().NodeIdResolutionNoLongerNeeded(handle.GetRequest().GetPeerId());
+    if (!handle.IsServedFromCache())
+    {
+        Dnssd::Resolver::Instance().NodeIdResolutionNoLongerNeeded(handle.GetRequest().GetPeerId());
+    }
 
     // Adjust any timing updates.
     ReArmTimer();
@@ -273,20 +431,30 @@ void Resolver::Shutdown()
 
         const PeerId peerId     = current->GetRequest().GetPeerId();
         NodeListener * listener = current->GetListener();
+        const bool fromCache    = current->IsServedFromCache();
 
         mActiveLookups.Erase(current);
 
         MATTER_LOG_NODE_DISCOVERY_FAILED(&peerId, CHIP_ERROR_SHUT_DOWN);
 
-        Dnssd::Resolver::Instance().NodeIdResolutionNoLongerNeeded(peerId);
+        if (!fromCache)
+        {
+            Dnssd::Resolver::Instance().NodeIdResolutionNoLongerNeeded(peerId);
+        }
         // Failure callback only called after iterator was cleared:
         // This allows failure handlers to deallocate structures that may
         // contain the active lookup data as a member (intrusive lists members)
         listener->OnNodeAddressResolutionFailed(peerId, CHIP_ERROR_SHUT_DOWN);
     }
 
+    for (auto & entry : mCache)
+    {
+        StopRefresh(entry);
+        entry.inUse = false;
+    }
+
     // Re-arm of timer is expected to cancel any active timer as the
-    // internal list of active lookups is empty at this point.
+    // internal list of active lookups is empty and no refresh runs at this point.
     ReArmTimer();
 
     mSystemLayer = nullptr;
@@ -295,38 +463,27 @@ void Resolver::Shutdown()
 
 void Resolver::OnOperationalNodeResolved(const Dnssd::ResolvedNodeData & nodeData)
 {
+    UpdateCache(nodeData, mTimeSource.GetMonotonicTimestamp());
+
     auto it = mActiveLookups.begin();
     while (it != mActiveLookups.end())
     {
         auto current = it;
         it++;
-        if (current->GetRequest().GetPeerId() != nodeData.operationalData.peerId)
+        if (current->GetRequest().GetPeerId() != nodeData.operationalData.peerId || current->IsServedFromCache())
         {
             continue;
         }
 
-        ResolveResult result;
-
-        result.address.SetPort(nodeData.resolutionData.port);
-        result.address.SetInterface(nodeData.resolutionData.interfaceId);
-        result.mrpRemoteConfig   = nodeData.resolutionData.GetRemoteMRPConfig();
-        result.supportsTcpClient = nodeData.resolutionData.supportsTcpClient;
-        result.supportsTcpServer = nodeData.resolutionData.supportsTcpServer;
-
-        if (nodeData.resolutionData.isICDOperatingAsLIT.has_value())
-        {
-            result.isICDOperatingAsLIT = *(nodeData.resolutionData.isICDOperatingAsLIT);
-        }
+        ResolveResult result = MakeResolveResult(nodeData);
 
         for (size_t i = 0; i < nodeData.resolutionData.numIPs; i++)
         {
-#if !INET_CONFIG_ENABLE_IPV4
-            if (!nodeData.resolutionData.ipAddress[i].IsIPv6())
+            if (!IsUsableAddress(nodeData.resolutionData.ipAddress[i]))
             {
                 ChipLogError(Discovery, "Skipping IPv4 address during operational resolve.");
                 continue;
             }
-#endif
             result.address.SetIPAddress(nodeData.resolutionData.ipAddress[i]);
             current->LookupResult(result);
         }
@@ -350,9 +507,27 @@ void Resolver::HandleAction(IntrusiveList<NodeLookupHandle>::Iterator & current)
     // final result, handle either success or failure
     const PeerId peerId     = current->GetRequest().GetPeerId();
     NodeListener * listener = current->GetListener();
+    const bool fromCache    = current->IsServedFromCache();
     mActiveLookups.Erase(current);
 
-    Dnssd::Resolver::Instance().NodeIdResolutionNoLongerNeeded(peerId);
+    if (!fromCache)
+    {
+        Dnssd::Resolver::Instance().NodeIdResolutionNoLongerNeeded(peerId);
+
+        // Remember that the node did not answer, so that lookups retried right
+        // away do not wait out another full lookup.
+        if (NodeAddressCache::IsEnabled() && kCacheNegativeTtl.count() > 0 &&
+            action.Type() == NodeLookupResult::kLookupError && action.ErrorResult() == CHIP_ERROR_TIMEOUT)
+        {
+            NodeAddressCache::Entry * entry = mCache.Find(peerId);
+            if (entry == nullptr)
+            {
+                entry = &mCache.NextFreeEntry();
+            }
+            StopRefresh(*entry);
+            NodeAddressCache::SetFailure(*entry, peerId, CHIP_ERROR_TIMEOUT, mTimeSource.GetMonotonicTimestamp());
+        }
+    }
 
     // ensure action is taken AFTER the current current lookup is marked complete
     // This allows failure handlers to deallocate structures that may
@@ -375,6 +550,8 @@ void Resolver::HandleAction(IntrusiveList<NodeLookupHandle>::Iterator & current)
 
 void Resolver::HandleTimer()
 {
+    ExpireRefreshes(mTimeSource.GetMonotonicTimestamp());
+
     auto it = mActiveLookups.begin();
     while (it != mActiveLookups.end())
     {
@@ -394,7 +571,7 @@ void Resolver::OnOperationalNodeResolutionFailed(const PeerId & peerId, CHIP_ERR
     {
         auto current = it;
         it++;
-        if (current->GetRequest().GetPeerId() != peerId)
+        if (current->GetRequest().GetPeerId() != peerId || current->IsServedFromCache())
         {
             continue;
         }
@@ -409,6 +586,13 @@ void Resolver::OnOperationalNodeResolutionFailed(const PeerId & peerId, CHIP_ERR
         // contain the active lookup data as a member (intrusive lists members)
         listener->OnNodeAddressResolutionFailed(peerId, error);
     }
+
+    NodeAddressCache::Entry * entry = mCache.Find(peerId);
+    if (entry != nullptr)
+    {
+        StopRefresh(*entry);
+    }
+
     ReArmTimer();
 }
 
@@ -429,6 +613,19 @@ void Resolver::ReArmTimer()
         }
     }
 
+    for (auto & entry : mCache)
+    {
+        if (entry.inUse && entry.refreshing)
+        {
+            System::Clock::Timeout timeout = System::Clock::Timeout::zero();
+            if (entry.refreshDeadline > now)
+            {
+                timeout = entry.refreshDeadline - now;
+            }
+            nextTimeout = std::min(nextTimeout, timeout);
+        }
+    }
+
     if (nextTimeout == kInvalidTimeout)
     {
         // Generally this is only expected when no active lookups exist
@@ -446,11 +643,15 @@ void Resolver::ReArmTimer()
         {
             const PeerId peerId     = it->GetRequest().GetPeerId();
             NodeListener * listener = it->GetListener();
+            const bool fromCache    = it->IsServedFromCache();
 
             mActiveLookups.Erase(it);
             it = mActiveLookups.begin();
 
-            Dnssd::Resolver::Instance().NodeIdResolutionNoLongerNeeded(peerId);
+            if (!fromCache)
+            {
+                Dnssd::Resolver::Instance().NodeIdResolutionNoLongerNeeded(peerId);
+            }
             // Callback only called after active lookup is cleared
             // This allows failure handlers to deallocate structures that may
             // contain the active lookup data as a member (intrusive lists members)
@@ -459,6 +660,139 @@ void Resolver::ReArmTimer()
     }
 }
 
+bool Resolver::LookupFromCache(NodeLookupHandle & handle, System::Clock::Timestamp now)
+{
+    NodeAddressCache::Entry * entry = mCache.Find(handle.GetRequest().GetPeerId());
+    VerifyOrReturnValue(entry != nullptr, false);
+
+    switch (NodeAddressCache::GetState(*entry, now))
+    {
+    case NodeAddressCache::EntryState::kFresh:
+        handle.ServeFromCache(entry->results, CHIP_NO_ERROR);
+        break;
+    case NodeAddressCache::EntryState::kRefreshDue:
+    case NodeAddressCache::EntryState::kStale:
+        // Use what we have and refresh it in the background for the next lookup.
+        handle.ServeFromCache(entry->results, CHIP_NO_ERROR);
+        StartRefresh(*entry, now);
+        break;
+    case NodeAddressCache::EntryState::kNegative:
+        handle.ServeFromCache(NodeLookupResults(), entry->error);
+        break;
+    case NodeAddressCache::EntryState::kExpired:
+        StopRefresh(*entry);
+        entry->inUse = false;
+        return false;
+    }
+
+    entry->lastUsed = now;
+    return true;
+}
+
+void Resolver::UpdateCache(const Dnssd::ResolvedNodeData & nodeData, System::Clock::Timestamp now)
+{
+    VerifyOrReturn(NodeAddressCache::IsEnabled());
+
+    const PeerId & peerId           = nodeData.operationalData.peerId;
+    NodeAddressCache::Entry * entry = mCache.Find(peerId);
+
+    // Keep the nodes that are looked up, and follow announcements for nodes
+    // already in the cache; announcements of any other node are not kept.
+    VerifyOrReturn(entry != nullptr || HasDnssdLookup(peerId));
+
+    if (entry != nullptr)
+    {
+        // A background refresh is answered by any advertisement of the node.
+        StopRefresh(*entry);
+
+        if (nodeData.operationalData.ttlSeconds.has_value() && *nodeData.operationalData.ttlSeconds == 0)
+        {
+            // The node withdrew its advertisement.
+            entry->inUse = false;
+            return;
+        }
+    }
+
+    NodeLookupResults results;
+    ResolveResult result = MakeResolveResult(nodeData);
+    for (size_t i = 0; i < nodeData.resolutionData.numIPs; i++)
+    {
+        if (IsUsableAddress(nodeData.resolutionData.ipAddress[i]))
+        {
+            result.address.SetIPAddress(nodeData.resolutionData.ipAddress[i]);
+            auto score = Dnssd::IPAddressSorter::ScoreIpAddress(result.address.GetIPAddress(), result.address.GetInterface());
+            results.UpdateResults(result, score);
+        }
+    }
+    VerifyOrReturn(results.count > 0);
+
+    if (entry == nullptr)
+    {
+        entry = &mCache.NextFreeEntry();
+        StopRefresh(*entry);
+    }
+
+    const System::Clock::Seconds32 ttl(nodeData.operationalData.ttlSeconds.value_or(kCacheDefaultTtl.count()));
+    NodeAddressCache::SetResults(*entry, peerId, results, ttl, now);
+}
+
+void Resolver::StartRefresh(NodeAddressCache::Entry & entry, System::Clock::Timestamp now)
+{
+    VerifyOrReturn(!entry.refreshing);
+
+    CHIP_ERROR err = Dnssd::Resolver::Instance().ResolveNodeId(entry.peerId);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Discovery, "Failed to refresh cached address for " ChipLogFormatPeerId ": %" CHIP_ERROR_FORMAT,
+                     ChipLogValuePeerId(entry.peerId), err.Format());
+        return;
+    }
+
+    entry.refreshing      = true;
+    entry.refreshDeadline = now + kCacheRefreshTimeout;
+}
+
+void Resolver::DropCacheEntry(const PeerId & peerId)
+{
+    NodeAddressCache::Entry * entry = mCache.Find(peerId);
+    VerifyOrReturn(entry != nullptr);
+
+    StopRefresh(*entry);
+    entry->inUse = false;
+}
+
+void Resolver::StopRefresh(NodeAddressCache::Entry & entry)
+{
+    VerifyOrReturn(entry.inUse && entry.refreshing);
+
+    entry.refreshing = false;
+    Dnssd::Resolver::Instance().NodeIdResolutionNoLongerNeeded(entry.peerId);
+}
+
+void Resolver::ExpireRefreshes(System::Clock::Timestamp now)
+{
+    for (auto & entry : mCache)
+    {
+        if (entry.inUse && entry.refreshing && now >= entry.refreshDeadline)
+        {
+            // The entry goes on to expire on its own schedule.
+            StopRefresh(entry);
+        }
+    }
+}
+
+bool Resolver::HasDnssdLookup(const PeerId & peerId)
+{
+    for (auto & lookup : mActiveLookups)
+    {
+        if (!lookup.IsServedFromCache() && lookup.GetRequest().GetPeerId() == peerId)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 } // namespace Impl
 
 Resolver & Resolver::Instance()
@@ -157,10 +157,81 @@ public:
     /// be triggered for this lookup handle
     System::Clock::Timeout NextEventTimeout(System::Clock::Timestamp now);
 
+    /// Complete the lookup from cached data instead of DNS-SD: with `results`
+    /// if there are any, or else with `error`. Must be called after
+    /// ResetForLookup.
+    void ServeFromCache(const NodeLookupResults & results, CHIP_ERROR error);
+
+    /// Is the lookup served from cached data (no DNS-SD query of its own)?
+    bool IsServedFromCache() const { return mServedFromCache; }
+
 private:
     NodeLookupResults mResults;
     NodeLookupRequest mRequest; // active request to process
     System::Clock::Timestamp mRequestStartTime;
+    CHIP_ERROR mCachedError = CHIP_NO_ERROR;
+    bool mServedFromCache   = false;
+};
+
+/// Operational addresses of recently resolved nodes.
+///
+/// Entries are filled from lookup results and from any operational
+/// advertisement received for a node that already has an entry, and honor the
+/// TTL of the advertisement:
+///   - kFresh until 3/4 of the TTL, then kRefreshDue until the TTL runs out;
+///   - kStale for CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_STALE_SECONDS after that,
+///     where the entry may still be used while a refresh runs;
+///   - kExpired afterwards.
+/// A negative entry records that a lookup timed out and is kNegative for
+/// CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_NEGATIVE_TTL_SECONDS.
+class NodeAddressCache
+{
+public:
+    static constexpr size_t kCapacity = CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_SIZE;
+
+    enum class EntryState
+    {
+        kFresh,
+        kRefreshDue,
+        kStale,
+        kNegative,
+        kExpired,
+    };
+
+    struct Entry
+    {
+        PeerId peerId;
+        NodeLookupResults results; // no results for a negative entry
+        CHIP_ERROR error = CHIP_NO_ERROR;
+        System::Clock::Timestamp refreshTime     = System::Clock::kZero;
+        System::Clock::Timestamp expiryTime      = System::Clock::kZero;
+        System::Clock::Timestamp staleTime       = System::Clock::kZero;
+        System::Clock::Timestamp lastUsed        = System::Clock::kZero;
+        System::Clock::Timestamp refreshDeadline = System::Clock::kZero; // while refreshing
+        bool inUse                               = false;
+        bool refreshing                          = false; // a background DNS-SD query is running for the entry
+    };
+
+    static constexpr bool IsEnabled() { return kCapacity > 0; }
+
+    Entry * Find(const PeerId & peerId);
+
+    /// Returns an unused entry, or else the least recently used one. A refresh
+    /// still running for a returned entry is the caller's to stop.
+    Entry & NextFreeEntry();
+
+    static EntryState GetState(const Entry & entry, System::Clock::Timestamp now);
+
+    static void SetResults(Entry & entry, const PeerId & peerId, const NodeLookupResults & results,
+                           System::Clock::Seconds32 ttl, System::Clock::Timestamp now);
+    static void SetFailure(Entry & entry, const PeerId & peerId, CHIP_ERROR error, System::Clock::Timestamp now);
+
+    Entry * begin() { return &mEntries[0]; }
+    Entry * end() { return &mEntries[0] + kCapacity; }
+
+private:
+    // Keep one entry when the cache is disabled, so the array stays valid; it is never used.
+    Entry mEntries[kCapacity > 0 ? kCapacity : 1];
 };
 
 class Resolver : public ::chip::AddressResolve::Resolver, public Dnssd::OperationalResolveDelegate
@@ -200,9 +271,27 @@ private:
     /// be used after calling this method.
     void HandleAction(IntrusiveList<NodeLookupHandle>::Iterator & current);
 
+    /// Sets up `handle` to complete from the cache if the cache has usable data
+    /// for its peer, starting a background refresh when the data is due for one.
+    bool LookupFromCache(NodeLookupHandle & handle, System::Clock::Timestamp now);
+
+    /// Records the addresses of a resolved node, if the cache keeps track of it.
+    void UpdateCache(const Dnssd::ResolvedNodeData & nodeData, System::Clock::Timestamp now);
+
+    /// Forgets whatever the cache holds for `peerId`.
+    void DropCacheEntry(const PeerId & peerId);
+
+    void StartRefresh(NodeAddressCache::Entry & entry, System::Clock::Timestamp now);
+    void StopRefresh(NodeAddressCache::Entry & entry);
+    void ExpireRefreshes(System::Clock::Timestamp now);
+
+    /// Whether a lookup for `peerId` still waits on DNS-SD.
+    bool HasDnssdLookup(const PeerId & peerId);
+
     System::Layer * mSystemLayer = nullptr;
     Time::TimeSource<Time::Source::kSystem> mTimeSource;
     IntrusiveList<NodeLookupHandle> mActiveLookups;
+    NodeAddressCache mCache;
 };
 
 } // namespace Impl
@@ -19,9 +19,13 @@
 #include <lib/address_resolve/AddressResolve_DefaultImpl.h>
 #include <lib/core/StringBuilderAdapters.h>
 #include <lib/dnssd/IPAddressSorter.h>
+#include <lib/dnssd/Resolver.h>
 #include <lib/support/StringBuilder.h>
+#include <system/SystemLayerImpl.h>
 #include <transport/raw/PeerAddress.h>
 
+#include <vector>
+
 using namespace chip;
 using namespace chip::AddressResolve;
 
@@ -44,6 +48,9 @@ using chip::Dnssd::IPAddressSorter::ScoreIpAddress;
 
 constexpr uint8_t kNumberOfAvailableSlots = CHIP_CONFIG_MDNS_RESOLVE_LOOKUP_RESULTS;
 
+constexpr System::Clock::Seconds32 kCacheStaleTimeForTest{ CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_STALE_SECONDS };
+constexpr System::Clock::Seconds32 kCacheNegativeTtlForTest{ CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_NEGATIVE_TTL_SECONDS };
+
 /// Get an address that should have `kUniqueLocal` (one of the lowest) priority.
 ///
 /// Since for various tests we check filling the cache with values, we allow
@@ -102,6 +109,91 @@ Transport::PeerAddress GetAddressWithHighScore(uint16_t port = CHIP_PORT, Inet::
     return Transport::PeerAddress::UDP(ipAddress, port, interfaceId);
 }
 
+// Holds on to the single timer the resolver arms, so tests decide when it fires.
+class ManualTimerLayer : public System::LayerImpl
+{
+public:
+    CHIP_ERROR StartTimer(System::Clock::Timeout aDelay, System::TimerCompleteCallback aComplete, void * aAppState) override
+    {
+        mCallback = aComplete;
+        mAppState = aAppState;
+        return CHIP_NO_ERROR;
+    }
+
+    void CancelTimer(System::TimerCompleteCallback aOnComplete, void * aAppState) override
+    {
+        if (mCallback == aOnComplete && mAppState == aAppState)
+        {
+            mCallback = nullptr;
+        }
+    }
+
+    void Fire()
+    {
+        ASSERT_NE(mCallback, nullptr);
+        auto callback = mCallback;
+        mCallback     = nullptr;
+        callback(this, mAppState);
+    }
+
+private:
+    System::TimerCompleteCallback mCallback = nullptr;
+    void * mAppState                        = nullptr;
+};
+
+// Counts operational lookups; tests answer them by calling the resolver's delegate methods directly.
+class FakeDnssdResolver : public Dnssd::Resolver
+{
+public:
+    CHIP_ERROR Init(Inet::EndPointManager<Inet::UDPEndPoint> * udpEndPointManager) override { return CHIP_NO_ERROR; }
+    bool IsInitialized() override { return true; }
+    void Shutdown() override {}
+    void SetOperationalDelegate(Dnssd::OperationalResolveDelegate * delegate) override {}
+    CHIP_ERROR ResolveNodeId(const PeerId & peerId) override
+    {
+        mLookupCount++;
+        return CHIP_NO_ERROR;
+    }
+    void NodeIdResolutionNoLongerNeeded(const PeerId & peerId) override {}
+    CHIP_ERROR StartDiscovery(Dnssd::DiscoveryType type, Dnssd::DiscoveryFilter filter, Dnssd::DiscoveryContext &) override
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+    CHIP_ERROR StopDiscovery(Dnssd::DiscoveryContext &) override { return CHIP_ERROR_NOT_IMPLEMENTED; }
+    CHIP_ERROR ReconfirmRecord(const char * hostname, Inet::IPAddress address, Inet::InterfaceId interfaceId) override
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+
+    int mLookupCount = 0;
+};
+
+class RecordingListener : public NodeListener
+{
+public:
+    void OnNodeAddressResolved(const PeerId & peerId, const ResolveResult & result) override
+    {
+        mAddresses.push_back(result.address);
+    }
+    void OnNodeAddressResolutionFailed(const PeerId & peerId, CHIP_ERROR reason) override { mFailureCount++; }
+
+    std::vector<Transport::PeerAddress> mAddresses;
+    int mFailureCount = 0;
+};
+
+Dnssd::ResolvedNodeData MakeResolvedNodeData(const PeerId & peerId, const Transport::PeerAddress & address)
+{
+    Dnssd::ResolvedNodeData nodeData;
+    nodeData.operationalData.peerId      = peerId;
+    nodeData.operationalData.hasZeroTTL  = false;
+    nodeData.operationalData.ttlSeconds  = 120;
+    nodeData.resolutionData.interfaceId  = Inet::InterfaceId::Null();
+    nodeData.resolutionData.ipAddress[0] = address.GetIPAddress();
+    nodeData.resolutionData.numIPs       = 1;
+    nodeData.resolutionData.port         = address.GetPort();
+    return nodeData;
+}
+
 #if CHIP_CONFIG_MDNS_RESOLVE_LOOKUP_RESULTS >= 3
 
 // test requires at least 3 slots: for high, medium and low
@@ -335,4 +427,177 @@ TEST(TestAddressResolveDefaultImpl, TestLookupResult)
     // Check that the results has been consumed properly.
     EXPECT_FALSE(handle.HasLookupResult());
 }
+
+TEST(TestAddressResolveDefaultImpl, TestLookupServedFromCache)
+{
+    Impl::NodeLookupResults results;
+    ResolveResult result;
+    result.address = GetAddressWithHighScore();
+    results.UpdateResults(result, ScoreIpAddress(result.address.GetIPAddress(), Inet::InterfaceId::Null()));
+
+    AddressResolve::NodeLookupHandle handle;
+    auto now     = System::SystemClock().GetMonotonicTimestamp();
+    auto request = NodeLookupRequest(chip::PeerId(1, 2));
+
+    // Cached results do not wait for the minimal lookup time.
+    handle.ResetForLookup(now, request);
+    handle.ServeFromCache(results, CHIP_NO_ERROR);
+    EXPECT_TRUE(handle.IsServedFromCache());
+    EXPECT_EQ(handle.NextEventTimeout(now), System::Clock::Timeout::zero());
+
+    auto action = handle.NextAction(now);
+    ASSERT_EQ(action.Type(), Impl::NodeLookupResult::kLookupSuccess);
+    EXPECT_EQ(action.ResolveResult().address, result.address);
+
+    // A cached failure completes the lookup with the cached error.
+    handle.ResetForLookup(now, request);
+    handle.ServeFromCache(Impl::NodeLookupResults(), CHIP_ERROR_TIMEOUT);
+    action = handle.NextAction(now);
+    ASSERT_EQ(action.Type(), Impl::NodeLookupResult::kLookupError);
+    EXPECT_EQ(action.ErrorResult(), CHIP_ERROR_TIMEOUT);
+
+    // A new lookup on the same handle goes back to DNS-SD.
+    handle.ResetForLookup(now, request);
+    EXPECT_FALSE(handle.IsServedFromCache());
+    EXPECT_EQ(handle.NextAction(now).Type(), Impl::NodeLookupResult::kKeepSearching);
+}
+
+TEST(TestAddressResolveDefaultImpl, TestAddressCacheEntryStates)
+{
+    if (!Impl::NodeAddressCache::IsEnabled())
+    {
+        GTEST_SKIP();
+    }
+
+    using namespace System::Clock::Literals;
+    using State = Impl::NodeAddressCache::EntryState;
+
+    Impl::NodeLookupResults results;
+    ResolveResult result;
+    result.address = GetAddressWithMediumScore();
+    results.UpdateResults(result, ScoreIpAddress(result.address.GetIPAddress(), Inet::InterfaceId::Null()));
+
+    Impl::NodeAddressCache cache;
+    const PeerId peerId(1, 2);
+    const System::Clock::Timestamp start = 1000000_ms64;
+
+    EXPECT_EQ(cache.Find(peerId), nullptr);
+
+    Impl::NodeAddressCache::Entry & entry = cache.NextFreeEntry();
+    Impl::NodeAddressCache::SetResults(entry, peerId, results, System::Clock::Seconds32(120), start);
+    ASSERT_EQ(cache.Find(peerId), &entry);
+
+    EXPECT_EQ(Impl::NodeAddressCache::GetState(entry, start), State::kFresh);
+    EXPECT_EQ(Impl::NodeAddressCache::GetState(entry, start + System::Clock::Seconds64(89)), State::kFresh);
+    EXPECT_EQ(Impl::NodeAddressCache::GetState(entry, start + System::Clock::Seconds64(90)), State::kRefreshDue);
+    EXPECT_EQ(Impl::NodeAddressCache::GetState(entry, start + System::Clock::Seconds64(120)), State::kStale);
+    EXPECT_EQ(Impl::NodeAddressCache::GetState(entry, start + System::Clock::Seconds64(120) + kCacheStaleTimeForTest), State::kExpired);
+
+    // A negative entry only lives for the negative TTL and carries the error.
+    Impl::NodeAddressCache::SetFailure(entry, peerId, CHIP_ERROR_TIMEOUT, start);
+    EXPECT_EQ(entry.error, CHIP_ERROR_TIMEOUT);
+    EXPECT_EQ(Impl::NodeAddressCache::GetState(entry, start), kCacheNegativeTtlForTest.count() > 0 ? State::kNegative : State::kExpired);
+    EXPECT_EQ(Impl::NodeAddressCache::GetState(entry, start + kCacheNegativeTtlForTest), State::kExpired);
+}
+
+TEST(TestAddressResolveDefaultImpl, TestAddressCacheEvictsLeastRecentlyUsed)
+{
+    if (!Impl::NodeAddressCache::IsEnabled())
+    {
+        GTEST_SKIP();
+    }
+
+    using namespace System::Clock::Literals;
+
+    Impl::NodeLookupResults results;
+    ResolveResult result;
+    result.address = GetAddressWithLowScore();
+    results.UpdateResults(result, ScoreIpAddress(result.address.GetIPAddress(), Inet::InterfaceId::Null()));
+
+    Impl::NodeAddressCache cache;
+    for (uint64_t i = 0; i < Impl::NodeAddressCache::kCapacity; i++)
+    {
+        Impl::NodeAddressCache::SetResults(cache.NextFreeEntry(), PeerId(1, i + 1), results, System::Clock::Seconds32(120),
+                                     System::Clock::Milliseconds64(1000 + i));
+    }
+
+    // Use the oldest node, so that the second oldest is the one to go.
+    cache.Find(PeerId(1, 1))->lastUsed = 5000_ms64;
+
+    Impl::NodeAddressCache::Entry & entry = cache.NextFreeEntry();
+    if (Impl::NodeAddressCache::kCapacity > 1)
+    {
+        EXPECT_EQ(entry.peerId, PeerId(1, 2));
+    }
+    Impl::NodeAddressCache::SetResults(entry, PeerId(1, 100), results, System::Clock::Seconds32(120), 6000_ms64);
+
+    EXPECT_NE(cache.Find(PeerId(1, 100)), nullptr);
+    if (Impl::NodeAddressCache::kCapacity > 1)
+    {
+        EXPECT_NE(cache.Find(PeerId(1, 1)), nullptr);
+        EXPECT_EQ(cache.Find(PeerId(1, 2)), nullptr);
+    }
+}
+
+TEST(TestAddressResolveDefaultImpl, TestBypassCacheRefreshesEntry)
+{
+    if (!Impl::NodeAddressCache::IsEnabled())
+    {
+        GTEST_SKIP();
+    }
+
+    Dnssd::Resolver & previousDnssdResolver = Dnssd::Resolver::Instance();
+    FakeDnssdResolver dnssdResolver;
+    Dnssd::Resolver::SetInstance(dnssdResolver);
+
+    ManualTimerLayer layer;
+    Impl::Resolver resolver;
+    ASSERT_EQ(resolver.Init(&layer), CHIP_NO_ERROR);
+
+    const PeerId peerId(1, 2);
+    const Transport::PeerAddress oldAddress = GetAddressWithMediumScore();
+    const Transport::PeerAddress newAddress = GetAddressWithHighScore();
+    RecordingListener listener;
+    AddressResolve::NodeLookupHandle handle;
+    handle.SetListener(&listener);
+
+    // The first lookup goes to DNS-SD and fills the cache.
+    NodeLookupRequest request(peerId);
+    request.SetMinLookupTime(System::Clock::kZero);
+    ASSERT_EQ(resolver.LookupNode(request, handle), CHIP_NO_ERROR);
+    EXPECT_EQ(dnssdResolver.mLookupCount, 1);
+    resolver.OnOperationalNodeResolved(MakeResolvedNodeData(peerId, oldAddress));
+    ASSERT_EQ(listener.mAddresses.size(), 1u);
+    EXPECT_EQ(listener.mAddresses.back(), oldAddress);
+
+    // The next one is answered from the cache.
+    ASSERT_EQ(resolver.LookupNode(request, handle), CHIP_NO_ERROR);
+    EXPECT_TRUE(handle.IsServedFromCache());
+    layer.Fire();
+    EXPECT_EQ(dnssdResolver.mLookupCount, 1);
+    ASSERT_EQ(listener.mAddresses.size(), 2u);
+    EXPECT_EQ(listener.mAddresses.back(), oldAddress);
+
+    // An address update bypasses the cache, and what it finds replaces the cached address.
+    request.SetBypassCache(true);
+    ASSERT_EQ(resolver.LookupNode(request, handle), CHIP_NO_ERROR);
+    EXPECT_FALSE(handle.IsServedFromCache());
+    EXPECT_EQ(dnssdResolver.mLookupCount, 2);
+    resolver.OnOperationalNodeResolved(MakeResolvedNodeData(peerId, newAddress));
+    ASSERT_EQ(listener.mAddresses.size(), 3u);
+    EXPECT_EQ(listener.mAddresses.back(), newAddress);
+
+    request.SetBypassCache(false);
+    ASSERT_EQ(resolver.LookupNode(request, handle), CHIP_NO_ERROR);
+    EXPECT_TRUE(handle.IsServedFromCache());
+    layer.Fire();
+    EXPECT_EQ(dnssdResolver.mLookupCount, 2);
+    ASSERT_EQ(listener.mAddresses.size(), 4u);
+    EXPECT_EQ(listener.mAddresses.back(), newAddress);
+    EXPECT_EQ(listener.mFailureCount, 0);
+
+    resolver.Shutdown();
+    Dnssd::Resolver::SetInstance(previousDnssdResolver);
+}
+
 } // namespace
@@ -1248,6 +1248,17 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE (3 * CHIP_CONFIG_MAX_FABRICS)
 #endif
 
+/**
+ * @def CHIP_CONFIG_CERTIFICATE_VALIDATION_CACHE_SIZE
+ *
+ * @brief
+ *   Number of intermediate certificates a Credentials::CertificateValidationCache remembers as
+ *   verified against their root.  Only applies when the application sets up such a cache.
+ */
+#ifndef CHIP_CONFIG_CERTIFICATE_VALIDATION_CACHE_SIZE
+#define CHIP_CONFIG_CERTIFICATE_VALIDATION_CACHE_SIZE CHIP_CONFIG_MAX_FABRICS
+#endif
+
 /**
  * @def CHIP_CONFIG_EVENT_LOGGING_BYTE_THRESHOLD
  *
@@ -1268,6 +1279,26 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_EVENT_LOGGING_BYTE_THRESHOLD 512
 #endif /* CHIP_CONFIG_EVENT_LOGGING_BYTE_THRESHOLD */
 
+/**
+ * @def CHIP_CONFIG_EVENT_LOG_QUEUE_MAX_PAYLOAD_SIZE
+ *
+ * @brief The largest TLV-encoded event payload, in bytes, that can be
+ *   handed to an EventLogQueue.  Every queue slot reserves this much space.
+ */
+#ifndef CHIP_CONFIG_EVENT_LOG_QUEUE_MAX_PAYLOAD_SIZE
+#define CHIP_CONFIG_EVENT_LOG_QUEUE_MAX_PAYLOAD_SIZE 128
+#endif /* CHIP_CONFIG_EVENT_LOG_QUEUE_MAX_PAYLOAD_SIZE */
+
+/**
+ * @def CHIP_CONFIG_EVENT_LOG_QUEUE_DRAIN_BATCH_SIZE
+ *
+ * @brief The number of queued events an EventLogQueue logs per pass on the
+ *   Matter thread before yielding back to the event loop.
+ */
+#ifndef CHIP_CONFIG_EVENT_LOG_QUEUE_DRAIN_BATCH_SIZE
+#define CHIP_CONFIG_EVENT_LOG_QUEUE_DRAIN_BATCH_SIZE 8
+#endif /* CHIP_CONFIG_EVENT_LOG_QUEUE_DRAIN_BATCH_SIZE */
+
 /**
  * @def CHIP_CONFIG_ENABLE_SERVER_IM_EVENT
  *
@@ -1391,6 +1422,45 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_MINMDNS_MAX_PARALLEL_RESOLVES 2
 #endif // CHIP_CONFIG_MINMDNS_MAX_PARALLEL_RESOLVES
 
+/*
+ * @def CHIP_CONFIG_MINMDNS_MAX_BULK_RESOLVES
+ *
+ * @brief Determines the maximum number of operational nodes the minmdns
+ *        resolver can resolve together through a single browse for all
+ *        operational services, instead of querying each node on its own.
+ *
+ *        Useful for controllers that connect to many nodes at once.
+ *        Set to 0 to disable bulk resolution.
+ */
+#ifndef CHIP_CONFIG_MINMDNS_MAX_BULK_RESOLVES
+#define CHIP_CONFIG_MINMDNS_MAX_BULK_RESOLVES 0
+#endif // CHIP_CONFIG_MINMDNS_MAX_BULK_RESOLVES
+
+/*
+ * @def CHIP_CONFIG_MINMDNS_BULK_RESOLVE_THRESHOLD
+ *
+ * @brief Number of operational nodes that have to be resolved at the same
+ *        time before further nodes are resolved in bulk.
+ *
+ *        Only used if CHIP_CONFIG_MINMDNS_MAX_BULK_RESOLVES is not 0.
+ */
+#ifndef CHIP_CONFIG_MINMDNS_BULK_RESOLVE_THRESHOLD
+#define CHIP_CONFIG_MINMDNS_BULK_RESOLVE_THRESHOLD 4
+#endif // CHIP_CONFIG_MINMDNS_BULK_RESOLVE_THRESHOLD
+
+/**
+ * @def CHIP_CONFIG_MINMDNS_RESPONSE_CACHE_SIZE
+ *
+ * @brief Number of serialized minimal mDNS responses kept to answer repeated
+ *        queries without building the response again.
+ *
+ *        Cached responses are dropped whenever the advertised services change.
+ *        Each entry takes about 800 bytes. 0 disables the cache.
+ */
+#ifndef CHIP_CONFIG_MINMDNS_RESPONSE_CACHE_SIZE
+#define CHIP_CONFIG_MINMDNS_RESPONSE_CACHE_SIZE 0
+#endif // CHIP_CONFIG_MINMDNS_RESPONSE_CACHE_SIZE
+
 /**
  * def CHIP_CONFIG_MDNS_RESOLVE_LOOKUP_RESULTS
  *
@@ -1424,6 +1494,48 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_ADDRESS_RESOLVE_MAX_LOOKUP_TIME_MS 45000
 #endif // CHIP_CONFIG_ADDRESS_RESOLVE_MAX_LOOKUP_TIME_MS
 
+/**
+ * @def CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_SIZE
+ *
+ * @brief Number of nodes whose operational addresses the address resolver
+ *        remembers between lookups.  A lookup for a remembered node completes
+ *        right away instead of waiting on DNS-SD.  0 disables the cache.
+ */
+#ifndef CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_SIZE
+#define CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_SIZE 8
+#endif // CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_SIZE
+
+/**
+ * @def CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_DEFAULT_TTL_SECONDS
+ *
+ * @brief How long a cached address stays fresh when the DNS-SD backend does
+ *        not report the TTL of the advertisement, in seconds
+ */
+#ifndef CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_DEFAULT_TTL_SECONDS
+#define CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_DEFAULT_TTL_SECONDS 120
+#endif // CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_DEFAULT_TTL_SECONDS
+
+/**
+ * @def CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_STALE_SECONDS
+ *
+ * @brief How long after its TTL has run out a cached address is still used,
+ *        while a DNS-SD lookup in the background refreshes it, in seconds
+ */
+#ifndef CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_STALE_SECONDS
+#define CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_STALE_SECONDS 60
+#endif // CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_STALE_SECONDS
+
+/**
+ * @def CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_NEGATIVE_TTL_SECONDS
+ *
+ * @brief How long the address resolver remembers that a lookup for a node
+ *        timed out, failing further lookups for it right away, in seconds.
+ *        0 disables negative caching.
+ */
+#ifndef CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_NEGATIVE_TTL_SECONDS
+#define CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_NEGATIVE_TTL_SECONDS 5
+#endif // CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_NEGATIVE_TTL_SECONDS
+
 /*
  * @def CHIP_CONFIG_NETWORK_COMMISSIONING_DEBUG_TEXT_BUFFER_SIZE
  *
@@ -106,6 +106,28 @@ void TLVCircularBuffer::Init(uint8_t * inBuffer, uint32_t inBufferLength)
     mImplicitProfileId = kCommonProfileId;
 }
 
+/**
+ * @brief
+ *   Restore the queue state of a buffer whose backing store already holds data, e.g. storage that
+ *   outlives the process.  The caller is responsible for the data being a sequence of complete
+ *   top-level TLV elements.
+ *
+ * @param[in] inHeadOffset  Offset of the queue head from the start of the backing store
+ *
+ * @param[in] inDataLength  Number of bytes of data in the queue, starting at the head
+ *
+ * @retval #CHIP_NO_ERROR               On success.
+ * @retval #CHIP_ERROR_INVALID_ARGUMENT If the state does not fit the backing store.
+ */
+CHIP_ERROR TLVCircularBuffer::Restore(uint32_t inHeadOffset, uint32_t inDataLength)
+{
+    VerifyOrReturnError(inHeadOffset < mQueueSize && inDataLength <= mQueueSize, CHIP_ERROR_INVALID_ARGUMENT);
+
+    mQueueHead   = mQueue + inHeadOffset;
+    mQueueLength = inDataLength;
+    return CHIP_NO_ERROR;
+}
+
 /**
  * @brief
  *   Evicts the oldest top-level TLV element in the TLVCircularBuffer
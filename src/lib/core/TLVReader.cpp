@@ -47,7 +47,59 @@ namespace TLV {
 
 using namespace chip::Encoding;
 
-static const uint8_t sTagSizes[] = { 0, 1, 2, 4, 2, 4, 6, 8 };
+static constexpr uint8_t sTagSizes[] = { 0, 1, 2, 4, 2, 4, 6, 8 };
+
+namespace {
+
+// Each sControlByteInfo entry holds the size of the element head (control byte, tag and length/value field)
+// in its low bits, 0 if the element type is invalid, plus the flags below.
+constexpr uint8_t kElementHeadSizeMask     = 0x1F;
+constexpr uint8_t kElementHasLength        = 0x20;
+constexpr uint8_t kElementIsContainer      = 0x40;
+constexpr uint8_t kElementIsEndOfContainer = 0x80;
+
+struct ControlByteInfoTable
+{
+    uint8_t mEntries[256];
+};
+
+constexpr ControlByteInfoTable MakeControlByteInfoTable()
+{
+    ControlByteInfoTable table = {};
+    for (unsigned controlByte = 0; controlByte < 256; controlByte++)
+    {
+        const auto elemType = static_cast<TLVElementType>(controlByte & kTLVTypeMask);
+        if (!IsValidTLVType(elemType))
+        {
+            continue;
+        }
+
+        uint8_t info = static_cast<uint8_t>(1 + sTagSizes[controlByte >> kTLVTagControlShift] +
+                                            TLVFieldSizeToBytes(GetTLVFieldSize(elemType)));
+        if (TLVTypeHasLength(elemType))
+        {
+            info |= kElementHasLength;
+        }
+        if (elemType >= TLVElementType::Structure && elemType <= TLVElementType::List)
+        {
+            info |= kElementIsContainer;
+        }
+        if (elemType == TLVElementType::EndOfContainer)
+        {
+            info |= kElementIsEndOfContainer;
+        }
+        table.mEntries[controlByte] = info;
+    }
+    return table;
+}
+
+constexpr ControlByteInfoTable sControlByteInfo = MakeControlByteInfoTable();
+
+static_assert((sControlByteInfo.mEntries[0x35] & kElementHeadSizeMask) == 2, "Context-tagged structure has a 2 byte head");
+static_assert((sControlByteInfo.mEntries[0x18] & kElementIsEndOfContainer) != 0, "End of container is flagged");
+static_assert(sControlByteInfo.mEntries[0x19] == 0, "Reserved element types are invalid");
+
+} // namespace
 
 TLVReader::TLVReader() :
     ImplicitProfileId(kProfileIdNotSpecified), AppData(nullptr), mElemLenOrVal(0), mBackingStore(nullptr), mReadPoint(nullptr),
@@ -732,12 +784,110 @@ CHIP_ERROR TLVReader::SkipToEndOfContainer()
         if (err != CHIP_NO_ERROR)
             return err;
 
+        SkipElementsInBuffer(nestLevel, outerContainerType);
+
         err = ReadElement();
         if (err != CHIP_NO_ERROR)
             return err;
     }
 }
 
+/**
+ * Fast path for SkipToEndOfContainer: step over complete elements that lie entirely within the current
+ * input buffer using the precomputed control byte table instead of decoding each element head.
+ *
+ * Stops on an element boundary at the end of the buffer, before the end of the container being skipped,
+ * and before any element whose validation needs the full decoder (implicit or fully-qualified tags, tags
+ * not allowed in the enclosing container, invalid types, or data running past the buffer).  The caller
+ * then reads the next element the regular way, so errors are reported exactly as without the fast path.
+ */
+void TLVReader::SkipElementsInBuffer(uint32_t & nestLevel, TLVType outerContainerType)
+{
+    const uint8_t * p     = mReadPoint;
+    TLVType containerType = mContainerType;
+
+    while (p < mBufEnd)
+    {
+        const uint8_t controlByte = *p;
+        const uint8_t info        = sControlByteInfo.mEntries[controlByte];
+        const uint8_t headBytes   = static_cast<uint8_t>(info & kElementHeadSizeMask);
+        const uint8_t tagControl  = static_cast<uint8_t>(controlByte & kTLVTagControlMask);
+        const size_t available    = static_cast<size_t>(mBufEnd - p);
+
+        if (headBytes == 0 || headBytes > available ||
+            tagControl > static_cast<uint8_t>(TLVTagControl::CommonProfile_4Bytes))
+        {
+            break;
+        }
+
+        const bool isAnonymous = (tagControl == static_cast<uint8_t>(TLVTagControl::Anonymous));
+
+        if (info & kElementIsEndOfContainer)
+        {
+            if (nestLevel == 0 || !isAnonymous)
+            {
+                break;
+            }
+            nestLevel--;
+            containerType = (nestLevel == 0) ? outerContainerType : kTLVType_UnknownContainer;
+            p += headBytes;
+            continue;
+        }
+
+        // Same tag rules as VerifyElement.
+        bool tagAllowed;
+        switch (containerType)
+        {
+        case kTLVType_NotSpecified:
+            tagAllowed = (tagControl != static_cast<uint8_t>(TLVTagControl::ContextSpecific));
+            break;
+        case kTLVType_Structure:
+            tagAllowed = !isAnonymous;
+            break;
+        case kTLVType_Array:
+            tagAllowed = isAnonymous;
+            break;
+        case kTLVType_UnknownContainer:
+        case kTLVType_List:
+            tagAllowed = true;
+            break;
+        default:
+            tagAllowed = false;
+            break;
+        }
+        if (!tagAllowed)
+        {
+            break;
+        }
+
+        size_t dataBytes = 0;
+        if (info & kElementHasLength)
+        {
+            // The length field is the last part of the head.
+            const uint8_t lenBytes = static_cast<uint8_t>(1 << (controlByte & kTLVTypeSizeMask));
+            uint64_t len           = 0;
+            memcpy(&len, p + headBytes - lenBytes, lenBytes);
+            LittleEndian::HostSwap(len);
+            if (len > available - headBytes)
+            {
+                break;
+            }
+            dataBytes = static_cast<size_t>(len);
+        }
+        else if (info & kElementIsContainer)
+        {
+            nestLevel++;
+            containerType = static_cast<TLVType>(controlByte & kTLVTypeMask);
+        }
+
+        p += headBytes + dataBytes;
+    }
+
+    mLenRead += static_cast<uint32_t>(p - mReadPoint);
+    mReadPoint     = p;
+    mContainerType = containerType;
+}
+
 CHIP_ERROR TLVReader::ReadElement()
 {
     // Make sure we have input data. Return CHIP_END_OF_TLV if no more data is available.
@@ -747,40 +897,43 @@ CHIP_ERROR TLVReader::ReadElement()
     // Get the element's control byte.
     mControlByte = *mReadPoint;
 
-    // Extract the element type from the control byte. Fail if it's invalid.
-    TLVElementType elemType = ElementType();
-    VerifyOrReturnError(IsValidTLVType(elemType), CHIP_ERROR_INVALID_TLV_ELEMENT);
+    // Look up the number of bytes in the element's 'head'. This includes: the control byte, the tag bytes (if present), the
+    // length bytes (if present), and for elements that don't have a length (e.g. integers), the value bytes.  The entry is
+    // zero if the element type is invalid.
+    const uint8_t elemHeadBytes = static_cast<uint8_t>(sControlByteInfo.mEntries[mControlByte] & kElementHeadSizeMask);
+    VerifyOrReturnError(elemHeadBytes != 0, CHIP_ERROR_INVALID_TLV_ELEMENT);
 
-    // Extract the tag control from the control byte.
+    TLVElementType elemType  = ElementType();
     TLVTagControl tagControl = static_cast<TLVTagControl>(mControlByte & kTLVTagControlMask);
 
-    // Determine the number of bytes in the element's tag, if any.
-    uint8_t tagBytes = sTagSizes[tagControl >> kTLVTagControlShift];
-
-    // Extract the size of length/value field from the control byte.
-    TLVFieldSize lenOrValFieldSize = GetTLVFieldSize(elemType);
-
     // Determine the number of bytes in the length/value field.
-    const uint8_t valOrLenBytes = TLVFieldSizeToBytes(lenOrValFieldSize);
-
-    // Determine the number of bytes in the element's 'head'. This includes: the control byte, the tag bytes (if present), the
-    // length bytes (if present), and for elements that don't have a length (e.g. integers), the value bytes.
-    const uint8_t elemHeadBytes = static_cast<uint8_t>(1 + tagBytes + valOrLenBytes);
+    const uint8_t valOrLenBytes = TLVFieldSizeToBytes(GetTLVFieldSize(elemType));
 
     // 17 = 1 control byte + 8 tag bytes + 8 length/value bytes
     uint8_t stagingBuf[17];
+    const uint8_t * p;
 
-    // Odd workaround: clang-tidy claims garbage value otherwise as it does not
-    // understand that ReadData initializes stagingBuf
-    stagingBuf[1] = 0;
+    if (static_cast<size_t>(mBufEnd - mReadPoint) >= elemHeadBytes)
+    {
+        // The whole head is in the current input buffer: parse it in place.
+        // +1 to skip over the control byte
+        p = mReadPoint + 1;
+        mReadPoint += elemHeadBytes;
+        mLenRead += elemHeadBytes;
+    }
+    else
+    {
+        // Odd workaround: clang-tidy claims garbage value otherwise as it does not
+        // understand that ReadData initializes stagingBuf
+        stagingBuf[1] = 0;
 
-    // If the head of the element goes past the end of the current input buffer,
-    // we need to read it into the staging buffer to parse it.  Just do that unconditionally,
-    // even if the head does not go past end of current buffer, to save codesize.
-    ReturnErrorOnFailure(ReadData(stagingBuf, elemHeadBytes));
+        // The head of the element goes past the end of the current input buffer, so
+        // read it into the staging buffer to parse it.
+        ReturnErrorOnFailure(ReadData(stagingBuf, elemHeadBytes));
 
-    // +1 to skip over the control byte
-    const uint8_t * p = stagingBuf + 1;
+        // +1 to skip over the control byte
+        p = stagingBuf + 1;
+    }
 
     // Read the tag field, if present.
     mElemTag      = ReadTag(tagControl, p);
@@ -974,6 +974,7 @@ protected:
     void ClearElementState();
     CHIP_ERROR SkipData();
     CHIP_ERROR SkipToEndOfContainer();
+    void SkipElementsInBuffer(uint32_t & nestLevel, TLVType outerContainerType);
     CHIP_ERROR VerifyElement();
     Tag ReadTag(TLVTagControl tagControl, const uint8_t *& p) const;
     CHIP_ERROR EnsureData(CHIP_ERROR noDataErr);
@@ -0,0 +1,253 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @file
+ *   Microbenchmarks for TLV skip, copy and iterate over payloads shaped like Interaction Model
+ *   reports: a ReportDataMessage holding many AttributeReportIBs with nested paths, scalar values,
+ *   strings and lists of structures.
+ *
+ *   Every case is run over a contiguous buffer and over the same bytes split into small chunks, which
+ *   forces the reader to decode element by element.
+ *
+ *   Usage: tlv-benchmark [iterations]
+ */
+
+#include <lib/core/CHIPError.h>
+#include <lib/core/TLV.h>
+#include <lib/core/TLVBackingStore.h>
+#include <lib/core/TLVUtilities.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/tests/BenchmarkHelpers.h>
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace chip;
+using namespace chip::TLV;
+
+namespace {
+
+constexpr uint64_t kDefaultIterations = 20000;
+constexpr size_t kPayloadBufferSize   = 16384;
+constexpr uint32_t kChunkSize         = 64;
+constexpr uint16_t kAttributeReports  = 64;
+
+uint8_t gPayload[kPayloadBufferSize];
+uint32_t gPayloadLength;
+uint8_t gCopyBuffer[kPayloadBufferSize];
+
+class ChunkedBackingStore : public TLVBackingStore
+{
+public:
+    CHIP_ERROR OnInit(TLVReader & reader, const uint8_t *& bufStart, uint32_t & bufLen) override
+    {
+        bufStart = gPayload;
+        bufLen   = std::min(kChunkSize, gPayloadLength);
+        return CHIP_NO_ERROR;
+    }
+
+    // Readers copied from one another share the store, so continue from wherever the asking reader is.
+    CHIP_ERROR GetNextBuffer(TLVReader & reader, const uint8_t *& bufStart, uint32_t & bufLen) override
+    {
+        const auto offset = static_cast<uint32_t>(reader.GetReadPoint() - gPayload);
+        bufStart          = reader.GetReadPoint();
+        bufLen            = std::min(kChunkSize, gPayloadLength - offset);
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR OnInit(TLVWriter & writer, uint8_t *& bufStart, uint32_t & bufLen) override { return CHIP_ERROR_NOT_IMPLEMENTED; }
+    CHIP_ERROR GetNewBuffer(TLVWriter & writer, uint8_t *& bufStart, uint32_t & bufLen) override
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+    CHIP_ERROR FinalizeBuffer(TLVWriter & writer, uint8_t * bufStart, uint32_t bufLen) override
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+};
+
+ChunkedBackingStore gChunkedStore;
+
+CHIP_ERROR EncodeAttributeReport(TLVWriter & writer, uint16_t index)
+{
+    TLVType report, attributeData, path, value, entry;
+
+    ReturnErrorOnFailure(writer.StartContainer(AnonymousTag(), kTLVType_Structure, report));
+    ReturnErrorOnFailure(writer.StartContainer(ContextTag(1), kTLVType_Structure, attributeData));
+    ReturnErrorOnFailure(writer.Put(ContextTag(0), static_cast<uint32_t>(0x12345678 + index)));
+
+    ReturnErrorOnFailure(writer.StartContainer(ContextTag(1), kTLVType_List, path));
+    ReturnErrorOnFailure(writer.Put(ContextTag(2), static_cast<uint16_t>(1 + index % 4)));
+    ReturnErrorOnFailure(writer.Put(ContextTag(3), static_cast<uint32_t>(0x0028 + index % 8)));
+    ReturnErrorOnFailure(writer.Put(ContextTag(4), static_cast<uint32_t>(index)));
+    ReturnErrorOnFailure(writer.EndContainer(path));
+
+    switch (index % 3)
+    {
+    case 0:
+        ReturnErrorOnFailure(writer.Put(ContextTag(2), static_cast<uint64_t>(index) * 1000));
+        break;
+    case 1:
+        ReturnErrorOnFailure(writer.PutString(ContextTag(2), "Long attribute string value for a report"));
+        break;
+    default:
+        // A list of structures, like a Descriptor or AccessControl entry list.
+        ReturnErrorOnFailure(writer.StartContainer(ContextTag(2), kTLVType_Array, value));
+        for (uint8_t i = 0; i < 6; i++)
+        {
+            ReturnErrorOnFailure(writer.StartContainer(AnonymousTag(), kTLVType_Structure, entry));
+            ReturnErrorOnFailure(writer.Put(ContextTag(0), i));
+            ReturnErrorOnFailure(writer.Put(ContextTag(1), static_cast<uint32_t>(0x0100 + i)));
+            ReturnErrorOnFailure(writer.PutBoolean(ContextTag(2), (i % 2) == 0));
+            const uint8_t bytes[8] = { i, 1, 2, 3, 4, 5, 6, 7 };
+            ReturnErrorOnFailure(writer.PutBytes(ContextTag(3), bytes, sizeof(bytes)));
+            ReturnErrorOnFailure(writer.EndContainer(entry));
+        }
+        ReturnErrorOnFailure(writer.EndContainer(value));
+        break;
+    }
+
+    ReturnErrorOnFailure(writer.EndContainer(attributeData));
+    return writer.EndContainer(report);
+}
+
+CHIP_ERROR EncodeReportData()
+{
+    TLVWriter writer;
+    TLVType reportData, reports;
+    writer.Init(gPayload);
+
+    ReturnErrorOnFailure(writer.StartContainer(AnonymousTag(), kTLVType_Structure, reportData));
+    ReturnErrorOnFailure(writer.Put(ContextTag(0), static_cast<uint32_t>(0x5a5a5a5a)));
+    ReturnErrorOnFailure(writer.StartContainer(ContextTag(1), kTLVType_Array, reports));
+    for (uint16_t i = 0; i < kAttributeReports; i++)
+    {
+        ReturnErrorOnFailure(EncodeAttributeReport(writer, i));
+    }
+    ReturnErrorOnFailure(writer.EndContainer(reports));
+    ReturnErrorOnFailure(writer.PutBoolean(ContextTag(4), true));
+    ReturnErrorOnFailure(writer.Put(ContextTag(0xFF), static_cast<uint8_t>(12)));
+    ReturnErrorOnFailure(writer.EndContainer(reportData));
+    ReturnErrorOnFailure(writer.Finalize());
+
+    gPayloadLength = writer.GetLengthWritten();
+    return CHIP_NO_ERROR;
+}
+
+void InitReader(TLVReader & reader, bool chunked)
+{
+    if (chunked)
+    {
+        reader.Init(gChunkedStore, gPayloadLength);
+    }
+    else
+    {
+        reader.Init(gPayload, gPayloadLength);
+    }
+}
+
+bool SkipReport(bool chunked)
+{
+    TLVReader reader;
+    InitReader(reader, chunked);
+    VerifyOrReturnValue(reader.Next() == CHIP_NO_ERROR, false);
+    VerifyOrReturnValue(reader.Skip() == CHIP_NO_ERROR, false);
+    Test::DoNotOptimize(reader.GetLengthRead());
+    return reader.GetLengthRead() == gPayloadLength;
+}
+
+bool SkipEachAttributeReport(bool chunked)
+{
+    TLVReader reader;
+    TLVType reportData, reports;
+    InitReader(reader, chunked);
+    VerifyOrReturnValue(reader.Next() == CHIP_NO_ERROR, false);
+    VerifyOrReturnValue(reader.EnterContainer(reportData) == CHIP_NO_ERROR, false);
+    VerifyOrReturnValue(reader.Next(ContextTag(0)) == CHIP_NO_ERROR, false);
+    VerifyOrReturnValue(reader.Next(ContextTag(1)) == CHIP_NO_ERROR, false);
+    VerifyOrReturnValue(reader.EnterContainer(reports) == CHIP_NO_ERROR, false);
+
+    size_t count = 0;
+    CHIP_ERROR err;
+    while ((err = reader.Next()) == CHIP_NO_ERROR)
+    {
+        count++;
+    }
+    VerifyOrReturnValue(err == CHIP_END_OF_TLV, false);
+    VerifyOrReturnValue(reader.ExitContainer(reports) == CHIP_NO_ERROR, false);
+    VerifyOrReturnValue(reader.ExitContainer(reportData) == CHIP_NO_ERROR, false);
+    return count == kAttributeReports;
+}
+
+bool CopyReport(bool chunked)
+{
+    TLVReader reader;
+    TLVWriter writer;
+    InitReader(reader, chunked);
+    writer.Init(gCopyBuffer);
+    VerifyOrReturnValue(reader.Next() == CHIP_NO_ERROR, false);
+    VerifyOrReturnValue(writer.CopyElement(AnonymousTag(), reader) == CHIP_NO_ERROR, false);
+    VerifyOrReturnValue(writer.Finalize() == CHIP_NO_ERROR, false);
+    return writer.GetLengthWritten() == gPayloadLength;
+}
+
+bool IterateReport(bool chunked)
+{
+    TLVReader reader;
+    size_t count = 0;
+    InitReader(reader, chunked);
+    VerifyOrReturnValue(reader.Next() == CHIP_NO_ERROR, false);
+    VerifyOrReturnValue(Utilities::Count(reader, count, true) == CHIP_NO_ERROR, false);
+    Test::DoNotOptimize(count);
+    return count > kAttributeReports;
+}
+
+void RunCase(const char * name, bool (*body)(bool), uint64_t iterations)
+{
+    char caseName[64];
+
+    snprintf(caseName, sizeof(caseName), "%s/contiguous", name);
+    Test::PrintBenchmarkResult(Test::RunBenchmark(caseName, iterations, [body](uint64_t) { return body(false); }));
+
+    snprintf(caseName, sizeof(caseName), "%s/chunked-%u", name, static_cast<unsigned>(kChunkSize));
+    Test::PrintBenchmarkResult(Test::RunBenchmark(caseName, iterations, [body](uint64_t) { return body(true); }));
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+    const uint64_t iterations = (argc > 1) ? strtoull(argv[1], nullptr, 0) : kDefaultIterations;
+
+    if (EncodeReportData() != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "Failed to encode the report payload\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("Report payload: %u bytes, %u attribute reports\n\n", static_cast<unsigned>(gPayloadLength),
+           static_cast<unsigned>(kAttributeReports));
+    Test::PrintBenchmarkHeader();
+    RunCase("Skip(ReportData)", SkipReport, iterations);
+    RunCase("Next+ExitContainer(AttributeReportIBs)", SkipEachAttributeReport, iterations);
+    RunCase("CopyElement(ReportData)", CopyReport, iterations);
+    RunCase("Utilities::Count(ReportData, recurse)", IterateReport, iterations);
+    return EXIT_SUCCESS;
+}
@@ -43,6 +43,7 @@
 
 #include <system/TLVPacketBufferBackingStore.h>
 
+#include <algorithm>
 #include <stdlib.h>
 #include <string.h>
 
@@ -2449,6 +2450,39 @@ TEST_F(TestTLV, CheckCircularTLVBufferEvictStraddlingEvent)
     TestEnd<TLVReader>(reader);
 }
 
+TEST_F(TestTLV, CheckCircularTLVBufferRestore)
+{
+    uint8_t element[8];
+    uint8_t backingStore[14];
+    TLVCircularBuffer buffer(backingStore, sizeof(backingStore));
+    TLVWriter writer;
+    CircularTLVReader reader;
+
+    // A head at the end of the backing store is outside of it, and so is more data than the store holds.
+    EXPECT_EQ(buffer.Restore(sizeof(backingStore), 0), CHIP_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(buffer.Restore(sizeof(backingStore) + 1, 0), CHIP_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(buffer.Restore(0, sizeof(backingStore) + 1), CHIP_ERROR_INVALID_ARGUMENT);
+
+    // An element whose first byte is the last byte of the backing store, wrapping around to its start.
+    writer.Init(element);
+    writer.ImplicitProfileId = TestProfile_2;
+    EXPECT_EQ(writer.PutBoolean(ProfileTag(TestProfile_1, 2), true), CHIP_NO_ERROR);
+    EXPECT_EQ(writer.Finalize(), CHIP_NO_ERROR);
+    const uint32_t length = writer.GetLengthWritten();
+    ASSERT_LE(length, sizeof(backingStore));
+
+    backingStore[sizeof(backingStore) - 1] = element[0];
+    memcpy(backingStore, element + 1, length - 1);
+    EXPECT_EQ(buffer.Restore(sizeof(backingStore) - 1, length), CHIP_NO_ERROR);
+    EXPECT_EQ(buffer.DataLength(), length);
+
+    reader.Init(buffer);
+    reader.ImplicitProfileId = TestProfile_2;
+    TestNext<TLVReader>(reader);
+    TEST_GET_NOERROR(reader, kTLVType_Boolean, ProfileTag(TestProfile_1, 2), true);
+    TestEnd<TLVReader>(reader);
+}
+
 TEST_F(TestTLV, CheckCircularTLVBufferEdge)
 {
     TestTLVContext * context = &TestTLV::ctx;
@@ -4938,3 +4972,119 @@ TEST_F(TestTLV, TestUninitializedWriter)
         EXPECT_EQ(writer.CopyContainer(ContextTag(1), buf, static_cast<uint16_t>(sizeof(buf))), CHIP_ERROR_INCORRECT_STATE);
     }
 }
+
+namespace {
+
+/**
+ * Hands out the encoding a few bytes at a time, so that the reader can never skip an element out of a single
+ * contiguous buffer.
+ */
+class ChunkedBackingStore : public TLVBackingStore
+{
+public:
+    ChunkedBackingStore(ByteSpan aData, uint32_t aChunkSize) : mData(aData), mChunkSize(aChunkSize) {}
+
+    CHIP_ERROR OnInit(TLVReader & reader, const uint8_t *& bufStart, uint32_t & bufLen) override
+    {
+        bufStart = mData.data();
+        bufLen   = std::min(mChunkSize, static_cast<uint32_t>(mData.size()));
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR GetNextBuffer(TLVReader & reader, const uint8_t *& bufStart, uint32_t & bufLen) override
+    {
+        const auto offset = static_cast<uint32_t>(reader.GetReadPoint() - mData.data());
+        bufStart          = reader.GetReadPoint();
+        bufLen            = std::min(mChunkSize, static_cast<uint32_t>(mData.size()) - offset);
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR OnInit(TLVWriter & writer, uint8_t *& bufStart, uint32_t & bufLen) override { return CHIP_ERROR_NOT_IMPLEMENTED; }
+    CHIP_ERROR GetNewBuffer(TLVWriter & writer, uint8_t *& bufStart, uint32_t & bufLen) override
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+    CHIP_ERROR FinalizeBuffer(TLVWriter & writer, uint8_t * bufStart, uint32_t bufLen) override
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+
+private:
+    ByteSpan mData;
+    uint32_t mChunkSize;
+};
+
+// Skip the first top-level element and return the error, along with the length read and the next element.
+CHIP_ERROR SkipFirstElement(TLVReader & reader, uint32_t & lengthRead, uint8_t & nextValue)
+{
+    ReturnErrorOnFailure(reader.Next());
+    ReturnErrorOnFailure(reader.Skip());
+    lengthRead = reader.GetLengthRead();
+    ReturnErrorOnFailure(reader.Next());
+    return reader.Get(nextValue);
+}
+
+void CheckSkipMatchesChunkedReader(ByteSpan encoding, CHIP_ERROR expectedError)
+{
+    uint32_t contiguousLength = 0;
+    uint8_t contiguousNext    = 0;
+    TLVReader contiguousReader;
+    contiguousReader.Init(encoding);
+    EXPECT_EQ(SkipFirstElement(contiguousReader, contiguousLength, contiguousNext), expectedError);
+
+    uint32_t chunkedLength = 0;
+    uint8_t chunkedNext    = 0;
+    ChunkedBackingStore store(encoding, 3);
+    TLVReader chunkedReader;
+    chunkedReader.Init(store, static_cast<uint32_t>(encoding.size()));
+    EXPECT_EQ(SkipFirstElement(chunkedReader, chunkedLength, chunkedNext), expectedError);
+
+    EXPECT_EQ(contiguousLength, chunkedLength);
+    EXPECT_EQ(contiguousNext, chunkedNext);
+}
+
+} // namespace
+
+/**
+ *  Test that skipping containers gives the same results whether or not the container lies in a single
+ *  contiguous buffer (fast path) or is split over many small buffers (element by element).
+ */
+TEST_F(TestTLV, CheckSkipContainerFastPath)
+{
+    // { 1 = 5, 2 = [1, 2, { }], 3 = "abc", 4 = [[ [ ] ]] }, 7
+    const uint8_t valid[] = { 0x15, 0x24, 0x01, 0x05, 0x36, 0x02, 0x04, 0x01, 0x04, 0x02, 0x15, 0x18, 0x18, 0x2C, 0x03,
+                              0x03, 'a',  'b',  'c',  0x37, 0x04, 0x16, 0x18, 0x18, 0x18, 0x04, 0x07 };
+    CheckSkipMatchesChunkedReader(ByteSpan(valid), CHIP_NO_ERROR);
+
+    uint32_t lengthRead = 0;
+    uint8_t next        = 0;
+    TLVReader reader;
+    reader.Init(valid);
+    EXPECT_EQ(SkipFirstElement(reader, lengthRead, next), CHIP_NO_ERROR);
+    EXPECT_EQ(lengthRead, sizeof(valid) - 2);
+    EXPECT_EQ(next, 7u);
+
+    // Context tag inside an array.
+    const uint8_t taggedArrayElement[] = { 0x15, 0x36, 0x01, 0x24, 0x02, 0x01, 0x18, 0x18, 0x04, 0x07 };
+    CheckSkipMatchesChunkedReader(ByteSpan(taggedArrayElement), CHIP_ERROR_INVALID_TLV_TAG);
+
+    // Anonymous element inside a nested structure.
+    const uint8_t anonymousStructMember[] = { 0x15, 0x35, 0x01, 0x04, 0x02, 0x18, 0x18, 0x04, 0x07 };
+    CheckSkipMatchesChunkedReader(ByteSpan(anonymousStructMember), CHIP_ERROR_INVALID_TLV_TAG);
+
+    // String length running past the end of the encoding.
+    const uint8_t truncatedString[] = { 0x15, 0x2C, 0x01, 0x10, 'a', 0x18 };
+    CheckSkipMatchesChunkedReader(ByteSpan(truncatedString), CHIP_ERROR_TLV_UNDERRUN);
+
+    // Implicit profile tag without an implicit profile id.
+    const uint8_t implicitTag[] = { 0x15, 0x84, 0x01, 0x00, 0x05, 0x18, 0x04, 0x07 };
+    CheckSkipMatchesChunkedReader(ByteSpan(implicitTag), CHIP_ERROR_UNKNOWN_IMPLICIT_TLV_TAG);
+
+    // Invalid element type.
+    const uint8_t invalidType[] = { 0x15, 0x39, 0x01, 0x18, 0x04, 0x07 };
+    CheckSkipMatchesChunkedReader(ByteSpan(invalidType), CHIP_ERROR_INVALID_TLV_ELEMENT);
+
+    // Missing end of container.
+    const uint8_t unterminated[] = { 0x15, 0x24, 0x01, 0x05 };
+    CheckSkipMatchesChunkedReader(ByteSpan(unterminated), CHIP_END_OF_TLV);
+}
@@ -71,6 +71,34 @@ bool ActiveResolveAttempts::HasBrowseFor(chip::Dnssd::DiscoveryType type) const
     return false;
 }
 
+bool ActiveResolveAttempts::HasResolveFor(const PeerId & peerId) const
+{
+    for (auto & item : mRetryQueue)
+    {
+        if (item.attempt.Matches(peerId))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+size_t ActiveResolveAttempts::GetResolveCount() const
+{
+    size_t count = 0;
+
+    for (auto & item : mRetryQueue)
+    {
+        if (item.attempt.IsResolve())
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
 void ActiveResolveAttempts::CompleteIpResolution(SerializedQNameIterator targetHostName)
 {
     for (auto & item : mRetryQueue)
@@ -296,6 +296,12 @@ public:
     /// Check if a browse operation is active for the given discovery type
     bool HasBrowseFor(chip::Dnssd::DiscoveryType type) const;
 
+    /// Check if a resolve for the given peer is pending
+    bool HasResolveFor(const chip::PeerId & peerId) const;
+
+    /// Number of pending operational resolves
+    size_t GetResolveCount() const;
+
 private:
     struct RetryEntry
     {
@@ -0,0 +1,218 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "BulkResolveAttempts.h"
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+using namespace chip;
+
+namespace mdns {
+namespace Minimal {
+
+constexpr System::Clock::Timeout BulkResolveAttemptsBase::kMaxRetryDelay;
+
+void BulkResolveAttemptsBase::Reset()
+{
+    for (size_t i = 0; i < mCapacity; i++)
+    {
+        mEntries[i] = Entry();
+    }
+    mPendingCount = 0;
+    FinishBrowse();
+}
+
+BulkResolveAttemptsBase::Entry * BulkResolveAttemptsBase::Find(const PeerId & peerId)
+{
+    for (size_t i = 0; i < mCapacity; i++)
+    {
+        if (mEntries[i].state != Entry::State::kUnused && mEntries[i].peerId == peerId)
+        {
+            return &mEntries[i];
+        }
+    }
+    return nullptr;
+}
+
+const BulkResolveAttemptsBase::Entry * BulkResolveAttemptsBase::Find(const PeerId & peerId) const
+{
+    return const_cast<BulkResolveAttemptsBase *>(this)->Find(peerId);
+}
+
+CHIP_ERROR BulkResolveAttemptsBase::MarkPending(const PeerId & peerId)
+{
+    Entry * entry = Find(peerId);
+
+    if (entry != nullptr && entry->state == Entry::State::kPending)
+    {
+        entry->consumerCount++;
+        return CHIP_NO_ERROR;
+    }
+
+    if (entry == nullptr)
+    {
+        // Prefer unused entries. Answered entries only save a reply from
+        // their node, so they may be reused while the browse is running.
+        for (size_t i = 0; i < mCapacity && (entry == nullptr || entry->state != Entry::State::kUnused); i++)
+        {
+            if (mEntries[i].state != Entry::State::kPending)
+            {
+                entry = &mEntries[i];
+            }
+        }
+        VerifyOrReturnError(entry != nullptr, CHIP_ERROR_NO_MEMORY);
+    }
+
+    entry->peerId           = peerId;
+    entry->state            = Entry::State::kPending;
+    entry->consumerCount    = 1;
+    entry->answerTtlSeconds = 0;
+    mPendingCount++;
+
+    const System::Clock::Timestamp now = mClock->GetMonotonicTimestamp();
+    if (!mQuerySent)
+    {
+        mQueryDueTime = now;
+    }
+    else if (mQueryDueTime > mLastQueryTime + System::Clock::Seconds16(1))
+    {
+        // The node may have answered before it was requested: browse again
+        // as soon as the minimum query interval allows.
+        mQueryDueTime = mLastQueryTime + System::Clock::Seconds16(1);
+    }
+    mNextRetryDelay = System::Clock::Seconds16(1);
+
+    return CHIP_NO_ERROR;
+}
+
+bool BulkResolveAttemptsBase::Complete(const PeerId & peerId, uint32_t ttlSeconds)
+{
+    Entry * entry = Find(peerId);
+    VerifyOrReturnValue(entry != nullptr && entry->state == Entry::State::kPending, false);
+
+    entry->state         = Entry::State::kAnswered;
+    entry->consumerCount = 0;
+    entry->answerTime    = mClock->GetMonotonicTimestamp();
+    if (entry->answerTtlSeconds == 0)
+    {
+        entry->answerTtlSeconds = ttlSeconds;
+    }
+
+    if (--mPendingCount == 0)
+    {
+        FinishBrowse();
+    }
+
+    return true;
+}
+
+void BulkResolveAttemptsBase::SetAnswerTtl(const PeerId & peerId, uint32_t ttlSeconds)
+{
+    Entry * entry = Find(peerId);
+    VerifyOrReturn(entry != nullptr);
+
+    entry->answerTtlSeconds = ttlSeconds;
+    entry->answerTime       = mClock->GetMonotonicTimestamp();
+}
+
+void BulkResolveAttemptsBase::NodeIdResolutionNoLongerNeeded(const PeerId & peerId)
+{
+    Entry * entry = Find(peerId);
+    VerifyOrReturn(entry != nullptr && entry->state == Entry::State::kPending);
+
+    if (entry->consumerCount > 1)
+    {
+        entry->consumerCount--;
+        return;
+    }
+
+    *entry = Entry();
+    if (--mPendingCount == 0)
+    {
+        FinishBrowse();
+    }
+}
+
+bool BulkResolveAttemptsBase::IsPending(const PeerId & peerId) const
+{
+    const Entry * entry = Find(peerId);
+    return entry != nullptr && entry->state == Entry::State::kPending;
+}
+
+std::optional<System::Clock::Timeout> BulkResolveAttemptsBase::GetTimeUntilNextQuery() const
+{
+    VerifyOrReturnValue(HasPending(), std::nullopt);
+
+    const System::Clock::Timestamp now = mClock->GetMonotonicTimestamp();
+    if (now >= mQueryDueTime)
+    {
+        return std::make_optional<System::Clock::Timeout>(0);
+    }
+    return std::make_optional<System::Clock::Timeout>(mQueryDueTime - now);
+}
+
+bool BulkResolveAttemptsBase::NextQuery(bool & firstSend)
+{
+    VerifyOrReturnValue(HasPending(), false);
+
+    const System::Clock::Timestamp now = mClock->GetMonotonicTimestamp();
+    VerifyOrReturnValue(now >= mQueryDueTime, false);
+
+    if (mNextRetryDelay > kMaxRetryDelay)
+    {
+        ChipLogError(Discovery, "Timeout waiting for mDNS resolution of %u node(s).", static_cast<unsigned>(mPendingCount));
+        Reset();
+        return false;
+    }
+
+    firstSend       = !mQuerySent;
+    mQuerySent      = true;
+    mLastQueryTime  = now;
+    mQueryDueTime   = now + mNextRetryDelay;
+    mNextRetryDelay = mNextRetryDelay * 2;
+
+    return true;
+}
+
+void BulkResolveAttemptsBase::FinishBrowse()
+{
+    // Known answers only make sense within one browse: a later browse has to
+    // hear from every node it asks for.
+    for (size_t i = 0; i < mCapacity; i++)
+    {
+        if (mEntries[i].state == Entry::State::kAnswered)
+        {
+            mEntries[i] = Entry();
+        }
+    }
+
+    mQuerySent      = false;
+    mNextRetryDelay = System::Clock::Seconds16(1);
+}
+
+bool BulkResolveAttemptsBase::GetRemainingTtl(const Entry & entry, System::Clock::Timestamp now, uint32_t & remainingTtl)
+{
+    const uint64_t elapsedSeconds = std::chrono::duration_cast<System::Clock::Seconds64>(now - entry.answerTime).count();
+    VerifyOrReturnValue(elapsedSeconds < entry.answerTtlSeconds, false);
+
+    remainingTtl = static_cast<uint32_t>(entry.answerTtlSeconds - elapsedSeconds);
+    return remainingTtl >= (entry.answerTtlSeconds + 1) / 2;
+}
+
+} // namespace Minimal
+} // namespace mdns
@@ -0,0 +1,169 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include <lib/core/CHIPError.h>
+#include <lib/core/PeerId.h>
+#include <system/SystemClock.h>
+
+namespace mdns {
+namespace Minimal {
+
+/// Keeps track of operational nodes resolved through a single browse
+///
+/// Resolving many nodes one by one sends one query per node, and
+/// ActiveResolveAttempts only has room for a handful of them at a time.
+/// Instead, peers added here are resolved together by browsing for all
+/// operational services (`_matter._tcp.local`): every node answers that
+/// query with its PTR record and, as additional records, its SRV/TXT/AAAA
+/// records, which the resolver parses like any other response.
+///
+/// The browse is repeated with the same back-off as ActiveResolveAttempts
+/// until every pending peer has been answered or is no longer needed. Peers
+/// answered during the browse are listed as known answers in the repeated
+/// queries (RFC 6762 section 7.1), so only the nodes that have not answered
+/// yet reply again.
+class BulkResolveAttemptsBase
+{
+public:
+    static constexpr chip::System::Clock::Timeout kMaxRetryDelay = chip::System::Clock::Seconds16(16);
+
+    struct Entry
+    {
+        enum class State : uint8_t
+        {
+            kUnused,
+            kPending,  // waiting for the node to answer
+            kAnswered, // answered during the current browse; sent as a known answer
+        };
+
+        chip::PeerId peerId;
+        State state            = State::kUnused;
+        uint16_t consumerCount = 0;
+
+        // TTL of the answer (0 if not known yet) and when it was received,
+        // to compute the remaining TTL of the known answer.
+        uint32_t answerTtlSeconds = 0;
+        chip::System::Clock::Timestamp answerTime;
+    };
+
+    /// Clear out all entries and stop browsing
+    void Reset();
+
+    /// Add a consumer for the resolution of the given peer.
+    ///
+    /// Returns CHIP_ERROR_NO_MEMORY if no entry is available for the peer, in
+    /// which case the caller should resolve it on its own.
+    CHIP_ERROR MarkPending(const chip::PeerId & peerId);
+
+    /// Mark the given peer as answered.
+    ///
+    /// `ttlSeconds` is the TTL of the known answer unless the TTL of the PTR
+    /// record of the peer was set with SetAnswerTtl.
+    ///
+    /// Returns true if the peer was pending.
+    bool Complete(const chip::PeerId & peerId, uint32_t ttlSeconds);
+
+    /// Set the TTL of the PTR record the given peer answered with.
+    void SetAnswerTtl(const chip::PeerId & peerId, uint32_t ttlSeconds);
+
+    /// Note that the resolution of the given peer has one fewer consumer.
+    void NodeIdResolutionNoLongerNeeded(const chip::PeerId & peerId);
+
+    bool IsPending(const chip::PeerId & peerId) const;
+    bool HasPending() const { return mPendingCount > 0; }
+
+    /// Get the time until the next browse query is due.
+    ///
+    /// Returns missing if nothing is pending.
+    std::optional<chip::System::Clock::Timeout> GetTimeUntilNextQuery() const;
+
+    /// Check if a browse query is due now.
+    ///
+    /// If so, assumes the query is being sent and schedules the next one.
+    /// `firstSend` is set for the first query of a browse, which may ask for
+    /// unicast replies.
+    bool NextQuery(bool & firstSend);
+
+    /// Call `callback(peerId, ttlSeconds)` for every peer to list as a known
+    /// answer in the next query.
+    ///
+    /// Answers whose remaining TTL dropped below half of their TTL are not
+    /// listed, so that the node refreshes them (RFC 6762 section 7.1).
+    template <typename Callback>
+    void ForEachKnownAnswer(Callback && callback) const
+    {
+        const chip::System::Clock::Timestamp now = mClock->GetMonotonicTimestamp();
+
+        for (size_t i = 0; i < mCapacity; i++)
+        {
+            const Entry & entry = mEntries[i];
+            uint32_t remainingTtl;
+
+            if (entry.state == Entry::State::kAnswered && GetRemainingTtl(entry, now, remainingTtl))
+            {
+                callback(entry.peerId, remainingTtl);
+            }
+        }
+    }
+
+protected:
+    BulkResolveAttemptsBase(chip::System::Clock::ClockBase * clock, Entry * entries, size_t capacity) :
+        mClock(clock), mEntries(entries), mCapacity(capacity)
+    {}
+
+private:
+    Entry * Find(const chip::PeerId & peerId);
+    const Entry * Find(const chip::PeerId & peerId) const;
+
+    /// Called when the last pending peer is removed: the browse is over.
+    void FinishBrowse();
+
+    static bool GetRemainingTtl(const Entry & entry, chip::System::Clock::Timestamp now, uint32_t & remainingTtl);
+
+    chip::System::Clock::ClockBase * mClock;
+    Entry * mEntries;
+    const size_t mCapacity;
+    size_t mPendingCount = 0;
+
+    // Browse schedule, same rules as ActiveResolveAttempts: at least one
+    // second between queries, doubling the interval after every query.
+    chip::System::Clock::Timestamp mQueryDueTime;
+    chip::System::Clock::Timestamp mLastQueryTime;
+    chip::System::Clock::Timeout mNextRetryDelay = chip::System::Clock::Seconds16(1);
+    bool mQuerySent                              = false;
+};
+
+template <size_t kCapacity>
+class BulkResolveAttempts : public BulkResolveAttemptsBase
+{
+public:
+    static_assert(kCapacity > 0, "BulkResolveAttempts needs room for at least one peer");
+
+    BulkResolveAttempts(chip::System::Clock::ClockBase * clock) : BulkResolveAttemptsBase(clock, mEntryStorage, kCapacity) {}
+
+private:
+    Entry mEntryStorage[kCapacity];
+};
+
+} // namespace Minimal
+} // namespace mdns
@@ -24,6 +24,8 @@
 #include <lib/support/CHIPMemString.h>
 #include <tracing/macros.h>
 
+#include <algorithm>
+
 namespace chip {
 namespace Dnssd {
 
@@ -178,13 +180,15 @@ CHIP_ERROR IncrementalResolver::InitializeParsing(mdns::Minimal::SerializedQName
                 return CHIP_ERROR_INVALID_ARGUMENT;
             }
 
-            CHIP_ERROR err =
-                ExtractIdFromInstanceName(nameCopy.Value(), &mSpecificResolutionData.Get<OperationalNodeData>().peerId);
+            OperationalNodeData & operationalData = mSpecificResolutionData.Get<OperationalNodeData>();
+
+            CHIP_ERROR err = ExtractIdFromInstanceName(nameCopy.Value(), &operationalData.peerId);
             if (err != CHIP_NO_ERROR)
             {
                 return err;
             }
-            mSpecificResolutionData.Get<OperationalNodeData>().hasZeroTTL = (ttl == 0);
+            operationalData.hasZeroTTL = (ttl == 0);
+            operationalData.ttlSeconds = static_cast<uint32_t>(std::min<uint64_t>(ttl, UINT32_MAX));
         }
 
         LogFoundOperationalSrvRecord(mSpecificResolutionData.Get<OperationalNodeData>().peerId, mTargetHostName.Get());
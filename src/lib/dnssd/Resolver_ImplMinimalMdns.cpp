@@ -17,8 +17,11 @@
 
 #include "Resolver.h"
 
+#include <algorithm>
+
 #include <lib/core/CHIPConfig.h>
 #include <lib/dnssd/ActiveResolveAttempts.h>
+#include <lib/dnssd/BulkResolveAttempts.h>
 #include <lib/dnssd/IncrementalResolve.h>
 #include <lib/dnssd/MinimalMdnsServer.h>
 #include <lib/dnssd/ServiceNaming.h>
@@ -27,6 +30,7 @@
 #include <lib/dnssd/minimal_mdns/QueryBuilder.h>
 #include <lib/dnssd/minimal_mdns/RecordData.h>
 #include <lib/dnssd/minimal_mdns/core/FlatAllocatedQName.h>
+#include <lib/dnssd/minimal_mdns/records/Ptr.h>
 #include <lib/support/CHIPMemString.h>
 #include <lib/support/logging/CHIPLogging.h>
 #include <tracing/macros.h>
@@ -45,6 +49,14 @@ constexpr uint16_t kMdnsPort        = 5353;
 
 using namespace mdns::Minimal;
 
+constexpr size_t kMaxBulkResolves      = CHIP_CONFIG_MINMDNS_MAX_BULK_RESOLVES;
+constexpr bool kBulkResolveEnabled     = (kMaxBulkResolves > 0);
+constexpr size_t kBulkResolveThreshold = CHIP_CONFIG_MINMDNS_BULK_RESOLVE_THRESHOLD;
+
+using BulkResolves = BulkResolveAttempts<kBulkResolveEnabled ? kMaxBulkResolves : 1>;
+
+constexpr QNamePart kOperationalServiceQName[] = { kOperationalServiceName, kOperationalProtocol, kLocalDomain };
+
 /// Handles processing of minmdns packet data.
 ///
 /// Can process multiple incremental resolves based on SRV data and allows
@@ -53,7 +65,9 @@ using namespace mdns::Minimal;
 class PacketParser : private ParserDelegate
 {
 public:
-    PacketParser(ActiveResolveAttempts & activeResolves) : mActiveResolves(activeResolves) {}
+    PacketParser(ActiveResolveAttempts & activeResolves, BulkResolveAttemptsBase & bulkResolves) :
+        mActiveResolves(activeResolves), mBulkResolves(bulkResolves)
+    {}
 
     /// Goes through the given SRV records within a response packet
     /// and sets up data resolution
@@ -85,6 +99,12 @@ private:
     /// Forwards the resource to all active resolvers.
     void ParseResource(const ResourceData & data);
 
+    /// Called for PTR records while nodes are resolved in bulk.
+    ///
+    /// Keeps the TTL of the PTR record of a pending node, which is what the
+    /// next bulk browse lists as known answer.
+    void ParseBulkBrowseAnswer(const ResourceData & data);
+
     enum class RecordParsingState
     {
         kIdle,
@@ -102,6 +122,7 @@ private:
 
     // resolvers kept between parse steps
     ActiveResolveAttempts & mActiveResolves;
+    BulkResolveAttemptsBase & mBulkResolves;
     IncrementalResolver mResolvers[kMinMdnsNumParallelResolvers];
 };
 
@@ -186,6 +207,33 @@ void PacketParser::ParseResource(const ResourceData & data)
     {
         mActiveResolves.CompleteIpResolution(data.GetName());
     }
+
+    if (data.GetType() == QType::PTR && mBulkResolves.HasPending())
+    {
+        ParseBulkBrowseAnswer(data);
+    }
+}
+
+void PacketParser::ParseBulkBrowseAnswer(const ResourceData & data)
+{
+    if (data.GetName() != FullQName(kOperationalServiceQName))
+    {
+        return;
+    }
+
+    SerializedQNameIterator instanceName;
+    if (!ParsePtrRecord(data.GetData(), mPacketRange, &instanceName) || !instanceName.Next() || !instanceName.IsValid())
+    {
+        return;
+    }
+
+    PeerId peerId;
+    if (ExtractIdFromInstanceName(instanceName.Value(), &peerId) != CHIP_NO_ERROR)
+    {
+        return;
+    }
+
+    mBulkResolves.SetAnswerTtl(peerId, static_cast<uint32_t>(std::min<uint64_t>(data.GetTtlSeconds(), UINT32_MAX)));
 }
 
 void PacketParser::ParseSRVResource(const ResourceData & data)
@@ -267,7 +315,9 @@ void PacketParser::ParseNonSrvRecords(Inet::InterfaceId interface, const BytesRa
 class MinMdnsResolver : public Resolver, public MdnsPacketDelegate
 {
 public:
-    MinMdnsResolver() : mActiveResolves(&chip::System::SystemClock()), mPacketParser(mActiveResolves)
+    MinMdnsResolver() :
+        mActiveResolves(&chip::System::SystemClock()), mBulkResolves(&chip::System::SystemClock()),
+        mPacketParser(mActiveResolves, mBulkResolves)
     {
         GlobalMinimalMdnsServer::Instance().SetResponseDelegate(this);
     }
@@ -292,6 +342,7 @@ private:
     DiscoveryContext * mDiscoveryContext              = nullptr;
     System::Layer * mSystemLayer                      = nullptr;
     ActiveResolveAttempts mActiveResolves;
+    BulkResolves mBulkResolves;
     PacketParser mPacketParser;
 
     void SetDiscoveryContext(DiscoveryContext * context);
@@ -300,6 +351,14 @@ private:
     CHIP_ERROR SendAllPendingQueries();
     CHIP_ERROR ScheduleRetries();
 
+    /// Whether the given peer should be resolved through the bulk browse
+    /// rather than with a query of its own.
+    bool ShouldResolveInBulk(const PeerId & peerId) const;
+
+    /// Browse for all operational nodes, listing the nodes that already
+    /// answered as known answers.
+    CHIP_ERROR SendBulkResolveQuery(bool firstSend);
+
     /// Prepare a query for the given schedule attempt
     CHIP_ERROR BuildQuery(QueryBuilder & builder, const ActiveResolveAttempts::ScheduledAttempt & attempt);
 
@@ -375,7 +434,8 @@ void MinMdnsResolver::AdvancePendingResolverStates()
                 // Browse wants IP addresses
                 ScheduleIpAddressResolve(resolver->GetTargetHostName());
             }
-            else if (mActiveResolves.ShouldResolveIpAddress(resolver->OperationalParsePeerId()))
+            else if (mActiveResolves.ShouldResolveIpAddress(resolver->OperationalParsePeerId()) ||
+                     mBulkResolves.IsPending(resolver->OperationalParsePeerId()))
             {
                 // Keep searching for IP addresses if an active resolve needs these IP addresses
                 // otherwise ignore the data (received a SRV record without IP address, however we do not
@@ -480,6 +540,8 @@ void MinMdnsResolver::AdvancePendingResolverStates()
             }
 
             mActiveResolves.Complete(nodeResolvedData.operationalData.peerId);
+            mBulkResolves.Complete(nodeResolvedData.operationalData.peerId,
+                                   nodeResolvedData.operationalData.ttlSeconds.value_or(0));
             if (mOperationalDelegate != nullptr)
             {
                 mOperationalDelegate->OnOperationalNodeResolved(nodeResolvedData);
@@ -698,11 +760,55 @@ CHIP_ERROR MinMdnsResolver::SendAllPendingQueries()
         }
     }
 
+    bool firstBulkSend;
+    if (mBulkResolves.NextQuery(firstBulkSend))
+    {
+        ReturnErrorOnFailure(SendBulkResolveQuery(firstBulkSend));
+    }
+
     ExpireIncrementalResolvers();
 
     return ScheduleRetries();
 }
 
+CHIP_ERROR MinMdnsResolver::SendBulkResolveQuery(bool firstSend)
+{
+    MATTER_TRACE_SCOPE("Send bulk resolve query", "MinMdnsResolver");
+
+    System::PacketBufferHandle buffer = System::PacketBufferHandle::New(kMdnsMaxPacketSize);
+    VerifyOrReturnError(!buffer.IsNull(), CHIP_ERROR_NO_MEMORY);
+
+    QueryBuilder builder(std::move(buffer));
+    builder.Header().SetMessageId(0);
+
+    const ActiveResolveAttempts::ScheduledAttempt::Browse browse(DiscoveryFilter(), DiscoveryType::kOperational);
+    ReturnErrorOnFailure(BuildQuery(builder, browse, firstSend));
+    VerifyOrReturnError(builder.Ok(), CHIP_ERROR_INTERNAL);
+
+    // Known answers that do not fit are left out: their nodes just answer again.
+    mBulkResolves.ForEachKnownAnswer([&builder](const PeerId & peerId, uint32_t ttlSeconds) {
+        char instanceName[Operational::kInstanceNameMaxLength + 1];
+        VerifyOrReturn(MakeInstanceName(instanceName, sizeof(instanceName), peerId) == CHIP_NO_ERROR);
+
+        const QNamePart instanceQName[] = { instanceName, kOperationalServiceName, kOperationalProtocol, kLocalDomain };
+        PtrResourceRecord record(kOperationalServiceQName, instanceQName);
+        record.SetTtl(ttlSeconds);
+
+        if (!builder.AddAnswer(record))
+        {
+#if CHIP_MINMDNS_HIGH_VERBOSITY
+            ChipLogError(Discovery, "Known answer list does not fit in the bulk resolve query");
+#endif
+        }
+    });
+
+    if (firstSend)
+    {
+        return GlobalMinimalMdnsServer::Server().BroadcastUnicastQuery(builder.ReleasePacket(), kMdnsPort);
+    }
+    return GlobalMinimalMdnsServer::Server().BroadcastSend(builder.ReleasePacket(), kMdnsPort);
+}
+
 void MinMdnsResolver::ExpireIncrementalResolvers()
 {
     // once all queries are sent, if any SRV cannot receive AAAA addresses, expire it
@@ -754,9 +860,24 @@ CHIP_ERROR MinMdnsResolver::BrowseNodes(DiscoveryType type, DiscoveryFilter filt
     return SendAllPendingQueries();
 }
 
+bool MinMdnsResolver::ShouldResolveInBulk(const PeerId & peerId) const
+{
+    if (!kBulkResolveEnabled || mActiveResolves.HasResolveFor(peerId))
+    {
+        return false;
+    }
+
+    // Once one browse is running, every further node joins it.
+    return mBulkResolves.HasPending() || (mActiveResolves.GetResolveCount() >= kBulkResolveThreshold);
+}
+
 CHIP_ERROR MinMdnsResolver::ResolveNodeId(const PeerId & peerId)
 {
-    mActiveResolves.MarkPending(peerId);
+    // Fall back to a query of its own if the bulk resolve is full.
+    if (!ShouldResolveInBulk(peerId) || (mBulkResolves.MarkPending(peerId) != CHIP_NO_ERROR))
+    {
+        mActiveResolves.MarkPending(peerId);
+    }
 
     return SendAllPendingQueries();
 }
@@ -764,6 +885,7 @@ CHIP_ERROR MinMdnsResolver::ResolveNodeId(const PeerId & peerId)
 void MinMdnsResolver::NodeIdResolutionNoLongerNeeded(const PeerId & peerId)
 {
     mActiveResolves.NodeIdResolutionNoLongerNeeded(peerId);
+    mBulkResolves.NodeIdResolutionNoLongerNeeded(peerId);
 }
 
 CHIP_ERROR MinMdnsResolver::ScheduleRetries()
@@ -773,7 +895,13 @@ CHIP_ERROR MinMdnsResolver::ScheduleRetries()
     VerifyOrReturnError(mSystemLayer != nullptr, CHIP_ERROR_INCORRECT_STATE);
     mSystemLayer->CancelTimer(&RetryCallback, this);
 
-    std::optional<System::Clock::Timeout> delay = mActiveResolves.GetTimeUntilNextExpectedResponse();
+    std::optional<System::Clock::Timeout> delay     = mActiveResolves.GetTimeUntilNextExpectedResponse();
+    std::optional<System::Clock::Timeout> bulkDelay = mBulkResolves.GetTimeUntilNextQuery();
+
+    if (bulkDelay.has_value() && (!delay.has_value() || (*bulkDelay < *delay)))
+    {
+        delay = bulkDelay;
+    }
 
     if (!delay.has_value())
     {
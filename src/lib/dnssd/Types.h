@@ -201,7 +201,12 @@ struct OperationalNodeData
 {
     PeerId peerId;
     bool hasZeroTTL;
-    void Reset() { peerId = PeerId(); }
+    std::optional<uint32_t> ttlSeconds; // TTL of the advertisement, when the backend reports it
+    void Reset()
+    {
+        peerId = PeerId();
+        ttlSeconds.reset();
+    }
 };
 
 struct OperationalNodeBrowseData : public OperationalNodeData
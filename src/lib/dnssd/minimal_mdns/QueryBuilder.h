@@ -21,6 +21,7 @@
 
 #include <lib/dnssd/minimal_mdns/Query.h>
 #include <lib/dnssd/minimal_mdns/core/DnsHeader.h>
+#include <lib/dnssd/minimal_mdns/records/ResourceRecord.h>
 
 namespace mdns {
 namespace Minimal {
@@ -28,13 +29,24 @@ namespace Minimal {
 class QueryBuilder
 {
 public:
-    QueryBuilder() : mHeader(nullptr) {}
-    QueryBuilder(chip::System::PacketBufferHandle && packet) : mHeader(nullptr) { Reset(std::move(packet)); }
+    QueryBuilder() : mHeader(nullptr), mAnswerOutput(nullptr, 0), mAnswerWriter(&mAnswerOutput) {}
+    QueryBuilder(chip::System::PacketBufferHandle && packet) :
+        mHeader(nullptr), mAnswerOutput(nullptr, 0), mAnswerWriter(&mAnswerOutput)
+    {
+        Reset(std::move(packet));
+    }
+
+    // mAnswerWriter points at mAnswerOutput, so a copy would keep writing through the original
+    QueryBuilder(const QueryBuilder &)             = delete;
+    QueryBuilder(QueryBuilder &&)                  = delete;
+    QueryBuilder & operator=(const QueryBuilder &) = delete;
+    QueryBuilder & operator=(QueryBuilder &&)      = delete;
 
     QueryBuilder & Reset(chip::System::PacketBufferHandle && packet)
     {
-        mPacket = std::move(packet);
-        mHeader = HeaderRef(mPacket->Start());
+        mPacket         = std::move(packet);
+        mHeader         = HeaderRef(mPacket->Start());
+        mAnswersStarted = false;
 
         if (mPacket->AvailableDataLength() >= HeaderRef::kSizeBytes)
         {
@@ -81,12 +93,53 @@ public:
         return *this;
     }
 
+    /// Append a known answer (RFC 6762 section 7.1). Must be called after
+    /// all queries have been added.
+    ///
+    /// Known answers are optional, so a record that does not fit leaves the
+    /// packet unchanged and returns false instead of failing the query.
+    bool AddAnswer(const ResourceRecord & record)
+    {
+        if (!mQueryBuildOk)
+        {
+            return false;
+        }
+
+        if (!mAnswersStarted)
+        {
+            // Answers share one writer so that their names get compressed
+            mAnswerOutput =
+                chip::Encoding::BigEndian::BufferWriter(mPacket->Start(), mPacket->DataLength() + mPacket->AvailableDataLength());
+            mAnswerOutput.Skip(mPacket->DataLength());
+            mAnswerWriter.Reset();
+            mAnswersStarted = true;
+        }
+
+        const chip::Encoding::BigEndian::BufferWriter previousOutput = mAnswerOutput;
+        const RecordWriter previousWriter                            = mAnswerWriter;
+
+        if (!record.Append(mHeader, ResourceType::kAnswer, mAnswerWriter))
+        {
+            mAnswerOutput = previousOutput;
+            mAnswerWriter = previousWriter;
+            return false;
+        }
+
+        mPacket->SetDataLength(static_cast<uint16_t>(mAnswerOutput.Needed()));
+        return true;
+    }
+
     bool Ok() const { return mQueryBuildOk; }
 
 private:
     chip::System::PacketBufferHandle mPacket;
     HeaderRef mHeader;
     bool mQueryBuildOk = true;
+
+    // Output for known answers, set up by the first AddAnswer call
+    chip::Encoding::BigEndian::BufferWriter mAnswerOutput;
+    RecordWriter mAnswerWriter;
+    bool mAnswersStarted = false;
 };
 
 } // namespace Minimal
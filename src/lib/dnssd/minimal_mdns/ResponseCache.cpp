@@ -0,0 +1,167 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "ResponseCache.h"
+
+#include <string.h>
+
+#include <lib/dnssd/minimal_mdns/core/DnsHeader.h>
+#include <lib/support/CodeUtils.h>
+
+namespace mdns {
+namespace Minimal {
+
+constexpr chip::System::Clock::Timeout ResponseCacheBase::kMaxAge;
+
+bool ResponseCacheBase::Entry::AddAnswer(QueryResponderRecord * record)
+{
+    VerifyOrReturnValue(mAnswerCount < kMaxAnswers, false);
+    mAnswers[mAnswerCount++] = record;
+    return true;
+}
+
+bool ResponseCacheBase::Entry::SetPacket(const chip::System::PacketBufferHandle & packet)
+{
+    VerifyOrReturnValue(mPacketSize == 0, false); // response split into several packets
+    VerifyOrReturnValue(!packet->HasChainedBuffer() && packet->DataLength() <= kMaxPacketSize, false);
+
+    memcpy(mPacket, packet->Start(), packet->DataLength());
+    mPacketSize = packet->DataLength();
+    return true;
+}
+
+bool ResponseCacheBase::Entry::AnswersMulticastBefore(chip::System::Clock::Timestamp time) const
+{
+    for (size_t i = 0; i < mAnswerCount; i++)
+    {
+        if (mAnswers[i]->lastMulticastTime >= time)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ResponseCacheBase::Entry::SetAnswersMulticastTime(chip::System::Clock::Timestamp time)
+{
+    for (size_t i = 0; i < mAnswerCount; i++)
+    {
+        mAnswers[i]->lastMulticastTime = time;
+    }
+}
+
+chip::System::PacketBufferHandle ResponseCacheBase::Entry::CopyPacket(uint16_t messageId) const
+{
+    chip::System::PacketBufferHandle packet = chip::System::PacketBufferHandle::NewWithData(mPacket, mPacketSize);
+    if (!packet.IsNull())
+    {
+        HeaderRef(packet->Start()).SetMessageId(messageId);
+    }
+    return packet;
+}
+
+bool ResponseCacheBase::Entry::Matches(const QueryData & query, chip::Inet::InterfaceId interface) const
+{
+    if (!mInUse || (mInterface != interface) || (mType != query.GetType()) || (mClass != query.GetClass()))
+    {
+        return false;
+    }
+
+    return SerializedQNameIterator(BytesRange(mQName, mQName + mQNameSize), mQName) == query.GetName();
+}
+
+void ResponseCacheBase::Invalidate()
+{
+    for (size_t i = 0; i < mCapacity; i++)
+    {
+        mEntries[i].mInUse = false;
+    }
+}
+
+ResponseCacheBase::Entry * ResponseCacheBase::Find(const QueryData & query, chip::Inet::InterfaceId interface,
+                                                   chip::System::Clock::Timestamp now)
+{
+    for (size_t i = 0; i < mCapacity; i++)
+    {
+        Entry & entry = mEntries[i];
+        if (!entry.Matches(query, interface))
+        {
+            continue;
+        }
+
+        if (now >= entry.mCreatedTime + kMaxAge)
+        {
+            entry.mInUse = false;
+            return nullptr;
+        }
+
+        entry.mLastUsedTime = now;
+        return &entry;
+    }
+    return nullptr;
+}
+
+ResponseCacheBase::Entry * ResponseCacheBase::Prepare(const QueryData & query, chip::Inet::InterfaceId interface,
+                                                      chip::System::Clock::Timestamp now)
+{
+    VerifyOrReturnValue(mCapacity > 0, nullptr);
+
+    // Prefer unused entries, then the least recently used one
+    Entry * entry = &mEntries[0];
+    for (size_t i = 0; i < mCapacity && entry->mInUse; i++)
+    {
+        if (!mEntries[i].mInUse || (mEntries[i].mLastUsedTime < entry->mLastUsedTime))
+        {
+            entry = &mEntries[i];
+        }
+    }
+
+    entry->mInUse       = false;
+    entry->mAnswerCount = 0;
+    entry->mPacketSize  = 0;
+    entry->mQNameSize   = 0;
+
+    SerializedQNameIterator name = query.GetName();
+    while (name.Next())
+    {
+        const size_t length = strlen(name.Value());
+        VerifyOrReturnValue(entry->mQNameSize + length + 2 <= kMaxQNameSize, nullptr);
+
+        entry->mQName[entry->mQNameSize++] = static_cast<uint8_t>(length);
+        memcpy(&entry->mQName[entry->mQNameSize], name.Value(), length);
+        entry->mQNameSize += length;
+    }
+    VerifyOrReturnValue(name.IsValid(), nullptr);
+    entry->mQName[entry->mQNameSize++] = 0;
+
+    entry->mInterface    = interface;
+    entry->mType         = query.GetType();
+    entry->mClass        = query.GetClass();
+    entry->mCreatedTime  = now;
+    entry->mLastUsedTime = now;
+
+    return entry;
+}
+
+void ResponseCacheBase::Commit(Entry & entry)
+{
+    VerifyOrReturn(entry.mPacketSize > 0);
+    entry.mInUse = true;
+}
+
+} // namespace Minimal
+} // namespace mdns
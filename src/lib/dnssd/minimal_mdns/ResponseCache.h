@@ -0,0 +1,144 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <inet/InetInterface.h>
+#include <lib/dnssd/minimal_mdns/Parser.h>
+#include <lib/dnssd/minimal_mdns/responders/QueryResponder.h>
+#include <system/SystemClock.h>
+#include <system/SystemPacketBuffer.h>
+
+namespace mdns {
+namespace Minimal {
+
+/// Keeps fully serialized responses to recent queries.
+///
+/// Advertised records only change when the advertised services change, so
+/// repeated queries (e.g. the same browse sent by every controller on a busy
+/// network) can be answered by copying the response built for the first one
+/// and patching its message id, instead of going through the responders and
+/// serializing every record again.
+///
+/// Responses are kept per interface the query was received on (responses list
+/// the addresses of that interface) and per query name, type and class. Only
+/// responses that fit in a single packet are kept.
+///
+/// The owner has to Invalidate() the cache whenever the advertised records
+/// change. Interface addresses may change on their own, so entries also expire
+/// after kMaxAge.
+class ResponseCacheBase
+{
+public:
+    static constexpr size_t kMaxPacketSize = 512;
+    static constexpr size_t kMaxQNameSize  = 128;
+    static constexpr size_t kMaxAnswers    = 16;
+
+    static constexpr chip::System::Clock::Timeout kMaxAge = chip::System::Clock::Seconds16(30);
+
+    class Entry
+    {
+    public:
+        /// Remember a record sent as an answer.
+        ///
+        /// Returns false if too many answers were sent to cache the response.
+        bool AddAnswer(QueryResponderRecord * record);
+
+        /// Store the response packet.
+        ///
+        /// Returns false if the packet cannot be cached, e.g. because the
+        /// response was split into several packets.
+        bool SetPacket(const chip::System::PacketBufferHandle & packet);
+
+        size_t GetAnswerCount() const { return mAnswerCount; }
+
+        /// Check that none of the answers was multicast at or after the given time.
+        bool AnswersMulticastBefore(chip::System::Clock::Timestamp time) const;
+
+        /// Note that the answers are being multicast now.
+        void SetAnswersMulticastTime(chip::System::Clock::Timestamp time);
+
+        /// Allocate a copy of the response, with its message id set to `messageId`.
+        chip::System::PacketBufferHandle CopyPacket(uint16_t messageId) const;
+
+    private:
+        friend class ResponseCacheBase;
+
+        bool Matches(const QueryData & query, chip::Inet::InterfaceId interface) const;
+
+        bool mInUse = false;
+        chip::Inet::InterfaceId mInterface;
+        QType mType   = QType::ANY;
+        QClass mClass = QClass::ANY;
+        chip::System::Clock::Timestamp mCreatedTime;
+        chip::System::Clock::Timestamp mLastUsedTime;
+
+        // Query name, serialized without compression
+        uint8_t mQName[kMaxQNameSize];
+        size_t mQNameSize = 0;
+
+        // Records sent as answers: multicast throttling applies to them
+        QueryResponderRecord * mAnswers[kMaxAnswers];
+        size_t mAnswerCount = 0;
+
+        uint8_t mPacket[kMaxPacketSize];
+        size_t mPacketSize = 0;
+    };
+
+    /// Drop all cached responses.
+    void Invalidate();
+
+    /// Find the response cached for the given query received on the given interface.
+    ///
+    /// Returns nullptr if no response is cached.
+    Entry * Find(const QueryData & query, chip::Inet::InterfaceId interface, chip::System::Clock::Timestamp now);
+
+    /// Get an entry to record the response to the given query in, replacing the
+    /// least recently used entry if needed.
+    ///
+    /// The entry is only used once it is committed. Returns nullptr if the
+    /// response to the query cannot be cached.
+    Entry * Prepare(const QueryData & query, chip::Inet::InterfaceId interface, chip::System::Clock::Timestamp now);
+
+    /// Start using an entry returned by Prepare once the response is recorded in it.
+    void Commit(Entry & entry);
+
+protected:
+    ResponseCacheBase(Entry * entries, size_t capacity) : mEntries(entries), mCapacity(capacity) {}
+
+private:
+    Entry * mEntries;
+    const size_t mCapacity;
+};
+
+template <size_t kCapacity>
+class ResponseCache : public ResponseCacheBase
+{
+public:
+    static_assert(kCapacity > 0, "ResponseCache needs room for at least one response");
+
+    ResponseCache() : ResponseCacheBase(mEntryStorage, kCapacity) {}
+
+private:
+    Entry mEntryStorage[kCapacity];
+};
+
+} // namespace Minimal
+} // namespace mdns
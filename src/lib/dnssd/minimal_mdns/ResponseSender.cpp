@@ -62,12 +62,14 @@ CHIP_ERROR ResponseSender::AddQueryResponder(QueryResponderBase * queryResponder
         if (responder == nullptr || responder == queryResponder)
         {
             responder = queryResponder;
+            InvalidateCachedResponses();
             return CHIP_NO_ERROR;
         }
     }
 
 #if CHIP_CONFIG_MINMDNS_DYNAMIC_OPERATIONAL_RESPONDER_LIST
     mResponders.push_back(queryResponder);
+    InvalidateCachedResponses();
     return CHIP_NO_ERROR;
 #else
     return CHIP_ERROR_NO_MEMORY;
@@ -84,6 +86,7 @@ CHIP_ERROR ResponseSender::RemoveQueryResponder(QueryResponderBase * queryRespon
 #if CHIP_CONFIG_MINMDNS_DYNAMIC_OPERATIONAL_RESPONDER_LIST
             mResponders.erase(it);
 #endif
+            InvalidateCachedResponses();
             return CHIP_NO_ERROR;
         }
     }
@@ -107,6 +110,28 @@ CHIP_ERROR ResponseSender::Respond(uint16_t messageId, const QueryData & query,
 {
     mSendState.Reset(messageId, query, querySource);
 
+    const chip::System::Clock::Timestamp kTimeNow = chip::System::SystemClock().GetMonotonicTimestamp();
+
+#if CHIP_CONFIG_MINMDNS_RESPONSE_CACHE_SIZE > 0
+    mCacheEntry = nullptr;
+
+    if (IsCacheable(configuration))
+    {
+        ResponseCacheBase::Entry * cached = mResponseCache.Find(query, querySource->Interface, kTimeNow);
+        if (cached == nullptr)
+        {
+            // Record the response built below for the next identical query
+            mCacheEntry = mResponseCache.Prepare(query, querySource->Interface, kTimeNow);
+        }
+        else
+        {
+            bool sent = false;
+            ReturnErrorOnFailure(SendCachedResponse(*cached, kTimeNow, sent));
+            VerifyOrReturnError(!sent, CHIP_NO_ERROR);
+        }
+    }
+#endif
+
     if (query.IsAnnounceBroadcast())
     {
         // Deny listing large amount of data
@@ -128,8 +153,6 @@ CHIP_ERROR ResponseSender::Respond(uint16_t messageId, const QueryData & query,
 
     // send all 'Answer' replies
     {
-        const chip::System::Clock::Timestamp kTimeNow = chip::System::SystemClock().GetMonotonicTimestamp();
-
         QueryReplyFilter queryReplyFilter(query);
         QueryResponderRecordFilter responseFilter;
 
@@ -143,6 +166,14 @@ CHIP_ERROR ResponseSender::Respond(uint16_t messageId, const QueryData & query,
             //       broadcasts on one interface to throttle broadcasts on another interface.
             responseFilter.SetIncludeOnlyMulticastBeforeMS(kTimeNow - chip::System::Clock::Seconds32(1));
         }
+
+        if (!query.IsAnnounceBroadcast())
+        {
+            // Only records named like the query can be answers: look them up by name hash
+            // instead of going through every record of every responder.
+            responseFilter.SetQNameHash(QNameHash(query.GetName()));
+        }
+
         for (auto & responder : mResponders)
         {
             if (responder == nullptr)
@@ -160,6 +191,13 @@ CHIP_ERROR ResponseSender::Respond(uint16_t messageId, const QueryData & query,
                 {
                     it->lastMulticastTime = kTimeNow;
                 }
+
+#if CHIP_CONFIG_MINMDNS_RESPONSE_CACHE_SIZE > 0
+                if ((mCacheEntry != nullptr) && !mCacheEntry->AddAnswer(&*it))
+                {
+                    mCacheEntry = nullptr;
+                }
+#endif
             }
         }
     }
@@ -195,40 +233,120 @@ CHIP_ERROR ResponseSender::Respond(uint16_t messageId, const QueryData & query,
         }
     }
 
-    return FlushReply();
+    ReturnErrorOnFailure(FlushReply());
+
+#if CHIP_CONFIG_MINMDNS_RESPONSE_CACHE_SIZE > 0
+    // A multicast response leaves out answers multicast less than a second ago: only keep
+    // it if it has all of them.
+    if ((mCacheEntry != nullptr) && (mSendState.SendUnicast() || (mCacheEntry->GetAnswerCount() == CountAnswers(query))))
+    {
+        mResponseCache.Commit(*mCacheEntry);
+    }
+    mCacheEntry = nullptr;
+#endif
+
+    return CHIP_NO_ERROR;
+}
+
+void ResponseSender::InvalidateCachedResponses()
+{
+#if CHIP_CONFIG_MINMDNS_RESPONSE_CACHE_SIZE > 0
+    mResponseCache.Invalidate();
+    mCacheEntry = nullptr;
+#endif
 }
 
+#if CHIP_CONFIG_MINMDNS_RESPONSE_CACHE_SIZE > 0
+
+bool ResponseSender::IsCacheable(const ResponseConfiguration & configuration) const
+{
+    // Announcements are rare and legacy unicast responses echo the query: not worth keeping.
+    return !mSendState.GetQuery()->IsAnnounceBroadcast() && !mSendState.IncludeQuery() &&
+        !configuration.GetTtlSecondsOverride().has_value();
+}
+
+CHIP_ERROR ResponseSender::SendCachedResponse(ResponseCacheBase::Entry & entry, chip::System::Clock::Timestamp now, bool & sent)
+{
+    sent = false;
+
+    if (!mSendState.SendUnicast())
+    {
+        VerifyOrReturnError(entry.AnswersMulticastBefore(now - chip::System::Clock::Seconds32(1)), CHIP_NO_ERROR);
+        entry.SetAnswersMulticastTime(now);
+    }
+
+    chip::System::PacketBufferHandle packet = entry.CopyPacket(mSendState.GetMessageId());
+    VerifyOrReturnError(!packet.IsNull(), CHIP_ERROR_NO_MEMORY);
+
+    sent = true;
+    return SendPacket(std::move(packet));
+}
+
+size_t ResponseSender::CountAnswers(const QueryData & query) const
+{
+    QueryReplyFilter queryReplyFilter(query);
+    QueryResponderRecordFilter responseFilter;
+    responseFilter.SetReplyFilter(&queryReplyFilter).SetQNameHash(QNameHash(query.GetName()));
+
+    size_t count = 0;
+    for (auto & responder : mResponders)
+    {
+        if (responder == nullptr)
+        {
+            continue;
+        }
+        for (auto it = responder->begin(&responseFilter); it != responder->end(); it++)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+#endif // CHIP_CONFIG_MINMDNS_RESPONSE_CACHE_SIZE > 0
+
 CHIP_ERROR ResponseSender::FlushReply()
 {
     VerifyOrReturnError(mResponseBuilder.HasPacketBuffer(), CHIP_NO_ERROR); // nothing to flush
 
     if (mResponseBuilder.HasResponseRecords())
     {
-        char srcAddressString[chip::Inet::IPAddress::kMaxStringLength];
-        VerifyOrDie(mSendState.GetSourceAddress().ToString(srcAddressString) != nullptr);
+        chip::System::PacketBufferHandle packet = mResponseBuilder.ReleasePacket();
 
-        if (mSendState.SendUnicast())
+#if CHIP_CONFIG_MINMDNS_RESPONSE_CACHE_SIZE > 0
+        if ((mCacheEntry != nullptr) && !mCacheEntry->SetPacket(packet))
         {
-#if CHIP_MINMDNS_HIGH_VERBOSITY
-            ChipLogDetail(Discovery, "Directly sending mDns reply to peer %s on port %d", srcAddressString,
-                          mSendState.GetSourcePort());
-#endif
-            ReturnErrorOnFailure(mServer->DirectSend(mResponseBuilder.ReleasePacket(), mSendState.GetSourceAddress(),
-                                                     mSendState.GetSourcePort(), mSendState.GetSourceInterfaceId()));
+            mCacheEntry = nullptr;
         }
-        else
-        {
-#if CHIP_MINMDNS_HIGH_VERBOSITY
-            ChipLogDetail(Discovery, "Broadcasting mDns reply for query from %s", srcAddressString);
 #endif
-            ReturnErrorOnFailure(mServer->BroadcastSend(mResponseBuilder.ReleasePacket(), kMdnsStandardPort,
-                                                        mSendState.GetSourceInterfaceId(), mSendState.GetSourceAddress().Type()));
-        }
+
+        ReturnErrorOnFailure(SendPacket(std::move(packet)));
     }
 
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR ResponseSender::SendPacket(chip::System::PacketBufferHandle && packet)
+{
+    char srcAddressString[chip::Inet::IPAddress::kMaxStringLength];
+    VerifyOrDie(mSendState.GetSourceAddress().ToString(srcAddressString) != nullptr);
+
+    if (mSendState.SendUnicast())
+    {
+#if CHIP_MINMDNS_HIGH_VERBOSITY
+        ChipLogDetail(Discovery, "Directly sending mDns reply to peer %s on port %d", srcAddressString, mSendState.GetSourcePort());
+#endif
+        return mServer->DirectSend(std::move(packet), mSendState.GetSourceAddress(), mSendState.GetSourcePort(),
+                                   mSendState.GetSourceInterfaceId());
+    }
+
+#if CHIP_MINMDNS_HIGH_VERBOSITY
+    ChipLogDetail(Discovery, "Broadcasting mDns reply for query from %s", srcAddressString);
+#endif
+    return mServer->BroadcastSend(std::move(packet), kMdnsStandardPort, mSendState.GetSourceInterfaceId(),
+                                  mSendState.GetSourceAddress().Type());
+}
+
 CHIP_ERROR ResponseSender::PrepareNewReplyPacket()
 {
     chip::System::PacketBufferHandle buffer = chip::System::PacketBufferHandle::New(kPacketSizeBytes);
@@ -19,6 +19,7 @@
 
 #include "Parser.h"
 #include "ResponseBuilder.h"
+#include "ResponseCache.h"
 #include "Server.h"
 
 #include <lib/dnssd/minimal_mdns/responders/QueryResponder.h>
@@ -145,16 +146,41 @@ public:
 
     void SetServer(ServerBase * server) { mServer = server; }
 
+    /// Drop responses kept for repeated queries.
+    ///
+    /// Has to be called whenever the records of a registered query responder change.
+    void InvalidateCachedResponses();
+
 private:
     CHIP_ERROR FlushReply();
+    CHIP_ERROR SendPacket(chip::System::PacketBufferHandle && packet);
     CHIP_ERROR PrepareNewReplyPacket();
 
+#if CHIP_CONFIG_MINMDNS_RESPONSE_CACHE_SIZE > 0
+    /// Check whether the response to the current query can be kept for later queries
+    bool IsCacheable(const ResponseConfiguration & configuration) const;
+
+    /// Send a cached response to the current query.
+    ///
+    /// `sent` is left false if the cached response cannot be multicast yet because some of its
+    /// answers were multicast less than a second ago.
+    CHIP_ERROR SendCachedResponse(ResponseCacheBase::Entry & entry, chip::System::Clock::Timestamp now, bool & sent);
+
+    /// Number of records that would answer the current query, ignoring multicast throttling
+    size_t CountAnswers(const QueryData & query) const;
+#endif
+
     ServerBase * mServer;
     QueryResponderPtrPool mResponders = {};
 
     /// Current send state
     ResponseBuilder mResponseBuilder;          // packet being built
     Internal::ResponseSendingState mSendState; // sending state
+
+#if CHIP_CONFIG_MINMDNS_RESPONSE_CACHE_SIZE > 0
+    ResponseCache<CHIP_CONFIG_MINMDNS_RESPONSE_CACHE_SIZE> mResponseCache;
+    ResponseCacheBase::Entry * mCacheEntry = nullptr; // where the response being built is recorded
+#endif
 };
 
 } // namespace Minimal
@@ -22,6 +22,31 @@
 namespace mdns {
 namespace Minimal {
 
+namespace {
+
+// 32-bit FNV-1a, folding ASCII case like the strcasecmp comparisons below
+constexpr uint32_t kQNameHashOffset = 2166136261u;
+constexpr uint32_t kQNameHashPrime  = 16777619u;
+
+uint32_t HashQNamePart(uint32_t hash, const char * part)
+{
+    const size_t length = strlen(part);
+
+    hash = (hash ^ static_cast<uint8_t>(length)) * kQNameHashPrime;
+    for (size_t i = 0; i < length; i++)
+    {
+        uint8_t c = static_cast<uint8_t>(part[i]);
+        if (c >= 'A' && c <= 'Z')
+        {
+            c = static_cast<uint8_t>(c - 'A' + 'a');
+        }
+        hash = (hash ^ c) * kQNameHashPrime;
+    }
+    return hash;
+}
+
+} // namespace
+
 bool SerializedQNameIterator::Next()
 {
     return mIsValid && Next(true);
@@ -210,5 +235,25 @@ bool FullQName::operator==(const FullQName & other) const
     return true;
 }
 
+uint32_t QNameHash(const FullQName & name)
+{
+    uint32_t hash = kQNameHashOffset;
+    for (size_t i = 0; i < name.nameCount; i++)
+    {
+        hash = HashQNamePart(hash, name.names[i]);
+    }
+    return hash;
+}
+
+uint32_t QNameHash(SerializedQNameIterator name)
+{
+    uint32_t hash = kQNameHashOffset;
+    while (name.Next())
+    {
+        hash = HashQNamePart(hash, name.Value());
+    }
+    return hash;
+}
+
 } // namespace Minimal
 } // namespace mdns
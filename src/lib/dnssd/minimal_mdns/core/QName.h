@@ -117,5 +117,13 @@ private:
     bool Next(bool followIndirectPointers);
 };
 
+/// Case-insensitive hash of a QName.
+///
+/// Names that compare equal have the same hash, whether they are given as a
+/// FullQName or as a SerializedQNameIterator, so hashes can be used to find
+/// the names to compare a received name against.
+uint32_t QNameHash(const FullQName & name);
+uint32_t QNameHash(SerializedQNameIterator name);
+
 } // namespace Minimal
 } // namespace mdns
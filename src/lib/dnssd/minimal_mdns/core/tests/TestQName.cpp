@@ -298,4 +298,28 @@ TEST(TestQName, SerializedCompare)
     EXPECT_NE(AsSerializedQName(kThisIs), thisIsATestPtr);
 }
 
+TEST(TestQName, Hash)
+{
+    static const uint8_t kThisIsATest1[]    = "\04this\02is\01a\04test\00";
+    static const uint8_t kThisIsATest2[]    = "\04ThIs\02is\01A\04tESt\00";
+    static const uint8_t kThisIsDifferent[] = "\04this\02is\09different\00";
+
+    const QNamePart kThisIsATest[] = { "this", "IS", "a", "test" };
+    const QNamePart kThisIsA[]     = { "this", "is", "a" };
+    const QNamePart kThisIsATeSt[] = { "this", "is", "ate", "st" };
+
+    // Equal names hash the same, whatever their case and representation
+    EXPECT_EQ(QNameHash(AsSerializedQName(kThisIsATest1)), QNameHash(AsSerializedQName(kThisIsATest2)));
+    EXPECT_EQ(QNameHash(AsSerializedQName(kThisIsATest1)), QNameHash(FullQName(kThisIsATest)));
+
+    static const uint8_t kPtrItems[] = "\03abc\02is\01a\04test\00\04this\xc0\04";
+    SerializedQNameIterator thisIsATestPtr(BytesRange(kPtrItems, kPtrItems + sizeof(kPtrItems)), kPtrItems + 15);
+    EXPECT_EQ(QNameHash(thisIsATestPtr), QNameHash(FullQName(kThisIsATest)));
+
+    // Different names are expected to hash differently, including names with the same characters
+    EXPECT_NE(QNameHash(AsSerializedQName(kThisIsDifferent)), QNameHash(FullQName(kThisIsATest)));
+    EXPECT_NE(QNameHash(FullQName(kThisIsA)), QNameHash(FullQName(kThisIsATest)));
+    EXPECT_NE(QNameHash(FullQName(kThisIsATeSt)), QNameHash(FullQName(kThisIsATest)));
+}
+
 } // namespace
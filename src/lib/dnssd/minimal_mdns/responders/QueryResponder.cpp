@@ -20,6 +20,7 @@
 #include <lib/dnssd/minimal_mdns/core/QNameString.h>
 #include <lib/dnssd/minimal_mdns/records/Ptr.h>
 
+#include <lib/support/CodeUtils.h>
 #include <lib/support/logging/CHIPLogging.h>
 
 namespace mdns {
@@ -27,8 +28,10 @@ namespace Minimal {
 
 const QNamePart kDnsSdQueryPath[] = { "_services", "_dns-sd", "_udp", "local" };
 
-QueryResponderBase::QueryResponderBase(Internal::QueryResponderInfo * infos, size_t infoSizes) :
-    Responder(QType::PTR, FullQName(kDnsSdQueryPath)), mResponderInfos(infos), mResponderInfoSize(infoSizes)
+QueryResponderBase::QueryResponderBase(Internal::QueryResponderInfo * infos, size_t infoSizes,
+                                       Internal::QueryResponderInfo ** buckets, size_t bucketCount) :
+    Responder(QType::PTR, FullQName(kDnsSdQueryPath)),
+    mResponderInfos(infos), mResponderInfoSize(infoSizes), mBuckets(buckets), mBucketCount(bucketCount)
 {}
 
 void QueryResponderBase::Init()
@@ -38,10 +41,19 @@ void QueryResponderBase::Init()
         mResponderInfos[i].Clear();
     }
 
+    for (size_t i = 0; i < mBucketCount; i++)
+    {
+        mBuckets[i] = nullptr;
+    }
+
+    mAdditionalHead = nullptr;
+    mAdditionalTail = nullptr;
+
     if (mResponderInfoSize > 0)
     {
         // reply to queries about services available
         mResponderInfos[0].responder = this;
+        AddToIndex(&mResponderInfos[0]);
     }
 
     if (mResponderInfoSize < 2)
@@ -65,6 +77,7 @@ QueryResponderSettings QueryResponderBase::AddResponder(RecordResponder * respon
         {
             mResponderInfos[i].Clear();
             mResponderInfos[i].responder = responder;
+            AddToIndex(&mResponderInfos[i]);
 
             return QueryResponderSettings(&mResponderInfos[i]);
         }
@@ -72,33 +85,83 @@ QueryResponderSettings QueryResponderBase::AddResponder(RecordResponder * respon
     return QueryResponderSettings();
 }
 
-void QueryResponderBase::ResetAdditionals()
+void QueryResponderBase::AddToIndex(Internal::QueryResponderInfo * info)
 {
+    VerifyOrReturn(mBucketCount > 0);
 
-    for (size_t i = 0; i < mResponderInfoSize; i++)
+    info->qnameHash    = QNameHash(info->responder->GetQName());
+    info->nextInBucket = nullptr;
+
+    // Append, so that records sharing a bucket keep the order they were added in
+    Internal::QueryResponderInfo ** link = BucketFor(info->qnameHash);
+    while (*link != nullptr)
+    {
+        link = &(*link)->nextInBucket;
+    }
+    *link = info;
+}
+
+QueryResponderIterator QueryResponderBase::begin(QueryResponderRecordFilter * filter)
+{
+    if (filter->GetIncludeAdditionalRepliesOnly())
+    {
+        return QueryResponderIterator(filter, mAdditionalHead, &Internal::QueryResponderInfo::nextAdditional);
+    }
+
+    if (filter->HasQNameHash() && (mBucketCount > 0))
+    {
+        return QueryResponderIterator(filter, *BucketFor(filter->GetQNameHash()), &Internal::QueryResponderInfo::nextInBucket);
+    }
+
+    return QueryResponderIterator(filter, mResponderInfos, mResponderInfoSize);
+}
+
+void QueryResponderBase::ResetAdditionals()
+{
+    Internal::QueryResponderInfo * info = mAdditionalHead;
+    while (info != nullptr)
     {
-        mResponderInfos[i].reportNowAsAdditional = false;
+        Internal::QueryResponderInfo * next = info->nextAdditional;
+
+        info->reportNowAsAdditional = false;
+        info->nextAdditional        = nullptr;
+        info                        = next;
     }
+
+    mAdditionalHead = nullptr;
+    mAdditionalTail = nullptr;
 }
 
-size_t QueryResponderBase::MarkAdditional(const FullQName & qname)
+size_t QueryResponderBase::MarkAdditional(const FullQName & qname, uint32_t qnameHash)
 {
+    VerifyOrReturnValue(mBucketCount > 0, 0);
+
     size_t count = 0;
-    for (size_t i = 0; i < mResponderInfoSize; i++)
+    for (Internal::QueryResponderInfo * info = *BucketFor(qnameHash); info != nullptr; info = info->nextInBucket)
     {
-        if (mResponderInfos[i].responder == nullptr)
+        if (info->responder == nullptr)
         {
             continue; // not a valid entry
         }
 
-        if (mResponderInfos[i].reportNowAsAdditional)
+        if (info->reportNowAsAdditional)
         {
             continue; // already marked
         }
 
-        if (mResponderInfos[i].responder->GetQName() == qname)
+        if ((info->qnameHash == qnameHash) && (info->responder->GetQName() == qname))
         {
-            mResponderInfos[i].reportNowAsAdditional = true;
+            info->reportNowAsAdditional = true;
+            info->nextAdditional        = nullptr;
+            if (mAdditionalTail == nullptr)
+            {
+                mAdditionalHead = info;
+            }
+            else
+            {
+                mAdditionalTail->nextAdditional = info;
+            }
+            mAdditionalTail = info;
             count++;
         }
     }
@@ -115,26 +178,22 @@ void QueryResponderBase::MarkAdditionalRepliesFor(QueryResponderIterator it)
         return; // nothing additional to report
     }
 
-    if (MarkAdditional(info->additionalQName) == 0)
+    Internal::QueryResponderInfo * lastMarked = mAdditionalTail;
+
+    if (MarkAdditional(info->additionalQName, info->additionalQNameHash) == 0)
     {
         return; // nothing additional added
     }
 
-    // something additionally added. Iterate and re-add until no more additional items were added
-    bool keepAdding = true;
-    while (keepAdding)
+    // something additionally added. Items are appended to the additional list as they are
+    // marked, so walking the newly marked items until the end of the list also handles
+    // anything they mark in turn.
+    Internal::QueryResponderInfo * added = (lastMarked == nullptr) ? mAdditionalHead : lastMarked->nextAdditional;
+    for (; added != nullptr; added = added->nextAdditional)
     {
-        keepAdding = false;
-
-        QueryResponderRecordFilter filter;
-        filter.SetIncludeAdditionalRepliesOnly(true);
-
-        for (auto ait = begin(&filter); ait != end(); ait++)
+        if (added->alsoReportAdditionalQName)
         {
-            if (ait.GetInternal()->alsoReportAdditionalQName)
-            {
-                keepAdding = keepAdding || (MarkAdditional(ait.GetInternal()->additionalQName) != 0);
-            }
+            MarkAdditional(added->additionalQName, added->additionalQNameHash);
         }
     }
 }
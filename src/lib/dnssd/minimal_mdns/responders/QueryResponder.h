@@ -44,12 +44,22 @@ struct QueryResponderInfo : public QueryResponderRecord
     bool alsoReportAdditionalQName = false; // report more data when this record is listed
     FullQName additionalQName;              // if alsoReportAdditionalQName is set, send this extra data
 
+    uint32_t qnameHash           = 0; // QNameHash of the responder qname
+    uint32_t additionalQNameHash = 0; // QNameHash of additionalQName
+
+    QueryResponderInfo * nextInBucket   = nullptr; // next item in the same qname hash bucket
+    QueryResponderInfo * nextAdditional = nullptr; // next item marked as 'reportNowAsAdditional'
+
     void Clear()
     {
         responder                 = nullptr;
         reportService             = false;
         reportNowAsAdditional     = false;
         alsoReportAdditionalQName = false;
+        qnameHash                 = 0;
+        additionalQNameHash       = 0;
+        nextInBucket              = nullptr;
+        nextAdditional            = nullptr;
     }
 };
 
@@ -84,6 +94,7 @@ public:
         {
             mInfo->alsoReportAdditionalQName = true;
             mInfo->additionalQName           = qname;
+            mInfo->additionalQNameHash       = QNameHash(qname);
         }
         return *this;
     }
@@ -128,6 +139,21 @@ public:
         return *this;
     }
 
+    /// Filter out anything whose qname does not have the given QNameHash.
+    ///
+    /// This only narrows down the candidate records: names still have to be
+    /// matched by the reply filter.
+    QueryResponderRecordFilter & SetQNameHash(uint32_t qnameHash)
+    {
+        mFilterByQNameHash = true;
+        mQNameHash         = qnameHash;
+        return *this;
+    }
+
+    bool GetIncludeAdditionalRepliesOnly() const { return mIncludeAdditionalRepliesOnly; }
+    bool HasQNameHash() const { return mFilterByQNameHash; }
+    uint32_t GetQNameHash() const { return mQNameHash; }
+
     bool Accept(Internal::QueryResponderInfo * record) const
     {
         if (record->responder == nullptr)
@@ -135,6 +161,11 @@ public:
             return false;
         }
 
+        if (mFilterByQNameHash && (record->qnameHash != mQNameHash))
+        {
+            return false;
+        }
+
         if (mIncludeAdditionalRepliesOnly && !record->reportNowAsAdditional)
         {
             return false;
@@ -158,10 +189,12 @@ private:
     bool mIncludeAdditionalRepliesOnly                         = false;
     ReplyFilter * mReplyFilter                                 = nullptr;
     chip::System::Clock::Timestamp mIncludeOnlyMulticastBefore = chip::System::Clock::kZero;
+    bool mFilterByQNameHash                                    = false;
+    uint32_t mQNameHash                                        = 0;
 };
 
-/// Iterates over an array of QueryResponderRecord items, providing only 'valid' ones, where
-/// valid is based on the provided filter.
+/// Iterates over an array (or a linked list) of QueryResponderRecord items, providing only 'valid'
+/// ones, where valid is based on the provided filter.
 class QueryResponderIterator
 {
 public:
@@ -169,18 +202,33 @@ public:
     using pointer    = QueryResponderRecord *;
     using reference  = QueryResponderRecord &;
 
+    /// Link between items of a list of QueryResponderInfo (e.g. &QueryResponderInfo::nextInBucket)
+    using NextPointer = Internal::QueryResponderInfo * Internal::QueryResponderInfo::*;
+
     QueryResponderIterator() : mCurrent(nullptr), mRemaining(0) {}
     QueryResponderIterator(QueryResponderRecordFilter * recordFilter, Internal::QueryResponderInfo * pos, size_t size) :
         mFilter(recordFilter), mCurrent(pos), mRemaining(size)
     {
         SkipInvalid();
     }
+    QueryResponderIterator(QueryResponderRecordFilter * recordFilter, Internal::QueryResponderInfo * first, NextPointer next) :
+        mFilter(recordFilter), mCurrent(first), mRemaining(0), mNext(next)
+    {
+        SkipInvalid();
+    }
     QueryResponderIterator(const QueryResponderIterator & other)             = default;
     QueryResponderIterator & operator=(const QueryResponderIterator & other) = default;
 
     QueryResponderIterator & operator++()
     {
-        if (mRemaining != 0)
+        if (mNext != nullptr)
+        {
+            if (mCurrent != nullptr)
+            {
+                mCurrent = mCurrent->*mNext;
+            }
+        }
+        else if (mRemaining != 0)
         {
             mCurrent++;
             mRemaining--;
@@ -207,9 +255,18 @@ public:
 
 private:
     /// Skips invalid/not useful values.
-    /// ensures that if mRemaining is 0, mCurrent is nullptr;
+    /// ensures that if mRemaining is 0 (or the end of the list is reached), mCurrent is nullptr;
     void SkipInvalid()
     {
+        if (mNext != nullptr)
+        {
+            while ((mCurrent != nullptr) && !mFilter->Accept(mCurrent))
+            {
+                mCurrent = mCurrent->*mNext;
+            }
+            return;
+        }
+
         while ((mRemaining > 0) && !mFilter->Accept(mCurrent))
         {
             mRemaining--;
@@ -224,6 +281,7 @@ private:
     QueryResponderRecordFilter * mFilter;
     Internal::QueryResponderInfo * mCurrent;
     size_t mRemaining;
+    NextPointer mNext = nullptr; // set when iterating over a linked list rather than an array
 };
 
 /// Responds to mDNS queries.
@@ -234,11 +292,17 @@ private:
 ///
 /// Maintains a stateful list of 'additional replies' that can be marked/unmarked
 /// for query processing
+///
+/// Records are indexed by the hash of their qname as they are added, so that
+/// answering a query only looks at the records that may match its name rather
+/// than at every record.
 class QueryResponderBase : public Responder // "_services._dns-sd._udp.local"
 {
 public:
-    /// Builds a new responder with the given storage for the response infos
-    QueryResponderBase(Internal::QueryResponderInfo * infos, size_t infoSizes);
+    /// Builds a new responder with the given storage for the response infos and
+    /// for the qname hash index.
+    QueryResponderBase(Internal::QueryResponderInfo * infos, size_t infoSizes, Internal::QueryResponderInfo ** buckets,
+                       size_t bucketCount);
     ~QueryResponderBase() override {}
 
     /// Setup initial settings (clears all infos and sets up dns-sd query replies)
@@ -255,10 +319,11 @@ public:
     void AddAllResponses(const chip::Inet::IPPacketInfo * source, ResponderDelegate * delegate,
                          const ResponseConfiguration & configuration) override;
 
-    QueryResponderIterator begin(QueryResponderRecordFilter * filter)
-    {
-        return QueryResponderIterator(filter, mResponderInfos, mResponderInfoSize);
-    }
+    /// Iterate over the records accepted by the given filter.
+    ///
+    /// Only the records marked as additional or, if the filter has a qname hash,
+    /// the records in the matching hash bucket are looked at.
+    QueryResponderIterator begin(QueryResponderRecordFilter * filter);
     QueryResponderIterator end() { return QueryResponderIterator(); }
 
     /// Clear any items marked as 'additional'.
@@ -266,7 +331,7 @@ public:
 
     /// Marks queries matching this qname as 'to be additionally reported'
     /// @return the number of items marked new as 'additional data'.
-    size_t MarkAdditional(const FullQName & qname);
+    size_t MarkAdditional(const FullQName & qname) { return MarkAdditional(qname, QNameHash(qname)); }
 
     /// Flag any additional responses required for the given iterator
     void MarkAdditionalRepliesFor(QueryResponderIterator it);
@@ -276,18 +341,32 @@ public:
     void ClearBroadcastThrottle();
 
 private:
+    size_t MarkAdditional(const FullQName & qname, uint32_t qnameHash);
+
+    /// Adds the given info to the qname hash index
+    void AddToIndex(Internal::QueryResponderInfo * info);
+
+    Internal::QueryResponderInfo ** BucketFor(uint32_t qnameHash) { return &mBuckets[qnameHash % mBucketCount]; }
+
     Internal::QueryResponderInfo * mResponderInfos;
     size_t mResponderInfoSize;
+    Internal::QueryResponderInfo ** mBuckets;
+    size_t mBucketCount;
+
+    // Items marked as 'reportNowAsAdditional', in the order they were marked
+    Internal::QueryResponderInfo * mAdditionalHead = nullptr;
+    Internal::QueryResponderInfo * mAdditionalTail = nullptr;
 };
 
 template <size_t kSize>
 class QueryResponder : public QueryResponderBase
 {
 public:
-    QueryResponder() : QueryResponderBase(mData, kSize) { Init(); }
+    QueryResponder() : QueryResponderBase(mData, kSize, mBuckets, kSize) { Init(); }
 
 private:
     Internal::QueryResponderInfo mData[kSize];
+    Internal::QueryResponderInfo * mBuckets[kSize];
 };
 
 } // namespace Minimal
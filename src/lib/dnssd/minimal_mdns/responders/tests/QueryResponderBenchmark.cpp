@@ -0,0 +1,152 @@
+/*
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @file
+ *   Measures how long a minimal mDNS QueryResponder takes to find the record answering a query, for
+ *   1 to 64 records named after operational instances.  Every case looks up the record added last,
+ *   once by going through all records (what answering a query used to do) and once through the
+ *   qname hash index, including hashing the received name.
+ *
+ *   Usage: minmdns-query-responder-benchmark [iterations]
+ */
+
+#include <lib/dnssd/minimal_mdns/Parser.h>
+#include <lib/dnssd/minimal_mdns/QueryReplyFilter.h>
+#include <lib/dnssd/minimal_mdns/responders/Ptr.h>
+#include <lib/dnssd/minimal_mdns/responders/QueryResponder.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/tests/BenchmarkHelpers.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+using namespace chip;
+using namespace mdns::Minimal;
+
+namespace {
+
+constexpr uint64_t kDefaultIterations = 200000;
+constexpr size_t kMaxRecords          = 64;
+constexpr size_t kInstanceNameLength  = 33; // <compressed fabric id>-<node id>
+
+const QNamePart kOperationalService[] = { "_matter", "_tcp", "local" };
+
+char gInstanceNames[kMaxRecords][kInstanceNameLength + 1];
+QNamePart gInstanceQNames[kMaxRecords][4];
+std::vector<PtrResponder> gRecords;
+
+FullQName InstanceQName(size_t idx)
+{
+    FullQName qname;
+    qname.names     = gInstanceQNames[idx];
+    qname.nameCount = 4;
+    return qname;
+}
+
+/// Serialized form of the instance name, as found in a received query
+size_t SerializeInstanceQName(size_t idx, uint8_t * out)
+{
+    size_t len = 0;
+    for (QNamePart part : gInstanceQNames[idx])
+    {
+        const size_t partLength = strlen(part);
+        out[len++]              = static_cast<uint8_t>(partLength);
+        memcpy(out + len, part, partLength);
+        len += partLength;
+    }
+    out[len++] = 0;
+    return len;
+}
+
+size_t CountAnswers(QueryResponderBase & responder, QueryResponderRecordFilter & filter)
+{
+    size_t count = 0;
+    for (auto it = responder.begin(&filter); it != responder.end(); it++)
+    {
+        count++;
+    }
+    return count;
+}
+
+bool RunCase(size_t recordCount, uint64_t iterations)
+{
+    QueryResponder<kMaxRecords + 1> responder;
+    for (size_t i = 0; i < recordCount; i++)
+    {
+        VerifyOrReturnValue(responder.AddResponder(&gRecords[i]).IsValid(), false);
+    }
+
+    uint8_t queryName[128];
+    const size_t queryNameLength = SerializeInstanceQName(recordCount - 1, queryName);
+    const QueryData query(QType::ANY, QClass::IN, false, queryName, BytesRange(queryName, queryName + queryNameLength));
+
+    char name[64];
+
+    snprintf(name, sizeof(name), "answer lookup, %u records, linear scan", static_cast<unsigned>(recordCount));
+    Test::PrintBenchmarkResult(Test::RunBenchmark(name, iterations, [&](uint64_t) {
+        QueryReplyFilter replyFilter(query);
+        QueryResponderRecordFilter filter;
+        filter.SetReplyFilter(&replyFilter);
+        return CountAnswers(responder, filter) == 1;
+    }));
+
+    snprintf(name, sizeof(name), "answer lookup, %u records, hash index", static_cast<unsigned>(recordCount));
+    Test::PrintBenchmarkResult(Test::RunBenchmark(name, iterations, [&](uint64_t) {
+        QueryReplyFilter replyFilter(query);
+        QueryResponderRecordFilter filter;
+        filter.SetReplyFilter(&replyFilter).SetQNameHash(QNameHash(query.GetName()));
+        return CountAnswers(responder, filter) == 1;
+    }));
+
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+    const uint64_t iterations = (argc > 1) ? strtoull(argv[1], nullptr, 0) : kDefaultIterations;
+
+    for (size_t i = 0; i < kMaxRecords; i++)
+    {
+        snprintf(gInstanceNames[i], sizeof(gInstanceNames[i]), "%016" PRIX64 "-%016" PRIX64, UINT64_C(0x87E1B004E235A130),
+                 static_cast<uint64_t>(i + 1));
+        gInstanceQNames[i][0] = gInstanceNames[i];
+        gInstanceQNames[i][1] = kOperationalService[0];
+        gInstanceQNames[i][2] = kOperationalService[1];
+        gInstanceQNames[i][3] = kOperationalService[2];
+    }
+
+    gRecords.reserve(kMaxRecords);
+    for (size_t i = 0; i < kMaxRecords; i++)
+    {
+        gRecords.emplace_back(InstanceQName(i), kOperationalService);
+    }
+
+    Test::PrintBenchmarkHeader();
+    for (size_t recordCount = 1; recordCount <= kMaxRecords; recordCount *= 2)
+    {
+        VerifyOrReturnValue(RunCase(recordCount, iterations), EXIT_FAILURE);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -165,4 +165,89 @@ TEST(TestQueryResponder, NonDiscoverableService)
         EXPECT_EQ(accumulator.Captures()[0], kName2);
     }
 }
+
+TEST(TestQueryResponder, LooksUpRecordsByName)
+{
+    QueryResponder<10> responder;
+
+    const QNamePart kName3[] = { "SOME", "Test" };
+
+    EmptyResponder empty1(kName1);
+    EmptyResponder empty2(kName2);
+    EmptyResponder empty3(kName3);
+
+    EXPECT_TRUE(responder.AddResponder(&empty1).IsValid());
+    EXPECT_TRUE(responder.AddResponder(&empty2).IsValid());
+    EXPECT_TRUE(responder.AddResponder(&empty3).IsValid());
+
+    QueryResponderRecordFilter filter;
+    filter.SetQNameHash(QNameHash(FullQName(kName1)));
+
+    // Names match case-insensitively
+    std::vector<Responder *> found;
+    for (auto it = responder.begin(&filter); it != responder.end(); it++)
+    {
+        found.push_back(it->responder);
+    }
+    ASSERT_EQ(found.size(), 2u);
+    EXPECT_EQ(found[0], &empty1);
+    EXPECT_EQ(found[1], &empty3);
+
+    filter.SetQNameHash(QNameHash(FullQName(kDnsSdname)));
+    auto it = responder.begin(&filter);
+    ASSERT_NE(it, responder.end());
+    EXPECT_EQ(it->responder, &responder);
+    EXPECT_EQ(++it, responder.end());
+}
+
+TEST(TestQueryResponder, MarksAdditionalsTransitively)
+{
+    QueryResponder<10> responder;
+
+    const QNamePart kPtrName[]  = { "_service", "_tcp", "local" };
+    const QNamePart kSrvName[]  = { "instance", "_service", "_tcp", "local" };
+    const QNamePart kHostName[] = { "host", "local" };
+
+    EmptyResponder ptr(kPtrName);
+    EmptyResponder srv(kSrvName);
+    EmptyResponder txt(kSrvName);
+    EmptyResponder host(kHostName);
+    EmptyResponder unrelated(kName1);
+
+    EXPECT_TRUE(responder.AddResponder(&host).IsValid());
+    EXPECT_TRUE(responder.AddResponder(&unrelated).IsValid());
+    EXPECT_TRUE(responder.AddResponder(&srv).SetReportAdditional(kHostName).IsValid());
+    EXPECT_TRUE(responder.AddResponder(&txt).IsValid());
+    EXPECT_TRUE(responder.AddResponder(&ptr).SetReportAdditional(kSrvName).IsValid());
+
+    QueryResponderRecordFilter answerFilter;
+    answerFilter.SetQNameHash(QNameHash(FullQName(kPtrName)));
+    auto answer = responder.begin(&answerFilter);
+    ASSERT_NE(answer, responder.end());
+    EXPECT_EQ(answer->responder, &ptr);
+
+    responder.MarkAdditionalRepliesFor(answer);
+
+    // PTR references SRV and TXT, SRV references the host
+    QueryResponderRecordFilter additionalFilter;
+    additionalFilter.SetIncludeAdditionalRepliesOnly(true);
+
+    std::vector<Responder *> additionals;
+    for (auto it = responder.begin(&additionalFilter); it != responder.end(); it++)
+    {
+        additionals.push_back(it->responder);
+    }
+    ASSERT_EQ(additionals.size(), 3u);
+    EXPECT_EQ(additionals[0], &srv);
+    EXPECT_EQ(additionals[1], &txt);
+    EXPECT_EQ(additionals[2], &host);
+
+    // Marking again does not duplicate anything
+    EXPECT_EQ(responder.MarkAdditional(kHostName), 0u);
+
+    responder.ResetAdditionals();
+    EXPECT_EQ(responder.begin(&additionalFilter), responder.end());
+    EXPECT_EQ(responder.MarkAdditional(kHostName), 1u);
+}
+
 } // namespace
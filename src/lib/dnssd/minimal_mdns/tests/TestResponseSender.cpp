@@ -350,4 +350,44 @@ TEST_F(TestResponseSender, PtrSrvTxtMultipleRespondersToServiceListing)
     EXPECT_TRUE(common1->server.GetHeaderFound());
 }
 
+#if CHIP_CONFIG_MINMDNS_RESPONSE_CACHE_SIZE > 0
+TEST_F(TestResponseSender, RepeatedQueryAnsweredFromCache)
+{
+    CommonTestElements common("test");
+    ResponseSender responseSender(&common.server);
+    EXPECT_EQ(responseSender.AddQueryResponder(&common.queryResponder), CHIP_NO_ERROR);
+    common.queryResponder.AddResponder(&common.srvResponder);
+
+    // Build a unicast mDNS query (not a legacy one) for the instance name
+    common.recordWriter.WriteQName(common.instance);
+    common.packetInfo.SrcPort = 5353;
+
+    QueryData queryData = QueryData(QType::ANY, QClass::IN, true, common.requestNameStart, common.requestBytesRange);
+
+    common.server.AddExpectedRecord(&common.srvRecord);
+    EXPECT_EQ(responseSender.Respond(1, queryData, &common.packetInfo, ResponseConfiguration()), CHIP_NO_ERROR);
+    EXPECT_TRUE(common.server.GetSendCalled());
+    EXPECT_TRUE(common.server.GetHeaderFound());
+
+    // Records changed behind the back of the sender: the cached response is still sent
+    common.queryResponder.AddResponder(&common.txtResponder);
+
+    common.server.Reset();
+    common.server.AddExpectedRecord(&common.srvRecord);
+    EXPECT_EQ(responseSender.Respond(2, queryData, &common.packetInfo, ResponseConfiguration()), CHIP_NO_ERROR);
+    EXPECT_TRUE(common.server.GetSendCalled());
+    EXPECT_TRUE(common.server.GetHeaderFound());
+
+    // Once invalidated, the response is built again
+    responseSender.InvalidateCachedResponses();
+
+    common.server.Reset();
+    common.server.AddExpectedRecord(&common.srvRecord);
+    common.server.AddExpectedRecord(&common.txtRecord);
+    EXPECT_EQ(responseSender.Respond(3, queryData, &common.packetInfo, ResponseConfiguration()), CHIP_NO_ERROR);
+    EXPECT_TRUE(common.server.GetSendCalled());
+    EXPECT_TRUE(common.server.GetHeaderFound());
+}
+#endif // CHIP_CONFIG_MINMDNS_RESPONSE_CACHE_SIZE > 0
+
 } // namespace
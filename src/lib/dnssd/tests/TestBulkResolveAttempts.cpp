@@ -0,0 +1,206 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <pw_unit_test/framework.h>
+
+#include <lib/core/StringBuilderAdapters.h>
+#include <lib/dnssd/BulkResolveAttempts.h>
+
+#include <vector>
+
+namespace {
+
+using namespace chip;
+using namespace chip::System::Clock::Literals;
+using chip::System::Clock::Timeout;
+using mdns::Minimal::BulkResolveAttempts;
+
+PeerId MakePeerId(NodeId nodeId)
+{
+    PeerId peerId;
+    return peerId.SetNodeId(nodeId).SetCompressedFabricId(123);
+}
+
+template <size_t N>
+std::vector<std::pair<NodeId, uint32_t>> KnownAnswers(const BulkResolveAttempts<N> & attempts)
+{
+    std::vector<std::pair<NodeId, uint32_t>> answers;
+    attempts.ForEachKnownAnswer(
+        [&answers](const PeerId & peerId, uint32_t ttlSeconds) { answers.emplace_back(peerId.GetNodeId(), ttlSeconds); });
+    return answers;
+}
+
+TEST(TestBulkResolveAttempts, TestSingleBrowseForAllPeers)
+{
+    System::Clock::Internal::MockClock mockClock;
+    BulkResolveAttempts<8> attempts(&mockClock);
+    bool firstSend = false;
+
+    mockClock.AdvanceMonotonic(1234_ms32);
+
+    EXPECT_FALSE(attempts.HasPending());
+    EXPECT_FALSE(attempts.GetTimeUntilNextQuery().has_value());
+    EXPECT_FALSE(attempts.NextQuery(firstSend));
+
+    for (NodeId id = 1; id <= 5; id++)
+    {
+        EXPECT_EQ(attempts.MarkPending(MakePeerId(id)), CHIP_NO_ERROR);
+    }
+
+    // All peers share one query
+    EXPECT_EQ(attempts.GetTimeUntilNextQuery(), std::make_optional<Timeout>(0_ms32));
+    EXPECT_TRUE(attempts.NextQuery(firstSend));
+    EXPECT_TRUE(firstSend);
+    EXPECT_FALSE(attempts.NextQuery(firstSend));
+    EXPECT_EQ(attempts.GetTimeUntilNextQuery(), std::make_optional<Timeout>(1000_ms32));
+
+    // Retries back off like individual resolves
+    mockClock.AdvanceMonotonic(1000_ms32);
+    EXPECT_TRUE(attempts.NextQuery(firstSend));
+    EXPECT_FALSE(firstSend);
+    EXPECT_EQ(attempts.GetTimeUntilNextQuery(), std::make_optional<Timeout>(2000_ms32));
+
+    for (NodeId id = 1; id <= 5; id++)
+    {
+        EXPECT_TRUE(attempts.IsPending(MakePeerId(id)));
+        EXPECT_TRUE(attempts.Complete(MakePeerId(id), 120));
+    }
+
+    // Browse is over once every peer answered
+    EXPECT_FALSE(attempts.HasPending());
+    EXPECT_FALSE(attempts.GetTimeUntilNextQuery().has_value());
+    EXPECT_TRUE(KnownAnswers(attempts).empty());
+}
+
+TEST(TestBulkResolveAttempts, TestKnownAnswers)
+{
+    System::Clock::Internal::MockClock mockClock;
+    BulkResolveAttempts<8> attempts(&mockClock);
+    bool firstSend = false;
+
+    mockClock.AdvanceMonotonic(1234_ms32);
+
+    EXPECT_EQ(attempts.MarkPending(MakePeerId(1)), CHIP_NO_ERROR);
+    EXPECT_EQ(attempts.MarkPending(MakePeerId(2)), CHIP_NO_ERROR);
+    EXPECT_EQ(attempts.MarkPending(MakePeerId(3)), CHIP_NO_ERROR);
+    EXPECT_TRUE(attempts.NextQuery(firstSend));
+
+    // Peer 1 answers with a PTR TTL that differs from its SRV TTL
+    attempts.SetAnswerTtl(MakePeerId(1), 4500);
+    EXPECT_TRUE(attempts.Complete(MakePeerId(1), 120));
+    EXPECT_TRUE(attempts.Complete(MakePeerId(2), 120));
+    EXPECT_FALSE(attempts.Complete(MakePeerId(2), 120));
+    EXPECT_FALSE(attempts.Complete(MakePeerId(4), 120));
+
+    mockClock.AdvanceMonotonic(1000_ms32);
+    EXPECT_TRUE(attempts.NextQuery(firstSend));
+
+    auto answers = KnownAnswers(attempts);
+    ASSERT_EQ(answers.size(), 2u);
+    EXPECT_EQ(answers[0].first, 1u);
+    EXPECT_EQ(answers[0].second, 4499u);
+    EXPECT_EQ(answers[1].first, 2u);
+    EXPECT_EQ(answers[1].second, 119u);
+
+    // Answers at less than half their TTL are not listed anymore
+    mockClock.AdvanceMonotonic(61000_ms32);
+    answers = KnownAnswers(attempts);
+    ASSERT_EQ(answers.size(), 1u);
+    EXPECT_EQ(answers[0].first, 1u);
+
+    // A known answer that is asked for again is pending again
+    EXPECT_EQ(attempts.MarkPending(MakePeerId(1)), CHIP_NO_ERROR);
+    EXPECT_TRUE(attempts.IsPending(MakePeerId(1)));
+    EXPECT_TRUE(KnownAnswers(attempts).empty());
+}
+
+TEST(TestBulkResolveAttempts, TestConsumers)
+{
+    System::Clock::Internal::MockClock mockClock;
+    BulkResolveAttempts<2> attempts(&mockClock);
+    bool firstSend = false;
+
+    EXPECT_EQ(attempts.MarkPending(MakePeerId(1)), CHIP_NO_ERROR);
+    EXPECT_EQ(attempts.MarkPending(MakePeerId(1)), CHIP_NO_ERROR);
+    EXPECT_EQ(attempts.MarkPending(MakePeerId(2)), CHIP_NO_ERROR);
+
+    // No room for a third peer: the caller resolves it on its own
+    EXPECT_EQ(attempts.MarkPending(MakePeerId(3)), CHIP_ERROR_NO_MEMORY);
+
+    attempts.NodeIdResolutionNoLongerNeeded(MakePeerId(1));
+    EXPECT_TRUE(attempts.IsPending(MakePeerId(1)));
+    attempts.NodeIdResolutionNoLongerNeeded(MakePeerId(1));
+    EXPECT_FALSE(attempts.IsPending(MakePeerId(1)));
+
+    EXPECT_TRUE(attempts.NextQuery(firstSend));
+    EXPECT_TRUE(attempts.Complete(MakePeerId(2), 120));
+    EXPECT_FALSE(attempts.HasPending());
+
+    // Entries of a finished browse are free again
+    EXPECT_EQ(attempts.MarkPending(MakePeerId(3)), CHIP_NO_ERROR);
+    EXPECT_EQ(attempts.MarkPending(MakePeerId(4)), CHIP_NO_ERROR);
+
+    // Answered entries make room for new peers while browsing
+    EXPECT_TRUE(attempts.NextQuery(firstSend));
+    EXPECT_TRUE(firstSend);
+    EXPECT_TRUE(attempts.Complete(MakePeerId(3), 120));
+    EXPECT_EQ(attempts.MarkPending(MakePeerId(5)), CHIP_NO_ERROR);
+    EXPECT_TRUE(attempts.IsPending(MakePeerId(5)));
+}
+
+TEST(TestBulkResolveAttempts, TestLatePeerRequeries)
+{
+    System::Clock::Internal::MockClock mockClock;
+    BulkResolveAttempts<4> attempts(&mockClock);
+    bool firstSend = false;
+
+    mockClock.AdvanceMonotonic(1234_ms32);
+
+    EXPECT_EQ(attempts.MarkPending(MakePeerId(1)), CHIP_NO_ERROR);
+    EXPECT_TRUE(attempts.NextQuery(firstSend));
+    mockClock.AdvanceMonotonic(1000_ms32);
+    EXPECT_TRUE(attempts.NextQuery(firstSend));
+    EXPECT_EQ(attempts.GetTimeUntilNextQuery(), std::make_optional<Timeout>(2000_ms32));
+
+    // A peer joining the running browse may have answered already: query
+    // again one second after the last query.
+    mockClock.AdvanceMonotonic(500_ms32);
+    EXPECT_EQ(attempts.MarkPending(MakePeerId(2)), CHIP_NO_ERROR);
+    EXPECT_EQ(attempts.GetTimeUntilNextQuery(), std::make_optional<Timeout>(500_ms32));
+}
+
+TEST(TestBulkResolveAttempts, TestTimeout)
+{
+    System::Clock::Internal::MockClock mockClock;
+    BulkResolveAttempts<4> attempts(&mockClock);
+    bool firstSend = false;
+
+    EXPECT_EQ(attempts.MarkPending(MakePeerId(1)), CHIP_NO_ERROR);
+
+    // 1 + 2 + 4 + 8 + 16 seconds between queries, then give up
+    for (int i = 0; i < 5; i++)
+    {
+        EXPECT_TRUE(attempts.NextQuery(firstSend));
+        mockClock.AdvanceMonotonic(*attempts.GetTimeUntilNextQuery());
+    }
+
+    EXPECT_FALSE(attempts.NextQuery(firstSend));
+    EXPECT_FALSE(attempts.HasPending());
+    EXPECT_FALSE(attempts.IsPending(MakePeerId(1)));
+}
+
+} // namespace
@@ -117,6 +117,8 @@ public:
     }
 
     static StorageKeyName SessionResumptionIndex() { return StorageKeyName::FromConst("g/sri"); }
+    static StorageKeyName SessionResumptionIndexPage(uint16_t page) { return StorageKeyName::Formatted("g/sri/%x", page); }
+    static StorageKeyName SessionResumptionIndexPageCount() { return StorageKeyName::FromConst("g/sri/n"); }
     static StorageKeyName SessionResumption(const char * resumptionIdBase64)
     {
         return StorageKeyName::Formatted("g/s/%s", resumptionIdBase64);
@@ -0,0 +1,95 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @file
+ *   Minimal helpers shared by the host benchmark executables: time a loop on the steady clock and
+ *   print one line per case with ns/op and ops/s.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+
+namespace chip {
+namespace Test {
+
+struct BenchmarkResult
+{
+    const char * mName   = nullptr;
+    uint64_t mIterations = 0;
+    uint64_t mTotalNs    = 0;
+
+    double NsPerOp() const { return mIterations == 0 ? 0.0 : static_cast<double>(mTotalNs) / static_cast<double>(mIterations); }
+    double OpsPerSecond() const { return mTotalNs == 0 ? 0.0 : static_cast<double>(mIterations) * 1e9 / static_cast<double>(mTotalNs); }
+};
+
+/**
+ * Keep the compiler from optimizing away a value computed by a benchmark body.
+ */
+template <typename T>
+inline void DoNotOptimize(const T & value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * Run `body(iteration)` `iterations` times and return how long it took.  `body` may return false
+ * to report a failure, in which case the run stops and the result has zero iterations.
+ */
+template <typename Body>
+BenchmarkResult RunBenchmark(const char * name, uint64_t iterations, Body && body)
+{
+    BenchmarkResult result;
+    result.mName = name;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        if (!body(i))
+        {
+            printf("%-56s FAILED at iteration %" PRIu64 "\n", name, i);
+            return result;
+        }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    result.mIterations = iterations;
+    result.mTotalNs    = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    return result;
+}
+
+inline void PrintBenchmarkHeader()
+{
+    printf("%-56s %12s %14s %14s\n", "benchmark", "iterations", "ns/op", "ops/s");
+}
+
+inline void PrintBenchmarkResult(const BenchmarkResult & result)
+{
+    if (result.mIterations == 0)
+    {
+        return;
+    }
+    printf("%-56s %12" PRIu64 " %14.1f %14.0f\n", result.mName, result.mIterations, result.NsPerOp(), result.OpsPerSecond());
+}
+
+} // namespace Test
+} // namespace chip
@@ -150,203 +150,31 @@ static constexpr ExchangeContext::Timeout kExpectedLowProcessingTime    = System
 static constexpr ExchangeContext::Timeout kExpectedSigma1ProcessingTime = kExpectedLowProcessingTime;
 static constexpr ExchangeContext::Timeout kExpectedHighProcessingTime   = System::Clock::Seconds16(30);
 
-// Helper for managing a session's outstanding work.
-// Holds work data which is provided to a scheduled work callback (standalone),
-// then (if not canceled) to a scheduled after work callback (on the session).
-template <class DATA>
-class CASESession::WorkHelper
-{
-public:
-    // Work callback, processed in the background via `PlatformManager::ScheduleBackgroundWork`.
-    // This is a non-member function which does not use the associated session.
-    // The return value is passed to the after work callback (called afterward).
-    // Set `cancel` to true if calling the after work callback is not necessary.
-    typedef CHIP_ERROR (*WorkCallback)(DATA & data, bool & cancel);
-
-    // After work callback, processed in the main Matter task via `PlatformManager::ScheduleWork`.
-    // This is a member function to be called on the associated session after the work callback.
-    // The `status` value is the result of the work callback (called beforehand), or the status of
-    // queueing the after work callback back to the Matter thread, if the work callback succeeds
-    // but queueing fails.
-    //
-    // When this callback is called asynchronously (i.e. via ScheduleWork), the helper guarantees
-    // that it will keep itself (and hence `data`) alive until the callback completes.
-    typedef CHIP_ERROR (CASESession::*AfterWorkCallback)(DATA & data, CHIP_ERROR status);
-
-public:
-    // Create a work helper using the specified session, work callback, after work callback, and data (template arg).
-    // Lifetime is managed by sharing between the caller (typically the session) and the helper itself (while work is scheduled).
-    static Platform::SharedPtr<WorkHelper> Create(CASESession & session, WorkCallback workCallback,
-                                                  AfterWorkCallback afterWorkCallback)
-    {
-        struct EnableShared : public WorkHelper
-        {
-            EnableShared(CASESession & session, WorkCallback workCallback, AfterWorkCallback afterWorkCallback) :
-                WorkHelper(session, workCallback, afterWorkCallback)
-            {}
-        };
-        auto ptr = Platform::MakeShared<EnableShared>(session, workCallback, afterWorkCallback);
-        if (ptr)
-        {
-            ptr->mWeakPtr = ptr; // used by `ScheduleWork`
-        }
-        return ptr;
-    }
+// How often to check, while background work is outstanding, whether its result could not be handed back.
+static constexpr System::Clock::Timeout kBackgroundWorkWatchdogInterval = System::Clock::Seconds16(1);
 
-    // Do the work immediately.
-    // No scheduling, no outstanding work, no shared lifetime management.
-    //
-    // The caller must guarantee that it keeps the helper alive across this call, most likely by
-    // holding a reference to it on the stack.
-    CHIP_ERROR DoWork()
-    {
-        // Ensure that this function is being called from main Matter thread
-        assertChipStackLockedByCurrentThread();
-
-        VerifyOrReturnError(mSession && mWorkCallback && mAfterWorkCallback, CHIP_ERROR_INCORRECT_STATE);
-        auto * helper   = this;
-        bool cancel     = false;
-        helper->mStatus = helper->mWorkCallback(helper->mData, cancel);
-        if (!cancel)
-        {
-            helper->mStatus = (helper->mSession->*(helper->mAfterWorkCallback))(helper->mData, helper->mStatus);
-        }
-        return helper->mStatus;
-    }
-
-    // Schedule the work for later execution.
-    // If lifetime is managed, the helper shares management while work is outstanding.
-    CHIP_ERROR ScheduleWork()
-    {
-        VerifyOrReturnError(mSession && mWorkCallback && mAfterWorkCallback, CHIP_ERROR_INCORRECT_STATE);
-        // Hold strong ptr while work is outstanding
-        mStrongPtr  = mWeakPtr.lock(); // set in `Create`
-        auto status = DeviceLayer::PlatformMgr().ScheduleBackgroundWork(WorkHandler, reinterpret_cast<intptr_t>(this));
-        if (status != CHIP_NO_ERROR)
-        {
-            // Release strong ptr since scheduling failed.
-            mStrongPtr.reset();
-        }
-        return status;
-    }
-
-    // Cancel the work, by clearing the associated session.
-    void CancelWork() { mSession.store(nullptr); }
-
-    bool IsCancelled() const { return mSession.load() == nullptr; }
-
-    // This API returns true when background thread fails to schedule the AfterWorkCallback
-    bool UnableToScheduleAfterWorkCallback() { return mScheduleAfterWorkFailed.load(); }
-
-    // Do after work immediately.
-    // No scheduling, no outstanding work, no shared lifetime management.
-    void DoAfterWork()
-    {
-        VerifyOrDie(UnableToScheduleAfterWorkCallback());
-        AfterWorkHandler(reinterpret_cast<intptr_t>(this));
-    }
-
-private:
-    // Create a work helper using the specified session, work callback, after work callback, and data (template arg).
-    // Lifetime is not managed, see `Create` for that option.
-    WorkHelper(CASESession & session, WorkCallback workCallback, AfterWorkCallback afterWorkCallback) :
-        mSession(&session), mWorkCallback(workCallback), mAfterWorkCallback(afterWorkCallback)
-    {}
-
-    // Handler for the work callback.
-    static void WorkHandler(intptr_t arg)
-    {
-        auto * helper = reinterpret_cast<WorkHelper *>(arg);
-        // Hold strong ptr while work is handled
-        auto strongPtr(std::move(helper->mStrongPtr));
-        VerifyOrReturn(!helper->IsCancelled());
-        bool cancel = false;
-        // Execute callback in background thread; data must be OK with this
-        helper->mStatus = helper->mWorkCallback(helper->mData, cancel);
-        VerifyOrReturn(!cancel && !helper->IsCancelled());
-        // Hold strong ptr to ourselves while work is outstanding
-        helper->mStrongPtr.swap(strongPtr);
-        auto status = DeviceLayer::PlatformMgr().ScheduleWork(AfterWorkHandler, reinterpret_cast<intptr_t>(helper));
-        if (status != CHIP_NO_ERROR)
-        {
-            ChipLogError(SecureChannel, "Failed to Schedule the AfterWorkCallback on foreground thread: %" CHIP_ERROR_FORMAT,
-                         status.Format());
-
-            // We failed to schedule after work callback, so setting mScheduleAfterWorkFailed flag to true
-            // This can be checked from foreground thread and after work callback can be retried
-            helper->mStatus = status;
-
-            // Release strong ptr to self since scheduling failed, because nothing guarantees
-            // that AfterWorkHandler will get called at this point to release the reference,
-            // and we don't want to leak.  That said, we want to ensure that "helper" stays
-            // alive through the end of this function (so we can set mScheduleAfterWorkFailed
-            // on it), but also want to avoid racing on the single SharedPtr instance in
-            // helper->mStrongPtr.  That means we need to not touch helper->mStrongPtr after
-            // writing to mScheduleAfterWorkFailed.
-            //
-            // The simplest way to do this is to move the reference in helper->mStrongPtr to
-            // our stack, where it outlives all our accesses to "helper".
-            strongPtr.swap(helper->mStrongPtr);
-
-            // helper and any of its state should not be touched after storing mScheduleAfterWorkFailed.
-            helper->mScheduleAfterWorkFailed.store(true);
-        }
-    }
-
-    // Handler for the after work callback.
-    static void AfterWorkHandler(intptr_t arg)
-    {
-        // Ensure that this function is being called from main Matter thread
-        assertChipStackLockedByCurrentThread();
-
-        auto * helper = reinterpret_cast<WorkHelper *>(arg);
-        // Hold strong ptr while work is handled, and ensure that helper->mStrongPtr does not keep
-        // holding a reference.
-        auto strongPtr(std::move(helper->mStrongPtr));
-        if (!strongPtr)
-        {
-            // This can happen if scheduling AfterWorkHandler failed.  Just grab a strong ref
-            // to handler directly, to fulfill our API contract of holding a strong reference
-            // across the after-work callback.  At this point, we are guaranteed that the
-            // background thread is not touching the helper anymore.
-            strongPtr = helper->mWeakPtr.lock();
-        }
-        if (auto * session = helper->mSession.load())
-        {
-            // Execute callback in Matter thread; session should be OK with this
-            (session->*(helper->mAfterWorkCallback))(helper->mData, helper->mStatus);
-        }
-    }
-
-private:
-    // Lifetime management: `ScheduleWork` sets `mStrongPtr` from `mWeakPtr`.
-    Platform::WeakPtr<WorkHelper> mWeakPtr;
+struct CASESession::HandleSigma2Data
+{
+    chip::Platform::ScopedMemoryBuffer<uint8_t> msg_R2_Signed;
+    size_t msg_r2_signed_len;
 
-    // Lifetime management: `ScheduleWork` sets `mStrongPtr` from `mWeakPtr`.
-    Platform::SharedPtr<WorkHelper> mStrongPtr;
+    ByteSpan responderNOC;
+    ByteSpan responderICAC;
 
-    // Associated session, cleared by `CancelWork`.
-    std::atomic<CASESession *> mSession;
+    uint8_t rootCertBuf[kMaxCHIPCertLength];
+    ByteSpan fabricRCAC;
 
-    // Work callback, called by `WorkHandler`.
-    WorkCallback mWorkCallback;
+    P256ECDSASignature tbsData2Signature;
 
-    // After work callback, called by `AfterWorkHandler`.
-    AfterWorkCallback mAfterWorkCallback;
+    FabricId fabricId;
+    NodeId expectedResponderNodeId;
 
-    // Return value of `mWorkCallback`, passed to `mAfterWorkCallback`.
-    CHIP_ERROR mStatus;
+    ValidationContext validContext;
 
-    // If background thread fails to schedule AfterWorkCallback then this flag is set to true
-    // and CASEServer then can check this one and run the AfterWorkCallback for us.
-    //
-    // When this happens, the write to this boolean _must_ be the last code that touches this
-    // object on the background thread.  After that, the Matter thread owns the object.
-    std::atomic<bool> mScheduleAfterWorkFailed{ false };
+    SessionResumptionStorage::ResumptionIdStorage newResumptionId;
 
-public:
-    // Data passed to `mWorkCallback` and `mAfterWorkCallback`.
-    DATA mData;
+    bool hasResponderSessionParams;
+    SessionParameters responderSessionParams;
 };
 
 struct CASESession::SendSigma3Data
@@ -408,6 +236,12 @@ void CASESession::Clear()
 {
     MATTER_TRACE_SCOPE("Clear", "CASESession");
     // Cancel any outstanding work.
+    StopBackgroundWorkWatchdog();
+    if (mHandleSigma2Helper)
+    {
+        mHandleSigma2Helper->CancelWork();
+        mHandleSigma2Helper.reset();
+    }
     if (mSendSigma3Helper)
     {
         mSendSigma3Helper->CancelWork();
@@ -450,10 +284,14 @@ void CASESession::Clear()
     {
         // Set the app state callback object in the Connection state to null
         // to prevent any dangling pointer to memory(mTCPConnCbCtxt) owned
-        // by the CASESession object, that is now getting cleared.
-        mPeerConnState->mAppState = nullptr;
+        // by the CASESession object, that is now getting cleared. The
+        // connection may have been handed to another session since.
+        if (mPeerConnState->mAppState == &mTCPConnCbCtxt)
+        {
+            mPeerConnState->mAppState = nullptr;
+        }
 
-        if (mPeerConnState->mConnectionState != Transport::TCPState::kConnected)
+        if (mPeerConnCreated && (mPeerConnState->mConnectionState != Transport::TCPState::kConnected))
         {
             // Abort the connection if the CASESession is being destroyed and the
             // connection is in the middle of being set up.
@@ -461,6 +299,7 @@ void CASESession::Clear()
             mPeerConnState = nullptr;
         }
     }
+    mPeerConnCreated = false;
 #endif // INET_CONFIG_ENABLE_TCP_ENDPOINT
 }
 
@@ -529,6 +368,8 @@ CASESession::PrepareForSessionEstablishment(SessionManager & sessionManager, Fab
     mSessionResumptionStorage = sessionResumptionStorage;
     mLocalMRPConfig           = MakeOptional(mrpLocalConfig.ValueOr(GetDefaultMRPConfig()));
 
+    mValidContext.mValidationCache = fabricTable->GetCertificateValidationCache();
+
     ChipLogDetail(SecureChannel, "Allocated SecureSession (%p) - waiting for Sigma1 msg",
                   mSecureSessionHolder.Get().Value()->AsSecureSession());
 
@@ -586,6 +427,8 @@ CHIP_ERROR CASESession::EstablishSession(SessionManager & sessionManager, Fabric
     mSessionResumptionStorage = sessionResumptionStorage;
     mLocalMRPConfig           = MakeOptional(mrpLocalConfig.ValueOr(GetDefaultMRPConfig()));
 
+    mValidContext.mValidationCache = fabricTable->GetCertificateValidationCache();
+
     mExchangeCtxt.Value()->UseSuggestedResponseTimeout(kExpectedSigma1ProcessingTime);
     mPeerNodeId  = peerScopedNodeId.GetNodeId();
     mLocalNodeId = fabricInfo->GetNodeId();
@@ -598,6 +441,8 @@ CHIP_ERROR CASESession::EstablishSession(SessionManager & sessionManager, Fabric
 #if INET_CONFIG_ENABLE_TCP_ENDPOINT
         err = sessionManager.TCPConnect(peerAddress, &mTCPConnCbCtxt, &mPeerConnState);
         SuccessOrExit(err);
+        // A reused connection is already established.
+        mPeerConnCreated = !mPeerConnState->IsConnected();
 #endif // INET_CONFIG_ENABLE_TCP_ENDPOINT
     }
     else
@@ -762,9 +607,13 @@ exit:
         // not holding on to a stale ActiveTCPConnectionState. We call
         // TCPDisconnect() here explicitly in order to abort the connection
         // even after it establishes successfully, but SendSigma1() fails for
-        // some reason.
-        caseSession->mSessionManager->TCPDisconnect(conn, /* shouldAbort = */ true);
-        caseSession->mPeerConnState = nullptr;
+        // some reason. A connection reused from established sessions is left
+        // to them, and Clear() takes this session's callbacks off it.
+        if (caseSession->mPeerConnCreated)
+        {
+            caseSession->mSessionManager->TCPDisconnect(conn, /* shouldAbort = */ true);
+            caseSession->mPeerConnState = nullptr;
+        }
 
         caseSession->Clear();
     }
@@ -1470,11 +1319,21 @@ CHIP_ERROR CASESession::HandleSigma2_and_SendSigma3(System::PacketBufferHandle &
 {
     MATTER_TRACE_SCOPE("HandleSigma2_and_SendSigma3", "CASESession");
     CHIP_ERROR err = HandleSigma2(std::move(msg));
-    MATTER_LOG_METRIC_END(kMetricDeviceCASESessionSigma1, err);
-    ReturnErrorOnFailure(err);
+    if (err == CHIP_NO_ERROR && mState == State::kHandleSigma2Pending)
+    {
+        // Sigma2 is being verified on the crypto work queue; HandleSigma2c sends Sigma3.
+        return CHIP_NO_ERROR;
+    }
+    return SendSigma3AfterSigma2(err);
+}
+
+CHIP_ERROR CASESession::SendSigma3AfterSigma2(CHIP_ERROR sigma2Status)
+{
+    MATTER_LOG_METRIC_END(kMetricDeviceCASESessionSigma1, sigma2Status);
+    ReturnErrorOnFailure(sigma2Status);
 
     MATTER_LOG_METRIC_BEGIN(kMetricDeviceCASESessionSigma3);
-    err = SendSigma3a();
+    CHIP_ERROR err = SendSigma3a();
     if (CHIP_NO_ERROR != err)
     {
         MATTER_LOG_METRIC_END(kMetricDeviceCASESessionSigma3, err);
@@ -1499,157 +1358,241 @@ CHIP_ERROR CASESession::HandleSigma2(System::PacketBufferHandle && msg)
     size_t msg_r2_encrypted_len          = 0;
     size_t msg_r2_encrypted_len_with_tag = 0;
 
-    chip::Platform::ScopedMemoryBuffer<uint8_t> msg_R2_Signed;
-    size_t msg_r2_signed_len;
     size_t max_msg_r2_signed_enc_len;
     constexpr size_t kCaseOverheadForFutureTbeData = 128;
 
     AutoReleaseSessionKey sr2k(*mSessionManager->GetSessionKeystore());
 
-    P256ECDSASignature tbsData2Signature;
-
-    NodeId responderNodeId;
-    P256PublicKey responderPublicKey;
-
     uint8_t responderRandom[kSigmaParamRandomNumberSize];
-    ByteSpan responderNOC;
-    ByteSpan responderICAC;
 
     uint16_t responderSessionId;
 
     ChipLogProgress(SecureChannel, "Received Sigma2 msg");
 
-    FabricId fabricId = kUndefinedFabricId;
+    auto helper = WorkHelper<HandleSigma2Data>::Create(*this, &HandleSigma2b, &CASESession::HandleSigma2c);
+    VerifyOrExit(helper, err = CHIP_ERROR_NO_MEMORY);
     {
-        VerifyOrExit(mFabricsTable != nullptr, err = CHIP_ERROR_INCORRECT_STATE);
-        const auto * fabricInfo = mFabricsTable->FindFabricWithIndex(mFabricIndex);
-        VerifyOrExit(fabricInfo != nullptr, err = CHIP_ERROR_INCORRECT_STATE);
-        fabricId = fabricInfo->GetFabricId();
-    }
+        auto & data = helper->mData;
+
+        {
+            VerifyOrExit(mFabricsTable != nullptr, err = CHIP_ERROR_INCORRECT_STATE);
+            const auto * fabricInfo = mFabricsTable->FindFabricWithIndex(mFabricIndex);
+            VerifyOrExit(fabricInfo != nullptr, err = CHIP_ERROR_INCORRECT_STATE);
+            data.fabricId = fabricInfo->GetFabricId();
+        }
 
-    VerifyOrExit(mEphemeralKey != nullptr, err = CHIP_ERROR_INTERNAL);
-    VerifyOrExit(buf != nullptr, err = CHIP_ERROR_MESSAGE_INCOMPLETE);
+        VerifyOrExit(mEphemeralKey != nullptr, err = CHIP_ERROR_INTERNAL);
+        VerifyOrExit(buf != nullptr, err = CHIP_ERROR_MESSAGE_INCOMPLETE);
 
-    tlvReader.Init(std::move(msg));
-    SuccessOrExit(err = tlvReader.Next(containerType, TLV::AnonymousTag()));
-    SuccessOrExit(err = tlvReader.EnterContainer(containerType));
+        tlvReader.Init(std::move(msg));
+        SuccessOrExit(err = tlvReader.Next(containerType, TLV::AnonymousTag()));
+        SuccessOrExit(err = tlvReader.EnterContainer(containerType));
 
-    // Retrieve Responder's Random value
-    SuccessOrExit(err = tlvReader.Next(TLV::kTLVType_ByteString, AsTlvContextTag(Sigma2Tags::kResponderRandom)));
-    SuccessOrExit(err = tlvReader.GetBytes(responderRandom, sizeof(responderRandom)));
+        // Retrieve Responder's Random value
+        SuccessOrExit(err = tlvReader.Next(TLV::kTLVType_ByteString, AsTlvContextTag(Sigma2Tags::kResponderRandom)));
+        SuccessOrExit(err = tlvReader.GetBytes(responderRandom, sizeof(responderRandom)));
 
-    // Assign Session ID
-    SuccessOrExit(err = tlvReader.Next(TLV::kTLVType_UnsignedInteger, AsTlvContextTag(Sigma2Tags::kResponderSessionId)));
-    SuccessOrExit(err = tlvReader.Get(responderSessionId));
+        // Assign Session ID
+        SuccessOrExit(err = tlvReader.Next(TLV::kTLVType_UnsignedInteger, AsTlvContextTag(Sigma2Tags::kResponderSessionId)));
+        SuccessOrExit(err = tlvReader.Get(responderSessionId));
 
-    ChipLogDetail(SecureChannel, "Peer assigned session session ID %d", responderSessionId);
-    SetPeerSessionId(responderSessionId);
+        ChipLogDetail(SecureChannel, "Peer assigned session session ID %d", responderSessionId);
+        SetPeerSessionId(responderSessionId);
 
-    // Retrieve Responder's Ephemeral Pubkey
-    SuccessOrExit(err = tlvReader.Next(TLV::kTLVType_ByteString, AsTlvContextTag(Sigma2Tags::kResponderEphPubKey)));
-    SuccessOrExit(err = tlvReader.GetBytes(mRemotePubKey, static_cast<uint32_t>(mRemotePubKey.Length())));
+        // Retrieve Responder's Ephemeral Pubkey
+        SuccessOrExit(err = tlvReader.Next(TLV::kTLVType_ByteString, AsTlvContextTag(Sigma2Tags::kResponderEphPubKey)));
+        SuccessOrExit(err = tlvReader.GetBytes(mRemotePubKey, static_cast<uint32_t>(mRemotePubKey.Length())));
 
-    // Generate a Shared Secret
-    SuccessOrExit(err = mEphemeralKey->ECDH_derive_secret(mRemotePubKey, mSharedSecret));
+        // Generate a Shared Secret
+        SuccessOrExit(err = mEphemeralKey->ECDH_derive_secret(mRemotePubKey, mSharedSecret));
 
-    // Generate the S2K key
-    {
-        MutableByteSpan saltSpan(msg_salt);
-        SuccessOrExit(err = ConstructSaltSigma2(ByteSpan(responderRandom), mRemotePubKey, ByteSpan(mIPK), saltSpan));
-        SuccessOrExit(err = DeriveSigmaKey(saltSpan, ByteSpan(kKDFSR2Info), sr2k));
-    }
+        // Generate the S2K key
+        {
+            MutableByteSpan saltSpan(msg_salt);
+            SuccessOrExit(err = ConstructSaltSigma2(ByteSpan(responderRandom), mRemotePubKey, ByteSpan(mIPK), saltSpan));
+            SuccessOrExit(err = DeriveSigmaKey(saltSpan, ByteSpan(kKDFSR2Info), sr2k));
+        }
+
+        SuccessOrExit(err = mCommissioningHash.AddData(ByteSpan{ buf, buflen }));
+
+        // Generate decrypted data
+        SuccessOrExit(err = tlvReader.Next(TLV::kTLVType_ByteString, AsTlvContextTag(Sigma2Tags::kEncrypted2)));
+
+        max_msg_r2_signed_enc_len = TLV::EstimateStructOverhead(
+            Credentials::kMaxCHIPCertLength, Credentials::kMaxCHIPCertLength, data.tbsData2Signature.Length(),
+            SessionResumptionStorage::kResumptionIdSize, kCaseOverheadForFutureTbeData);
+        msg_r2_encrypted_len_with_tag = tlvReader.GetLength();
 
-    SuccessOrExit(err = mCommissioningHash.AddData(ByteSpan{ buf, buflen }));
+        // Validate we did not receive a buffer larger than legal
+        VerifyOrExit(msg_r2_encrypted_len_with_tag <= max_msg_r2_signed_enc_len, err = CHIP_ERROR_INVALID_TLV_ELEMENT);
+        VerifyOrExit(msg_r2_encrypted_len_with_tag > CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES, err = CHIP_ERROR_INVALID_TLV_ELEMENT);
+        VerifyOrExit(msg_R2_Encrypted.Alloc(msg_r2_encrypted_len_with_tag), err = CHIP_ERROR_NO_MEMORY);
 
-    // Generate decrypted data
-    SuccessOrExit(err = tlvReader.Next(TLV::kTLVType_ByteString, AsTlvContextTag(Sigma2Tags::kEncrypted2)));
+        SuccessOrExit(err = tlvReader.GetBytes(msg_R2_Encrypted.Get(), static_cast<uint32_t>(msg_r2_encrypted_len_with_tag)));
+        msg_r2_encrypted_len = msg_r2_encrypted_len_with_tag - CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES;
 
-    max_msg_r2_signed_enc_len =
-        TLV::EstimateStructOverhead(Credentials::kMaxCHIPCertLength, Credentials::kMaxCHIPCertLength, tbsData2Signature.Length(),
-                                    SessionResumptionStorage::kResumptionIdSize, kCaseOverheadForFutureTbeData);
-    msg_r2_encrypted_len_with_tag = tlvReader.GetLength();
+        SuccessOrExit(err = AES_CCM_decrypt(msg_R2_Encrypted.Get(), msg_r2_encrypted_len, nullptr, 0,
+                                            msg_R2_Encrypted.Get() + msg_r2_encrypted_len, CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES,
+                                            sr2k.KeyHandle(), kTBEData2_Nonce, kTBEDataNonceLength, msg_R2_Encrypted.Get()));
 
-    // Validate we did not receive a buffer larger than legal
-    VerifyOrExit(msg_r2_encrypted_len_with_tag <= max_msg_r2_signed_enc_len, err = CHIP_ERROR_INVALID_TLV_ELEMENT);
-    VerifyOrExit(msg_r2_encrypted_len_with_tag > CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES, err = CHIP_ERROR_INVALID_TLV_ELEMENT);
-    VerifyOrExit(msg_R2_Encrypted.Alloc(msg_r2_encrypted_len_with_tag), err = CHIP_ERROR_NO_MEMORY);
+        decryptedDataTlvReader.Init(msg_R2_Encrypted.Get(), msg_r2_encrypted_len);
+        containerType = TLV::kTLVType_Structure;
+        SuccessOrExit(err = decryptedDataTlvReader.Next(containerType, TLV::AnonymousTag()));
+        SuccessOrExit(err = decryptedDataTlvReader.EnterContainer(containerType));
 
-    SuccessOrExit(err = tlvReader.GetBytes(msg_R2_Encrypted.Get(), static_cast<uint32_t>(msg_r2_encrypted_len_with_tag)));
-    msg_r2_encrypted_len = msg_r2_encrypted_len_with_tag - CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES;
+        SuccessOrExit(err = decryptedDataTlvReader.Next(TLV::kTLVType_ByteString, AsTlvContextTag(TBEDataTags::kSenderNOC)));
+        SuccessOrExit(err = decryptedDataTlvReader.Get(data.responderNOC));
 
-    SuccessOrExit(err = AES_CCM_decrypt(msg_R2_Encrypted.Get(), msg_r2_encrypted_len, nullptr, 0,
-                                        msg_R2_Encrypted.Get() + msg_r2_encrypted_len, CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES,
-                                        sr2k.KeyHandle(), kTBEData2_Nonce, kTBEDataNonceLength, msg_R2_Encrypted.Get()));
+        SuccessOrExit(err = decryptedDataTlvReader.Next());
+        if (decryptedDataTlvReader.GetTag() == AsTlvContextTag(TBEDataTags::kSenderICAC))
+        {
+            VerifyOrExit(decryptedDataTlvReader.GetType() == TLV::kTLVType_ByteString, err = CHIP_ERROR_WRONG_TLV_TYPE);
+            SuccessOrExit(err = decryptedDataTlvReader.Get(data.responderICAC));
+            SuccessOrExit(err = decryptedDataTlvReader.Next(TLV::kTLVType_ByteString, AsTlvContextTag(TBEDataTags::kSignature)));
+        }
 
-    decryptedDataTlvReader.Init(msg_R2_Encrypted.Get(), msg_r2_encrypted_len);
-    containerType = TLV::kTLVType_Structure;
-    SuccessOrExit(err = decryptedDataTlvReader.Next(containerType, TLV::AnonymousTag()));
-    SuccessOrExit(err = decryptedDataTlvReader.EnterContainer(containerType));
+        // Construct msg_R2_Signed, whose signature is validated in HandleSigma2b
+        data.msg_r2_signed_len = TLV::EstimateStructOverhead(sizeof(uint16_t), data.responderNOC.size(), data.responderICAC.size(),
+                                                             kP256_PublicKey_Length, kP256_PublicKey_Length);
 
-    SuccessOrExit(err = decryptedDataTlvReader.Next(TLV::kTLVType_ByteString, AsTlvContextTag(TBEDataTags::kSenderNOC)));
-    SuccessOrExit(err = decryptedDataTlvReader.Get(responderNOC));
+        VerifyOrExit(data.msg_R2_Signed.Alloc(data.msg_r2_signed_len), err = CHIP_ERROR_NO_MEMORY);
 
-    SuccessOrExit(err = decryptedDataTlvReader.Next());
-    if (decryptedDataTlvReader.GetTag() == AsTlvContextTag(TBEDataTags::kSenderICAC))
-    {
-        VerifyOrExit(decryptedDataTlvReader.GetType() == TLV::kTLVType_ByteString, err = CHIP_ERROR_WRONG_TLV_TYPE);
-        SuccessOrExit(err = decryptedDataTlvReader.Get(responderICAC));
-        SuccessOrExit(err = decryptedDataTlvReader.Next(TLV::kTLVType_ByteString, AsTlvContextTag(TBEDataTags::kSignature)));
+        SuccessOrExit(err = ConstructTBSData(data.responderNOC, data.responderICAC, ByteSpan(mRemotePubKey, mRemotePubKey.Length()),
+                                             ByteSpan(mEphemeralKey->Pubkey(), mEphemeralKey->Pubkey().Length()),
+                                             data.msg_R2_Signed.Get(), data.msg_r2_signed_len));
+
+        VerifyOrExit(decryptedDataTlvReader.GetTag() == AsTlvContextTag(TBEDataTags::kSignature), err = CHIP_ERROR_INVALID_TLV_TAG);
+        VerifyOrExit(data.tbsData2Signature.Capacity() >= decryptedDataTlvReader.GetLength(), err = CHIP_ERROR_INVALID_TLV_ELEMENT);
+        data.tbsData2Signature.SetLength(decryptedDataTlvReader.GetLength());
+        SuccessOrExit(err = decryptedDataTlvReader.GetBytes(data.tbsData2Signature.Bytes(), data.tbsData2Signature.Length()));
+
+        // Retrieve session resumption ID; it is only kept once the responder is verified
+        SuccessOrExit(err = decryptedDataTlvReader.Next(TLV::kTLVType_ByteString, AsTlvContextTag(TBEDataTags::kResumptionID)));
+        SuccessOrExit(err = decryptedDataTlvReader.GetBytes(data.newResumptionId.data(), data.newResumptionId.size()));
+
+        // Retrieve responderMRPParams if present
+        data.hasResponderSessionParams = (tlvReader.Next() != CHIP_END_OF_TLV);
+        if (data.hasResponderSessionParams)
+        {
+            data.responderSessionParams = mRemoteSessionParams;
+            SuccessOrExit(err = DecodeSessionParametersIfPresent(AsTlvContextTag(Sigma2Tags::kResponderSessionParams), tlvReader,
+                                                                 data.responderSessionParams));
+        }
+
+        // Prepare for validating responder identity located in msg_r2_encrypted
+        {
+            MutableByteSpan fabricRCAC{ data.rootCertBuf };
+            SuccessOrExit(err = mFabricsTable->FetchRootCert(mFabricIndex, fabricRCAC));
+            data.fabricRCAC = fabricRCAC;
+            SuccessOrExit(err = SetEffectiveTime());
+        }
+
+        // Copy remaining needed data into work structure
+        {
+            data.validContext = mValidContext;
+            // Verify that responderNodeId (from responderNOC) matches one that was included
+            // in the computation of the Destination Identifier when generating Sigma1.
+            data.expectedResponderNodeId = mPeerNodeId;
+
+            // responderNOC and responderICAC are spans into msg_R2_Encrypted
+            // which is going away, so to save memory, redirect them to their
+            // copies in msg_R2_signed, which is staying around
+            TLV::TLVReader signedDataTlvReader;
+            signedDataTlvReader.Init(data.msg_R2_Signed.Get(), data.msg_r2_signed_len);
+            SuccessOrExit(err = signedDataTlvReader.Next(TLV::kTLVType_Structure, TLV::AnonymousTag()));
+            SuccessOrExit(err = signedDataTlvReader.EnterContainer(containerType));
+
+            SuccessOrExit(err = signedDataTlvReader.Next(TLV::kTLVType_ByteString, AsTlvContextTag(TBSDataTags::kSenderNOC)));
+            SuccessOrExit(err = signedDataTlvReader.Get(data.responderNOC));
+
+            if (!data.responderICAC.empty())
+            {
+                SuccessOrExit(err = signedDataTlvReader.Next(TLV::kTLVType_ByteString, AsTlvContextTag(TBSDataTags::kSenderICAC)));
+                SuccessOrExit(err = signedDataTlvReader.Get(data.responderICAC));
+            }
+        }
+
+        if (mCryptoWorkQueue != nullptr)
+        {
+            SuccessOrExit(err = helper->ScheduleWork(*mCryptoWorkQueue));
+            mHandleSigma2Helper = helper;
+            mExchangeCtxt.Value()->WillSendMessage();
+            mState = State::kHandleSigma2Pending;
+            StartBackgroundWorkWatchdog();
+        }
+        else
+        {
+            SuccessOrExit(err = helper->DoWork());
+        }
     }
 
-    // Validate responder identity located in msg_r2_encrypted
-    // Constructing responder identity
+exit:
+    if (err != CHIP_NO_ERROR)
     {
-        CompressedFabricId unused;
-        FabricId responderFabricId;
-        SuccessOrExit(err = SetEffectiveTime());
-        SuccessOrExit(err = mFabricsTable->VerifyCredentials(mFabricIndex, responderNOC, responderICAC, mValidContext, unused,
-                                                             responderFabricId, responderNodeId, responderPublicKey));
-        VerifyOrExit(fabricId == responderFabricId, err = CHIP_ERROR_INVALID_CASE_PARAMETER);
-        // Verify that responderNodeId (from responderNOC) matches one that was included
-        // in the computation of the Destination Identifier when generating Sigma1.
-        VerifyOrExit(mPeerNodeId == responderNodeId, err = CHIP_ERROR_INVALID_CASE_PARAMETER);
+        SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
     }
+    return err;
+}
 
-    // Construct msg_R2_Signed and validate the signature in msg_r2_encrypted
-    msg_r2_signed_len = TLV::EstimateStructOverhead(sizeof(uint16_t), responderNOC.size(), responderICAC.size(),
-                                                    kP256_PublicKey_Length, kP256_PublicKey_Length);
+CHIP_ERROR CASESession::HandleSigma2b(HandleSigma2Data & data, bool & cancel)
+{
+    // Validate responder identity located in msg_r2_encrypted
+    CompressedFabricId unused;
+    FabricId responderFabricId;
+    NodeId responderNodeId;
+    P256PublicKey responderPublicKey;
+    ReturnErrorOnFailure(FabricTable::VerifyCredentials(data.responderNOC, data.responderICAC, data.fabricRCAC, data.validContext,
+                                                        unused, responderFabricId, responderNodeId, responderPublicKey));
+    VerifyOrReturnError(data.fabricId == responderFabricId, CHIP_ERROR_INVALID_CASE_PARAMETER);
+    VerifyOrReturnError(data.expectedResponderNodeId == responderNodeId, CHIP_ERROR_INVALID_CASE_PARAMETER);
+
+    // Validate signature
+    ReturnErrorOnFailure(
+        responderPublicKey.ECDSA_validate_msg_signature(data.msg_R2_Signed.Get(), data.msg_r2_signed_len, data.tbsData2Signature));
 
-    VerifyOrExit(msg_R2_Signed.Alloc(msg_r2_signed_len), err = CHIP_ERROR_NO_MEMORY);
+    return CHIP_NO_ERROR;
+}
 
-    SuccessOrExit(err = ConstructTBSData(responderNOC, responderICAC, ByteSpan(mRemotePubKey, mRemotePubKey.Length()),
-                                         ByteSpan(mEphemeralKey->Pubkey(), mEphemeralKey->Pubkey().Length()), msg_R2_Signed.Get(),
-                                         msg_r2_signed_len));
+CHIP_ERROR CASESession::HandleSigma2c(HandleSigma2Data & data, CHIP_ERROR status)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
 
-    VerifyOrExit(decryptedDataTlvReader.GetTag() == AsTlvContextTag(TBEDataTags::kSignature), err = CHIP_ERROR_INVALID_TLV_TAG);
-    VerifyOrExit(tbsData2Signature.Capacity() >= decryptedDataTlvReader.GetLength(), err = CHIP_ERROR_INVALID_TLV_ELEMENT);
-    tbsData2Signature.SetLength(decryptedDataTlvReader.GetLength());
-    SuccessOrExit(err = decryptedDataTlvReader.GetBytes(tbsData2Signature.Bytes(), tbsData2Signature.Length()));
+    // In the synchronous case, HandleSigma2 reports errors and HandleSigma2_and_SendSigma3 goes on to Sigma3.
+    const bool inBackground = (mState == State::kHandleSigma2Pending);
 
-    // Validate signature
-    SuccessOrExit(err = responderPublicKey.ECDSA_validate_msg_signature(msg_R2_Signed.Get(), msg_r2_signed_len, tbsData2Signature));
+    SuccessOrExit(err = status);
 
-    // Retrieve session resumption ID
-    SuccessOrExit(err = decryptedDataTlvReader.Next(TLV::kTLVType_ByteString, AsTlvContextTag(TBEDataTags::kResumptionID)));
-    SuccessOrExit(err = decryptedDataTlvReader.GetBytes(mNewResumptionId.data(), mNewResumptionId.size()));
+    mNewResumptionId = data.newResumptionId;
 
     // Retrieve peer CASE Authenticated Tags (CATs) from peer's NOC.
-    SuccessOrExit(err = ExtractCATsFromOpCert(responderNOC, mPeerCATs));
+    SuccessOrExit(err = ExtractCATsFromOpCert(data.responderNOC, mPeerCATs));
 
-    // Retrieve responderMRPParams if present
-    if (tlvReader.Next() != CHIP_END_OF_TLV)
+    if (data.hasResponderSessionParams)
     {
-        SuccessOrExit(err = DecodeSessionParametersIfPresent(AsTlvContextTag(Sigma2Tags::kResponderSessionParams), tlvReader,
-                                                             mRemoteSessionParams));
+        mRemoteSessionParams = data.responderSessionParams;
         mExchangeCtxt.Value()->GetSessionHandle()->AsUnauthenticatedSession()->SetRemoteSessionParameters(
             GetRemoteSessionParameters());
     }
 
 exit:
-    if (err != CHIP_NO_ERROR)
+    mHandleSigma2Helper.reset();
+
+    if (inBackground)
     {
-        SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
+        if (err != CHIP_NO_ERROR)
+        {
+            SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
+        }
+        err = SendSigma3AfterSigma2(err);
+        if (err != CHIP_NO_ERROR)
+        {
+            // Abort the pending establish, which is normally done by CASESession::OnMessageReceived,
+            // but in the background processing case must be done here.
+            DiscardExchange();
+            AbortPendingEstablish(err);
+        }
     }
+
     return err;
 }
 
@@ -1709,10 +1652,11 @@ CHIP_ERROR CASESession::SendSigma3a()
 
         if (data.keystore != nullptr)
         {
-            SuccessOrExit(err = helper->ScheduleWork());
+            SuccessOrExit(err = helper->ScheduleWork(GetCryptoWorkQueue()));
             mSendSigma3Helper = helper;
             mExchangeCtxt.Value()->WillSendMessage();
             mState = State::kSendSigma3Pending;
+            StartBackgroundWorkWatchdog();
         }
         else
         {
@@ -2003,10 +1947,11 @@ CHIP_ERROR CASESession::HandleSigma3a(System::PacketBufferHandle && msg)
             }
         }
 
-        SuccessOrExit(err = helper->ScheduleWork());
+        SuccessOrExit(err = helper->ScheduleWork(GetCryptoWorkQueue()));
         mHandleSigma3Helper = helper;
         mExchangeCtxt.Value()->WillSendMessage();
         mState = State::kHandleSigma3Pending;
+        StartBackgroundWorkWatchdog();
     }
 
 exit:
@@ -2092,6 +2037,15 @@ exit:
     return err;
 }
 
+CryptoWorkQueue & CASESession::GetCryptoWorkQueue()
+{
+    if (mCryptoWorkQueue != nullptr)
+    {
+        return *mCryptoWorkQueue;
+    }
+    return PlatformCryptoWorkQueue::Instance();
+}
+
 CHIP_ERROR CASESession::DeriveSigmaKey(const ByteSpan & salt, const ByteSpan & info, AutoReleaseSessionKey & key) const
 {
     return mSessionManager->GetSessionKeystore()->DeriveKey(mSharedSecret, salt, info, key.KeyHandle());
@@ -2579,23 +2533,63 @@ System::Clock::Timeout CASESession::ComputeSigma2ResponseTimeout(const ReliableM
 
 bool CASESession::InvokeBackgroundWorkWatchdog()
 {
-    bool watchdogFired = false;
+    // At most one piece of work is outstanding.  Return as soon as its after work callback has run: that callback may
+    // end the handshake, and the delegate may release this session when it is told.
+    if (mHandleSigma2Helper && mHandleSigma2Helper->UnableToScheduleAfterWorkCallback())
+    {
+        ChipLogError(SecureChannel, "HandleSigma2Helper was unable to schedule the AfterWorkCallback");
+        mHandleSigma2Helper->DoAfterWork();
+        return true;
+    }
 
     if (mSendSigma3Helper && mSendSigma3Helper->UnableToScheduleAfterWorkCallback())
     {
         ChipLogError(SecureChannel, "SendSigma3Helper was unable to schedule the AfterWorkCallback");
         mSendSigma3Helper->DoAfterWork();
-        watchdogFired = true;
+        return true;
     }
 
     if (mHandleSigma3Helper && mHandleSigma3Helper->UnableToScheduleAfterWorkCallback())
     {
         ChipLogError(SecureChannel, "HandleSigma3Helper was unable to schedule the AfterWorkCallback");
         mHandleSigma3Helper->DoAfterWork();
-        watchdogFired = true;
+        return true;
+    }
+
+    return false;
+}
+
+void CASESession::StartBackgroundWorkWatchdog()
+{
+    VerifyOrReturn(mHandleSigma2Helper || mSendSigma3Helper || mHandleSigma3Helper);
+    VerifyOrReturn(mSessionManager != nullptr && mSessionManager->SystemLayer() != nullptr);
+
+    mBackgroundWorkWatchdogLayer = mSessionManager->SystemLayer();
+    LogErrorOnFailure(
+        mBackgroundWorkWatchdogLayer->StartTimer(kBackgroundWorkWatchdogInterval, OnBackgroundWorkWatchdogTimer, this));
+}
+
+void CASESession::StopBackgroundWorkWatchdog()
+{
+    VerifyOrReturn(mBackgroundWorkWatchdogLayer != nullptr);
+    mBackgroundWorkWatchdogLayer->CancelTimer(OnBackgroundWorkWatchdogTimer, this);
+    mBackgroundWorkWatchdogLayer = nullptr;
+}
+
+void CASESession::OnBackgroundWorkWatchdogTimer(System::Layer * layer, void * appState)
+{
+    auto * session                        = static_cast<CASESession *>(appState);
+    session->mBackgroundWorkWatchdogLayer = nullptr;
+
+    // Nothing but this timer notices a lost after work callback on the initiator, which has no CASEServer to
+    // run the watchdog when the next Sigma1 arrives.
+    if (session->InvokeBackgroundWorkWatchdog())
+    {
+        return;
     }
 
-    return watchdogFired;
+    // Either the work is still running, or it has completed and there is nothing left to watch.
+    session->StartBackgroundWorkWatchdog();
 }
 
 // Helper function to map CASESession::State to SessionEstablishmentStage
@@ -2611,6 +2605,7 @@ SessionEstablishmentStage CASESession::MapCASEStateToSessionEstablishmentStage(S
     case State::kSentSigma2:
     case State::kSentSigma2Resume:
         return SessionEstablishmentStage::kSentSigma2;
+    case State::kHandleSigma2Pending:
     case State::kSendSigma3Pending:
         return SessionEstablishmentStage::kReceivedSigma2;
     case State::kSentSigma3:
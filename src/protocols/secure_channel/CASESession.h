@@ -39,6 +39,8 @@
 #include <messaging/ReliableMessageProtocolConfig.h>
 #include <protocols/secure_channel/CASEDestinationId.h>
 #include <protocols/secure_channel/Constants.h>
+#include <protocols/secure_channel/CryptoWorkHelper.h>
+#include <protocols/secure_channel/CryptoWorkQueue.h>
 #include <protocols/secure_channel/PairingSession.h>
 #include <protocols/secure_channel/SessionEstablishmentExchangeDispatch.h>
 #include <protocols/secure_channel/SessionResumptionStorage.h>
@@ -118,6 +120,18 @@ public:
      */
     void SetGroupDataProvider(Credentials::GroupDataProvider * groupDataProvider) { mGroupDataProvider = groupDataProvider; }
 
+    /**
+     * @brief Set the queue used for the expensive parts of the handshake: certificate chain validation and
+     *        signature checks of Sigma2 and Sigma3, and Sigma3 signing when the keystore allows it.
+     *
+     *        The ephemeral key generation and ECDH of each side, and the responder's Sigma2 signature, stay on the
+     *        Matter thread: they use session-owned keys or the FabricTable, and cost well under the verification.
+     *
+     * @param queue - Queue to use, or nullptr for the platform background queue.  Without a queue, Sigma2 is
+     *                verified synchronously on the Matter thread.
+     */
+    void SetCryptoWorkQueue(CryptoWorkQueue * queue) { mCryptoWorkQueue = queue; }
+
     /**
      * @brief
      *   Derive a secure session from the established session. The API will return error if called before session is established.
@@ -182,12 +196,17 @@ public:
         kFinishedViaResume   = 7,
         kSendSigma3Pending   = 8,
         kHandleSigma3Pending = 9,
+        kHandleSigma2Pending = 10,
     };
 
     State GetState() { return mState; }
 
     // Returns true if the CASE session handshake was stuck due to failing to schedule work on the Matter thread.
-    // If this function returns true, the CASE session has been reset and is ready for a new session establishment.
+    // If this function returns true, the stuck step has been completed or the CASE session has been reset; the
+    // delegate may have released the session, so the caller must not touch it unless it owns it.
+    //
+    // Besides CASEServer, which calls this when a Sigma1 arrives during a handshake, the session runs it from a
+    // timer while background work is outstanding.
     bool InvokeBackgroundWorkWatchdog();
 
 protected:
@@ -340,7 +359,12 @@ private:
     CHIP_ERROR SendSigma2Resume(System::PacketBufferHandle && msg_R2_resume);
 
     CHIP_ERROR HandleSigma2_and_SendSigma3(System::PacketBufferHandle && msg);
+    CHIP_ERROR SendSigma3AfterSigma2(CHIP_ERROR sigma2Status);
+
+    struct HandleSigma2Data;
     CHIP_ERROR HandleSigma2(System::PacketBufferHandle && msg);
+    static CHIP_ERROR HandleSigma2b(HandleSigma2Data & data, bool & cancel);
+    CHIP_ERROR HandleSigma2c(HandleSigma2Data & data, CHIP_ERROR status);
     CHIP_ERROR HandleSigma2Resume(System::PacketBufferHandle && msg);
 
     struct SendSigma3Data;
@@ -399,6 +423,10 @@ private:
     //
     // This pointer must be nulled out when the connection is closed.
     Transport::ActiveTCPConnectionState * mPeerConnState = nullptr;
+
+    // Whether TCPConnect() opened mPeerConnState for this session. A reused
+    // connection may carry established sessions, so it is never aborted here.
+    bool mPeerConnCreated = false;
 #endif // INET_CONFIG_ENABLE_TCP_ENDPOINT
 
 #if CONFIG_BUILD_FOR_HOST_UNIT_TEST
@@ -430,9 +458,18 @@ private:
     uint8_t mInitiatorRandom[kSigmaParamRandomNumberSize];
 
     template <class DATA>
-    class WorkHelper;
+    using WorkHelper = CryptoWorkHelper<CASESession, DATA>;
+    CryptoWorkQueue & GetCryptoWorkQueue();
+
+    Platform::SharedPtr<WorkHelper<HandleSigma2Data>> mHandleSigma2Helper;
     Platform::SharedPtr<WorkHelper<SendSigma3Data>> mSendSigma3Helper;
     Platform::SharedPtr<WorkHelper<HandleSigma3Data>> mHandleSigma3Helper;
+    CryptoWorkQueue * mCryptoWorkQueue = nullptr;
+
+    void StartBackgroundWorkWatchdog();
+    void StopBackgroundWorkWatchdog();
+    static void OnBackgroundWorkWatchdogTimer(System::Layer * layer, void * appState);
+    System::Layer * mBackgroundWorkWatchdogLayer = nullptr;
 
     State mState;
 
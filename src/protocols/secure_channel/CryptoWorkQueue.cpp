@@ -0,0 +1,144 @@
+/*
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <protocols/secure_channel/CryptoWorkQueue.h>
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <platform/PlatformManager.h>
+
+#include <algorithm>
+
+namespace chip {
+
+PlatformCryptoWorkQueue & PlatformCryptoWorkQueue::Instance()
+{
+    static PlatformCryptoWorkQueue sInstance;
+    return sInstance;
+}
+
+CHIP_ERROR PlatformCryptoWorkQueue::ScheduleWork(WorkFunct work, intptr_t arg)
+{
+    return DeviceLayer::PlatformMgr().ScheduleBackgroundWork(work, arg);
+}
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+CHIP_ERROR CryptoWorkerPool::Init(size_t threadCount, size_t queueDepth)
+{
+    VerifyOrReturnError(threadCount > 0 && threadCount <= kMaxThreads, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(queueDepth > 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(mThreadCount == 0, CHIP_ERROR_INCORRECT_STATE);
+
+    mQueue = static_cast<WorkItem *>(Platform::MemoryCalloc(queueDepth, sizeof(WorkItem)));
+    VerifyOrReturnError(mQueue != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    mQueueDepth   = queueDepth;
+    mQueueHead    = 0;
+    mQueueLength  = 0;
+    mShuttingDown = false;
+    mStats        = Stats();
+
+    for (mThreadCount = 0; mThreadCount < threadCount; ++mThreadCount)
+    {
+        mThreads[mThreadCount] = std::thread(&CryptoWorkerPool::WorkerMain, this);
+    }
+
+    ChipLogProgress(SecureChannel, "Crypto worker pool started with %u threads", static_cast<unsigned>(mThreadCount));
+    return CHIP_NO_ERROR;
+}
+
+void CryptoWorkerPool::Shutdown()
+{
+    VerifyOrReturn(mThreadCount > 0);
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mShuttingDown = true;
+    }
+    mWorkAvailable.notify_all();
+
+    for (size_t i = 0; i < mThreadCount; ++i)
+    {
+        mThreads[i].join();
+    }
+    mThreadCount = 0;
+
+    Platform::MemoryFree(mQueue);
+    mQueue      = nullptr;
+    mQueueDepth = 0;
+}
+
+CHIP_ERROR CryptoWorkerPool::ScheduleWork(WorkFunct work, intptr_t arg)
+{
+    VerifyOrReturnError(work != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        VerifyOrReturnError(mQueue != nullptr && !mShuttingDown, CHIP_ERROR_INCORRECT_STATE);
+        if (mQueueLength == mQueueDepth)
+        {
+            mStats.rejected++;
+            return CHIP_ERROR_NO_MEMORY;
+        }
+
+        mQueue[(mQueueHead + mQueueLength) % mQueueDepth] = WorkItem{ work, arg };
+        mQueueLength++;
+        mStats.queueDepth     = static_cast<uint32_t>(mQueueLength);
+        mStats.peakQueueDepth = std::max(mStats.peakQueueDepth, mStats.queueDepth);
+    }
+    mWorkAvailable.notify_one();
+
+    return CHIP_NO_ERROR;
+}
+
+CryptoWorkerPool::Stats CryptoWorkerPool::GetStats()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    return mStats;
+}
+
+void CryptoWorkerPool::WorkerMain()
+{
+    std::unique_lock<std::mutex> lock(mLock);
+    while (true)
+    {
+        mWorkAvailable.wait(lock, [this] { return mQueueLength > 0 || mShuttingDown; });
+
+        // Keep draining during shutdown: queued work holds references that only running it releases.
+        if (mQueueLength == 0)
+        {
+            return;
+        }
+
+        WorkItem item = mQueue[mQueueHead];
+        mQueueHead    = (mQueueHead + 1) % mQueueDepth;
+        mQueueLength--;
+        mStats.queueDepth = static_cast<uint32_t>(mQueueLength);
+
+        lock.unlock();
+        item.work(item.arg);
+        lock.lock();
+
+        mStats.completed++;
+    }
+}
+
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+} // namespace chip
@@ -0,0 +1,137 @@
+/*
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @file
+ *   Where session establishment runs its expensive crypto (certificate chain validation, ECDSA signing and
+ *   verification) when it does not run it inline on the Matter thread.
+ *
+ *   PlatformCryptoWorkQueue hands work to PlatformManager::ScheduleBackgroundWork, which is what CASESession has
+ *   always used; on platforms without a background event loop that work still ends up on the Matter thread.
+ *   CryptoWorkerPool runs work on its own worker threads, so that a controller establishing many sessions at
+ *   once keeps processing reports and other messages while signatures are checked.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <system/SystemConfig.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+namespace chip {
+
+class CryptoWorkQueue
+{
+public:
+    using WorkFunct = void (*)(intptr_t arg);
+
+    virtual ~CryptoWorkQueue() = default;
+
+    /**
+     * Run `work(arg)` at some later point, typically on a thread other than the Matter thread.  The work must not
+     * touch Matter stack state; it hands its result back with PlatformManager::ScheduleWork.
+     *
+     * @retval CHIP_ERROR_NO_MEMORY if the queue is full.
+     * @retval CHIP_ERROR_INCORRECT_STATE if the queue is not running.
+     */
+    virtual CHIP_ERROR ScheduleWork(WorkFunct work, intptr_t arg) = 0;
+};
+
+/**
+ * Runs work on the platform's background event loop, or on the Matter thread if the platform has none.
+ */
+class PlatformCryptoWorkQueue : public CryptoWorkQueue
+{
+public:
+    static PlatformCryptoWorkQueue & Instance();
+
+    CHIP_ERROR ScheduleWork(WorkFunct work, intptr_t arg) override;
+};
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+/**
+ * A fixed set of worker threads draining one bounded FIFO of work.
+ */
+class CryptoWorkerPool : public CryptoWorkQueue
+{
+public:
+    static constexpr size_t kMaxThreads = 16;
+
+    struct Stats
+    {
+        uint32_t queueDepth     = 0; // Work items waiting for a worker.
+        uint32_t peakQueueDepth = 0;
+        uint32_t completed      = 0; // Work items run since Init.
+        uint32_t rejected       = 0; // ScheduleWork calls refused because the queue was full.
+    };
+
+    CryptoWorkerPool() = default;
+    ~CryptoWorkerPool() override { Shutdown(); }
+
+    CryptoWorkerPool(const CryptoWorkerPool &)             = delete;
+    CryptoWorkerPool & operator=(const CryptoWorkerPool &) = delete;
+
+    /**
+     * Start `threadCount` workers sharing a queue of at most `queueDepth` pending items.
+     */
+    CHIP_ERROR Init(size_t threadCount, size_t queueDepth);
+
+    /**
+     * Run every item still queued, then stop and join the workers.  Must not be called from a worker.
+     */
+    void Shutdown();
+
+    CHIP_ERROR ScheduleWork(WorkFunct work, intptr_t arg) override;
+
+    Stats GetStats();
+
+private:
+    struct WorkItem
+    {
+        WorkFunct work;
+        intptr_t arg;
+    };
+
+    void WorkerMain();
+
+    std::mutex mLock;
+    std::condition_variable mWorkAvailable;
+
+    std::thread mThreads[kMaxThreads];
+    size_t mThreadCount = 0;
+
+    // Ring buffer of pending work, protected by mLock.
+    WorkItem * mQueue   = nullptr;
+    size_t mQueueDepth  = 0;
+    size_t mQueueHead   = 0;
+    size_t mQueueLength = 0;
+    bool mShuttingDown  = false;
+    Stats mStats;
+};
+
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+} // namespace chip
@@ -0,0 +1,648 @@
+/*
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <protocols/secure_channel/IndexedSessionResumptionStorage.h>
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/DefaultStorageKeyAllocator.h>
+#include <lib/support/SafeInt.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <string.h>
+
+namespace chip {
+
+constexpr TLV::Tag IndexedSessionResumptionStorage::kSlotTag;
+constexpr TLV::Tag IndexedSessionResumptionStorage::kFabricIndexTag;
+constexpr TLV::Tag IndexedSessionResumptionStorage::kPeerNodeIdTag;
+
+namespace {
+
+// splitmix64 finalizer; spreads sequential node ids across the table.
+uint64_t Mix(uint64_t value)
+{
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+} // namespace
+
+CHIP_ERROR IndexedSessionResumptionStorage::Init(PersistentStorageDelegate * storage, uint32_t capacity)
+{
+    VerifyOrReturnError(storage != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(capacity > 0 && capacity <= UINT16_MAX * static_cast<uint32_t>(kSlotsPerIndexPage),
+                        CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(mStorage == nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    // Keep the hash tables at most half full so probe sequences stay short.
+    uint32_t bucketCount = 1;
+    while (bucketCount < 2 * capacity)
+    {
+        bucketCount <<= 1;
+    }
+
+    mEntries.Alloc(capacity);
+    mNodeBuckets.Alloc(bucketCount);
+    mResumptionIdBuckets.Alloc(bucketCount);
+    if (mEntries.Get() == nullptr || mNodeBuckets.Get() == nullptr || mResumptionIdBuckets.Get() == nullptr)
+    {
+        Shutdown();
+        return CHIP_ERROR_NO_MEMORY;
+    }
+
+    for (uint32_t i = 0; i < bucketCount; ++i)
+    {
+        mNodeBuckets[i]         = kNoSlot;
+        mResumptionIdBuckets[i] = kNoSlot;
+    }
+
+    // Chain every slot into the free list, lowest slot first.
+    for (uint32_t slot = 0; slot < capacity; ++slot)
+    {
+        mEntries[slot].mLruNext = (slot + 1 < capacity) ? slot + 1 : kNoSlot;
+    }
+
+    mStorage    = storage;
+    mBucketMask = bucketCount - 1;
+    mCapacity   = capacity;
+    mCount      = 0;
+    mLruHead    = kNoSlot;
+    mLruTail    = kNoSlot;
+    mFreeHead   = 0;
+    ReturnErrorOnFailure(mStateStore.Init(storage));
+
+    for (uint16_t page = 0; page < PageCount(); ++page)
+    {
+        CHIP_ERROR err = LoadIndexPage(page);
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(SecureChannel, "Unable to load session resumption index page %u: %" CHIP_ERROR_FORMAT, page, err.Format());
+        }
+    }
+
+    CHIP_ERROR err = DeletePagesBeyondCapacity();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(SecureChannel, "Unable to delete session resumption entries beyond capacity: %" CHIP_ERROR_FORMAT,
+                     err.Format());
+    }
+
+    err = MigrateLegacyIndex();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(SecureChannel, "Unable to migrate session resumption index: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+
+    ChipLogProgress(SecureChannel, "Loaded %" PRIu32 " session resumption entries (capacity %" PRIu32 ")", mCount, mCapacity);
+    return CHIP_NO_ERROR;
+}
+
+void IndexedSessionResumptionStorage::Shutdown()
+{
+    if (mEntries.Get() != nullptr)
+    {
+        for (uint32_t slot = 0; slot < mCapacity; ++slot)
+        {
+            Crypto::ClearSecretData(mEntries[slot].mSharedSecret);
+        }
+    }
+
+    mEntries.Free();
+    mNodeBuckets.Free();
+    mResumptionIdBuckets.Free();
+    mStorage    = nullptr;
+    mBucketMask = 0;
+    mCapacity   = 0;
+    mCount      = 0;
+    mLruHead    = kNoSlot;
+    mLruTail    = kNoSlot;
+    mFreeHead   = kNoSlot;
+}
+
+CHIP_ERROR IndexedSessionResumptionStorage::FindByScopedNodeId(const ScopedNodeId & node, ResumptionIdStorage & resumptionId,
+                                                               Crypto::P256ECDHDerivedSecret & sharedSecret, CATValues & peerCATs)
+{
+    VerifyOrReturnError(mStorage != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    uint32_t slot = FindSlot(node);
+    VerifyOrReturnError(slot != kNoSlot, CHIP_ERROR_KEY_NOT_FOUND);
+
+    const Entry & entry = mEntries[slot];
+    resumptionId        = entry.mResumptionId;
+    ReturnErrorOnFailure(sharedSecret.SetLength(entry.mSharedSecretLength));
+    memcpy(sharedSecret.Bytes(), entry.mSharedSecret, entry.mSharedSecretLength);
+    peerCATs = entry.mPeerCATs;
+
+    Touch(slot);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR IndexedSessionResumptionStorage::FindByResumptionId(ConstResumptionIdView resumptionId, ScopedNodeId & node,
+                                                               Crypto::P256ECDHDerivedSecret & sharedSecret, CATValues & peerCATs)
+{
+    VerifyOrReturnError(mStorage != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    uint32_t slot = FindSlot(resumptionId);
+    VerifyOrReturnError(slot != kNoSlot, CHIP_ERROR_KEY_NOT_FOUND);
+
+    const Entry & entry = mEntries[slot];
+    node                = entry.mNode;
+    ReturnErrorOnFailure(sharedSecret.SetLength(entry.mSharedSecretLength));
+    memcpy(sharedSecret.Bytes(), entry.mSharedSecret, entry.mSharedSecretLength);
+    peerCATs = entry.mPeerCATs;
+
+    Touch(slot);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR IndexedSessionResumptionStorage::Save(const ScopedNodeId & node, ConstResumptionIdView resumptionId,
+                                                 const Crypto::P256ECDHDerivedSecret & sharedSecret, const CATValues & peerCATs)
+{
+    VerifyOrReturnError(mStorage != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(sharedSecret.Length() <= sizeof(Entry::mSharedSecret), CHIP_ERROR_INVALID_ARGUMENT);
+
+    ReturnErrorOnFailure(mStateStore.SaveState(node, resumptionId, sharedSecret, peerCATs));
+
+    uint32_t slot = FindSlot(node);
+    if (slot != kNoSlot)
+    {
+        // Known node: the index page already names it, only the resumption id key changes.
+        RemoveFromIndex(IndexKind::kByResumptionId, slot);
+        Fill(slot, node, resumptionId, sharedSecret, peerCATs);
+        InsertIntoIndex(IndexKind::kByResumptionId, slot);
+        Touch(slot);
+        return CHIP_NO_ERROR;
+    }
+
+    if (mCount == mCapacity)
+    {
+        const uint32_t victim         = mLruTail;
+        const ScopedNodeId victimNode = mEntries[victim].mNode;
+        ChipLogDetail(SecureChannel, "Evicting session resumption entry for node " ChipLogFormatX64,
+                      ChipLogValueX64(victimNode.GetNodeId()));
+
+        ReleaseSlot(victim);
+        CHIP_ERROR err = mStateStore.DeleteState(victimNode);
+        if (err != CHIP_NO_ERROR && err != CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+        {
+            ChipLogError(SecureChannel, "Unable to delete evicted session resumption state: %" CHIP_ERROR_FORMAT, err.Format());
+        }
+    }
+
+    slot = AllocateSlot();
+    VerifyOrDie(slot != kNoSlot);
+    Fill(slot, node, resumptionId, sharedSecret, peerCATs);
+    InsertIntoIndex(IndexKind::kByNode, slot);
+    InsertIntoIndex(IndexKind::kByResumptionId, slot);
+    LinkMostRecent(slot);
+
+    return SaveIndexPage(static_cast<uint16_t>(slot / kSlotsPerIndexPage));
+}
+
+CHIP_ERROR IndexedSessionResumptionStorage::Delete(const ScopedNodeId & node)
+{
+    VerifyOrReturnError(mStorage != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    uint32_t slot = FindSlot(node);
+    VerifyOrReturnError(slot != kNoSlot, CHIP_ERROR_KEY_NOT_FOUND);
+
+    return RemoveSlot(slot);
+}
+
+CHIP_ERROR IndexedSessionResumptionStorage::DeleteAll(FabricIndex fabricIndex)
+{
+    VerifyOrReturnError(mStorage != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    CHIP_ERROR stickyErr = CHIP_NO_ERROR;
+    for (uint16_t page = 0; page < PageCount(); ++page)
+    {
+        bool dirty           = false;
+        const uint32_t first = static_cast<uint32_t>(page) * kSlotsPerIndexPage;
+        for (uint32_t slot = first; slot < first + kSlotsPerIndexPage && slot < mCapacity; ++slot)
+        {
+            if (!mEntries[slot].mInUse || mEntries[slot].mNode.GetFabricIndex() != fabricIndex)
+            {
+                continue;
+            }
+
+            const ScopedNodeId node = mEntries[slot].mNode;
+            ReleaseSlot(slot);
+            dirty = true;
+
+            CHIP_ERROR err = mStateStore.DeleteState(node);
+            if (err != CHIP_NO_ERROR && err != CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+            {
+                ChipLogError(SecureChannel,
+                             "Session resumption cache deletion partially failed for fabric index %u, "
+                             "unable to delete node state: %" CHIP_ERROR_FORMAT,
+                             fabricIndex, err.Format());
+                stickyErr = (stickyErr == CHIP_NO_ERROR) ? err : stickyErr;
+            }
+        }
+
+        if (dirty)
+        {
+            CHIP_ERROR err = SaveIndexPage(page);
+            stickyErr      = (stickyErr == CHIP_NO_ERROR) ? err : stickyErr;
+        }
+    }
+    return stickyErr;
+}
+
+uint64_t IndexedSessionResumptionStorage::Hash(const ScopedNodeId & node)
+{
+    return Mix(node.GetNodeId() ^ (static_cast<uint64_t>(node.GetFabricIndex()) << 56));
+}
+
+uint64_t IndexedSessionResumptionStorage::Hash(ConstResumptionIdView resumptionId)
+{
+    // Resumption ids are random, but mix anyway so a poor DRBG cannot cluster the table.
+    uint64_t value;
+    memcpy(&value, resumptionId.data(), sizeof(value));
+    return Mix(value);
+}
+
+uint64_t IndexedSessionResumptionStorage::HashOfSlot(IndexKind kind, uint32_t slot) const
+{
+    const Entry & entry = mEntries[slot];
+    return (kind == IndexKind::kByNode) ? Hash(entry.mNode) : Hash(ConstResumptionIdView(entry.mResumptionId));
+}
+
+uint32_t IndexedSessionResumptionStorage::FindSlot(const ScopedNodeId & node)
+{
+    const uint32_t * buckets = mNodeBuckets.Get();
+    for (uint32_t bucket = static_cast<uint32_t>(Hash(node)) & mBucketMask; buckets[bucket] != kNoSlot;
+         bucket          = (bucket + 1) & mBucketMask)
+    {
+        if (mEntries[buckets[bucket]].mNode == node)
+        {
+            return buckets[bucket];
+        }
+    }
+    return kNoSlot;
+}
+
+uint32_t IndexedSessionResumptionStorage::FindSlot(ConstResumptionIdView resumptionId)
+{
+    const uint32_t * buckets = mResumptionIdBuckets.Get();
+    for (uint32_t bucket = static_cast<uint32_t>(Hash(resumptionId)) & mBucketMask; buckets[bucket] != kNoSlot;
+         bucket          = (bucket + 1) & mBucketMask)
+    {
+        const ResumptionIdStorage & candidate = mEntries[buckets[bucket]].mResumptionId;
+        if (memcmp(candidate.data(), resumptionId.data(), kResumptionIdSize) == 0)
+        {
+            return buckets[bucket];
+        }
+    }
+    return kNoSlot;
+}
+
+void IndexedSessionResumptionStorage::InsertIntoIndex(IndexKind kind, uint32_t slot)
+{
+    uint32_t * buckets = Buckets(kind);
+    uint32_t bucket    = static_cast<uint32_t>(HashOfSlot(kind, slot)) & mBucketMask;
+    while (buckets[bucket] != kNoSlot)
+    {
+        bucket = (bucket + 1) & mBucketMask;
+    }
+    buckets[bucket] = slot;
+}
+
+void IndexedSessionResumptionStorage::RemoveFromIndex(IndexKind kind, uint32_t slot)
+{
+    uint32_t * buckets = Buckets(kind);
+    uint32_t hole      = static_cast<uint32_t>(HashOfSlot(kind, slot)) & mBucketMask;
+    while (buckets[hole] != slot)
+    {
+        VerifyOrDie(buckets[hole] != kNoSlot);
+        hole = (hole + 1) & mBucketMask;
+    }
+
+    // Backward-shift deletion: pull later members of the probe run into the hole so lookups never stop early.
+    for (uint32_t next = (hole + 1) & mBucketMask; buckets[next] != kNoSlot; next = (next + 1) & mBucketMask)
+    {
+        const uint32_t home = static_cast<uint32_t>(HashOfSlot(kind, buckets[next])) & mBucketMask;
+        // Move the entry unless its home bucket lies cyclically in (hole, next].
+        const bool homeInRange = (hole <= next) ? (hole < home && home <= next) : (hole < home || home <= next);
+        if (!homeInRange)
+        {
+            buckets[hole] = buckets[next];
+            hole          = next;
+        }
+    }
+    buckets[hole] = kNoSlot;
+}
+
+void IndexedSessionResumptionStorage::LinkMostRecent(uint32_t slot)
+{
+    Entry & entry  = mEntries[slot];
+    entry.mLruPrev = kNoSlot;
+    entry.mLruNext = mLruHead;
+    if (mLruHead != kNoSlot)
+    {
+        mEntries[mLruHead].mLruPrev = slot;
+    }
+    mLruHead = slot;
+    if (mLruTail == kNoSlot)
+    {
+        mLruTail = slot;
+    }
+}
+
+void IndexedSessionResumptionStorage::Unlink(uint32_t slot)
+{
+    Entry & entry = mEntries[slot];
+    if (entry.mLruPrev != kNoSlot)
+    {
+        mEntries[entry.mLruPrev].mLruNext = entry.mLruNext;
+    }
+    else
+    {
+        mLruHead = entry.mLruNext;
+    }
+    if (entry.mLruNext != kNoSlot)
+    {
+        mEntries[entry.mLruNext].mLruPrev = entry.mLruPrev;
+    }
+    else
+    {
+        mLruTail = entry.mLruPrev;
+    }
+    entry.mLruPrev = kNoSlot;
+    entry.mLruNext = kNoSlot;
+}
+
+void IndexedSessionResumptionStorage::Touch(uint32_t slot)
+{
+    VerifyOrReturn(mLruHead != slot);
+    Unlink(slot);
+    LinkMostRecent(slot);
+}
+
+uint32_t IndexedSessionResumptionStorage::AllocateSlot()
+{
+    const uint32_t slot = mFreeHead;
+    VerifyOrReturnValue(slot != kNoSlot, kNoSlot);
+
+    mFreeHead             = mEntries[slot].mLruNext;
+    mEntries[slot].mInUse = true;
+    mCount++;
+    return slot;
+}
+
+void IndexedSessionResumptionStorage::ReleaseSlot(uint32_t slot)
+{
+    Entry & entry = mEntries[slot];
+    RemoveFromIndex(IndexKind::kByNode, slot);
+    RemoveFromIndex(IndexKind::kByResumptionId, slot);
+    Unlink(slot);
+    Crypto::ClearSecretData(entry.mSharedSecret);
+
+    entry.mInUse   = false;
+    entry.mLruNext = mFreeHead;
+    mFreeHead      = slot;
+    mCount--;
+}
+
+void IndexedSessionResumptionStorage::Fill(uint32_t slot, const ScopedNodeId & node, ConstResumptionIdView resumptionId,
+                                           const Crypto::P256ECDHDerivedSecret & sharedSecret, const CATValues & peerCATs)
+{
+    Entry & entry = mEntries[slot];
+    entry.mNode   = node;
+    memcpy(entry.mResumptionId.data(), resumptionId.data(), kResumptionIdSize);
+    Crypto::ClearSecretData(entry.mSharedSecret);
+    memcpy(entry.mSharedSecret, sharedSecret.ConstBytes(), sharedSecret.Length());
+    entry.mSharedSecretLength = static_cast<uint8_t>(sharedSecret.Length());
+    entry.mPeerCATs           = peerCATs;
+}
+
+CHIP_ERROR IndexedSessionResumptionStorage::RemoveSlot(uint32_t slot)
+{
+    const ScopedNodeId node = mEntries[slot].mNode;
+    ReleaseSlot(slot);
+
+    CHIP_ERROR err = mStateStore.DeleteState(node);
+    if (err != CHIP_NO_ERROR && err != CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+    {
+        ChipLogError(SecureChannel, "Unable to delete session resumption state for node " ChipLogFormatX64 ": %" CHIP_ERROR_FORMAT,
+                     ChipLogValueX64(node.GetNodeId()), err.Format());
+    }
+
+    return SaveIndexPage(static_cast<uint16_t>(slot / kSlotsPerIndexPage));
+}
+
+CHIP_ERROR IndexedSessionResumptionStorage::SaveIndexPage(uint16_t page)
+{
+    const StorageKeyName key = DefaultStorageKeyAllocator::SessionResumptionIndexPage(page);
+    const uint32_t first     = static_cast<uint32_t>(page) * kSlotsPerIndexPage;
+
+    uint8_t buf[MaxIndexPageSize()];
+    TLV::TLVWriter writer;
+    writer.Init(buf);
+
+    TLV::TLVType arrayType;
+    ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Array, arrayType));
+
+    bool empty = true;
+    for (uint32_t slot = first; slot < first + kSlotsPerIndexPage && slot < mCapacity; ++slot)
+    {
+        const Entry & entry = mEntries[slot];
+        if (!entry.mInUse)
+        {
+            continue;
+        }
+
+        TLV::TLVType innerType;
+        ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, innerType));
+        ReturnErrorOnFailure(writer.Put(kSlotTag, static_cast<uint16_t>(slot - first)));
+        ReturnErrorOnFailure(writer.Put(kFabricIndexTag, entry.mNode.GetFabricIndex()));
+        ReturnErrorOnFailure(writer.Put(kPeerNodeIdTag, entry.mNode.GetNodeId()));
+        ReturnErrorOnFailure(writer.EndContainer(innerType));
+        empty = false;
+    }
+
+    ReturnErrorOnFailure(writer.EndContainer(arrayType));
+
+    if (empty)
+    {
+        CHIP_ERROR err = mStorage->SyncDeleteKeyValue(key.KeyName());
+        return (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND) ? CHIP_NO_ERROR : err;
+    }
+
+    const auto len = writer.GetLengthWritten();
+    VerifyOrReturnError(CanCastTo<uint16_t>(len), CHIP_ERROR_BUFFER_TOO_SMALL);
+    return mStorage->SyncSetKeyValue(key.KeyName(), buf, static_cast<uint16_t>(len));
+}
+
+template <typename Handler>
+CHIP_ERROR IndexedSessionResumptionStorage::ReadIndexPage(uint16_t page, Handler && handler)
+{
+    uint8_t buf[MaxIndexPageSize()];
+    uint16_t len = sizeof(buf);
+
+    CHIP_ERROR err = mStorage->SyncGetKeyValue(DefaultStorageKeyAllocator::SessionResumptionIndexPage(page).KeyName(), buf, len);
+    VerifyOrReturnError(err != CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND, CHIP_NO_ERROR);
+    ReturnErrorOnFailure(err);
+
+    TLV::ContiguousBufferTLVReader reader;
+    reader.Init(buf, len);
+
+    ReturnErrorOnFailure(reader.Next(TLV::kTLVType_Array, TLV::AnonymousTag()));
+    TLV::TLVType arrayType;
+    ReturnErrorOnFailure(reader.EnterContainer(arrayType));
+
+    while ((err = reader.Next(TLV::kTLVType_Structure, TLV::AnonymousTag())) == CHIP_NO_ERROR)
+    {
+        TLV::TLVType containerType;
+        ReturnErrorOnFailure(reader.EnterContainer(containerType));
+
+        uint16_t offset;
+        FabricIndex fabricIndex;
+        NodeId peerNodeId;
+        ReturnErrorOnFailure(reader.Next(kSlotTag));
+        ReturnErrorOnFailure(reader.Get(offset));
+        ReturnErrorOnFailure(reader.Next(kFabricIndexTag));
+        ReturnErrorOnFailure(reader.Get(fabricIndex));
+        ReturnErrorOnFailure(reader.Next(kPeerNodeIdTag));
+        ReturnErrorOnFailure(reader.Get(peerNodeId));
+        ReturnErrorOnFailure(reader.ExitContainer(containerType));
+
+        handler(offset, ScopedNodeId(peerNodeId, fabricIndex));
+    }
+
+    VerifyOrReturnError(err == CHIP_END_OF_TLV, err);
+    return reader.ExitContainer(arrayType);
+}
+
+CHIP_ERROR IndexedSessionResumptionStorage::LoadIndexPage(uint16_t page)
+{
+    bool dropped = false;
+    ReturnErrorOnFailure(ReadIndexPage(page, [&](uint16_t offset, const ScopedNodeId & node) {
+        const uint32_t slot = static_cast<uint32_t>(page) * kSlotsPerIndexPage + offset;
+
+        ResumptionIdStorage resumptionId;
+        Crypto::P256ECDHDerivedSecret sharedSecret;
+        CATValues peerCATs;
+        if (offset < kSlotsPerIndexPage && slot >= mCapacity)
+        {
+            // The last page of a larger capacity; slots are saved in order, so everything before this one is loaded.
+            LogErrorOnFailure(DeleteStaleState(node));
+            dropped = true;
+            return;
+        }
+        if (offset >= kSlotsPerIndexPage || mEntries[slot].mInUse || FindSlot(node) != kNoSlot ||
+            mStateStore.LoadState(node, resumptionId, sharedSecret, peerCATs) != CHIP_NO_ERROR)
+        {
+            dropped = true;
+            return;
+        }
+
+        // Take this exact slot off the free list; pages are loaded before anything else allocates.
+        uint32_t * link = &mFreeHead;
+        while (*link != slot)
+        {
+            VerifyOrDie(*link != kNoSlot);
+            link = &mEntries[*link].mLruNext;
+        }
+        *link                 = mEntries[slot].mLruNext;
+        mEntries[slot].mInUse = true;
+        mCount++;
+
+        Fill(slot, node, resumptionId, sharedSecret, peerCATs);
+        InsertIntoIndex(IndexKind::kByNode, slot);
+        InsertIntoIndex(IndexKind::kByResumptionId, slot);
+        LinkMostRecent(slot);
+    }));
+
+    return dropped ? SaveIndexPage(page) : CHIP_NO_ERROR;
+}
+
+CHIP_ERROR IndexedSessionResumptionStorage::DeleteIndexPage(uint16_t page)
+{
+    ReturnErrorOnFailure(
+        ReadIndexPage(page, [&](uint16_t /* offset */, const ScopedNodeId & node) { LogErrorOnFailure(DeleteStaleState(node)); }));
+
+    CHIP_ERROR err = mStorage->SyncDeleteKeyValue(DefaultStorageKeyAllocator::SessionResumptionIndexPage(page).KeyName());
+    return (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND) ? CHIP_NO_ERROR : err;
+}
+
+CHIP_ERROR IndexedSessionResumptionStorage::DeleteStaleState(const ScopedNodeId & node)
+{
+    // A node that is also listed in a loaded slot still needs its state record.
+    VerifyOrReturnError(FindSlot(node) == kNoSlot, CHIP_NO_ERROR);
+
+    CHIP_ERROR err = mStateStore.DeleteState(node);
+    return (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND) ? CHIP_NO_ERROR : err;
+}
+
+CHIP_ERROR IndexedSessionResumptionStorage::DeletePagesBeyondCapacity()
+{
+    const StorageKeyName key = DefaultStorageKeyAllocator::SessionResumptionIndexPageCount();
+
+    uint16_t pageCount;
+    uint16_t len   = sizeof(pageCount);
+    CHIP_ERROR err = mStorage->SyncGetKeyValue(key.KeyName(), &pageCount, len);
+    if (err == CHIP_NO_ERROR && len == sizeof(pageCount))
+    {
+        for (uint16_t page = PageCount(); page < pageCount; ++page)
+        {
+            ReturnErrorOnFailure(DeleteIndexPage(page));
+        }
+        VerifyOrReturnError(pageCount != PageCount(), CHIP_NO_ERROR);
+    }
+
+    pageCount = PageCount();
+    return mStorage->SyncSetKeyValue(key.KeyName(), &pageCount, sizeof(pageCount));
+}
+
+CHIP_ERROR IndexedSessionResumptionStorage::MigrateLegacyIndex()
+{
+    // An index written by SimpleSessionResumptionStorage; its state records are compatible, its links are not needed.
+    DefaultSessionResumptionStorage::SessionIndex legacyIndex;
+    ReturnErrorOnFailure(mStateStore.LoadIndex(legacyIndex));
+    VerifyOrReturnError(legacyIndex.mSize > 0, CHIP_NO_ERROR);
+
+    ChipLogProgress(SecureChannel, "Migrating %u session resumption entries", static_cast<unsigned>(legacyIndex.mSize));
+    for (size_t i = 0; i < legacyIndex.mSize; ++i)
+    {
+        const ScopedNodeId & node = legacyIndex.mNodes[i];
+        ResumptionIdStorage resumptionId;
+        Crypto::P256ECDHDerivedSecret sharedSecret;
+        CATValues peerCATs;
+        if (mStateStore.LoadState(node, resumptionId, sharedSecret, peerCATs) != CHIP_NO_ERROR)
+        {
+            continue;
+        }
+
+        // Link records are not used by this storage.
+        mStateStore.DeleteLink(resumptionId);
+        if (FindSlot(node) == kNoSlot)
+        {
+            // Save rewrites the state record unchanged and evicts if the legacy index is larger than our capacity.
+            ReturnErrorOnFailure(Save(node, resumptionId, sharedSecret, peerCATs));
+        }
+    }
+
+    CHIP_ERROR err = mStorage->SyncDeleteKeyValue(DefaultStorageKeyAllocator::SessionResumptionIndex().KeyName());
+    return (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND) ? CHIP_NO_ERROR : err;
+}
+
+} // namespace chip
@@ -0,0 +1,152 @@
+/*
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPPersistentStorageDelegate.h>
+#include <lib/core/TLV.h>
+#include <lib/support/ScopedBuffer.h>
+#include <protocols/secure_channel/SimpleSessionResumptionStorage.h>
+
+namespace chip {
+
+/**
+ * @brief A SessionResumptionStorage for controllers that talk to many peers.
+ *
+ *   SimpleSessionResumptionStorage keeps a single index of at most CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE nodes in one
+ *   storage value and reads it back, together with a per-resumption-id link record, on every lookup and save.  With a large
+ *   fleet the index evicts in insertion order long before every peer has an entry, so most reconnects fall back to a full
+ *   Sigma1/2/3 exchange with ECDH.
+ *
+ *   This implementation holds up to a runtime `capacity` of entries in memory, looked up through two open-addressed hash
+ *   tables (by ScopedNodeId and by resumption id), and evicts the least recently used entry when full.  All entries are
+ *   loaded once in Init; afterwards lookups never touch storage and a save writes the node's state record plus one index
+ *   page.  Per-node state records use the same key and encoding as SimpleSessionResumptionStorage, and an index left behind
+ *   by SimpleSessionResumptionStorage is migrated on Init.  The index is split into pages of kSlotsPerIndexPage nodes under
+ *   DefaultStorageKeyAllocator::SessionResumptionIndexPage, so no single storage value grows with the fleet.  The number of
+ *   pages is persisted too, so that when Init is given a smaller capacity the entries that no longer fit are deleted from
+ *   storage instead of being left behind.  Recency is not persisted: after a restart entries are evicted in load order until
+ *   they have been used again.
+ */
+class IndexedSessionResumptionStorage : public SessionResumptionStorage
+{
+public:
+    static constexpr uint16_t kSlotsPerIndexPage = 32;
+
+    ~IndexedSessionResumptionStorage() override { Shutdown(); }
+
+    /**
+     * Allocate room for `capacity` entries and load everything persisted in `storage`.  Entries whose state record cannot
+     * be read are dropped from the index, and entries beyond `capacity` (left by an earlier Init with a larger capacity)
+     * are deleted from storage.
+     */
+    CHIP_ERROR Init(PersistentStorageDelegate * storage, uint32_t capacity);
+    void Shutdown();
+
+    CHIP_ERROR FindByScopedNodeId(const ScopedNodeId & node, ResumptionIdStorage & resumptionId,
+                                  Crypto::P256ECDHDerivedSecret & sharedSecret, CATValues & peerCATs) override;
+    CHIP_ERROR FindByResumptionId(ConstResumptionIdView resumptionId, ScopedNodeId & node,
+                                  Crypto::P256ECDHDerivedSecret & sharedSecret, CATValues & peerCATs) override;
+    CHIP_ERROR Save(const ScopedNodeId & node, ConstResumptionIdView resumptionId,
+                    const Crypto::P256ECDHDerivedSecret & sharedSecret, const CATValues & peerCATs) override;
+    CHIP_ERROR Delete(const ScopedNodeId & node);
+    CHIP_ERROR DeleteAll(FabricIndex fabricIndex) override;
+
+    uint32_t Count() const { return mCount; }
+    uint32_t Capacity() const { return mCapacity; }
+
+private:
+    static constexpr uint32_t kNoSlot = UINT32_MAX;
+
+    struct Entry
+    {
+        ScopedNodeId mNode;
+        ResumptionIdStorage mResumptionId;
+        // Raw bytes rather than a P256ECDHDerivedSecret so that entries stay trivially destructible; cleared explicitly.
+        uint8_t mSharedSecret[Crypto::kMax_ECDH_Secret_Length];
+        uint8_t mSharedSecretLength;
+        CATValues mPeerCATs;
+        // Least recently used list, most recent at mLruHead.
+        uint32_t mLruPrev = kNoSlot;
+        uint32_t mLruNext = kNoSlot;
+        bool mInUse       = false;
+    };
+
+    enum class IndexKind : uint8_t
+    {
+        kByNode,
+        kByResumptionId,
+    };
+
+    static uint64_t Hash(const ScopedNodeId & node);
+    static uint64_t Hash(ConstResumptionIdView resumptionId);
+    uint64_t HashOfSlot(IndexKind kind, uint32_t slot) const;
+    uint32_t * Buckets(IndexKind kind) { return (kind == IndexKind::kByNode) ? mNodeBuckets.Get() : mResumptionIdBuckets.Get(); }
+
+    uint32_t FindSlot(const ScopedNodeId & node);
+    uint32_t FindSlot(ConstResumptionIdView resumptionId);
+    void InsertIntoIndex(IndexKind kind, uint32_t slot);
+    void RemoveFromIndex(IndexKind kind, uint32_t slot);
+
+    void LinkMostRecent(uint32_t slot);
+    void Unlink(uint32_t slot);
+    void Touch(uint32_t slot);
+
+    uint32_t AllocateSlot();
+    void ReleaseSlot(uint32_t slot);
+    void Fill(uint32_t slot, const ScopedNodeId & node, ConstResumptionIdView resumptionId,
+              const Crypto::P256ECDHDerivedSecret & sharedSecret, const CATValues & peerCATs);
+
+    template <typename Handler>
+    CHIP_ERROR ReadIndexPage(uint16_t page, Handler && handler);
+    CHIP_ERROR LoadIndexPage(uint16_t page);
+    CHIP_ERROR DeleteIndexPage(uint16_t page);
+    CHIP_ERROR DeleteStaleState(const ScopedNodeId & node);
+    CHIP_ERROR DeletePagesBeyondCapacity();
+    CHIP_ERROR SaveIndexPage(uint16_t page);
+    CHIP_ERROR MigrateLegacyIndex();
+    CHIP_ERROR RemoveSlot(uint32_t slot);
+    uint16_t PageCount() const { return static_cast<uint16_t>((mCapacity + kSlotsPerIndexPage - 1) / kSlotsPerIndexPage); }
+
+    static constexpr size_t MaxIndexPageSize()
+    {
+        return TLV::EstimateStructOverhead(
+            (1 + TLV::EstimateStructOverhead(sizeof(uint16_t), sizeof(FabricIndex), sizeof(NodeId))) * kSlotsPerIndexPage);
+    }
+
+    static constexpr TLV::Tag kSlotTag        = TLV::ContextTag(1);
+    static constexpr TLV::Tag kFabricIndexTag = TLV::ContextTag(2);
+    static constexpr TLV::Tag kPeerNodeIdTag  = TLV::ContextTag(3);
+
+    // Reads and writes the per-node state records.
+    SimpleSessionResumptionStorage mStateStore;
+    PersistentStorageDelegate * mStorage = nullptr;
+
+    Platform::ScopedMemoryBuffer<Entry> mEntries;
+    Platform::ScopedMemoryBuffer<uint32_t> mNodeBuckets;
+    Platform::ScopedMemoryBuffer<uint32_t> mResumptionIdBuckets;
+    uint32_t mBucketMask = 0;
+    uint32_t mCapacity   = 0;
+    uint32_t mCount      = 0;
+
+    uint32_t mLruHead = kNoSlot;
+    uint32_t mLruTail = kNoSlot;
+    // Unused slots, chained through mLruNext.
+    uint32_t mFreeHead = kNoSlot;
+};
+
+} // namespace chip
@@ -0,0 +1,171 @@
+/*
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @file
+ *   Compares SimpleSessionResumptionStorage and IndexedSessionResumptionStorage for a controller that
+ *   reconnects to a fleet of nodes: how many reconnects find a resumption record, and what a lookup and
+ *   a save cost.  Every miss means a full CASE exchange instead of a resumption, so the P256 ECDH that
+ *   such an exchange needs is timed as well to put the hit rate into CPU terms.
+ *
+ *   Usage: session-resumption-storage-benchmark [fleet-size] [iterations]
+ */
+
+#include <crypto/CHIPCryptoPAL.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/TestPersistentStorageDelegate.h>
+#include <lib/support/tests/BenchmarkHelpers.h>
+#include <protocols/secure_channel/IndexedSessionResumptionStorage.h>
+#include <protocols/secure_channel/SimpleSessionResumptionStorage.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace chip;
+
+namespace {
+
+constexpr uint32_t kDefaultFleetSize  = 1000;
+constexpr uint64_t kDefaultIterations = 20000;
+constexpr FabricIndex kFabricIndex    = 1;
+
+using ResumptionIdStorage = SessionResumptionStorage::ResumptionIdStorage;
+
+Crypto::P256ECDHDerivedSecret gSharedSecret;
+CATValues gPeerCATs;
+
+ScopedNodeId NodeAt(uint64_t index)
+{
+    return ScopedNodeId(0x1000 + index, kFabricIndex);
+}
+
+ResumptionIdStorage ResumptionIdAt(uint64_t index, uint32_t generation)
+{
+    ResumptionIdStorage resumptionId;
+    resumptionId.fill(0);
+    memcpy(resumptionId.data(), &index, sizeof(index));
+    memcpy(resumptionId.data() + sizeof(index), &generation, sizeof(generation));
+    return resumptionId;
+}
+
+bool SaveFleet(SessionResumptionStorage & storage, uint32_t fleetSize)
+{
+    for (uint32_t i = 0; i < fleetSize; ++i)
+    {
+        const ResumptionIdStorage resumptionId = ResumptionIdAt(i, 0);
+        VerifyOrReturnValue(storage.Save(NodeAt(i), resumptionId, gSharedSecret, gPeerCATs) == CHIP_NO_ERROR, false);
+    }
+    return true;
+}
+
+// One reconnect to every node in the fleet, in order; returns how many of them could resume.
+uint32_t ReconnectSweep(SessionResumptionStorage & storage, uint32_t fleetSize)
+{
+    uint32_t hits = 0;
+    for (uint32_t i = 0; i < fleetSize; ++i)
+    {
+        ResumptionIdStorage resumptionId;
+        Crypto::P256ECDHDerivedSecret sharedSecret;
+        CATValues peerCATs;
+        if (storage.FindByScopedNodeId(NodeAt(i), resumptionId, sharedSecret, peerCATs) == CHIP_NO_ERROR)
+        {
+            hits++;
+        }
+    }
+    return hits;
+}
+
+void RunStorageCases(const char * label, SessionResumptionStorage & storage, uint32_t fleetSize, uint64_t iterations)
+{
+    char name[64];
+
+    snprintf(name, sizeof(name), "%s: save fleet of %u", label, static_cast<unsigned>(fleetSize));
+    Test::PrintBenchmarkResult(Test::RunBenchmark(name, 1, [&](uint64_t) { return SaveFleet(storage, fleetSize); }));
+
+    const uint32_t hits = ReconnectSweep(storage, fleetSize);
+    printf("%-56s %11.1f%%\n", "  reconnect sweep resumption hit rate",
+           100.0 * static_cast<double>(hits) / static_cast<double>(fleetSize));
+
+    snprintf(name, sizeof(name), "%s: FindByScopedNodeId", label);
+    Test::PrintBenchmarkResult(Test::RunBenchmark(name, iterations, [&](uint64_t i) {
+        ResumptionIdStorage resumptionId;
+        Crypto::P256ECDHDerivedSecret sharedSecret;
+        CATValues peerCATs;
+        // Misses are expected once the fleet outgrows the storage; they are timed like hits.
+        CHIP_ERROR err = storage.FindByScopedNodeId(NodeAt(i % fleetSize), resumptionId, sharedSecret, peerCATs);
+        Test::DoNotOptimize(err);
+        return true;
+    }));
+
+    snprintf(name, sizeof(name), "%s: Save (new resumption id)", label);
+    Test::PrintBenchmarkResult(Test::RunBenchmark(name, iterations, [&](uint64_t i) {
+        const uint64_t index                   = i % fleetSize;
+        const ResumptionIdStorage resumptionId = ResumptionIdAt(index, static_cast<uint32_t>(i + 1));
+        return storage.Save(NodeAt(index), resumptionId, gSharedSecret, gPeerCATs) == CHIP_NO_ERROR;
+    }));
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+    const uint32_t fleetSize  = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 0)) : kDefaultFleetSize;
+    const uint64_t iterations = (argc > 2) ? strtoull(argv[2], nullptr, 0) : kDefaultIterations;
+    VerifyOrReturnValue(fleetSize > 0, EXIT_FAILURE);
+    VerifyOrReturnValue(Platform::MemoryInit() == CHIP_NO_ERROR, EXIT_FAILURE);
+
+    VerifyOrReturnValue(gSharedSecret.SetLength(gSharedSecret.Capacity()) == CHIP_NO_ERROR, EXIT_FAILURE);
+    memset(gSharedSecret.Bytes(), 0x5a, gSharedSecret.Length());
+
+    Test::PrintBenchmarkHeader();
+
+    {
+        TestPersistentStorageDelegate storage;
+        SimpleSessionResumptionStorage simple;
+        VerifyOrReturnValue(simple.Init(&storage) == CHIP_NO_ERROR, EXIT_FAILURE);
+        RunStorageCases("simple", simple, fleetSize, iterations);
+    }
+
+    {
+        TestPersistentStorageDelegate storage;
+        IndexedSessionResumptionStorage indexed;
+        VerifyOrReturnValue(indexed.Init(&storage, fleetSize) == CHIP_NO_ERROR, EXIT_FAILURE);
+        RunStorageCases("indexed", indexed, fleetSize, iterations);
+        indexed.Shutdown();
+
+        // What a controller restart costs: reading every page and state record back.
+        Test::PrintBenchmarkResult(Test::RunBenchmark("indexed: Init from storage", 1, [&](uint64_t) {
+            IndexedSessionResumptionStorage reloaded;
+            return reloaded.Init(&storage, fleetSize) == CHIP_NO_ERROR && reloaded.Count() == fleetSize;
+        }));
+    }
+
+    // The work every resumption miss adds on the controller side of a full CASE exchange.
+    Crypto::P256Keypair local;
+    Crypto::P256Keypair remote;
+    VerifyOrReturnValue(local.Initialize(Crypto::ECPKeyTarget::ECDH) == CHIP_NO_ERROR, EXIT_FAILURE);
+    VerifyOrReturnValue(remote.Initialize(Crypto::ECPKeyTarget::ECDH) == CHIP_NO_ERROR, EXIT_FAILURE);
+    Test::PrintBenchmarkResult(Test::RunBenchmark("P256 ECDH (per resumption miss)", iterations / 20 + 1, [&](uint64_t) {
+        Crypto::P256ECDHDerivedSecret secret;
+        return local.ECDH_derive_secret(remote.Pubkey(), secret) == CHIP_NO_ERROR;
+    }));
+
+    Platform::MemoryShutdown();
+    return EXIT_SUCCESS;
+}
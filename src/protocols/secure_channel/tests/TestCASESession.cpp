@@ -21,7 +21,9 @@
  *      This file implements unit tests for the CASESession implementation.
  */
 
+#include <chrono>
 #include <stdarg.h>
+#include <thread>
 
 #include <pw_unit_test/framework.h>
 
@@ -580,6 +582,65 @@ TEST_F(TestCASESession, SecurePairingHandshakeServerTest)
     gPairingServer.Shutdown();
 }
 
+// The fake platform's event queue cannot be posted to from the worker threads.
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING && !CHIP_DEVICE_LAYER_TARGET_FAKE
+TEST_F(TestCASESession, SecurePairingHandshakeWithCryptoWorkerPoolTest)
+{
+    CryptoWorkerPool workerPool;
+    ASSERT_EQ(workerPool.Init(/* threadCount = */ 2, /* queueDepth = */ 4), CHIP_NO_ERROR);
+
+    TemporarySessionManager sessionManager(*this);
+    TestCASESecurePairingDelegate delegateCommissioner;
+    TestCASESecurePairingDelegate delegateAccessory;
+    CASESession pairingCommissioner;
+    CASESession pairingAccessory;
+
+    pairingCommissioner.SetGroupDataProvider(&gCommissionerGroupDataProvider);
+    pairingCommissioner.SetCryptoWorkQueue(&workerPool);
+    pairingAccessory.SetGroupDataProvider(&gDeviceGroupDataProvider);
+    pairingAccessory.SetCryptoWorkQueue(&workerPool);
+
+    EXPECT_EQ(GetExchangeManager().RegisterUnsolicitedMessageHandlerForType(Protocols::SecureChannel::MsgType::CASE_Sigma1,
+                                                                            &pairingAccessory),
+              CHIP_NO_ERROR);
+
+    ExchangeContext * contextCommissioner = NewUnauthenticatedExchangeToBob(&pairingCommissioner);
+
+    EXPECT_EQ(pairingAccessory.PrepareForSessionEstablishment(sessionManager, &gDeviceFabrics, nullptr, nullptr, &delegateAccessory,
+                                                              ScopedNodeId(), Optional<ReliableMessageProtocolConfig>::Missing()),
+              CHIP_NO_ERROR);
+    EXPECT_EQ(pairingCommissioner.EstablishSession(
+                  sessionManager, &gCommissionerFabrics, ScopedNodeId{ Node01_01, gCommissionerFabricIndex }, contextCommissioner,
+                  nullptr, nullptr, &delegateCommissioner, Optional<ReliableMessageProtocolConfig>::Missing()),
+              CHIP_NO_ERROR);
+
+    // Sigma2 and Sigma3 are verified on the pool's threads and their results come back through
+    // PlatformManager::ScheduleWork, so keep servicing events until both sides are done.
+    auto isDone = [&] {
+        return (delegateCommissioner.mNumPairingComplete + delegateCommissioner.mNumPairingErrors > 0) &&
+            (delegateAccessory.mNumPairingComplete + delegateAccessory.mNumPairingErrors > 0);
+    };
+    for (int i = 0; i < 500 && !isDone(); ++i)
+    {
+        ServiceEvents();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    EXPECT_EQ(delegateCommissioner.mNumPairingComplete, 1u);
+    EXPECT_EQ(delegateAccessory.mNumPairingComplete, 1u);
+    EXPECT_EQ(delegateCommissioner.mNumPairingErrors, 0u);
+    EXPECT_EQ(delegateAccessory.mNumPairingErrors, 0u);
+
+    // Sigma2 verification on the initiator and Sigma3 verification on the responder.
+    EXPECT_GE(workerPool.GetStats().completed, 2u);
+    EXPECT_EQ(workerPool.GetStats().rejected, 0u);
+
+    EXPECT_EQ(GetExchangeManager().UnregisterUnsolicitedMessageHandlerForType(Protocols::SecureChannel::MsgType::CASE_Sigma1),
+              CHIP_NO_ERROR);
+    workerPool.Shutdown();
+}
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING && !CHIP_DEVICE_LAYER_TARGET_FAKE
+
 TEST_F(TestCASESession, ClientReceivesBusyTest)
 {
     TemporarySessionManager sessionManager(*this);
@@ -0,0 +1,195 @@
+/*
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <pw_unit_test/framework.h>
+
+#include <lib/core/StringBuilderAdapters.h>
+#include <lib/support/CHIPMem.h>
+#include <protocols/secure_channel/CryptoWorkQueue.h>
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace chip;
+
+namespace {
+
+class TestCryptoWorkerPool : public ::testing::Test
+{
+public:
+    static void SetUpTestSuite() { ASSERT_EQ(Platform::MemoryInit(), CHIP_NO_ERROR); }
+    static void TearDownTestSuite() { Platform::MemoryShutdown(); }
+};
+
+// Blocks every work item that runs until Release() is called.
+struct Gate
+{
+    std::mutex lock;
+    std::condition_variable cv;
+    bool open = false;
+    std::atomic<uint32_t> entered{ 0 };
+    std::atomic<uint32_t> ran{ 0 };
+
+    static void Work(intptr_t arg)
+    {
+        auto * gate = reinterpret_cast<Gate *>(arg);
+        gate->entered++;
+        std::unique_lock<std::mutex> guard(gate->lock);
+        gate->cv.wait(guard, [gate] { return gate->open; });
+        gate->ran++;
+    }
+
+    void Release()
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            open = true;
+        }
+        cv.notify_all();
+    }
+
+    bool WaitEntered(uint32_t count)
+    {
+        for (int i = 0; i < 2000 && entered.load() < count; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return entered.load() >= count;
+    }
+};
+
+std::atomic<uint32_t> gCount{ 0 };
+
+void CountWork(intptr_t)
+{
+    gCount++;
+}
+
+void RecordThread(intptr_t arg)
+{
+    *reinterpret_cast<std::thread::id *>(arg) = std::this_thread::get_id();
+}
+
+TEST_F(TestCryptoWorkerPool, TestInitArguments)
+{
+    CryptoWorkerPool pool;
+    EXPECT_EQ(pool.Init(0, 4), CHIP_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(pool.Init(CryptoWorkerPool::kMaxThreads + 1, 4), CHIP_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(pool.Init(2, 0), CHIP_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(pool.ScheduleWork(CountWork, 0), CHIP_ERROR_INCORRECT_STATE);
+
+    EXPECT_EQ(pool.Init(2, 4), CHIP_NO_ERROR);
+    EXPECT_EQ(pool.Init(2, 4), CHIP_ERROR_INCORRECT_STATE);
+    EXPECT_EQ(pool.ScheduleWork(nullptr, 0), CHIP_ERROR_INVALID_ARGUMENT);
+    pool.Shutdown();
+
+    EXPECT_EQ(pool.ScheduleWork(CountWork, 0), CHIP_ERROR_INCORRECT_STATE);
+}
+
+TEST_F(TestCryptoWorkerPool, TestRunsOnWorkerThread)
+{
+    CryptoWorkerPool pool;
+    ASSERT_EQ(pool.Init(1, 4), CHIP_NO_ERROR);
+
+    std::thread::id workerId;
+    EXPECT_EQ(pool.ScheduleWork(RecordThread, reinterpret_cast<intptr_t>(&workerId)), CHIP_NO_ERROR);
+    pool.Shutdown();
+
+    EXPECT_NE(workerId, std::thread::id());
+    EXPECT_NE(workerId, std::this_thread::get_id());
+}
+
+TEST_F(TestCryptoWorkerPool, TestWorkersRunConcurrently)
+{
+    constexpr uint32_t kThreads = 4;
+
+    CryptoWorkerPool pool;
+    ASSERT_EQ(pool.Init(kThreads, kThreads), CHIP_NO_ERROR);
+
+    Gate gate;
+    for (uint32_t i = 0; i < kThreads; ++i)
+    {
+        EXPECT_EQ(pool.ScheduleWork(Gate::Work, reinterpret_cast<intptr_t>(&gate)), CHIP_NO_ERROR);
+    }
+
+    // Every item is blocked at once, so each one holds its own worker.
+    EXPECT_TRUE(gate.WaitEntered(kThreads));
+    gate.Release();
+    pool.Shutdown();
+
+    EXPECT_EQ(gate.ran.load(), kThreads);
+}
+
+TEST_F(TestCryptoWorkerPool, TestQueueFullAndStats)
+{
+    CryptoWorkerPool pool;
+    ASSERT_EQ(pool.Init(1, 2), CHIP_NO_ERROR);
+
+    // Park the only worker, then fill the queue behind it.
+    Gate gate;
+    EXPECT_EQ(pool.ScheduleWork(Gate::Work, reinterpret_cast<intptr_t>(&gate)), CHIP_NO_ERROR);
+    ASSERT_TRUE(gate.WaitEntered(1));
+
+    EXPECT_EQ(pool.ScheduleWork(Gate::Work, reinterpret_cast<intptr_t>(&gate)), CHIP_NO_ERROR);
+    EXPECT_EQ(pool.ScheduleWork(Gate::Work, reinterpret_cast<intptr_t>(&gate)), CHIP_NO_ERROR);
+    EXPECT_EQ(pool.ScheduleWork(Gate::Work, reinterpret_cast<intptr_t>(&gate)), CHIP_ERROR_NO_MEMORY);
+
+    CryptoWorkerPool::Stats stats = pool.GetStats();
+    EXPECT_EQ(stats.queueDepth, 2u);
+    EXPECT_EQ(stats.peakQueueDepth, 2u);
+    EXPECT_EQ(stats.completed, 0u);
+    EXPECT_EQ(stats.rejected, 1u);
+
+    gate.Release();
+    pool.Shutdown();
+
+    EXPECT_EQ(gate.ran.load(), 3u);
+}
+
+TEST_F(TestCryptoWorkerPool, TestShutdownDrainsQueue)
+{
+    constexpr uint32_t kItems = 64;
+
+    gCount = 0;
+    CryptoWorkerPool pool;
+    ASSERT_EQ(pool.Init(2, kItems), CHIP_NO_ERROR);
+
+    for (uint32_t i = 0; i < kItems; ++i)
+    {
+        EXPECT_EQ(pool.ScheduleWork(CountWork, 0), CHIP_NO_ERROR);
+    }
+    CryptoWorkerPool::Stats stats = pool.GetStats();
+    pool.Shutdown();
+
+    EXPECT_EQ(gCount.load(), kItems);
+    EXPECT_LE(stats.completed, kItems);
+
+    // A stopped pool can be started again.
+    ASSERT_EQ(pool.Init(1, 1), CHIP_NO_ERROR);
+    EXPECT_EQ(pool.ScheduleWork(CountWork, 0), CHIP_NO_ERROR);
+    pool.Shutdown();
+    EXPECT_EQ(gCount.load(), kItems + 1);
+}
+
+} // namespace
+
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
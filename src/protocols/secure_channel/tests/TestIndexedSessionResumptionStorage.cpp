@@ -0,0 +1,304 @@
+/*
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <pw_unit_test/framework.h>
+
+#include <lib/core/StringBuilderAdapters.h>
+#include <lib/support/DefaultStorageKeyAllocator.h>
+#include <lib/support/TestPersistentStorageDelegate.h>
+#include <protocols/secure_channel/IndexedSessionResumptionStorage.h>
+
+namespace {
+
+using namespace chip;
+using ResumptionIdStorage = SessionResumptionStorage::ResumptionIdStorage;
+
+constexpr FabricIndex kFabric1 = 10;
+constexpr FabricIndex kFabric2 = 14;
+
+struct Record
+{
+    ScopedNodeId node;
+    ResumptionIdStorage resumptionId;
+    Crypto::P256ECDHDerivedSecret sharedSecret;
+    CATValues peerCATs;
+};
+
+// Distinct, reproducible contents per node so a lookup can be checked against what was saved.
+Record MakeRecord(NodeId nodeId, FabricIndex fabricIndex, uint8_t generation = 0)
+{
+    Record record;
+    record.node = ScopedNodeId(nodeId, fabricIndex);
+    record.resumptionId.fill(0xA5);
+    memcpy(record.resumptionId.data(), &nodeId, sizeof(nodeId));
+    record.resumptionId[sizeof(nodeId)]     = fabricIndex;
+    record.resumptionId[sizeof(nodeId) + 1] = generation;
+    EXPECT_EQ(record.sharedSecret.SetLength(record.sharedSecret.Capacity()), CHIP_NO_ERROR);
+    for (size_t i = 0; i < record.sharedSecret.Length(); ++i)
+    {
+        record.sharedSecret.Bytes()[i] = static_cast<uint8_t>(nodeId + generation + i);
+    }
+    record.peerCATs.values[0] = static_cast<CASEAuthTag>(0x00010001 + nodeId);
+    return record;
+}
+
+CHIP_ERROR SaveRecord(SessionResumptionStorage & storage, const Record & record)
+{
+    return storage.Save(record.node, record.resumptionId, record.sharedSecret, record.peerCATs);
+}
+
+void ExpectFound(SessionResumptionStorage & storage, const Record & record)
+{
+    ResumptionIdStorage resumptionId;
+    Crypto::P256ECDHDerivedSecret sharedSecret;
+    CATValues peerCATs;
+    ASSERT_EQ(storage.FindByScopedNodeId(record.node, resumptionId, sharedSecret, peerCATs), CHIP_NO_ERROR);
+    EXPECT_EQ(resumptionId, record.resumptionId);
+    ASSERT_EQ(sharedSecret.Length(), record.sharedSecret.Length());
+    EXPECT_EQ(memcmp(sharedSecret.ConstBytes(), record.sharedSecret.ConstBytes(), sharedSecret.Length()), 0);
+    EXPECT_EQ(peerCATs, record.peerCATs);
+
+    ScopedNodeId node;
+    ASSERT_EQ(storage.FindByResumptionId(record.resumptionId, node, sharedSecret, peerCATs), CHIP_NO_ERROR);
+    EXPECT_EQ(node, record.node);
+    ASSERT_EQ(sharedSecret.Length(), record.sharedSecret.Length());
+    EXPECT_EQ(memcmp(sharedSecret.ConstBytes(), record.sharedSecret.ConstBytes(), sharedSecret.Length()), 0);
+}
+
+void ExpectNotFound(SessionResumptionStorage & storage, const Record & record)
+{
+    ResumptionIdStorage resumptionId;
+    Crypto::P256ECDHDerivedSecret sharedSecret;
+    CATValues peerCATs;
+    ScopedNodeId node;
+    EXPECT_EQ(storage.FindByScopedNodeId(record.node, resumptionId, sharedSecret, peerCATs), CHIP_ERROR_KEY_NOT_FOUND);
+    EXPECT_EQ(storage.FindByResumptionId(record.resumptionId, node, sharedSecret, peerCATs), CHIP_ERROR_KEY_NOT_FOUND);
+}
+
+class TestIndexedSessionResumptionStorage : public ::testing::Test
+{
+public:
+    static void SetUpTestSuite() { ASSERT_EQ(Platform::MemoryInit(), CHIP_NO_ERROR); }
+    static void TearDownTestSuite() { Platform::MemoryShutdown(); }
+};
+
+TEST_F(TestIndexedSessionResumptionStorage, TestSaveFindAndUpdate)
+{
+    TestPersistentStorageDelegate storage;
+    IndexedSessionResumptionStorage sessionStorage;
+    ASSERT_EQ(sessionStorage.Init(&storage, 100), CHIP_NO_ERROR);
+
+    for (NodeId nodeId = 1; nodeId <= 100; ++nodeId)
+    {
+        EXPECT_EQ(SaveRecord(sessionStorage, MakeRecord(nodeId, kFabric1)), CHIP_NO_ERROR);
+    }
+    EXPECT_EQ(sessionStorage.Count(), 100u);
+
+    for (NodeId nodeId = 1; nodeId <= 100; ++nodeId)
+    {
+        ExpectFound(sessionStorage, MakeRecord(nodeId, kFabric1));
+    }
+    ExpectNotFound(sessionStorage, MakeRecord(1, kFabric2));
+
+    // Saving a known node again replaces its resumption id in place.
+    EXPECT_EQ(SaveRecord(sessionStorage, MakeRecord(42, kFabric1, /* generation = */ 1)), CHIP_NO_ERROR);
+    EXPECT_EQ(sessionStorage.Count(), 100u);
+    ExpectFound(sessionStorage, MakeRecord(42, kFabric1, 1));
+
+    ScopedNodeId node;
+    Crypto::P256ECDHDerivedSecret sharedSecret;
+    CATValues peerCATs;
+    Record stale = MakeRecord(42, kFabric1);
+    EXPECT_EQ(sessionStorage.FindByResumptionId(stale.resumptionId, node, sharedSecret, peerCATs), CHIP_ERROR_KEY_NOT_FOUND);
+
+    EXPECT_EQ(sessionStorage.Delete(ScopedNodeId(42, kFabric1)), CHIP_NO_ERROR);
+    ExpectNotFound(sessionStorage, MakeRecord(42, kFabric1, 1));
+    EXPECT_EQ(sessionStorage.Count(), 99u);
+
+    // Everything else survives the backward shifts in the hash tables.
+    for (NodeId nodeId = 1; nodeId <= 100; ++nodeId)
+    {
+        if (nodeId != 42)
+        {
+            ExpectFound(sessionStorage, MakeRecord(nodeId, kFabric1));
+        }
+    }
+}
+
+TEST_F(TestIndexedSessionResumptionStorage, TestLeastRecentlyUsedEviction)
+{
+    TestPersistentStorageDelegate storage;
+    IndexedSessionResumptionStorage sessionStorage;
+    ASSERT_EQ(sessionStorage.Init(&storage, 3), CHIP_NO_ERROR);
+
+    EXPECT_EQ(SaveRecord(sessionStorage, MakeRecord(1, kFabric1)), CHIP_NO_ERROR);
+    EXPECT_EQ(SaveRecord(sessionStorage, MakeRecord(2, kFabric1)), CHIP_NO_ERROR);
+    EXPECT_EQ(SaveRecord(sessionStorage, MakeRecord(3, kFabric1)), CHIP_NO_ERROR);
+
+    // Using node 1 makes node 2 the least recently used entry.
+    ExpectFound(sessionStorage, MakeRecord(1, kFabric1));
+    EXPECT_EQ(SaveRecord(sessionStorage, MakeRecord(4, kFabric1)), CHIP_NO_ERROR);
+
+    EXPECT_EQ(sessionStorage.Count(), 3u);
+    ExpectNotFound(sessionStorage, MakeRecord(2, kFabric1));
+    ExpectFound(sessionStorage, MakeRecord(1, kFabric1));
+    ExpectFound(sessionStorage, MakeRecord(3, kFabric1));
+    ExpectFound(sessionStorage, MakeRecord(4, kFabric1));
+
+    // The evicted node's state record is gone from storage too.
+    EXPECT_FALSE(storage.HasKey(DefaultStorageKeyAllocator::FabricSession(kFabric1, 2).KeyName()));
+}
+
+TEST_F(TestIndexedSessionResumptionStorage, TestReloadFromStorage)
+{
+    TestPersistentStorageDelegate storage;
+    {
+        IndexedSessionResumptionStorage sessionStorage;
+        ASSERT_EQ(sessionStorage.Init(&storage, 80), CHIP_NO_ERROR);
+        for (NodeId nodeId = 1; nodeId <= 70; ++nodeId)
+        {
+            EXPECT_EQ(SaveRecord(sessionStorage, MakeRecord(nodeId, (nodeId % 2) ? kFabric1 : kFabric2)), CHIP_NO_ERROR);
+        }
+        EXPECT_EQ(sessionStorage.Delete(ScopedNodeId(10, kFabric2)), CHIP_NO_ERROR);
+    }
+
+    // The index spans several pages; lookups after a reload must not need storage anymore.
+    EXPECT_TRUE(storage.HasKey(DefaultStorageKeyAllocator::SessionResumptionIndexPage(2).KeyName()));
+
+    IndexedSessionResumptionStorage sessionStorage;
+    ASSERT_EQ(sessionStorage.Init(&storage, 80), CHIP_NO_ERROR);
+    EXPECT_EQ(sessionStorage.Count(), 69u);
+
+    storage.SetRejectWrites(true);
+    for (NodeId nodeId = 1; nodeId <= 70; ++nodeId)
+    {
+        Record record = MakeRecord(nodeId, (nodeId % 2) ? kFabric1 : kFabric2);
+        if (nodeId == 10)
+        {
+            ExpectNotFound(sessionStorage, record);
+        }
+        else
+        {
+            ExpectFound(sessionStorage, record);
+        }
+    }
+    storage.SetRejectWrites(false);
+}
+
+TEST_F(TestIndexedSessionResumptionStorage, TestMigrateLegacyIndex)
+{
+    TestPersistentStorageDelegate storage;
+    {
+        SimpleSessionResumptionStorage legacy;
+        ASSERT_EQ(legacy.Init(&storage), CHIP_NO_ERROR);
+        for (NodeId nodeId = 1; nodeId <= 3; ++nodeId)
+        {
+            EXPECT_EQ(SaveRecord(legacy, MakeRecord(nodeId, kFabric1)), CHIP_NO_ERROR);
+        }
+    }
+    EXPECT_TRUE(storage.HasKey(DefaultStorageKeyAllocator::SessionResumptionIndex().KeyName()));
+
+    {
+        IndexedSessionResumptionStorage sessionStorage;
+        ASSERT_EQ(sessionStorage.Init(&storage, 16), CHIP_NO_ERROR);
+        EXPECT_EQ(sessionStorage.Count(), 3u);
+        for (NodeId nodeId = 1; nodeId <= 3; ++nodeId)
+        {
+            ExpectFound(sessionStorage, MakeRecord(nodeId, kFabric1));
+        }
+    }
+
+    // Only the three state records, one index page and the page count are left; the link records are gone.
+    EXPECT_FALSE(storage.HasKey(DefaultStorageKeyAllocator::SessionResumptionIndex().KeyName()));
+    EXPECT_EQ(storage.GetNumKeys(), 5u);
+
+    IndexedSessionResumptionStorage sessionStorage;
+    ASSERT_EQ(sessionStorage.Init(&storage, 16), CHIP_NO_ERROR);
+    EXPECT_EQ(sessionStorage.Count(), 3u);
+}
+
+TEST_F(TestIndexedSessionResumptionStorage, TestDeleteAll)
+{
+    TestPersistentStorageDelegate storage;
+    IndexedSessionResumptionStorage sessionStorage;
+    ASSERT_EQ(sessionStorage.Init(&storage, 128), CHIP_NO_ERROR);
+
+    for (NodeId nodeId = 1; nodeId <= 40; ++nodeId)
+    {
+        EXPECT_EQ(SaveRecord(sessionStorage, MakeRecord(nodeId, kFabric1)), CHIP_NO_ERROR);
+        EXPECT_EQ(SaveRecord(sessionStorage, MakeRecord(nodeId, kFabric2)), CHIP_NO_ERROR);
+    }
+
+    EXPECT_EQ(sessionStorage.DeleteAll(kFabric1), CHIP_NO_ERROR);
+    EXPECT_EQ(sessionStorage.Count(), 40u);
+    for (NodeId nodeId = 1; nodeId <= 40; ++nodeId)
+    {
+        ExpectNotFound(sessionStorage, MakeRecord(nodeId, kFabric1));
+        ExpectFound(sessionStorage, MakeRecord(nodeId, kFabric2));
+    }
+
+    EXPECT_EQ(sessionStorage.DeleteAll(kFabric2), CHIP_NO_ERROR);
+    EXPECT_EQ(sessionStorage.Count(), 0u);
+    EXPECT_EQ(storage.GetNumKeys(), 1u);
+    EXPECT_TRUE(storage.HasKey(DefaultStorageKeyAllocator::SessionResumptionIndexPageCount().KeyName()));
+}
+
+TEST_F(TestIndexedSessionResumptionStorage, TestShrinkCapacity)
+{
+    TestPersistentStorageDelegate storage;
+    {
+        IndexedSessionResumptionStorage sessionStorage;
+        ASSERT_EQ(sessionStorage.Init(&storage, 80), CHIP_NO_ERROR);
+        for (NodeId nodeId = 1; nodeId <= 70; ++nodeId)
+        {
+            EXPECT_EQ(SaveRecord(sessionStorage, MakeRecord(nodeId, kFabric1)), CHIP_NO_ERROR);
+        }
+    }
+
+    // Nodes were saved into slots 0-69; only slots 0-39 fit now, in pages 0 and 1.
+    {
+        IndexedSessionResumptionStorage sessionStorage;
+        ASSERT_EQ(sessionStorage.Init(&storage, 40), CHIP_NO_ERROR);
+        EXPECT_EQ(sessionStorage.Count(), 40u);
+        for (NodeId nodeId = 1; nodeId <= 70; ++nodeId)
+        {
+            if (nodeId <= 40)
+            {
+                ExpectFound(sessionStorage, MakeRecord(nodeId, kFabric1));
+            }
+            else
+            {
+                ExpectNotFound(sessionStorage, MakeRecord(nodeId, kFabric1));
+            }
+        }
+    }
+
+    // The dropped entries are gone from storage, not just from the index: 40 state records, 2 pages and the page count.
+    for (NodeId nodeId = 41; nodeId <= 70; ++nodeId)
+    {
+        EXPECT_FALSE(storage.HasKey(DefaultStorageKeyAllocator::FabricSession(kFabric1, nodeId).KeyName()));
+    }
+    EXPECT_FALSE(storage.HasKey(DefaultStorageKeyAllocator::SessionResumptionIndexPage(2).KeyName()));
+    EXPECT_EQ(storage.GetNumKeys(), 43u);
+
+    // Growing again does not bring anything back.
+    IndexedSessionResumptionStorage sessionStorage;
+    ASSERT_EQ(sessionStorage.Init(&storage, 80), CHIP_NO_ERROR);
+    EXPECT_EQ(sessionStorage.Count(), 40u);
+}
+
+} // namespace
@@ -226,6 +226,8 @@ bool HasStringPrefix(const uint8_t * buffer, size_t len, const char * prefix)
     return len >= prefixLen && memcmp(buffer, prefix, prefixLen) == 0;
 }
 
+} // namespace
+
 CertFormat DetectCertFormat(const uint8_t * cert, uint32_t certLen)
 {
     static const uint8_t chipRawPrefix[]           = { 0x15, 0x30, 0x01 };
@@ -273,6 +275,8 @@ CertFormat DetectCertFormat(const uint8_t * cert, uint32_t certLen)
     return kCertFormat_Unknown;
 }
 
+namespace {
+
 bool SetCertSerialNumber(X509 * cert, uint64_t value = kUseRandomSerialNumber)
 {
     bool res = true;
@@ -0,0 +1,894 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements the command handler for the 'chip-cert' tool
+ *      that converts and validates a large number of CHIP certificates
+ *      in one run.
+ *
+ */
+
+#include "chip-cert.h"
+#include <credentials/CHIPCertificateSet.h>
+#include <lib/support/BytesToHex.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <dirent.h>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace chip;
+using namespace chip::ArgParser;
+using namespace chip::Credentials;
+using namespace chip::ASN1;
+
+#define CMD_NAME "chip-cert validate-cert-batch"
+
+bool HandleOption(const char * progName, OptionSet * optSet, int id, const char * name, const char * arg);
+bool HandleNonOptionArgs(const char * progName, int argc, char * const argv[]);
+
+// clang-format off
+OptionDef gCmdOptionDefs[] =
+{
+    { "cert",           kArgumentRequired,  'c' },
+    { "trusted-cert",   kArgumentRequired,  't' },
+    { "jobs",           kArgumentRequired,  'j' },
+    { "report",         kArgumentRequired,  'r' },
+    { "out-dir",        kArgumentRequired,  'o' },
+    { "out-format",     kArgumentRequired,  'F' },
+    { }
+};
+
+const char * const gCmdOptionHelp =
+    "  -c, --cert <file/str>\n"
+    "\n"
+    "       File or string containing an untrusted CHIP certificate to be used during\n"
+    "       validation of every input certificate. Usually, it is Intermediate CA\n"
+    "       certificate (ICAC) or Product Attestation Intermediate (PAI).\n"
+    "\n"
+    "  -t, --trusted-cert <file/str>\n"
+    "\n"
+    "       File or string containing a trusted CHIP certificate to be used during\n"
+    "       validation of every input certificate. Usually, it is trust anchor root\n"
+    "       certificate (RCAC). Without any trusted certificate the input certificates\n"
+    "       are only converted, and their chains are not validated.\n"
+    "\n"
+    "  -j, --jobs <int>\n"
+    "\n"
+    "       Number of certificates processed in parallel, from 1 to 256. Defaults to\n"
+    "       the number of CPU cores.\n"
+    "\n"
+    "  -r, --report <file/stdout>\n"
+    "\n"
+    "       File to write the report to, or '-' to write it to stdout, which is the\n"
+    "       default. The report has one JSON object per line for every input certificate,\n"
+    "       in input order, e.g.:\n"
+    "\n"
+    "         {\"index\":0,\"source\":\"certs.txt:1\",\"format\":\"chip-b64\",\"result\":\"valid\"}\n"
+    "\n"
+    "       where result is one of \"valid\", \"converted\" (no trusted certificate was given)\n"
+    "       or \"invalid\", in which case an \"error\" member says what failed.\n"
+    "\n"
+    "  -o, --out-dir <dir>\n"
+    "\n"
+    "       Directory to write every successfully converted certificate to, as\n"
+    "       cert-<index>.<format>. The report lists the name of each written file.\n"
+    "\n"
+    "  -F, --out-format <format>\n"
+    "\n"
+    "       Format of the certificates written to the output directory:\n"
+    "\n"
+    "         x509-pem -- X.509 PEM format\n"
+    "         x509-der -- X.509 DER raw format\n"
+    "         x509-hex -- X.509 DER hex encoded format\n"
+    "         chip     -- raw CHIP TLV format\n"
+    "         chip-b64 -- base-64 encoded CHIP TLV format (default)\n"
+    "         chip-hex -- hex encoded CHIP TLV format\n"
+    "\n"
+    ;
+
+OptionSet gCmdOptions =
+{
+    HandleOption,
+    gCmdOptionDefs,
+    "COMMAND OPTIONS",
+    gCmdOptionHelp
+};
+
+HelpOptions gHelpOptions(
+    CMD_NAME,
+    "Usage: " CMD_NAME " [ <options...> ] <file/dir>...\n",
+    CHIP_VERSION_STRING "\n" COPYRIGHT_STRING,
+    "Convert and validate a batch of CHIP certificates, spreading the work across\n"
+    "CPU cores, and write a machine-readable report.\n"
+    "\n"
+    "ARGUMENTS\n"
+    "\n"
+    "  <file/dir>\n"
+    "\n"
+    "      Files or directories holding the certificates to be processed. Every regular\n"
+    "      file in a directory is read, in name order. A file in X.509 DER or CHIP raw TLV\n"
+    "      format holds one certificate. Any other file is read line by line: every PEM\n"
+    "      block and every other non-empty line is one certificate, in any of the\n"
+    "      X.509 PEM, X.509 HEX, CHIP base-64 or CHIP HEX formats.\n"
+    "\n"
+);
+
+OptionSet * gCmdOptionSets[] =
+{
+    &gCmdOptions,
+    &gHelpOptions,
+    nullptr
+};
+// clang-format on
+
+enum
+{
+    kMaxCACerts = 16,
+    kMaxJobs    = 256,
+
+    // Number of certificates read ahead of the workers. Bounds the memory used for any number of inputs.
+    kChunkSize = 4096,
+};
+
+// Every worker's certificate set holds the CA certificates plus the certificate being validated.
+static_assert(kMaxCACerts + 1 <= UINT8_MAX, "ChipCertificateSet capacity is a uint8_t");
+
+enum BatchStatus
+{
+    kBatchStatus_Valid,
+    kBatchStatus_Converted,
+    kBatchStatus_Invalid,
+};
+
+struct CACert
+{
+    std::vector<uint8_t> chipCert;
+    bool isTrusted;
+};
+
+struct BatchItem
+{
+    std::string source;
+    std::vector<uint8_t> data;
+    bool readFailed = false;
+};
+
+struct BatchResult
+{
+    CertFormat format   = kCertFormat_Unknown;
+    BatchStatus status  = kBatchStatus_Invalid;
+    const char * stage  = nullptr; // What failed, for invalid certificates.
+    CHIP_ERROR err      = CHIP_NO_ERROR;
+    std::string outFileName;
+};
+
+const char * gCACertFileNames[kMaxCACerts] = { nullptr };
+bool gCACertIsTrusted[kMaxCACerts]         = { false };
+size_t gNumCACertFileNames                 = 0;
+uint32_t gJobs                             = 0;
+const char * gReportFileName               = "-";
+const char * gOutDirName                   = nullptr;
+CertFormat gOutCertFormat                  = kCertFormat_Default;
+char * const * gInputNames                 = nullptr;
+size_t gNumInputNames                      = 0;
+
+bool HandleOption(const char * progName, OptionSet * optSet, int id, const char * name, const char * arg)
+{
+    switch (id)
+    {
+    case 'c':
+    case 't':
+        if (gNumCACertFileNames >= kMaxCACerts)
+        {
+            PrintArgError("%s: Too many certificate files\n", progName);
+            return false;
+        }
+        gCACertFileNames[gNumCACertFileNames]   = arg;
+        gCACertIsTrusted[gNumCACertFileNames++] = (id == 't');
+        break;
+    case 'j':
+        if (!ParseInt(arg, gJobs) || gJobs == 0 || gJobs > kMaxJobs)
+        {
+            PrintArgError("%s: Invalid value specified for the number of jobs: %s\n", progName, arg);
+            return false;
+        }
+        break;
+    case 'r':
+        gReportFileName = arg;
+        break;
+    case 'o':
+        gOutDirName = arg;
+        break;
+    case 'F':
+        if (strcmp(arg, "x509-pem") == 0)
+        {
+            gOutCertFormat = kCertFormat_X509_PEM;
+        }
+        else if (strcmp(arg, "x509-der") == 0)
+        {
+            gOutCertFormat = kCertFormat_X509_DER;
+        }
+        else if (strcmp(arg, "x509-hex") == 0)
+        {
+            gOutCertFormat = kCertFormat_X509_Hex;
+        }
+        else if (strcmp(arg, "chip") == 0)
+        {
+            gOutCertFormat = kCertFormat_Chip_Raw;
+        }
+        else if (strcmp(arg, "chip-b64") == 0)
+        {
+            gOutCertFormat = kCertFormat_Chip_Base64;
+        }
+        else if (strcmp(arg, "chip-hex") == 0)
+        {
+            gOutCertFormat = kCertFormat_Chip_Hex;
+        }
+        else
+        {
+            PrintArgError("%s: Invalid value specified for the output format: %s\n", progName, arg);
+            return false;
+        }
+        break;
+    default:
+        PrintArgError("%s: Unhandled option: %s\n", progName, name);
+        return false;
+    }
+
+    return true;
+}
+
+bool HandleNonOptionArgs(const char * progName, int argc, char * const argv[])
+{
+    if (argc == 0)
+    {
+        PrintArgError("%s: Please specify the certificate files or directories to be processed.\n", progName);
+        return false;
+    }
+
+    gInputNames    = argv;
+    gNumInputNames = static_cast<size_t>(argc);
+
+    return true;
+}
+
+const char * CertFormatName(CertFormat certFmt)
+{
+    switch (certFmt)
+    {
+    case kCertFormat_X509_PEM:
+        return "x509-pem";
+    case kCertFormat_X509_DER:
+        return "x509-der";
+    case kCertFormat_X509_Hex:
+        return "x509-hex";
+    case kCertFormat_Chip_Raw:
+        return "chip";
+    case kCertFormat_Chip_Base64:
+        return "chip-b64";
+    case kCertFormat_Chip_Hex:
+        return "chip-hex";
+    default:
+        return "unknown";
+    }
+}
+
+bool IsDirectory(const char * path)
+{
+    struct stat st;
+    return stat(path, &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+/**
+ * Expand the input arguments into the list of files to read, with the regular files of every directory in name order.
+ */
+bool ExpandInputNames(std::vector<std::string> & fileNames)
+{
+    for (size_t i = 0; i < gNumInputNames; i++)
+    {
+        const char * inputName = gInputNames[i];
+
+        if (!IsDirectory(inputName))
+        {
+            fileNames.emplace_back(inputName);
+            continue;
+        }
+
+        DIR * dir = opendir(inputName);
+        if (dir == nullptr)
+        {
+            fprintf(stderr, "Unable to open %s: %s\n", inputName, strerror(errno));
+            return false;
+        }
+
+        std::vector<std::string> dirFileNames;
+        for (struct dirent * entry = readdir(dir); entry != nullptr; entry = readdir(dir))
+        {
+            std::string path = std::string(inputName) + "/" + entry->d_name;
+            struct stat st;
+            if (entry->d_name[0] != '.' && stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode))
+            {
+                dirFileNames.push_back(std::move(path));
+            }
+        }
+        closedir(dir);
+
+        std::sort(dirFileNames.begin(), dirFileNames.end());
+        fileNames.insert(fileNames.end(), dirFileNames.begin(), dirFileNames.end());
+    }
+
+    return true;
+}
+
+/**
+ * Reads the input certificates one at a time, so that only the certificates of the current chunk are held in memory.
+ */
+class CertInputStream
+{
+public:
+    explicit CertInputStream(std::vector<std::string> fileNames) : mFileNames(std::move(fileNames)) {}
+    ~CertInputStream()
+    {
+        CloseFile(mFile);
+        free(mLine);
+    }
+
+    /**
+     * Read the next certificate into `item`.
+     *
+     * @return false once every input was read.
+     */
+    bool Next(BatchItem & item)
+    {
+        item.data.clear();
+        item.readFailed = false;
+
+        while (true)
+        {
+            if (mFile == nullptr)
+            {
+                VerifyOrReturnValue(mFileIndex < mFileNames.size(), false);
+                if (!OpenNextFile(item))
+                {
+                    return true;
+                }
+                if (mFile == nullptr)
+                {
+                    // The file held a single binary certificate.
+                    return true;
+                }
+            }
+
+            if (ReadTextCert(item))
+            {
+                return true;
+            }
+
+            CloseFile(mFile);
+        }
+    }
+
+private:
+    // Open the next input file, or read it entirely if it holds one binary certificate.
+    bool OpenNextFile(BatchItem & item)
+    {
+        const std::string & fileName = mFileNames[mFileIndex++];
+        item.source                  = fileName;
+
+        // Not OpenFile(), which maps "-" to stdin: the format detection below needs a file it can rewind.
+        mFile = fopen(fileName.c_str(), "r");
+        if (mFile == nullptr)
+        {
+            fprintf(stderr, "Unable to open %s: %s\n", fileName.c_str(), strerror(errno));
+            item.readFailed = true;
+            return false;
+        }
+
+        uint8_t prefix[4];
+        const size_t prefixLen = fread(prefix, 1, sizeof(prefix), mFile);
+        const CertFormat format = DetectCertFormat(prefix, static_cast<uint32_t>(prefixLen));
+        if (format != kCertFormat_Chip_Raw && format != kCertFormat_X509_DER)
+        {
+            rewind(mFile);
+            mLineNumber = 0;
+            return true;
+        }
+
+        CloseFile(mFile);
+
+        uint32_t fileLen = 0;
+        if (!ReadFileIntoMem(fileName.c_str(), nullptr, fileLen))
+        {
+            item.readFailed = true;
+            return false;
+        }
+        item.data.resize(fileLen);
+        item.readFailed = !ReadFileIntoMem(fileName.c_str(), item.data.data(), fileLen);
+        return true;
+    }
+
+    // Read the next PEM block or non-empty line of the current text file.
+    bool ReadTextCert(BatchItem & item)
+    {
+        static const char kPEMBegin[] = "-----BEGIN CERTIFICATE-----";
+        static const char kPEMEnd[]   = "-----END CERTIFICATE-----";
+
+        bool inPEM = false;
+        ssize_t lineLen;
+
+        while ((lineLen = getline(&mLine, &mLineCapacity, mFile)) >= 0)
+        {
+            mLineNumber++;
+            while (lineLen > 0 && isspace(static_cast<unsigned char>(mLine[lineLen - 1])))
+            {
+                lineLen--;
+            }
+            if (lineLen == 0 && !inPEM)
+            {
+                continue;
+            }
+
+            if (!inPEM)
+            {
+                item.source = mFileNames[mFileIndex - 1] + ":" + std::to_string(mLineNumber);
+                inPEM       = (strncmp(mLine, kPEMBegin, sizeof(kPEMBegin) - 1) == 0);
+            }
+
+            item.data.insert(item.data.end(), mLine, mLine + lineLen);
+            if (!inPEM)
+            {
+                return true;
+            }
+
+            item.data.push_back('\n');
+            if (strncmp(mLine, kPEMEnd, sizeof(kPEMEnd) - 1) == 0)
+            {
+                return true;
+            }
+        }
+
+        // A PEM block cut short by the end of the file is still reported, and fails to decode.
+        return inPEM;
+    }
+
+    std::vector<std::string> mFileNames;
+    size_t mFileIndex     = 0;
+    FILE * mFile          = nullptr;
+    size_t mLineNumber    = 0;
+    char * mLine          = nullptr;
+    size_t mLineCapacity  = 0;
+};
+
+/**
+ * Converts and validates certificates on one thread. Every worker has its own certificate set holding the CA
+ * certificates, to which the certificate being validated is added and then removed again.
+ */
+class BatchWorker
+{
+public:
+    CHIP_ERROR Init(const std::vector<CACert> & caCerts, const ValidationContext & context)
+    {
+        mContext = context;
+        VerifyOrReturnError(caCerts.size() <= kMaxCACerts, CHIP_ERROR_INVALID_ARGUMENT);
+        ReturnErrorOnFailure(mCertSet.Init(static_cast<uint8_t>(caCerts.size() + 1)));
+
+        for (const CACert & caCert : caCerts)
+        {
+            if (caCert.isTrusted)
+            {
+                const ByteSpan chipCert(caCert.chipCert.data(), caCert.chipCert.size());
+                ReturnErrorOnFailure(mCertSet.LoadCert(chipCert, BitFlags<CertDecodeFlags>(CertDecodeFlags::kIsTrustAnchor)));
+                mHasTrustAnchor = true;
+            }
+        }
+
+        for (const CACert & caCert : caCerts)
+        {
+            if (!caCert.isTrusted)
+            {
+                const ByteSpan chipCert(caCert.chipCert.data(), caCert.chipCert.size());
+                BitFlags<CertDecodeFlags> decodeFlags(CertDecodeFlags::kGenerateTBSHash);
+                if (IsSignedByTrustAnchor(chipCert))
+                {
+                    // Spares every validation below the intermediate the check of the intermediate's signature.
+                    decodeFlags.Set(CertDecodeFlags::kSignatureVerified);
+                }
+                ReturnErrorOnFailure(mCertSet.LoadCert(chipCert, decodeFlags));
+            }
+        }
+
+        return CHIP_NO_ERROR;
+    }
+
+    void Process(const BatchItem & item, size_t index, BatchResult & result)
+    {
+        result = BatchResult();
+
+        if (item.readFailed)
+        {
+            Fail(result, "read", CHIP_ERROR_READ_FAILED);
+            return;
+        }
+
+        VerifyOrReturn(CanCastTo<uint32_t>(item.data.size()), Fail(result, "read", CHIP_ERROR_BUFFER_TOO_SMALL));
+        result.format = DetectCertFormat(item.data.data(), static_cast<uint32_t>(item.data.size()));
+
+        MutableByteSpan x509Cert(mX509CertBuf);
+        MutableByteSpan chipCert(mChipCertBuf);
+
+        CHIP_ERROR err = Decode(item, result.format, x509Cert, chipCert);
+        VerifyOrReturn(err == CHIP_NO_ERROR, Fail(result, "decode", err));
+
+        // Convert to the form that was not given, which also checks that the certificate fits the CHIP profile.
+        if (IsChipCertFormat(result.format))
+        {
+            err = ConvertChipCertToX509Cert(chipCert, x509Cert);
+        }
+        else
+        {
+            err = ConvertX509CertToChipCert(x509Cert, chipCert);
+        }
+        VerifyOrReturn(err == CHIP_NO_ERROR, Fail(result, "convert", err));
+
+        if (gOutDirName != nullptr)
+        {
+            VerifyOrReturn(WriteOutput(index, x509Cert, chipCert, result), Fail(result, "write", CHIP_ERROR_WRITE_FAILED));
+        }
+
+        if (!mHasTrustAnchor)
+        {
+            result.status = kBatchStatus_Converted;
+            return;
+        }
+
+        err = Validate(chipCert);
+        VerifyOrReturn(err == CHIP_NO_ERROR, Fail(result, "validate", err));
+
+        result.status = kBatchStatus_Valid;
+    }
+
+private:
+    static void Fail(BatchResult & result, const char * stage, CHIP_ERROR err)
+    {
+        result.status = kBatchStatus_Invalid;
+        result.stage  = stage;
+        result.err    = err;
+    }
+
+    // Decode the input into X.509 DER form for the X.509 formats, or into CHIP TLV form for the CHIP ones.
+    CHIP_ERROR Decode(const BatchItem & item, CertFormat format, MutableByteSpan & x509Cert, MutableByteSpan & chipCert)
+    {
+        const uint8_t * data = item.data.data();
+        const size_t dataLen = item.data.size();
+
+        switch (format)
+        {
+        case kCertFormat_X509_DER:
+            return CopySpanToMutableSpan(ByteSpan(data, dataLen), x509Cert);
+
+        case kCertFormat_Chip_Raw:
+            return CopySpanToMutableSpan(ByteSpan(data, dataLen), chipCert);
+
+        case kCertFormat_X509_Hex:
+        case kCertFormat_Chip_Hex: {
+            MutableByteSpan & out = (format == kCertFormat_X509_Hex) ? x509Cert : chipCert;
+            VerifyOrReturnError(dataLen <= 2 * out.size(), CHIP_ERROR_BUFFER_TOO_SMALL);
+            const size_t len = Encoding::HexToBytes(Uint8::to_const_char(data), dataLen, out.data(), out.size());
+            VerifyOrReturnError(len != 0 && 2 * len == dataLen, CHIP_ERROR_INVALID_ARGUMENT);
+            out.reduce_size(len);
+            return CHIP_NO_ERROR;
+        }
+
+        case kCertFormat_Chip_Base64: {
+            VerifyOrReturnError(dataLen <= BASE64_ENCODED_LEN(chipCert.size()), CHIP_ERROR_BUFFER_TOO_SMALL);
+            const uint32_t len = Base64Decode32(Uint8::to_const_char(data), static_cast<uint32_t>(dataLen), chipCert.data());
+            VerifyOrReturnError(len != UINT32_MAX, CHIP_ERROR_INVALID_ARGUMENT);
+            chipCert.reduce_size(len);
+            return CHIP_NO_ERROR;
+        }
+
+        case kCertFormat_X509_PEM: {
+            VerifyOrReturnError(CanCastTo<int>(dataLen), CHIP_ERROR_BUFFER_TOO_SMALL);
+            std::unique_ptr<BIO, void (*)(BIO *)> certBIO(BIO_new_mem_buf(data, static_cast<int>(dataLen)), &BIO_free_all);
+            VerifyOrReturnError(certBIO, CHIP_ERROR_NO_MEMORY);
+            std::unique_ptr<X509, void (*)(X509 *)> cert(PEM_read_bio_X509(certBIO.get(), nullptr, nullptr, nullptr), &X509_free);
+            VerifyOrReturnError(cert, CHIP_ERROR_INVALID_ARGUMENT);
+
+            const int len = i2d_X509(cert.get(), nullptr);
+            VerifyOrReturnError(len > 0, CHIP_ERROR_INVALID_ARGUMENT);
+            VerifyOrReturnError(static_cast<size_t>(len) <= x509Cert.size(), CHIP_ERROR_BUFFER_TOO_SMALL);
+            uint8_t * out = x509Cert.data();
+            VerifyOrReturnError(i2d_X509(cert.get(), &out) == len, CHIP_ERROR_INTERNAL);
+            x509Cert.reduce_size(static_cast<size_t>(len));
+            return CHIP_NO_ERROR;
+        }
+
+        default:
+            return CHIP_ERROR_UNSUPPORTED_CERT_FORMAT;
+        }
+    }
+
+    bool WriteOutput(size_t index, const ByteSpan & x509Cert, const ByteSpan & chipCert, BatchResult & result)
+    {
+        char fileName[PATH_MAX];
+        int len = snprintf(fileName, sizeof(fileName), "%s/cert-%08zu.%s", gOutDirName, index, CertFormatName(gOutCertFormat));
+        VerifyOrReturnError(len > 0 && static_cast<size_t>(len) < sizeof(fileName), false);
+
+        if (IsChipCertFormat(gOutCertFormat))
+        {
+            VerifyOrReturnError(WriteChipCert(fileName, chipCert, gOutCertFormat), false);
+        }
+        else if (gOutCertFormat == kCertFormat_X509_PEM)
+        {
+            VerifyOrReturnError(CanCastTo<long>(x509Cert.size()), false);
+            const uint8_t * der = x509Cert.data();
+            std::unique_ptr<X509, void (*)(X509 *)> cert(d2i_X509(nullptr, &der, static_cast<long>(x509Cert.size())), &X509_free);
+            VerifyOrReturnError(cert && WriteCert(fileName, cert.get(), gOutCertFormat), false);
+        }
+        else
+        {
+            DataFormat dataFmt = (gOutCertFormat == kCertFormat_X509_Hex) ? kDataFormat_Hex : kDataFormat_Raw;
+            VerifyOrReturnError(WriteDataIntoFile(fileName, x509Cert.data(), x509Cert.size(), dataFmt), false);
+        }
+
+        result.outFileName = fileName;
+        return true;
+    }
+
+    bool IsSignedByTrustAnchor(const ByteSpan & chipCert)
+    {
+        ChipCertificateData certData;
+        VerifyOrReturnValue(DecodeChipCert(chipCert, certData, BitFlags<CertDecodeFlags>(CertDecodeFlags::kGenerateTBSHash)) ==
+                                CHIP_NO_ERROR,
+                            false);
+
+        const ChipCertificateData * issuer = mCertSet.FindCert(certData.mAuthKeyId);
+        return issuer != nullptr && issuer->mCertFlags.Has(CertFlags::kIsTrustAnchor) &&
+            VerifyCertSignature(certData, *issuer) == CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR Validate(const ByteSpan & chipCert)
+    {
+        const uint8_t certCount = mCertSet.GetCertCount();
+
+        ReturnErrorOnFailure(mCertSet.LoadCert(chipCert, BitFlags<CertDecodeFlags>(CertDecodeFlags::kGenerateTBSHash)));
+
+        // LoadCert() skips a certificate that is already in the set, i.e. one of the CA certificates.
+        const bool added                       = (mCertSet.GetCertCount() != certCount);
+        const ChipCertificateData * certToFind = added ? mCertSet.GetLastCert() : nullptr;
+        ChipCertificateData certData;
+        if (!added)
+        {
+            ReturnErrorOnFailure(DecodeChipCert(chipCert, certData));
+            certToFind = &certData;
+        }
+
+        ValidationContext context             = mContext;
+        const ChipCertificateData * validCert = nullptr;
+        CHIP_ERROR err = mCertSet.FindValidCert(certToFind->mSubjectDN, certToFind->mSubjectKeyId, context, &validCert);
+
+        if (added)
+        {
+            mCertSet.ReleaseLastCert();
+        }
+        return err;
+    }
+
+    ChipCertificateSet mCertSet;
+    ValidationContext mContext;
+    bool mHasTrustAnchor = false;
+    uint8_t mX509CertBuf[kMaxDERCertLength];
+    uint8_t mChipCertBuf[kMaxCHIPCertLength];
+};
+
+void WriteJSONString(FILE * file, const char * str)
+{
+    fputc('"', file);
+    for (; *str != 0; str++)
+    {
+        const unsigned char c = static_cast<unsigned char>(*str);
+        if (c == '"' || c == '\\')
+        {
+            fprintf(file, "\\%c", c);
+        }
+        else if (c < 0x20)
+        {
+            fprintf(file, "\\u%04x", c);
+        }
+        else
+        {
+            fputc(c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+void WriteReportLine(FILE * file, size_t index, const BatchItem & item, const BatchResult & result)
+{
+    static const char * const kStatusNames[] = { "valid", "converted", "invalid" };
+
+    fprintf(file, "{\"index\":%zu,\"source\":", index);
+    WriteJSONString(file, item.source.c_str());
+    fprintf(file, ",\"format\":\"%s\",\"result\":\"%s\"", CertFormatName(result.format), kStatusNames[result.status]);
+    if (result.status == kBatchStatus_Invalid)
+    {
+        // ErrorStr() is not thread-safe, so errors are only turned into text here, on the main thread.
+        char error[256];
+        snprintf(error, sizeof(error), "%s: %s", result.stage, ErrorStr(result.err));
+        fputs(",\"error\":", file);
+        WriteJSONString(file, error);
+    }
+    if (!result.outFileName.empty())
+    {
+        fputs(",\"output\":", file);
+        WriteJSONString(file, result.outFileName.c_str());
+    }
+    fputs("}\n", file);
+}
+
+bool LoadCACerts(std::vector<CACert> & caCerts)
+{
+    for (size_t i = 0; i < gNumCACertFileNames; i++)
+    {
+        std::unique_ptr<X509, void (*)(X509 *)> cert(nullptr, &X509_free);
+        uint8_t chipCertBuf[kMaxCHIPCertLength];
+        MutableByteSpan chipCert(chipCertBuf);
+
+        VerifyOrReturnError(ReadCert(gCACertFileNames[i], cert), false);
+        VerifyOrReturnError(X509ToChipCert(cert.get(), chipCert), false);
+
+        caCerts.push_back({ std::vector<uint8_t>(chipCert.data(), chipCert.data() + chipCert.size()), gCACertIsTrusted[i] });
+    }
+    return true;
+}
+
+} // namespace
+
+bool Cmd_ValidateCertBatch(int argc, char * argv[])
+{
+    bool res       = true;
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    FILE * report  = nullptr;
+    std::vector<CACert> caCerts;
+    std::vector<std::string> fileNames;
+    std::vector<std::unique_ptr<BatchWorker>> workers;
+    std::vector<BatchItem> items(kChunkSize);
+    std::vector<BatchResult> results(kChunkSize);
+    ValidationContext context;
+    uint32_t currentTime;
+    size_t counts[3]     = { 0, 0, 0 };
+    size_t processed     = 0;
+    uint32_t jobs        = 0;
+    const auto startTime = std::chrono::steady_clock::now();
+
+    // Start from the defaults, so that the command can run more than once in a process.
+    gNumCACertFileNames = 0;
+    gJobs               = 0;
+    gReportFileName     = "-";
+    gOutDirName         = nullptr;
+    gOutCertFormat      = kCertFormat_Default;
+
+    if (argc == 1)
+    {
+        gHelpOptions.PrintBriefUsage(stderr);
+        ExitNow(res = true);
+    }
+
+    res = ParseArgs(CMD_NAME, argc, argv, gCmdOptionSets, HandleNonOptionArgs);
+    VerifyTrueOrExit(res);
+
+    res = InitOpenSSL();
+    VerifyTrueOrExit(res);
+
+    res = LoadCACerts(caCerts);
+    VerifyTrueOrExit(res);
+
+    res = ExpandInputNames(fileNames);
+    VerifyTrueOrExit(res);
+
+    context.Reset();
+    res = chip::UnixEpochToChipEpochTime(static_cast<uint32_t>(time(nullptr)), currentTime);
+    VerifyTrueOrExit(res);
+    context.mEffectiveTime.Set<CurrentChipEpochTime>(currentTime);
+    context.mRequiredKeyUsages.Set(KeyUsageFlags::kDigitalSignature);
+
+    jobs = (gJobs != 0) ? gJobs : std::max(1u, std::min(static_cast<uint32_t>(std::thread::hardware_concurrency()),
+                                                         static_cast<uint32_t>(kMaxJobs)));
+    for (uint32_t i = 0; i < jobs; i++)
+    {
+        workers.push_back(std::make_unique<BatchWorker>());
+        err = workers.back()->Init(caCerts, context);
+        if (err != CHIP_NO_ERROR)
+        {
+            fprintf(stderr, "Failed to initialize certificate set: %s\n", chip::ErrorStr(err));
+            ExitNow(res = false);
+        }
+    }
+
+    res = OpenFile(gReportFileName, report, true);
+    VerifyTrueOrExit(res);
+
+    {
+        CertInputStream input(std::move(fileNames));
+
+        while (true)
+        {
+            size_t count = 0;
+            while (count < kChunkSize && input.Next(items[count]))
+            {
+                count++;
+            }
+            if (count == 0)
+            {
+                break;
+            }
+
+            std::atomic<size_t> nextItem{ 0 };
+            std::vector<std::thread> threads;
+            for (uint32_t i = 0; i < jobs; i++)
+            {
+                threads.emplace_back([&, i] {
+                    for (size_t item = nextItem++; item < count; item = nextItem++)
+                    {
+                        workers[i]->Process(items[item], processed + item, results[item]);
+                    }
+                });
+            }
+            for (std::thread & thread : threads)
+            {
+                thread.join();
+            }
+
+            for (size_t i = 0; i < count; i++)
+            {
+                WriteReportLine(report, processed + i, items[i], results[i]);
+                counts[results[i].status]++;
+            }
+            processed += count;
+        }
+    }
+
+    {
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        fprintf(stderr, "Processed %zu certificates in %.3f s (%.0f certificates/s) using %u jobs\n", processed, seconds,
+                (seconds > 0) ? static_cast<double>(processed) / seconds : 0.0, jobs);
+        fprintf(stderr, "%zu valid, %zu converted, %zu invalid\n", counts[kBatchStatus_Valid], counts[kBatchStatus_Converted],
+                counts[kBatchStatus_Invalid]);
+    }
+
+    res = (counts[kBatchStatus_Invalid] == 0);
+
+exit:
+    if (report == stdout)
+    {
+        fflush(report);
+    }
+    else
+    {
+        CloseFile(report);
+    }
+    return res;
+}
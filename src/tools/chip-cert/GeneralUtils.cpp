@@ -51,6 +51,9 @@ bool InitOpenSSL()
 {
     bool res = true;
 
+    // The CHIP OIDs can only be registered once per process.
+    VerifyOrReturnError(gNIDChipNodeId == 0, true);
+
     OPENSSL_malloc_init();
 
     ERR_load_crypto_strings();
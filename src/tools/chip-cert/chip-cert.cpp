@@ -56,6 +56,8 @@ const char * const sHelp =
     "\n"
     "    validate-cert -- Validate a CHIP certificate chain.\n"
     "\n"
+    "    validate-cert-batch -- Convert and validate a batch of CHIP certificates in parallel.\n"
+    "\n"
     "    print-cert -- Print a CHIP certificate.\n"
     "\n"
     "    gen-att-cert -- Generate a CHIP attestation certificate.\n"
@@ -123,6 +125,10 @@ int main(int argc, char * argv[])
     {
         res = Cmd_ValidateCert(argc - 1, argv + 1);
     }
+    else if (strcasecmp(argv[1], "validate-cert-batch") == 0 || strcasecmp(argv[1], "validatecertbatch") == 0)
+    {
+        res = Cmd_ValidateCertBatch(argc - 1, argv + 1);
+    }
     else if (strcasecmp(argv[1], "print-cert") == 0 || strcasecmp(argv[1], "printcert") == 0)
     {
         res = Cmd_PrintCert(argc - 1, argv + 1);
@@ -0,0 +1,176 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Runs 'chip-cert validate-cert-batch' over certificates written to a temporary directory.
+ */
+
+#include <credentials/tests/CHIPCert_test_vectors.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/Span.h>
+#include <tools/chip-cert/chip-cert.h>
+
+#include <pw_unit_test/framework.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using namespace chip;
+using namespace chip::TestCerts;
+
+class TestValidateCertBatch : public ::testing::Test
+{
+public:
+    static void SetUpTestSuite() { ASSERT_EQ(chip::Platform::MemoryInit(), CHIP_NO_ERROR); }
+    static void TearDownTestSuite() { chip::Platform::MemoryShutdown(); }
+
+    void SetUp() override
+    {
+        char dirTemplate[] = "/tmp/chip-cert-batch-XXXXXX";
+        ASSERT_NE(mkdtemp(dirTemplate), nullptr);
+        mDir = dirTemplate;
+
+        mRootCert   = WriteFile("root.der", sTestCert_Root01_DER);
+        mICACert    = WriteFile("ica.der", sTestCert_ICA01_DER);
+        mReportFile = mDir + "/report.jsonl";
+
+        mInputDir = mDir + "/in";
+        ASSERT_EQ(mkdir(mInputDir.c_str(), 0700), 0);
+    }
+
+    void TearDown() override
+    {
+        for (const std::string & file : mFiles)
+        {
+            unlink(file.c_str());
+        }
+        unlink(mReportFile.c_str());
+        rmdir(mInputDir.c_str());
+        rmdir(mDir.c_str());
+    }
+
+protected:
+    std::string WriteFile(const std::string & name, const ByteSpan & data)
+    {
+        std::string path = mDir + "/" + name;
+        FILE * file      = fopen(path.c_str(), "wb");
+        EXPECT_NE(file, nullptr);
+        if (file != nullptr)
+        {
+            EXPECT_EQ(fwrite(data.data(), 1, data.size(), file), data.size());
+            fclose(file);
+        }
+        mFiles.push_back(path);
+        return path;
+    }
+
+    std::string WriteInput(const std::string & name, const ByteSpan & data) { return WriteFile("in/" + name, data); }
+
+    bool Run(std::vector<std::string> args)
+    {
+        args.insert(args.begin(), "validate-cert-batch");
+        std::vector<char *> argv;
+        for (std::string & arg : args)
+        {
+            argv.push_back(&arg[0]);
+        }
+        argv.push_back(nullptr);
+        return Cmd_ValidateCertBatch(static_cast<int>(args.size()), argv.data());
+    }
+
+    std::vector<std::string> ReadReport()
+    {
+        std::vector<std::string> lines;
+        FILE * file = fopen(mReportFile.c_str(), "r");
+        EXPECT_NE(file, nullptr);
+        if (file != nullptr)
+        {
+            char line[1024];
+            while (fgets(line, sizeof(line), file) != nullptr)
+            {
+                lines.emplace_back(line);
+            }
+            fclose(file);
+        }
+        return lines;
+    }
+
+    static bool Contains(const std::string & line, const char * text) { return line.find(text) != std::string::npos; }
+
+    std::string mDir;
+    std::string mInputDir;
+    std::string mRootCert;
+    std::string mICACert;
+    std::string mReportFile;
+    std::vector<std::string> mFiles;
+};
+
+TEST_F(TestValidateCertBatch, ValidatesEveryInputInOrder)
+{
+    // Read in name order: a chain through the ICA, one straight under the root, and one from another fabric's root.
+    WriteInput("1-node01_01.der", sTestCert_Node01_01_DER);
+    WriteInput("2-node01_02.chip", sTestCert_Node01_02_Chip);
+    WriteInput("3-node02_01.chip", sTestCert_Node02_01_Chip);
+
+    EXPECT_FALSE(Run({ "--trusted-cert", mRootCert, "--cert", mICACert, "--jobs", "2", "--report", mReportFile, mInputDir }));
+
+    std::vector<std::string> report = ReadReport();
+    ASSERT_EQ(report.size(), 3u);
+    EXPECT_TRUE(Contains(report[0], "\"index\":0,"));
+    EXPECT_TRUE(Contains(report[0], "\"format\":\"x509-der\",\"result\":\"valid\""));
+    EXPECT_TRUE(Contains(report[1], "\"index\":1,"));
+    EXPECT_TRUE(Contains(report[1], "\"format\":\"chip\",\"result\":\"valid\""));
+    EXPECT_TRUE(Contains(report[2], "\"index\":2,"));
+    EXPECT_TRUE(Contains(report[2], "\"result\":\"invalid\",\"error\":\"validate: "));
+}
+
+TEST_F(TestValidateCertBatch, ConvertsWithoutTrustedCert)
+{
+    WriteInput("node01_01.der", sTestCert_Node01_01_DER);
+    WriteInput("node01_02.der", sTestCert_Node01_02_DER);
+
+    EXPECT_TRUE(Run({ "--jobs", "1", "--report", mReportFile, mInputDir }));
+
+    std::vector<std::string> report = ReadReport();
+    ASSERT_EQ(report.size(), 2u);
+    EXPECT_TRUE(Contains(report[0], "\"result\":\"converted\""));
+    EXPECT_TRUE(Contains(report[1], "\"result\":\"converted\""));
+}
+
+TEST_F(TestValidateCertBatch, RejectsJobsOutOfRange)
+{
+    WriteInput("node01_02.der", sTestCert_Node01_02_DER);
+
+    for (const char * jobs : { "0", "257", "4294967296", "-1", "2x", "" })
+    {
+        EXPECT_FALSE(Run({ "--trusted-cert", mRootCert, "--jobs", jobs, "--report", mReportFile, mInputDir })) << jobs;
+    }
+
+    // The bounds themselves are accepted.
+    EXPECT_TRUE(Run({ "--trusted-cert", mRootCert, "--jobs", "1", "--report", mReportFile, mInputDir }));
+    EXPECT_TRUE(Run({ "--trusted-cert", mRootCert, "--jobs", "256", "--report", mReportFile, mInputDir }));
+}
+
+} // namespace
@@ -78,5 +78,11 @@ constexpr MetricKey kMetricDeviceRMPRetryCount = "core_dev_rmp_retry_count";
 // Subscription setup
 constexpr MetricKey kMetricDeviceSubscriptionSetup = "core_dev_subscription_setup";
 
+// Number of operational session setups waiting for a CASE establishment slot
+constexpr MetricKey kMetricCASEEstablishmentQueueDepth = "core_case_sched_queue_depth";
+
+// Milliseconds from a session setup first asking for a CASE establishment slot to having a session
+constexpr MetricKey kMetricCASEEstablishmentTimeToSession = "core_case_sched_time_to_session";
+
 } // namespace Tracing
 } // namespace chip
@@ -261,6 +261,70 @@ CHIP_ERROR CryptoContext::Decrypt(const uint8_t * input, size_t input_length, ui
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR CryptoContext::Encrypt(Span<const MutableByteSpan> buffers, ConstNonceView nonce, PacketHeader & header,
+                                  MessageAuthenticationCode & mac) const
+{
+    if (buffers.size() == 1)
+    {
+        return Encrypt(buffers[0].data(), buffers[0].size(), buffers[0].data(), nonce, header, mac);
+    }
+
+    const size_t taglen = header.MICTagLength();
+
+    VerifyOrDie(taglen <= kMaxTagLen);
+
+    size_t length = 0;
+    for (const MutableByteSpan & buffer : buffers)
+    {
+        length += buffer.size();
+    }
+    VerifyOrReturnError(length > 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    VerifyOrReturnError(mKeyContext == nullptr, CHIP_ERROR_NOT_IMPLEMENTED);
+    VerifyOrReturnError(mKeyAvailable, CHIP_ERROR_INVALID_USE_OF_SESSION_KEY);
+
+    uint8_t AAD[kMaxAADLen];
+    uint16_t aadLen = sizeof(AAD);
+    uint8_t tag[kMaxTagLen];
+
+    ReturnErrorOnFailure(GetAdditionalAuthData(header, AAD, aadLen));
+    ReturnErrorOnFailure(AES_CCM_encrypt_buffers(buffers.data(), buffers.size(), AAD, aadLen, mEncryptionKey, nonce.data(),
+                                                 nonce.size(), tag, taglen));
+
+    mac.SetTag(&header, tag, taglen);
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CryptoContext::Decrypt(Span<const MutableByteSpan> buffers, ConstNonceView nonce, const PacketHeader & header,
+                                  const MessageAuthenticationCode & mac) const
+{
+    if (buffers.size() == 1)
+    {
+        return Decrypt(buffers[0].data(), buffers[0].size(), buffers[0].data(), nonce, header, mac);
+    }
+
+    const size_t taglen = header.MICTagLength();
+    const uint8_t * tag = mac.GetTag();
+    uint8_t AAD[kMaxAADLen];
+    uint16_t aadLen = sizeof(AAD);
+
+    size_t length = 0;
+    for (const MutableByteSpan & buffer : buffers)
+    {
+        length += buffer.size();
+    }
+    VerifyOrReturnError(length > 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    VerifyOrReturnError(mKeyContext == nullptr, CHIP_ERROR_NOT_IMPLEMENTED);
+    VerifyOrReturnError(mKeyAvailable, CHIP_ERROR_INVALID_USE_OF_SESSION_KEY);
+
+    ReturnErrorOnFailure(GetAdditionalAuthData(header, AAD, aadLen));
+
+    return AES_CCM_decrypt_buffers(buffers.data(), buffers.size(), AAD, aadLen, tag, taglen, mDecryptionKey, nonce.data(),
+                                   nonce.size());
+}
+
 CHIP_ERROR CryptoContext::PrivacyEncrypt(const uint8_t * input, size_t input_length, uint8_t * output, PacketHeader & header,
                                          MessageAuthenticationCode & mac) const
 {
@@ -146,6 +146,38 @@ public:
     CHIP_ERROR Decrypt(const uint8_t * input, size_t input_length, uint8_t * output, ConstNonceView nonce,
                        const PacketHeader & header, const MessageAuthenticationCode & mac) const;
 
+    /**
+     * @brief
+     *   Encrypt, in place, a message spread over several buffers using keys established in the secure channel
+     *
+     * Group key contexts only support a single buffer.
+     *
+     * @param buffers Buffers holding the unencrypted message, in order. Replaced with the encrypted message.
+     * @param nonce Nonce buffer for encrypt
+     * @param header message header structure. Encryption type will be set on the header.
+     * @param mac - output the resulting mac
+     *
+     * @return CHIP_ERROR The result of encryption
+     */
+    CHIP_ERROR Encrypt(Span<const MutableByteSpan> buffers, ConstNonceView nonce, PacketHeader & header,
+                       MessageAuthenticationCode & mac) const;
+
+    /**
+     * @brief
+     *   Decrypt, in place, a message spread over several buffers using keys established in the secure channel
+     *
+     * Group key contexts only support a single buffer.
+     *
+     * @param buffers Buffers holding the encrypted message, in order. Replaced with the decrypted message.
+     * @param nonce Nonce buffer for decrypt
+     * @param header message header structure
+     * @param mac Input mac
+     *
+     * @return CHIP_ERROR The result of decryption
+     */
+    CHIP_ERROR Decrypt(Span<const MutableByteSpan> buffers, ConstNonceView nonce, const PacketHeader & header,
+                       const MessageAuthenticationCode & mac) const;
+
     CHIP_ERROR PrivacyEncrypt(const uint8_t * input, size_t input_length, uint8_t * output, PacketHeader & header,
                               MessageAuthenticationCode & mac) const;
 
@@ -36,24 +36,43 @@ using System::PacketBufferHandle;
 
 namespace SecureMessageCodec {
 
+namespace {
+
+// Longest buffer chain Encrypt() accepts
+constexpr size_t kMaxEncryptedBufferChainLength = 16;
+
+} // namespace
+
 CHIP_ERROR Encrypt(const CryptoContext & context, CryptoContext::ConstNonceView nonce, PayloadHeader & payloadHeader,
                    PacketHeader & packetHeader, System::PacketBufferHandle & msgBuf)
 {
     VerifyOrReturnError(!msgBuf.IsNull(), CHIP_ERROR_INVALID_ARGUMENT);
-    VerifyOrReturnError(!msgBuf->HasChainedBuffer(), CHIP_ERROR_INVALID_MESSAGE_LENGTH);
 
     ReturnErrorOnFailure(payloadHeader.EncodeBeforeData(msgBuf));
 
-    uint8_t * data  = msgBuf->Start();
-    size_t totalLen = msgBuf->TotalLength();
+    // Each buffer of a chain is encrypted in place, the message is never consolidated.
+    MutableByteSpan buffers[kMaxEncryptedBufferChainLength];
+    size_t bufferCount      = 0;
+    PacketBufferHandle last = msgBuf.Retain();
+    while (true)
+    {
+        VerifyOrReturnError(bufferCount < ArraySize(buffers), CHIP_ERROR_INVALID_MESSAGE_LENGTH);
+        buffers[bufferCount++] = MutableByteSpan(last->Start(), last->DataLength());
+        if (!last->HasChainedBuffer())
+        {
+            break;
+        }
+        last.Advance();
+    }
 
     MessageAuthenticationCode mac;
-    ReturnErrorOnFailure(context.Encrypt(data, totalLen, data, nonce, packetHeader, mac));
+    ReturnErrorOnFailure(context.Encrypt(Span<const MutableByteSpan>(buffers, bufferCount), nonce, packetHeader, mac));
 
+    // The MIC follows the data of the last buffer
     uint16_t taglen = 0;
-    ReturnErrorOnFailure(mac.Encode(packetHeader, &data[totalLen], msgBuf->AvailableDataLength(), &taglen));
+    ReturnErrorOnFailure(mac.Encode(packetHeader, last->Start() + last->DataLength(), last->AvailableDataLength(), &taglen));
 
-    msgBuf->SetDataLength(totalLen + taglen);
+    last->SetDataLength(last->DataLength() + taglen, msgBuf);
 
     return CHIP_NO_ERROR;
 }
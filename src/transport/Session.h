@@ -205,7 +205,12 @@ class OutgoingGroupSession;
 class Session
 {
 public:
-    virtual ~Session() {}
+    virtual ~Session()
+    {
+#if INET_CONFIG_ENABLE_TCP_ENDPOINT
+        SetTCPConnection(nullptr);
+#endif // INET_CONFIG_ENABLE_TCP_ENDPOINT
+    }
 
     enum class SessionType : uint8_t
     {
@@ -296,8 +301,24 @@ public:
     // latter is about to be marked active. It is also used to reset the
     // connection to a nullptr when the connection is lost and the session
     // is marked as Defunct.
+    //
+    // The session holds the connection it is associated with, which keeps
+    // the transport from evicting it, until it is reset or the session goes
+    // away.
     ActiveTCPConnectionState * GetTCPConnection() const { return mTCPConnection; }
-    void SetTCPConnection(ActiveTCPConnectionState * conn) { mTCPConnection = conn; }
+    void SetTCPConnection(ActiveTCPConnectionState * conn)
+    {
+        VerifyOrReturn(conn != mTCPConnection);
+        if (mTCPConnection != nullptr)
+        {
+            mTCPConnection->ReleaseHolder();
+        }
+        mTCPConnection = conn;
+        if (mTCPConnection != nullptr)
+        {
+            mTCPConnection->AddHolder();
+        }
+    }
 #endif // INET_CONFIG_ENABLE_TCP_ENDPOINT
 
     void NotifySessionHang()
@@ -730,6 +730,7 @@ void SessionManager::HandleConnectionClosed(Transport::ActiveTCPConnectionState
     VerifyOrReturn(conn != nullptr);
 
     MarkSecureSessionOverTCPForEviction(conn, conErr);
+    mUnauthenticatedSessions.ReleaseTCPConnection(conn);
 
     // TODO: A mechanism to mark an unauthenticated session as unusable when
     // the underlying connection is broken. Issue #32323
@@ -1362,6 +1363,12 @@ void SessionManager::MarkSecureSessionOverTCPForEviction(Transport::ActiveTCPCon
             // Mark session for eviction.
             session->MarkForEviction();
         }
+        else if (session->GetTCPConnection() == conn)
+        {
+            // Sessions that are not active only drop their pointer to the
+            // connection state that is going away.
+            session->SetTCPConnection(nullptr);
+        }
 
         return Loop::Continue;
     });
@@ -166,6 +166,12 @@ public:
 
     static void Release(UnauthenticatedSession * obj)
     {
+#if INET_CONFIG_ENABLE_TCP_ENDPOINT
+        // Nobody uses the session anymore, so it should not keep its connection
+        // from being evicted while it waits to be reused.
+        obj->SetTCPConnection(nullptr);
+#endif // INET_CONFIG_ENABLE_TCP_ENDPOINT
+
         // When using heap pools, we need to make sure to release ourselves back to
         // the pool.  When not using heap pools, we don't want the extra cost of the
         // table pointer here, and the table itself handles entry reuse and cleanup
@@ -296,6 +302,20 @@ public:
         return Optional<SessionHandle>::Missing();
     }
 
+#if INET_CONFIG_ENABLE_TCP_ENDPOINT
+    // Dissociate the sessions from a connection that is being closed.
+    void ReleaseTCPConnection(ActiveTCPConnectionState * conn)
+    {
+        mEntries.ForEachActiveObject([&](UnauthenticatedSession * entry) {
+            if (entry->GetTCPConnection() == conn)
+            {
+                entry->SetTCPConnection(nullptr);
+            }
+            return Loop::Continue;
+        });
+    }
+#endif // INET_CONFIG_ENABLE_TCP_ENDPOINT
+
 private:
     using EntryType = detail::UnauthenticatedSessionPoolEntry<kMaxSessionCount>;
     friend EntryType;
@@ -27,6 +27,7 @@
 #include <inet/InetInterface.h>
 #include <inet/TCPEndPoint.h>
 #include <lib/core/CHIPCore.h>
+#include <system/SystemClock.h>
 #include <transport/raw/PeerAddress.h>
 #include <transport/raw/TCPConfig.h>
 
@@ -54,10 +55,13 @@ struct ActiveTCPConnectionState
 
     void Init(Inet::TCPEndPoint * endPoint, const PeerAddress & peerAddr)
     {
-        mEndPoint = endPoint;
-        mPeerAddr = peerAddr;
-        mReceived = nullptr;
-        mAppState = nullptr;
+        mEndPoint     = endPoint;
+        mPeerAddr     = peerAddr;
+        mReceived     = nullptr;
+        mAppState     = nullptr;
+        mIdleTimeout  = System::Clock::Seconds32(CHIP_CONFIG_TCP_IDLE_TIMEOUT_SECS);
+        mHolderCount  = 0;
+        mReusePending = false;
     }
 
     void Free()
@@ -66,14 +70,30 @@ struct ActiveTCPConnectionState
         {
             mEndPoint->Free();
         }
-        mPeerAddr = PeerAddress::Uninitialized();
-        mEndPoint = nullptr;
-        mReceived = nullptr;
-        mAppState = nullptr;
+        mPeerAddr     = PeerAddress::Uninitialized();
+        mEndPoint     = nullptr;
+        mReceived     = nullptr;
+        mAppState     = nullptr;
+        mHolderCount  = 0;
+        mReusePending = false;
     }
 
     bool InUse() const { return mEndPoint != nullptr; }
 
+    // Sessions register themselves through Session::SetTCPConnection while
+    // they send over the connection.
+    void AddHolder() { mHolderCount++; }
+    void ReleaseHolder()
+    {
+        // The count restarts when the connection is closed, so a session that
+        // still points at a closed connection must not take it below zero.
+        if (mHolderCount > 0)
+        {
+            mHolderCount--;
+        }
+    }
+    bool IsHeld() const { return mHolderCount > 0; }
+
     bool IsConnected() const { return (mEndPoint != nullptr && mConnectionState == TCPState::kConnected); }
 
     bool IsConnecting() const { return (mEndPoint != nullptr && mConnectionState == TCPState::kConnecting); }
@@ -103,6 +123,27 @@ struct ActiveTCPConnectionState
     // KeepAlive interval in seconds
     uint16_t mTCPKeepAliveIntervalSecs = CHIP_CONFIG_TCP_KEEPALIVE_INTERVAL_SECS;
     uint16_t mTCPMaxNumKeepAliveProbes = CHIP_CONFIG_MAX_TCP_KEEPALIVE_PROBES;
+
+    // Last time data was sent or received on the connection, and the order
+    // of that use among all connections.
+    System::Clock::Timestamp mLastActivityTime = System::Clock::kZero;
+    uint64_t mLastUse                          = 0;
+
+    // The connection is closed once idle for this long. Zero keeps it open
+    // until it is explicitly closed.
+    System::Clock::Timeout mIdleTimeout = System::Clock::Seconds32(CHIP_CONFIG_TCP_IDLE_TIMEOUT_SECS);
+
+    // Number of sessions currently using the connection. TCPBase never
+    // evicts a connection that is held.
+    uint16_t mHolderCount = 0;
+
+    // Next connections in the same TCPBase lookup buckets.
+    ActiveTCPConnectionState * mNextByPeer     = nullptr;
+    ActiveTCPConnectionState * mNextByEndPoint = nullptr;
+
+    // The connection was handed to a new TCPConnect() caller that has not
+    // been notified of the connection completion yet.
+    bool mReusePending = false;
 };
 
 // Functors for callbacks into higher layers
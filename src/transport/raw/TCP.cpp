@@ -82,6 +82,7 @@ CHIP_ERROR TCPBase::Init(TcpListenParameters & params)
     // connection endpoints at runtime.
     err = params.GetEndPointManager()->NewEndPoint(&mListenSocket);
     SuccessOrExit(err);
+    mSystemLayer = &mListenSocket->GetSystemLayer();
 
     if (params.IsServerListenEnabled())
     {
@@ -124,6 +125,13 @@ void TCPBase::Close()
 
     CloseActiveConnections();
 
+    if (mSystemLayer != nullptr)
+    {
+        mSystemLayer->CancelTimer(HandleIdleTimer, this);
+        mSystemLayer->CancelTimer(HandleReusedConnections, this);
+        mSystemLayer = nullptr;
+    }
+
     mState = TCPState::kNotReady;
 }
 
@@ -140,6 +148,60 @@ ActiveTCPConnectionState * TCPBase::AllocateConnection()
     return nullptr;
 }
 
+size_t TCPBase::PeerBucket(const Inet::IPAddress & address, uint16_t port) const
+{
+    uint32_t hash = port;
+    for (uint32_t word : address.Addr)
+    {
+        hash = (hash ^ word) * 0x9E3779B1u;
+    }
+    return (hash ^ (hash >> 16)) % mBucketCount;
+}
+
+size_t TCPBase::EndPointBucket(const Inet::TCPEndPoint * endPoint) const
+{
+    // Endpoints are at least sizeof(TCPEndPoint) bytes apart: drop the address bits they have in common.
+    return (reinterpret_cast<uintptr_t>(endPoint) / sizeof(Inet::TCPEndPoint)) % mBucketCount;
+}
+
+void TCPBase::AddToLookup(ActiveTCPConnectionState * connection)
+{
+    const size_t peerBucket     = PeerBucket(connection->mPeerAddr.GetIPAddress(), connection->mPeerAddr.GetPort());
+    const size_t endPointBucket = EndPointBucket(connection->mEndPoint);
+
+    connection->mNextByPeer          = mPeerBuckets[peerBucket];
+    mPeerBuckets[peerBucket]         = connection;
+    connection->mNextByEndPoint      = mEndPointBuckets[endPointBucket];
+    mEndPointBuckets[endPointBucket] = connection;
+}
+
+void TCPBase::RemoveFromLookup(ActiveTCPConnectionState * connection)
+{
+    const PeerAddress & peer         = connection->mPeerAddr;
+    ActiveTCPConnectionState ** link = &mPeerBuckets[PeerBucket(peer.GetIPAddress(), peer.GetPort())];
+    while ((*link != nullptr) && (*link != connection))
+    {
+        link = &(*link)->mNextByPeer;
+    }
+    if (*link != nullptr)
+    {
+        *link = connection->mNextByPeer;
+    }
+
+    link = &mEndPointBuckets[EndPointBucket(connection->mEndPoint)];
+    while ((*link != nullptr) && (*link != connection))
+    {
+        link = &(*link)->mNextByEndPoint;
+    }
+    if (*link != nullptr)
+    {
+        *link = connection->mNextByEndPoint;
+    }
+
+    connection->mNextByPeer     = nullptr;
+    connection->mNextByEndPoint = nullptr;
+}
+
 // Find an ActiveTCPConnectionState corresponding to a peer address
 ActiveTCPConnectionState * TCPBase::FindActiveConnection(const PeerAddress & address)
 {
@@ -148,20 +210,20 @@ ActiveTCPConnectionState * TCPBase::FindActiveConnection(const PeerAddress & add
         return nullptr;
     }
 
-    for (size_t i = 0; i < mActiveConnectionsSize; i++)
-    {
-        if (!mActiveConnections[i].IsConnected())
-        {
-            continue;
-        }
-        Inet::IPAddress addr;
-        uint16_t port;
-        mActiveConnections[i].mEndPoint->GetPeerInfo(&addr, &port);
+    const Inet::IPAddress & ipAddress     = address.GetIPAddress();
+    const uint16_t port                   = address.GetPort();
+    ActiveTCPConnectionState * connection = mPeerBuckets[PeerBucket(ipAddress, port)];
 
-        if ((addr == address.GetIPAddress()) && (port == address.GetPort()))
+    while (connection != nullptr)
+    {
+        // The InterfaceID is ignored, as it may not have been provided in the
+        // PeerAddress during connection establishment.
+        if (connection->IsConnected() && (connection->mPeerAddr.GetIPAddress() == ipAddress) &&
+            (connection->mPeerAddr.GetPort() == port))
         {
-            return &mActiveConnections[i];
+            return connection;
         }
+        connection = connection->mNextByPeer;
     }
 
     return nullptr;
@@ -170,31 +232,162 @@ ActiveTCPConnectionState * TCPBase::FindActiveConnection(const PeerAddress & add
 // Find the ActiveTCPConnectionState for a given TCPEndPoint
 ActiveTCPConnectionState * TCPBase::FindActiveConnection(const Inet::TCPEndPoint * endPoint)
 {
+    ActiveTCPConnectionState * connection = FindInUseConnection(endPoint);
+    return (connection != nullptr && connection->IsConnected()) ? connection : nullptr;
+}
+
+ActiveTCPConnectionState * TCPBase::FindInUseConnection(const Inet::TCPEndPoint * endPoint)
+{
+    if (endPoint == nullptr)
+    {
+        return nullptr;
+    }
+
+    ActiveTCPConnectionState * connection = mEndPointBuckets[EndPointBucket(endPoint)];
+    while ((connection != nullptr) && (connection->mEndPoint != endPoint))
+    {
+        connection = connection->mNextByEndPoint;
+    }
+    return connection;
+}
+
+CHIP_ERROR TCPBase::MakeRoomForConnection()
+{
+    if (mUsedEndPointCount < mActiveConnectionsSize)
+    {
+        return CHIP_NO_ERROR;
+    }
+
+#if CHIP_CONFIG_TCP_EVICT_LEAST_RECENTLY_USED
+    // Connections still being set up are about to be used, connections held by a session carry its traffic,
+    // and connections with an mAppState have a handshake waiting on their callbacks. Only established
+    // connections that none of these use are closed.
+    ActiveTCPConnectionState * leastRecentlyUsed = nullptr;
     for (size_t i = 0; i < mActiveConnectionsSize; i++)
     {
-        if (mActiveConnections[i].mEndPoint == endPoint && mActiveConnections[i].IsConnected())
+        ActiveTCPConnectionState * connection = &mActiveConnections[i];
+        if (!connection->IsConnected() || connection->IsHeld() || (connection->mAppState != nullptr))
         {
-            return &mActiveConnections[i];
+            continue;
+        }
+        if ((leastRecentlyUsed == nullptr) || (connection->mLastUse < leastRecentlyUsed->mLastUse))
+        {
+            leastRecentlyUsed = connection;
         }
     }
-    return nullptr;
+    VerifyOrReturnError(leastRecentlyUsed != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    ChipLogProgress(Inet, "All TCP connections in use, closing the least recently used one that no session holds.");
+    CloseConnectionInternal(leastRecentlyUsed, CHIP_NO_ERROR, SuppressCallback::No);
+
+    return (mUsedEndPointCount < mActiveConnectionsSize) ? CHIP_NO_ERROR : CHIP_ERROR_NO_MEMORY;
+#else
+    return CHIP_ERROR_NO_MEMORY;
+#endif // CHIP_CONFIG_TCP_EVICT_LEAST_RECENTLY_USED
 }
 
-ActiveTCPConnectionState * TCPBase::FindInUseConnection(const Inet::TCPEndPoint * endPoint)
+void TCPBase::MarkActive(ActiveTCPConnectionState * connection)
 {
-    if (endPoint == nullptr)
+    connection->mLastActivityTime = System::SystemClock().GetMonotonicTimestamp();
+    connection->mLastUse          = ++mUseCount;
+}
+
+void TCPBase::SetIdleTimeout(ActiveTCPConnectionState * conn, System::Clock::Timeout timeout)
+{
+    VerifyOrReturn(conn != nullptr);
+
+    conn->mIdleTimeout = timeout;
+    ScheduleIdleCheck();
+}
+
+CHIP_ERROR TCPBase::SetIdleTimeout(const PeerAddress & address, System::Clock::Timeout timeout)
+{
+    ActiveTCPConnectionState * connection = FindActiveConnection(address);
+    VerifyOrReturnError(connection != nullptr, CHIP_ERROR_NOT_FOUND);
+
+    SetIdleTimeout(connection, timeout);
+    return CHIP_NO_ERROR;
+}
+
+void TCPBase::ScheduleIdleCheck()
+{
+    VerifyOrReturn(mSystemLayer != nullptr);
+
+    bool found = false;
+    System::Clock::Timestamp earliest;
+    for (size_t i = 0; i < mActiveConnectionsSize; i++)
     {
-        return nullptr;
+        const ActiveTCPConnectionState & connection = mActiveConnections[i];
+        if (!connection.IsConnected() || (connection.mIdleTimeout == System::Clock::kZero))
+        {
+            continue;
+        }
+
+        const System::Clock::Timestamp deadline = connection.mLastActivityTime + connection.mIdleTimeout;
+        if (!found || (deadline < earliest))
+        {
+            earliest = deadline;
+            found    = true;
+        }
+    }
+
+    if (!found)
+    {
+        mSystemLayer->CancelTimer(HandleIdleTimer, this);
+        return;
     }
 
+    const System::Clock::Timestamp now = System::SystemClock().GetMonotonicTimestamp();
+    const System::Clock::Timeout delay =
+        (earliest > now) ? std::chrono::duration_cast<System::Clock::Timeout>(earliest - now) : System::Clock::kZero;
+    if (mSystemLayer->StartTimer(delay, HandleIdleTimer, this) != CHIP_NO_ERROR)
+    {
+        ChipLogError(Inet, "Failed to start the TCP idle connection timer");
+    }
+}
+
+void TCPBase::CloseIdleConnections()
+{
+    const System::Clock::Timestamp now = System::SystemClock().GetMonotonicTimestamp();
+
     for (size_t i = 0; i < mActiveConnectionsSize; i++)
     {
-        if (mActiveConnections[i].mEndPoint == endPoint)
+        ActiveTCPConnectionState * connection = &mActiveConnections[i];
+        if (connection->IsConnected() && (connection->mIdleTimeout != System::Clock::kZero) &&
+            (now >= connection->mLastActivityTime + connection->mIdleTimeout))
         {
-            return &mActiveConnections[i];
+            ChipLogProgress(Inet, "TCP connection idle for %" PRIu32 " ms.", connection->mIdleTimeout.count());
+            CloseConnectionInternal(connection, CHIP_NO_ERROR, SuppressCallback::No);
+        }
+    }
+
+    ScheduleIdleCheck();
+}
+
+void TCPBase::HandleIdleTimer(System::Layer * systemLayer, void * appState)
+{
+    reinterpret_cast<TCPBase *>(appState)->CloseIdleConnections();
+}
+
+void TCPBase::HandleReusedConnections(System::Layer * systemLayer, void * appState)
+{
+    TCPBase * tcp = reinterpret_cast<TCPBase *>(appState);
+
+    for (size_t i = 0; i < tcp->mActiveConnectionsSize; i++)
+    {
+        ActiveTCPConnectionState * connection = &tcp->mActiveConnections[i];
+        if (!connection->mReusePending)
+        {
+            continue;
+        }
+        connection->mReusePending = false;
+
+        // The caller may have released the connection in the meantime.
+        if (connection->IsConnected() && (connection->mAppState != nullptr))
+        {
+            tcp->HandleConnectionAttemptComplete(connection, CHIP_NO_ERROR);
         }
     }
-    return nullptr;
 }
 
 CHIP_ERROR TCPBase::SendMessage(const Transport::PeerAddress & address, System::PacketBufferHandle && msgBuf)
@@ -222,6 +415,7 @@ CHIP_ERROR TCPBase::SendMessage(const Transport::PeerAddress & address, System::
 
     if (connection != nullptr)
     {
+        MarkActive(connection);
         return connection->mEndPoint->Send(std::move(msgBuf));
     }
 
@@ -249,11 +443,21 @@ CHIP_ERROR TCPBase::StartConnect(const PeerAddress & addr, Transport::AppTCPConn
     activeConnection->Init(endPoint, addr);
     activeConnection->mAppState        = appState;
     activeConnection->mConnectionState = TCPState::kConnecting;
+    AddToLookup(activeConnection);
+    MarkActive(activeConnection);
     // Set the return value of the peer connection state to the allocated
     // connection.
     *outPeerConnState = activeConnection;
 
-    ReturnErrorOnFailure(endPoint->Connect(addr.GetIPAddress(), addr.GetPort(), addr.GetInterface()));
+    CHIP_ERROR err = endPoint->Connect(addr.GetIPAddress(), addr.GetPort(), addr.GetInterface());
+    if (err != CHIP_NO_ERROR)
+    {
+        // Release the connection: the endpoint is freed on return.
+        RemoveFromLookup(activeConnection);
+        activeConnection->Init(nullptr, PeerAddress::Uninitialized());
+        *outPeerConnState = nullptr;
+        return err;
+    }
 
     mUsedEndPointCount++;
 
@@ -292,14 +496,13 @@ CHIP_ERROR TCPBase::SendAfterConnect(const PeerAddress & addr, System::PacketBuf
     }
 
     // Ensures sufficient active connections size exist
-    VerifyOrReturnError(mUsedEndPointCount < mActiveConnectionsSize, CHIP_ERROR_NO_MEMORY);
+    ReturnErrorOnFailure(MakeRoomForConnection());
 
     Transport::ActiveTCPConnectionState * peerConnState = nullptr;
     ReturnErrorOnFailure(StartConnect(addr, nullptr, &peerConnState));
 
     // enqueue the packet once the connection succeeds
     VerifyOrReturnError(mPendingPackets.CreateObject(addr, std::move(msg)) != nullptr, CHIP_ERROR_NO_MEMORY);
-    mUsedEndPointCount++;
 
     return CHIP_NO_ERROR;
 #else
@@ -312,6 +515,7 @@ CHIP_ERROR TCPBase::ProcessReceivedBuffer(Inet::TCPEndPoint * endPoint, const Pe
 {
     ActiveTCPConnectionState * state = FindActiveConnection(endPoint);
     VerifyOrReturnError(state != nullptr, CHIP_ERROR_INTERNAL);
+    MarkActive(state);
     state->mReceived.AddToEnd(std::move(buffer));
 
     while (!state->mReceived.IsNull())
@@ -366,16 +570,37 @@ CHIP_ERROR TCPBase::ProcessSingleMessage(const PeerAddress & peerAddress, Active
     MessageTransportContext msgContext;
     msgContext.conn = state;
 
-    if (state->mReceived->DataLength() == messageSize)
+    const size_t headLength = state->mReceived->DataLength();
+
+    if (headLength == messageSize)
     {
         // In this case, the head packet buffer contains exactly the message.
         // This is common because typical messages fit in a network packet, and are delivered as such.
         // Peel off the head to pass upstream, which effectively consumes it from `state->mReceived`.
         message = state->mReceived.PopHead();
     }
+    else if ((headLength > messageSize) && (headLength - messageSize < messageSize))
+    {
+        // The head packet buffer contains the whole message, followed by the start of the next one(s). This happens
+        // when the peer sends messages back to back, e.g. during large transfers. Move the (shorter) trailing data to a
+        // buffer of its own and peel off the head to pass upstream, instead of copying the message out of it.
+        System::PacketBufferHandle trailing =
+            System::PacketBufferHandle::NewWithData(state->mReceived->Start() + messageSize, headLength - messageSize, 0, 0);
+        if (trailing.IsNull())
+        {
+            return CHIP_ERROR_NO_MEMORY;
+        }
+        message = state->mReceived.PopHead();
+        message->SetDataLength(messageSize);
+        if (!state->mReceived.IsNull())
+        {
+            trailing->AddToEnd(std::move(state->mReceived));
+        }
+        state->mReceived = std::move(trailing);
+    }
     else
     {
-        // The message is either longer or shorter than the head buffer.
+        // The message is either longer than the head buffer, or much shorter than it.
         // In either case, copy the message to a fresh linear buffer to pass upstream. We always copy, rather than provide
         // a shared reference to the current buffer, in case upper layers manipulate the buffer in ways that would affect
         // our use, e.g. chaining it elsewhere or reusing space beyond the current message.
@@ -435,6 +660,7 @@ void TCPBase::CloseConnectionInternal(ActiveTCPConnectionState * connection, CHI
             }
         }
 
+        RemoveFromLookup(connection);
         connection->Free();
         mUsedEndPointCount--;
     }
@@ -523,15 +749,40 @@ void TCPBase::HandleTCPEndPointConnectComplete(Inet::TCPEndPoint * endPoint, CHI
 
         ChipLogProgress(Inet, "Connection established successfully with %s.", addrStr);
 
+        tcp->MarkActive(activeConnection);
+        tcp->ScheduleIdleCheck();
+
         // Let higher layer/delegate know that connection is successfully
         // established
         tcp->HandleConnectionAttemptComplete(activeConnection, CHIP_NO_ERROR);
     }
     else
     {
-        ChipLogError(Inet, "Connection establishment with %s encountered an error: %" CHIP_ERROR_FORMAT, addrStr, err.Format());
-        endPoint->Free();
-        tcp->mUsedEndPointCount--;
+        activeConnection = tcp->FindInUseConnection(endPoint);
+        if (activeConnection != nullptr)
+        {
+            // The endpoint has no peer once the attempt failed
+            activeConnection->mPeerAddr.ToString(addrStr);
+        }
+        ChipLogError(Inet, "Connection establishment with %s encountered an error: %" CHIP_ERROR_FORMAT, addrStr, conErr.Format());
+
+        if (activeConnection == nullptr)
+        {
+            endPoint->Free();
+            return;
+        }
+
+        // Drop the packets that were waiting for this connection
+        tcp->mPendingPackets.ForEachActiveObject([&](PendingPacket * pending) {
+            if (pending->mPeerAddress == activeConnection->mPeerAddr)
+            {
+                tcp->mPendingPackets.ReleaseObject(pending);
+            }
+            return Loop::Continue;
+        });
+
+        // Release the connection, letting the higher layer know that the attempt failed
+        tcp->CloseConnectionInternal(activeConnection, conErr, SuppressCallback::No);
     }
 }
 
@@ -584,6 +835,9 @@ void TCPBase::HandleIncomingConnection(Inet::TCPEndPoint * listenEndPoint, Inet:
         activeConnection->Init(endPoint, addr);
         tcp->mUsedEndPointCount++;
         activeConnection->mConnectionState = TCPState::kConnected;
+        tcp->AddToLookup(activeConnection);
+        tcp->MarkActive(activeConnection);
+        tcp->ScheduleIdleCheck();
 
         // Set the TCPKeepalive configurations on the received connection
         endPoint->EnableKeepAlive(activeConnection->mTCPKeepAliveIntervalSecs, activeConnection->mTCPMaxNumKeepAliveProbes);
@@ -617,10 +871,26 @@ CHIP_ERROR TCPBase::TCPConnect(const PeerAddress & address, Transport::AppTCPCon
     // Verify that PeerAddress AddressType is TCP
     VerifyOrReturnError(address.GetTransportType() == Transport::Type::kTcp, CHIP_ERROR_INVALID_ARGUMENT);
 
-    VerifyOrReturnError(mUsedEndPointCount < mActiveConnectionsSize, CHIP_ERROR_NO_MEMORY);
-
     char addrStr[Transport::PeerAddress::kMaxToStringSize];
     address.ToString(addrStr);
+
+    // Sessions with the same peer share the connection to it, including one
+    // that established sessions hold, unless someone else is still waiting
+    // for its callbacks.
+    ActiveTCPConnectionState * connection = FindActiveConnection(address);
+    if ((connection != nullptr) && (connection->mAppState == nullptr))
+    {
+        ChipLogProgress(Inet, "Reusing connection to peer %s.", addrStr);
+        ReturnErrorOnFailure(mSystemLayer->StartTimer(System::Clock::kZero, HandleReusedConnections, this));
+        connection->mAppState     = appState;
+        connection->mReusePending = true;
+        MarkActive(connection);
+        *outPeerConnState = connection;
+        return CHIP_NO_ERROR;
+    }
+
+    ReturnErrorOnFailure(MakeRoomForConnection());
+
     ChipLogProgress(Inet, "Connecting to peer %s.", addrStr);
 
     ReturnErrorOnFailure(StartConnect(address, appState, outPeerConnState));
@@ -630,26 +900,14 @@ CHIP_ERROR TCPBase::TCPConnect(const PeerAddress & address, Transport::AppTCPCon
 
 void TCPBase::TCPDisconnect(const PeerAddress & address)
 {
-    // Closes an existing connection
-    for (size_t i = 0; i < mActiveConnectionsSize; i++)
+    // Closes the existing connections to the peer
+    ActiveTCPConnectionState * connection;
+    while ((connection = FindActiveConnection(address)) != nullptr)
     {
-        if (mActiveConnections[i].IsConnected())
-        {
-            const Inet::IPAddress & ipAddress = mActiveConnections[i].mPeerAddr.GetIPAddress();
-            uint16_t port                     = mActiveConnections[i].mPeerAddr.GetPort();
-
-            // Ignoring the InterfaceID in the check as it may not have been provided in
-            // the PeerAddress during connection establishment. The IPAddress and Port
-            // are the necessary and sufficient set of parameters for searching
-            // through the connections.
-            if (ipAddress == address.GetIPAddress() && port == address.GetPort() && address.GetTransportType() == Type::kTcp)
-            {
-                // NOTE: this leaves the socket in TIME_WAIT.
-                // Calling Abort() would clean it since SO_LINGER would be set to 0,
-                // however this seems not to be useful.
-                CloseConnectionInternal(&mActiveConnections[i], CHIP_NO_ERROR, SuppressCallback::Yes);
-            }
-        }
+        // NOTE: this leaves the socket in TIME_WAIT.
+        // Calling Abort() would clean it since SO_LINGER would be set to 0,
+        // however this seems not to be useful.
+        CloseConnectionInternal(connection, CHIP_NO_ERROR, SuppressCallback::Yes);
     }
 }
 
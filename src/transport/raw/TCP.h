@@ -34,6 +34,8 @@
 #include <lib/core/CHIPCore.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/PoolWrapper.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayer.h>
 #include <transport/raw/ActiveTCPConnectionState.h>
 #include <transport/raw/Base.h>
 #include <transport/raw/TCPConfig.h>
@@ -127,10 +129,12 @@ protected:
 
 public:
     using PendingPacketPoolType = PoolInterface<PendingPacket, const PeerAddress &, System::PacketBufferHandle &&>;
-    TCPBase(ActiveTCPConnectionState * activeConnectionsBuffer, size_t bufferSize, PendingPacketPoolType & packetBuffers) :
-        mActiveConnections(activeConnectionsBuffer), mActiveConnectionsSize(bufferSize), mPendingPackets(packetBuffers)
+    TCPBase(ActiveTCPConnectionState * activeConnectionsBuffer, size_t bufferSize, ActiveTCPConnectionState ** peerBuckets,
+            ActiveTCPConnectionState ** endPointBuckets, size_t bucketCount, PendingPacketPoolType & packetBuffers) :
+        mActiveConnections(activeConnectionsBuffer), mActiveConnectionsSize(bufferSize), mPeerBuckets(peerBuckets),
+        mEndPointBuckets(endPointBuckets), mBucketCount(bucketCount), mPendingPackets(packetBuffers)
     {
-        // activeConnectionsBuffer must be initialized by the caller.
+        // activeConnectionsBuffer and the buckets must be initialized by the caller.
     }
     ~TCPBase() override;
 
@@ -153,6 +157,22 @@ public:
      */
     void SetConnectTimeout(const uint32_t connTimeoutMsecs) { mConnectTimeout = connTimeoutMsecs; }
 
+    /**
+     * Set how long the given connection may go without sending or receiving
+     * data before it is closed. A zero timeout keeps the connection open until
+     * it is explicitly closed.
+     *
+     * The timeout defaults to CHIP_CONFIG_TCP_IDLE_TIMEOUT_SECS.
+     */
+    void SetIdleTimeout(ActiveTCPConnectionState * conn, System::Clock::Timeout timeout);
+
+    /**
+     * Set the idle timeout of the connection to the given peer.
+     *
+     * @return CHIP_ERROR_NOT_FOUND if there is no connection to the peer.
+     */
+    CHIP_ERROR SetIdleTimeout(const PeerAddress & address, System::Clock::Timeout timeout);
+
     /**
      * Close the open endpoint without destroying the object
      */
@@ -176,6 +196,9 @@ public:
      *                          connection attempt if the caller object dies
      *                          before the attempt completes.
      *
+     * If there already is a connection to the peer and no application state
+     * is attached to it, that connection is handed to the caller and the
+     * connection attempt completes right after this call returns.
      */
     CHIP_ERROR TCPConnect(const PeerAddress & address, Transport::AppTCPConnectionCallbackCtxt * appState,
                           Transport::ActiveTCPConnectionState ** outPeerConnState) override;
@@ -234,6 +257,37 @@ private:
      */
     ActiveTCPConnectionState * FindInUseConnection(const Inet::TCPEndPoint * endPoint);
 
+    /**
+     * Add an allocated connection to the peer and endpoint lookup buckets, or
+     * remove it from them before it is freed.
+     */
+    void AddToLookup(ActiveTCPConnectionState * connection);
+    void RemoveFromLookup(ActiveTCPConnectionState * connection);
+
+    size_t PeerBucket(const Inet::IPAddress & address, uint16_t port) const;
+    size_t EndPointBucket(const Inet::TCPEndPoint * endPoint) const;
+
+    /**
+     * Ensure a new connection can be started. If all connections are in use
+     * and CHIP_CONFIG_TCP_EVICT_LEAST_RECENTLY_USED is enabled, the least
+     * recently used connection that no session holds (see
+     * ActiveTCPConnectionState::IsHeld) and no handshake waits on (mAppState
+     * is null) is closed.
+     */
+    CHIP_ERROR MakeRoomForConnection();
+
+    // Note that data was just sent or received on the connection.
+    void MarkActive(ActiveTCPConnectionState * connection);
+
+    // Start the timer for the earliest idle connection deadline, if any.
+    void ScheduleIdleCheck();
+
+    void CloseIdleConnections();
+    static void HandleIdleTimer(System::Layer * systemLayer, void * appState);
+
+    // Report the completion of TCPConnect() calls that reused a connection.
+    static void HandleReusedConnections(System::Layer * systemLayer, void * appState);
+
     /**
      * Sends the specified message once a connection has been established.
      *
@@ -308,6 +362,7 @@ private:
     static void HandleAcceptError(Inet::TCPEndPoint * endPoint, CHIP_ERROR err);
 
     Inet::TCPEndPoint * mListenSocket = nullptr;                       ///< TCP socket used by the transport
+    System::Layer * mSystemLayer      = nullptr;                       ///< Layer running the transport timers
     Inet::IPAddressType mEndpointType = Inet::IPAddressType::kUnknown; ///< Socket listening type
     TCPState mState                   = TCPState::kNotReady;           ///< State of the TCP transport
 
@@ -318,10 +373,19 @@ private:
     // Number of active and 'pending connection' endpoints
     size_t mUsedEndPointCount = 0;
 
+    // Number of times connections were used, to order them by last use
+    uint64_t mUseCount = 0;
+
     // Currently active connections
     ActiveTCPConnectionState * mActiveConnections;
     const size_t mActiveConnectionsSize;
 
+    // Lookup of allocated connections by peer address and by endpoint:
+    // chains of connections linked through mNextByPeer and mNextByEndPoint.
+    ActiveTCPConnectionState ** mPeerBuckets;
+    ActiveTCPConnectionState ** mEndPointBuckets;
+    const size_t mBucketCount;
+
     // Data to be sent when connections succeed
     PendingPacketPoolType & mPendingPackets;
 };
@@ -330,11 +394,14 @@ template <size_t kActiveConnectionsSize, size_t kPendingPacketSize>
 class TCP : public TCPBase
 {
 public:
-    TCP() : TCPBase(mConnectionsBuffer, kActiveConnectionsSize, mPendingPackets)
+    TCP() :
+        TCPBase(mConnectionsBuffer, kActiveConnectionsSize, mPeerBuckets, mEndPointBuckets, kActiveConnectionsSize, mPendingPackets)
     {
         for (size_t i = 0; i < kActiveConnectionsSize; ++i)
         {
             mConnectionsBuffer[i].Init(nullptr, PeerAddress::Uninitialized());
+            mPeerBuckets[i]     = nullptr;
+            mEndPointBuckets[i] = nullptr;
         }
     }
 
@@ -342,6 +409,8 @@ public:
 
 private:
     ActiveTCPConnectionState mConnectionsBuffer[kActiveConnectionsSize];
+    ActiveTCPConnectionState * mPeerBuckets[kActiveConnectionsSize];
+    ActiveTCPConnectionState * mEndPointBuckets[kActiveConnectionsSize];
     PoolImpl<PendingPacket, kPendingPacketSize, ObjectPoolMem::kInline, PendingPacketPoolType::Interface> mPendingPackets;
 };
 
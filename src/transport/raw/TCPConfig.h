@@ -103,6 +103,37 @@ namespace chip {
 #define CHIP_CONFIG_MAX_TCP_KEEPALIVE_PROBES (5)
 #endif // CHIP_CONFIG_MAX_TCP_KEEPALIVE_PROBES
 
+/**
+ *  @def CHIP_CONFIG_TCP_IDLE_TIMEOUT_SECS
+ *
+ *  @brief
+ *    This defines the default time (in seconds) a TCP connection
+ *    may go without sending or receiving any data before it is
+ *    closed. The timeout can be changed per connection at runtime.
+ *
+ *    A value of 0 keeps idle connections open.
+ *
+ */
+#ifndef CHIP_CONFIG_TCP_IDLE_TIMEOUT_SECS
+#define CHIP_CONFIG_TCP_IDLE_TIMEOUT_SECS (0)
+#endif // CHIP_CONFIG_TCP_IDLE_TIMEOUT_SECS
+
+/**
+ *  @def CHIP_CONFIG_TCP_EVICT_LEAST_RECENTLY_USED
+ *
+ *  @brief
+ *    When all TCP connections are in use, close the least
+ *    recently used one to connect to a new peer, instead of
+ *    failing the connection attempt. Connections held by a
+ *    session are never closed for this, so the attempt still
+ *    fails if every connection is held. Incoming connections
+ *    are still refused when all connections are in use.
+ *
+ */
+#ifndef CHIP_CONFIG_TCP_EVICT_LEAST_RECENTLY_USED
+#define CHIP_CONFIG_TCP_EVICT_LEAST_RECENTLY_USED 0
+#endif // CHIP_CONFIG_TCP_EVICT_LEAST_RECENTLY_USED
+
 /**
  *  @def CHIP_CONFIG_MAX_UNACKED_DATA_TIMEOUT_SECS
  *
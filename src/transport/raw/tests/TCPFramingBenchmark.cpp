@@ -0,0 +1,155 @@
+/*
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @file
+ *   Measures TCP transport throughput over loopback: a TCP transport sends length-prefixed messages of
+ *   64 bytes up to the largest supported size to itself, in windows of kWindow messages, and each window
+ *   waits until all its messages went through the receive framing.  Reports ns per message and MB/s.
+ *
+ *   Usage: tcp-framing-benchmark [megabytes per message size]
+ */
+
+#include "NetworkTestHelpers.h"
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/tests/BenchmarkHelpers.h>
+#include <system/SystemPacketBuffer.h>
+#include <transport/raw/TCP.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace chip;
+
+namespace {
+
+constexpr size_t kMaxActiveConnections = 2;
+constexpr size_t kMaxPendingPackets    = 4;
+constexpr uint64_t kDefaultMegabytes   = 64;
+constexpr uint64_t kWindow             = 16;
+constexpr uint16_t kPort               = 5541;
+
+// Leaves room for the headers, including the length prefix added by the transport.
+constexpr size_t kMaxMessageSize = System::PacketBuffer::kLargeBufMaxSize;
+
+const size_t kMessageSizes[] = { 64, 1024, 8 * 1024, 32 * 1024, kMaxMessageSize };
+
+using TCPImpl = Transport::TCP<kMaxActiveConnections, kMaxPendingPackets>;
+
+class Receiver : public Transport::RawTransportDelegate
+{
+public:
+    void HandleMessageReceived(const Transport::PeerAddress & peerAddress, System::PacketBufferHandle && msg,
+                               Transport::MessageTransportContext * ctxt) override
+    {
+        mMessages++;
+        mBytes += msg->TotalLength();
+    }
+
+    uint64_t mMessages = 0;
+    uint64_t mBytes    = 0;
+};
+
+bool SendMessage(TCPImpl & tcp, const Transport::PeerAddress & peer, size_t size)
+{
+    System::PacketBufferHandle buffer = System::PacketBufferHandle::New(size);
+    VerifyOrReturnValue(!buffer.IsNull(), false);
+    memset(buffer->Start(), 0x5A, size);
+    buffer->SetDataLength(size);
+    return tcp.SendMessage(peer, std::move(buffer)) == CHIP_NO_ERROR;
+}
+
+bool WaitForMessages(Test::IOContext & io, Receiver & receiver, uint64_t count)
+{
+    io.DriveIOUntil(System::Clock::Seconds16(5), [&]() { return receiver.mMessages >= count; });
+    return receiver.mMessages >= count;
+}
+
+bool RunCase(Test::IOContext & io, TCPImpl & tcp, Receiver & receiver, const Transport::PeerAddress & peer, size_t size,
+             uint64_t megabytes)
+{
+    // Whole windows of messages, at least one
+    uint64_t iterations = (megabytes * 1024 * 1024 / size) / kWindow * kWindow;
+    iterations          = (iterations == 0) ? kWindow : iterations;
+
+    receiver.mMessages = 0;
+    receiver.mBytes    = 0;
+
+    char name[64];
+    snprintf(name, sizeof(name), "loopback TCP, %u byte messages", static_cast<unsigned>(size));
+    Test::BenchmarkResult result = Test::RunBenchmark(name, iterations, [&](uint64_t i) {
+        VerifyOrReturnValue(SendMessage(tcp, peer, size), false);
+        return ((i + 1) % kWindow != 0) || WaitForMessages(io, receiver, i + 1);
+    });
+    Test::PrintBenchmarkResult(result);
+    VerifyOrReturnValue(result.mIterations != 0, false);
+
+    const double seconds = static_cast<double>(result.mTotalNs) / 1e9;
+    printf("%-56s %12.1f MB/s\n", "", static_cast<double>(receiver.mBytes) / (1024.0 * 1024.0) / seconds);
+    return receiver.mBytes == iterations * size;
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+    const uint64_t megabytes = (argc > 1) ? strtoull(argv[1], nullptr, 0) : kDefaultMegabytes;
+
+    Test::IOContext io;
+    VerifyOrReturnValue(io.Init() == CHIP_NO_ERROR, EXIT_FAILURE);
+
+    Inet::IPAddress addr;
+    Inet::IPAddress::FromString("::1", addr);
+    const Transport::PeerAddress peer = Transport::PeerAddress::TCP(addr, kPort);
+
+    Receiver receiver;
+    TCPImpl tcp;
+    int result = EXIT_FAILURE;
+
+    auto run = [&]() {
+        VerifyOrReturnValue(tcp.Init(Transport::TcpListenParameters(io.GetTCPEndPointManager())
+                                         .SetAddressType(addr.Type())
+                                         .SetListenPort(kPort)) == CHIP_NO_ERROR,
+                            false);
+        tcp.SetDelegate(&receiver);
+
+        // Connect before measuring anything
+        VerifyOrReturnValue(SendMessage(tcp, peer, 64) && WaitForMessages(io, receiver, 1), false);
+
+        Test::PrintBenchmarkHeader();
+        for (size_t size : kMessageSizes)
+        {
+            if (size > kMaxMessageSize)
+            {
+                continue; // large buffers not supported by this build
+            }
+            VerifyOrReturnValue(RunCase(io, tcp, receiver, peer, size, megabytes), false);
+        }
+        return true;
+    };
+
+    if (run())
+    {
+        result = EXIT_SUCCESS;
+    }
+
+    tcp.Close();
+    io.Shutdown();
+    return result;
+}
@@ -295,6 +295,35 @@ private:
     OnTCPConnectionReceivedCallback mConnReceivedCb = nullptr;
 };
 
+// Counts the messages received by a transport that is not under test.
+class CountingTransportDelegate : public Transport::RawTransportDelegate
+{
+public:
+    void HandleMessageReceived(const Transport::PeerAddress & peerAddress, System::PacketBufferHandle && msg,
+                               Transport::MessageTransportContext * ctxt) override
+    {
+        mMessageCount++;
+    }
+
+    size_t mMessageCount = 0;
+};
+
+// A session waiting for a TCP connection, as CASESession does.
+struct TCPSession
+{
+    TCPSession()
+    {
+        mCallbackCtxt.appContext     = this;
+        mCallbackCtxt.connCompleteCb = [](Transport::ActiveTCPConnectionState * conn, CHIP_ERROR conErr) {
+            static_cast<TCPSession *>(conn->mAppState->appContext)->mConnected = (conErr == CHIP_NO_ERROR);
+        };
+    }
+
+    Transport::AppTCPConnectionCallbackCtxt mCallbackCtxt;
+    Transport::ActiveTCPConnectionState * mConnection = nullptr;
+    bool mConnected                                   = false;
+};
+
 // Generates a packet buffer or a chain of packet buffers for a single message.
 struct TestData
 {
@@ -412,6 +441,26 @@ bool TestData::Init(const uint32_t sizes[])
     return true;
 }
 
+// Copies the messages of `first` and `second` to a chain of two packet buffers, the first one holding
+// `first` and the first `split` bytes of `second`.
+System::PacketBufferHandle CopyMessages(const TestData & first, const TestData & second, size_t split)
+{
+    System::PacketBufferHandle head = System::PacketBufferHandle::New(first.mTotalLength + split, 0 /* reserve */);
+    VerifyOrReturnValue(!head.IsNull(), head);
+    memcpy(head->Start(), first.mPayload, first.mTotalLength);
+    memcpy(head->Start() + first.mTotalLength, second.mPayload, split);
+    head->SetDataLength(first.mTotalLength + split);
+
+    if (split < second.mTotalLength)
+    {
+        System::PacketBufferHandle tail =
+            System::PacketBufferHandle::NewWithData(second.mPayload + split, second.mTotalLength - split, 0, 0);
+        VerifyOrReturnValue(!tail.IsNull(), tail);
+        head->AddToEnd(std::move(tail));
+    }
+    return head;
+}
+
 void TestData::Free()
 {
     chip::Platform::MemoryFree(mPayload);
@@ -647,6 +696,274 @@ TEST_F(TestTCP, HandleConnCloseCalledTest6)
     HandleConnCloseTest(addr);
 }
 
+TEST_F(TestTCP, CheckIdleConnectionClosed)
+{
+    TCPImpl tcp;
+
+    IPAddress addr;
+    IPAddress::FromString("::1", addr);
+
+    uint16_t port = GetRandomPort();
+    MockTransportMgrDelegate gMockTransportMgrDelegate(mIOContext);
+    gMockTransportMgrDelegate.InitializeMessageTest(tcp, addr, port);
+    gMockTransportMgrDelegate.ConnectTest(tcp, addr, port);
+
+    Transport::PeerAddress lPeerAddress = Transport::PeerAddress::TCP(addr, port);
+    EXPECT_EQ(tcp.SetIdleTimeout(lPeerAddress, System::Clock::Milliseconds32(50)), CHIP_NO_ERROR);
+
+    // The accepted end of the connection closes when the connecting end does.
+    mIOContext->DriveIOUntil(chip::System::Clock::Seconds16(5), [&tcp]() { return !tcp.HasActiveConnections(); });
+    EXPECT_FALSE(tcp.HasActiveConnections());
+    EXPECT_TRUE(gMockTransportMgrDelegate.mHandleConnectionCloseCalled);
+    EXPECT_EQ(tcp.SetIdleTimeout(lPeerAddress, System::Clock::Milliseconds32(50)), CHIP_ERROR_NOT_FOUND);
+}
+
+#if CHIP_CONFIG_TCP_EVICT_LEAST_RECENTLY_USED
+TEST_F(TestTCP, CheckManySessionsShareConnections)
+{
+    // Sessions with more peers than there are connections: a session reuses
+    // the connection to its peer if there is one, otherwise the least
+    // recently used connection makes room for a new one.
+    constexpr size_t kServerCount  = kMaxTcpActiveConnectionCount + 2;
+    constexpr size_t kSessionCount = 300;
+
+    IPAddress addr;
+    IPAddress::FromString("::1", addr);
+
+    // Ports above the range used by GetRandomPort()
+    const uint16_t firstServerPort = static_cast<uint16_t>(GetRandomPort() + 100);
+
+    TCPImpl servers[kServerCount];
+    CountingTransportDelegate serverDelegate;
+    for (size_t i = 0; i < kServerCount; i++)
+    {
+        ASSERT_EQ(servers[i].Init(Transport::TcpListenParameters(mIOContext->GetTCPEndPointManager())
+                                      .SetAddressType(addr.Type())
+                                      .SetListenPort(static_cast<uint16_t>(firstServerPort + i))),
+                  CHIP_NO_ERROR);
+        servers[i].SetDelegate(&serverDelegate);
+    }
+
+    TCPImpl tcp;
+    MockTransportMgrDelegate gMockTransportMgrDelegate(mIOContext);
+    gMockTransportMgrDelegate.InitializeMessageTest(tcp, addr, GetRandomPort());
+
+    size_t reusedCount = 0;
+    for (size_t i = 0; i < kSessionCount; i++)
+    {
+        // Two sessions in a row with each peer
+        const uint16_t port         = static_cast<uint16_t>(firstServerPort + (i / 2) % kServerCount);
+        Transport::PeerAddress peer = Transport::PeerAddress::TCP(addr, port);
+        void * existing             = TestAccess::FindActiveConnection(tcp, peer);
+
+        TCPSession session;
+        ASSERT_EQ(tcp.TCPConnect(peer, &session.mCallbackCtxt, &session.mConnection), CHIP_NO_ERROR);
+        mIOContext->DriveIOUntil(chip::System::Clock::Seconds16(5), [&session]() { return session.mConnected; });
+        ASSERT_TRUE(session.mConnected);
+        if (session.mConnection == existing)
+        {
+            reusedCount++;
+        }
+
+        chip::System::PacketBufferHandle buffer = chip::System::PacketBufferHandle::NewWithData(PAYLOAD, sizeof(PAYLOAD));
+        ASSERT_FALSE(buffer.IsNull());
+        ASSERT_EQ(tcp.SendMessage(peer, std::move(buffer)), CHIP_NO_ERROR);
+        mIOContext->DriveIOUntil(chip::System::Clock::Seconds16(5), [&]() { return serverDelegate.mMessageCount > i; });
+        ASSERT_EQ(serverDelegate.mMessageCount, i + 1);
+
+        // Sessions release the connection once established
+        session.mConnection->mAppState = nullptr;
+    }
+    EXPECT_EQ(reusedCount, kSessionCount / 2);
+
+    tcp.Close();
+    mIOContext->DriveIOUntil(chip::System::Clock::Seconds16(5), [&servers]() {
+        for (auto & server : servers)
+        {
+            if (server.HasActiveConnections())
+            {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
+TEST_F(TestTCP, CheckHeldConnectionsAreNotEvicted)
+{
+    // A handshake still waits on the least recently used connection, so
+    // making room for a new one closes the next one instead; once every
+    // connection is in use, no room can be made.
+    constexpr size_t kServerCount = kMaxTcpActiveConnectionCount + 2;
+
+    IPAddress addr;
+    IPAddress::FromString("::1", addr);
+
+    // Ports above the range used by GetRandomPort()
+    const uint16_t firstServerPort = static_cast<uint16_t>(GetRandomPort() + 100);
+
+    TCPImpl servers[kServerCount];
+    Transport::PeerAddress peers[kServerCount];
+    CountingTransportDelegate serverDelegate;
+    for (size_t i = 0; i < kServerCount; i++)
+    {
+        const uint16_t port = static_cast<uint16_t>(firstServerPort + i);
+        ASSERT_EQ(servers[i].Init(Transport::TcpListenParameters(mIOContext->GetTCPEndPointManager())
+                                      .SetAddressType(addr.Type())
+                                      .SetListenPort(port)),
+                  CHIP_NO_ERROR);
+        servers[i].SetDelegate(&serverDelegate);
+        peers[i] = Transport::PeerAddress::TCP(addr, port);
+    }
+
+    TCPImpl tcp;
+    MockTransportMgrDelegate gMockTransportMgrDelegate(mIOContext);
+    gMockTransportMgrDelegate.InitializeMessageTest(tcp, addr, GetRandomPort());
+
+    // Fill the table. Only the first, and least recently used, session keeps
+    // waiting on its connection.
+    TCPSession sessions[kMaxTcpActiveConnectionCount + 1];
+    for (size_t i = 0; i < kMaxTcpActiveConnectionCount; i++)
+    {
+        ASSERT_EQ(tcp.TCPConnect(peers[i], &sessions[i].mCallbackCtxt, &sessions[i].mConnection), CHIP_NO_ERROR);
+        mIOContext->DriveIOUntil(chip::System::Clock::Seconds16(5), [&sessions, i]() { return sessions[i].mConnected; });
+        ASSERT_TRUE(sessions[i].mConnected);
+        if (i > 0)
+        {
+            sessions[i].mConnection->mAppState = nullptr;
+        }
+    }
+
+    TCPSession & newSession = sessions[kMaxTcpActiveConnectionCount];
+    ASSERT_EQ(tcp.TCPConnect(peers[kMaxTcpActiveConnectionCount], &newSession.mCallbackCtxt, &newSession.mConnection),
+              CHIP_NO_ERROR);
+    mIOContext->DriveIOUntil(chip::System::Clock::Seconds16(5), [&newSession]() { return newSession.mConnected; });
+    EXPECT_TRUE(newSession.mConnected);
+
+    // The held connection survived and the next least recently used one made room.
+    EXPECT_EQ(TestAccess::FindActiveConnection(tcp, peers[0]), sessions[0].mConnection);
+    EXPECT_EQ(TestAccess::FindActiveConnection(tcp, peers[1]), nullptr);
+    EXPECT_NE(TestAccess::FindActiveConnection(tcp, peers[2]), nullptr);
+
+    // Once every connection is in use, a new peer cannot be connected to.
+    for (size_t i = 2; i <= kMaxTcpActiveConnectionCount; i++)
+    {
+        sessions[i].mConnection->mAppState = &sessions[i].mCallbackCtxt;
+    }
+    TCPSession refusedSession;
+    EXPECT_EQ(tcp.TCPConnect(peers[kServerCount - 1], &refusedSession.mCallbackCtxt, &refusedSession.mConnection),
+              CHIP_ERROR_NO_MEMORY);
+    EXPECT_EQ(TestAccess::FindActiveConnection(tcp, peers[0]), sessions[0].mConnection);
+
+    tcp.Close();
+    mIOContext->DriveIOUntil(chip::System::Clock::Seconds16(5), [&servers]() {
+        for (auto & server : servers)
+        {
+            if (server.HasActiveConnections())
+            {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
+TEST_F(TestTCP, CheckSessionHeldConnectionsAreReusedNotEvicted)
+{
+    // An established session holds its connection after the handshake has
+    // released the callbacks: a new handshake with the same peer shares the
+    // connection, and the connection is not evicted until the session lets go.
+    constexpr size_t kServerCount = kMaxTcpActiveConnectionCount + 2;
+
+    IPAddress addr;
+    IPAddress::FromString("::1", addr);
+
+    // Ports above the range used by GetRandomPort()
+    const uint16_t firstServerPort = static_cast<uint16_t>(GetRandomPort() + 100);
+
+    TCPImpl servers[kServerCount];
+    Transport::PeerAddress peers[kServerCount];
+    CountingTransportDelegate serverDelegate;
+    for (size_t i = 0; i < kServerCount; i++)
+    {
+        const uint16_t port = static_cast<uint16_t>(firstServerPort + i);
+        ASSERT_EQ(servers[i].Init(Transport::TcpListenParameters(mIOContext->GetTCPEndPointManager())
+                                      .SetAddressType(addr.Type())
+                                      .SetListenPort(port)),
+                  CHIP_NO_ERROR);
+        servers[i].SetDelegate(&serverDelegate);
+        peers[i] = Transport::PeerAddress::TCP(addr, port);
+    }
+
+    TCPImpl tcp;
+    MockTransportMgrDelegate gMockTransportMgrDelegate(mIOContext);
+    gMockTransportMgrDelegate.InitializeMessageTest(tcp, addr, GetRandomPort());
+
+    // Fill the table. The session with the first peer is established and
+    // holds its connection, as Session::SetTCPConnection does.
+    TCPSession sessions[kMaxTcpActiveConnectionCount];
+    for (size_t i = 0; i < kMaxTcpActiveConnectionCount; i++)
+    {
+        ASSERT_EQ(tcp.TCPConnect(peers[i], &sessions[i].mCallbackCtxt, &sessions[i].mConnection), CHIP_NO_ERROR);
+        mIOContext->DriveIOUntil(chip::System::Clock::Seconds16(5), [&sessions, i]() { return sessions[i].mConnected; });
+        ASSERT_TRUE(sessions[i].mConnected);
+        sessions[i].mConnection->mAppState = nullptr;
+    }
+    Transport::ActiveTCPConnectionState * heldConnection = sessions[0].mConnection;
+    heldConnection->AddHolder();
+
+    // A new handshake with the first peer shares the held connection.
+    TCPSession reusingSession;
+    ASSERT_EQ(tcp.TCPConnect(peers[0], &reusingSession.mCallbackCtxt, &reusingSession.mConnection), CHIP_NO_ERROR);
+    EXPECT_EQ(reusingSession.mConnection, heldConnection);
+    mIOContext->DriveIOUntil(chip::System::Clock::Seconds16(5), [&reusingSession]() { return reusingSession.mConnected; });
+    EXPECT_TRUE(reusingSession.mConnected);
+    heldConnection->mAppState = nullptr;
+
+    // Use the other connections so that the held one is the least recently used.
+    for (size_t i = 1; i < kMaxTcpActiveConnectionCount; i++)
+    {
+        chip::System::PacketBufferHandle buffer = chip::System::PacketBufferHandle::NewWithData(PAYLOAD, sizeof(PAYLOAD));
+        ASSERT_FALSE(buffer.IsNull());
+        ASSERT_EQ(tcp.SendMessage(peers[i], std::move(buffer)), CHIP_NO_ERROR);
+        mIOContext->DriveIOUntil(chip::System::Clock::Seconds16(5), [&]() { return serverDelegate.mMessageCount >= i; });
+        ASSERT_EQ(serverDelegate.mMessageCount, i);
+    }
+
+    // Making room closes the next least recently used connection.
+    TCPSession newSession;
+    ASSERT_EQ(tcp.TCPConnect(peers[kMaxTcpActiveConnectionCount], &newSession.mCallbackCtxt, &newSession.mConnection),
+              CHIP_NO_ERROR);
+    mIOContext->DriveIOUntil(chip::System::Clock::Seconds16(5), [&newSession]() { return newSession.mConnected; });
+    EXPECT_TRUE(newSession.mConnected);
+    newSession.mConnection->mAppState = nullptr;
+    EXPECT_EQ(TestAccess::FindActiveConnection(tcp, peers[0]), heldConnection);
+    EXPECT_EQ(TestAccess::FindActiveConnection(tcp, peers[1]), nullptr);
+
+    // Once the session lets go, its connection is the one evicted.
+    heldConnection->ReleaseHolder();
+    EXPECT_FALSE(heldConnection->IsHeld());
+    TCPSession lastSession;
+    ASSERT_EQ(tcp.TCPConnect(peers[kServerCount - 1], &lastSession.mCallbackCtxt, &lastSession.mConnection), CHIP_NO_ERROR);
+    mIOContext->DriveIOUntil(chip::System::Clock::Seconds16(5), [&lastSession]() { return lastSession.mConnected; });
+    EXPECT_TRUE(lastSession.mConnected);
+    EXPECT_EQ(TestAccess::FindActiveConnection(tcp, peers[0]), nullptr);
+    EXPECT_NE(TestAccess::FindActiveConnection(tcp, peers[2]), nullptr);
+
+    tcp.Close();
+    mIOContext->DriveIOUntil(chip::System::Clock::Seconds16(5), [&servers]() {
+        for (auto & server : servers)
+        {
+            if (server.HasActiveConnections())
+            {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+#endif // CHIP_CONFIG_TCP_EVICT_LEAST_RECENTLY_USED
+
 TEST_F(TestTCP, CheckTCPEndpointAfterCloseTest)
 {
     TCPImpl tcp;
@@ -734,6 +1051,24 @@ TEST_F(TestTCP, CheckProcessReceivedBuffer)
     EXPECT_EQ(err, CHIP_NO_ERROR);
     EXPECT_EQ(gMockTransportMgrDelegate.mReceiveHandlerCallCount, 2);
 
+    // Test two messages in a single packet buffer, the second one shorter.
+    gMockTransportMgrDelegate.mReceiveHandlerCallCount = 0;
+    EXPECT_TRUE(testData[0].Init((const uint32_t[]){ 300, 0 }));
+    EXPECT_TRUE(testData[1].Init((const uint32_t[]){ 200, 0 }));
+    buf = CopyMessages(testData[0], testData[1], testData[1].mTotalLength);
+    ASSERT_FALSE(buf.IsNull());
+    err = TestAccess::ProcessReceivedBuffer(tcp, lEndPoint, lPeerAddress, std::move(buf));
+    EXPECT_EQ(err, CHIP_NO_ERROR);
+    EXPECT_EQ(gMockTransportMgrDelegate.mReceiveHandlerCallCount, 2);
+
+    // Test a message followed by the start of the next one in a packet buffer.
+    gMockTransportMgrDelegate.mReceiveHandlerCallCount = 0;
+    buf = CopyMessages(testData[0], testData[1], 50);
+    ASSERT_FALSE(buf.IsNull());
+    err = TestAccess::ProcessReceivedBuffer(tcp, lEndPoint, lPeerAddress, std::move(buf));
+    EXPECT_EQ(err, CHIP_NO_ERROR);
+    EXPECT_EQ(gMockTransportMgrDelegate.mReceiveHandlerCallCount, 2);
+
     // Test a single packet buffer that is larger than
     // kMaxSizeWithoutReserve but less than CHIP_CONFIG_MAX_LARGE_PAYLOAD_SIZE_BYTES.
     gMockTransportMgrDelegate.mReceiveHandlerCallCount = 0;
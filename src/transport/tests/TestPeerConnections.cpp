@@ -140,6 +140,40 @@ TEST_F(TestPeerConnections, TestFindByKeyId)
     System::Clock::Internal::SetSystemClockForTesting(realClock);
 }
 
+#if INET_CONFIG_ENABLE_TCP_ENDPOINT
+TEST_F(TestPeerConnections, TestSessionsHoldTCPConnection)
+{
+    SecureSessionTable connections;
+    System::Clock::Internal::MockClock clock;
+    System::Clock::ClockBase * realClock = &System::SystemClock();
+    System::Clock::Internal::SetSystemClockForTesting(&clock);
+    ActiveTCPConnectionState conn;
+
+    auto session1 = connections.CreateNewSecureSessionForTest(SecureSession::Type::kCASE, 2, kLocalNodeId, kCasePeer1NodeId,
+                                                              kPeer1CATs, 1, kFabricIndex, GetDefaultMRPConfig());
+    ASSERT_TRUE(session1.HasValue());
+    auto session2 = connections.CreateNewSecureSessionForTest(SecureSession::Type::kCASE, 4, kLocalNodeId, kCasePeer2NodeId,
+                                                              kPeer2CATs, 3, kFabricIndex, GetDefaultMRPConfig());
+    ASSERT_TRUE(session2.HasValue());
+
+    // Both sessions hold the connection, each only once.
+    session1.Value()->AsSecureSession()->SetTCPConnection(&conn);
+    session1.Value()->AsSecureSession()->SetTCPConnection(&conn);
+    session2.Value()->AsSecureSession()->SetTCPConnection(&conn);
+    EXPECT_TRUE(conn.IsHeld());
+
+    session1.Value()->AsSecureSession()->SetTCPConnection(nullptr);
+    EXPECT_TRUE(conn.IsHeld());
+
+    // A session that goes away lets go of its connection.
+    session2.Value()->AsSecureSession()->MarkForEviction();
+    session2.ClearValue();
+    EXPECT_FALSE(conn.IsHeld());
+
+    System::Clock::Internal::SetSystemClockForTesting(realClock);
+}
+#endif // INET_CONFIG_ENABLE_TCP_ENDPOINT
+
 struct ExpiredCallInfo
 {
     int callCount                   = 0;
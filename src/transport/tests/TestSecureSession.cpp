@@ -29,13 +29,23 @@
 #include <crypto/DefaultSessionKeystore.h>
 #include <lib/core/CHIPCore.h>
 #include <lib/core/StringBuilderAdapters.h>
+#include <lib/support/CHIPMem.h>
 #include <lib/support/CodeUtils.h>
+#include <system/SystemPacketBuffer.h>
 #include <transport/CryptoContext.h>
+#include <transport/SecureMessageCodec.h>
 
 using namespace chip;
 using namespace Crypto;
 
-TEST(TestSecureSession, SecureChannelInitTest)
+class TestSecureSession : public ::testing::Test
+{
+public:
+    static void SetUpTestSuite() { ASSERT_EQ(chip::Platform::MemoryInit(), CHIP_NO_ERROR); }
+    static void TearDownTestSuite() { chip::Platform::MemoryShutdown(); }
+};
+
+TEST_F(TestSecureSession, SecureChannelInitTest)
 {
     Crypto::DefaultSessionKeystore sessionKeystore;
     CryptoContext channel;
@@ -67,7 +77,7 @@ TEST(TestSecureSession, SecureChannelInitTest)
               CHIP_NO_ERROR);
 }
 
-TEST(TestSecureSession, SecureChannelEncryptTest)
+TEST_F(TestSecureSession, SecureChannelEncryptTest)
 {
     Crypto::DefaultSessionKeystore sessionKeystore;
     CryptoContext channel;
@@ -108,7 +118,7 @@ TEST(TestSecureSession, SecureChannelEncryptTest)
     EXPECT_EQ(channel.Encrypt(plain_text, sizeof(plain_text), output, nonce, packetHeader, mac), CHIP_NO_ERROR);
 }
 
-TEST(TestSecureSession, SecureChannelDecryptTest)
+TEST_F(TestSecureSession, SecureChannelDecryptTest)
 {
     Crypto::DefaultSessionKeystore sessionKeystore;
     CryptoContext channel;
@@ -158,3 +168,113 @@ TEST(TestSecureSession, SecureChannelDecryptTest)
 
     EXPECT_EQ(memcmp(plain_text, output, sizeof(plain_text)), 0);
 }
+
+TEST_F(TestSecureSession, SecureChannelBuffersTest)
+{
+    Crypto::DefaultSessionKeystore sessionKeystore;
+    CryptoContext channel;
+    CryptoContext channel2;
+    uint8_t plain_text[1000];
+    uint8_t encrypted[sizeof(plain_text)];
+    uint8_t data[sizeof(plain_text)];
+    PacketHeader packetHeader;
+    MessageAuthenticationCode mac;
+    MessageAuthenticationCode mac2;
+
+    for (size_t i = 0; i < sizeof(plain_text); i++)
+    {
+        plain_text[i] = static_cast<uint8_t>(i);
+    }
+
+    packetHeader.SetSessionId(1);
+
+    CryptoContext::NonceStorage nonce;
+    CryptoContext::BuildNonce(nonce, packetHeader.GetSecurityFlags(), packetHeader.GetMessageCounter(), 0);
+
+    const char * salt = "Test Salt";
+
+    P256Keypair keypair;
+    EXPECT_EQ(keypair.Initialize(ECPKeyTarget::ECDH), CHIP_NO_ERROR);
+
+    P256Keypair keypair2;
+    EXPECT_EQ(keypair2.Initialize(ECPKeyTarget::ECDH), CHIP_NO_ERROR);
+
+    EXPECT_EQ(channel.InitFromKeyPair(sessionKeystore, keypair, keypair2.Pubkey(), ByteSpan((const uint8_t *) salt, strlen(salt)),
+                                      CryptoContext::SessionInfoType::kSessionEstablishment,
+                                      CryptoContext::SessionRole::kInitiator),
+              CHIP_NO_ERROR);
+    EXPECT_EQ(channel2.InitFromKeyPair(sessionKeystore, keypair2, keypair.Pubkey(), ByteSpan((const uint8_t *) salt, strlen(salt)),
+                                       CryptoContext::SessionInfoType::kSessionEstablishment,
+                                       CryptoContext::SessionRole::kResponder),
+              CHIP_NO_ERROR);
+    EXPECT_EQ(channel.Encrypt(plain_text, sizeof(plain_text), encrypted, nonce, packetHeader, mac), CHIP_NO_ERROR);
+
+    // The same message in buffers that do not line up with AES blocks
+    memcpy(data, plain_text, sizeof(plain_text));
+    const MutableByteSpan buffers[] = { MutableByteSpan(data, 7), MutableByteSpan(data + 7, 0), MutableByteSpan(data + 7, 500),
+                                        MutableByteSpan(data + 507, sizeof(data) - 507) };
+
+    EXPECT_EQ(channel.Encrypt(Span<const MutableByteSpan>(buffers), nonce, packetHeader, mac2), CHIP_NO_ERROR);
+    EXPECT_EQ(memcmp(data, encrypted, sizeof(encrypted)), 0);
+    EXPECT_EQ(memcmp(mac.GetTag(), mac2.GetTag(), packetHeader.MICTagLength()), 0);
+
+    EXPECT_EQ(channel2.Decrypt(Span<const MutableByteSpan>(buffers), nonce, packetHeader, mac), CHIP_NO_ERROR);
+    EXPECT_EQ(memcmp(data, plain_text, sizeof(plain_text)), 0);
+
+    // Wrong key
+    EXPECT_EQ(channel.Encrypt(Span<const MutableByteSpan>(buffers), nonce, packetHeader, mac2), CHIP_NO_ERROR);
+    EXPECT_NE(channel.Decrypt(Span<const MutableByteSpan>(buffers), nonce, packetHeader, mac2), CHIP_NO_ERROR);
+}
+
+TEST_F(TestSecureSession, SecureMessageCodecChainTest)
+{
+    Crypto::DefaultSessionKeystore sessionKeystore;
+    CryptoContext channel;
+    PayloadHeader payloadHeader;
+    PacketHeader packetHeader;
+    uint8_t payload[600];
+
+    for (size_t i = 0; i < sizeof(payload); i++)
+    {
+        payload[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    packetHeader.SetSessionId(1);
+
+    CryptoContext::NonceStorage nonce;
+    CryptoContext::BuildNonce(nonce, packetHeader.GetSecurityFlags(), packetHeader.GetMessageCounter(), 0);
+
+    P256Keypair keypair;
+    EXPECT_EQ(keypair.Initialize(ECPKeyTarget::ECDH), CHIP_NO_ERROR);
+
+    P256Keypair keypair2;
+    EXPECT_EQ(keypair2.Initialize(ECPKeyTarget::ECDH), CHIP_NO_ERROR);
+
+    EXPECT_EQ(channel.InitFromKeyPair(sessionKeystore, keypair, keypair2.Pubkey(), ByteSpan(),
+                                      CryptoContext::SessionInfoType::kSessionEstablishment,
+                                      CryptoContext::SessionRole::kInitiator),
+              CHIP_NO_ERROR);
+
+    {
+        constexpr size_t kMICSize = 16;
+
+        System::PacketBufferHandle single = System::PacketBufferHandle::NewWithData(payload, sizeof(payload), kMICSize);
+        System::PacketBufferHandle chain  = System::PacketBufferHandle::NewWithData(payload, 100);
+        System::PacketBufferHandle tail   = System::PacketBufferHandle::NewWithData(payload + 100, sizeof(payload) - 100, kMICSize);
+        ASSERT_FALSE(single.IsNull());
+        ASSERT_FALSE(chain.IsNull());
+        ASSERT_FALSE(tail.IsNull());
+        chain->AddToEnd(std::move(tail));
+
+        EXPECT_EQ(SecureMessageCodec::Encrypt(channel, nonce, payloadHeader, packetHeader, single), CHIP_NO_ERROR);
+        EXPECT_EQ(SecureMessageCodec::Encrypt(channel, nonce, payloadHeader, packetHeader, chain), CHIP_NO_ERROR);
+
+        // The chain is encrypted in place, to the same message and MIC
+        uint8_t encrypted[sizeof(payload) + 64];
+        EXPECT_TRUE(chain->HasChainedBuffer());
+        ASSERT_EQ(chain->TotalLength(), single->DataLength());
+        ASSERT_LE(chain->TotalLength(), sizeof(encrypted));
+        EXPECT_EQ(chain->Read(encrypted, chain->TotalLength()), CHIP_NO_ERROR);
+        EXPECT_EQ(memcmp(encrypted, single->Start(), single->DataLength()), 0);
+    }
+}